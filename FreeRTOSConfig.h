@@ -72,7 +72,7 @@
 #define configUSE_PREEMPTION                1
 #define configUSE_IDLE_HOOK                 0
 #define configUSE_TICK_HOOK                 0
-#define configCPU_CLOCK_HZ                  ( ( unsigned long ) 50000000 )
+#define configCPU_CLOCK_HZ                  ( ( unsigned long ) 80000000 )
 #define configTICK_RATE_HZ                  ( ( portTickType ) 1000 )
 #define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 200 )
 
@@ -80,14 +80,14 @@
 /*************************************************************************
  *
  * This #define controls how much of the microcontroller's SRAM will be
- * allocated just to run FreeRTOS. At the moment, this value is set to
- * 20KB. If additional tasks are added, you may need to increase this
- * value to compensate for the addded memory requirements. Otherwise,
- * just keep this in the back of your mind in case any strange FreeRTOS
- * stack overflow errors occur.
+ * allocated to the FreeRTOS heap (heap_2). Every task, queue and mutex
+ * is created from it once during initialization (see memory_budget.h),
+ * which takes about 12KB with the stack sizes used today. At the moment,
+ * this value is set to 16KB. "system show memory" reports how much of
+ * the heap and of each stack is in use, check it after adding a task.
  *
  *************************************************************************/
-#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 20000 ) )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 16384 ) )
 #define configMAX_TASK_NAME_LEN             ( 12 )
 #define configUSE_TRACE_FACILITY            1
 #define configUSE_16_BIT_TICKS              0
@@ -115,6 +115,25 @@ to exclude the API function. */
 #define INCLUDE_uxTaskGetStackHighWaterMark 1
 #define INCLUDE_pcTaskGetTaskName 1
 #define INCLUDE_eTaskGetState 1
+#define INCLUDE_xTaskGetSchedulerState 1
+#define INCLUDE_xTaskGetCurrentTaskHandle 1
+#define INCLUDE_xTaskGetIdleTaskHandle 1
+
+/* Records the peak depth of the queues created through MemoryQueueCreate(),
+ * see memory_budget.c. Only called with the queue locked. */
+extern void MemoryQueueSent(void *queue);
+#define traceQUEUE_SEND( pxQueue )              MemoryQueueSent( pxQueue )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )     MemoryQueueSent( pxQueue )
+
+/* Per-task CPU time for "system show perf", counted by the DWT cycle counter
+ * (see perf_stats.c). Set to 0 to compile every performance counter out. */
+#define configGENERATE_RUN_TIME_STATS           1
+#if configGENERATE_RUN_TIME_STATS
+extern void PerfInit(void);
+extern uint32_t PerfRunTimeCounter(void);
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()    PerfInit()
+#define portGET_RUN_TIME_COUNTER_VALUE()            PerfRunTimeCounter()
+#endif
 
 /* Be ENORMOUSLY careful if you want to modify these two values and make sure
  * you read http://www.freertos.org/a00110.html#kernel_priority first!
@@ -0,0 +1,284 @@
+/**\file boot_task.c
+ * \brief <b>Staged Boot Task</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <eee_hal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "string.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "console.h"
+#include "freertos_init.h"
+#include "command_functions.h"
+#include "vlan_table.h"
+#include "config_store.h"
+#include "boot_task.h"
+#include "priorities.h"
+#include "memory_budget.h"
+#include "perf_stats.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+//*****************************************************************************
+//
+//! An external reference to the UART mutex that blocks communication with the
+//! interface until it becomes available.
+//
+//*****************************************************************************
+extern xSemaphoreHandle g_pUARTSemaphore;
+
+//*****************************************************************************
+//
+//! Times at which each boot phase was reached (microseconds).
+//
+//*****************************************************************************
+static uint32_t BootPhaseTimes[BOOT_PHASE_COUNT] = {0};
+
+//*****************************************************************************
+//
+//! Names of the boot phases, indexed by BootPhase.
+//
+//*****************************************************************************
+static const char *BootPhaseNames[BOOT_PHASE_COUNT] = {
+		"timebase started",
+		"switch registers restored",
+		"forwarding",
+		"scheduler started",
+		"VLAN table loaded",
+		"users loaded",
+		"configuration ready"
+};
+
+//*****************************************************************************
+//
+//! Set by the boot task once the VLAN table and the user database are loaded.
+//
+//*****************************************************************************
+static volatile bool BootReady = false;
+
+//*****************************************************************************
+//
+//! Flags of the legacy configuration handed over by InitializeEEPROM().
+//
+//*****************************************************************************
+static uint8_t BootLegacyFlags = 0x00;
+
+//*****************************************************************************
+//
+//! Records the time a boot phase was reached.
+//!
+//! \param phase the phase that was reached
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void BootPhaseMark(BootPhase phase)
+{
+	if (phase < BOOT_PHASE_COUNT) {
+		BootPhaseTimes[phase] = DelayTimebaseUs();
+	}
+}
+
+//*****************************************************************************
+//
+//! Returns the time a boot phase was reached.
+//!
+//! \param phase the phase to look up
+//!
+//! \return Returns the time in microseconds, 0 if the phase was not reached
+//
+//*****************************************************************************
+uint32_t BootPhaseTime(BootPhase phase)
+{
+	return ((phase < BOOT_PHASE_COUNT) ? BootPhaseTimes[phase] : 0);
+}
+
+//*****************************************************************************
+//
+//! Returns the name of a boot phase for display.
+//!
+//! \param phase the phase to look up
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *BootPhaseName(BootPhase phase)
+{
+	return ((phase < BOOT_PHASE_COUNT) ? BootPhaseNames[phase] : "unknown");
+}
+
+//*****************************************************************************
+//
+//! Returns true once the VLAN table and the user database have been loaded.
+//!
+//! \return Returns true if the configuration is ready
+//
+//*****************************************************************************
+bool BootConfigReady(void)
+{
+	return BootReady;
+}
+
+//*****************************************************************************
+//
+//! Pends the calling task until the configuration has finished loading.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void BootWaitReady(void)
+{
+	while (!BootReady) {
+		vTaskDelay(BOOT_READY_POLL_MS / portTICK_RATE_MS);
+	}
+}
+
+//*****************************************************************************
+//
+//! Loads the user database saved by firmware without the configuration store
+//! (MAX_USERS records of EEPROM_USER_RECORD_SIZE bytes at EEPROM_USERS_BASE).
+//!
+//! \param buffer scratch buffer of at least EEPROM_USER_RECORD_SIZE bytes
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void BootLoadLegacyUsers(uint8_t *buffer)
+{
+	uint32_t users_cnt;
+
+	for (users_cnt = 0; users_cnt < MAX_USERS; users_cnt++) {
+		//Get the whole 65-byte user record from EEPROM with a single read
+		EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (users_cnt*EEPROM_USER_RECORD_SIZE)), buffer, EEPROM_USER_RECORD_SIZE);
+		//Username (16 characters [16 registers])
+		memcpy(users[users_cnt].username, &buffer[0], 16);
+		//Password (16 characters [16 registers])
+		memcpy(users[users_cnt].password, &buffer[16], 16);
+		//First name (16 characters [16 registers])
+		memcpy(users[users_cnt].first_name, &buffer[32], 16);
+		//Last name (16 characters [16 registers])
+		memcpy(users[users_cnt].last_name, &buffer[48], 16);
+		//Get permission level from user. PermLevel is cast from 8-bit unsigned integer
+		users[users_cnt].permissions = (PermLevel)buffer[64];
+		//Set this user to be left unchanged on next configuration save.
+		users[users_cnt].nextAction = None;
+	}
+}
+
+//*****************************************************************************
+//
+//! Second stage of bring-up. Runs at the lowest priority once the switch is
+//! already forwarding, loads the VLAN table and the user database, migrates a
+//! legacy configuration into the configuration store and then deletes itself.
+//
+//*****************************************************************************
+static void BootTask(void *pvParameters)
+{
+	uint8_t page_buffer[EEPROM_PAGE_SIZE];
+	uint32_t migrate = CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH);
+	bool vlans_restored = false, migrated = true;
+#if ENABLE_PERF_STATS
+	static const char *const BootSpanLabel[1] = { "boot restore" };
+#endif
+	PERF_SPAN_BEGIN();
+
+	BootPhaseMark(BootPhaseScheduler);
+
+	if (BootLegacyFlags == 0x00) {
+		if (ConfigStoreSections() & CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS)) {
+			vlans_restored = ConfigStoreApply(CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS), page_buffer);
+		}
+	}
+	else if ((BootLegacyFlags & (1 << FLAG_CONFIG_VLAN_VALID)) != 0) {
+		//Rebuild the VLAN membership map from the saved image and program the table a group at a time
+		vlans_restored = VLANTableRestore(page_buffer);
+		if (vlans_restored) {
+			migrate |= CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS);
+		}
+	}
+	if (!vlans_restored) {
+		//No saved VLAN image was applied, mirror whatever the Ethernet Controller holds
+		VLANTableLoad();
+	}
+	BootPhaseMark(BootPhaseVLANs);
+
+	if (BootLegacyFlags == 0x00) {
+		ConfigStoreApply(CONFIG_SECTION_MASK(CONFIG_SECTION_USERS), page_buffer);
+	}
+	else if ((BootLegacyFlags & (1 << FLAG_CONFIG_USERS_VALID)) != 0) {
+		BootLoadLegacyUsers(page_buffer);
+		migrate |= CONFIG_SECTION_MASK(CONFIG_SECTION_USERS);
+	}
+	BootPhaseMark(BootPhaseUsers);
+
+	if (BootLegacyFlags != 0x00) {
+		//Move the legacy configuration into the configuration store, the legacy areas are only read from now on
+		migrated = ConfigStoreCommit(migrate, 0, page_buffer, NULL);
+	}
+
+	PERF_SPAN_END(BootSpanLabel, 1);
+	BootReady = true;
+	BootPhaseMark(BootPhaseReady);
+
+	xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
+	ConsolePrintf("\n[BOOTING]: Forwarding after %d ms, configuration ready after %d ms%s\n",
+			(BootPhaseTime(BootPhaseForwarding) / 1000), (BootPhaseTime(BootPhaseReady) / 1000),
+			(migrated ? "" : " (legacy migration FAILED)"));
+	xSemaphoreGive(g_pUARTSemaphore);
+
+	MemoryTaskExit();
+	vTaskDelete(NULL);
+}
+
+//*****************************************************************************
+//
+//! Creates the boot task. This should return zero if the task was created
+//! successfully.
+//!
+//! \param legacy_flags flags of a legacy configuration (register 0x1E) to
+//! load and migrate into the configuration store, 0 to use the store
+//!
+//! \return Returns 0 on success, 1 otherwise
+//
+//*****************************************************************************
+uint32_t BootTaskInit(uint8_t legacy_flags)
+{
+	BootLegacyFlags = legacy_flags;
+
+	//
+    // Create the boot task.
+    //
+    if(MemoryTaskCreate(BootTask, "BOOT", BOOT_TASK_STACK_SIZE,
+                   tskIDLE_PRIORITY + PRIORITY_BOOT_TASK) == NULL)
+    {
+        return(1);
+    }
+
+    //
+    // Success.
+    //
+    return(0);
+}
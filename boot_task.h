@@ -0,0 +1,127 @@
+/**\file boot_task.h
+ * \brief <b>Staged Boot Task</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef BOOT_TASK_H_
+#define BOOT_TASK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+//! Interval in milliseconds at which tasks waiting in BootWaitReady() check
+//! whether the configuration has finished loading.
+//
+//*****************************************************************************
+#define BOOT_READY_POLL_MS          10
+
+//*****************************************************************************
+//
+//! Phases of bring-up, in the order they are reached. BootPhaseTime() returns
+//! the time each phase was reached at.
+//
+//*****************************************************************************
+typedef enum {
+	//! The delay timebase was started, all times are measured from here
+	BootPhaseTimebase,
+	//! The saved Ethernet Controller registers were restored
+	BootPhaseSwitchRestored,
+	//! The Ethernet Controller was started and is forwarding
+	BootPhaseForwarding,
+	//! The scheduler is running and the boot task has started
+	BootPhaseScheduler,
+	//! The VLAN table was restored or read back from the Ethernet Controller
+	BootPhaseVLANs,
+	//! The user database was restored
+	BootPhaseUsers,
+	//! The configuration is fully loaded (BootConfigReady() returns true)
+	BootPhaseReady,
+	BOOT_PHASE_COUNT
+} BootPhase;
+
+//*****************************************************************************
+//
+//! Records the time a boot phase was reached. May be called before the
+//! scheduler is started.
+//!
+//! \param phase the phase that was reached
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void BootPhaseMark(BootPhase phase);
+//*****************************************************************************
+//
+//! Returns the time a boot phase was reached.
+//!
+//! \param phase the phase to look up
+//!
+//! \return Returns the time in microseconds since the timebase was started, 0
+//! if the phase has not been reached
+//
+//*****************************************************************************
+extern uint32_t BootPhaseTime(BootPhase phase);
+//*****************************************************************************
+//
+//! Returns the name of a boot phase for display.
+//!
+//! \param phase the phase to look up
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+extern const char *BootPhaseName(BootPhase phase);
+//*****************************************************************************
+//
+//! Returns true once the VLAN table and the user database have been loaded.
+//!
+//! \return Returns true if the configuration is ready
+//
+//*****************************************************************************
+extern bool BootConfigReady(void);
+//*****************************************************************************
+//
+//! Pends the calling task until the configuration has finished loading.
+//! Commands that read or change VLANs, users or the saved configuration must
+//! not run before then.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void BootWaitReady(void);
+//*****************************************************************************
+//
+//! Creates the boot task, which loads the VLAN table and the user database at
+//! a low priority once the scheduler is running and then deletes itself.
+//! This should return zero if the task was created successfully.
+//!
+//! \param legacy_flags flags of a legacy configuration (register 0x1E) to
+//! load and migrate into the configuration store, 0 to use the store
+//!
+//! \return Returns 0 on success, 1 otherwise
+//
+//*****************************************************************************
+extern uint32_t BootTaskInit(uint8_t legacy_flags);
+
+#endif /* BOOT_TASK_H_ */
@@ -0,0 +1,454 @@
+/**\file cable_diag.c
+ * \brief <b>Concurrent LinkMD Cable Diagnostics</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "eee_hal.h"
+#include "interpreter_task.h"
+#include "freertos_init.h"
+#include "port_monitor_task.h"
+#include "cable_diag.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+//*****************************************************************************
+//
+//! Register bits used by a test. Auto-negotiation and auto MDI/MDI-X must be
+//! off while LinkMD runs, the start bit clears itself once the result is
+//! ready in bits 6:5 and the distance in bit 0 and the next register.
+//
+//*****************************************************************************
+#define CABLE_CONTROL5_AUTONEG_OFF	(1 << 7)
+#define CABLE_CONTROL6_RESTART_AN	(1 << 5)
+#define CABLE_CONTROL6_MDIX_OFF		(1 << 2)
+#define CABLE_LINKMD0_RESULT_MASK	0x60
+#define CABLE_LINKMD0_START			(1 << 4)
+#define CABLE_LINKMD0_DISTANCE_HIGH	0x01
+#define CABLE_STATUS0_LINK_GOOD		(1 << 5)
+
+//*****************************************************************************
+//
+//! \brief A test in progress and the settings it restores once finished.
+//
+//*****************************************************************************
+typedef struct {
+	uint32_t polls;
+	uint32_t control5;
+	uint32_t control6;
+} CableRun;
+
+//*****************************************************************************
+//
+//! Names of the results, indexed by CableStatus.
+//
+//*****************************************************************************
+static const char *CableStatusNames[] = {
+	"untested", "normal", "open", "short", "failed", "timed out"
+};
+
+//*****************************************************************************
+//
+//! Ports requested by CableDiagStart() and not yet started, and ports whose
+//! test is running. Only the port monitor task touches CableRuns.
+//
+//*****************************************************************************
+static uint32_t CableRequested = 0;
+static uint32_t CableRunning = 0;
+static CableRun CableRuns[CABLE_DIAG_PORT_COUNT];
+
+//*****************************************************************************
+//
+//! Last result of each port and the tick count it was taken at.
+//
+//*****************************************************************************
+static CableStatus CableStatuses[CABLE_DIAG_PORT_COUNT];
+static uint32_t CableDistances[CABLE_DIAG_PORT_COUNT];
+static portTickType CableTimes[CABLE_DIAG_PORT_COUNT];
+
+//*****************************************************************************
+//
+//! Tick count of the next check of the running tests, and the interval and
+//! next tick count of the background scan (0 = disabled).
+//
+//*****************************************************************************
+static portTickType CablePollDue = 0;
+static portTickType CableScanTicks = 0;
+static portTickType CableScanDue = 0;
+
+//*****************************************************************************
+//
+//! Guards the requests and the results. Never held while the Ethernet
+//! Controller is accessed.
+//
+//*****************************************************************************
+static xSemaphoreHandle CableMutex = NULL;
+
+//*****************************************************************************
+//
+//! Takes the result mutex once the scheduler is running.
+//!
+//! \return Returns true if the mutex was taken and must be given back
+//
+//*****************************************************************************
+static bool CableLock(void)
+{
+	if (CableMutex != NULL && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		return (xSemaphoreTake(CableMutex, portMAX_DELAY) == pdTRUE);
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+//! Returns the register base address of a port.
+//!
+//! \param port the port (0 - 3)
+//!
+//! \return Returns the base address (0x10 - 0x40)
+//
+//*****************************************************************************
+static uint32_t CablePortBase(uint8_t port)
+{
+	return ((uint32_t)(port + 1) << 4);
+}
+
+//*****************************************************************************
+//
+//! Saves the port settings, turns auto-negotiation and auto MDI/MDI-X off and
+//! starts LinkMD.
+//!
+//! \param port the port (0 - 3)
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void CableBegin(uint8_t port)
+{
+	uint32_t base = CablePortBase(port);
+	uint32_t reg_data;
+
+	CableRuns[port].polls = 0;
+	CableRuns[port].control5 = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_CONTROL5_OFFSET_HEX);
+	CableRuns[port].control6 = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_CONTROL6_OFFSET_HEX);
+	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_CONTROL5_OFFSET_HEX, CableRuns[port].control5 | CABLE_CONTROL5_AUTONEG_OFF);
+	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_CONTROL6_OFFSET_HEX, CableRuns[port].control6 | CABLE_CONTROL6_MDIX_OFF);
+
+	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_LINKMD0_OFFSET_HEX);
+	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_LINKMD0_OFFSET_HEX, reg_data | CABLE_LINKMD0_START);
+}
+
+//*****************************************************************************
+//
+//! Restores the settings saved by CableBegin() and stores the result. If
+//! auto-negotiation was on it is restarted so the link comes back at once.
+//!
+//! \param port the port (0 - 3)
+//! \param status the result
+//! \param distance distance to the fault in meters
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void CableFinish(uint8_t port, CableStatus status, uint32_t distance)
+{
+	uint32_t base = CablePortBase(port);
+	uint32_t control6 = CableRuns[port].control6;
+	bool locked;
+
+	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_CONTROL5_OFFSET_HEX, CableRuns[port].control5);
+	if ((CableRuns[port].control5 & CABLE_CONTROL5_AUTONEG_OFF) == 0) {
+		control6 |= CABLE_CONTROL6_RESTART_AN;
+	}
+	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_CONTROL6_OFFSET_HEX, control6);
+
+	locked = CableLock();
+	CableStatuses[port] = status;
+	CableDistances[port] = distance;
+	CableTimes[port] = xTaskGetTickCount();
+	CableRunning &= ~(1 << port);
+	if (locked) {
+		xSemaphoreGive(CableMutex);
+	}
+}
+
+//*****************************************************************************
+//
+//! Checks a running test and finishes it once LinkMD is done or the test has
+//! run out of checks.
+//!
+//! \param port the port (0 - 3)
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void CablePoll(uint8_t port)
+{
+	uint32_t base = CablePortBase(port);
+	uint32_t linkmd0, count, distance = 0;
+	CableStatus status;
+
+	linkmd0 = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_LINKMD0_OFFSET_HEX);
+	if (linkmd0 & CABLE_LINKMD0_START) {
+		if (++CableRuns[port].polls >= CABLE_DIAG_MAX_POLLS) {
+			CableFinish(port, CableTimeout, 0);
+		}
+		return;
+	}
+
+	switch (linkmd0 & CABLE_LINKMD0_RESULT_MASK) {
+	case 0x00:
+		status = CableNormal;
+		break;
+	case 0x20:
+		status = CableOpen;
+		break;
+	case 0x40:
+		status = CableShort;
+		break;
+	default:
+		status = CableFailed;
+		break;
+	}
+	if (status == CableOpen || status == CableShort) {
+		//The fault is 0.4 m per count beyond the first 26 counts
+		count = ((linkmd0 & CABLE_LINKMD0_DISTANCE_HIGH) << 8) |
+				EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, base + PORT_LINKMD1_OFFSET_HEX);
+		distance = (count > 26) ? (((count - 26) * 4) / 10) : 0;
+	}
+	CableFinish(port, status, distance);
+}
+
+//*****************************************************************************
+//
+//! Creates the result mutex.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void CableDiagInit(void)
+{
+	if (CableMutex == NULL) {
+		CableMutex = xSemaphoreCreateMutex();
+	}
+}
+
+//*****************************************************************************
+//
+//! Starts the requested tests and the scheduled scan, then checks the running
+//! tests if a check is due.
+//!
+//! \return Returns the number of ticks until the next call is due
+//
+//*****************************************************************************
+uint32_t CableDiagService(void)
+{
+	portTickType now = xTaskGetTickCount();
+	portTickType wait = portMAX_DELAY;
+	uint32_t start, status0;
+	uint8_t port;
+	bool locked;
+
+	locked = CableLock();
+	start = CableRequested & ~CableRunning;
+	CableRequested = 0;
+	if (locked) {
+		xSemaphoreGive(CableMutex);
+	}
+
+	//The scan only tests ports without a link, a test takes the link down
+	if (CableScanTicks != 0 && (portTickType)(now - CableScanDue) < (portMAX_DELAY / 2)) {
+		for (port = 0; port < CABLE_DIAG_PORT_COUNT; port++) {
+			status0 = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, CablePortBase(port) + PORT_STATUS0_OFFSET_HEX);
+			if ((status0 & CABLE_STATUS0_LINK_GOOD) == 0) {
+				start |= (1 << port);
+			}
+		}
+		CableScanDue = now + CableScanTicks;
+	}
+
+	start &= ~CableRunning;
+	if (start != 0) {
+		for (port = 0; port < CABLE_DIAG_PORT_COUNT; port++) {
+			if (start & (1 << port)) {
+				CableBegin(port);
+			}
+		}
+		locked = CableLock();
+		CableRunning |= start;
+		if (locked) {
+			xSemaphoreGive(CableMutex);
+		}
+		//Give the new tests a full interval, the others are checked with them
+		CablePollDue = now + (CABLE_DIAG_POLL_MS / portTICK_RATE_MS);
+	}
+	else if (CableRunning != 0 && (portTickType)(now - CablePollDue) < (portMAX_DELAY / 2)) {
+		for (port = 0; port < CABLE_DIAG_PORT_COUNT; port++) {
+			if (CableRunning & (1 << port)) {
+				CablePoll(port);
+			}
+		}
+		CablePollDue = now + (CABLE_DIAG_POLL_MS / portTICK_RATE_MS);
+	}
+
+	now = xTaskGetTickCount();
+	if (CableRunning != 0) {
+		wait = ((portTickType)(CablePollDue - now) < (portMAX_DELAY / 2)) ? (CablePollDue - now) : 0;
+	}
+	if (CableScanTicks != 0) {
+		start = ((portTickType)(CableScanDue - now) < (portMAX_DELAY / 2)) ? (CableScanDue - now) : 0;
+		if (start < wait) {
+			wait = start;
+		}
+	}
+	return wait;
+}
+
+//*****************************************************************************
+//
+//! Requests a test of the given ports.
+//!
+//! \param port_mask bit n set to test port n (0 - 3)
+//!
+//! \return Returns false if no valid port was given
+//
+//*****************************************************************************
+bool CableDiagStart(uint32_t port_mask)
+{
+	bool locked;
+
+	port_mask &= CABLE_DIAG_ALL_PORTS;
+	if (port_mask == 0) {
+		return false;
+	}
+	locked = CableLock();
+	CableRequested |= port_mask;
+	if (locked) {
+		xSemaphoreGive(CableMutex);
+	}
+	PortMonitorWake();
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns the ports whose test was requested or is still running.
+//!
+//! \return Returns a mask, bit n for port n
+//
+//*****************************************************************************
+uint32_t CableDiagBusy(void)
+{
+	uint32_t busy;
+	bool locked;
+
+	locked = CableLock();
+	busy = CableRequested | CableRunning;
+	if (locked) {
+		xSemaphoreGive(CableMutex);
+	}
+	return busy;
+}
+
+//*****************************************************************************
+//
+//! Copies the last result of a port.
+//!
+//! \param port the port (0 - 3)
+//! \param result returns the result
+//!
+//! \return Returns false if the port is invalid
+//
+//*****************************************************************************
+bool CableDiagGet(uint8_t port, CableResult *result)
+{
+	bool locked;
+
+	if (port >= CABLE_DIAG_PORT_COUNT) {
+		return false;
+	}
+	locked = CableLock();
+	result->status = CableStatuses[port];
+	result->distance_m = CableDistances[port];
+	result->age_s = (CableStatuses[port] == CableUntested) ? 0 : (((xTaskGetTickCount() - CableTimes[port]) * portTICK_RATE_MS) / 1000);
+	result->running = (((CableRequested | CableRunning) & (1 << port)) != 0);
+	if (locked) {
+		xSemaphoreGive(CableMutex);
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Sets the interval of the background scan. The first scan follows one
+//! interval after this call.
+//!
+//! \param minutes interval in minutes, 0 disables the scan
+//!
+//! \return Returns false if the interval exceeds CABLE_DIAG_MAX_SCAN_MINUTES
+//
+//*****************************************************************************
+bool CableDiagSetScan(uint32_t minutes)
+{
+	bool locked;
+
+	if (minutes > CABLE_DIAG_MAX_SCAN_MINUTES) {
+		return false;
+	}
+	locked = CableLock();
+	CableScanTicks = (minutes * 60000) / portTICK_RATE_MS;
+	CableScanDue = xTaskGetTickCount() + CableScanTicks;
+	if (locked) {
+		xSemaphoreGive(CableMutex);
+	}
+	PortMonitorWake();
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns the interval of the background scan.
+//!
+//! \return Returns the interval in minutes, 0 if the scan is disabled
+//
+//*****************************************************************************
+uint32_t CableDiagGetScan(void)
+{
+	return ((CableScanTicks * portTICK_RATE_MS) / 60000);
+}
+
+//*****************************************************************************
+//
+//! Returns the name of a result.
+//!
+//! \param status the result
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *CableStatusName(CableStatus status)
+{
+	return ((status <= CableTimeout) ? CableStatusNames[status] : "unknown");
+}
@@ -0,0 +1,167 @@
+/**\file cable_diag.h
+ * \brief <b>Concurrent LinkMD Cable Diagnostics</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef CABLE_DIAG_H_
+#define CABLE_DIAG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+//! Number of KSZ8895MLUB ports with a PHY that can run LinkMD. Ports are
+//! numbered as on the KSZ8895MLUB: 0 = port 1 (f3) through 3 = port 4 (f0).
+//
+//*****************************************************************************
+#define CABLE_DIAG_PORT_COUNT		4
+#define CABLE_DIAG_ALL_PORTS		((1 << CABLE_DIAG_PORT_COUNT) - 1)
+
+//*****************************************************************************
+//
+//! Interval in milliseconds between two checks of the running tests, and the
+//! number of checks before a test is given up.
+//
+//*****************************************************************************
+#define CABLE_DIAG_POLL_MS			40
+#define CABLE_DIAG_MAX_POLLS		10
+
+//*****************************************************************************
+//
+//! Longest interval in minutes accepted for the background scan.
+//
+//*****************************************************************************
+#define CABLE_DIAG_MAX_SCAN_MINUTES	1440
+
+//*****************************************************************************
+//
+//! \brief Outcome of the last test of a port.
+//
+//*****************************************************************************
+typedef enum {
+	//! The port was not tested since boot
+	CableUntested,
+	CableNormal,
+	CableOpen,
+	CableShort,
+	//! The Ethernet Controller reported that the test failed
+	CableFailed,
+	//! The test did not complete within CABLE_DIAG_MAX_POLLS checks
+	CableTimeout
+} CableStatus;
+
+//*****************************************************************************
+//
+//! \brief Last result of a port, see CableDiagGet().
+//
+//*****************************************************************************
+typedef struct {
+	CableStatus status;
+	//! Distance to the fault in meters, 0 for a normal cable
+	uint32_t distance_m;
+	//! Seconds since the test finished
+	uint32_t age_s;
+	//! True while a new test of the port is running
+	bool running;
+} CableResult;
+
+//*****************************************************************************
+//
+//! Creates the mutex guarding the results. Must be called before the
+//! scheduler is started.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void CableDiagInit(void);
+//*****************************************************************************
+//
+//! Starts the requested tests and advances the running ones. Called by the
+//! port monitor task.
+//!
+//! \return Returns the number of ticks until the next call is due
+//
+//*****************************************************************************
+extern uint32_t CableDiagService(void);
+//*****************************************************************************
+//
+//! Requests a test of the given ports. The tests run together in the port
+//! monitor task, ports already under test are not restarted. Each port loses
+//! its link until its test has finished and its settings are restored.
+//!
+//! \param port_mask bit n set to test port n (0 - 3)
+//!
+//! \return Returns false if no valid port was given
+//
+//*****************************************************************************
+extern bool CableDiagStart(uint32_t port_mask);
+//*****************************************************************************
+//
+//! Returns the ports whose test was requested or is still running.
+//!
+//! \return Returns a mask, bit n for port n
+//
+//*****************************************************************************
+extern uint32_t CableDiagBusy(void);
+//*****************************************************************************
+//
+//! Copies the last result of a port. Does not access the Ethernet Controller.
+//!
+//! \param port the port (0 - 3)
+//! \param result returns the result
+//!
+//! \return Returns false if the port is invalid
+//
+//*****************************************************************************
+extern bool CableDiagGet(uint8_t port, CableResult *result);
+//*****************************************************************************
+//
+//! Sets the interval of the background scan. The scan only tests ports
+//! without a link, so it never interrupts traffic.
+//!
+//! \param minutes interval in minutes, 0 disables the scan
+//!
+//! \return Returns false if the interval exceeds CABLE_DIAG_MAX_SCAN_MINUTES
+//
+//*****************************************************************************
+extern bool CableDiagSetScan(uint32_t minutes);
+//*****************************************************************************
+//
+//! Returns the interval of the background scan.
+//!
+//! \return Returns the interval in minutes, 0 if the scan is disabled
+//
+//*****************************************************************************
+extern uint32_t CableDiagGetScan(void);
+//*****************************************************************************
+//
+//! Returns the name of a result as shown by "port all diagnostics".
+//!
+//! \param status the result
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+extern const char *CableStatusName(CableStatus status);
+
+#endif /* CABLE_DIAG_H_ */
@@ -78,6 +78,24 @@
  *		[1.4.29] COM_ShowDynamicMACTable <br>
  *		[1.4.30] CreateProgressBar <br>
  *		[1.4.31] UpdateProgressBar <br>
+ *		[1.4.32] COM_ShowBootTimes <br>
+ *		[1.4.33] COM_FindMACByPort <br>
+ *		[1.4.34] COM_FindMACByPrefix <br>
+ *		[1.4.35] COM_BatchBegin <br>
+ *		[1.4.36] COM_BatchCommit <br>
+ *		[1.4.37] COM_ShowPortStats <br>
+ *		[1.4.38] COM_ShowMemory <br>
+ *		[1.4.39] COM_ShowPerf <br>
+ *		[1.4.40] COM_ResetPerf <br>
+ *		[1.4.41] COM_RunAllCableDiagnostics <br>
+ *		[1.4.42] COM_ShowCableDiagnostics <br>
+ *		[1.4.43] COM_SetCableDiagScan <br>
+ *		[1.4.44] COM_ShowSPIClock <br>
+ *		[1.4.45] COM_SetSPIClock <br>
+ *		[1.4.46] COM_SyncLayers <br>
+ *		[1.4.47] COM_SetLayerAddress <br>
+ *		[1.4.48] COM_SetQoSProfile <br>
+ *		[1.4.49] COM_ShowQoS <br>
  * <br>
  *  Created on: May 20, 2016
  *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
@@ -107,13 +125,26 @@
 #include "driverlib/gpio.h"
 #include "driverlib/rom.h"
 #include "driverlib/sysctl.h"
-#include "utils/uartstdio.h"
 #include "i2c.h"
 #include "command_functions.h"
 #include "event_logger.h"
 #include "interpreter_task.h"
 #include "freertos_init.h"
 #include "i2c_task.h"
+#include "vlan_table.h"
+#include "config_store.h"
+#include "boot_task.h"
+#include "mac_table.h"
+#include "mib_counters.h"
+#include "cable_diag.h"
+#include "spi_clock.h"
+#include "spi_arbiter.h"
+#include "layer_sync.h"
+#include "qos_profile.h"
+#include "memory_budget.h"
+#include "perf_stats.h"
+#include "switch_batch.h"
+#include "console.h"
 #include "priorities.h"
 #include "FreeRTOS.h"
 #include "task.h"
@@ -125,9 +156,17 @@ void ShowProgress(int percent);
 uint32_t SetPortMembershipBits(uint32_t port_membership, uint32_t port_addr);
 uint8_t AssertVLANS(uint32_t vlan_id, uint32_t port_id);
 size_t FindIndex(uint8_t a[], size_t size, int value );
+bool ReadSwitchConfiguration(uint8_t *config);
 
 static bool ResetIssued = false;
-extern xQueueHandle g_pLoggerQueue;
+//*****************************************************************************
+//
+//! Staging buffer used by the command-line to assemble up to one EEPROM page
+//! before it is handed to EEPROMBulkWrite, or to hold a page returned by
+//! EEPROMBulkRead.
+//
+//*****************************************************************************
+static uint8_t EEPROMPageBuffer[EEPROM_PAGE_SIZE];
 
 //*****************************************************************************
 //
@@ -144,11 +183,11 @@ bool COM_WriteToEEPOM(char *params[MAX_PARAMS]) {
 
 	//Parameter 1: Register Address
 	uint32_t reg_addr = (uint32_t)strtol(params[0],NULL,0);
-	UARTprintf("REG ADDR: 0x%02x\n", reg_addr);
+	ConsolePrintfWait("REG ADDR: 0x%02x\n", reg_addr);
 	//Parameter 2: Register Data (8-bits)
 	uint32_t reg_data = (uint32_t)strtol(params[1],NULL,0);
-	UARTprintf("REG DATA: 0x%02x\n", reg_data);
-	UARTprintf("[RUNNING TASK]: Writing To EEPROM                                           \n");
+	ConsolePrintfWait("REG DATA: 0x%02x\n", reg_data);
+	ConsolePrintfWait("[RUNNING TASK]: Writing To EEPROM                                           \n");
 	ShowProgress(50);
 	if (EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, reg_addr, reg_data))
 	{
@@ -158,7 +197,7 @@ bool COM_WriteToEEPOM(char *params[MAX_PARAMS]) {
 		ShowProgress(-1);
 	}
 
-	UARTprintf("\033[0m");
+	ConsolePrintfWait("\033[0m");
 	return true;
 }
 
@@ -178,13 +217,13 @@ bool COM_ReadFromEEPROM(char *params[MAX_PARAMS])
 	uint32_t reg_addr = (uint32_t)strtol(params[0],NULL,0);
 	//Returned Data Stored Here
 	uint32_t reg_data;
-	UARTprintf("REG ADDR: 0x%08x\n", reg_addr);
-	UARTprintf("[RUNNING TASK]: Reading From EEPROM                                           \n");
+	ConsolePrintfWait("REG ADDR: 0x%08x\n", reg_addr);
+	ConsolePrintfWait("[RUNNING TASK]: Reading From EEPROM                                           \n");
 	ShowProgress(50);
 	reg_data = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, reg_addr);
 	ShowProgress(100);
-	UARTprintf("\n Data Read @0x%02x: 0x%02x", reg_addr, reg_data);
-	UARTprintf("\033[0m");
+	ConsolePrintfWait("\n Data Read @0x%02x: 0x%02x", reg_addr, reg_data);
+	ConsolePrintfWait("\033[0m");
 	return true;
 }
 
@@ -239,11 +278,7 @@ uint8_t I2C_SetBitEthernetController(uint8_t params[MAX_PARAMS])
 	//Parameter 3: Bit to set (8-bits)
 	uint32_t bit_to_set = (uint32_t)params[2];
 
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + offset));
-	reg_data |= 1 << bit_to_set;
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), reg_data);
-	return true;
+	return EthoControllerModifyBits(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), 0, (1 << bit_to_set), &reg_data);
 }
 //*****************************************************************************
 //
@@ -278,10 +313,7 @@ uint8_t I2C_ClearBitEthernetController(uint8_t params[MAX_PARAMS])
 	//Parameter 3: Bit to set (8-bits)
 	uint32_t bit_to_set = (uint32_t)params[2];
 
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + offset));
-	reg_data &= ~(1 << bit_to_set);
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), reg_data);
+	EthoControllerModifyBits(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), (1 << bit_to_set), 0, &reg_data);
 	while (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset)) != reg_data) {
 		retry_attempts++;
 		if (retry_attempts > 10) {
@@ -325,11 +357,8 @@ uint8_t I2C_SetSCEthernetController(uint8_t params[MAX_PARAMS])
 	//Parameter 3: Bit to set (8-bits)
 	uint32_t bit_to_set = (uint32_t)params[2];
 
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + offset));
 	//Set bit to '1' and write
-	reg_data |= 1 << bit_to_set;
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), reg_data);
+	EthoControllerModifyBits(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), 0, (1 << bit_to_set), &reg_data);
 	//Reset bit to '0' and validate
 	reg_data &= ~(1 << bit_to_set);
 
@@ -424,113 +453,392 @@ uint8_t I2C_RunCableDiagnostics(uint8_t params[MAX_PARAMS])
 //*****************************************************************************
 //
 //! Save Running Configuration to EEPROM (for I2C Commands)
-//! Saves all registers from 0x00 to 0xFF inside the ethernet controller to
-//! the corresponding EEPROM registers (0x100 - 0x1FF) an reports on the
-//! success or failure of the operation.
+//! Saves registers 0x00 to 0xFE of the ethernet controller to the configuration
+//! store as a new generation, leaving the saved users and VLANs untouched, and
+//! reports on the success or failure of the operation.
 //!
 //! \return Returns the results of the operation as a boolean
 //
 //*****************************************************************************
 uint8_t I2C_SaveSwitchConfiguration(uint8_t params[MAX_PARAMS])
 {
-	 uint32_t read_addr = 0x00;
-	 uint8_t flag_data = 0x00;
-	 uint32_t eeprom_eth0_addr = 0x100;
-	 portTickType ui32WakeTime;
-	 UARTprintf("\nI2C Requested Configuration Save\n%s>", console_hostname);
-	 //This task takes a while, so we want share nicely with other tasks instead of blocking
-	 uint32_t ui32TaskDelay = SHORT_TASK_DLY;
-
-	 //Get system time in ticks
-	 ui32WakeTime = xTaskGetTickCount();
-
-	 for (read_addr = 0; read_addr < 0xFF; read_addr++)
-	{
-		//Read data at address "read_addr" from Ethernet Controller 1
-		uint8_t data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, read_addr);
-
-		//Save this information to the next sector in EEPROM
-		if (!EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, eeprom_eth0_addr, data)) {
-			//We encountered a bad write cycle, report this to the user
-			return false;
-		}
+	 uint8_t page_buffer[EEPROM_PAGE_SIZE];
+	 ConsolePrintfWait("\nI2C Requested Configuration Save\n%s>", console_hostname);
 
-		//Increment to the next sector in EEPROM
-		eeprom_eth0_addr++;
+	//The staged changes of an open batch are not on the Ethernet Controller yet
+	if (SwitchBatchActive()) {
+		return false;
+	}
 
-		//Delay for 40ms to allow other tasks to run
-        vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
+	//Commit the registers of Ethernet Controller 1, nothing is written if they did not change
+	if (!ConfigStoreCommit(CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH), 0, page_buffer, NULL)) {
+		//We encountered a bad write cycle, report this to the user
+		return false;
 	}
-	flag_data = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, 0x0001E);
-	flag_data |= 1 << 0x06;
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, 0x0001E, flag_data);
 	return true;
 }
 //*****************************************************************************
 //
 //! Download Running Configuration (for I2C Commands)
-//! Sequentially writes each value held in the Micrel KSZ8895MLUB's registers
-//! 0x00 - 0xFF to the requesting I2C master.
+//! Returns each value held in the Micrel KSZ8895MLUB's registers 0x00 - 0xFE
+//! to the requesting I2C master in a single read.
 //!
 //! \return Returns the results of the operation as a boolean
 //
 //*****************************************************************************
 uint8_t I2C_DownloadSwitchConfiguration(uint8_t params[MAX_PARAMS])
 {
-	 uint32_t read_addr = 0x00;
-	 portTickType ui32WakeTime;
-
-	 //This task takes a while, so we want share nicely with other tasks instead of blocking
-	 uint32_t ui32TaskDelay = SHORT_TASK_DLY;
+	 uint8_t switch_config[0xFF];
 
-	 //Get system time in ticks
-	 ui32WakeTime = xTaskGetTickCount();
-
-	 for (read_addr = 0; read_addr < 0xFF; read_addr++)
-	{
-		//Read data at address "read_addr" from Ethernet Controller 1
-		uint8_t data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, read_addr);
-		delayUs(I2C_SLAVE_SEND_DLY);
-		//Send this information over I2C to the master
-		I2CSlaveDataPut(I2C_BASE_ADDR,data);
-		I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_SINGLE_RECEIVE);
-		//Delay for 40ms to allow other tasks to run
-        vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-	}
-	return true;
+	 //Read all registers from Ethernet Controller 1 using burst reads before sending
+	 if (!ReadSwitchConfiguration(switch_config)) {
+		 return false;
+	 }
+	 return I2CResponseAppend(switch_config, 0xFF);
 }
 //*****************************************************************************
 //
 //! Clear Running Configuration (for I2C Commands)
-//! Sequentially writes a null (0x00) to each register in the Micrel 25AA1024
-//! EEPROM from 0x100 - 0x1FF and reports the success or failure of the operation
+//! Commits a new generation of the configuration store without the saved
+//! Ethernet Controller registers and reports the success or failure of the
+//! operation
 //!
 //! \return Returns the results of the operation as a boolean
 //
 //*****************************************************************************
 uint8_t I2C_ClearSwitchConfiguration(uint8_t params[MAX_PARAMS])
 {
-	 uint32_t write_addr = 0x100;
-	 uint8_t flag_data;
-	 portTickType ui32WakeTime;
+	 uint8_t page_buffer[EEPROM_PAGE_SIZE];
 
-	 //This task takes a while, so we want share nicely with other tasks instead of blocking
-	 uint32_t ui32TaskDelay = SHORT_TASK_DLY;
+	 if (!ConfigStoreCommit(0, CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH), page_buffer, NULL)) {
+		 return false;
+	 }
+	 //Nothing is saved any more, the next save has to write every register
+	 EthoShadowMarkRange(0, ETHO_SHADOW_SIZE, true);
+	return true;
+}
+//*****************************************************************************
+//
+//! Run A Batch Of Commands (for I2C Commands)
+//! Runs several I2C commands sent in one frame as a single batch: register and
+//! VLAN changes are coalesced and written in one pass once every command has
+//! run. Commands returning more than one value cannot be batched.
+//!
+//! \param params[0] number of bytes that follow
+//! \param params[1] first command code, followed by its custom parameters, then
+//! the next command code and so on
+//!
+//! \return Returns 1 if every command and the commit succeeded, otherwise 0
+//
+//*****************************************************************************
+uint8_t I2C_RunBatch(uint8_t params[MAX_PARAMS])
+{
+	uint8_t function_params[MAX_PARAMS];
+	const I2C_Codes *code;
+	uint32_t pos = 1, i;
+	bool result = true;
 
-	 //Get system time in ticks
-	 ui32WakeTime = xTaskGetTickCount();
+	if (!SwitchBatchBegin()) {
+		return false;
+	}
+	while (pos <= params[0]) {
+		code = (params[pos] < MAX_I2C_COMMAND) ? &I2C_Mappings[params[pos]] : NULL;
+		//Stop at the first command that cannot be run, the frame cannot be parsed past it
+		if (code == NULL || code->command_code != params[pos] || code->custom_pcount == I2C_VARIABLE_PCOUNT || code->return_pcount > 1
+				|| (pos + code->custom_pcount) > params[0] || (code->static_pcount + code->custom_pcount) > MAX_PARAMS) {
+			SwitchBatchRecord(false);
+			break;
+		}
+		memset(function_params, 0, sizeof(function_params));
+		for (i = 0; i < code->static_pcount; i++) {
+			function_params[i] = code->static_parameters[i];
+		}
+		for (i = 0; i < code->custom_pcount; i++) {
+			function_params[code->static_pcount + i] = params[pos + 1 + i];
+		}
+		SwitchBatchRecord(code->func(function_params) != 0);
+		pos += 1 + code->custom_pcount;
+	}
+	result = SwitchBatchCommit(NULL);
+	return result;
+}
+//*****************************************************************************
+//
+//! Count Learned MAC Addresses (for I2C Commands)
+//! Returns the number of dynamic entries in the MAC table snapshot learned on
+//! the port specified, without accessing the Ethernet Controller.
+//!
+//! \param params[0] port number (1 - 4 = f0 - f3, 5 = exp-port, 0 = all ports)
+//!
+//! \return Returns the number of addresses, saturated at 0xFF
+//
+//*****************************************************************************
+uint8_t I2C_CountMACAddresses(uint8_t params[MAX_PARAMS])
+{
+	MACFilter filter;
+	MACEntry entry;
+	uint32_t index = 0;
+	uint32_t count = 0;
 
-	 for (; write_addr < 0x1FF; write_addr++)
-	{
-		//Read data at address "read_addr" from Ethernet Controller 1
-		EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, write_addr, 0x00);
+	if (params[0] > MAC_PORT_COUNT) {
+		return 0;
+	}
+	//Ports are inverted logically, so f0 (1) is the KSZ8895MLUB's port 4 (3)
+	filter.port = (params[0] == 0) ? MAC_PORT_ANY : ((params[0] == MAC_PORT_COUNT) ? (MAC_PORT_COUNT - 1) : (uint8_t)(MAC_PORT_COUNT - 1 - params[0]));
+	filter.prefix_length = 0;
+	while (count < 0xFF && MACTableNext(MAC_TABLE_DYNAMIC, &index, &filter, &entry)) {
+		count++;
+	}
+	return (uint8_t)count;
+}
+//*****************************************************************************
+//
+//! Read Learned MAC Addresses (for I2C Commands)
+//! Returns up to I2C_MAC_CHUNK_ENTRIES dynamic entries of the MAC table
+//! snapshot in one read: the 16-bit position to continue from (0 once the end
+//! is reached), then for each entry its MAC address, port (numbered as in
+//! params[0]) and filter ID.
+//!
+//! \param params[0] port number (1 - 4 = f0 - f3, 5 = exp-port, 0 = all ports)
+//! \param params[1] upper 8 bits of the position to start from (0 for the first read)
+//! \param params[2] lower 8 bits of the position to start from
+//!
+//! \return Returns the number of entries returned
+//
+//*****************************************************************************
+uint8_t I2C_ReadMACTable(uint8_t params[MAX_PARAMS])
+{
+	MACFilter filter;
+	MACEntry entry;
+	uint32_t index = ((uint32_t)params[1] << 8) | params[2];
+	uint32_t count = 0, next;
+	uint8_t chunk[2 + (I2C_MAC_CHUNK_ENTRIES * 8)];
+
+	if (params[0] > MAC_PORT_COUNT) {
+		return 0;
+	}
+	//Ports are inverted logically, so f0 (1) is the KSZ8895MLUB's port 4 (3)
+	filter.port = (params[0] == 0) ? MAC_PORT_ANY : ((params[0] == MAC_PORT_COUNT) ? (MAC_PORT_COUNT - 1) : (uint8_t)(MAC_PORT_COUNT - 1 - params[0]));
+	filter.prefix_length = 0;
+
+	while (count < I2C_MAC_CHUNK_ENTRIES && MACTableNext(MAC_TABLE_DYNAMIC, &index, &filter, &entry)) {
+		memcpy(&chunk[2 + (count * 8)], entry.mac, 6);
+		chunk[2 + (count * 8) + 6] = (entry.port == (MAC_PORT_COUNT - 1)) ? MAC_PORT_COUNT : (uint8_t)(MAC_PORT_COUNT - 1 - entry.port);
+		chunk[2 + (count * 8) + 7] = entry.fid;
+		count++;
+	}
+	//Only return a position to continue from if another entry follows
+	next = index;
+	if (count < I2C_MAC_CHUNK_ENTRIES || !MACTableNext(MAC_TABLE_DYNAMIC, &next, &filter, &entry)) {
+		index = 0;
+	}
+	chunk[0] = (uint8_t)(index >> 8);
+	chunk[1] = (uint8_t)index;
+	I2CResponseAppend(chunk, 2 + (count * 8));
+	return (uint8_t)count;
+}
+//*****************************************************************************
+//
+//! Retrieve Port Status (for I2C Commands)
+//! Returns the I2C_PORT_STATUS_LENGTH control and status registers of a port
+//! in a single read.
+//!
+//! \param params[0] 8-bit base address of the port (see interpreter_task.h)
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_GetPortStatus(uint8_t params[MAX_PARAMS])
+{
+	uint32_t reg_data[I2C_PORT_STATUS_LENGTH];
+	uint8_t status[I2C_PORT_STATUS_LENGTH];
+	uint32_t reg;
 
-		//Delay for 40ms to allow other tasks to run
-        vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
+	if (!EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, params[0], I2C_PORT_STATUS_LENGTH, reg_data)) {
+		return false;
+	}
+	for (reg = 0; reg < I2C_PORT_STATUS_LENGTH; reg++) {
+		status[reg] = (uint8_t)reg_data[reg];
+	}
+	return I2CResponseAppend(status, I2C_PORT_STATUS_LENGTH);
+}
+//*****************************************************************************
+//
+//! Read Port Statistics (for I2C Commands)
+//! Returns I2C_PORT_STATS_LENGTH values for each port in a single read, f0 - f3
+//! first and exp-port last: the average received and transmitted bytes and
+//! packets per second, then the dropped packets and CRC errors since reset.
+//! Each value is 32 bits, most significant byte first.
+//!
+//! \return Returns false if no statistics were collected yet
+//
+//*****************************************************************************
+uint8_t I2C_ReadPortStatistics(uint8_t params[MAX_PARAMS])
+{
+	MIBPortStats stats;
+	uint8_t block[I2C_PORT_STATS_LENGTH * 4];
+	uint32_t values[I2C_PORT_STATS_LENGTH];
+	uint32_t i, pos, value;
+	//f0 - f3 are the KSZ8895MLUB's ports 4 - 1, exp-port is port 5
+	const uint8_t ports[MIB_PORT_COUNT] = {3, 2, 1, 0, 4};
+
+	for (i = 0; i < MIB_PORT_COUNT; i++) {
+		if (!MIBCountersGet(ports[i], &stats)) {
+			return false;
+		}
+		values[0] = stats.average[MIB_RX_BYTES];
+		values[1] = stats.average[MIB_TX_BYTES];
+		values[2] = stats.average[MIB_RX_PACKETS];
+		values[3] = stats.average[MIB_TX_PACKETS];
+		values[4] = (uint32_t)(stats.total[MIB_RX_DROPS] + stats.total[MIB_TX_DROPS]);
+		values[5] = (uint32_t)stats.total[MIB_CRC_ERRORS];
+		for (pos = 0; pos < I2C_PORT_STATS_LENGTH; pos++) {
+			value = values[pos];
+			block[(pos * 4) + 0] = (uint8_t)(value >> 24);
+			block[(pos * 4) + 1] = (uint8_t)(value >> 16);
+			block[(pos * 4) + 2] = (uint8_t)(value >> 8);
+			block[(pos * 4) + 3] = (uint8_t)value;
+		}
+		I2CResponseAppend(block, sizeof(block));
+	}
+	return true;
+}
+//*****************************************************************************
+//
+//! Read Cable Diagnostics (for I2C Commands)
+//! Returns the last cable test of each port without running a new one, f0
+//! first: I2C_CABLE_DIAG_LENGTH bytes per port holding the result (CableStatus,
+//! bit 7 set while a new test is running), the 16-bit distance to the fault in
+//! meters and the 32-bit age of the result in seconds, most significant byte
+//! first.
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+uint8_t I2C_ReadCableDiagnostics(uint8_t params[MAX_PARAMS])
+{
+	CableResult result;
+	uint8_t block[I2C_CABLE_DIAG_LENGTH];
+	int32_t port;
+
+	//f0 - f3 are the KSZ8895MLUB's ports 4 - 1
+	for (port = CABLE_DIAG_PORT_COUNT - 1; port >= 0; port--) {
+		CableDiagGet((uint8_t)port, &result);
+		block[0] = (uint8_t)result.status | (result.running ? 0x80 : 0x00);
+		block[1] = (uint8_t)(result.distance_m >> 8);
+		block[2] = (uint8_t)result.distance_m;
+		block[3] = (uint8_t)(result.age_s >> 24);
+		block[4] = (uint8_t)(result.age_s >> 16);
+		block[5] = (uint8_t)(result.age_s >> 8);
+		block[6] = (uint8_t)result.age_s;
+		I2CResponseAppend(block, sizeof(block));
+	}
+	return true;
+}
+//*****************************************************************************
+//
+//! Query Configuration Digest (for I2C Commands)
+//! Returns the 32-bit digest of sections of the saved configuration, most
+//! significant byte first. A layer copying its configuration compares it with
+//! its own to skip layers that are already up to date.
+//!
+//! \param params[0] mask of sections (see CONFIG_SECTION_MASK)
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+uint8_t I2C_SyncQuery(uint8_t params[MAX_PARAMS])
+{
+	uint32_t digest = ConfigStoreDigest(NULL, (params[0] & CONFIG_SECTIONS_ALL));
+	uint8_t block[4];
+
+	block[0] = (uint8_t)(digest >> 24);
+	block[1] = (uint8_t)(digest >> 16);
+	block[2] = (uint8_t)(digest >> 8);
+	block[3] = (uint8_t)digest;
+	return I2CResponseAppend(block, sizeof(block));
+}
+//*****************************************************************************
+//
+//! Begin Receiving A Configuration Section (for I2C Commands)
+//! Starts or resumes receiving a section of another layer's configuration.
+//! Returns the result followed by the 16-bit offset the master is to send
+//! from.
+//!
+//! \param params[0] the section (CONFIG_SECTION_*)
+//! \param params[1] upper 8 bits of the length of the section
+//! \param params[2] lower 8 bits of the length of the section
+//! \param params[3] - params[6] CRC-32 of the section, most significant byte first
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_SyncBegin(uint8_t params[MAX_PARAMS])
+{
+	uint32_t length = ((uint32_t)params[1] << 8) | params[2];
+	uint32_t crc = ((uint32_t)params[3] << 24) | ((uint32_t)params[4] << 16) | ((uint32_t)params[5] << 8) | params[6];
+	uint32_t offset;
+	uint8_t block[3];
+
+	block[0] = LayerSyncReceiveBegin(params[0], length, crc, &offset);
+	block[1] = (uint8_t)(offset >> 8);
+	block[2] = (uint8_t)offset;
+	I2CResponseAppend(block, sizeof(block));
+	return block[0];
+}
+//*****************************************************************************
+//
+//! Receive A Configuration Chunk (for I2C Commands)
+//! Stores the next chunk of the section being received.
+//!
+//! \param params[0] number of bytes that follow
+//! \param params[1] upper 8 bits of the offset of the chunk
+//! \param params[2] lower 8 bits of the offset of the chunk
+//! \param params[3] the chunk, followed by the CRC-32 of the offset and the
+//! chunk, most significant byte first
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_SyncData(uint8_t params[MAX_PARAMS])
+{
+	uint32_t length, offset, crc;
+	uint8_t *tail;
+
+	if (params[0] < 7) {
+		return false;
+	}
+	length = params[0] - 6;
+	offset = ((uint32_t)params[1] << 8) | params[2];
+	tail = &params[3 + length];
+	crc = ((uint32_t)tail[0] << 24) | ((uint32_t)tail[1] << 16) | ((uint32_t)tail[2] << 8) | tail[3];
+	return LayerSyncReceiveData(offset, &params[3], length, crc);
+}
+//*****************************************************************************
+//
+//! Commit A Received Configuration (for I2C Commands)
+//! Saves the sections received from another layer as a new generation of the
+//! configuration store and applies them.
+//!
+//! \param params[0] mask of sections copied (see CONFIG_SECTION_MASK)
+//! \param params[1] - params[4] the sender's digest of those sections, most
+//! significant byte first
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_SyncCommit(uint8_t params[MAX_PARAMS])
+{
+	uint32_t digest = ((uint32_t)params[1] << 24) | ((uint32_t)params[2] << 16) | ((uint32_t)params[3] << 8) | params[4];
+
+	//The staged changes of an open batch would be overwritten
+	if (SwitchBatchActive()) {
+		return false;
 	}
-		flag_data = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, 0x0001E);
-		flag_data &= ~(1 << 0x0);
-		EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, 0x0001E, flag_data);
+	if (!LayerSyncReceiveCommit(params[0], digest)) {
+		return false;
+	}
+	ConsolePrintf("\n[I2C]: Configuration received from another layer (generation %u)\n", ConfigStoreGeneration());
 	return true;
 }
 //*****************************************************************************
@@ -553,13 +861,13 @@ bool COM_ReadFromEthernetController(char *params[MAX_PARAMS])
 
 	uint8_t reg_addr = (uint8_t)strtol(params[0],NULL,16);
 	uint32_t reg_data;
-	UARTprintf("REG ADDR: 0x%08x\n", reg_addr);
-	UARTprintf("[RUNNING TASK]: Reading From Ethernet Controller 1 \n");
+	ConsolePrintfWait("REG ADDR: 0x%08x\n", reg_addr);
+	ConsolePrintfWait("[RUNNING TASK]: Reading From Ethernet Controller 1 \n");
 	ShowProgress(50);
 	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, reg_addr);
 	ShowProgress(100);
-	UARTprintf("\nData Read @ 0x%08x: 0x%08x", reg_addr, reg_data);
-	UARTprintf("\033[0m");
+	ConsolePrintfWait("\nData Read @ 0x%08x: 0x%08x", reg_addr, reg_data);
+	ConsolePrintfWait("\033[0m");
 	return true;
 	//Read specified register from controller 1
 }
@@ -600,27 +908,24 @@ bool COM_SetBitEthernetController(char *params[MAX_PARAMS])
 	uint32_t bit_to_set = (uint32_t)strtol(params[2],NULL,0);
 
 	//Parameter 4: Task Execution Text Printed to Command Line
-	UARTprintf("[RUNNING TASK]: %s \n", params[3]);
+	ConsolePrintfWait("[RUNNING TASK]: %s \n", params[3]);
 	ShowProgress(30);
 
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + offset));
+	EthoControllerModifyBits(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), 0, (1 << bit_to_set), &reg_data);
 	ShowProgress(60);
-	reg_data |= 1 << bit_to_set;
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), reg_data);
 
 	while (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset)) != reg_data) {
 		retry_attempts++;
 		if (retry_attempts > 10) {
 			ShowProgress(-1);
-			UARTprintf("\033[0m");
+			ConsolePrintfWait("\033[0m");
 			return false;
 		}
 		ShowProgress(40 + retry_attempts);
         vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
 	}
 	ShowProgress(100);
-	UARTprintf("\033[0m");
+	ConsolePrintfWait("\033[0m");
 	return true;
 }
 //*****************************************************************************
@@ -660,26 +965,22 @@ bool COM_ClearBitEthernetController(char *params[MAX_PARAMS])
 	uint32_t bit_to_set = (uint32_t)strtol(params[2],NULL,0);
 
 	//Parameter 4: Task Execution Text Printed to Command Line
-	UARTprintf("[RUNNING TASK]: %s \n", params[3]);
+	ConsolePrintfWait("[RUNNING TASK]: %s \n", params[3]);
 	ShowProgress(50);
 
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + offset));
-
-	reg_data &= ~(1 << bit_to_set);
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), reg_data);
+	EthoControllerModifyBits(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), (1 << bit_to_set), 0, &reg_data);
 	while (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset)) != reg_data) {
 		retry_attempts++;
 		if (retry_attempts > 10) {
 			ShowProgress(-1);
-			UARTprintf("\033[0m");
+			ConsolePrintfWait("\033[0m");
 			return false;
 		}
 		ShowProgress(40 + retry_attempts);
         vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
 	}
 	ShowProgress(100);
-	UARTprintf("\033[0m");
+	ConsolePrintfWait("\033[0m");
 	return true;
 }
 //*****************************************************************************
@@ -721,16 +1022,12 @@ bool COM_SetSCBitEthernetController(char *params[MAX_PARAMS])
 	uint32_t bit_to_set = (uint32_t)strtol(params[2],NULL,0);
 
 	//Parameter 4: Task Execution Text Printed to Command Line
-	UARTprintf("[RUNNING TASK]: %s \n", params[3]);
+	ConsolePrintfWait("[RUNNING TASK]: %s \n", params[3]);
 	ShowProgress(30);
 
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + offset));
-	ShowProgress(60);
-
 	//Set bit to '1' and write
-	reg_data |= 1 << bit_to_set;
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), reg_data);
+	EthoControllerModifyBits(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + offset), 0, (1 << bit_to_set), &reg_data);
+	ShowProgress(60);
 
 
 	//Reset bit to '0' and validate
@@ -740,145 +1037,180 @@ bool COM_SetSCBitEthernetController(char *params[MAX_PARAMS])
 		retry_attempts++;
 		if (retry_attempts > 10) {
 			ShowProgress(-1);
-			UARTprintf("\033[0m");
+			ConsolePrintfWait("\033[0m");
 			return false;
 		}
 		ShowProgress(40 + retry_attempts);
         vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
 	}
 	ShowProgress(100);
-	UARTprintf("\033[0m");
+	ConsolePrintfWait("\033[0m");
+	return true;
+}
+//*****************************************************************************
+//
+//! Waits for the cable tests of the given ports to finish. The UART mutex is
+//! not held, so other tasks may print meanwhile.
+//!
+//! \param port_mask bit n set for port n (0 - 3)
+//!
+//! \return Returns false if a test did not finish in time
+//
+//*****************************************************************************
+static bool CableDiagWait(uint32_t port_mask)
+{
+	uint32_t waited = 0;
+
+	//Every test gives up after CABLE_DIAG_MAX_POLLS checks, allow two more for starting and restoring
+	while ((CableDiagBusy() & port_mask) != 0) {
+		if (waited > ((CABLE_DIAG_MAX_POLLS + 2) * CABLE_DIAG_POLL_MS)) {
+			return false;
+		}
+		vTaskDelay(CABLE_DIAG_POLL_MS / portTICK_RATE_MS);
+		waited += CABLE_DIAG_POLL_MS;
+	}
 	return true;
 }
+
+//*****************************************************************************
+//
+//! Prints the last cable test result of the given ports, f0 first.
+//!
+//! \param port_mask bit n set for port n (0 - 3)
+//!
+//! \return Returns false if a port timed out or was never tested
+//
+//*****************************************************************************
+static bool ShowCableResults(uint32_t port_mask)
+{
+	CableResult result;
+	bool valid = true;
+	int32_t port;
+
+	ConsolePrintfWait("\n\t%-12s%-12s%14s%10s\n", "port", "cable", "fault at (m)", "age (s)");
+	//f0 - f3 are the KSZ8895MLUB's ports 4 - 1
+	for (port = CABLE_DIAG_PORT_COUNT - 1; port >= 0; port--) {
+		if ((port_mask & (1 << port)) == 0 || !CableDiagGet((uint8_t)port, &result)) {
+			continue;
+		}
+		if (result.status == CableUntested || result.status == CableTimeout) {
+			valid = false;
+		}
+		if (result.status == CableOpen || result.status == CableShort) {
+			ConsolePrintfWait("\t%-12s%-12s%14u%10u%s\n", MACTablePortName((uint8_t)port), CableStatusName(result.status),
+					result.distance_m, result.age_s, (result.running ? "  (testing)" : ""));
+		}
+		else {
+			ConsolePrintfWait("\t%-12s%-12s%14s%10u%s\n", MACTablePortName((uint8_t)port), CableStatusName(result.status),
+					"-", result.age_s, (result.running ? "  (testing)" : ""));
+		}
+	}
+	return valid;
+}
+
 //*****************************************************************************
 //
 //! Run Cable Diagnostics For Specified Port (for Command-Line Interface)
 //! Activates the Time Domain Reflectometry (TDR) function built into the ethernet
 //! controller for the port specified and writes the state (Short/Open/Normal) and
-//! distance to fault (in meters) back to the user's command-line
+//! distance to fault (in meters) back to the user's command-line. The test runs
+//! in the port monitor task, see cable_diag.h.
 //!
 //! \param params[0] 8-bit base address of the port to test (see interpreter_task.h)
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
 //!
-//! \return Returns with the result of the operation as a boolean
+//! \return Returns false if the test did not complete
 //
 //*****************************************************************************
 bool COM_RunCableDiagnostics(char *params[MAX_PARAMS]) {
-     uint32_t reg_data = 0, fault_distance = 0, cable_state = 0;
-	 portTickType ui32WakeTime;
-	 uint32_t retry_attempts = 0;
-
-	 //This task takes a while, so we want share nicely with other tasks instead of blocking
-	 uint32_t ui32TaskDelay = LONG_RUNNING_TASK_DLY;
-
-	 //Get system time in ticks
-	 ui32WakeTime = xTaskGetTickCount();
-
 	//Parameter 1: Register Base Address
 	uint32_t reg_addr = (uint32_t)strtol(params[0],NULL,0);
+	//Port base addresses 0x10 - 0x40 belong to the KSZ8895MLUB's ports 1 - 4
+	uint32_t port_mask = (1 << ((reg_addr >> 4) - 1));
 
 	//Task Execution Text Printed to Command Line
-	UARTprintf("[RUNNING TASK]: Running Link MD for selected port, please wait... \n");
+	ConsolePrintfWait("[RUNNING TASK]: Running Link MD for selected port, please wait... \n");
+	if (!CableDiagStart(port_mask) || !CableDiagWait(port_mask)) {
+		return false;
+	}
+	return ShowCableResults(port_mask);
+}
 
-	//Disable auto-negotiation
-	ShowProgress(10);
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL5_OFFSET_HEX));
-	ShowProgress(15);
+//*****************************************************************************
+//
+//! Run Cable Diagnostics On All Ports (for Command-Line Interface)
+//! Tests every port at once and lists the results. Each port loses its link
+//! until its test has finished.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns false if a test did not complete
+//
+//*****************************************************************************
+bool COM_RunAllCableDiagnostics(char *params[MAX_PARAMS]) {
+	ConsolePrintfWait("[RUNNING TASK]: Running Link MD on all ports, please wait... \n");
+	if (!CableDiagStart(CABLE_DIAG_ALL_PORTS) || !CableDiagWait(CABLE_DIAG_ALL_PORTS)) {
+		return false;
+	}
+	return ShowCableResults(CABLE_DIAG_ALL_PORTS);
+}
 
-	//Set bit to '1' and write to disable auto-negotiation
-	reg_data |= 1 << 0x07;
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL5_OFFSET_HEX), reg_data);
-	ShowProgress(20);
+//*****************************************************************************
+//
+//! Show Cable Diagnostics Results (for Command-Line Interface)
+//! Lists the last cable test of every port, including those run by the
+//! background scan. Does not access the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+bool COM_ShowCableDiagnostics(char *params[MAX_PARAMS]) {
+	uint32_t minutes = CableDiagGetScan();
 
-	//Disable auto-MDI/MDIX
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL6_OFFSET_HEX));
-	ShowProgress(25);
+	ShowCableResults(CABLE_DIAG_ALL_PORTS);
+	if (minutes == 0) {
+		ConsolePrintfWait("\nBackground scan: disabled\n");
+	}
+	else {
+		ConsolePrintfWait("\nBackground scan: ports without a link every %u minutes\n", minutes);
+	}
+	return true;
+}
 
-	//Set bit to '1' and write to disable auto-negotiation
-	reg_data |= 1 << 0x02;
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL6_OFFSET_HEX), reg_data);
-	ShowProgress(30);
+//*****************************************************************************
+//
+//! Set Cable Diagnostics Scan Interval (for Command-Line Interface)
+//! Sets how often ports without a link are tested in the background. The
+//! interval is not saved and is disabled after a reset.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] interval in minutes (0 - CABLE_DIAG_MAX_SCAN_MINUTES), 0 disables the scan
+//!
+//! \return Returns false if the interval is invalid
+//
+//*****************************************************************************
+bool COM_SetCableDiagScan(char *params[MAX_PARAMS]) {
+	char *end;
+	uint32_t minutes = (uint32_t)strtoul(params[0], &end, 10);
 
-	//LINKMD: Start Diagnostics
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_LINKMD0_OFFSET_HEX));
-	ShowProgress(35);
-
-	//Set bit to '1' and write to start LinkMD
-	reg_data |= 1 << 0x04;
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + PORT_LINKMD0_OFFSET_HEX), reg_data);
-	ShowProgress(40);
-
-	//Poll for completion of LinkMD process and obtain results
-	reg_data &= ~(1 << 0x04);
-
-	while (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + PORT_LINKMD0_OFFSET_HEX)) != reg_data) {
-		retry_attempts++;
-		if (retry_attempts > 10) {
-			ShowProgress(-1);
-			UARTprintf("\033[0m");
-			return false;
-		}
-		ShowProgress(40 + retry_attempts);
-        vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-	}
-	//LinkMD finished
-	ShowProgress(55);
-
-	//Get cable diagnostics results
-	cable_state = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_LINKMD0_OFFSET_HEX));
-	cable_state &= 0x60;
-	ShowProgress(60);
-	//Get distance to cable fault reading
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_LINKMD0_OFFSET_HEX));
-	reg_data &= 0x01;
-	ShowProgress(70);
-	reg_data += EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_LINKMD1_OFFSET_HEX));
-	ShowProgress(80);
-	fault_distance = (0.4 * (reg_data - 26));
-
-	//Enable auto-negotiation
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL5_OFFSET_HEX));
-
-	reg_data &= ~(1 << 0x07);
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL5_OFFSET_HEX), reg_data);
-
-	//Enable AutoMDI/MDI-X
-	reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE,ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL6_OFFSET_HEX));
-
-	reg_data &= ~(1 << 0x02);
-
-	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (reg_addr + PORT_CONTROL6_OFFSET_HEX), reg_data);
-
-
-	ShowProgress(100);
-	switch (cable_state) {
-	case 0x00:
-		ShowProgress(100);
-		UARTprintf("\n\tLINK CABLE: Normal\n");
-		UARTprintf("\033[0m");
-		return true;
-	case 0x20:
-		UARTprintf("\n\tLINK CABLE: Open Detected In Cable\n");
-		break;
-	case 0x40:
-		UARTprintf("\n\tLINK CABLE: Short Detected In Cable\n");
-		break;
-	case 0x60:
-		UARTprintf("\n\tLINK CABLE: Cable Diagnostics Failed\n");
-		break;
-	default:
-		UARTprintf("n\tLINK CABLE: An unknown error occurred while testing\n");
-		break;
-	}
-	UARTprintf("\tDISTANCE TO FAULT: %d", fault_distance);
-	UARTprintf("\033[0m");
-	return true;
-
-
-}
+	if (params[0][0] == '\0' || *end != '\0' || !CableDiagSetScan(minutes)) {
+		ConsolePrintfWait("The interval must be between 0 and %u minutes.\n", CABLE_DIAG_MAX_SCAN_MINUTES);
+		return false;
+	}
+	return true;
+}
 
 //*****************************************************************************
 //
@@ -899,14 +1231,14 @@ bool COM_WriteToEthernetController(char *params[MAX_PARAMS])
 {
 
 	uint8_t reg_addr = (uint8_t)strtol(params[0],NULL,16);
-	UARTprintf("REG ADDR: 0x%08x\n", reg_addr);
+	ConsolePrintfWait("REG ADDR: 0x%08x\n", reg_addr);
 	uint8_t reg_data = (uint8_t)strtol(params[1],NULL,16);
 
 	//The new value for the specified register
 	uint32_t read_data;
 
-	UARTprintf("REG DATA: 0x%08x\n", reg_data);
-	UARTprintf("[RUNNING TASK]: Writing To Ethernet Controller 1 \n");
+	ConsolePrintfWait("REG DATA: 0x%08x\n", reg_data);
+	ConsolePrintfWait("[RUNNING TASK]: Writing To Ethernet Controller 1 \n");
 
 	ShowProgress(50);
 
@@ -916,15 +1248,15 @@ bool COM_WriteToEthernetController(char *params[MAX_PARAMS])
 	read_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, reg_addr);
 	if (read_data == reg_data) {
 		ShowProgress(100);
-		UARTprintf("\nData Written To @ 0x%08x: 0x%08x", reg_addr, read_data);
+		ConsolePrintfWait("\nData Written To @ 0x%08x: 0x%08x", reg_addr, read_data);
 	}
 	else {
 		ShowProgress(-1);
-		UARTprintf("\033[0m");
+		ConsolePrintfWait("\033[0m");
 		return false;
 	}
 
-	UARTprintf("\033[0m");
+	ConsolePrintfWait("\033[0m");
 
 	return true;
 
@@ -995,188 +1327,28 @@ bool COM_SetVLANEntry(char *params[MAX_PARAMS]) {
 	uint32_t port_addr = (uint32_t)strtol(params[0],NULL,0);
 	//Parameter 2: VLAN ID
 	uint32_t vlan_id = (uint32_t)strtol(params[1],NULL,0);
-
-	if (vlan_id > 4095) {
-		UARTprintf("VLAN entered is out of range. Valid options are 1 - 4095");
-		return false;
-	}
 	uint8_t port_membership = 0x00;
 
-	uint32_t indirect_reg_addr = (vlan_id / 4), indirect_reg_data = 0x00;
-	//Obtain current indirect access data 0 and modify
-	uint32_t indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0);
-	//Select VLAN table, set operation mode to READ, and set 2 bits from MSB of indirect_reg_addr in bits 0 and 1 of this register
-	indirect_access_data |= (INDIRECT_TABLESELECT_VLAN << INDIRECT_CONTROL_TABLESELECT) | (INDIRECT_READTYPE_READ << INDIRECT_CONTROL_READTYPEBIT) | (((indirect_reg_addr >> 8) & 0xFF) << INDIRECT_CONTROL_ADDRESS_HIGH);
-	//Write the modified register to the Ethernet Controller
-	if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, indirect_access_data))
-	{
-		return false;
-	}
-	//Obtain current indirect access data 1 and modify
-	indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_1);
-	//Set this register to the remaining 8 bits of the 10-bit indirect_reg_addr
-	indirect_access_data = (indirect_reg_addr & 0xFF);
-	if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_1, indirect_access_data))
-	{
-		return false;
-	}
-
-	//VLAN SETTINGS MODIFICATION START HERE
-	/*Each indirect register contains informatin for four VLANs organized in the following way:
-	* ENTRY 0 (12 bits) maps to first VLAN, indirect bits (12-0): register 119 (bits 4-0), register 120 (bits 7-0)
-	* ENTRY 1 (12 bits) maps to second VLAN, indirect bits (25-13): register 117 (bits 1-0), register 118 (bits 7-0), register 119 (bits 7-5)
-	* ENTRY 2 (12 bits) maps to third VLAN, indirect bits (38-26): register 116 (bits 6-0), register 117 (7-2)
-	* ENTRY 3 (12 bits) maps to fourth VLAN, indirect bits (51-39): register 114 (bits 3-0), register 115 (7-0), register 116 (bit 7);
-	*
-	* VLAN GROUP = (VLAN_ID / 4)
-	* VLAN = VLAN GROUP % 4
-	*/
-	switch (vlan_id % 4) {
-	//User requested a change to the first VLAN in GROUP X
-	case 0:
-		//Get the information held in register 119
-		indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_1);
-		//Set VLAN entry to VALID
-		indirect_reg_data |= (1 << 4);
-
-		//Read current port membership data
-		port_membership = (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_1) & 0xF) + (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_0) >> 7);
-		//Set bit corresponding to currently selected port
-		port_membership = AssertVLANS(vlan_id, port_addr); //SetPortMembershipBits(port_membership, port_addr);
-
-		//Place first four bits of port_membership value into bits [3-0] of indirect register 119
-		indirect_reg_data |= ((port_membership >> 1 ) << 0);
-		//Overwrite register 119 with updated information
-		if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_1, indirect_reg_data))
-		{
-			return false;
-		}
-		//Get the information held in register 120
-		indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_0);
-		//Place the fifth bit into bit 7 of indirect register 120
-		indirect_reg_data |= ((port_membership & 0x01) << 7);
-		//Overwrite register 120 with updated information
-		if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_0, indirect_reg_data))
-		{
-			return false;
-		}
-		break;
-	//User requested a change to the second VLAN in GROUP X
-	case 1:
-		//Get the information held in register 117
-		indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_3);
-		//Set VLAN entry to VALID
-		indirect_reg_data |= (1 << 1);
-
-		//Read current port membership data
-		port_membership = (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_3) & 0x01) + (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_2) >> 4);
-		//Set bit corresponding to currently selected port
-		port_membership = AssertVLANS(vlan_id, port_addr); //SetPortMembershipBits(port_membership, port_addr);
-
-		//Place first bit of port_membership value into bit [0] of indirect register 117
-		indirect_reg_data |= ((port_membership >> 4 ) << 0);
-		//Overwrite register 117 with updated information
-		if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_3, indirect_reg_data))
-		{
-			return false;
-		}
-		//Get the information held in register 118
-		indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_2);
-		//Place the last four bits of port_membership value into bits [7-4] of indirect register 118
-		indirect_reg_data |= ((port_membership & 0xF) << 4);
-		//Overwrite register 118 with updated information
-		if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_2, indirect_reg_data))
-		{
-			return false;
-		}
-		break;
-	//User requested a change to the third VLAN in GROUP X
-	case 2:
-		//Get the information held in register 116
-		indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_4);
-		//Set VLAN entry to VALID
-		indirect_reg_data |= (1 << 6);
-
-		//Read current port membership data
-		port_membership = (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_4) >> 1);
-		//Set bit corresponding to currently selected port
-		port_membership = AssertVLANS(vlan_id, port_addr); //SetPortMembershipBits(port_membership, port_addr);
-
-		//Place port_membership value into bits [5-1] of indirect register 116
-		indirect_reg_data |= ((port_membership) << 1);
-		//Overwrite register 116 with updated information
-		if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_4, indirect_reg_data))
-		{
-			return false;
-		}
-		break;
-	//User requested a change to the fourth VLAN in GROUP X
-	case 3:
-		//Get the information held in register 114
-		indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_6);
-		//Set VLAN entry to VALID
-		indirect_reg_data |= (1 << 3);
-
-		//Read current port membership data
-		port_membership = (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_6) & 0x07) + (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_5) >> 6);
-		//Set bit corresponding to currently selected port
-		port_membership = AssertVLANS(vlan_id, port_addr); //SetPortMembershipBits(port_membership, port_addr);
-
-		//Place first three bits of port_membership value into bits [2-0] of indirect register 114
-		indirect_reg_data |= ((port_membership >> 2 ) << 0);
-		//Overwrite register 114 with updated information
-		if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_6, indirect_reg_data))
-		{
-			return false;
-		}
-		//Get the information held in register 115
-		indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_5);
-		//Place the last two bits of port_membership value into bits [7-6] of indirect register 115
-		indirect_reg_data |= ((port_membership & 0x3) << 6);
-		//Overwrite register 115 with updated information
-		if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_5, indirect_reg_data))
-		{
-			return false;
-		}
-		break;
-	}
-
-	uint8_t temp_data = 0x80;
-	temp_data += port_membership;
-	if (!EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(0x200 + (vlan_id - 1)),temp_data)) {
-		return false;
-	}
-
-	//Obtain current indirect access data 0 and modify
-	indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0);
-	//Select VLAN table, set operation mode to READ, and set 2 bits from MSB of indirect_reg_addr in bits 0 and 1 of this register
-	indirect_access_data &= ~0x1f;
-	indirect_access_data |= (INDIRECT_TABLESELECT_VLAN << INDIRECT_CONTROL_TABLESELECT) | (INDIRECT_READTYPE_WRITE << INDIRECT_CONTROL_READTYPEBIT) | (((indirect_reg_addr >> 8) & 0xFF) << INDIRECT_CONTROL_ADDRESS_HIGH);
-	//Write the modified register to the Ethernet Controller
-	if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, indirect_access_data))
-	{
-		return false;
-	}
-	//Obtain current indirect access data 1 and modify
-	indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_1);
-	//Set this register to the remaining 8 bits of the 10-bit indirect_reg_addr
-	indirect_access_data = (indirect_reg_addr & 0xFF);
-	if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_1, indirect_access_data))
-	{
+	if (vlan_id == 0 || vlan_id > 4095) {
+		ConsolePrintfWait("VLAN entered is out of range. Valid options are 1 - 4095");
 		return false;
 	}
 
+	//Add the ports found on this VLAN to any membership the entry already has
+	VLANGetEntry(vlan_id, &port_membership);
+	port_membership |= AssertVLANS(vlan_id, port_addr);
 
-
-	return true;
+	//Update the membership map and write the whole group of four in one indirect access.
+	//The EEPROM image is written from the map by "config save"
+	return VLANSetEntry(vlan_id, true, port_membership);
 }
 
 //*****************************************************************************
 //
 //! Display VLAN Table (for Command-Line Interface)
-//! Writes all active VLAN Table entries to the Command-Line Interface. This
-//! function is a long-running task and takes approximately 20 seconds to fully
-//! compile the VLAN table.
+//! Writes all active VLAN Table entries to the Command-Line Interface. Entries
+//! are taken from the RAM membership map kept by the VLAN table engine, ten
+//! entries per screen.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -1186,115 +1358,99 @@ bool COM_SetVLANEntry(char *params[MAX_PARAMS]) {
 //*****************************************************************************
 bool COM_ShowVLANTable(char *params[MAX_PARAMS]) {
 	uint32_t vlan_id = 1, item_count = 0;
-	uint8_t vlan_data;
+	uint8_t vlan_membership;
 	int item_index = 0;
 
-	portTickType ui32WakeTime;
 	bool ContinueRequested = false;
 
 	VLANTableEntry Entries[10];
 
-	//This task takes a while, so we want share nicely with other tasks instead of blocking
-	uint32_t ui32TaskDelay = SHORT_TASK_DLY;
-
-	//Get system time in ticks
-	ui32WakeTime = xTaskGetTickCount();
 
-
-	UARTprintf("[Compiling VLAN Table]: Please wait...\n");
+	ConsolePrintfWait("[Compiling VLAN Table]: Please wait...\n");
 	//Compile VLAN Table
 	for (;vlan_id < 4096; vlan_id++) {
-		vlan_data = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(0x200 + (vlan_id - 1)));
-
 		//If this entry is valid (active), add this record to VLAN table
-		if ((vlan_data & 0x80) == 0x80) {
-			if (vlan_id == 0 || vlan_id > 4095) {
-				continue;
-			}
-			if (item_count > 10) {
+		if (VLANGetEntry(vlan_id, &vlan_membership)) {
+			if (item_count >= 10) {
 				//Pause here, display entries and display menu (Next or Exit)
 				while (!ContinueRequested) {
 					char option_entered;
 
-					UARTprintf("\nVLAN ID    STATUS     PORTS ASSIGNED\n");
+					ConsolePrintfWait("\nVLAN ID    STATUS     PORTS ASSIGNED\n");
 					for (item_index = 0; item_index < 10; item_index++) {
-						UARTprintf("%d", Entries[item_index].VLAN_ID);
+						ConsolePrintfWait("%d", Entries[item_index].VLAN_ID);
 						if (Entries[item_index].VLAN_ID < 10)
-							UARTprintf("   ");
+							ConsolePrintfWait("   ");
 						if (Entries[item_index].VLAN_ID < 100)
-							UARTprintf("  ");
+							ConsolePrintfWait("  ");
 						if (Entries[item_index].VLAN_ID < 1000)
-							UARTprintf(" ");
-						UARTprintf("    %s    ", "Active");
+							ConsolePrintfWait(" ");
+						ConsolePrintfWait("    %s    ", "Active");
 						if (Entries[item_index].PORT_REGISTRATION & 0x20)
-							UARTprintf("fast-eth0 ");
+							ConsolePrintfWait("fast-eth0 ");
 						if (Entries[item_index].PORT_REGISTRATION & 0x10)
-							UARTprintf("fast-eth1 ");
+							ConsolePrintfWait("fast-eth1 ");
 						if (Entries[item_index].PORT_REGISTRATION & 0x08)
-							UARTprintf("fast-eth2 ");
+							ConsolePrintfWait("fast-eth2 ");
 						if (Entries[item_index].PORT_REGISTRATION & 0x04)
-							UARTprintf("fast-eth3 ");
-
-						UARTprintf("\n");
-					}
-					UARTprintf("\n\nSelect An Option:: [N]: Next, [E]: Exit\n");
-					//Disable console logging
-					UARTEchoSet(false);
+							ConsolePrintfWait("fast-eth3 ");
 
-					while (!UARTRxBytesAvail()) {
-						uint32_t currentTime = xTaskGetTickCount();
-						vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
+						ConsolePrintfWait("\n");
 					}
-					option_entered = UARTgetc();
+					ConsolePrintfWait("\n\nSelect An Option:: [N]: Next, [E]: Exit\n");
+					//Read the menu keys without echo
+					ConsoleKeyMode(true);
+					option_entered = ConsoleReadKey();
 
 					switch (option_entered) {
 						//User wants to exit menu
 						case 'E': case 'e':
-							UARTEchoSet(true);
+							ConsoleKeyMode(false);
 							return true;
 						case 'N': case 'n':
 							ContinueRequested = true;
 							item_count = 0;
 							item_index = 0;
-							UARTEchoSet(true);
+							ConsoleKeyMode(false);
 							break;
 					}
 				}
+				ContinueRequested = false;
 			}
 
 			Entries[item_index].VLAN_ID = vlan_id;
-			Entries[item_index].PORT_REGISTRATION = (vlan_data & 0x7C);
+			//Keep the port bits in the position used by the EEPROM VLAN image
+			Entries[item_index].PORT_REGISTRATION = (vlan_membership << 2);
 			Entries[item_index].isActive = true;
 
 			item_index++;
 			item_count++;
 		}
-        vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
 	}
-	UARTprintf("\nVLAN ID    STATUS     PORTS ASSIGNED\n");
+	ConsolePrintfWait("\nVLAN ID    STATUS     PORTS ASSIGNED\n");
 	if (!item_count) {
-		UARTprintf("==== NO ENTRIES FOUND IN VLAN TABLE ====");
+		ConsolePrintfWait("==== NO ENTRIES FOUND IN VLAN TABLE ====");
 		return true;
 	}
 	for (item_index = 0; item_index < item_count; item_index++) {
-			UARTprintf("%d", Entries[item_index].VLAN_ID);
+			ConsolePrintfWait("%d", Entries[item_index].VLAN_ID);
 			if (Entries[item_index].VLAN_ID < 10)
-				UARTprintf("   ");
+				ConsolePrintfWait("   ");
 			if (Entries[item_index].VLAN_ID < 100)
-				UARTprintf("  ");
+				ConsolePrintfWait("  ");
 			if (Entries[item_index].VLAN_ID < 1000)
-				UARTprintf(" ");
-			UARTprintf("   %s   ", "Active");
+				ConsolePrintfWait(" ");
+			ConsolePrintfWait("   %s   ", "Active");
 			if (Entries[item_index].PORT_REGISTRATION & 0x20)
-				UARTprintf("fast-eth0 ");
+				ConsolePrintfWait("fast-eth0 ");
 			if (Entries[item_index].PORT_REGISTRATION & 0x10)
-				UARTprintf("fast-eth1 ");
+				ConsolePrintfWait("fast-eth1 ");
 			if (Entries[item_index].PORT_REGISTRATION & 0x08)
-				UARTprintf("fast-eth2 ");
+				ConsolePrintfWait("fast-eth2 ");
 			if (Entries[item_index].PORT_REGISTRATION & 0x04)
-				UARTprintf("fast-eth3 ");
+				ConsolePrintfWait("fast-eth3 ");
 
-			UARTprintf("\n");
+			ConsolePrintfWait("\n");
 
 	}
 	return true;
@@ -1362,16 +1518,72 @@ bool COM_ReinitializeEEPROM(char *params[MAX_PARAMS]){
 	{
 		return false;
 	}
-	UARTprintf("[IMPORTANT]: Reboot required for changes to take effect!\n");
+	ConsolePrintfWait("[IMPORTANT]: Reboot required for changes to take effect!\n");
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Begin A Batch (for Command-Line Interface)
+//! Opens a batch for the command-line. Until COM_BatchCommit is issued, register
+//! changes are staged in the register shadow and VLAN changes in the RAM
+//! membership map instead of being written to the Ethernet Controller one by one.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_BatchBegin(char *params[MAX_PARAMS]) {
+	if (SwitchBatchActive()) {
+		ConsolePrintfWait("A batch is already open. Use 'config commit' to apply it.\n");
+		return true;
+	}
+	if (!SwitchBatchBegin()) {
+		ConsolePrintfWait("A batch is open on another interface, try again later.\n");
+		return false;
+	}
+	ConsolePrintfWait("Batch opened. Changes are applied by 'config commit'.\n");
 	return true;
 }
 
+//*****************************************************************************
+//
+//! Commit A Batch (for Command-Line Interface)
+//! Applies everything changed since COM_BatchBegin in a single pass and reports
+//! the aggregated result of the batch.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_BatchCommit(char *params[MAX_PARAMS]) {
+	SwitchBatchResult summary;
+	bool result;
+
+	if (!SwitchBatchActive()) {
+		ConsolePrintfWait("No batch is open. Use 'config begin' to open one.\n");
+		return false;
+	}
+	result = SwitchBatchCommit(&summary);
+	ConsolePrintfWait("\n==== BATCH COMMITTED ====\n");
+	ConsolePrintfWait("\tCommands:      %d (%d failed)\n", summary.commands, summary.failed);
+	ConsolePrintfWait("\tRegisters:     %d in %d bursts\n", summary.registers, summary.bursts);
+	ConsolePrintfWait("\tVLAN groups:   %d\n", summary.vlan_groups);
+	ConsolePrintfWait("\tCommit time:   %d.%03d ms\n", (summary.commit_us / 1000), (summary.commit_us % 1000));
+	return result;
+}
+
 //*****************************************************************************
 //
 //! Delete Configuration (for Command-Line Interface)
-//! Sets the flag for loading configuration and VLANs in EEPROM register 0x1E
-//! back to a logic low level. When rebooting the switch, the configuration and
-//! VLAN values will not be loaded.
+//! Commits a new generation of the configuration store without the saved
+//! switch configuration and VLANs, and clears the legacy flags in EEPROM
+//! register 0x1E. When rebooting the switch, the configuration and VLAN values
+//! will not be loaded.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -1388,15 +1600,20 @@ bool COM_DeleteConfig(char *params[MAX_PARAMS]) {
 	if (!EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_SETTINGS, FirmwareSettings)) {
 		return false;
 	}
+	if (!ConfigStoreCommit(0, (CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH) | CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS)), EEPROMPageBuffer, NULL)) {
+		return false;
+	}
+	EthoShadowMarkRange(0, ETHO_SHADOW_SIZE, true);
 	return true;
 }
 
 //*****************************************************************************
 //
 //! Save Running Configuration to EEPROM (for Command-Line Interface)
-//! Saves all registers from 0x00 to 0xFF inside the ethernet controller to
-//! the corresponding EEPROM registers (0x100 - 0x1FF) an reports on the
-//! success or failure of the operation.
+//! Commits the Ethernet Controller registers (0x00 - 0xFE), the user database
+//! and, when VLANs are enabled, the VLAN table to the configuration store as a
+//! single new generation. Sections that did not change since the last commit
+//! are not rewritten. Reports on the success or failure of the operation.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -1406,226 +1623,89 @@ bool COM_DeleteConfig(char *params[MAX_PARAMS]) {
 //*****************************************************************************
 bool COM_SaveSwitchConfiguration(char *params[MAX_PARAMS])
 {
-	 uint32_t read_addr = 0x00, eeprom_eth0_addr = 0x100, eeprom_vlan_addr = 0x200, vlan_id = 1;
-	 int progress = 0, task = 1;
-	 uint8_t flag_data = 0x00;
-	 portTickType ui32WakeTime;
-
-	 //This task takes a while, so we want share nicely with other tasks instead of blocking
-	 uint32_t ui32TaskDelay = SHORT_TASK_DLY;
-
-	 //Get system time in ticks
-	 ui32WakeTime = xTaskGetTickCount();
-
-	 UARTEchoSet(false);
-	//Get current system flags from EEPROM
-	flag_data = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, FLAG_BASE);
-
-	 UARTprintf("[%d]: Saving Ethernet Controller Configuration To EEPROM (%d%%)\n", task, (task*25));
-	 //Display progress bar
-	 progress = CreateProgressBar();
-
-	 for (read_addr = 0; read_addr < 0xFF; read_addr++)
-	{
-		//Update progress of task to user
-		//ShowProgress((read_addr * 100)/0xFF);
-		UpdateProgressBar(&progress, Increment, (100*read_addr)/0xFF);
+	 uint32_t update = CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH) | CONFIG_SECTION_MASK(CONFIG_SECTION_USERS);
+	 uint32_t remove = 0, written = 0;
+	 int progress = 0;
+	 SPIPriority priority;
+	 bool committed;
 
-		//Read data at address "read_addr" from Ethernet Controller 1
-		uint8_t data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, read_addr);
+	 //The staged changes of an open batch are not on the Ethernet Controller yet
+	 if (SwitchBatchActive()) {
+		 ConsolePrintfWait("Commit the open batch (config commit) before saving.\n");
+		 return false;
+	 }
 
-		//Save this information to the next sector in EEPROM
-		if (!EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, eeprom_eth0_addr, data)) {
-			//We encountered a bad write cycle, report this to the user
-			return false;
-		}
-
-		//Increment to the next sector in EEPROM
-		eeprom_eth0_addr++;
-
-		//Delay for 40ms to allow other tasks to run
-        vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-	}
-
-	//Set CONFIG_SAVED flag
-	flag_data |= 1 << FLAG_CONFIG_SAVED;
-	task++;
-
-	//Write VLAN entries to EEPROM (Start: 0x200, End 0x11FF)
-	//8-bit register
-	//7 : Entry is valid/not valid/not
-	//6 - 2 : Membership ID bits
+	 ConsoleEchoSet(false);
 
+	//VLANs are only kept while VLAN support is enabled
 	uint32_t global_control_3 = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_3_HEX);
-	if (global_control_3 && 0x80) {
-		//If VLANs are enabled, Save the changes!
-		UARTprintf("\n[%d]: Saving VLANs To EEPROM (%d%%)\n", task, (task*25));
-		progress = CreateProgressBar();
-		ui32TaskDelay = VERY_SHORT_TASK_DLY;
-		for (vlan_id = 0;vlan_id < 16; vlan_id++) {
-			EEPROMPageErase(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, (eeprom_vlan_addr + (vlan_id*256)));
-		}
-		for (vlan_id = 1;vlan_id < 4096; vlan_id++) {
-			uint32_t indirect_reg_addr = (vlan_id / 4), indirect_reg_data = 0x00, port_membership = 0x00, vlan_status = 0x00;
-			uint32_t indirect_reg_values[7] = {0x00};
-
-			//Obtain current indirect access data 0 and modify
-			uint32_t indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0);
-			//Select VLAN table, set operation mode to READ, and set 2 bits from MSB of indirect_reg_addr in bits 0 and 1 of this register
-			indirect_access_data |= (INDIRECT_TABLESELECT_VLAN << INDIRECT_CONTROL_TABLESELECT) | (INDIRECT_READTYPE_READ << INDIRECT_CONTROL_READTYPEBIT) | (((indirect_reg_addr >> 8) & 0xFF) << INDIRECT_CONTROL_ADDRESS_HIGH);
-			//Write the modified register to the Ethernet Controller
-			if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, indirect_access_data))
-			{
-				return false;
-			}
-			//Obtain current indirect access data 1 and modify
-			indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_1);
-			//Set this register to the remaining 8 bits of the 10-bit indirect_reg_addr
-			indirect_access_data = (indirect_reg_addr & 0xFF);
-			if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_1, indirect_access_data))
-			{
-				return false;
-			}
-			//Read all indirect register values
-			EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_6, 7, indirect_reg_values);
-
-			//VLAN SETTINGS MODIFICATION START HERE
-			/*Each indirect register contains informatin for four VLANs organized in the following way:
-			* ENTRY 0 (12 bits) maps to first VLAN, indirect bits (12-0): register 119 (bits 4-0), register 120 (bits 7-0)
-			* ENTRY 1 (12 bits) maps to second VLAN, indirect bits (25-13): register 117 (bits 1-0), register 118 (bits 7-0), register 119 (bits 7-5)
-			* ENTRY 2 (12 bits) maps to third VLAN, indirect bits (38-26): register 116 (bits 6-0), register 117 (7-2)
-			* ENTRY 3 (12 bits) maps to fourth VLAN, indirect bits (51-39): register 114 (bits 3-0), register 115 (7-0), register 116 (bit 7);
-			*
-			* VLAN GROUP = (VLAN_ID / 4)
-			* VLAN = VLAN GROUP % 4
-			*/
-			switch (vlan_id % 4) {
-			//First VLAN in GROUP X
-			case 0:
-				//Get the information held in register 119
-				indirect_reg_data = indirect_reg_values[5];
-				//Get VLAN status (0 : Entry is invalid, 1: Entry is valid)
-				vlan_status |= (indirect_reg_data & 0x10) >> 4;
-				//Read current port membership data
-				port_membership = (indirect_reg_values[5] & 0xF) + (indirect_reg_values[6] >> 7);
-				break;
-			//Second VLAN in GROUP X
-			case 1:
-				//Get the information held in register 117
-				indirect_reg_data = indirect_reg_values[3];
-				//Get VLAN status (0 : Entry is invalid, 1: Entry is valid)
-				vlan_status |= (indirect_reg_data & 0x02) >> 1;
-				//Read current port membership data
-				port_membership = (indirect_reg_values[3] & 0x01) + (indirect_reg_values[4] >> 4);
-				break;
-			//Third VLAN in GROUP X
-			case 2:
-				//Get the information held in register 116
-				indirect_reg_data = indirect_reg_values[2];
-				//Get VLAN status (0 : Entry is invalid, 1: Entry is valid)
-				vlan_status |= (indirect_reg_data & 0x40) >> 2;
-				//Read current port membership data
-				port_membership = (indirect_reg_values[2] >> 1);
-				break;
-			//Fourth VLAN in GROUP X
-			case 3:
-				//Get the information held in register 114
-				indirect_reg_data = indirect_reg_values[0];
-				//Get VLAN status (0 : Entry is invalid, 1: Entry is valid)
-				vlan_status |= (indirect_reg_data & 0x08) >> 3;
-				//Read current port membership data
-				port_membership = (indirect_reg_values[0] & 0x07) + (indirect_reg_values[1] >> 6);
-				break;
-			}
-
-			//Save aquired VLAN information to temporary 8-bit integer
-			uint8_t vlan_data = 0x00;
-			vlan_data |= vlan_status << 7;
-			vlan_data |= port_membership << 2;
-			//Write aquired data to current register in EEPROM (vlan_id normalized to zero by subtracting one from current value)
-			if (!EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, (eeprom_vlan_addr + (vlan_id - 1)), vlan_data)) {
-				return false;
-			}
-
-			UpdateProgressBar(&progress, Increment, (100*vlan_id)/4096);
-
-			vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-		}
-
-		flag_data |= 1 << FLAG_CONFIG_VLAN_VALID;
-		task++;
+	if (global_control_3 & 0x80) {
+		update |= CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS);
 	}
 	else {
-		flag_data &= ~(1 << FLAG_CONFIG_VLAN_VALID);
+		remove |= CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS);
 	}
 
-	UARTprintf("\n[%d]: Saving Updated User Database To EEPROM (%d%%)\n", task, (task*25));
+	ConsolePrintfWait("[1]: Saving Configuration To EEPROM (Generation %d)\n", (ConfigStoreGeneration() + 1));
 	progress = CreateProgressBar();
-	ui32TaskDelay = VERY_SHORT_TASK_DLY;
-
-	char empty_array[16] = {0x00};
-
-	int current_user = 0, user_cnt = 0;
-
-	for (user_cnt = 0; user_cnt < MAX_USERS; user_cnt++) {
-		if (users[current_user].nextAction == Update || users[current_user].nextAction == Add) {
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65)),(uint8_t*)users[current_user].username, 16);
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 16),(uint8_t*)users[current_user].password, 16);
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 32),(uint8_t*)users[current_user].first_name, 16);
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 48),(uint8_t*)users[current_user].last_name, 16);
-			EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 64),users[current_user].permissions);
-		}
-		if (users[current_user].nextAction == Delete) {
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65)),(uint8_t*)empty_array, 16);
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 16),(uint8_t*)empty_array, 16);
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 32),(uint8_t*)empty_array, 16);
-			EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 48),(uint8_t*)empty_array, 16);
-			EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 64),0x00);
-			user_cnt -= 1;
-		}
-		current_user++;
-		if (current_user > (MAX_USERS - 1) && (user_cnt < (MAX_USERS - 1)))
-		{
-			//Records were deleted, fill all remaining locations in EEPROM with blank records
-			for (; user_cnt < MAX_USERS; user_cnt++) {
-				EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65)),(uint8_t*)empty_array, 16);
-				EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 16),(uint8_t*)empty_array, 16);
-				EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 32),(uint8_t*)empty_array, 16);
-				EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 48),(uint8_t*)empty_array, 16);
-				EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (user_cnt*65) + 64),0x00);
-			}
-			break;
-		}
 
-		if (users[current_user].nextAction != Delete && (user_cnt > 0)) {
-			UpdateProgressBar(&progress, Increment, (100*user_cnt)/MAX_USERS);
-		}
-
-        vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
+	//The save is written page by page, link changes and I2C requests get the bus in between
+	priority = SPIArbiterSetPriority(SPIPriorityBackground);
+	//Every section is written before the new header, so a reset at any point leaves the previous generation in place
+	committed = ConfigStoreCommit(update, remove, EEPROMPageBuffer, &written);
+	SPIArbiterSetPriority(priority);
+	if (!committed) {
+		//We encountered a bad write cycle, report this to the user
+		ConsoleEchoSet(true);
+		return false;
 	}
+	UpdateProgressBar(&progress, Increment, 100);
 
-	flag_data |= 1 << FLAG_CONFIG_USERS_VALID;
+	ConsolePrintfWait("\n      Ethernet Controller: %s\n", (written & CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH)) ? "saved" : "unchanged");
+	ConsolePrintfWait("      User Database:       %s\n", (written & CONFIG_SECTION_MASK(CONFIG_SECTION_USERS)) ? "saved" : "unchanged");
+	ConsolePrintfWait("      VLANs:               %s\n", (remove & CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS)) ? "not saved (disabled)" :
+			((written & CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS)) ? "saved" : "unchanged"));
 
-	//Save Log Status Flags
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_1, ((LogStatusFlags >> 24) & 0xFF));
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_2, ((LogStatusFlags >> 16) & 0xFF));
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_3, ((LogStatusFlags >> 8) & 0xFF));
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_4, ((LogStatusFlags) & 0xFF));
-
-	//Save Next Log Status Pointer
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_1, ((NextLogSlot >> 24) & 0xFF));
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_2, ((NextLogSlot >> 16) & 0xFF));
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_3, ((NextLogSlot >> 8) & 0xFF));
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_4, ((NextLogSlot) & 0xFF));
+	//Write out staged log entries so that the saved Next Log Status Pointer is accurate
+	LoggerFlush();
 
+	//Save Log Status Flags [0x1F - 0x22] and Next Log Status Pointer [0x23 - 0x26] with a single write
+	uint8_t log_settings[8] = {	((LogStatusFlags >> 24) & 0xFF), ((LogStatusFlags >> 16) & 0xFF), ((LogStatusFlags >> 8) & 0xFF), ((LogStatusFlags) & 0xFF),
+								((NextLogSlot >> 24) & 0xFF), ((NextLogSlot >> 16) & 0xFF), ((NextLogSlot >> 8) & 0xFF), ((NextLogSlot) & 0xFF)};
+	EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_1, log_settings, 8);
 
+	ConsoleEchoSet(true);
 
+	return true;
+}
 
-	//Save system flags to EEPROM
-	EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, FLAG_BASE, flag_data);
+//*****************************************************************************
+//
+//! Read Running Configuration
+//! Copies registers 0x00 - 0xFE of the Micrel KSZ8895MLUB into "config" using
+//! burst reads of up to ETHO_BURST_LENGTH registers each, instead of one SPI
+//! transaction per register.
+//!
+//! \param config pointer-to-array of at least 0xFF values to save results into
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool ReadSwitchConfiguration(uint8_t *config)
+{
+	uint32_t burst_data[ETHO_BURST_LENGTH];
+	uint32_t read_addr = 0x00, burst_length = 0, pos = 0;
 
-	UARTEchoSet(true);
+	for (read_addr = 0; read_addr < 0xFF; read_addr += burst_length) {
+		burst_length = ((0xFF - read_addr) < ETHO_BURST_LENGTH) ? (0xFF - read_addr) : ETHO_BURST_LENGTH;
 
+		if (!EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, read_addr, burst_length, burst_data)) {
+			return false;
+		}
+		for (pos = 0; pos < burst_length; pos++) {
+			config[read_addr + pos] = (burst_data[pos] & 0xFF);
+		}
+	}
 	return true;
 }
 
@@ -1667,25 +1747,22 @@ void ShowPortStatus(uint32_t port_addr) {
 				break;
 			}
 			uint8_t masked_data = (data & PortConfigMappings[reg].options[option].mask);
-			UARTprintf("\t%s:", PortConfigMappings[reg].options[option].description);
+			ConsolePrintfWait("\t%s:", PortConfigMappings[reg].options[option].description);
 
 			//Go through each possible value to see if we matched one
 			for (value = 0; value < MAX_VALUES; value++) {
 				if (PortConfigMappings[reg].options[option].values[value].value_description == 0) {
-					UARTprintf("\n");
+					ConsolePrintfWait("\n");
 					break;
 				}
 				if (PortConfigMappings[reg].options[option].values[value].value == masked_data) {
 					//Print the string equivalent of the value found
 					for (add_spaces = 0; add_spaces < (longest_string - strlen(PortConfigMappings[reg].options[option].description)); add_spaces++)
 					{
-						UARTprintf(" ");
+						ConsolePrintfWait(" ");
 					}
 
-					//Add a very small delay in this function to allow the UART to completely flush its TX buffer
-					delayMs(1);
-
-					UARTprintf("%s\n", PortConfigMappings[reg].options[option].values[value].value_description);
+					ConsolePrintfWait("%s\n", PortConfigMappings[reg].options[option].values[value].value_description);
 					break;
 				}
 			}
@@ -1729,25 +1806,22 @@ void ShowGlobalStatus() {
 				break;
 			}
 			uint8_t masked_data = (data & GlobalConfigMappings[reg].options[option].mask);
-			UARTprintf("\t%s:", GlobalConfigMappings[reg].options[option].description);
+			ConsolePrintfWait("\t%s:", GlobalConfigMappings[reg].options[option].description);
 
 			//Go through each possible value to see if we matched one
 			for (value = 0; value < MAX_VALUES; value++) {
 				if (GlobalConfigMappings[reg].options[option].values[value].value_description == 0) {
-					UARTprintf("\n");
+					ConsolePrintfWait("\n");
 					break;
 				}
 				if (GlobalConfigMappings[reg].options[option].values[value].value == masked_data) {
 					//Print the string equivalent of the value found
 					for (add_spaces = 0; add_spaces < (longest_string - strlen(GlobalConfigMappings[reg].options[option].description)); add_spaces++)
 					{
-						UARTprintf(" ");
+						ConsolePrintfWait(" ");
 					}
 
-					//Add a very small delay in this function to allow the UART to completely flush its TX buffer
-					delayMs(1);
-
-					UARTprintf("%s\n", GlobalConfigMappings[reg].options[option].values[value].value_description);
+					ConsolePrintfWait("%s\n", GlobalConfigMappings[reg].options[option].values[value].value_description);
 					break;
 				}
 			}
@@ -1771,44 +1845,39 @@ void ShowGlobalStatus() {
 bool COM_ShowRunningConfig(char *params[MAX_PARAMS]) {
 	bool isValidOption = false;
 	char option_entered = 0x00;
-	uint32_t taskDelay = LONG_RUNNING_TASK_DLY;
 
-	UARTprintf("\n========== GLOBAL SETTINGS ==========\n");
+	ConsolePrintfWait("\n========== GLOBAL SETTINGS ==========\n");
 	ShowGlobalStatus();
 
 	while (true) {
 		switch (option_entered) {
 		case 'G': case 'g':
-			UARTprintf("\n========== GLOBAL SETTINGS ==========\n");
+			ConsolePrintfWait("\n========== GLOBAL SETTINGS ==========\n");
 			ShowGlobalStatus();
 			break;
 		case '0':
-			UARTprintf("\n========== PORT 0 SETTINGS ==========\n");
+			ConsolePrintfWait("\n========== PORT 0 SETTINGS ==========\n");
 			ShowPortStatus(PORT1_OFFSET_HEX);
 			break;
 		case '1':
-			UARTprintf("\n========== PORT 1 SETTINGS ==========\n");
+			ConsolePrintfWait("\n========== PORT 1 SETTINGS ==========\n");
 			ShowPortStatus(PORT2_OFFSET_HEX);
 			break;
 		case '2':
-			UARTprintf("\n========== PORT 2 SETTINGS ==========\n");
+			ConsolePrintfWait("\n========== PORT 2 SETTINGS ==========\n");
 			ShowPortStatus(PORT3_OFFSET_HEX);
 			break;
 		case '3':
-			UARTprintf("\n========== PORT 3 SETTINGS ==========\n");
+			ConsolePrintfWait("\n========== PORT 3 SETTINGS ==========\n");
 			ShowPortStatus(PORT4_OFFSET_HEX);
 			break;
 		}
-		UARTprintf("\nOPTIONS: [G]: Global Settings  [0]: Port 0  [1]: Port 1  [2]: Port 2  [3]: Port 3  [E]: EXIT");
-		UARTEchoSet(false);
+		ConsolePrintfWait("\nOPTIONS: [G]: Global Settings  [0]: Port 0  [1]: Port 1  [2]: Port 2  [3]: Port 3  [E]: EXIT");
+		ConsoleKeyMode(true);
 		isValidOption = false;
 		option_entered = 0x00;
 		while (!isValidOption) {
-			while (!UARTRxBytesAvail()) {
-				uint32_t currentTime = xTaskGetTickCount();
-		        vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
-			}
-			option_entered = UARTgetc();
+			option_entered = ConsoleReadKey();
 			switch (option_entered) {
 			case 'G': case 'g':
 				isValidOption = true;
@@ -1827,11 +1896,11 @@ bool COM_ShowRunningConfig(char *params[MAX_PARAMS]) {
 				break;
 			case 'E': case 'e':
 				isValidOption = true;
-				UARTEchoSet(true);
+				ConsoleKeyMode(false);
 				return true;
 			}
 		}
-		UARTEchoSet(true);
+		ConsoleKeyMode(false);
 	}
 }
 
@@ -1856,19 +1925,19 @@ bool COM_ShowPortStatus(char *params[MAX_PARAMS]) {
 	//Print port identifer
 	switch (port_addr) {
 		case PORT1_OFFSET_HEX:
-			UARTprintf("Configuration for <Fast Ethernet 0>\n");
+			ConsolePrintfWait("Configuration for <Fast Ethernet 0>\n");
 			break;
 		case PORT2_OFFSET_HEX:
-			UARTprintf("Configuration for <Fast Ethernet 1>\n");
+			ConsolePrintfWait("Configuration for <Fast Ethernet 1>\n");
 			break;
 		case PORT3_OFFSET_HEX:
-			UARTprintf("Configuration for <Fast Ethernet 2>\n");
+			ConsolePrintfWait("Configuration for <Fast Ethernet 2>\n");
 			break;
 		case PORT4_OFFSET_HEX:
-			UARTprintf("Configuration for <Fast Ethernet 3>\n");
+			ConsolePrintfWait("Configuration for <Fast Ethernet 3>\n");
 			break;
 		default:
-			UARTprintf("Invalid Port Specified\n");
+			ConsolePrintfWait("Invalid Port Specified\n");
 	}
 
 	//Find longest option for console alignment
@@ -1906,11 +1975,13 @@ bool COM_ShowPortStatus(char *params[MAX_PARAMS]) {
 //*****************************************************************************
 bool COM_ResetTivaC(char *params[MAX_PARAMS]) {
 	if (!ResetIssued) {
-		UARTprintf("\nAre you sure? Type 'system reset' again to confirm\n");
+		ConsolePrintfWait("\nAre you sure? Type 'system reset' again to confirm\n");
 		ResetIssued = true;
 		return false;
 	}
 	else {
+		//Do not lose log entries still waiting in RAM
+		LoggerFlush();
 		SysCtlReset();
 	}
 	return true;
@@ -1930,7 +2001,7 @@ bool COM_ResetTivaC(char *params[MAX_PARAMS]) {
 //*****************************************************************************
 bool COM_EventStatus(char *params[MAX_PARAMS]) {
 	int event_no = 0, longest_event = 0, spaces_to_align = 0;
-	UARTprintf("\n ====== Events currently logged to EEPROM ======\n");
+	ConsolePrintfWait("\n ====== Events currently logged to EEPROM ======\n");
 
 	for (event_no = 0; event_no < MAX_LOG_TYPES; event_no++) {
 		if (LogTypes[event_no] == 0x00) {
@@ -1945,19 +2016,19 @@ bool COM_EventStatus(char *params[MAX_PARAMS]) {
 			return true;
 		}
 		//Print log type string
-		UARTprintf("\n %s", LogTypes[event_no]);
+		ConsolePrintfWait("\n %s", LogTypes[event_no]);
 
 		//If this log type string is less than that longest available, add spaces to left align
 		for (spaces_to_align = strlen(LogTypes[event_no]); spaces_to_align < longest_event; spaces_to_align++) {
-			UARTprintf(" ");
+			ConsolePrintfWait(" ");
 		}
 
 		//Show user whether this log type is currently active or not
 		if ((LogStatusFlags >> event_no) & 1) {
-			UARTprintf(" - [ENABLED]\n");
+			ConsolePrintfWait(" - [ENABLED]\n");
 		}
 		else {
-			UARTprintf(" - [DISABLED]\n");
+			ConsolePrintfWait(" - [DISABLED]\n");
 		}
 
 	}
@@ -1982,18 +2053,16 @@ bool COM_ManageEvents(char *params[MAX_PARAMS]) {
 	int i = 0,total_items = 0,current_item=0;
 	char option_entered = 0x00;
 
-	uint32_t taskDelay = LONG_RUNNING_TASK_DLY;
-
 	//Print what this menu is doing
-	UARTprintf("\nCheck all events to ENABLE/DISABLE by using the arrow keys\nUse <ENTER> to select, <C> to confirm, <E> to exit\n");
+	ConsolePrintfWait("\nCheck all events to ENABLE/DISABLE by using the arrow keys\nUse <ENTER> to select, <C> to confirm, <E> to exit\n");
 
 	for (i = 0; i < MAX_LOG_TYPES; i++) {
 		if (LogTypes[i] != 0x00) {
 			if ((LogStatusFlags >> i) & 1) {
-				UARTprintf("[#] EVENT: %s\n", LogTypes[i]);
+				ConsolePrintfWait("[#] EVENT: %s\n", LogTypes[i]);
 			}
 			else {
-				UARTprintf("[ ] EVENT: %s\n", LogTypes[i]);
+				ConsolePrintfWait("[ ] EVENT: %s\n", LogTypes[i]);
 			}
 			total_items++;
 			current_item++;
@@ -2002,44 +2071,39 @@ bool COM_ManageEvents(char *params[MAX_PARAMS]) {
 
 	//Place cursor in first item checkbox
 	for (i = 0; i < total_items; i++) {
-		UARTprintf("\033[1A");
+		ConsolePrintfWait("\033[1A");
 		current_item--;
 	}
-	UARTprintf("\033[1C");
+	ConsolePrintfWait("\033[1C");
 
 	while (true) {
 
-		//Disable console logging
-		UARTEchoSet(false);
-
-		while (!UARTRxBytesAvail()) {
-			uint32_t currentTime = xTaskGetTickCount();
-			vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
-		}
-		option_entered = UARTgetc();
+		//Read the menu keys without echo, arrow keys arrive decoded
+		ConsoleKeyMode(true);
+		option_entered = ConsoleReadKey();
 
 		switch (option_entered) {
 			//Up Arrow Entered
-			case 0x41:
+			case CONSOLE_KEY_UP:
 				if (current_item > 0) {
-			       UARTprintf("\033[1A");
+			       ConsolePrintfWait("\033[1A");
 			       current_item--;
 				}
 				break;
 			//Down Arrow Entered
-			case 0x42:
+			case CONSOLE_KEY_DOWN:
 				if (current_item < (total_items - 1)) {
-			       UARTprintf("\033[1B");
+			       ConsolePrintfWait("\033[1B");
 			       current_item++;
 				}
 				break;
 			case '\n': case '\r':
 				if ((LogStatusFlags >> current_item) & 1) {
-					UARTprintf(" \033[1D");
+					ConsolePrintfWait(" \033[1D");
 					LogStatusFlags &= ~(1 << current_item);
 				}
 				else {
-					UARTprintf("#\033[1D");
+					ConsolePrintfWait("#\033[1D");
 					LogStatusFlags |= 1 << current_item;
 				}
 				break;
@@ -2047,20 +2111,20 @@ bool COM_ManageEvents(char *params[MAX_PARAMS]) {
 			case 'E': case 'e':
 				//Reset cursor to bottom of screen
 				for (i = current_item; i < total_items; i++) {
-				   UARTprintf("\033[1B");
+				   ConsolePrintfWait("\033[1B");
 				}
-			    UARTprintf("\033[2B\033[1D");
-				UARTEchoSet(true);
+			    ConsolePrintfWait("\033[2B\033[1D");
+				ConsoleKeyMode(false);
 				return true;
 			case 'C': case 'c':
 				//Reset cursor to bottom of screen
 				for (i = current_item; i < total_items; i++) {
-				   UARTprintf("\033[1B");
+				   ConsolePrintfWait("\033[1B");
 				}
-			    UARTprintf("\033[2B\033[1D");
+			    ConsolePrintfWait("\033[2B\033[1D");
 			    //Return control of RX buffer to user
-				UARTEchoSet(true);
-				UARTprintf("\n[NOTICE]: Save switch configuration before turning off system!\n");
+				ConsoleKeyMode(false);
+				ConsolePrintfWait("\n[NOTICE]: Save switch configuration before turning off system!\n");
 				return true;
 		}
 	}
@@ -2068,53 +2132,97 @@ bool COM_ManageEvents(char *params[MAX_PARAMS]) {
 
 //*****************************************************************************
 //
-//! List All EEPROM Logged Events (for Command-Line Interface)
-//! Displays a dump of all events logged to the EEPROM. Since the current
-//! iteration of this system does not have a way of saving or retriving a real-time
-//! clock, the metric reported before the logged event is the number of FreeRTOS
-//! ticks since the system was started. Maximum number of log entries that can be
-//! stored/read is 400.
+//! Prints every logged event from sequence number first_seq up to the newest
+//! record. first_seq is clamped to the oldest record still held in EEPROM.
+//! The log is read a page at a time, starting at the page holding first_seq
+//! so that its time mark can be used to rebuild the event times.
 //!
-//! Follows the function prototype required for all command-line function pointers
-//! by returning the result of the operation as a boolean success or fail.
+//! \param first_seq Sequence number of the first event to print
 //!
-//! \return Returns with the result of the operation as a boolean
+//! \return Returns true if the log could be read, otherwise false.
 //
 //*****************************************************************************
-bool COM_ListEvents(char *params[MAX_PARAMS]) {
-	int entry_memaddr = EEPROM_LOG_BASE;
-	//Read first 20 log entries
+static bool PrintEventsFrom(uint32_t first_seq) {
+	uint32_t oldest_seq, oldest_slot, next_seq;
+	uint32_t total, remaining, slot, page, pages_read, i;
+	uint32_t seq, timestamp = 0;
+	uint8_t *record;
+	uint8_t code;
+
+	//Make sure entries still held in RAM by the logger are included
+	LoggerFlush();
+
+	if (!LoggerGetBounds(&oldest_seq, &oldest_slot, &next_seq)) {
+		return false;
+	}
+	total = (next_seq - oldest_seq) & LOG_SEQ_MASK;
+	if (total == 0) {
+		ConsolePrintfWait("\n=== NO LOG ENTRIES FOUND ===\n");
+		return true;
+	}
 
+	//Anything older than the oldest record has already been overwritten
+	remaining = (next_seq - first_seq) & LOG_SEQ_MASK;
+	if (remaining > total) {
+		first_seq = oldest_seq;
+		remaining = total;
+	}
 
-	for (; entry_memaddr < (EEPROM_LOG_BASE + (MAX_LOG_ENTRIES * 5)); entry_memaddr += 5) {
-		uint32_t timestamp;
-		uint8_t timestamp_data[4];
-		LoggerCodes event;
+	slot = (oldest_slot + (total - remaining)) % LOG_TOTAL_RECORDS;
+	page = slot / LOG_RECORDS_PER_PAGE;
 
-		if (!EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,entry_memaddr, timestamp_data,4)) {
+	for (pages_read = 0; pages_read < LOG_AREA_PAGES && remaining > 0; pages_read++) {
+		if (!EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_LOG_BASE + (page * EEPROM_PAGE_SIZE), EEPROMPageBuffer, EEPROM_PAGE_SIZE)) {
 			return false;
 		}
-		timestamp = (timestamp_data[0] << 24) | (timestamp_data[1] << 16) | (timestamp_data[2] << 8) | (timestamp_data[3]);
-		if (timestamp == 0 && (entry_memaddr == EEPROM_LOG_BASE)) {
-			UARTprintf("\n=== NO LOG ENTRIES FOUND ===\n");
-			return true;
-		}
-		else if (timestamp == 0 || (entry_memaddr >= NextLogSlot)) {
-			UARTprintf("\n=== END OF LOG ===\n");
-			return true;
-		}
-		else {
-			event = (LoggerCodes)EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, entry_memaddr + 4);
-			UARTprintf("[System Time: %d] - %s\n", timestamp, LogTypes[event]);
+
+		for (i = 0; i < LOG_RECORDS_PER_PAGE && remaining > 0; i++) {
+			record = &EEPROMPageBuffer[i * LOG_RECORD_SIZE];
+			if (!LogRecordValid(record)) {
+				break;
+			}
+			seq = LogRecordSeq(record);
+
+			if (record[0] & LOG_RECORD_TIMEMARK) {
+				timestamp = (record[4] << 24) | (record[5] << 16) | (record[6] << 8) | (record[7]);
+			}
+			else {
+				timestamp += (record[4] << 8) | (record[5]);
+			}
+
+			//Records before first_seq are only decoded for their time
+			if (((seq - first_seq) & LOG_SEQ_MASK) >= ((next_seq - first_seq) & LOG_SEQ_MASK)) {
+				continue;
+			}
+			remaining--;
+
+			if (record[0] & LOG_RECORD_TIMEMARK) {
+				continue;
+			}
+
+			code = record[6];
+			ConsolePrintfWait("[%d][System Time: %d] - %s", seq, timestamp, (code < MAX_LOG_TYPES && LogTypes[code] != 0) ? LogTypes[code] : "Unknown Event");
+			if (record[0] & LOG_RECORD_PAYLOAD) {
+				ConsolePrintfWait(" (0x%02x)", record[7]);
+			}
+			ConsolePrintfWait("\n");
 		}
+		page = (page + 1) % LOG_AREA_PAGES;
 	}
+
+	ConsolePrintfWait("\n=== END OF LOG ===\n");
 	return true;
 }
+
 //*****************************************************************************
 //
-//! Delete All EEPROM Logged Events (for Command-Line Interface)
-//! Erases all EEPROM Sectors that are allocated for log entries and resets
-//! next log slot to the initial EEPROM_LOG_BASE value.
+//! List All EEPROM Logged Events (for Command-Line Interface)
+//! Displays a dump of all events logged to the EEPROM. Since the current
+//! iteration of this system does not have a way of saving or retriving a real-time
+//! clock, the metric reported before the logged event is the number of FreeRTOS
+//! ticks since the system was started. Each event is prefixed by its sequence
+//! number. Maximum number of log records that can be stored is
+//! LOG_TOTAL_RECORDS.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -2122,49 +2230,100 @@ bool COM_ListEvents(char *params[MAX_PARAMS]) {
 //! \return Returns with the result of the operation as a boolean
 //
 //*****************************************************************************
-bool COM_DeleteEvents(char *params[MAX_PARAMS]) {
-	int page_addr = EEPROM_LOG_BASE;
-	for (; page_addr < (EEPROM_LOG_BASE + (8*256)); page_addr += 256) {
-		EEPROMPageErase(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, page_addr);
-	}
-	NextLogSlot = EEPROM_LOG_BASE;
-	UARTprintf("\n[NOTICE]: Save switch configuration before turning off system!\n");
-	return true;
+bool COM_ListEvents(char *params[MAX_PARAMS]) {
+	//One full ring back from the next record is always older than the oldest
+	return PrintEventsFrom((LoggerNextSequence() - LOG_TOTAL_RECORDS) & LOG_SEQ_MASK);
 }
 
 //*****************************************************************************
 //
-//! Add New User to System (for Command-Line Interface)
-//! Issues prompts to the command-line to gather information for a new user. Once
-//! all fields in the User_Data structure are filled, this function places the new
-//! user at the next available slot in the "users" array. In order to prevent this
-//! function from blocking the FreeRTOS tasks currently running, vTaskDelayUntil
-//! is used while waiting for a new line character from the command-line.
+//! List Most Recent EEPROM Logged Events (for Command-Line Interface)
+//! Displays the events among the last <count> log records, oldest first.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
 //!
+//! \param params[0] number of records to display
+//!
 //! \return Returns with the result of the operation as a boolean
 //
 //*****************************************************************************
-bool COM_AddUser(char *params[MAX_PARAMS])
-{
-	int available_slot = MAX_USERS - 1, current_user = 0;
+bool COM_ListLastEvents(char *params[MAX_PARAMS]) {
+	int32_t count = (int32_t)strtol(params[0],NULL,0);
 
-	User_Data NewUser = {0};
+	if (count <= 0) {
+		ConsolePrintfWait("\nInvalid entry!\n");
+		return false;
+	}
+	if (count > LOG_TOTAL_RECORDS) {
+		count = LOG_TOTAL_RECORDS;
+	}
+	return PrintEventsFrom((LoggerNextSequence() - count) & LOG_SEQ_MASK);
+}
 
-	portTickType ui32WakeTime;
+//*****************************************************************************
+//
+//! List EEPROM Logged Events Since Sequence Number (for Command-Line Interface)
+//! Displays every event from the given sequence number onwards. If that record
+//! has already been overwritten, the listing starts at the oldest record.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] sequence number of the first record to display
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ListEventsSince(char *params[MAX_PARAMS]) {
+	uint32_t first_seq = (uint32_t)strtol(params[0],NULL,0);
 
-	//This task takes a while, so we want share nicely with other tasks instead of blocking
-	uint32_t ui32TaskDelay = SHORT_TASK_DLY;
+	return PrintEventsFrom(first_seq & LOG_SEQ_MASK);
+}
+//*****************************************************************************
+//
+//! Delete All EEPROM Logged Events (for Command-Line Interface)
+//! Erases all EEPROM Sectors that are allocated for log entries and resets
+//! next log slot to the initial EEPROM_LOG_BASE value. Sequence numbers are
+//! not reset.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_DeleteEvents(char *params[MAX_PARAMS]) {
+	//The log is recovered from EEPROM at boot, no need to save the configuration
+	LoggerClear();
+	return true;
+}
 
-	//Get system time in ticks
-	ui32WakeTime = xTaskGetTickCount();
+//*****************************************************************************
+//
+//! Add New User to System (for Command-Line Interface)
+//! Issues prompts to the command-line to gather information for a new user. Once
+//! all fields in the User_Data structure are filled, this function places the new
+//! user at the next available slot in the "users" array. In order to prevent this
+//! function from blocking the FreeRTOS tasks currently running, vTaskDelayUntil
+//! is used while waiting for a new line character from the command-line.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_AddUser(char *params[MAX_PARAMS])
+{
+	int available_slot = MAX_USERS - 1, current_user = 0;
+
+	User_Data NewUser = {0};
 
 	//If all 15 slots allocated for users have been filled, the last one's USERNAME field will not be NULL.
 	if (users[available_slot].username[0] != 0x00) {
 		//Maximum user limit exceeded!
-		UARTprintf("\nMaximum user limit exceeeded (15)! \nPlease delete an existing user before adding a new one.\n");
+		ConsolePrintfWait("\nMaximum user limit exceeeded (15)! \nPlease delete an existing user before adding a new one.\n");
 		return false;
 	}
 
@@ -2183,28 +2342,15 @@ bool COM_AddUser(char *params[MAX_PARAMS])
 		available_slot = 0;
 	}
 
-	//Disable buffer redirection for interpreter task. Let this function process the UART's RX buffer.
-	UARTInterpreterEnabled = false;
-
 	//Get a USERNAME value from the CLI.
 	while (NewUser.username[0] == 0x00) {
-		UARTprintf("\nUsername (16 character max): ");
-		//Wait for enter key and pend this task unil done
-		while ((UARTPeek('\n') == -1) && (UARTPeek('\r') == -1)) {
-			while (!UARTRxBytesAvail()) {
-				//Pend until a new line character is detected.
-				uint32_t currentTime = xTaskGetTickCount();
-				vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-			}
-		}
-		//Get 16 characters from the UART RX buffer
-		UARTgets(NewUser.username, 16);
-		//Delete everything else
-		UARTFlushRx();
+		ConsolePrintfWait("\nUsername (16 character max): ");
+		//Wait for a line from the console, the first 15 characters are kept
+		ConsoleGets(NewUser.username, 16);
 		//Check to see if the username does not already exist in the "users" array.
 		for (current_user = 0; current_user < MAX_USERS; current_user++) {
 			if (strcmp(NewUser.username, users[current_user].username) == 0) {
-				UARTprintf("\nUser already exists. Please enter a unique username.\n");
+				ConsolePrintfWait("\nUser already exists. Please enter a unique username.\n");
 				memset(NewUser.username, 0x00, 16);
 				break;
 			}
@@ -2213,75 +2359,38 @@ bool COM_AddUser(char *params[MAX_PARAMS])
 
 	//Get a FIRST NAME value from the CLI.
 	while (NewUser.first_name[0] == 0x00) {
-		UARTprintf("\nFirst Name (16 character max): ");
-		//Wait for enter key and pend this task unil done
-		while ((UARTPeek('\n') == -1) && (UARTPeek('\r') == -1)) {
-			while (!UARTRxBytesAvail()) {
-				//Pend until a new line character is detected.
-				uint32_t currentTime = xTaskGetTickCount();
-				vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-			}
-		}
-		//Get 16 characters from the UART RX buffer
-		UARTgets(NewUser.first_name, 16);
-		//Delete everything else.
-		UARTFlushRx();
+		ConsolePrintfWait("\nFirst Name (16 character max): ");
+		//Wait for a line from the console, the first 15 characters are kept
+		ConsoleGets(NewUser.first_name, 16);
 	}
 
 	//Get a LAST NAME value from the CLI.
 	while (NewUser.last_name[0] == 0x00) {
-		UARTprintf("\nLast Name (16 character max): ");
-		//Wait for enter key and pend this task unil done
-		while ((UARTPeek('\n') == -1) && (UARTPeek('\r') == -1)) {
-			while (!UARTRxBytesAvail()) {
-				//Pend until a new line character is detected.
-				uint32_t currentTime = xTaskGetTickCount();
-				vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-			}
-		}
-		//Get 16 characters from the UART RX buffer
-		UARTgets(NewUser.last_name, 16);
-		//Delete everything else.
-		UARTFlushRx();
+		ConsolePrintfWait("\nLast Name (16 character max): ");
+		//Wait for a line from the console, the first 15 characters are kept
+		ConsoleGets(NewUser.last_name, 16);
 	}
 
 	//Get a PASSWORD from the CLI.
 	while (NewUser.password[0] == 0x00) {
-		UARTprintf("\nPassword (16 character max): ");
-		//Wait for enter key and pend this task unil done
-		while ((UARTPeek('\n') == -1) && (UARTPeek('\r') == -1)) {
-			while (!UARTRxBytesAvail()) {
-				//Pend until a new line character is detected.
-				uint32_t currentTime = xTaskGetTickCount();
-				vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-			}
-		}
-		//Get 16 characters from the UART RX buffer
-		UARTgets(NewUser.password, 16);
-		//Delete everything else.
-		UARTFlushRx();
+		ConsolePrintfWait("\nPassword (16 character max): ");
+		//Wait for a line from the console, the first 15 characters are kept
+		ConsoleGets(NewUser.password, 16);
 	}
 
 	char value_entered = 0x00;
+	char permission[2];
 
 	//Get a PERMISSION LEVEL from the CLI.
 	while (value_entered != '0' && value_entered != '1' && value_entered != '2' && value_entered != '3') {
 		value_entered = 0x00;
-		UARTprintf("\n\nENTER ONE OF THE FOLLOWING:\n0: User has read-only permissions\n1: User can change port settings\n2: User can change port and system settings\n3: User has full administrative rights\nPermission Level (0 | 1 | 2 | 3): ");
-		//Wait for enter key and pend this task unil done
-		while ((UARTPeek('\n') == -1) && (UARTPeek('\r') == -1)) {
-			while (!UARTRxBytesAvail()) {
-				//Pend until a new line character is detected.
-				uint32_t currentTime = xTaskGetTickCount();
-				vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-			}
-		}
-
-		value_entered = UARTgetc();
-		UARTFlushRx();
+		ConsolePrintfWait("\n\nENTER ONE OF THE FOLLOWING:\n0: User has read-only permissions\n1: User can change port settings\n2: User can change port and system settings\n3: User has full administrative rights\nPermission Level (0 | 1 | 2 | 3): ");
+		//Only the first character of the line is used
+		ConsoleGets(permission, 2);
+		value_entered = permission[0];
 		//Is the value entered outside of the allowed values?
 		if (value_entered != '0' && value_entered != '1' && value_entered != '2' && value_entered != '3') {
-			UARTprintf("\nInvalid entry!\n");
+			ConsolePrintfWait("\nInvalid entry!\n");
 		}
 		else {
 			NewUser.permissions = (PermLevel)(value_entered - '0');
@@ -2289,15 +2398,12 @@ bool COM_AddUser(char *params[MAX_PARAMS])
 	}
 
 
-	//Enable buffer redirection for interpreter task. Return control of UART RX buffer to interpreter task.
-	UARTInterpreterEnabled = true;
-
 	//Flag this entry to be saved to the EEPROM
 	NewUser.nextAction = Add;
 
 	users[available_slot] = NewUser;
 
-	UARTprintf("\n\nUser added to table. Save switch configuration to make changes permanent!\n\tUsername: %s\n\tFirst Name: %s\n\tLast Name: %s\n", NewUser.username, NewUser.first_name, NewUser.last_name);
+	ConsolePrintfWait("\n\nUser added to table. Save switch configuration to make changes permanent!\n\tUsername: %s\n\tFirst Name: %s\n\tLast Name: %s\n", NewUser.username, NewUser.first_name, NewUser.last_name);
 	return true;
 }
 
@@ -2317,13 +2423,13 @@ bool COM_ListUsers(char *params[MAX_PARAMS]) {
 	for (user_index = 0; user_index < MAX_USERS; user_index++) {
 		if (users[0].username[0] == 0) {
 			//Empty users array
-			UARTprintf("\n === NO USERS IN DATABASE === \n");
+			ConsolePrintfWait("\n === NO USERS IN DATABASE === \n");
 			return false;
 		}
 		if (users[user_index].username[0] != 0) {
-			UARTprintf("[%d] USER: %s\n\t%s %s\n\tROLE: %s\n", (user_index + 1), users[user_index].username, users[user_index].first_name, users[user_index].last_name, RoleDefs[users[user_index].permissions]);
+			ConsolePrintfWait("[%d] USER: %s\n\t%s %s\n\tROLE: %s\n", (user_index + 1), users[user_index].username, users[user_index].first_name, users[user_index].last_name, RoleDefs[users[user_index].permissions]);
 			if (users[user_index].nextAction == Delete) {
-				UARTprintf("\t[USER MARKED FOR DELETION]\n");
+				ConsolePrintfWait("\t[USER MARKED FOR DELETION]\n");
 			}
 		}
 	}
@@ -2347,14 +2453,12 @@ bool COM_DeleteUsersMenu(char *params[MAX_PARAMS]) {
 	int i = 0,total_items = 0,current_item=0;
 	char option_entered = 0x00;
 
-	uint32_t taskDelay = LONG_RUNNING_TASK_DLY;
-
 	//Print what this menu is doing
-	UARTprintf("\nCheck all users to DELETE by using the arrow keys\nUse <ENTER> to select, <C> to confirm, <E> to exit\n");
+	ConsolePrintfWait("\nCheck all users to DELETE by using the arrow keys\nUse <ENTER> to select, <C> to confirm, <E> to exit\n");
 
 	if (users[0].username[0] == 0) {
 		//Empty users array
-		UARTprintf("\n === NO USERS IN DATABASE === \n");
+		ConsolePrintfWait("\n === NO USERS IN DATABASE === \n");
 		return false;
 	}
 
@@ -2362,10 +2466,10 @@ bool COM_DeleteUsersMenu(char *params[MAX_PARAMS]) {
 	for (i = 0; i < MAX_USERS; i++) {
 		if (users[i].username[0] != 0) {
 			if (users[i].isMarked) {
-				UARTprintf("[#] USER: %s\n\t%s %s\n\tROLE: %s\n", users[i].username, users[i].first_name, users[i].last_name, RoleDefs[users[i].permissions]);
+				ConsolePrintfWait("[#] USER: %s\n\t%s %s\n\tROLE: %s\n", users[i].username, users[i].first_name, users[i].last_name, RoleDefs[users[i].permissions]);
 			}
 			else {
-				UARTprintf("[ ] USER: %s\n\t%s %s\n\tROLE: %s\n", users[i].username, users[i].first_name, users[i].last_name, RoleDefs[users[i].permissions]);
+				ConsolePrintfWait("[ ] USER: %s\n\t%s %s\n\tROLE: %s\n", users[i].username, users[i].first_name, users[i].last_name, RoleDefs[users[i].permissions]);
 			}
 			//A counter to keep track of the length of the array
 			total_items++;
@@ -2377,50 +2481,45 @@ bool COM_DeleteUsersMenu(char *params[MAX_PARAMS]) {
 	//Place cursor in first item checkbox
 	for (i = 0; i < total_items; i++) {
 		//Move cursor UP three lines
-		UARTprintf("\033[3A");
+		ConsolePrintfWait("\033[3A");
 		current_item--;
 	}
 	//Move cursor RIGHT 1 column
-	UARTprintf("\033[1C");
+	ConsolePrintfWait("\033[1C");
 
 	while (true) {
 
-		//Disable console logging
-		UARTEchoSet(false);
-
-		while (!UARTRxBytesAvail()) {
-			uint32_t currentTime = xTaskGetTickCount();
-			vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
-		}
-		option_entered = UARTgetc();
+		//Read the menu keys without echo, arrow keys arrive decoded
+		ConsoleKeyMode(true);
+		option_entered = ConsoleReadKey();
 
 		//Check to see which of the menu action items the user selected
 		switch (option_entered) {
 			//Up Arrow Entered
-			case 0x41:
+			case CONSOLE_KEY_UP:
 				if (current_item > 0) {
 					//Move cursor UP 1 row
-			       UARTprintf("\033[3A");
+			       ConsolePrintfWait("\033[3A");
 			       current_item--;
 				}
 				break;
 			//Down Arrow Entered
-			case 0x42:
+			case CONSOLE_KEY_DOWN:
 				if (current_item < (total_items - 1)) {
 				   //Move cursor DOWN 1 row
-			       UARTprintf("\033[3B");
+			       ConsolePrintfWait("\033[3B");
 			       current_item++;
 				}
 				break;
 			case '\n': case '\r':
 				if (users[current_item].isMarked) {
 					//Move cursor LEFT 1 column
-					UARTprintf(" \033[1D");
+					ConsolePrintfWait(" \033[1D");
 					users[current_item].isMarked = false;
 				}
 				else if (!users[current_item].isMarked) {
 					//Move cursor LEFT 1 column
-					UARTprintf("#\033[1D");
+					ConsolePrintfWait("#\033[1D");
 					users[current_item].isMarked = true;
 				}
 				break;
@@ -2429,17 +2528,17 @@ bool COM_DeleteUsersMenu(char *params[MAX_PARAMS]) {
 				//Reset cursor to bottom of screen
 				for (i = current_item; i < total_items; i++) {
 					//Move cursor DOWN 1 row
-				   UARTprintf("\033[3B");
+				   ConsolePrintfWait("\033[3B");
 				}
-			    UARTprintf("\033[2B\033[1D");
-				UARTEchoSet(true);
+			    ConsolePrintfWait("\033[2B\033[1D");
+				ConsoleKeyMode(false);
 				return true;
 			case 'C': case 'c':
 				//Reset cursor to bottom of screen
 				for (i = current_item; i < total_items; i++) {
-				   UARTprintf("\033[3B");
+				   ConsolePrintfWait("\033[3B");
 				}
-			    UARTprintf("\033[2B\033[1D");
+			    ConsolePrintfWait("\033[2B\033[1D");
 			    //Mark users for deletion
 			    for (i = 0; i < MAX_USERS; i++) {
 			    	if (users[i].isMarked) {
@@ -2452,20 +2551,64 @@ bool COM_DeleteUsersMenu(char *params[MAX_PARAMS]) {
 			    	}
 			    }
 			    //Return control of RX buffer to user
-				UARTEchoSet(true);
-				UARTprintf("\n[NOTICE]: Save switch configuration to update user database\n");
+				ConsoleKeyMode(false);
+				ConsolePrintfWait("\n[NOTICE]: Save switch configuration to update user database\n");
 				return true;
 		}
 	}
 }
 
+//*****************************************************************************
+//
+//! Prints the entries of one table of the MAC table snapshot (see mac_table.h)
+//! that match a filter, using the same columns as the show commands.
+//!
+//! \param table MAC_TABLE_STATIC or MAC_TABLE_DYNAMIC
+//! \param filter entries to print, NULL for all
+//!
+//! \return Returns the number of entries printed
+//
+//*****************************************************************************
+static uint32_t ShowMACEntries(uint32_t table, const MACFilter *filter)
+{
+	MACEntry entry;
+	uint32_t index = 0;
+	uint32_t shown = 0;
+	uint8_t port;
+
+	while (MACTableNext(table, &index, filter, &entry)) {
+		if (shown++ == 0) {
+			if (table == MAC_TABLE_STATIC) {
+				ConsolePrintfWait("== FILTER ID ==\t == USE FID ==\t == OVERRIDE STP ==\t == FORWARDING PORTS ==\t == MAC ADDRESS ==\n");
+			}
+			else {
+				ConsolePrintfWait("\n\t== MAC ADDRESS ==\t == SOURCE PORT ==\t == FILTER ID ==\n");
+			}
+		}
+		if (table == MAC_TABLE_STATIC) {
+			ConsolePrintfWait("%d\t%s\t%s\t", (entry.fid & 0x7F), (entry.fid & MAC_STATIC_USE_FID) ? "TRUE" : "FALSE", (entry.port & MAC_STATIC_OVERRIDE) ? "YES" : "NO");
+			//Print forwarding ports (bit n = port n)
+			for (port = 0; port < MAC_PORT_COUNT; port++) {
+				if ((entry.port >> port) & 1) {
+					ConsolePrintfWait(" %s ", MACTablePortName(port));
+				}
+			}
+			ConsolePrintfWait("\t%02X:%02X:%02X:%02X:%02X:%02X\n", entry.mac[0], entry.mac[1], entry.mac[2], entry.mac[3], entry.mac[4], entry.mac[5]);
+		}
+		else {
+			ConsolePrintfWait("\t%02X:%02X:%02X:%02X:%02X:%02X\t\t", entry.mac[0], entry.mac[1], entry.mac[2], entry.mac[3], entry.mac[4], entry.mac[5]);
+			ConsolePrintfWait("%s\t\t\t%d\n", MACTablePortName(entry.port), entry.fid);
+		}
+	}
+	return shown;
+}
+
 //*****************************************************************************
 //
 //! Show Current Static MAC Table (for Command-Line Interface)
 //! Displays all valid entries in the Micrel KSZ8895MLUB Ethernet Controller's
-//! static MAC table. In order to obtains these values, the function accessess
-//! the indirect registers in the KSZ8895MLUB. Information regarding these
-//! registers can be found in the datasheet for this part.
+//! static MAC table. Entries are taken from the MAC table snapshot (see
+//! mac_table.h), which is refreshed if it is older than MAC_SNAPSHOT_REFRESH_MS.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -2474,186 +2617,649 @@ bool COM_DeleteUsersMenu(char *params[MAX_PARAMS]) {
 //
 //*****************************************************************************
 bool COM_ShowStaticMACTable(char *params[MAX_PARAMS]) {
+	if (MACTableAge(MAC_TABLE_STATIC) > MAC_SNAPSHOT_REFRESH_MS) {
+		MACTableRefresh(MAC_TABLE_STATIC);
+	}
+	if (ShowMACEntries(MAC_TABLE_STATIC, NULL) == 0) {
+		ConsolePrintfWait("\n==== NO ENTRIES FOUND IN STATIC MAC TABLE ====\n");
+		return true;
+	}
+	ConsolePrintfWait("\n==== END OF STATIC MAC TABLE ====\n");
 
-	//Setup indirect access registers
-	//We want to READ (bit 4 of 0x6E = 1) the STATIC MAC table (bits [3:2] of 0x6E = 00)
-	uint8_t reg6EBase = 0x10;
-
-	//And check each entry in the MAC table from 0x00 to 0x3FF (10 bits)
-	uint16_t current_entry = 0x00;
-
-	for (current_entry = 0x00; current_entry < 0x400; current_entry++) {
-
-		//Data for each entry will be held here
-		uint32_t MACTableData[8] = {0x00};
+	return true;
+}
 
-		//Set reg6E to read <current_entry [8:9]>
-		EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_0,(reg6EBase | ((current_entry & 0x300) >> 8)));
+//*****************************************************************************
+//
+//! Show Current Dynamic MAC Table (for Command-Line Interface)
+//! Displays the learned entries in the Micrel KSZ8895MLUB Ethernet Controller's
+//! dynamic MAC table. Entries are taken from the MAC table snapshot (see
+//! mac_table.h), which is refreshed if it is older than MAC_SNAPSHOT_REFRESH_MS.
+//! If more addresses were learned than the snapshot holds, the number shown and
+//! the number learned are both reported.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ShowDynamicMACTable(char *params[MAX_PARAMS]) {
+	uint32_t shown;
 
-		//Set register 111 (0x6F [Indirect Access Control 1]) to the remaining 8 bits of <current_entry [7:0]>
-		EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_1,(current_entry & 0xFF));
+	if (MACTableAge(MAC_TABLE_DYNAMIC) > MAC_SNAPSHOT_REFRESH_MS) {
+		MACTableRefresh(MAC_TABLE_DYNAMIC);
+	}
+	shown = ShowMACEntries(MAC_TABLE_DYNAMIC, NULL);
+	if (shown == 0) {
+		ConsolePrintfWait("\n==== NO ENTRIES FOUND IN DYNAMIC MAC TABLE ====\n");
+		return true;
+	}
+	if (shown < MACTableLearned()) {
+		ConsolePrintfWait("\n\tShowing %d of %d learned addresses\n", shown, MACTableLearned());
+	}
+	ConsolePrintfWait("\n==== END OF DYNAMIC MAC TABLE (%d s old) ====\n", MACTableAge(MAC_TABLE_DYNAMIC) / 1000);
 
-		//This will start a read of <current_entry>
-		EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_7,8,MACTableData);
+	return true;
+}
 
-		//Check validity of entry before processing. This will be in MACTableData[1] bit 6.
-		if ((MACTableData[1] >> 5) & 1) {
-			//This entry is valid and we want to show it to the user!
-			if (current_entry == 0x00) {
-				//If this is the first entry checked, print the table header
-				UARTprintf("== FILTER ID ==\t == USE FID ==\t == OVERRIDE STP ==\t == FORWARDING PORTS ==\t == MAC ADDRESS ==\n");
-			}
+//*****************************************************************************
+//
+//! Find MAC Addresses By Port (for Command-Line Interface)
+//! Lists the static entries forwarding to, and the dynamic entries learned on,
+//! the port specified. Entries are taken from the MAC table snapshot without
+//! accessing the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] name of the port (f0 - f3, exp-port)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_FindMACByPort(char *params[MAX_PARAMS]) {
+	MACFilter filter;
 
-			//Print Filter ID (FID)
-			UARTprintf("%d\t",(MACTableData[0] >> 1));
+	filter.port = MACTablePortFromName(params[0]);
+	filter.prefix_length = 0;
+	if (filter.port == MAC_PORT_ANY) {
+		ConsolePrintfWait("Unknown port '%s'. Valid ports are f0 - f3 and exp-port.\n", params[0]);
+		return false;
+	}
+	if (ShowMACEntries(MAC_TABLE_STATIC, &filter) + ShowMACEntries(MAC_TABLE_DYNAMIC, &filter) == 0) {
+		ConsolePrintfWait("\n==== NO ENTRIES FOUND FOR %s ====\n", params[0]);
+		return true;
+	}
+	ConsolePrintfWait("\n==== END OF ENTRIES FOR %s ====\n", params[0]);
+	return true;
+}
 
-			//Print Use FID?
-			if (MACTableData[0] & 1) {
-				UARTprintf("TRUE\t");
-			}
-			else {
-				UARTprintf("FALSE\t");
-			}
+//*****************************************************************************
+//
+//! Find MAC Addresses By Prefix (for Command-Line Interface)
+//! Lists the static and dynamic entries whose MAC address starts with the
+//! prefix specified. Entries are taken from the MAC table snapshot without
+//! accessing the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] MAC address prefix of one to six bytes (i.e. 00:1A:2B)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_FindMACByPrefix(char *params[MAX_PARAMS]) {
+	MACFilter filter;
 
-			//Print Override STP?
-			if ((MACTableData[1] >> 7) & 1) {
-				UARTprintf("YES\t");
-			}
-			else {
-				UARTprintf("NO\t");
-			}
+	filter.port = MAC_PORT_ANY;
+	if (!MACTableParsePrefix(params[0], &filter)) {
+		ConsolePrintfWait("Invalid MAC address prefix '%s'. Enter one to six bytes (i.e. 00:1A:2B).\n", params[0]);
+		return false;
+	}
+	if (ShowMACEntries(MAC_TABLE_STATIC, &filter) + ShowMACEntries(MAC_TABLE_DYNAMIC, &filter) == 0) {
+		ConsolePrintfWait("\n==== NO ENTRIES FOUND FOR %s ====\n", params[0]);
+		return true;
+	}
+	ConsolePrintfWait("\n==== END OF ENTRIES FOR %s ====\n", params[0]);
+	return true;
+}
 
-			//Print forwarding ports
-			if ((MACTableData[1] >> 4) & 1) {
-				UARTprintf(" f3 ");
-			}
-			if ((MACTableData[1] >> 3) & 1) {
-				UARTprintf(" f2 ");
-			}
-			if ((MACTableData[1] >> 2) & 1) {
-				UARTprintf(" f1 ");
-			}
-			if ((MACTableData[1] >> 1) & 1) {
-				UARTprintf(" f0 ");
-			}
-			if ((MACTableData[1] >> 0) & 1) {
-				UARTprintf(" exp-port");
-			}
+//*****************************************************************************
+//
+//! Show Boot Phase Times (for Command-Line Interface)
+//! Lists the time at which each phase of bring-up was reached, measured from
+//! the start of the delay timebase, including the time to forwarding.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ShowBootTimes(char *params[MAX_PARAMS]) {
+	uint32_t phase, pad, time_us;
 
-			//Print MAC Address
-			UARTprintf("\t%02X:%02X:%02X:%02X:%02X:%02X\n", MACTableData[2], MACTableData[3], MACTableData[4], MACTableData[5], MACTableData[6], MACTableData[7]);
+	ConsolePrintfWait("\n==== BOOT PHASES ====\n");
+	for (phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+		time_us = BootPhaseTime((BootPhase)phase);
+		ConsolePrintfWait("\t%s", BootPhaseName((BootPhase)phase));
+		for (pad = strlen(BootPhaseName((BootPhase)phase)); pad < 28; pad++) {
+			ConsolePrintfWait(" ");
+		}
+		if (phase != BootPhaseTimebase && time_us == 0) {
+			ConsolePrintfWait("pending\n");
 		}
 		else {
-			//If this is the first entry checked, the static MAC table is empty. Return control to the user.
-			if (current_entry == 0x00) {
-				UARTprintf("\n==== NO ENTRIES FOUND IN STATIC MAC TABLE ====\n");
-				return true;
-			}
+			ConsolePrintfWait("%d.%03d ms\n", (time_us / 1000), (time_us % 1000));
 		}
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Formats a 64-bit counter in decimal, the console only prints 32-bit values.
+//!
+//! \param buffer receives the NULL-terminated text, at least 21 characters
+//! \param value the counter
+//!
+//! \return Returns buffer
+//
+//*****************************************************************************
+static char *FormatCounter(char *buffer, uint64_t value) {
+	char digits[20];
+	uint32_t count = 0, pos = 0;
 
+	do {
+		digits[count++] = '0' + (char)(value % 10);
+		value /= 10;
+	} while (value != 0);
+	while (count) {
+		buffer[pos++] = digits[--count];
 	}
-	UARTprintf("\n==== END OF STATIC MAC TABLE ====\n");
+	buffer[pos] = 0;
+	return buffer;
+}
 
+//*****************************************************************************
+//
+//! Show Port Statistics (for Command-Line Interface)
+//! Lists the traffic and error counters of a port collected from the
+//! KSZ8895MLUB's MIB counters, with their rates over the last sample and over
+//! the sliding window. Does not access the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] base address of the port (see interpreter_task.h)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ShowPortStats(char *params[MAX_PARAMS]) {
+	//Parameter 1: Port Base Address
+	uint32_t port_addr = (uint32_t)strtol(params[0],NULL,0);
+	//Port base addresses 0x10 - 0x50 belong to the KSZ8895MLUB's ports 1 - 5
+	uint8_t port = (uint8_t)((port_addr >> 4) - 1);
+	MIBPortStats stats;
+	char total[21];
+	uint32_t metric;
+
+	if (!MIBCountersGet(port, &stats)) {
+		ConsolePrintfWait("No statistics have been collected yet, try again in a second.\n");
+		return false;
+	}
+	ConsolePrintfWait("\n==== STATISTICS FOR %s ====\n", MACTablePortName(port));
+	ConsolePrintfWait("\t%-14s%21s%12s%12s\n", "", "total", "per second", "average");
+	for (metric = 0; metric < MIB_METRIC_COUNT; metric++) {
+		ConsolePrintfWait("\t%-14s%21s%12u%12u\n", MIBMetricName((MIBMetric)metric), FormatCounter(total, stats.total[metric]),
+				stats.rate[metric], stats.average[metric]);
+	}
+	ConsolePrintfWait("\n==== RATES OVER THE LAST %d s AND %d s ====\n", MIB_SAMPLE_MS / 1000, (MIB_SAMPLE_MS * MIB_WINDOW_SAMPLES) / 1000);
 	return true;
 }
 
 //*****************************************************************************
 //
-//! Show Current Dynamic MAC Table (for Command-Line Interface)
-//! Displays all valid entries in the Micrel KSZ8895MLUB Ethernet Controller's
-//! dynamic MAC table. In order to obtains these values, the function accessess
-//! the indirect registers in the KSZ8895MLUB. Information regarding these
-//! registers can be found in the datasheet for this part.
+//! Show Memory (for Command-Line Interface)
+//! Lists the stack size and the deepest stack use of every task, the length
+//! and the peak depth of every queue, the heap taken by them
+//! and the free FreeRTOS heap. Does not access the Ethernet Controller.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
 //!
+//! \param params unused
+//!
 //! \return Returns with the result of the operation as a boolean
 //
 //*****************************************************************************
-bool COM_ShowDynamicMACTable(char *params[MAX_PARAMS]) {
-	//Setup indirect access registers
-	//We want to READ (bit 4 of 0x6E = 1) the DYNAMIC MAC table (bits [3:2] of 0x6E = 10)
-	uint8_t reg6EBase = 0x18;
+bool COM_ShowMemory(char *params[MAX_PARAMS]) {
+	MemoryTaskInfo task;
+	MemoryQueueInfo queue;
+	uint32_t i;
 
-	//And check each entry in the MAC table from 0x00 to 0x3FF (10 bits)
-	uint16_t current_entry = 0x00;
-	uint16_t total_entries = 0x400;
+	ConsolePrintfWait("\n==== TASK STACKS (WORDS) ====\n");
+	ConsolePrintfWait("\t%-14s%8s%8s%8s\n", "task", "size", "peak", "free");
+	for (i = 0; MemoryTaskGet(i, &task); i++) {
+		ConsolePrintfWait("\t%-14s%8u%8u%8u%s\n", task.name, task.stack_words, task.stack_words - task.free_words,
+				task.free_words, (task.exited ? "  (exited)" : ""));
+	}
+	ConsolePrintfWait("\n==== QUEUES (ITEMS) ====\n");
+	ConsolePrintfWait("\t%-14s%8s%8s%8s%8s\n", "queue", "length", "bytes", "peak", "now");
+	for (i = 0; MemoryQueueGet(i, &queue); i++) {
+		ConsolePrintfWait("\t%-14s%8u%8u%8u%8u\n", queue.name, queue.length, queue.item_size, queue.peak, queue.waiting);
+	}
+	ConsolePrintfWait("\n==== RAM (BYTES) ====\n");
+	ConsolePrintfWait("\theap for tasks and queues   %u\n", MemoryHeapBytes());
+	ConsolePrintfWait("\tfree heap                   %u of %u\n", (uint32_t)xPortGetFreeHeapSize(), (uint32_t)configTOTAL_HEAP_SIZE);
+	return true;
+}
 
-	for (current_entry = 0x00; current_entry < total_entries; current_entry++) {
+//*****************************************************************************
+//
+//! Show Performance Counters (for Command-Line Interface)
+//! Lists the count, average and longest latency, the log2 latency histogram and
+//! the callers of every timed EEPROM, Ethernet Controller and command-line
+//! operation, followed by the CPU time of every task since the last reset, the
+//! SPI traffic and bus arbitration counters since boot and the time and SPI
+//! traffic of the last commands and of the boot restore. Does not access the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns false if the counters are compiled out
+//
+//*****************************************************************************
+bool COM_ShowPerf(char *params[MAX_PARAMS]) {
+#if ENABLE_PERF_STATS
+	PerfOpStats stats;
+	PerfTaskShare shares[MEMORY_TASK_COUNT];
+	PerfBusStats bus;
+	SPIArbiterStats arbiter;
+	PerfSpan span;
+	uint32_t op, i, count, cycles_per_us = PerfCyclesPerUs();
 
-		while (UARTTxBytesFree() < 100) {
-			uint32_t taskDelay = LONG_RUNNING_TASK_DLY;
-			uint32_t currentTime = xTaskGetTickCount();
-			vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
+	if (cycles_per_us == 0) {
+		ConsolePrintfWait("The cycle counter has not been started.\n");
+		return false;
+	}
+	ConsolePrintfWait("\n==== OPERATION LATENCY (US) ====\n");
+	ConsolePrintfWait("\t%-18s%10s%10s%10s\n", "operation", "count", "average", "longest");
+	for (op = 0; op < PERF_OP_COUNT; op++) {
+		if (!PerfOpGet((PerfOp)op, &stats) || stats.count == 0) {
+			continue;
+		}
+		ConsolePrintfWait("\t%-18s%10u%10u%10u\n", PerfOpName((PerfOp)op), stats.count,
+				(uint32_t)(stats.total_cycles / stats.count / cycles_per_us), stats.max_cycles / cycles_per_us);
+		//Each bucket is labelled with the shortest latency it holds
+		ConsolePrintfWait("\t\tlatency:");
+		for (i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+			if (stats.histogram[i] != 0) {
+				if (i == 0) {
+					ConsolePrintfWait(" <1us=%u", stats.histogram[i]);
+				}
+				else {
+					ConsolePrintfWait(" %uus=%u", (1 << (i - 1)), stats.histogram[i]);
+				}
+			}
 		}
-		//Data for each entry will be held here
-		uint32_t MACTableData[9] = {0x00};
+		ConsolePrintfWait("\n\t\tcallers:");
+		for (i = 0; i < PERF_CALLER_COUNT; i++) {
+			if (stats.callers[i] != 0) {
+				ConsolePrintfWait(" %s=%u", PerfCallerName(i), stats.callers[i]);
+			}
+		}
+		ConsolePrintfWait("\n");
+	}
+
+	count = PerfTaskShares(shares, MEMORY_TASK_COUNT);
+	ConsolePrintfWait("\n==== TASK CPU TIME ====\n");
+	ConsolePrintfWait("\t%-14s%10s%10s\n", "task", "ms", "share");
+	for (i = 0; i < count; i++) {
+		ConsolePrintfWait("\t%-14s%10u%7u.%u%%\n", shares[i].name, shares[i].time_ms, shares[i].permille / 10, shares[i].permille % 10);
+	}
+	ConsolePrintfWait("\nCounted since the last \"system show perf-reset\".\n");
 
-		//Set reg6E to read <current_entry [8:9]>
-		EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_0,(reg6EBase | ((current_entry & 0x300) >> 8)));
+	PerfBusGet(&bus);
+	ConsolePrintfWait("\n==== SPI TRAFFIC SINCE BOOT ====\n");
+	ConsolePrintfWait("\t%-22s%14s%14s\n", "bus", "transactions", "bytes");
+	ConsolePrintfWait("\t%-22s%14u%14u\n", "EEPROM (SSI0)", bus.transactions[0], bus.bytes[0]);
+	ConsolePrintfWait("\t%-22s%14u%14u\n", "Ethernet Ctrl (SSI1)", bus.transactions[1], bus.bytes[1]);
 
-		//Set register 111 (0x6F [Indirect Access Control 1]) to the remaining 8 bits of <current_entry [7:0]>
-		EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_1,(current_entry & 0xFF));
+	ConsolePrintfWait("\n==== SPI BUS ARBITER ====\n");
+	ConsolePrintfWait("\t%-22s%10s%10s%10s%10s%10s\n", "bus", "grants", "waited", "preempted", "timeouts", "max ms");
+	for (i = 0; SPIArbiterGet(i, &arbiter); i++) {
+		ConsolePrintfWait("\t%-22s%10u%10u%10u%10u%10u\n", (i == SPI_ARBITER_BUS_EEPROM) ? "EEPROM (SSI0)" : "Ethernet Ctrl (SSI1)",
+				arbiter.grants, arbiter.waits, arbiter.preemptions, arbiter.timeouts, arbiter.max_wait_ms);
+	}
 
-		//This will start a read of <current_entry>
-		EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_8,9,MACTableData);
+	//The history holds the previous commands, this one is added once it returns
+	ConsolePrintfWait("\n==== RECENT COMMANDS ====\n");
+	ConsolePrintfWait("\t%-24s%10s%16s%16s\n", "command", "us", "EEPROM xfer/B", "Ethernet xfer/B");
+	for (i = 0; PerfHistoryGet(i, &span); i++) {
+		ConsolePrintfWait("\t%-24s%10u%8u/%-7u%8u/%-7u\n", span.label, span.time,
+				span.bus.transactions[0], span.bus.bytes[0], span.bus.transactions[1], span.bus.bytes[1]);
+	}
+	return true;
+#else
+	ConsolePrintfWait("Performance counters are disabled in this build (configGENERATE_RUN_TIME_STATS).\n");
+	return false;
+#endif
+}
 
-		//MSB of first 8 bits will tell us if the MAC table is empty or not
-		if ((MACTableData[0] >> 7) & 1) {
-			UARTprintf("\n==== NO ENTRIES FOUND IN DYNAMIC MAC TABLE ====\n");
-			return true;
-		}
+//*****************************************************************************
+//
+//! Reset Performance Counters (for Command-Line Interface)
+//! Clears the operation counters and restarts the task CPU time measurement.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns false if the counters are compiled out
+//
+//*****************************************************************************
+bool COM_ResetPerf(char *params[MAX_PARAMS]) {
+#if ENABLE_PERF_STATS
+	PerfReset();
+	return true;
+#else
+	ConsolePrintfWait("Performance counters are disabled in this build (configGENERATE_RUN_TIME_STATS).\n");
+	return false;
+#endif
+}
 
-		//Recheck number of valid entries in MAC table. It's possible the user may unplug a port before we're done processing. If so, let's exit this loop!
-		total_entries = ((MACTableData[0] & 0x7F) << 3) | ((MACTableData[1] & 0xE0) >> 5) + 1;
-		if (current_entry > total_entries) {
-			//The table shrinked, exit now!
-			UARTprintf("\n ==== END OF TABLE \n ====\n");
-			return true;
-		}
+//*****************************************************************************
+//
+//! Show SPI Clocks (for Command-Line Interface)
+//! Lists the clock of each SSI bus, how it was chosen, the profiles that
+//! passed the self-test during this boot and the setting for the next boot.
+//! Does not access the EEPROM or the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+bool COM_ShowSPIClock(char *params[MAX_PARAMS]) {
+	static const char *sources[] = {"default", "tuned", "selected"};
+	SPIClockInfo info;
+	uint32_t profile;
+	uint8_t bus;
 
-		//An entry can still be changing while we're processing, so let's pend on it being complete. This is held in bit 8 of MACTableData[2]
-		while ((MACTableData[2] >> 7) & 1) {
-			//Waiting for entry to become valid
+	ConsolePrintfWait("\n==== SPI CLOCKS ====\n");
+	for (bus = 0; bus < SPI_CLOCK_BUS_COUNT; bus++) {
+		SPIClockGet(bus, &info);
+		ConsolePrintfWait("\t%-22s%6u kHz (%s)\n", SPIClockBusName(bus), info.rate / 1000, sources[info.source]);
+		ConsolePrintfWait("\t\tpassed self-test:");
+		for (profile = 0; profile < SPI_CLOCK_PROFILE_COUNT; profile++) {
+			if (info.passed & (1 << profile)) {
+				ConsolePrintfWait(" %u kHz", SPIClockProfileRate(profile) / 1000);
+			}
+		}
+		if (info.selected == 0) {
+			ConsolePrintfWait("\n\t\tnext boot: auto\n");
 		}
+		else {
+			ConsolePrintfWait("\n\t\tnext boot: %u kHz\n", info.selected / 1000);
+		}
+	}
+	ConsolePrintfWait("\nProfiles (kHz):");
+	for (profile = 0; profile < SPI_CLOCK_PROFILE_COUNT; profile++) {
+		ConsolePrintfWait(" %u", SPIClockProfileRate(profile) / 1000);
+	}
+	ConsolePrintfWait("\n");
+	return true;
+}
 
-		//This entry is valid and we want to show it to the user!
-		if (current_entry == 0x00) {
-			//If this is the first entry checked, print the table header
-			UARTprintf("\n\t== MAC ADDRESS ==\t == SOURCE PORT ==\t == FILTER ID ==\n");
+//*****************************************************************************
+//
+//! Select SPI Clock (for Command-Line Interface)
+//! Switches an SSI bus to a new clock at once and saves it for the next boot,
+//! "auto" tunes the bus again. A clock that fails the self-test is not kept.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] bus (SPI_CLOCK_BUS_EEPROM or SPI_CLOCK_BUS_ETHO)
+//! \param params[1] "auto" or one of the profile rates in kHz
+//!
+//! \return Returns false if the rate is not a profile the device is rated for
+//! or failed the self-test
+//
+//*****************************************************************************
+bool COM_SetSPIClock(char *params[MAX_PARAMS]) {
+	uint8_t bus = (uint8_t)strtol(params[0],NULL,0);
+	uint32_t khz, profile, rate = 0;
+	SPIClockInfo info;
+	char *end;
+
+	if (strcmp(params[1], "auto") != 0) {
+		khz = (uint32_t)strtoul(params[1], &end, 10);
+		for (profile = 0; profile < SPI_CLOCK_PROFILE_COUNT && rate == 0; profile++) {
+			if (*end == '\0' && (SPIClockProfileRate(profile) / 1000) == khz) {
+				rate = SPIClockProfileRate(profile);
+			}
 		}
+		if (rate == 0) {
+			ConsolePrintfWait("Unknown rate, see \"system show spi-clock\" for the profiles.\n");
+			return false;
+		}
+	}
+	if (!SPIClockSelect(bus, rate)) {
+		ConsolePrintfWait("The %s is not rated for this rate, failed the self-test or the setting could not be saved.\n", SPIClockBusName(bus));
+		return false;
+	}
+	SPIClockGet(bus, &info);
+	ConsolePrintfWait("The %s now runs at %u kHz, saved for the next boot.\n", SPIClockBusName(bus), info.rate / 1000);
+	return true;
+}
 
-		//Print MAC Address
-		UARTprintf("\t%02X:%02X:%02X:%02X:%02X:%02X\t\t", MACTableData[3], MACTableData[4], MACTableData[5], MACTableData[6], MACTableData[7], MACTableData[8]);
 
-		//Print Source Port
-		switch (MACTableData[1] & 0x07) {
-			case 0x00:
-				UARTprintf("f3");
-				break;
-			case 0x01:
-				UARTprintf("f2");
-				break;
-			case 0x02:
-				UARTprintf("f1");
-				break;
-			case 0x03:
-				UARTprintf("f0");
-				break;
-			case 0x04:
-				UARTprintf("exp-port");
-				break;
+//*****************************************************************************
+//
+//! Copy Configuration To Other Layers (for Command-Line Interface)
+//! Copies the saved switch registers and VLAN table, and optionally the
+//! users, to one layer or to every layer found on the I2C bus. Layers that
+//! already hold the same configuration are skipped. Changes that were not
+//! saved are not copied.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] "1" to copy the users as well
+//! \param params[1] "all" or the I2C address of the layer
+//!
+//! \return Returns false if any layer could not be updated
+//
+//*****************************************************************************
+bool COM_SyncLayers(char *params[MAX_PARAMS]) {
+	static const char *results[] = {"not found", "up to date", "updated", "FAILED"};
+	uint32_t sections = CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH) | CONFIG_SECTION_MASK(CONFIG_SECTION_VLANS);
+	uint32_t address, first, last, found = 0, failed = 0;
+	LayerSyncReport report;
+
+	if (strtol(params[0],NULL,0) != 0) {
+		sections |= CONFIG_SECTION_MASK(CONFIG_SECTION_USERS);
+	}
+	if (strcmp(params[1], "all") == 0) {
+		first = LAYER_SYNC_FIRST_ADDR;
+		last = LAYER_SYNC_LAST_ADDR;
+	}
+	else {
+		first = last = (uint32_t)strtoul(params[1],NULL,16);
+		if (first < LAYER_ADDR_MIN || first > LAYER_ADDR_MAX || first == LayerAddressGet()) {
+			ConsolePrintfWait("Enter the 7-bit address of another layer (0x%02x - 0x%02x).\n", LAYER_ADDR_MIN, LAYER_ADDR_MAX);
+			return false;
 		}
+	}
+	if (ConfigStoreGeneration() == 0) {
+		ConsolePrintfWait("Nothing has been saved on this layer, save the configuration first.\n");
+		return false;
+	}
 
-		//Print Filter ID
-		UARTprintf("\t\t\t%d\n",(MACTableData[2] & 0x7F));
+	ConsolePrintfWait("\n==== LAYER SYNC FROM 0x%02x (generation %u) ====\n", LayerAddressGet(), ConfigStoreGeneration());
+	for (address = first; address <= last; address++) {
+		if (address == LayerAddressGet()) {
+			continue;
+		}
+		LayerSyncRun((uint8_t)address, sections, &report);
+		//Only report empty addresses when a single layer was asked for
+		if (report.result == LayerSyncAbsent && first != last) {
+			continue;
+		}
+		found += (report.result != LayerSyncAbsent);
+		failed += (report.result != LayerSyncUpToDate && report.result != LayerSyncUpdated);
+		ConsolePrintfWait("\t0x%02x  %-12s%7u bytes%5u retries%7u ms\n", address, results[report.result], report.bytes, report.retries, report.time_ms);
+	}
+	if (found == 0 && first != last) {
+		ConsolePrintfWait("\tNo layers found at 0x%02x - 0x%02x\n", first, last);
 	}
-	UARTprintf("\n==== END OF DYNAMIC MAC TABLE ====\n");
+	return (failed == 0);
+}
 
+//*****************************************************************************
+//
+//! Set Layer Address (for Command-Line Interface)
+//! Saves the I2C address this layer answers at and moves the I2C slave to it
+//! at once. Every layer starts at I2C_DEVICE_ADDR, so each layer in a stack
+//! needs its own address before "system sync layers" can reach it.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] the 7-bit address (LAYER_ADDR_MIN - LAYER_ADDR_MAX)
+//!
+//! \return Returns false if the address is out of range or could not be saved
+//
+//*****************************************************************************
+bool COM_SetLayerAddress(char *params[MAX_PARAMS]) {
+	char *end;
+	uint32_t address = (uint32_t)strtoul(params[0],&end,16);
+
+	if (end == params[0] || *end != '\0' || !LayerAddressSet((uint8_t)address)) {
+		ConsolePrintfWait("Enter a 7-bit address (0x%02x - 0x%02x).\n", LAYER_ADDR_MIN, LAYER_ADDR_MAX);
+		return false;
+	}
+	ConsolePrintfWait("This layer now answers at 0x%02x.\n", LayerAddressGet());
 	return true;
 }
 
+//*****************************************************************************
+//
+//! Apply QoS Profile (for Command-Line Interface)
+//! Writes one of the data-plane profiles (priority queues, DiffServ map, rate
+//! limits, storm protection, flow control and aging) to the Ethernet
+//! Controller in a single switch batch. Inside "config begin" the registers
+//! are only staged. The profile is kept after a reset once the configuration
+//! is saved.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] the profile (QOS_PROFILE_*)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_SetQoSProfile(char *params[MAX_PARAMS]) {
+	uint32_t profile = (uint32_t)strtoul(params[0],NULL,0);
+	SwitchBatchResult summary;
+	bool staged = SwitchBatchActive();
+
+	if (!QoSProfileApply(profile, &summary)) {
+		ConsolePrintfWait("Could not apply the %s profile. Is a batch open on another interface?\n", QoSProfileName(profile));
+		return false;
+	}
+	if (staged) {
+		ConsolePrintfWait("Staged the %s profile, \"config commit\" applies it.\n", QoSProfileName(profile));
+	}
+	else {
+		ConsolePrintfWait("Applied the %s profile: %d registers in %d bursts (%d.%03d ms).\n", QoSProfileName(profile),
+				summary.registers, summary.bursts, (summary.commit_us / 1000), (summary.commit_us % 1000));
+		ConsolePrintfWait("Use \"config save\" to keep it after a reset.\n");
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Show QoS Settings (for Command-Line Interface)
+//! Shows the active QoS profile and the settings it consists of as read back
+//! from the Ethernet Controller, so settings changed one register at a time
+//! are shown as well.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+bool COM_ShowQoS(char *params[MAX_PARAMS]) {
+	static const char *names[QOS_PORT_COUNT] = {"f0", "f1", "f2", "f3", "exp-port"};
+	//f0 - f3 are the KSZ8895MLUB's ports 4 - 1, exp-port is port 5
+	static const uint8_t ports[QOS_PORT_COUNT] = {3, 2, 1, 0, 4};
+	static QoSSettings settings;
+	const QoSPortSettings *port;
+	uint32_t i, j, first, queue, limits[2];
+
+	QoSGet(&settings);
+	ConsolePrintfWait("\n==== QOS (profile: %s) ====\n", QoSProfileName(QoSProfileActive()));
+	ConsolePrintfWait("\tScheduling:      %s\n", (settings.fair_queueing ? "weighted fair queueing" : "strict priority"));
+	ConsolePrintfWait("\tStorm rate:      %u frames / 50 ms (%s)\n", settings.storm_rate,
+			(settings.storm_multicast ? "broadcast and multicast" : "broadcast only"));
+	ConsolePrintfWait("\tFlow control:    %s\n", (settings.flow_control ? "enabled" : "disabled"));
+	ConsolePrintfWait("\tAging:           %s\n", (!settings.aging ? "disabled" : (settings.fast_aging ? "fast" : "normal")));
+
+	ConsolePrintfWait("\n\t%-10s%-8s%-7s%-10s%-7s%-9s%-9s\n", "Port", "Queues", "Prio", "Classify", "Storm", "In Mbps", "Out Mbps");
+	for (i = 0; i < QOS_PORT_COUNT; i++) {
+		port = &settings.ports[ports[i]];
+		ConsolePrintfWait("\t%-10s%-8u%-7u%-10s%-7s", names[i], (port->four_queues ? 4 : 1), port->priority,
+				((port->classify_8021p && port->classify_diffserv) ? "both" : (port->classify_8021p ? "802.1p" : (port->classify_diffserv ? "dscp" : "-"))),
+				(port->storm_protection ? "on" : "off"));
+		//A limit of 0 means line rate
+		limits[0] = port->ingress_mbps;
+		limits[1] = port->egress_mbps;
+		for (j = 0; j < 2; j++) {
+			if (limits[j] == 0) {
+				ConsolePrintfWait("%-9s", "-");
+			}
+			else {
+				ConsolePrintfWait("%-9u", limits[j]);
+			}
+		}
+		ConsolePrintfWait("\n");
+	}
+
+	//Runs of code points in the same queue
+	ConsolePrintfWait("\n\tDSCP queues:");
+	for (first = 0, i = 1; i <= QOS_DSCP_COUNT; i++) {
+		queue = QOS_DSCP_QUEUE(settings.dscp_map, first);
+		if (i < QOS_DSCP_COUNT && QOS_DSCP_QUEUE(settings.dscp_map, i) == queue) {
+			continue;
+		}
+		if (first == (i - 1)) {
+			ConsolePrintfWait(" %u:q%u", first, queue);
+		}
+		else {
+			ConsolePrintfWait(" %u-%u:q%u", first, (i - 1), queue);
+		}
+		first = i;
+	}
+	ConsolePrintfWait("\n");
+	return true;
+}
 
 //*****************************************************************************
 //
@@ -2684,7 +3290,7 @@ bool COM_I2CSend(char *params[MAX_PARAMS]) {
 	}
 
 	//Send the I2C command to the designated slave
-	I2CMasterSlaveAddrSet(I2C_BASE_ADDR, I2C_DEVICE_ADDR, false);
+	I2CMasterSlaveAddrSet(I2C_BASE_ADDR, LayerAddressGet(), false);
 	I2CMasterDataPut(I2C_BASE_ADDR, command);
 	I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_SINGLE_SEND);
 	while(I2CMasterBusy(I2C_BASE_ADDR));
@@ -2697,7 +3303,7 @@ bool COM_I2CSend(char *params[MAX_PARAMS]) {
 	}
 
 	//Recieve the result of the I2C operation. (Read back by I2C Interrupt)
-	I2CMasterSlaveAddrSet(I2C_BASE_ADDR, I2C_DEVICE_ADDR, true);
+	I2CMasterSlaveAddrSet(I2C_BASE_ADDR, LayerAddressGet(), true);
 	I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_SINGLE_RECEIVE);
 	return true;
 }
@@ -2707,7 +3313,8 @@ bool COM_I2CSend(char *params[MAX_PARAMS]) {
 //
 //! Logs Out From Switch CLI (for Command-Line Interface)
 //! Logs the current user out of the command line and returns to a login prompt.
-//! Also logs the UserLoggedOut event to EEPROM (if enabled).
+//! Also logs the UserLoggedOut event to EEPROM (if enabled). A batch left open
+//! is committed so that it does not hold off other interfaces.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -2716,7 +3323,10 @@ bool COM_I2CSend(char *params[MAX_PARAMS]) {
 //
 //*****************************************************************************
 bool COM_Logout(char *params[MAX_PARAMS]) {
-	UARTprintf("\033[2J\033[0m\n");
+	if (SwitchBatchActive()) {
+		SwitchBatchCommit(NULL);
+	}
+	ConsolePrintfWait("\033[2J\033[0m\n");
 	Authenticated = false;
 
 	LogItemEEPROM(UserLoggedOut);
@@ -2738,8 +3348,8 @@ bool COM_Logout(char *params[MAX_PARAMS]) {
 //*****************************************************************************
 int CreateProgressBar() {
 	int progress = 0;
-	UARTprintf("\033[2K\033[100D\033[34;47mTask Progress: [");
-	UARTprintf("\033[s");
+	ConsolePrintfWait("\033[2K\033[100D\033[34;47mTask Progress: [");
+	ConsolePrintfWait("\033[s");
 	return progress;
 }
 //*****************************************************************************
@@ -2755,10 +3365,10 @@ void UpdateProgressBar(int* lastprogress, PBarActions action, int newvalue) {
 	if (*lastprogress >= 100 && action != Fill) {
 		return;
 	}
-	UARTprintf("\033[u");
+	ConsolePrintfWait("\033[u");
 	switch (action) {
 	case Reset:
-		UARTprintf("\033[2K\033[100D\033[34;47mTask Progress: [");
+		ConsolePrintfWait("\033[2K\033[100D\033[34;47mTask Progress: [");
 		*lastprogress = 0;
 		break;
 	case Fill:
@@ -2768,21 +3378,21 @@ void UpdateProgressBar(int* lastprogress, PBarActions action, int newvalue) {
 
 	if (action != FillError) {
 		for (i = 0; i < ((newvalue/2)-(*lastprogress/2)); i++) {
-			UARTprintf("#");
+			ConsolePrintfWait("#");
 		}
-		UARTprintf("\033[s");
+		ConsolePrintfWait("\033[s");
 		*lastprogress = newvalue;
 		for (i = 0; i < (50-(*lastprogress/2));i++) {
-			UARTprintf(" ");
+			ConsolePrintfWait(" ");
 		}
 	}
 	else {
-		UARTprintf("\033[2K\033[100DTask Progress: [");
+		ConsolePrintfWait("\033[2K\033[100DTask Progress: [");
 		for (i = 0; i < (50); i++) {
-			UARTprintf("!");
+			ConsolePrintfWait("!");
 		}
 	}
-	UARTprintf("]\033[0m");
+	ConsolePrintfWait("]\033[0m");
 }
 
 //*****************************************************************************
@@ -2798,21 +3408,21 @@ void UpdateProgressBar(int* lastprogress, PBarActions action, int newvalue) {
 void ShowProgress(int percent)
 {	int i = 0;
 	if (percent > 0) {
-		UARTprintf("\033[2K\033[100D\033[34;47mTask Progress: [");
+		ConsolePrintfWait("\033[2K\033[100D\033[34;47mTask Progress: [");
 		for (i = 0; i < (percent/2); i++) {
-			UARTprintf("#");
+			ConsolePrintfWait("#");
 		}
 		for (i = 0; i < (50-(percent/2));i++) {
-			UARTprintf(" ");
+			ConsolePrintfWait(" ");
 		}
-		UARTprintf("]\033[0m");
+		ConsolePrintfWait("]\033[0m");
 	}
 	else {
-		UARTprintf("\033[2K\033[100DTask Progress: [");
+		ConsolePrintfWait("\033[2K\033[100DTask Progress: [");
 		for (i = 0; i < (50); i++) {
-			UARTprintf("!");
+			ConsolePrintfWait("!");
 		}
-		UARTprintf("]\033[0m");
+		ConsolePrintfWait("]\033[0m");
 	}
 }
 
@@ -214,19 +214,65 @@ bool COM_SetSCBitEthernetController(char *params[20]);
 //! Run Cable Diagnostics For Specified Port (for Command-Line Interface)
 //! Activates the Time Domain Reflectometry (TDR) function built into the ethernet
 //! controller for the port specified and writes the state (Short/Open/Normal) and
-//! distance to fault (in meters) back to the user's command-line
+//! distance to fault (in meters) back to the user's command-line. The test runs
+//! in the port monitor task, see cable_diag.h.
 //!
 //! \param params[0] 8-bit base address of the port to test (see interpreter_task.h)
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
 //!
-//! \return Returns with the result of the operation as a boolean
+//! \return Returns false if the test did not complete
 //
 //*****************************************************************************
 bool COM_RunCableDiagnostics(char *params[20]);
 //*****************************************************************************
 //
+//! Run Cable Diagnostics On All Ports (for Command-Line Interface)
+//! Tests every port at once and lists the results. Each port loses its link
+//! until its test has finished.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns false if a test did not complete
+//
+//*****************************************************************************
+bool COM_RunAllCableDiagnostics(char *params[20]);
+//*****************************************************************************
+//
+//! Show Cable Diagnostics Results (for Command-Line Interface)
+//! Lists the last cable test of every port, including those run by the
+//! background scan. Does not access the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+bool COM_ShowCableDiagnostics(char *params[20]);
+//*****************************************************************************
+//
+//! Set Cable Diagnostics Scan Interval (for Command-Line Interface)
+//! Sets how often ports without a link are tested in the background. The
+//! interval is not saved and is disabled after a reset.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] interval in minutes (0 - CABLE_DIAG_MAX_SCAN_MINUTES), 0 disables the scan
+//!
+//! \return Returns false if the interval is invalid
+//
+//*****************************************************************************
+bool COM_SetCableDiagScan(char *params[20]);
+//*****************************************************************************
+//
 //! Show Current Port Status (for Command-Line Interface)
 //! Reads the registers specified by both "PortConfigMappings" (refer to "interpreter_task.h")
 //! and reports the current value of each in a textual format. Aligns all printed
@@ -342,8 +388,9 @@ bool COM_ManageEvents(char *params[20]);
 //! Displays a dump of all events logged to the EEPROM. Since the current
 //! iteration of this system does not have a way of saving or retriving a real-time
 //! clock, the metric reported before the logged event is the number of FreeRTOS
-//! ticks since the system was started. Maximum number of log entries that can be
-//! stored/read is 400.
+//! ticks since the system was started. Each event is prefixed by its sequence
+//! number. Maximum number of log records that can be stored is
+//! LOG_TOTAL_RECORDS.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -354,9 +401,39 @@ bool COM_ManageEvents(char *params[20]);
 bool COM_ListEvents(char *params[20]);
 //*****************************************************************************
 //
+//! List Most Recent EEPROM Logged Events (for Command-Line Interface)
+//! Displays the events among the last <count> log records, oldest first.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] number of records to display
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ListLastEvents(char *params[20]);
+//*****************************************************************************
+//
+//! List EEPROM Logged Events Since Sequence Number (for Command-Line Interface)
+//! Displays every event from the given sequence number onwards. If that record
+//! has already been overwritten, the listing starts at the oldest record.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] sequence number of the first record to display
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ListEventsSince(char *params[20]);
+//*****************************************************************************
+//
 //! Delete All EEPROM Logged Events (for Command-Line Interface)
 //! Erases all EEPROM Sectors that are allocated for log entries and resets
-//! next log slot to the initial EEPROM_LOG_BASE value.
+//! next log slot to the initial EEPROM_LOG_BASE value. Sequence numbers are
+//! not reset.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -369,7 +446,8 @@ bool COM_DeleteEvents(char *params[20]);
 //
 //! Logs Out From Switch CLI (for Command-Line Interface)
 //! Logs the current user out of the command line and returns to a login prompt.
-//! Also logs the UserLoggedOut event to EEPROM (if enabled).
+//! Also logs the UserLoggedOut event to EEPROM (if enabled). A batch left open
+//! is committed so that it does not hold off other interfaces.
 //!
 //! Follows the function prototype required for all command-line function pointers
 //! by returning the result of the operation as a boolean success or fail.
@@ -496,6 +574,242 @@ bool COM_ShowStaticMACTable(char *params[20]);
 bool COM_ShowDynamicMACTable(char *params[20]);
 //*****************************************************************************
 //
+//! Show Boot Phase Times (for Command-Line Interface)
+//! Lists the time at which each phase of bring-up was reached, measured from
+//! the start of the delay timebase, including the time to forwarding.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ShowBootTimes(char *params[20]);
+//*****************************************************************************
+//
+//! Find MAC Addresses By Port (for Command-Line Interface)
+//! Lists the static entries forwarding to, and the dynamic entries learned on,
+//! the port specified. Entries are taken from the MAC table snapshot without
+//! accessing the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] name of the port (f0 - f3, exp-port)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_FindMACByPort(char *params[20]);
+//*****************************************************************************
+//
+//! Find MAC Addresses By Prefix (for Command-Line Interface)
+//! Lists the static and dynamic entries whose MAC address starts with the
+//! prefix specified. Entries are taken from the MAC table snapshot without
+//! accessing the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] MAC address prefix of one to six bytes (i.e. 00:1A:2B)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_FindMACByPrefix(char *params[20]);
+//*****************************************************************************
+//
+//! Begin A Batch (for Command-Line Interface)
+//! Opens a batch for the command-line. Until COM_BatchCommit is issued, register
+//! changes are staged in the register shadow and VLAN changes in the RAM
+//! membership map instead of being written to the Ethernet Controller one by one.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_BatchBegin(char *params[20]);
+//*****************************************************************************
+//
+//! Commit A Batch (for Command-Line Interface)
+//! Applies everything changed since COM_BatchBegin in a single pass and reports
+//! the aggregated result of the batch.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_BatchCommit(char *params[20]);
+//*****************************************************************************
+//
+//! Show Port Statistics (for Command-Line Interface)
+//! Lists the traffic and error counters of a port collected from the
+//! KSZ8895MLUB's MIB counters, with their rates over the last sample and over
+//! the sliding window. Does not access the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] base address of the port (see interpreter_task.h)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ShowPortStats(char *params[20]);
+//*****************************************************************************
+//
+//! Show Memory (for Command-Line Interface)
+//! Lists the stack size and the deepest stack use of every task, the length
+//! and the peak depth of every queue, the heap taken by them
+//! and the free FreeRTOS heap. Does not access the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_ShowMemory(char *params[20]);
+//*****************************************************************************
+//
+//! Show Performance Counters (for Command-Line Interface)
+//! Lists the count, average and longest latency, the log2 latency histogram and
+//! the callers of every timed EEPROM, Ethernet Controller and command-line
+//! operation, followed by the CPU time of every task since the last reset.
+//! Does not access the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns false if the counters are compiled out
+//
+//*****************************************************************************
+bool COM_ShowPerf(char *params[20]);
+//*****************************************************************************
+//
+//! Reset Performance Counters (for Command-Line Interface)
+//! Clears the operation counters and restarts the task CPU time measurement.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns false if the counters are compiled out
+//
+//*****************************************************************************
+bool COM_ResetPerf(char *params[20]);
+//*****************************************************************************
+//
+//! Show SPI Clocks (for Command-Line Interface)
+//! Lists the clock of each SSI bus, how it was chosen, the profiles that
+//! passed the self-test during this boot and the setting for the next boot.
+//! Does not access the EEPROM or the Ethernet Controller.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+bool COM_ShowSPIClock(char *params[20]);
+//*****************************************************************************
+//
+//! Select SPI Clock (for Command-Line Interface)
+//! Switches an SSI bus to a new clock at once and saves it for the next boot,
+//! "auto" tunes the bus again. A clock that fails the self-test is not kept.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] bus (SPI_CLOCK_BUS_EEPROM or SPI_CLOCK_BUS_ETHO)
+//! \param params[1] "auto" or one of the profile rates in kHz
+//!
+//! \return Returns false if the rate is not a profile the device is rated for
+//! or failed the self-test
+//
+//*****************************************************************************
+bool COM_SetSPIClock(char *params[20]);
+//*****************************************************************************
+//
+//! Copy Configuration To Other Layers (for Command-Line Interface)
+//! Copies the saved switch registers and VLAN table, and optionally the
+//! users, to one layer or to every layer found on the I2C bus. Layers that
+//! already hold the same configuration are skipped. Changes that were not
+//! saved are not copied.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] "1" to copy the users as well
+//! \param params[1] "all" or the I2C address of the layer
+//!
+//! \return Returns false if any layer could not be updated
+//
+//*****************************************************************************
+bool COM_SyncLayers(char *params[20]);
+//*****************************************************************************
+//
+//! Set Layer Address (for Command-Line Interface)
+//! Saves the I2C address this layer answers at and moves the I2C slave to it
+//! at once. Every layer starts at I2C_DEVICE_ADDR, so each layer in a stack
+//! needs its own address before "system sync layers" can reach it.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] the 7-bit address (LAYER_ADDR_MIN - LAYER_ADDR_MAX)
+//!
+//! \return Returns false if the address is out of range or could not be saved
+//
+//*****************************************************************************
+bool COM_SetLayerAddress(char *params[20]);
+//*****************************************************************************
+//
+//! Apply QoS Profile (for Command-Line Interface)
+//! Writes one of the data-plane profiles (priority queues, DiffServ map, rate
+//! limits, storm protection, flow control and aging) to the Ethernet
+//! Controller in a single switch batch. Inside "config begin" the registers
+//! are only staged. The profile is kept after a reset once the configuration
+//! is saved.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params[0] the profile (QOS_PROFILE_*)
+//!
+//! \return Returns with the result of the operation as a boolean
+//
+//*****************************************************************************
+bool COM_SetQoSProfile(char *params[20]);
+//*****************************************************************************
+//
+//! Show QoS Settings (for Command-Line Interface)
+//! Shows the active QoS profile and the settings it consists of as read back
+//! from the Ethernet Controller, so settings changed one register at a time
+//! are shown as well.
+//!
+//! Follows the function prototype required for all command-line function pointers
+//! by returning the result of the operation as a boolean success or fail.
+//!
+//! \param params unused
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+bool COM_ShowQoS(char *params[20]);
+//*****************************************************************************
+//
 //! Send an I2C Command (for Command-Line Interface)
 //! Allows the user to modify other layers using the I2C interface. To do this,
 //! refer to "i2c_task.h" for valid I2C commands and how to send parameters. This
@@ -590,8 +904,8 @@ uint8_t I2C_SaveSwitchConfiguration(uint8_t params[20]);
 //*****************************************************************************
 //
 //! Download Running Configuration (for I2C Commands)
-//! Sequentially writes each value held in the Micrel KSZ8895MLUB's registers
-//! 0x00 - 0xFF to the requesting I2C master.
+//! Returns each value held in the Micrel KSZ8895MLUB's registers 0x00 - 0xFE
+//! to the requesting I2C master in a single read.
 //!
 //! \return Returns the results of the operation as a boolean
 //
@@ -609,6 +923,144 @@ uint8_t I2C_DownloadSwitchConfiguration(uint8_t params[20]);
 uint8_t I2C_ClearSwitchConfiguration(uint8_t params[20]);
 //*****************************************************************************
 //
+//! Count Learned MAC Addresses (for I2C Commands)
+//! Returns the number of dynamic entries in the MAC table snapshot learned on
+//! the port specified, without accessing the Ethernet Controller.
+//!
+//! \param params[0] port number (1 - 4 = f0 - f3, 5 = exp-port, 0 = all ports)
+//!
+//! \return Returns the number of addresses, saturated at 0xFF
+//
+//*****************************************************************************
+uint8_t I2C_CountMACAddresses(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Run A Batch Of Commands (for I2C Commands)
+//! Runs several I2C commands sent in one frame as a single batch: register and
+//! VLAN changes are coalesced and written in one pass once every command has
+//! run. Commands returning more than one value cannot be batched.
+//!
+//! \param params[0] number of bytes that follow
+//! \param params[1] first command code, followed by its custom parameters, then
+//! the next command code and so on
+//!
+//! \return Returns 1 if every command and the commit succeeded, otherwise 0
+//
+//*****************************************************************************
+uint8_t I2C_RunBatch(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Read Learned MAC Addresses (for I2C Commands)
+//! Returns up to I2C_MAC_CHUNK_ENTRIES dynamic entries of the MAC table
+//! snapshot in one read: the 16-bit position to continue from (0 once the end
+//! is reached), then for each entry its MAC address, port (numbered as in
+//! params[0]) and filter ID.
+//!
+//! \param params[0] port number (1 - 4 = f0 - f3, 5 = exp-port, 0 = all ports)
+//! \param params[1] upper 8 bits of the position to start from (0 for the first read)
+//! \param params[2] lower 8 bits of the position to start from
+//!
+//! \return Returns the number of entries returned
+//
+//*****************************************************************************
+uint8_t I2C_ReadMACTable(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Retrieve Port Status (for I2C Commands)
+//! Returns the I2C_PORT_STATUS_LENGTH control and status registers of a port
+//! in a single read.
+//!
+//! \param params[0] 8-bit base address of the port (see interpreter_task.h)
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_GetPortStatus(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Read Port Statistics (for I2C Commands)
+//! Returns I2C_PORT_STATS_LENGTH values for each port in a single read, f0 - f3
+//! first and exp-port last: the average received and transmitted bytes and
+//! packets per second, then the dropped packets and CRC errors since reset.
+//! Each value is 32 bits, most significant byte first.
+//!
+//! \return Returns false if no statistics were collected yet
+//
+//*****************************************************************************
+uint8_t I2C_ReadPortStatistics(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Read Cable Diagnostics (for I2C Commands)
+//! Returns the last cable test of each port without running a new one, f0
+//! first: I2C_CABLE_DIAG_LENGTH bytes per port holding the result (CableStatus,
+//! bit 7 set while a new test is running), the 16-bit distance to the fault in
+//! meters and the 32-bit age of the result in seconds, most significant byte
+//! first.
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+uint8_t I2C_ReadCableDiagnostics(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Query Configuration Digest (for I2C Commands)
+//! Returns the 32-bit digest of sections of the saved configuration, most
+//! significant byte first. A layer copying its configuration compares it with
+//! its own to skip layers that are already up to date.
+//!
+//! \param params[0] mask of sections (see CONFIG_SECTION_MASK)
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+uint8_t I2C_SyncQuery(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Begin Receiving A Configuration Section (for I2C Commands)
+//! Starts or resumes receiving a section of another layer's configuration.
+//! Returns the result followed by the 16-bit offset the master is to send
+//! from.
+//!
+//! \param params[0] the section (CONFIG_SECTION_*)
+//! \param params[1] upper 8 bits of the length of the section
+//! \param params[2] lower 8 bits of the length of the section
+//! \param params[3] - params[6] CRC-32 of the section, most significant byte first
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_SyncBegin(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Receive A Configuration Chunk (for I2C Commands)
+//! Stores the next chunk of the section being received.
+//!
+//! \param params[0] number of bytes that follow
+//! \param params[1] upper 8 bits of the offset of the chunk
+//! \param params[2] lower 8 bits of the offset of the chunk
+//! \param params[3] the chunk, followed by the CRC-32 of the offset and the
+//! chunk, most significant byte first
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_SyncData(uint8_t params[20]);
+//*****************************************************************************
+//
+//! Commit A Received Configuration (for I2C Commands)
+//! Saves the sections received from another layer as a new generation of the
+//! configuration store and applies them.
+//!
+//! \param params[0] mask of sections copied (see CONFIG_SECTION_MASK)
+//! \param params[1] - params[4] the sender's digest of those sections, most
+//! significant byte first
+//!
+//! \return Returns the results of the operation as a boolean
+//
+//*****************************************************************************
+uint8_t I2C_SyncCommit(uint8_t params[20]);
+//*****************************************************************************
+//
 //! Update A Task Progress Bar (for Command-Line Interface)
 //! Changes the current state of a progress bar by either incrementing, decrementing,
 //! the current value. Once updated, the value of lastprogress is updated so that
@@ -0,0 +1,1039 @@
+/**\file config_store.c
+ * \brief <b>Transactional A/B Configuration Store</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "eee_hal.h"
+#include "freertos_init.h"
+#include "command_functions.h"
+#include "vlan_table.h"
+#include "config_store.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+//*****************************************************************************
+//
+//! Length of the Ethernet Controller section (registers 0x00 - 0xFE).
+//
+//*****************************************************************************
+#define CONFIG_SWITCH_LENGTH 		0xFF
+
+//*****************************************************************************
+//
+//! Length of the user database section (MAX_USERS records of
+//! EEPROM_USER_RECORD_SIZE bytes: username, password, first name, last name
+//! and permission level).
+//
+//*****************************************************************************
+#define CONFIG_USERS_LENGTH 		(MAX_USERS * EEPROM_USER_RECORD_SIZE)
+
+//*****************************************************************************
+//
+//! \brief Callbacks and placement of one configuration section. Sections are
+//! rendered and loaded sequentially, a page at a time, so none of them needs
+//! a RAM copy of its saved form.
+//
+//*****************************************************************************
+typedef struct {
+	//! Offset of the section within a slot (page aligned)
+	uint32_t offset;
+	//! Bytes reserved for the section within a slot
+	uint32_t capacity;
+	//! Starts rendering the running configuration and returns the section length
+	uint32_t (*begin)(void);
+	//! Renders up to "length" more bytes into the buffer and returns the count (0 = done)
+	uint32_t (*render)(uint8_t *buffer, uint32_t length);
+	//! Prepares the running configuration to receive the section
+	void (*load_begin)(void);
+	//! Applies the next bytes of the section
+	void (*load)(const uint8_t *data, uint32_t length);
+	//! Finishes applying the section
+	bool (*load_end)(void);
+	//! Called after a commit that included this section (may be NULL)
+	void (*finish)(bool committed);
+} ConfigSection;
+
+//*****************************************************************************
+//
+//! Header of the committed generation and the slot it was read from or
+//! written to. The next generation is always committed to the other slot.
+//
+//*****************************************************************************
+static ConfigHeader ConfigCommitted;
+static uint32_t ConfigCommittedSlot = 1;
+
+//*****************************************************************************
+//
+//! Serializes commits from the interpreter and I2C tasks.
+//
+//*****************************************************************************
+static xSemaphoreHandle ConfigStoreMutex = NULL;
+
+//*****************************************************************************
+//
+//! Takes the store's mutex once the scheduler is running. Before that only
+//! one thread uses the store.
+//!
+//! \return Returns true if the mutex was taken and has to be given back
+//
+//*****************************************************************************
+static bool ConfigStoreLock(void)
+{
+	if (ConfigStoreMutex != NULL && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		return (xSemaphoreTake(ConfigStoreMutex, portMAX_DELAY) == pdTRUE);
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+//! Gives back the mutex taken by ConfigStoreLock().
+//!
+//! \param locked the value returned by ConfigStoreLock()
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigStoreUnlock(bool locked)
+{
+	if (locked) {
+		xSemaphoreGive(ConfigStoreMutex);
+	}
+}
+
+//*****************************************************************************
+//
+//! Read and write positions of the Ethernet Controller and user sections.
+//
+//*****************************************************************************
+static uint32_t ConfigSwitchCursor;
+static uint32_t ConfigUsersCursor;
+static uint32_t ConfigUsersSource;
+
+//*****************************************************************************
+//
+//! Starts rendering the Ethernet Controller registers.
+//!
+//! \return Returns the section length
+//
+//*****************************************************************************
+static uint32_t ConfigSwitchBegin(void)
+{
+	ConfigSwitchCursor = 0;
+	return CONFIG_SWITCH_LENGTH;
+}
+
+//*****************************************************************************
+//
+//! Renders the next Ethernet Controller registers. Registers come from the
+//! register shadow when it is loaded so that status registers read at
+//! different times cannot make an unchanged configuration look changed.
+//!
+//! \param buffer pointer-to-array of at least length bytes
+//! \param length the largest number of bytes to render
+//!
+//! \return Returns the number of bytes rendered, 0 once done or on an error
+//
+//*****************************************************************************
+static uint32_t ConfigSwitchRender(uint8_t *buffer, uint32_t length)
+{
+	uint32_t burst_data[ETHO_BURST_LENGTH];
+	uint32_t count, burst, pos;
+
+	if (length > (CONFIG_SWITCH_LENGTH - ConfigSwitchCursor)) {
+		length = CONFIG_SWITCH_LENGTH - ConfigSwitchCursor;
+	}
+
+	if (EthoShadowIsValid()) {
+		EthoShadowTakeRange(ConfigSwitchCursor, length, buffer);
+	}
+	else {
+		for (count = 0; count < length; count += burst) {
+			burst = ((length - count) < ETHO_BURST_LENGTH) ? (length - count) : ETHO_BURST_LENGTH;
+			if (!EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, (ConfigSwitchCursor + count), burst, burst_data)) {
+				return 0;
+			}
+			for (pos = 0; pos < burst; pos++) {
+				buffer[count + pos] = (burst_data[pos] & 0xFF);
+			}
+		}
+	}
+	ConfigSwitchCursor += length;
+	return length;
+}
+
+//*****************************************************************************
+//
+//! Prepares to restore the Ethernet Controller registers.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigSwitchLoadBegin(void)
+{
+	ConfigSwitchCursor = 0;
+}
+
+//*****************************************************************************
+//
+//! Writes the next saved registers to the Ethernet Controller in bursts.
+//!
+//! \param data pointer-to-array of saved register values
+//! \param length the number of bytes in data
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigSwitchLoad(const uint8_t *data, uint32_t length)
+{
+	uint32_t burst_data[ETHO_BURST_LENGTH];
+	uint32_t burst, pos;
+
+	while (length != 0 && ConfigSwitchCursor < CONFIG_SWITCH_LENGTH) {
+		burst = (length < ETHO_BURST_LENGTH) ? length : ETHO_BURST_LENGTH;
+		for (pos = 0; pos < burst; pos++) {
+			burst_data[pos] = data[pos];
+		}
+		EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, ConfigSwitchCursor, burst, burst_data);
+		ConfigSwitchCursor += burst;
+		data += burst;
+		length -= burst;
+	}
+}
+
+//*****************************************************************************
+//
+//! Finishes restoring the Ethernet Controller registers. The device now holds
+//! the saved image, so nothing needs to be saved again.
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+static bool ConfigSwitchLoadEnd(void)
+{
+	EthoShadowMarkRange(0, ETHO_SHADOW_SIZE, false);
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Puts the dirty flags taken by ConfigSwitchRender() back if the commit failed.
+//!
+//! \param committed true if the new generation was committed
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigSwitchFinish(bool committed)
+{
+	if (!committed) {
+		EthoShadowMarkRange(0, CONFIG_SWITCH_LENGTH, true);
+	}
+}
+
+//*****************************************************************************
+//
+//! Returns true if a user record is to be saved (not empty, not being deleted).
+//!
+//! \param index the index into users[]
+//!
+//! \return Returns true if the user is kept
+//
+//*****************************************************************************
+static bool ConfigUserKept(uint32_t index)
+{
+	return (users[index].username[0] != 0x00 && users[index].nextAction != Delete);
+}
+
+//*****************************************************************************
+//
+//! Returns one byte of the saved form of a user record.
+//!
+//! \param user the user to render
+//! \param field the byte within the record (0 - EEPROM_USER_RECORD_SIZE - 1)
+//!
+//! \return Returns the byte
+//
+//*****************************************************************************
+static uint8_t ConfigUserGetByte(const User_Data *user, uint32_t field)
+{
+	if (field < 16) {
+		return user->username[field];
+	}
+	if (field < 32) {
+		return user->password[field - 16];
+	}
+	if (field < 48) {
+		return user->first_name[field - 32];
+	}
+	if (field < 64) {
+		return user->last_name[field - 48];
+	}
+	return (uint8_t)user->permissions;
+}
+
+//*****************************************************************************
+//
+//! Sets one byte of a user record from its saved form.
+//!
+//! \param user the user to fill in
+//! \param field the byte within the record (0 - EEPROM_USER_RECORD_SIZE - 1)
+//! \param value the saved byte
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigUserSetByte(User_Data *user, uint32_t field, uint8_t value)
+{
+	if (field < 16) {
+		user->username[field] = value;
+	}
+	else if (field < 32) {
+		user->password[field - 16] = value;
+	}
+	else if (field < 48) {
+		user->first_name[field - 32] = value;
+	}
+	else if (field < 64) {
+		user->last_name[field - 48] = value;
+	}
+	else {
+		user->permissions = (PermLevel)value;
+	}
+}
+
+//*****************************************************************************
+//
+//! Starts rendering the user database.
+//!
+//! \return Returns the section length
+//
+//*****************************************************************************
+static uint32_t ConfigUsersBegin(void)
+{
+	ConfigUsersCursor = 0;
+	ConfigUsersSource = 0;
+	return CONFIG_USERS_LENGTH;
+}
+
+//*****************************************************************************
+//
+//! Renders the next bytes of the user database. Users being deleted are left
+//! out and the remaining records are packed to the front, the rest of the
+//! MAX_USERS records are blank.
+//!
+//! \param buffer pointer-to-array of at least length bytes
+//! \param length the largest number of bytes to render
+//!
+//! \return Returns the number of bytes rendered, 0 once done
+//
+//*****************************************************************************
+static uint32_t ConfigUsersRender(uint8_t *buffer, uint32_t length)
+{
+	uint32_t count = 0, field;
+
+	while (count < length && ConfigUsersCursor < CONFIG_USERS_LENGTH) {
+		field = ConfigUsersCursor % EEPROM_USER_RECORD_SIZE;
+		if (field == 0) {
+			while (ConfigUsersSource < MAX_USERS && !ConfigUserKept(ConfigUsersSource)) {
+				ConfigUsersSource++;
+			}
+		}
+		buffer[count++] = (ConfigUsersSource < MAX_USERS) ? ConfigUserGetByte(&users[ConfigUsersSource], field) : 0x00;
+		ConfigUsersCursor++;
+		if (field == (EEPROM_USER_RECORD_SIZE - 1) && ConfigUsersSource < MAX_USERS) {
+			ConfigUsersSource++;
+		}
+	}
+	return count;
+}
+
+//*****************************************************************************
+//
+//! Prepares to restore the user database.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigUsersLoadBegin(void)
+{
+	ConfigUsersCursor = 0;
+}
+
+//*****************************************************************************
+//
+//! Copies the next bytes of the saved user database into users[].
+//!
+//! \param data pointer-to-array of saved user records
+//! \param length the number of bytes in data
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigUsersLoad(const uint8_t *data, uint32_t length)
+{
+	while (length-- && ConfigUsersCursor < CONFIG_USERS_LENGTH) {
+		ConfigUserSetByte(&users[ConfigUsersCursor / EEPROM_USER_RECORD_SIZE], (ConfigUsersCursor % EEPROM_USER_RECORD_SIZE), *data++);
+		ConfigUsersCursor++;
+	}
+}
+
+//*****************************************************************************
+//
+//! Finishes restoring the user database. Restored users are left unchanged
+//! on the next configuration save.
+//!
+//! \return Returns true
+//
+//*****************************************************************************
+static bool ConfigUsersLoadEnd(void)
+{
+	uint32_t index;
+
+	for (index = 0; index < MAX_USERS; index++) {
+		users[index].isMarked = false;
+		users[index].nextAction = None;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Applies the pending user changes to users[] once they have been committed,
+//! so that RAM matches what the next boot will load.
+//!
+//! \param committed true if the new generation was committed
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigUsersFinish(bool committed)
+{
+	uint32_t source, target = 0;
+
+	if (!committed) {
+		return;
+	}
+	for (source = 0; source < MAX_USERS; source++) {
+		if (ConfigUserKept(source)) {
+			users[target] = users[source];
+			users[target].isMarked = false;
+			users[target].nextAction = None;
+			target++;
+		}
+	}
+	for (; target < MAX_USERS; target++) {
+		memset(&users[target], 0x00, sizeof(User_Data));
+		users[target].permissions = ReadOnlyUser;
+		users[target].nextAction = None;
+	}
+}
+
+//*****************************************************************************
+//
+//! Prepares the VLAN membership map to receive the saved VLAN image.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigVLANsLoadBegin(void)
+{
+	VLANImageLoadBegin(VLAN_SPARSE_MAX_SIZE);
+}
+
+//*****************************************************************************
+//
+//! Feeds the next bytes of the saved VLAN image into the membership map.
+//!
+//! \param data pointer-to-array of image bytes
+//! \param length the number of bytes in data
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigVLANsLoad(const uint8_t *data, uint32_t length)
+{
+	VLANImageLoad(data, length);
+}
+
+//*****************************************************************************
+//
+//! Checks the received VLAN image and programs the VLAN table from it.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool ConfigVLANsLoadEnd(void)
+{
+	return (VLANImageLoadEnd() && VLANTableProgram());
+}
+
+//*****************************************************************************
+//
+//! Placement and callbacks of every section, indexed by CONFIG_SECTION_*.
+//! Sections are applied in this order on boot, the switch registers first so
+//! that the VLAN table is programmed with VLAN support already configured.
+//
+//*****************************************************************************
+static const ConfigSection ConfigSections[CONFIG_SECTION_COUNT] = {
+		{CONFIG_STORE_DATA_OFFSET, 	0x100,	ConfigSwitchBegin,	ConfigSwitchRender,	ConfigSwitchLoadBegin,	ConfigSwitchLoad,	ConfigSwitchLoadEnd,	ConfigSwitchFinish},
+		{0x200, 					0x400,	ConfigUsersBegin,	ConfigUsersRender,	ConfigUsersLoadBegin,	ConfigUsersLoad,	ConfigUsersLoadEnd,		ConfigUsersFinish},
+		{0x600, 					0x3100,	VLANImageBegin,		VLANImageRender,	ConfigVLANsLoadBegin,	ConfigVLANsLoad,	ConfigVLANsLoadEnd,		NULL}
+};
+
+//*****************************************************************************
+//
+//! Returns the EEPROM address of a slot.
+//!
+//! \param slot 0 = EEPROM_CONFIG_SLOT_A, 1 = EEPROM_CONFIG_SLOT_B
+//!
+//! \return Returns the base address of the slot
+//
+//*****************************************************************************
+static uint32_t ConfigSlotBase(uint32_t slot)
+{
+	return (slot ? EEPROM_CONFIG_SLOT_B : EEPROM_CONFIG_SLOT_A);
+}
+
+//*****************************************************************************
+//
+//! Returns the slot a new copy of a section is written to: the one the
+//! committed generation does not use for it.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//!
+//! \return Returns the slot (0 or 1)
+//
+//*****************************************************************************
+static uint8_t ConfigSpareBank(uint32_t index)
+{
+	return (ConfigCommitted.sections[index].present ? (ConfigCommitted.sections[index].bank ^ 1) : (ConfigCommittedSlot ^ 1));
+}
+
+//*****************************************************************************
+//
+//! Returns the CRC-32 of a header, excluding its crc field.
+//!
+//! \param header the header to check
+//!
+//! \return Returns the CRC of the header
+//
+//*****************************************************************************
+static uint32_t ConfigHeaderCrc(const ConfigHeader *header)
+{
+	return (EEPROMCrc32(EEPROM_CRC32_INIT, (const uint8_t *)header, offsetof(ConfigHeader, crc)) ^ EEPROM_CRC32_INIT);
+}
+
+//*****************************************************************************
+//
+//! Reads the header of a slot.
+//!
+//! \param slot the slot to read (0 or 1)
+//! \param header returns the header
+//!
+//! \return Returns true if the header is valid, otherwise false
+//
+//*****************************************************************************
+static bool ConfigReadHeader(uint32_t slot, ConfigHeader *header)
+{
+	if (!EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, ConfigSlotBase(slot), (uint8_t *)header, sizeof(ConfigHeader))) {
+		return false;
+	}
+	return (header->magic == CONFIG_STORE_MAGIC && header->crc == ConfigHeaderCrc(header));
+}
+
+//*****************************************************************************
+//
+//! Reads a committed section a page at a time, either checking it against its
+//! CRC or passing it to the section's loader.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param entry where the section lives
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//! \param apply false to check the CRC only, true to apply the section
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool ConfigSectionRead(uint32_t index, const ConfigSectionEntry *entry, uint8_t *buffer, bool apply)
+{
+	const ConfigSection *section = &ConfigSections[index];
+	uint32_t address = ConfigSlotBase(entry->bank) + section->offset;
+	uint32_t offset, length, crc = EEPROM_CRC32_INIT;
+
+	if (entry->length > section->capacity) {
+		return false;
+	}
+	if (apply) {
+		section->load_begin();
+	}
+	for (offset = 0; offset < entry->length; offset += length) {
+		length = ((entry->length - offset) < EEPROM_PAGE_SIZE) ? (entry->length - offset) : EEPROM_PAGE_SIZE;
+		if (!EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, (address + offset), buffer, length)) {
+			return false;
+		}
+		if (apply) {
+			section->load(buffer, length);
+		}
+		else {
+			crc = EEPROMCrc32(crc, buffer, length);
+		}
+	}
+	return (apply ? section->load_end() : ((crc ^ EEPROM_CRC32_INIT) == entry->crc));
+}
+
+//*****************************************************************************
+//
+//! Renders a section and, if it differs from what the entry describes, writes
+//! it into the slot the entry does not point at. The entry is updated to
+//! describe the new copy. The CRC saved is the one of the bytes actually
+//! written.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param entry the section's entry in the generation being built
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//! \param changed returns true if the section was written
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool ConfigSectionSave(uint32_t index, ConfigSectionEntry *entry, uint8_t *buffer, bool *changed)
+{
+	const ConfigSection *section = &ConfigSections[index];
+	uint32_t length, count, offset = 0, address, crc = EEPROM_CRC32_INIT;
+	uint8_t bank;
+
+	*changed = false;
+
+	//Render once without writing to find out whether anything changed
+	length = section->begin();
+	if (length > section->capacity) {
+		return false;
+	}
+	while ((count = section->render(buffer, EEPROM_PAGE_SIZE)) != 0) {
+		crc = EEPROMCrc32(crc, buffer, count);
+		offset += count;
+	}
+	if (offset != length) {
+		return false;
+	}
+	crc ^= EEPROM_CRC32_INIT;
+	if (entry->present && entry->length == length && entry->crc == crc) {
+		return true;
+	}
+
+	//Never overwrite the copy the committed generation refers to
+	bank = ConfigSpareBank(index);
+	address = ConfigSlotBase(bank) + section->offset;
+
+	length = section->begin();
+	crc = EEPROM_CRC32_INIT;
+	offset = 0;
+	while ((count = section->render(buffer, EEPROM_PAGE_SIZE)) != 0) {
+		//Sections are page aligned and rendered a page at a time, so each chunk is one page write
+		if (!EEPROMPageWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, (address + offset), buffer, count)) {
+			return false;
+		}
+		crc = EEPROMCrc32(crc, buffer, count);
+		offset += count;
+	}
+	if (offset != length) {
+		return false;
+	}
+
+	entry->length = length;
+	entry->crc = crc ^ EEPROM_CRC32_INIT;
+	entry->bank = bank;
+	entry->present = 1;
+	entry->reserved = 0;
+	*changed = true;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Clears the configuration flags used by firmware without the configuration
+//! store, so the legacy images are never loaded once a generation exists.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void ConfigRetireLegacyFlags(void)
+{
+	uint8_t legacy = (1 << FLAG_CONFIG_SAVED) | (1 << FLAG_CONFIG_VLAN_VALID) | (1 << FLAG_CONFIG_USERS_VALID);
+	uint8_t settings = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_SETTINGS);
+
+	if (settings & legacy) {
+		EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_SETTINGS, (settings & ~legacy));
+	}
+}
+
+//*****************************************************************************
+//
+//! Writes the header of a new generation to the slot the committed one is not
+//! in and makes it the committed generation.
+//!
+//! \param header the new generation, its crc field is filled in
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool ConfigWriteHeader(ConfigHeader *header)
+{
+	uint32_t slot = ConfigCommittedSlot ^ 1;
+
+	header->crc = ConfigHeaderCrc(header);
+	//Flip to the new generation. Until this write completes the committed one stays intact
+	if (!EEPROMPageWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, ConfigSlotBase(slot), (uint8_t *)header, sizeof(ConfigHeader))) {
+		return false;
+	}
+	ConfigCommitted = *header;
+	ConfigCommittedSlot = slot;
+	ConfigRetireLegacyFlags();
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Finds the newest committed generation whose header and sections all pass
+//! their CRC checks.
+//!
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns true if a generation was found, otherwise false
+//
+//*****************************************************************************
+bool ConfigStoreOpen(uint8_t *buffer)
+{
+	ConfigHeader headers[2];
+	bool valid[2];
+	uint32_t attempt, slot, newest, index;
+	bool intact;
+
+	if (ConfigStoreMutex == NULL) {
+		ConfigStoreMutex = xSemaphoreCreateMutex();
+	}
+	memset(&ConfigCommitted, 0x00, sizeof(ConfigCommitted));
+	ConfigCommittedSlot = 1;
+
+	valid[0] = ConfigReadHeader(0, &headers[0]);
+	valid[1] = ConfigReadHeader(1, &headers[1]);
+	if (valid[0] && valid[1]) {
+		newest = ((int32_t)(headers[1].generation - headers[0].generation) > 0) ? 1 : 0;
+	}
+	else {
+		newest = valid[1] ? 1 : 0;
+	}
+
+	//Try the newest generation first, fall back to the other slot if any of its sections is torn
+	for (attempt = 0; attempt < 2; attempt++) {
+		slot = newest ^ attempt;
+		if (!valid[slot]) {
+			continue;
+		}
+		intact = true;
+		for (index = 0; index < CONFIG_SECTION_COUNT && intact; index++) {
+			if (headers[slot].sections[index].present) {
+				intact = ConfigSectionRead(index, &headers[slot].sections[index], buffer, false);
+			}
+		}
+		if (!intact) {
+			continue;
+		}
+
+		ConfigCommitted = headers[slot];
+		ConfigCommittedSlot = slot;
+		return true;
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+//! Applies sections of the generation found by ConfigStoreOpen().
+//!
+//! \param sections mask of sections to apply (see CONFIG_SECTION_MASK)
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool ConfigStoreApply(uint32_t sections, uint8_t *buffer)
+{
+	uint32_t index;
+	bool locked, result = true;
+
+	locked = ConfigStoreLock();
+	for (index = 0; index < CONFIG_SECTION_COUNT; index++) {
+		if ((sections & CONFIG_SECTION_MASK(index)) && ConfigCommitted.sections[index].present) {
+			result &= ConfigSectionRead(index, &ConfigCommitted.sections[index], buffer, true);
+		}
+	}
+	ConfigStoreUnlock(locked);
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Commits a new generation with the sections in "update" saved from the
+//! running configuration and the sections in "remove" left out.
+//!
+//! \param update mask of sections to save (see CONFIG_SECTION_MASK)
+//! \param remove mask of sections to leave out of the new generation
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//! \param written returns the mask of sections that were rewritten (may be NULL)
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool ConfigStoreCommit(uint32_t update, uint32_t remove, uint8_t *buffer, uint32_t *written)
+{
+	ConfigHeader header;
+	uint32_t index, rewritten = 0;
+	bool changed, locked, result = true;
+
+	locked = ConfigStoreLock();
+
+	header = ConfigCommitted;
+	header.magic = CONFIG_STORE_MAGIC;
+	header.generation = ConfigCommitted.generation + 1;
+
+	for (index = 0; index < CONFIG_SECTION_COUNT && result; index++) {
+		if (remove & CONFIG_SECTION_MASK(index)) {
+			memset(&header.sections[index], 0x00, sizeof(ConfigSectionEntry));
+		}
+		else if (update & CONFIG_SECTION_MASK(index)) {
+			result = ConfigSectionSave(index, &header.sections[index], buffer, &changed);
+			if (changed) {
+				rewritten |= CONFIG_SECTION_MASK(index);
+			}
+		}
+	}
+
+	//Nothing to commit if every section is where the committed generation already has it
+	if (result && (ConfigCommitted.magic != CONFIG_STORE_MAGIC || memcmp(header.sections, ConfigCommitted.sections, sizeof(header.sections)) != 0)) {
+		result = ConfigWriteHeader(&header);
+	}
+
+	for (index = 0; index < CONFIG_SECTION_COUNT; index++) {
+		if ((update & ~remove & CONFIG_SECTION_MASK(index)) && ConfigSections[index].finish != NULL) {
+			ConfigSections[index].finish(result);
+		}
+	}
+
+	ConfigStoreUnlock(locked);
+	if (written != NULL) {
+		*written = rewritten;
+	}
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Returns the mask of sections present in the committed generation.
+//!
+//! \return Returns a mask of CONFIG_SECTION_MASK() values
+//
+//*****************************************************************************
+uint32_t ConfigStoreSections(void)
+{
+	uint32_t index, sections = 0;
+
+	for (index = 0; index < CONFIG_SECTION_COUNT; index++) {
+		if (ConfigCommitted.sections[index].present) {
+			sections |= CONFIG_SECTION_MASK(index);
+		}
+	}
+	return sections;
+}
+
+//*****************************************************************************
+//
+//! Returns the committed generation number (0 if nothing has been committed).
+//!
+//! \return Returns the generation number
+//
+//*****************************************************************************
+uint32_t ConfigStoreGeneration(void)
+{
+	return ConfigCommitted.generation;
+}
+
+//*****************************************************************************
+//
+//! Returns a digest of sections: a CRC-32 of their lengths and checksums,
+//! absent sections counting as zero.
+//!
+//! \param entries the sections, NULL for the committed generation
+//! \param sections mask of sections (see CONFIG_SECTION_MASK)
+//!
+//! \return Returns the digest
+//
+//*****************************************************************************
+uint32_t ConfigStoreDigest(const ConfigSectionEntry *entries, uint32_t sections)
+{
+	uint32_t index, crc = EEPROM_CRC32_INIT;
+	uint32_t summary[2];
+
+	if (entries == NULL) {
+		entries = ConfigCommitted.sections;
+	}
+	for (index = 0; index < CONFIG_SECTION_COUNT; index++) {
+		if (sections & CONFIG_SECTION_MASK(index)) {
+			summary[0] = entries[index].present ? entries[index].length : 0;
+			summary[1] = entries[index].present ? entries[index].crc : 0;
+			crc = EEPROMCrc32(crc, (const uint8_t *)summary, sizeof(summary));
+		}
+	}
+	return (crc ^ EEPROM_CRC32_INIT);
+}
+
+//*****************************************************************************
+//
+//! Returns the entry of a section in the committed generation.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param entry returns the entry
+//!
+//! \return Returns false if the section is not part of the generation
+//
+//*****************************************************************************
+bool ConfigStoreSectionInfo(uint32_t index, ConfigSectionEntry *entry)
+{
+	if (index >= CONFIG_SECTION_COUNT || !ConfigCommitted.sections[index].present) {
+		return false;
+	}
+	*entry = ConfigCommitted.sections[index];
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Reads part of a section of the committed generation as it is saved.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param offset the first byte to read within the section
+//! \param buffer returns the bytes
+//! \param length the number of bytes to read
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool ConfigStoreSectionRead(uint32_t index, uint32_t offset, uint8_t *buffer, uint32_t length)
+{
+	const ConfigSectionEntry *entry;
+	bool locked, result = false;
+
+	if (index >= CONFIG_SECTION_COUNT) {
+		return false;
+	}
+	locked = ConfigStoreLock();
+	entry = &ConfigCommitted.sections[index];
+	if (entry->present && (offset + length) <= entry->length) {
+		result = EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, (ConfigSlotBase(entry->bank) + ConfigSections[index].offset + offset), buffer, length);
+	}
+	ConfigStoreUnlock(locked);
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Writes part of a section received from elsewhere into the slot the
+//! committed generation does not use for it.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param offset the position within the section
+//! \param data the bytes to write
+//! \param length the number of bytes, all within one EEPROM page
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool ConfigStoreImportWrite(uint32_t index, uint32_t offset, const uint8_t *data, uint32_t length)
+{
+	bool locked, result = false;
+
+	if (index >= CONFIG_SECTION_COUNT || (offset + length) > ConfigSections[index].capacity
+			|| ((offset % EEPROM_PAGE_SIZE) + length) > EEPROM_PAGE_SIZE) {
+		return false;
+	}
+	locked = ConfigStoreLock();
+	result = EEPROMPageWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,
+			(ConfigSlotBase(ConfigSpareBank(index)) + ConfigSections[index].offset + offset), (uint8_t *)data, length);
+	ConfigStoreUnlock(locked);
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Commits a new generation made of sections written with
+//! ConfigStoreImportWrite(). Each imported section is checked against its CRC
+//! before the header is written.
+//!
+//! \param sections mask of sections imported or removed
+//! \param entries the length and CRC of every section in "sections", those
+//! not present are left out of the new generation
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool ConfigStoreImportCommit(uint32_t sections, const ConfigSectionEntry *entries, uint8_t *buffer)
+{
+	ConfigHeader header;
+	uint32_t index;
+	bool locked, result = true;
+
+	locked = ConfigStoreLock();
+
+	header = ConfigCommitted;
+	header.magic = CONFIG_STORE_MAGIC;
+	header.generation = ConfigCommitted.generation + 1;
+
+	for (index = 0; index < CONFIG_SECTION_COUNT && result; index++) {
+		if (!(sections & CONFIG_SECTION_MASK(index))) {
+			continue;
+		}
+		memset(&header.sections[index], 0x00, sizeof(ConfigSectionEntry));
+		if (entries[index].present) {
+			header.sections[index].length = entries[index].length;
+			header.sections[index].crc = entries[index].crc;
+			header.sections[index].bank = ConfigSpareBank(index);
+			header.sections[index].present = 1;
+			//A commit made on this layer since the section was written may have overwritten it
+			result = ConfigSectionRead(index, &header.sections[index], buffer, false);
+		}
+	}
+	if (result) {
+		result = ConfigWriteHeader(&header);
+	}
+
+	ConfigStoreUnlock(locked);
+	return result;
+}
@@ -0,0 +1,244 @@
+/**\file config_store.h
+ * \brief <b>Transactional A/B Configuration Store</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef CONFIG_STORE_H_
+#define CONFIG_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+//! Sections held by the configuration store. Each section is saved, checked
+//! and carried over between generations on its own.
+//
+//*****************************************************************************
+#define CONFIG_SECTION_SWITCH 		0
+#define CONFIG_SECTION_USERS 		1
+#define CONFIG_SECTION_VLANS 		2
+#define CONFIG_SECTION_COUNT 		3
+
+//*****************************************************************************
+//
+//! Section masks for ConfigStoreCommit() and ConfigStoreSections().
+//
+//*****************************************************************************
+#define CONFIG_SECTION_MASK(s) 		(1 << (s))
+#define CONFIG_SECTIONS_ALL 		((1 << CONFIG_SECTION_COUNT) - 1)
+
+//*****************************************************************************
+//
+//! Identifies a valid slot header ("CFG1").
+//
+//*****************************************************************************
+#define CONFIG_STORE_MAGIC 			0x43464731
+
+//*****************************************************************************
+//
+//! Offset of the section data within a slot. The header takes the first page.
+//
+//*****************************************************************************
+#define CONFIG_STORE_DATA_OFFSET 	0x100
+
+//*****************************************************************************
+//
+//! \brief Location and checksum of one section in a committed generation.
+//
+//*****************************************************************************
+typedef struct {
+	//! Length of the section in bytes
+	uint32_t length;
+	//! CRC-32 of the section data
+	uint32_t crc;
+	//! Slot that holds the section data (0 = EEPROM_CONFIG_SLOT_A, 1 = EEPROM_CONFIG_SLOT_B)
+	uint8_t bank;
+	//! Non-zero if the section is part of this generation
+	uint8_t present;
+	//! Unused, written as zero
+	uint16_t reserved;
+} ConfigSectionEntry;
+
+//*****************************************************************************
+//
+//! \brief Header written to the first page of a slot to commit a generation.
+//! The header is written after all of the section data it refers to, so a
+//! generation only becomes visible once it is complete.
+//
+//*****************************************************************************
+typedef struct {
+	//! CONFIG_STORE_MAGIC
+	uint32_t magic;
+	//! Incremented on every commit. The valid header with the newest generation wins.
+	uint32_t generation;
+	//! Where each section of this generation lives
+	ConfigSectionEntry sections[CONFIG_SECTION_COUNT];
+	//! CRC-32 of all of the fields above
+	uint32_t crc;
+} ConfigHeader;
+
+//*****************************************************************************
+//
+// Prototypes for the configuration store.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Finds the newest committed generation whose header and sections all pass
+//! their CRC checks. An older generation is used if the newest one is not
+//! intact. Nothing is applied until ConfigStoreApply() is called. Must be
+//! called before the scheduler is started.
+//!
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns true if a generation was found, otherwise false
+//
+//*****************************************************************************
+extern bool ConfigStoreOpen(uint8_t *buffer);
+//*****************************************************************************
+//
+//! Applies sections of the generation found by ConfigStoreOpen() to the
+//! Ethernet Controller, the VLAN table or the user database. Sections not in
+//! the generation are skipped.
+//!
+//! \param sections mask of sections to apply (see CONFIG_SECTION_MASK)
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool ConfigStoreApply(uint32_t sections, uint8_t *buffer);
+
+//*****************************************************************************
+//
+//! Commits a new generation. Sections in "update" are rendered from the
+//! running configuration and written only if they differ from the committed
+//! generation, into the slot the committed generation does not use for them.
+//! Sections in "remove" are left out. All other sections are carried over
+//! without being rewritten. The header is written last.
+//!
+//! \param update mask of sections to save (see CONFIG_SECTION_MASK)
+//! \param remove mask of sections to leave out of the new generation
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//! \param written returns the mask of sections that were rewritten (may be NULL)
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool ConfigStoreCommit(uint32_t update, uint32_t remove, uint8_t *buffer, uint32_t *written);
+
+//*****************************************************************************
+//
+//! Returns the mask of sections present in the committed generation.
+//!
+//! \return Returns a mask of CONFIG_SECTION_MASK() values
+//
+//*****************************************************************************
+extern uint32_t ConfigStoreSections(void);
+
+//*****************************************************************************
+//
+//! Returns the committed generation number (0 if nothing has been committed).
+//!
+//! \return Returns the generation number
+//
+//*****************************************************************************
+extern uint32_t ConfigStoreGeneration(void);
+
+//*****************************************************************************
+//
+//! Returns a digest of sections: a CRC-32 of their lengths and checksums,
+//! absent sections counting as zero. Two layers whose digests of the same
+//! sections match hold the same saved configuration for them, whatever their
+//! generation numbers.
+//!
+//! \param entries the sections, NULL for the committed generation
+//! \param sections mask of sections (see CONFIG_SECTION_MASK)
+//!
+//! \return Returns the digest
+//
+//*****************************************************************************
+extern uint32_t ConfigStoreDigest(const ConfigSectionEntry *entries, uint32_t sections);
+
+//*****************************************************************************
+//
+//! Returns the entry of a section in the committed generation.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param entry returns the entry
+//!
+//! \return Returns false if the section is not part of the generation
+//
+//*****************************************************************************
+extern bool ConfigStoreSectionInfo(uint32_t index, ConfigSectionEntry *entry);
+
+//*****************************************************************************
+//
+//! Reads part of a section of the committed generation as it is saved, so
+//! that it can be copied to another layer.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param offset the first byte to read within the section
+//! \param buffer returns the bytes
+//! \param length the number of bytes to read
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool ConfigStoreSectionRead(uint32_t index, uint32_t offset, uint8_t *buffer, uint32_t length);
+
+//*****************************************************************************
+//
+//! Writes part of a section received from another layer into the slot the
+//! committed generation does not use for it. Nothing changes until
+//! ConfigStoreImportCommit() is called.
+//!
+//! \param index the section (CONFIG_SECTION_*)
+//! \param offset the position within the section
+//! \param data the bytes to write
+//! \param length the number of bytes, all within one EEPROM page
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool ConfigStoreImportWrite(uint32_t index, uint32_t offset, const uint8_t *data, uint32_t length);
+
+//*****************************************************************************
+//
+//! Commits a new generation made of sections written with
+//! ConfigStoreImportWrite(). Each imported section is checked against its CRC
+//! before the header is written. Sections outside "sections" are carried
+//! over. Nothing is applied until ConfigStoreApply() is called.
+//!
+//! \param sections mask of sections imported or removed
+//! \param entries the length and CRC of every section in "sections", indexed
+//! by CONFIG_SECTION_*. Those not present are left out of the new generation
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool ConfigStoreImportCommit(uint32_t sections, const ConfigSectionEntry *entries, uint8_t *buffer);
+
+#endif /* CONFIG_STORE_H_ */
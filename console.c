@@ -0,0 +1,1123 @@
+/**\file console.c
+ * \brief <b>Interrupt-Driven Console Input and uDMA Output</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_uart.h"
+#include "uart.h"
+#include "udma.h"
+#include "interrupt.h"
+#include "freertos_init.h"
+#include "console.h"
+#include "memory_budget.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+//*****************************************************************************
+//
+//! States of the escape sequence decoder.
+//
+//*****************************************************************************
+typedef enum {
+	ConsoleText,
+	ConsoleEscape,
+	ConsoleSequence
+} ConsoleRxState;
+
+//*****************************************************************************
+//
+//! Destinations of formatted output, see ConsoleFormat().
+//
+//*****************************************************************************
+typedef enum {
+	//! Only count the characters
+	ConsoleSinkCount,
+	//! Store straight into the transmit ring, space has been checked
+	ConsoleSinkRing,
+	//! Collect in chunk and write the chunks, waiting for space
+	ConsoleSinkChunk
+} ConsoleSinkMode;
+
+typedef struct {
+	ConsoleSinkMode mode;
+	uint32_t count;
+	uint32_t used;
+	char chunk[CONSOLE_TX_CHUNK_SIZE];
+} ConsoleSink;
+
+//*****************************************************************************
+//
+//! The queue that carries the indices of assembled lines to the interpreter
+//! task. The lines themselves stay in ConsoleLines.
+//
+//*****************************************************************************
+xQueueHandle g_pINTERPRETERQueue;
+
+//*****************************************************************************
+//
+//! The queue of key presses read by menus in key mode.
+//
+//*****************************************************************************
+static xQueueHandle ConsoleKeyQueue = NULL;
+
+//*****************************************************************************
+//
+//! Line buffers and the mask of those not in use. A line is owned by the
+//! interrupt while it is assembled and by the receiving task from
+//! ConsoleLineReceive() until ConsoleLineRelease().
+//
+//*****************************************************************************
+static char ConsoleLines[CONSOLE_LINE_COUNT][CONSOLE_LINE_SIZE];
+static volatile uint32_t ConsoleLinesFree = ((1 << CONSOLE_LINE_COUNT) - 1);
+
+//*****************************************************************************
+//
+//! The line being assembled by the interrupt and its length.
+//
+//*****************************************************************************
+static uint8_t ConsoleAssembly = CONSOLE_NO_LINE;
+static uint32_t ConsoleLength = 0;
+
+//*****************************************************************************
+//
+//! Previously entered lines. ConsoleHistoryNext is the slot for the next line,
+//! ConsoleHistoryCursor how far back the line being edited was recalled from
+//! (0 if it was typed).
+//
+//*****************************************************************************
+static char ConsoleHistory[CONSOLE_HISTORY_DEPTH][CONSOLE_LINE_SIZE];
+static uint32_t ConsoleHistoryCount = 0;
+static uint32_t ConsoleHistoryNext = 0;
+static uint32_t ConsoleHistoryCursor = 0;
+
+//*****************************************************************************
+//
+//! Receive state: escape sequence decoding, whether the last character was a
+//! carriage return (so the line feed of a CR LF pair is dropped), echo and key
+//! mode.
+//
+//*****************************************************************************
+static ConsoleRxState ConsoleState = ConsoleText;
+static bool ConsoleLastCR = false;
+static volatile bool ConsoleEcho = true;
+static volatile bool ConsoleKeys = false;
+
+//*****************************************************************************
+//
+//! Transmit ring. ConsoleTxHead and ConsoleTxTail are free running, the ring
+//! holds ConsoleTxHead - ConsoleTxTail characters. ConsoleTxLength characters
+//! from the tail are being sent by the uDMA channel while ConsoleTxActive.
+//! The ring is only changed with interrupts masked up to
+//! configMAX_SYSCALL_INTERRUPT_PRIORITY, so tasks and interrupts may print.
+//
+//*****************************************************************************
+static char ConsoleTxBuffer[CONSOLE_TX_BUFFER_SIZE];
+static volatile uint32_t ConsoleTxHead = 0;
+static volatile uint32_t ConsoleTxTail = 0;
+static volatile uint32_t ConsoleTxLength = 0;
+static volatile bool ConsoleTxActive = false;
+static bool ConsoleTxDMAReady = false;
+
+//*****************************************************************************
+//
+//! Given each time a uDMA transfer completes, for tasks waiting for space.
+//
+//*****************************************************************************
+static xSemaphoreHandle ConsoleTxSpace = NULL;
+
+//*****************************************************************************
+//
+//! Transmit counters, see ConsoleTxStatsGet().
+//
+//*****************************************************************************
+static ConsoleTxStats ConsoleTxCounters = {0};
+
+//*****************************************************************************
+//
+//! Configures UART1 for CONSOLE_BAUD_RATE, 8-N-1, creates the line and key
+//! queues and enables the receive interrupt. Until ConsoleDMAInit() is
+//! called, output is written to the UART directly.
+//!
+//! \param ui32SrcClock clock supplied to UART1 in Hz
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleInit(uint32_t ui32SrcClock)
+{
+	g_pINTERPRETERQueue = MemoryQueueCreate("CONSOLE_LINES", CONSOLE_LINE_COUNT, sizeof(uint8_t));
+	ConsoleKeyQueue = MemoryQueueCreate("CONSOLE_KEYS", CONSOLE_KEY_QUEUE_SIZE, sizeof(char));
+	ConsoleTxSpace = xSemaphoreCreateBinary();
+
+	UARTConfigSetExpClk(UART1_BASE, ui32SrcClock, CONSOLE_BAUD_RATE,
+						(UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE));
+	UARTFIFOLevelSet(UART1_BASE, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+	UARTFIFOEnable(UART1_BASE);
+
+	UARTIntEnable(UART1_BASE, UART_INT_RX | UART_INT_RT);
+	IntPrioritySet(INT_UART1, CONSOLE_INT_PRIORITY);
+	IntEnable(INT_UART1);
+	UARTEnable(UART1_BASE);
+}
+
+//*****************************************************************************
+//
+//! Hands the transmit ring over to the uDMA engine. Must be called after
+//! SSIDMAInit() has enabled the controller and set its control table.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleDMAInit(void)
+{
+	uint32_t ui32Mask;
+
+	uDMAChannelAssign(UDMA_CH23_UART1TX);
+	uDMAChannelAttributeDisable(UDMA_CHANNEL_UART1TX, UDMA_ATTR_ALL);
+	uDMAChannelControlSet(UDMA_CHANNEL_UART1TX | UDMA_PRI_SELECT,
+						  UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_4);
+	UARTDMAEnable(UART1_BASE, UART_DMA_TX);
+
+	ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	ConsoleTxDMAReady = true;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+}
+
+//*****************************************************************************
+//
+//! Starts sending the oldest characters of the ring if no transfer is
+//! running. A transfer stops at the end of the ring. Before the uDMA engine
+//! is set up the ring is written out directly. Called with interrupts masked.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleTxStart(void)
+{
+	uint32_t tail = ConsoleTxTail & (CONSOLE_TX_BUFFER_SIZE - 1);
+	uint32_t length = ConsoleTxHead - ConsoleTxTail;
+
+	if (ConsoleTxActive || (length == 0)) {
+		return;
+	}
+
+	if (!ConsoleTxDMAReady) {
+		while (ConsoleTxTail != ConsoleTxHead) {
+			UARTCharPut(UART1_BASE, ConsoleTxBuffer[ConsoleTxTail++ & (CONSOLE_TX_BUFFER_SIZE - 1)]);
+		}
+		return;
+	}
+
+	if (length > (CONSOLE_TX_BUFFER_SIZE - tail)) {
+		length = CONSOLE_TX_BUFFER_SIZE - tail;
+	}
+	if (length > CONSOLE_TX_DMA_MAX) {
+		length = CONSOLE_TX_DMA_MAX;
+	}
+	uDMAChannelTransferSet(UDMA_CHANNEL_UART1TX | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+						   &ConsoleTxBuffer[tail], (void *)(UART1_BASE + UART_O_DR), length);
+	ConsoleTxLength = length;
+	ConsoleTxActive = true;
+	uDMAChannelEnable(UDMA_CHANNEL_UART1TX);
+}
+
+//*****************************************************************************
+//
+//! Retires the running transfer once the uDMA channel has finished it and
+//! starts the next. Called with interrupts masked.
+//!
+//! \return Returns true if a transfer was retired.
+//
+//*****************************************************************************
+static bool ConsoleTxComplete(void)
+{
+	if (!ConsoleTxActive || uDMAChannelIsEnabled(UDMA_CHANNEL_UART1TX)) {
+		return false;
+	}
+	ConsoleTxTail += ConsoleTxLength;
+	ConsoleTxLength = 0;
+	ConsoleTxActive = false;
+	ConsoleTxStart();
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Records the fill level of the ring. Called with interrupts masked.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleTxHighWater(void)
+{
+	if ((ConsoleTxHead - ConsoleTxTail) > ConsoleTxCounters.high_water) {
+		ConsoleTxCounters.high_water = ConsoleTxHead - ConsoleTxTail;
+	}
+}
+
+//*****************************************************************************
+//
+//! Copies characters into the ring and starts the transfer. With wait, the
+//! caller is blocked until all characters fit, otherwise characters that do
+//! not fit are dropped and counted; a write is never partially dropped.
+//!
+//! \param pcBuf characters to send
+//! \param ui32Len number of characters
+//! \param wait true to wait for space, only from a task
+//!
+//! \return Returns false if the characters were dropped.
+//
+//*****************************************************************************
+static bool ConsoleTxWrite(const char *pcBuf, uint32_t ui32Len, bool wait)
+{
+	uint32_t ui32Mask, space, length;
+
+	while (ui32Len) {
+		ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+		space = CONSOLE_TX_BUFFER_SIZE - (ConsoleTxHead - ConsoleTxTail);
+		if (!wait && (space < ui32Len)) {
+			ConsoleTxCounters.dropped_messages++;
+			ConsoleTxCounters.dropped_bytes += ui32Len;
+			portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+			return false;
+		}
+
+		length = (ui32Len < space) ? ui32Len : space;
+		ui32Len -= length;
+		while (length--) {
+			ConsoleTxBuffer[ConsoleTxHead++ & (CONSOLE_TX_BUFFER_SIZE - 1)] = *pcBuf++;
+		}
+		ConsoleTxHighWater();
+		ConsoleTxStart();
+
+		portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+
+		if (ui32Len) {
+			ConsoleTxCounters.waits++;
+			if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+				xSemaphoreTake(ConsoleTxSpace, CONSOLE_TX_WAIT_MS / portTICK_RATE_MS);
+			}
+			else {
+				//Interrupts are masked until the scheduler starts, poll the channel
+				ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+				ConsoleTxComplete();
+				portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+			}
+		}
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Passes one formatted character to a sink, expanding '\n' to "\r\n".
+//!
+//! \param sink the destination
+//! \param cChar the character
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleSinkPut(ConsoleSink *sink, char cChar)
+{
+	if (cChar == '\n') {
+		ConsoleSinkPut(sink, '\r');
+	}
+	sink->count++;
+
+	switch (sink->mode) {
+	case ConsoleSinkRing:
+		ConsoleTxBuffer[ConsoleTxHead++ & (CONSOLE_TX_BUFFER_SIZE - 1)] = cChar;
+		break;
+	case ConsoleSinkChunk:
+		sink->chunk[sink->used++] = cChar;
+		if (sink->used == CONSOLE_TX_CHUNK_SIZE) {
+			ConsoleTxWrite(sink->chunk, sink->used, true);
+			sink->used = 0;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+//*****************************************************************************
+//
+//! Passes a field to a sink, padded to the given width.
+//!
+//! \param sink the destination
+//! \param pcField the field
+//! \param ui32Len length of the field
+//! \param ui32Width minimum width, 0 for none
+//! \param cFill padding character
+//! \param left true to pad on the right instead of the left
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleSinkField(ConsoleSink *sink, const char *pcField, uint32_t ui32Len,
+							 uint32_t ui32Width, char cFill, bool left)
+{
+	uint32_t pad = (ui32Width > ui32Len) ? (ui32Width - ui32Len) : 0;
+
+	while (!left && pad) {
+		ConsoleSinkPut(sink, cFill);
+		pad--;
+	}
+	while (ui32Len--) {
+		ConsoleSinkPut(sink, *pcField++);
+	}
+	while (pad--) {
+		ConsoleSinkPut(sink, ' ');
+	}
+}
+
+//*****************************************************************************
+//
+//! Formats a string into a sink. Supports the conversions used with
+//! UARTprintf(): %c, %d, %i, %u, %x, %X, %p, %s and %%, with an optional '-'
+//! or '0' flag and a field width.
+//!
+//! \param sink the destination
+//! \param pcString the format string
+//! \param vaArgP the arguments
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleFormat(ConsoleSink *sink, const char *pcString, va_list vaArgP)
+{
+	const char *digits;
+	const char *field;
+	char number[12];
+	uint32_t width, value, base, pos;
+	bool left, negative;
+	char fill;
+
+	while (*pcString) {
+		if (*pcString != '%') {
+			ConsoleSinkPut(sink, *pcString++);
+			continue;
+		}
+		pcString++;
+
+		left = false;
+		fill = ' ';
+		width = 0;
+		if (*pcString == '-') {
+			left = true;
+			pcString++;
+		}
+		if (*pcString == '0') {
+			fill = '0';
+			pcString++;
+		}
+		while ((*pcString >= '0') && (*pcString <= '9')) {
+			width = (width * 10) + (*pcString++ - '0');
+		}
+		if (*pcString == 'l') {
+			pcString++;
+		}
+
+		negative = false;
+		value = 0;
+		base = 0;
+		digits = "0123456789abcdef";
+		switch (*pcString) {
+		case 'c':
+			number[0] = (char)va_arg(vaArgP, int);
+			ConsoleSinkField(sink, number, 1, width, ' ', left);
+			break;
+		case 's':
+			field = va_arg(vaArgP, const char *);
+			if (field == NULL) {
+				field = "(null)";
+			}
+			ConsoleSinkField(sink, field, strlen(field), width, ' ', left);
+			break;
+		case 'd': case 'i':
+			value = (uint32_t)va_arg(vaArgP, int32_t);
+			if ((int32_t)value < 0) {
+				negative = true;
+				value = 0 - value;
+			}
+			base = 10;
+			break;
+		case 'u':
+			value = va_arg(vaArgP, uint32_t);
+			base = 10;
+			break;
+		case 'X':
+			digits = "0123456789ABCDEF";
+			value = va_arg(vaArgP, uint32_t);
+			base = 16;
+			break;
+		case 'x': case 'p':
+			value = va_arg(vaArgP, uint32_t);
+			base = 16;
+			break;
+		case '\0':
+			return;
+		default:
+			ConsoleSinkPut(sink, *pcString);
+			break;
+		}
+		pcString++;
+
+		if (base) {
+			pos = sizeof(number);
+			do {
+				number[--pos] = digits[value % base];
+				value /= base;
+			} while (value);
+
+			if (negative) {
+				if ((fill == '0') && !left) {
+					//The sign goes before the zero padding
+					ConsoleSinkPut(sink, '-');
+					width = width ? (width - 1) : 0;
+				}
+				else {
+					number[--pos] = '-';
+				}
+			}
+			ConsoleSinkField(sink, &number[pos], sizeof(number) - pos, width, left ? ' ' : fill, left);
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Formats a message into the transmit ring. With wait the message is
+//! streamed as space becomes free, so long output such as tables arrives in
+//! full. Without wait the message is dropped as a whole, and counted, if it
+//! does not fit, and it is never interleaved with other output.
+//!
+//! \param pcString the format string, as for UARTprintf()
+//! \param vaArgP the arguments
+//! \param wait true to wait for space, only from a task
+//!
+//! \return Returns false if the message was dropped.
+//
+//*****************************************************************************
+bool ConsoleVPrintf(const char *pcString, va_list vaArgP, bool wait)
+{
+	ConsoleSink sink;
+	va_list vaCount;
+	uint32_t ui32Mask;
+
+	sink.count = 0;
+	sink.used = 0;
+
+	if (wait) {
+		sink.mode = ConsoleSinkChunk;
+		ConsoleFormat(&sink, pcString, vaArgP);
+		return ConsoleTxWrite(sink.chunk, sink.used, true);
+	}
+
+	//Measure the message first so that it is stored whole or not at all
+	sink.mode = ConsoleSinkCount;
+	va_copy(vaCount, vaArgP);
+	ConsoleFormat(&sink, pcString, vaCount);
+	va_end(vaCount);
+
+	ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	if ((CONSOLE_TX_BUFFER_SIZE - (ConsoleTxHead - ConsoleTxTail)) < sink.count) {
+		ConsoleTxCounters.dropped_messages++;
+		ConsoleTxCounters.dropped_bytes += sink.count;
+		portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+		return false;
+	}
+	sink.mode = ConsoleSinkRing;
+	ConsoleFormat(&sink, pcString, vaArgP);
+	ConsoleTxHighWater();
+	ConsoleTxStart();
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Prints a message without blocking. The message is dropped, and counted,
+//! if the transmit ring is too full for it.
+//!
+//! \param pcString the format string, as for UARTprintf()
+//!
+//! \return Returns false if the message was dropped.
+//
+//*****************************************************************************
+bool ConsolePrintf(const char *pcString, ...)
+{
+	va_list vaArgP;
+	bool result;
+
+	va_start(vaArgP, pcString);
+	result = ConsoleVPrintf(pcString, vaArgP, false);
+	va_end(vaArgP);
+
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Prints a message, waiting for space in the transmit ring as needed. The
+//! calling task sleeps while the uDMA engine sends, so use this for command
+//! output and tables rather than from tasks doing time critical work.
+//!
+//! \param pcString the format string, as for UARTprintf()
+//!
+//! \return Returns true.
+//
+//*****************************************************************************
+bool ConsolePrintfWait(const char *pcString, ...)
+{
+	va_list vaArgP;
+	bool result;
+
+	va_start(vaArgP, pcString);
+	result = ConsoleVPrintf(pcString, vaArgP, true);
+	va_end(vaArgP);
+
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Prints a message from an interrupt handler. The message is only stored in
+//! the transmit ring and sent afterwards by the uDMA engine; it is dropped,
+//! and counted, if it does not fit.
+//!
+//! \param pcString the format string, as for UARTprintf()
+//!
+//! \return Returns false if the message was dropped.
+//
+//*****************************************************************************
+bool ConsolePrintfFromISR(const char *pcString, ...)
+{
+	va_list vaArgP;
+	bool result;
+
+	va_start(vaArgP, pcString);
+	result = ConsoleVPrintf(pcString, vaArgP, false);
+	va_end(vaArgP);
+
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Empties the transmit ring. The pending characters are either discarded
+//! or written out directly, which also works with interrupts disabled (e.g.
+//! from a fault handler).
+//!
+//! \param discard true to discard the pending characters
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleFlushTx(bool discard)
+{
+	uint32_t ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+	if (ConsoleTxActive) {
+		uDMAChannelDisable(UDMA_CHANNEL_UART1TX);
+		ConsoleTxTail += ConsoleTxLength - uDMAChannelSizeGet(UDMA_CHANNEL_UART1TX | UDMA_PRI_SELECT);
+		ConsoleTxLength = 0;
+		ConsoleTxActive = false;
+	}
+
+	if (discard) {
+		ConsoleTxTail = ConsoleTxHead;
+	}
+	else {
+		while (ConsoleTxTail != ConsoleTxHead) {
+			UARTCharPut(UART1_BASE, ConsoleTxBuffer[ConsoleTxTail++ & (CONSOLE_TX_BUFFER_SIZE - 1)]);
+		}
+		while (UARTBusy(UART1_BASE)) {
+		}
+	}
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+}
+
+//*****************************************************************************
+//
+//! Copies the transmit counters.
+//!
+//! \param stats receives the counters
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleTxStatsGet(ConsoleTxStats *stats)
+{
+	uint32_t ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+	*stats = ConsoleTxCounters;
+	stats->pending = ConsoleTxHead - ConsoleTxTail;
+
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+}
+
+//*****************************************************************************
+//
+//! Echoes characters back to the terminal unless echo is disabled. Called
+//! from the interrupt handler, so characters that do not fit are dropped.
+//!
+//! \param pcBuf characters to echo
+//! \param ui32Len number of characters
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleEchoWrite(const char *pcBuf, uint32_t ui32Len)
+{
+	if (ConsoleEcho && !ConsoleKeys) {
+		ConsoleTxWrite(pcBuf, ui32Len, false);
+	}
+}
+
+//*****************************************************************************
+//
+//! Takes a free line buffer for assembly if none is held yet.
+//!
+//! \return Returns true if a line is being assembled, false if all lines are
+//! waiting for the interpreter.
+//
+//*****************************************************************************
+static bool ConsoleAcquire(void)
+{
+	uint8_t line;
+
+	if (ConsoleAssembly != CONSOLE_NO_LINE) {
+		return true;
+	}
+	for (line = 0; line < CONSOLE_LINE_COUNT; line++) {
+		if (ConsoleLinesFree & (1 << line)) {
+			ConsoleLinesFree &= ~(1 << line);
+			ConsoleAssembly = line;
+			ConsoleLength = 0;
+			return true;
+		}
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+//! Replaces the line being edited with an entry from the history, or with an
+//! empty line when moving past the newest entry. The old text is erased with
+//! backspaces and a VT100 erase-to-end-of-line.
+//!
+//! \param older true to step back in the history, false to step forward
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleRecall(bool older)
+{
+	char *text;
+
+	//Passwords are neither recorded nor recalled
+	if (UsePasswordMask) {
+		return;
+	}
+	if (older) {
+		if (ConsoleHistoryCursor >= ConsoleHistoryCount) {
+			return;
+		}
+		ConsoleHistoryCursor++;
+	}
+	else {
+		if (ConsoleHistoryCursor == 0) {
+			return;
+		}
+		ConsoleHistoryCursor--;
+	}
+	if (!ConsoleAcquire()) {
+		return;
+	}
+
+	text = ConsoleLines[ConsoleAssembly];
+	while (ConsoleLength) {
+		ConsoleEchoWrite("\b", 1);
+		ConsoleLength--;
+	}
+	ConsoleEchoWrite("\033[K", 3);
+
+	if (ConsoleHistoryCursor) {
+		strcpy(text, ConsoleHistory[(ConsoleHistoryNext + CONSOLE_HISTORY_DEPTH - ConsoleHistoryCursor) % CONSOLE_HISTORY_DEPTH]);
+		ConsoleLength = strlen(text);
+		ConsoleEchoWrite(text, ConsoleLength);
+	}
+}
+
+//*****************************************************************************
+//
+//! Terminates the line being assembled, records it in the history and passes
+//! its index to the interpreter queue. An empty line is passed as well so the
+//! prompt is printed again.
+//!
+//! \param pxHigherPriorityTaskWoken set if a task waiting for a line was woken
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleSubmit(portBASE_TYPE *pxHigherPriorityTaskWoken)
+{
+	char *text;
+
+	if (!ConsoleAcquire()) {
+		return;
+	}
+	text = ConsoleLines[ConsoleAssembly];
+	text[ConsoleLength] = 0x00;
+
+	if (ConsoleLength && !UsePasswordMask) {
+		strcpy(ConsoleHistory[ConsoleHistoryNext], text);
+		ConsoleHistoryNext = (ConsoleHistoryNext + 1) % CONSOLE_HISTORY_DEPTH;
+		if (ConsoleHistoryCount < CONSOLE_HISTORY_DEPTH) {
+			ConsoleHistoryCount++;
+		}
+	}
+	ConsoleHistoryCursor = 0;
+
+	//The queue holds one entry per line buffer so it is never full
+	xQueueSendFromISR(g_pINTERPRETERQueue, &ConsoleAssembly, pxHigherPriorityTaskWoken);
+	ConsoleAssembly = CONSOLE_NO_LINE;
+	ConsoleLength = 0;
+}
+
+//*****************************************************************************
+//
+//! Processes one received character. Escape sequences are decoded first so
+//! that the arrow keys are never confused with the enter key.
+//!
+//! \param cChar the received character
+//! \param pxHigherPriorityTaskWoken set if a waiting task was woken
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void ConsoleReceive(char cChar, portBASE_TYPE *pxHigherPriorityTaskWoken)
+{
+	char key = cChar;
+
+	switch (ConsoleState) {
+	case ConsoleEscape:
+		ConsoleState = ((cChar == '[') || (cChar == 'O')) ? ConsoleSequence : ConsoleText;
+		return;
+	case ConsoleSequence:
+		//Parameter bytes are skipped up to the final byte of the sequence
+		if ((cChar < 0x40) || (cChar > 0x7E)) {
+			return;
+		}
+		ConsoleState = ConsoleText;
+		switch (cChar) {
+		case 'A':
+			key = CONSOLE_KEY_UP;
+			break;
+		case 'B':
+			key = CONSOLE_KEY_DOWN;
+			break;
+		case 'C':
+			key = CONSOLE_KEY_RIGHT;
+			break;
+		case 'D':
+			key = CONSOLE_KEY_LEFT;
+			break;
+		default:
+			return;
+		}
+		break;
+	default:
+		if (cChar == 0x1B) {
+			ConsoleState = ConsoleEscape;
+			return;
+		}
+		break;
+	}
+
+	//Terminals may end a line with CR, LF or CR LF
+	if ((key == '\n') && ConsoleLastCR) {
+		ConsoleLastCR = false;
+		return;
+	}
+	ConsoleLastCR = (key == '\r');
+
+	if (ConsoleKeys) {
+		//Key presses are dropped if the menu does not keep up
+		xQueueSendFromISR(ConsoleKeyQueue, &key, pxHigherPriorityTaskWoken);
+		return;
+	}
+
+	switch (key) {
+	case '\r': case '\n':
+		ConsoleSubmit(pxHigherPriorityTaskWoken);
+		break;
+	case '\b': case 0x7F:
+		if ((ConsoleAssembly != CONSOLE_NO_LINE) && ConsoleLength) {
+			ConsoleLength--;
+			ConsoleEchoWrite("\b \b", 3);
+		}
+		break;
+	case CONSOLE_KEY_UP:
+		ConsoleRecall(true);
+		break;
+	case CONSOLE_KEY_DOWN:
+		ConsoleRecall(false);
+		break;
+	default:
+		if ((key < ' ') || (key > '~')) {
+			break;
+		}
+		//Ring the bell if the line is full or no line buffer is free
+		if (!ConsoleAcquire() || (ConsoleLength >= (CONSOLE_LINE_SIZE - 1))) {
+			ConsoleEchoWrite("\a", 1);
+			break;
+		}
+		ConsoleLines[ConsoleAssembly][ConsoleLength++] = key;
+		ConsoleEchoWrite(UsePasswordMask ? "*" : &key, 1);
+		break;
+	}
+}
+
+//*****************************************************************************
+//
+//! UART1 interrupt handler. Received characters are assembled into lines
+//! and completed uDMA transfers of the transmit ring are retired.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleUARTIntHandler(void)
+{
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+	uint32_t ui32Ints = UARTIntStatus(UART1_BASE, true);
+	int32_t i32Char;
+
+	if (ui32Ints & (UART_INT_RX | UART_INT_RT)) {
+		UARTIntClear(UART1_BASE, ui32Ints & (UART_INT_RX | UART_INT_RT));
+
+		while (UARTCharsAvail(UART1_BASE)) {
+			i32Char = UARTCharGetNonBlocking(UART1_BASE);
+			//Lines are discarded until the scheduler's queues exist
+			if ((i32Char >= 0) && (g_pINTERPRETERQueue != NULL)) {
+				ConsoleReceive((char)i32Char, &xHigherPriorityTaskWoken);
+			}
+		}
+	}
+
+	//The uDMA engine signals the end of a transfer on the UART's interrupt
+	uDMAIntClear(1 << UDMA_CHANNEL_UART1TX);
+	if (ConsoleTxComplete()) {
+		xSemaphoreGiveFromISR(ConsoleTxSpace, &xHigherPriorityTaskWoken);
+	}
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+//*****************************************************************************
+//
+//! Waits for the next line. The line is not copied: the caller may tokenize
+//! it in place through ConsoleLineBuffer() and must release it with
+//! ConsoleLineRelease().
+//!
+//! \param line receives the index of the line
+//! \param ticks number of ticks to wait, portMAX_DELAY to wait forever
+//!
+//! \return Returns true if a line was received.
+//
+//*****************************************************************************
+bool ConsoleLineReceive(uint8_t *line, uint32_t ticks)
+{
+	return (xQueueReceive(g_pINTERPRETERQueue, line, ticks) == pdPASS);
+}
+
+//*****************************************************************************
+//
+//! Returns the text of a received line.
+//!
+//! \param line index from ConsoleLineReceive()
+//!
+//! \return Returns the NULL-terminated line.
+//
+//*****************************************************************************
+char *ConsoleLineBuffer(uint8_t line)
+{
+	return ConsoleLines[line];
+}
+
+//*****************************************************************************
+//
+//! Returns a received line to the pool of line buffers.
+//!
+//! \param line index from ConsoleLineReceive()
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleLineRelease(uint8_t line)
+{
+	if (line >= CONSOLE_LINE_COUNT) {
+		return;
+	}
+	taskENTER_CRITICAL();
+	ConsoleLinesFree |= (1 << line);
+	taskEXIT_CRITICAL();
+}
+
+//*****************************************************************************
+//
+//! Waits for the next line and copies it out, for short prompts. Characters
+//! beyond size - 1 are dropped.
+//!
+//! \param buffer receives the NULL-terminated line
+//! \param size size of buffer
+//!
+//! \return Returns the number of characters copied.
+//
+//*****************************************************************************
+uint32_t ConsoleGets(char *buffer, uint32_t size)
+{
+	uint8_t line;
+	uint32_t length;
+
+	ConsoleLineReceive(&line, portMAX_DELAY);
+
+	length = strlen(ConsoleLines[line]);
+	if (length > (size - 1)) {
+		length = size - 1;
+	}
+	memcpy(buffer, ConsoleLines[line], length);
+	buffer[length] = 0x00;
+
+	ConsoleLineRelease(line);
+	return length;
+}
+
+//*****************************************************************************
+//
+//! Enables or disables the echo of typed characters. Input is still
+//! assembled while echo is disabled.
+//!
+//! \param enable true to echo typed characters
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleEchoSet(bool enable)
+{
+	ConsoleEcho = enable;
+}
+
+//*****************************************************************************
+//
+//! Enters or leaves key mode. In key mode every key press, including the
+//! decoded arrow keys, is queued for ConsoleReadKey() without echo instead of
+//! being assembled into a line.
+//!
+//! \param enable true to enter key mode
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleKeyMode(bool enable)
+{
+	//Keys pressed before the menu was shown are not for the menu
+	if (enable && !ConsoleKeys) {
+		xQueueReset(ConsoleKeyQueue);
+	}
+	ConsoleKeys = enable;
+}
+
+//*****************************************************************************
+//
+//! Waits for the next key press in key mode.
+//!
+//! \return Returns the key, or one of the CONSOLE_KEY_ codes for arrow keys.
+//
+//*****************************************************************************
+char ConsoleReadKey(void)
+{
+	char key = 0x00;
+
+	xQueueReceive(ConsoleKeyQueue, &key, portMAX_DELAY);
+	return key;
+}
+
+//*****************************************************************************
+//
+//! Discards the line being typed and every line not yet received.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleFlush(void)
+{
+	uint8_t line;
+
+	while (xQueueReceive(g_pINTERPRETERQueue, &line, 0) == pdPASS) {
+		ConsoleLineRelease(line);
+	}
+	taskENTER_CRITICAL();
+	ConsoleLength = 0;
+	ConsoleState = ConsoleText;
+	ConsoleHistoryCursor = 0;
+	taskEXIT_CRITICAL();
+}
+
+//*****************************************************************************
+//
+//! Interrupt-safe version of ConsoleFlush(), used when a new console session
+//! is opened.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void ConsoleFlushFromISR(void)
+{
+	uint8_t line;
+
+	if (g_pINTERPRETERQueue == NULL) {
+		return;
+	}
+	while (xQueueReceiveFromISR(g_pINTERPRETERQueue, &line, NULL) == pdPASS) {
+		if (line < CONSOLE_LINE_COUNT) {
+			ConsoleLinesFree |= (1 << line);
+		}
+	}
+	ConsoleLength = 0;
+	ConsoleState = ConsoleText;
+	ConsoleHistoryCursor = 0;
+}
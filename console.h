@@ -0,0 +1,137 @@
+/**\file console.h
+ * \brief <b>Interrupt-Driven Console Input and uDMA Output</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+//*****************************************************************************
+//
+//! Console baud rate. UART1 runs from the 16MHz PIOSC, so rates up to
+//! 1000000 are possible as long as the UART-to-USB converter follows.
+//
+//*****************************************************************************
+#define CONSOLE_BAUD_RATE			115200
+
+//*****************************************************************************
+//
+//! Number and size of the line buffers shared by the UART interrupt and the
+//! interpreter task. A line holds at most CONSOLE_LINE_SIZE - 1 characters.
+//
+//*****************************************************************************
+#define CONSOLE_LINE_COUNT			4
+#define CONSOLE_LINE_SIZE			128
+
+//*****************************************************************************
+//
+//! Number of previous lines recalled with the up and down arrow keys.
+//
+//*****************************************************************************
+#define CONSOLE_HISTORY_DEPTH		4
+
+//*****************************************************************************
+//
+//! Size of the transmit ring drained by the uDMA engine. Must be a power of
+//! two. A single uDMA transfer moves at most CONSOLE_TX_DMA_MAX characters.
+//
+//*****************************************************************************
+#define CONSOLE_TX_BUFFER_SIZE		2048
+#define CONSOLE_TX_DMA_MAX			1024
+
+//*****************************************************************************
+//
+//! Characters formatted on the stack before they are copied into the ring
+//! by ConsolePrintfWait(), and the longest a waiting task sleeps before it
+//! checks for space again.
+//
+//*****************************************************************************
+#define CONSOLE_TX_CHUNK_SIZE		32
+#define CONSOLE_TX_WAIT_MS			10
+
+//*****************************************************************************
+//
+//! Priority of the UART interrupt. Must not be above
+//! configMAX_SYSCALL_INTERRUPT_PRIORITY as the handler uses the FreeRTOS API.
+//
+//*****************************************************************************
+#define CONSOLE_INT_PRIORITY		0xC0
+
+//*****************************************************************************
+//
+//! Returned by ConsoleReadKey() for the arrow keys, whose VT100 escape
+//! sequences are decoded by the interrupt handler.
+//
+//*****************************************************************************
+#define CONSOLE_KEY_UP				((char)0x80)
+#define CONSOLE_KEY_DOWN			((char)0x81)
+#define CONSOLE_KEY_RIGHT			((char)0x82)
+#define CONSOLE_KEY_LEFT			((char)0x83)
+
+//*****************************************************************************
+//
+//! Marks that no line buffer is in use.
+//
+//*****************************************************************************
+#define CONSOLE_NO_LINE				0xFF
+
+//*****************************************************************************
+//
+//! Transmit counters, see ConsoleTxStatsGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Messages, and their characters, dropped because the ring was full
+	uint32_t dropped_messages;
+	uint32_t dropped_bytes;
+	//! Times ConsolePrintfWait() had to wait for space
+	uint32_t waits;
+	//! Most characters held by the ring
+	uint32_t high_water;
+	//! Characters not yet sent
+	uint32_t pending;
+} ConsoleTxStats;
+
+extern void ConsoleInit(uint32_t ui32SrcClock);
+extern void ConsoleDMAInit(void);
+extern void ConsoleUARTIntHandler(void);
+extern bool ConsoleLineReceive(uint8_t *line, uint32_t ticks);
+extern char *ConsoleLineBuffer(uint8_t line);
+extern void ConsoleLineRelease(uint8_t line);
+extern uint32_t ConsoleGets(char *buffer, uint32_t size);
+extern void ConsoleEchoSet(bool enable);
+extern void ConsoleKeyMode(bool enable);
+extern char ConsoleReadKey(void);
+extern void ConsoleFlush(void);
+extern void ConsoleFlushFromISR(void);
+extern bool ConsoleVPrintf(const char *pcString, va_list vaArgP, bool wait);
+extern bool ConsolePrintf(const char *pcString, ...);
+extern bool ConsolePrintfWait(const char *pcString, ...);
+extern bool ConsolePrintfFromISR(const char *pcString, ...);
+extern void ConsoleFlushTx(bool discard);
+extern void ConsoleTxStatsGet(ConsoleTxStats *stats);
+
+#endif /* CONSOLE_H_ */
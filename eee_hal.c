@@ -27,78 +27,535 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "eee_hal.h"
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_ssi.h"
 #include "gpio.h"
+#include "interrupt.h"
 #include "pin_map.h"
 #include "rom.h"
 #include "ssi.h"
 #include "sysctl.h"
+#include "timer.h"
 #include "uart.h"
+#include "udma.h"
 #include "uartstdio.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
 #include "task.h"
 #include "event_logger.h"
+#include "perf_stats.h"
+#include "spi_arbiter.h"
 
 
 //*****************************************************************************
 //
-//! FreeRTOS FIFO Queue. Allows read/write events to be logged to the EEPROM.
-//! The only items that should be passed to this queue are of the LoggerCodes
-//! enumeration found in event_logger.h.
+//! Staging buffer for EEPROM transactions. Holds the command/address header
+//! followed by up to one page of data so that a page write is handed to the
+//! uDMA engine as a single transfer. Only used while SPI0 is owned (see
+//! SPIBusAcquire()).
 //
 //*****************************************************************************
-extern xQueueHandle g_pLoggerQueue;
+static uint8_t EEPROMTransferBuffer[EEPROM_PAGE_SIZE + 4];
 //*****************************************************************************
 //
-//! FreeRTOS mutex that forces concurrently running tasks to request access
-//! to the EEPROM's SPI port before sending/reading information. This prevents
-//! any two or more tasks from interfering with an ongoing transaction.
+//! Staging buffer for Ethernet Controller bursts. Holds the command/address
+//! header followed by every register in the device. Only used while SPI1 is
+//! owned (see SPIBusAcquire()).
 //
 //*****************************************************************************
-extern xSemaphoreHandle g_pSPI0Semaphore;
+static uint8_t EthoTransferBuffer[256 + 2];
+
+
+//************TIMING SERVICE*************************************************************
+//
+// Two general purpose timers back every delay in the firmware. DELAY_TIMEBASE runs
+// free as a 32-bit down counter at the system clock and is used for short, exact
+// waits such as CS setup/hold times. Polling a counter is reentrant, so any task or
+// interrupt may use it at the same time. DELAY_ONESHOT is armed for longer sub-tick
+// waits so that the calling task sleeps on a semaphore until the timer expires.
+// Anything at or above one millisecond is handed straight to vTaskDelay.
+//
+//***************************************************************************************
+
 //*****************************************************************************
 //
-//! FreeRTOS mutex that forces concurrently running tasks to request access
-//! to the Ethernet Controller's SPI port before sending/reading information.
-//! This prevents any two or more tasks from interfering with an ongoing
-//! transaction.
+//! Number of timebase counts in one microsecond. Zero until DelayTimerInit()
+//! has been called, in which case the delays fall back to SysCtlDelay.
 //
 //*****************************************************************************
-extern xSemaphoreHandle g_pSPI1Semaphore;
+static uint32_t DelayTicksPerUs = 0;
+//*****************************************************************************
+//
+//! Only one task may own the one-shot timer at a time. Tasks that find it in
+//! use simply fall back to polling the timebase.
+//
+//*****************************************************************************
+static xSemaphoreHandle g_pDelayTimerSemaphore = NULL;
+//*****************************************************************************
+//
+//! Given by DelayTimerIntHandler() when the one-shot timer expires.
+//
+//*****************************************************************************
+static xSemaphoreHandle g_pDelayTimerComplete = NULL;
 
+//*****************************************************************************
+//
+//! Returns true if the caller is a task that may block, i.e. the scheduler is
+//! running and we are not inside an interrupt handler.
+//
+//*****************************************************************************
+static bool DelayCanBlock(void)
+{
+	if ((HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M) != 0) {
+		return false;
+	}
+	return (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+}
 
 //*****************************************************************************
 //
-//! Pauses execution of the microcontroller for the time specified in ui32Ms in
-//! milliseconds by converting ui32Ms to MCU ticks. This function blocks all
-//! other running tasks for the time specified. [USE SPARINGLY].
+//! Busy-waits on the free running timebase for the given number of
+//! microseconds. Waits must be shorter than 2^32 timebase counts (~85s).
+//
+//*****************************************************************************
+static void DelayPoll(uint32_t ui32Us)
+{
+	uint32_t start = TimerValueGet(DELAY_TIMEBASE_BASE, TIMER_A);
+	uint32_t ticks = ui32Us * DelayTicksPerUs;
+
+	//The timebase counts down, unsigned subtraction handles the wrap
+	while ((start - TimerValueGet(DELAY_TIMEBASE_BASE, TIMER_A)) < ticks);
+}
+
+//*****************************************************************************
+//
+//! Starts the timebase and prepares the one-shot timer used by delayMs() and
+//! delayUs(). Must be called after the system clock has been set.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void DelayTimerInit(void)
+{
+	ROM_SysCtlPeripheralEnable(DELAY_TIMEBASE_SYS_BASE);
+	ROM_SysCtlPeripheralEnable(DELAY_ONESHOT_SYS_BASE);
+
+	//Free running 32-bit timebase
+	TimerConfigure(DELAY_TIMEBASE_BASE, TIMER_CFG_PERIODIC);
+	TimerLoadSet(DELAY_TIMEBASE_BASE, TIMER_A, 0xFFFFFFFF);
+	TimerEnable(DELAY_TIMEBASE_BASE, TIMER_A);
+
+	//One-shot timer that wakes a sleeping task
+	TimerConfigure(DELAY_ONESHOT_BASE, TIMER_CFG_ONE_SHOT);
+	TimerIntEnable(DELAY_ONESHOT_BASE, TIMER_TIMA_TIMEOUT);
+
+	g_pDelayTimerSemaphore = xSemaphoreCreateMutex();
+	g_pDelayTimerComplete = xSemaphoreCreateBinary();
+
+	//Interrupts that call FreeRTOS API functions must not be above configMAX_SYSCALL_INTERRUPT_PRIORITY
+	IntPrioritySet(DELAY_ONESHOT_INT, DELAY_INT_PRIORITY);
+	IntEnable(DELAY_ONESHOT_INT);
+
+	DelayTicksPerUs = SysCtlClockGet() / 1000000;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of microseconds since DelayTimerInit() was called, or 0
+//! if it has not been called yet. Wraps after 2^32 timebase counts (~85s).
+//!
+//! \return Returns the elapsed time in microseconds
+//
+//*****************************************************************************
+uint32_t DelayTimebaseUs(void)
+{
+	if (DelayTicksPerUs == 0) {
+		return 0;
+	}
+	//The timebase counts down from its load value
+	return ((0xFFFFFFFF - TimerValueGet(DELAY_TIMEBASE_BASE, TIMER_A)) / DelayTicksPerUs);
+}
+
+//*****************************************************************************
+//
+//! Interrupt handler for the one-shot delay timer. Wakes the task waiting in
+//! delayUs().
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void DelayTimerIntHandler(void)
+{
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+	TimerIntClear(DELAY_ONESHOT_BASE, TIMER_TIMA_TIMEOUT);
+	xSemaphoreGiveFromISR(g_pDelayTimerComplete, &xHigherPriorityTaskWoken);
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+//*****************************************************************************
+//
+//! Pauses the calling task for the time specified in ui32Ms in milliseconds.
+//! Once the scheduler is running, tasks are put to sleep with vTaskDelay so
+//! that other tasks may run in the meantime. Before the scheduler starts, or
+//! when called from an interrupt handler, the timebase is polled instead.
 //!
 //! \param ui32Ms the number of milliseconds to pause the MCU
 //
 //*****************************************************************************
 void delayMs(uint32_t ui32Ms) {
 
-	// 1 clock cycle = 1 / SysCtlClockGet() second
-	// 1 SysCtlDelay = 3 clock cycle = 3 / SysCtlClockGet() second
-	// 1 second = SysCtlClockGet() / 3
-	// 0.001 second = 1 ms = SysCtlClockGet() / 3 / 1000
+	if (DelayTicksPerUs == 0) {
+		// 1 SysCtlDelay = 3 clock cycle = 3 / SysCtlClockGet() second
+		// 0.001 second = 1 ms = SysCtlClockGet() / 3 / 1000
+		ROM_SysCtlDelay(ui32Ms * (SysCtlClockGet() / 3 / 1000));
+		return;
+	}
+
+	if (DelayCanBlock()) {
+		//Round up and add a tick since the current tick period is already partly spent
+		vTaskDelay(((ui32Ms + portTICK_RATE_MS - 1) / portTICK_RATE_MS) + 1);
+		return;
+	}
 
-	ROM_SysCtlDelay(ui32Ms * (SysCtlClockGet() / 3 / 1000));
+	//Poll one millisecond at a time so that long waits cannot overflow the timebase
+	while (ui32Ms--) {
+		DelayPoll(1000);
+	}
 }
 //*****************************************************************************
 //
-//! Pauses execution of the microcontroller for the time specified in ui32Us in
-//! microseconds by converting ui32Us to MCU ticks. This function blocks all
-//! other running tasks for the time specified. [USE SPARINGLY].
+//! Pauses the calling task for the time specified in ui32Us in microseconds.
+//! Waits shorter than DELAY_BLOCK_MIN_US (CS setup/hold times and the like)
+//! poll the timebase since a context switch would take longer than the wait
+//! itself. Longer waits arm the one-shot timer and sleep until it expires, and
+//! waits of a millisecond or more are handed to delayMs().
 //!
 //! \param ui32Us the number of microseconds to pause the MCU
 //
 //*****************************************************************************
 void delayUs(uint32_t ui32Us) {
-	ROM_SysCtlDelay(ui32Us * (SysCtlClockGet() / 3 / 1000000));
+
+	if (DelayTicksPerUs == 0) {
+		ROM_SysCtlDelay(ui32Us * (SysCtlClockGet() / 3 / 1000000));
+		return;
+	}
+
+	if (ui32Us >= 1000 && (ui32Us % 1000) == 0) {
+		delayMs(ui32Us / 1000);
+		return;
+	}
+
+	if (ui32Us >= DELAY_BLOCK_MIN_US && DelayCanBlock()
+			&& xSemaphoreTake(g_pDelayTimerSemaphore, 0) == pdTRUE) {
+		//Drop a completion left over from an earlier wait that timed out
+		xSemaphoreTake(g_pDelayTimerComplete, 0);
+		TimerLoadSet(DELAY_ONESHOT_BASE, TIMER_A, ui32Us * DelayTicksPerUs);
+		TimerEnable(DELAY_ONESHOT_BASE, TIMER_A);
+		xSemaphoreTake(g_pDelayTimerComplete, (ui32Us / 1000 / portTICK_RATE_MS) + 2);
+		TimerDisable(DELAY_ONESHOT_BASE, TIMER_A);
+		xSemaphoreGive(g_pDelayTimerSemaphore);
+		return;
+	}
+
+	DelayPoll(ui32Us);
+}
+
+//************uDMA SSI TRANSACTION ENGINE************************************************
+//
+// Every transaction on SSI0 (EEPROM) and SSI1 (Ethernet Controller) is moved by a
+// pair of uDMA channels: the TX channel feeds the SSI FIFO while the RX channel drains
+// it. The calling task blocks on the port's completion semaphore, which is given by
+// the SSI interrupt as soon as the RX channel stops. Chip select handling remains with
+// the EEPROM and Ethernet Controller functions further down in this file.
+//
+//***************************************************************************************
+
+//*****************************************************************************
+//
+//! Book-keeping for one SSI port serviced by the uDMA engine.
+//
+//*****************************************************************************
+typedef struct SSIDMAChannels {
+	//! Base address of the SSI port
+	uint32_t ssi_base;
+	//! uDMA channel that drains the SSI receive FIFO
+	uint32_t rx_channel;
+	//! uDMA channel that feeds the SSI transmit FIFO
+	uint32_t tx_channel;
+	//! NVIC interrupt number for the SSI port
+	uint32_t interrupt;
+	//! Given by the SSI interrupt once the RX channel has stopped
+	xSemaphoreHandle complete;
+	//! Set while a DMA transfer is in flight on this port
+	volatile bool active;
+} SSI_DMA_Channel;
+
+//*****************************************************************************
+//
+//! uDMA channel control table. The controller requires this table to be
+//! aligned on a 1024-byte boundary.
+//
+//*****************************************************************************
+#pragma DATA_ALIGN(SSIDMAControlTable, 1024)
+static tDMAControlTable SSIDMAControlTable[64];
+
+//*****************************************************************************
+//
+//! uDMA channels assigned to SSI0 and SSI1
+//
+//*****************************************************************************
+static SSI_DMA_Channel SSIDMAPorts[2] = {
+	{SSI0_BASE, UDMA_CHANNEL_SSI0RX, UDMA_CHANNEL_SSI0TX, INT_SSI0, NULL, false},
+	{SSI1_BASE, UDMA_CHANNEL_SSI1RX, UDMA_CHANNEL_SSI1TX, INT_SSI1, NULL, false}
+};
+
+//*****************************************************************************
+//
+//! Clocked out by the TX channel when the caller only wants to receive, and
+//! written to by the RX channel when the caller only wants to transmit.
+//
+//*****************************************************************************
+static uint8_t SSIDMADummy = 0x00;
+static uint8_t SSIDMASink;
+
+//*****************************************************************************
+//
+//! Returns the uDMA book-keeping for the given SSI port or NULL if the port
+//! is not serviced by the engine.
+//
+//*****************************************************************************
+static SSI_DMA_Channel *SSIDMAGetChannel(uint32_t SSI_BASE)
+{
+	if (SSI_BASE == SSI0_BASE) {
+		return &SSIDMAPorts[0];
+	}
+	else if (SSI_BASE == SSI1_BASE) {
+		return &SSIDMAPorts[1];
+	}
+	return NULL;
+}
+
+//*****************************************************************************
+//
+//! Enables the uDMA controller, assigns channels 10/11 to SSI0 and 24/25 to
+//! SSI1 and enables both SSI interrupts. Must be called after ConfigureSSI()
+//! and before any EEPROM or Ethernet Controller access.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SSIDMAInit(void)
+{
+	int i = 0;
+
+	ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+	uDMAEnable();
+	uDMAControlBaseSet(SSIDMAControlTable);
+
+	uDMAChannelAssign(UDMA_CH10_SSI0RX);
+	uDMAChannelAssign(UDMA_CH11_SSI0TX);
+	uDMAChannelAssign(UDMA_CH24_SSI1RX);
+	uDMAChannelAssign(UDMA_CH25_SSI1TX);
+
+	for (i = 0; i < 2; i++) {
+		uDMAChannelAttributeDisable(SSIDMAPorts[i].rx_channel, UDMA_ATTR_ALL);
+		uDMAChannelAttributeDisable(SSIDMAPorts[i].tx_channel, UDMA_ATTR_ALL);
+		//The RX channel must never fall behind or the receive FIFO will overrun
+		uDMAChannelAttributeEnable(SSIDMAPorts[i].rx_channel, UDMA_ATTR_HIGH_PRIORITY);
+
+		SSIDMAPorts[i].complete = xSemaphoreCreateBinary();
+		SSIDMAPorts[i].active = false;
+
+		//Interrupts that call FreeRTOS API functions must not be above configMAX_SYSCALL_INTERRUPT_PRIORITY
+		IntPrioritySet(SSIDMAPorts[i].interrupt, SSI_DMA_INT_PRIORITY);
+		IntEnable(SSIDMAPorts[i].interrupt);
+	}
+}
+
+//*****************************************************************************
+//
+//! Clocks a transfer through the SSI FIFO using the CPU. Used for transfers
+//! that are too short to be worth arming the uDMA channels for.
+//
+//*****************************************************************************
+static void SSIFIFOTransfer(uint32_t SSI_BASE, uint8_t *tx, uint8_t *rx, uint32_t length)
+{
+	uint32_t READ_DATA;
+	uint32_t pos;
+
+	for (pos = 0; pos < length; pos++) {
+		SSIDataPut(SSI_BASE, (tx != NULL) ? tx[pos] : 0x00);
+		SSIDataGet(SSI_BASE, &READ_DATA);
+		if (rx != NULL) {
+			rx[pos] = (uint8_t)READ_DATA;
+		}
+	}
+	//Wait for the SSI Port to finish all communication
+	while(SSIBusy(SSI_BASE));
+}
+
+//*****************************************************************************
+//
+//! Arms the RX and TX channels of a port for a single uDMA transfer of up to
+//! SSI_DMA_MAX_LENGTH bytes and waits for it to finish. Once the scheduler is
+//! running the calling task blocks on the completion semaphore. Before that,
+//! interrupts are masked by the kernel so the RX channel is polled instead.
+//
+//*****************************************************************************
+static bool SSIDMARun(SSI_DMA_Channel *channel, uint8_t *tx, uint8_t *rx, uint32_t length)
+{
+	uint32_t polls = 0;
+	bool result = true;
+	void *data_register = (void *)(uintptr_t)(channel->ssi_base + SSI_O_DR);
+
+	channel->active = true;
+
+	uDMAChannelControlSet(channel->rx_channel | UDMA_PRI_SELECT,
+			UDMA_SIZE_8 | UDMA_SRC_INC_NONE | ((rx != NULL) ? UDMA_DST_INC_8 : UDMA_DST_INC_NONE) | UDMA_ARB_4);
+	uDMAChannelTransferSet(channel->rx_channel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+			data_register, (rx != NULL) ? rx : &SSIDMASink, length);
+
+	uDMAChannelControlSet(channel->tx_channel | UDMA_PRI_SELECT,
+			UDMA_SIZE_8 | ((tx != NULL) ? UDMA_SRC_INC_8 : UDMA_SRC_INC_NONE) | UDMA_DST_INC_NONE | UDMA_ARB_4);
+	uDMAChannelTransferSet(channel->tx_channel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+			(tx != NULL) ? tx : &SSIDMADummy, data_register, length);
+
+	uDMAChannelEnable(channel->rx_channel);
+	uDMAChannelEnable(channel->tx_channel);
+	//Raising the DMA request lines starts the transfer
+	SSIDMAEnable(channel->ssi_base, SSI_DMA_RX | SSI_DMA_TX);
+
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		result = (xSemaphoreTake(channel->complete, SSI_DMA_TIMEOUT_MS / portTICK_RATE_MS) == pdTRUE);
+	}
+	else {
+		while (uDMAChannelIsEnabled(channel->rx_channel)) {
+			if (++polls > (SSI_DMA_TIMEOUT_MS * 1000)) {
+				result = false;
+				break;
+			}
+			delayUs(1);
+		}
+	}
+
+	if (channel->active) {
+		//Either the transfer was polled or it timed out, tidy up in place of the interrupt
+		uDMAChannelDisable(channel->tx_channel);
+		uDMAChannelDisable(channel->rx_channel);
+		SSIDMADisable(channel->ssi_base, SSI_DMA_RX | SSI_DMA_TX);
+		uDMAIntClear((1 << channel->rx_channel) | (1 << channel->tx_channel));
+		channel->active = false;
+		//Drop any completion given while we were not waiting on it
+		xSemaphoreTake(channel->complete, 0);
+	}
+
+	while(SSIBusy(channel->ssi_base));
+
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Moves a block of data through an SSI port. Every byte in tx is clocked out
+//! while the byte shifted in at the same time is stored in rx.
+//!
+//! \param SSI_BASE the base address of the SSI port (SSI0 or SSI1)
+//! \param tx pointer-to-array of bytes to send. Pass NULL to clock out zeros.
+//! \param rx pointer-to-array that receives the bytes read back. Pass NULL to discard them.
+//! \param length number of bytes to move
+//!
+//! Transfers of at least SSI_DMA_MIN_LENGTH bytes are handed to the uDMA
+//! engine, split into SSI_DMA_MAX_LENGTH pieces where required. Shorter
+//! transfers are clocked through the FIFO directly. The SSI port is idle
+//! when this function returns, so the caller may release CS straight away.
+//!
+//! \note The caller must already own the SPI port (see SPIBusAcquire()) and
+//! drive CS itself.
+//!
+//! \return Returns the result of the operation (0 = Timed Out, 1 = Succeeded)
+//
+//*****************************************************************************
+bool SSITransfer(uint32_t SSI_BASE, uint8_t *tx, uint8_t *rx, uint32_t length)
+{
+	SSI_DMA_Channel *channel = SSIDMAGetChannel(SSI_BASE);
+	uint32_t READ_DATA;
+	uint32_t pos = 0, chunk = 0;
+
+	PERF_BUS(SSI_BASE, length);
+	if (channel == NULL || channel->complete == NULL || length < SSI_DMA_MIN_LENGTH) {
+		SSIFIFOTransfer(SSI_BASE, tx, rx, length);
+		return true;
+	}
+
+	//Discard anything left in the receive FIFO so the RX channel only sees this transfer
+	while(SSIDataGetNonBlocking(SSI_BASE, &READ_DATA));
+
+	while (pos < length) {
+		chunk = length - pos;
+		if (chunk > SSI_DMA_MAX_LENGTH) {
+			chunk = SSI_DMA_MAX_LENGTH;
+		}
+		if (!SSIDMARun(channel, (tx != NULL) ? &tx[pos] : NULL, (rx != NULL) ? &rx[pos] : NULL, chunk)) {
+			return false;
+		}
+		pos += chunk;
+	}
+
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Services an SSI interrupt raised by the uDMA controller. The TX channel
+//! always finishes first, so the waiting task is only released once the RX
+//! channel has stopped.
+//
+//*****************************************************************************
+static void SSIDMAIntHandler(SSI_DMA_Channel *channel)
+{
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+	uDMAIntClear((1 << channel->rx_channel) | (1 << channel->tx_channel));
+
+	if (channel->active && !uDMAChannelIsEnabled(channel->rx_channel)) {
+		SSIDMADisable(channel->ssi_base, SSI_DMA_RX | SSI_DMA_TX);
+		channel->active = false;
+		xSemaphoreGiveFromISR(channel->complete, &xHigherPriorityTaskWoken);
+	}
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+//*****************************************************************************
+//
+//! Interrupt handler for SSI0 (EEPROM). Signals uDMA transfer completion.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SSI0IntHandler(void)
+{
+	SSIDMAIntHandler(&SSIDMAPorts[0]);
+}
+
+//*****************************************************************************
+//
+//! Interrupt handler for SSI1 (Ethernet Controller). Signals uDMA transfer
+//! completion.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SSI1IntHandler(void)
+{
+	SSIDMAIntHandler(&SSIDMAPorts[1]);
 }
 
 //************EEPROM READ/WRITE FUNCTIONS FOR MICREL 25AA1024****************************
@@ -112,6 +569,44 @@ void delayUs(uint32_t ui32Us) {
 //***************************************************************************************
 
 
+//*****************************************************************************
+//
+//! Polls the status register of the 25AA1024 until the Write-In-Process (WIP)
+//! bit clears, indicating that the internal write/erase cycle has finished.
+//! Polling is abandoned after EEPROM_WIP_POLL_LIMIT attempts spaced
+//! EEPROM_WIP_POLL_INTERVAL_US microseconds apart.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//!
+//! \note The caller must already own the SPI0 port.
+//!
+//! \return Returns the result of the operation (0 = Timed Out, 1 = Write Cycle Complete)
+//
+//*****************************************************************************
+static bool EEPROMWaitForWriteCycle(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN)
+{
+    uint8_t READ_STATUS[2]			= {0x05, 0x00};
+    uint8_t READ_DATA[2];
+    uint32_t ACTIVE_LOW 			= 0x0;
+    uint32_t polls;
+
+    for (polls = 0; polls < EEPROM_WIP_POLL_LIMIT; polls++) {
+        GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
+        delayUs(1);
+        SSITransfer(SSI_BASE, READ_STATUS, READ_DATA, 2);
+        GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+
+        //Bit 0 of the status register is the WIP bit
+        if ((READ_DATA[1] & 0x01) == 0x00) {
+        	return true;
+        }
+        delayUs(EEPROM_WIP_POLL_INTERVAL_US);
+    }
+    return false;
+}
+
 //*****************************************************************************
 //
 //! Writes a single 8 bit value to a register within the EEPROM at the specified
@@ -138,82 +633,121 @@ void delayUs(uint32_t ui32Us) {
 //*****************************************************************************
 bool EEPROMSingleWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address, uint8_t data)
 {
-    uint32_t WRITE_ENABLE 	= 0x00000006;
-    uint32_t WRITE_COMMAND 	= 0x00000002;
-    uint32_t READ_COMMAND 	= 0x00000003;
+	//A single sector is simply a one byte page write
+	return EEPROMPageWrite(SSI_BASE, CS_PORT_BASE, CS_PIN, address, &data, 1);
+}
+
+//*****************************************************************************
+//
+//! Writes up to one page (256 bytes) of 8-bit values to the EEPROM using a
+//! single WRITE instruction.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param address the 17-bit starting address in EEPROM to write to
+//! \param data pointer-to-array of 8-bit values to write sequentially
+//! \param length number of values to write. Must be non-zero and must not run
+//! past the end of the page that holds "address".
+//!
+//! The write enable latch is set once, all bytes are clocked out behind a single
+//! command/address header and the write cycle is completed by polling the WIP
+//! bit rather than waiting a fixed period. The page is then read back in one
+//! sequential read and compared against the data provided.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool EEPROMPageWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address, uint8_t *data, uint32_t length)
+{
+    uint8_t WRITE_ENABLE 	= 0x06;
+    uint8_t READ_COMMAND[4]	= {0x03, ((address >> 16) & 0xFF), ((address >> 8) & 0xFF), (address & 0xFF)};
     uint32_t ACTIVE_LOW 	= 0x00000000;
-    uint32_t READ_DATA;
+    uint32_t pos;
+    bool verified = true;
+    PERF_BEGIN();
 
 	LogItemEEPROM(EEPROMWriteOP);
 
-	xSemaphoreTake(g_pSPI0Semaphore,0);
-    //Invert data to write, zeros in EEPROM indicate set bits
-    data = ~data;
+	if (length == 0 || (address + length) > EEPROM_SIZE || ((address % EEPROM_PAGE_SIZE) + length) > EEPROM_PAGE_SIZE) {
+		//Transfer would wrap around inside the page or run past addressable memory
+		LogItemEEPROM(EEPROMIOException);
+		PERF_END(PerfEEPROMWrite);
+		return false;
+	}
+
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		LogItemEEPROM(EEPROMIOException);
+		PERF_END(PerfEEPROMWrite);
+		return false;
+	}
 
     //Set Write Enable Latch
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
     delayUs(3);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
     delayUs(1);
-    SSIDataPut(SSI_BASE, WRITE_ENABLE);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    //Wait for the SSI Port to finish all communication before bringing CS high
-    while(SSIBusy(SSI_BASE));
+    SSITransfer(SSI_BASE, &WRITE_ENABLE, NULL, 1);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
     delayUs(1);
 
-
-    //Write data to the appropriate register in the EEPROM
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
-    delayUs(1);
-    SSIDataPut(SSI_BASE, WRITE_COMMAND);
-    SSIDataGet(SSI_BASE, &READ_DATA);
+    //Stage the WRITE command, 24-bit address and page data as one transfer
+    EEPROMTransferBuffer[0] = 0x02;
     //Shift data by 16 bits and mask everything but the last octet
-    SSIDataPut(SSI_BASE, ((address >> 16) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
+    EEPROMTransferBuffer[1] = ((address >> 16) & 0xFF);
     //Shift data by 8 bits and mask everything but the last octet
-    SSIDataPut(SSI_BASE, ((address >> 8) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
+    EEPROMTransferBuffer[2] = ((address >> 8) & 0xFF);
     //Mask everything but the last octet
-    SSIDataPut(SSI_BASE, ((address) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    //Send our 8-bit data out the SSITX Pin
-    SSIDataPut(SSI_BASE, data);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    //Wait for the SSI Port to finish all communication before bringing CS high
-    while(SSIBusy(SSI_BASE));
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-    //25AA1024 requires a finite amount of time to peform an automated erase of the sector
-    delayMs(8);
+    EEPROMTransferBuffer[3] = (address & 0xFF);
+    //Each 8-bit value is stored inverted, zeros in EEPROM indicate set bits
+    for (pos = 0; pos < length; pos++) {
+    	EEPROMTransferBuffer[4 + pos] = (uint8_t)~data[pos];
+    }
+
+    //Write data to the appropriate registers in the EEPROM
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
-    delayUs(3);
-    //Read our data back from the same address and verify it matches
-    SSIDataPut(SSI_BASE, READ_COMMAND);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, ((address >> 16) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, ((address >> 8) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, ((address) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, 0x00000000);
-    //Wait for the SSI Port to finish all communication before bringing CS high
-    while(SSIBusy(SSI_BASE));
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-    SSIDataGet(SSI_BASE, &READ_DATA);
+    delayUs(1);
+    if (!SSITransfer(SSI_BASE, EEPROMTransferBuffer, NULL, length + 4)) {
+    	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+    	SPIBusRelease(SSI_BASE);
 
-    if (data == READ_DATA)
-    {
-    	xSemaphoreGive(g_pSPI0Semaphore);
-    	return true;
+    	LogItemEEPROM(EEPROMIOException);
+
+    	PERF_END(PerfEEPROMWrite);
+    	return false;
     }
-    else {
-    	xSemaphoreGive(g_pSPI0Semaphore);
+    //Bringing CS high starts the internal write cycle for the whole page
+    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+
+    if (!EEPROMWaitForWriteCycle(SSI_BASE, CS_PORT_BASE, CS_PIN)) {
+    	SPIBusRelease(SSI_BASE);
 
     	LogItemEEPROM(EEPROMIOException);
 
+    	PERF_END(PerfEEPROMWrite);
     	return false;
     }
+
+    GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
+    delayUs(3);
+    //Read our data back from the same addresses and verify it matches
+    SSITransfer(SSI_BASE, READ_COMMAND, NULL, 4);
+    verified = SSITransfer(SSI_BASE, NULL, &EEPROMTransferBuffer[4], length);
+    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+    for (pos = 0; pos < length; pos++) {
+    	if (EEPROMTransferBuffer[4 + pos] != (uint8_t)~data[pos]) {
+    		verified = false;
+    	}
+    }
+
+	SPIBusRelease(SSI_BASE);
+
+    if (!verified)
+    {
+    	LogItemEEPROM(EEPROMIOException);
+    }
+    PERF_END(PerfEEPROMWrite);
+    return verified;
 }
 
 //*****************************************************************************
@@ -230,39 +764,38 @@ bool EEPROMSingleWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN
 //*****************************************************************************
 bool EEPROMChipErase(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN)
 {
-    uint32_t WRITE_ENABLE 			= 0x00000006;
+    uint8_t WRITE_ENABLE 			= 0x06;
 
-    uint32_t ERASE_COMMAND 			= 0x000000C7;
+    uint8_t ERASE_COMMAND 			= 0xC7;
     uint32_t ACTIVE_LOW 			= 0x00000000;
-    uint32_t READ_DATA;
-    //Set Write Enable Latch
+    PERF_BEGIN();
 
-	xSemaphoreTake(g_pSPI0Semaphore,0);
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		PERF_END(PerfEEPROMErase);
+		return false;
+	}
 
+    //Set Write Enable Latch
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
     delayUs(3);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
     delayUs(1);
-    SSIDataPut(SSI_BASE, WRITE_ENABLE);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    //Wait for the SSI Port to finish all communication before bringing CS high
-    while(SSIBusy(SSI_BASE));
+    SSITransfer(SSI_BASE, &WRITE_ENABLE, NULL, 1);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
     delayUs(1);
 
     //Write chip erase command to the EEPROM
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
     delayUs(1);
-    SSIDataPut(SSI_BASE, ERASE_COMMAND);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    while(SSIBusy(SSI_BASE));
+    SSITransfer(SSI_BASE, &ERASE_COMMAND, NULL, 1);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
     //25AA1024 requires a finite amount of time to peform an automated erase of the sector
     delayMs(8);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
     delayUs(3);
 
-	xSemaphoreGive(g_pSPI0Semaphore);
+	SPIBusRelease(SSI_BASE);
+    PERF_END(PerfEEPROMErase);
     return true;
 }
 //*****************************************************************************
@@ -280,55 +813,65 @@ bool EEPROMChipErase(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN)
 //*****************************************************************************
 bool EEPROMPageErase(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address)
 {
-    uint32_t WRITE_ENABLE 			= 0x6;
-    uint32_t READ_STATUS			= 0x5;
-    uint32_t ERASE_COMMAND 			= 0x42;
+    uint8_t WRITE_ENABLE 			= 0x06;
+    uint8_t ERASE_COMMAND[4]		= {0x42, ((address >> 16) & 0xFF), ((address >> 8) & 0xFF), (address & 0xFF)};
     uint32_t ACTIVE_LOW 			= 0x0;
-    uint32_t DUMMY_DATA				= 0x0;
-    uint32_t READ_DATA;
-    //Set Write Enable Latch
+    bool result;
+    PERF_BEGIN();
 
-	xSemaphoreTake(g_pSPI0Semaphore,0);
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		PERF_END(PerfEEPROMErase);
+		return false;
+	}
 
+    //Set Write Enable Latch
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
     delayUs(3);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
     delayUs(1);
-    SSIDataPut(SSI_BASE, WRITE_ENABLE);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    //Wait for the SSI Port to finish all communication before bringing CS high
-    while(SSIBusy(SSI_BASE));
+    SSITransfer(SSI_BASE, &WRITE_ENABLE, NULL, 1);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
     delayUs(1);
 
-    //Write chip erase command to the EEPROM
+    //Write page erase command to the EEPROM followed by the 24-bit page address
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
     delayUs(1);
-    SSIDataPut(SSI_BASE, ERASE_COMMAND);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    while(SSIBusy(SSI_BASE));
-    SSIDataPut(SSI_BASE, address);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    while(SSIBusy(SSI_BASE));
+    SSITransfer(SSI_BASE, ERASE_COMMAND, NULL, 4);
     GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-    //25AA1024 requires a finite amount of time to peform an automated erase of the sector
-    delayMs(10);
 
-    READ_DATA = 0x01;
+    //25AA1024 requires a finite amount of time to peform an automated erase of the page
+    result = EEPROMWaitForWriteCycle(SSI_BASE, CS_PORT_BASE, CS_PIN);
 
-    while ((READ_DATA & 0x01) != 0x00) {
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
-    delayUs(1);
-    SSIDataPut(SSI_BASE, READ_STATUS);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    while(SSIBusy(SSI_BASE));
-    SSIDataPut(SSI_BASE, DUMMY_DATA);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-    }
-
-	xSemaphoreGive(g_pSPI0Semaphore);
-    return true;
+	SPIBusRelease(SSI_BASE);
+    PERF_END(PerfEEPROMErase);
+    return result;
+}
+//*****************************************************************************
+//
+//! Updates a CRC-32 (IEEE 802.3, reflected, polynomial 0xEDB88320) with a block
+//! of data. A nibble-wide table keeps the code small while avoiding a full
+//! bit-by-bit loop per byte.
+//!
+//! \param crc the running CRC, start with EEPROM_CRC32_INIT
+//! \param data pointer-to-array of data to add to the CRC
+//! \param length the number of bytes in data
+//!
+//! \return Returns the updated CRC. XOR the final value with EEPROM_CRC32_INIT.
+//
+//*****************************************************************************
+uint32_t EEPROMCrc32(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	static const uint32_t CRC32_NIBBLE_TABLE[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+	};
+
+	while (length--) {
+		crc ^= *data++;
+		crc = (crc >> 4) ^ CRC32_NIBBLE_TABLE[crc & 0x0F];
+		crc = (crc >> 4) ^ CRC32_NIBBLE_TABLE[crc & 0x0F];
+	}
+	return crc;
 }
 //*****************************************************************************
 //
@@ -353,152 +896,493 @@ bool EEPROMPageErase(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN,
 //*****************************************************************************
 uint8_t EEPROMSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address)
 {
-    uint32_t READ_COMMAND 	= 0x00000003;
+	uint8_t data = 0x00;
+
+	//A single sector is simply a one byte sequential read
+	EEPROMSequentialRead(SSI_BASE, CS_PORT_BASE, CS_PIN, address, &data, 1);
+
+    return data;
+}
+
+//*****************************************************************************
+//
+//! Reads any number of consecutive 8-bit values from the EEPROM using a single
+//! READ instruction.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param address the 17-bit starting address in EEPROM to read from
+//! \param output pointer-to-array of 8-bit values to save results into
+//! \param length number of values to read. This value should be non-zero.
+//!
+//! The 25AA1024 auto-increments its internal address pointer for as long as CS
+//! is held low, so one command/address header is sent per SPI_ARBITER_CHUNK_SIZE
+//! bytes. The bus is given up between chunks so that waiting transactions are
+//! not held up by long reads. Page boundaries do not apply to read operations.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool EEPROMSequentialRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address, uint8_t *output, uint32_t length)
+{
+    uint8_t READ_COMMAND[4]	= {0x03, 0x00, 0x00, 0x00};
     uint32_t ACTIVE_LOW 	= 0x00000000;
-    uint32_t READ_DATA;
+    uint32_t pos, chunk = 0;
+    bool result = true;
+    PERF_BEGIN();
 
 	LogItemEEPROM(EEPROMReadOP);
 
-	xSemaphoreTake(g_pSPI0Semaphore,0);
+	if (length == 0 || (address + length) > EEPROM_SIZE) {
+		//User provided value outside range of addressable memory
+		LogItemEEPROM(EEPROMIOException);
+		PERF_END(PerfEEPROMRead);
+		return false;
+	}
 
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-    delayUs(3);
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
-    delayUs(3);
-    //Read our data back from the same address and verify it matches
-    SSIDataPut(SSI_BASE, READ_COMMAND);
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, ((address >> 16) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, ((address >> 8) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, ((address) & 0x000000FF));
-    SSIDataGet(SSI_BASE, &READ_DATA);
-    SSIDataPut(SSI_BASE, 0x00000000);
-    //Wait for the SSI Port to finish all communication before bringing CS high
-    while(SSIBusy(SSI_BASE));
-    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-    SSIDataGet(SSI_BASE, &READ_DATA);
+	//Long reads give the bus up every SPI_ARBITER_CHUNK_SIZE bytes so that waiting transactions get a turn
+	for (pos = 0; pos < length && result; pos += chunk) {
+		chunk = ((length - pos) < SPI_ARBITER_CHUNK_SIZE) ? (length - pos) : SPI_ARBITER_CHUNK_SIZE;
+		READ_COMMAND[1] = (((address + pos) >> 16) & 0xFF);
+		READ_COMMAND[2] = (((address + pos) >> 8) & 0xFF);
+		READ_COMMAND[3] = ((address + pos) & 0xFF);
+
+		if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+			result = false;
+			break;
+		}
+	    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+	    delayUs(3);
+	    GPIOPinWrite(CS_PORT_BASE, CS_PIN, ACTIVE_LOW);
+	    delayUs(3);
+	    SSITransfer(SSI_BASE, READ_COMMAND, NULL, 4);
+	    //Clock out one dummy byte for every sector requested straight into the output array
+	    result = SSITransfer(SSI_BASE, NULL, &output[pos], chunk);
+	    GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+		SPIBusRelease(SSI_BASE);
+	}
+
+    //Data is stored inverted
+    for (pos = 0; pos < length; pos++) {
+    	output[pos] = (uint8_t)~output[pos];
+    }
+
+    if (!result)
+    {
+    	LogItemEEPROM(EEPROMIOException);
+    }
+    PERF_END(PerfEEPROMRead);
+    return result;
+}
+
+//*****************************************************************************
+//
+//! Writes an array of 8-bit values to the EEPROM chip and handles overflow
+//! to another page.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param start_address the 17-bit starting address in EEPROM to write to
+//! \param data pointer-to-array of 8-bit values to write sequentially
+//! \param array_length number of values held in the array. This value should be non-zero.
+//!
+//! This function takes the address provided by the user and accompanying data
+//! and splits the array on 256-byte page boundaries. Each piece is written
+//! with a single page write (see EEPROMPageWrite) so that the write enable,
+//! command header, write cycle and read-back verification are paid once per
+//! page instead of once per byte.
+//!
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool EEPROMBulkWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t start_address, uint8_t *data, uint32_t array_length)
+{
+	uint32_t pos = 0, page_length = 0;
+	PERF_BEGIN();
 
-	xSemaphoreGive(g_pSPI0Semaphore);
+	if ((start_address + array_length) > EEPROM_SIZE) {
+		//User provided value outside range of addressable memory
+		LogItemEEPROM(EEPROMIOException);
+		PERF_END(PerfEEPROMBulkWrite);
+		return false;
+	}
+
+	while (pos < array_length) {
+		//Only write up to the end of the page that holds the current address
+		page_length = EEPROM_PAGE_SIZE - ((start_address + pos) % EEPROM_PAGE_SIZE);
+		if (page_length > (array_length - pos)) {
+			page_length = array_length - pos;
+		}
+		if (!EEPROMPageWrite(SSI_BASE, CS_PORT_BASE, CS_PIN, (start_address + pos), &data[pos], page_length)) {
+			// We encountered a bad write, the failure has already been logged
+			PERF_END(PerfEEPROMBulkWrite);
+			return false;
+		}
+		pos += page_length;
+	}
 
-    return (~READ_DATA);
+	PERF_END(PerfEEPROMBulkWrite);
+	return true;
 }
 
 //*****************************************************************************
 //
-//! Writes an array of 8-bit values to the EEPROM chip and handles overflow
+//! Reads an array of 8-bit values to the EEPROM chip and handles overflow
 //! to another page.
 //!
 //! \param SSI_BASE the base address of the SSI port connected to the EEPROM
 //! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
 //! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
 //! \param start_address the 17-bit starting address in EEPROM to write to
-//! \param data pointer-to-array of 8-bit values to write sequentially
+//! \param output pointer-to-array of 8-bit values to save results into
 //! \param array_length number of values held in the array. This value should be non-zero.
 //!
 //! This function takes the address provided by the user and accompanying data
-//! and performs write operations for each 8-bit value in the given array. If
-//! the next address were to overflow to another page, this function provides
-//! safe methods for dealing with this.
+//! and reads every address up to the array size in one sequential read
+//! (see EEPROMSequentialRead). Reads are not limited by page boundaries.
 //!
 //!
 //! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
 //
 //*****************************************************************************
-bool EEPROMBulkWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t start_address, uint8_t *data, uint32_t array_length)
+bool EEPROMBulkRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t start_address, uint8_t *output, uint32_t array_length)
 {
-	int pos = 0;
+	//Reads are not bound to pages, stream the whole array in one transaction
+	return EEPROMSequentialRead(SSI_BASE, CS_PORT_BASE, CS_PIN, start_address, output, array_length);
+}
 
-	LogItemEEPROM(EEPROMWriteOP);
+//************REGISTER SHADOW FOR MICREL KSZ8895MLUB*************************************
+//
+// A RAM copy of all 256 registers of the Ethernet Controller. Most registers only
+// change when the firmware writes them, so once the shadow is loaded they are read
+// from RAM and every write goes to both the device and the shadow. A dirty bit is
+// kept for each register whose value changed since the saved image in EEPROM was
+// last brought up to date, so a configuration save only writes what changed.
+//
+//***************************************************************************************
 
-	xSemaphoreTake(g_pSPI0Semaphore,0);
+//*****************************************************************************
+//
+//! The shadow itself and a dirty bit per register. Only valid once
+//! EthoShadowValid is set, and only for the controller on EthoShadowSSIBase.
+//
+//*****************************************************************************
+static uint8_t EthoShadow[ETHO_SHADOW_SIZE];
+static uint32_t EthoShadowDirty[ETHO_SHADOW_SIZE / 32];
+static bool EthoShadowValid = false;
+static uint32_t EthoShadowSSIBase = 0;
+static uint32_t EthoShadowCSBase = 0;
+static uint32_t EthoShadowCSPin = 0;
+//*****************************************************************************
+//
+//! Registers written during a batch (see EthoBatchBegin()) whose new value is
+//! only held in the shadow, and the task that owns the batch.
+//
+//*****************************************************************************
+static uint32_t EthoBatchPending[ETHO_SHADOW_SIZE / 32];
+static xTaskHandle EthoBatchOwner = NULL;
+//*****************************************************************************
+//
+//! Serializes accesses to the indirect tables, see EthoIndirectLock().
+//
+//*****************************************************************************
+static xSemaphoreHandle g_pEthoIndirectSemaphore = NULL;
 
-	if (start_address >= 131072) {
-		//User provided value outside range of addressable memory
-		LogItemEEPROM(EEPROMIOException);
+//*****************************************************************************
+//
+//! Returns true if the register only changes when the firmware writes it.
+//! KSZ8895MLUB register map: port registers sit at 0x10 - 0x5F with offsets
+//! 0x9 - 0xF holding status, LinkMD and PHY restart controls.
+//
+//*****************************************************************************
+bool EthoShadowIsCacheable(uint8_t address)
+{
+	uint8_t offset = (address & 0x0F);
+
+	//Global Control 0 holds the self-clearing table flush bits
+	if (address == 0x02) {
+		return false;
+	}
+	//Port 1 - 5 status 0, LinkMD, control 6 (self-clearing restart bits) and status 1 - 2
+	if (address >= 0x10 && address < 0x60) {
+		return !(offset == 0x9 || offset == 0xA || offset == 0xB || offset >= 0xD);
+	}
+	//Indirect access control/data and interrupt status
+	if (address >= 0x6E && address <= 0x7C) {
 		return false;
 	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns true if reads of this register on this controller can be served
+//! from the shadow.
+//
+//*****************************************************************************
+static bool EthoShadowHit(uint32_t SSI_BASE, uint8_t address)
+{
+	return (EthoShadowValid && SSI_BASE == EthoShadowSSIBase && EthoShadowIsCacheable(address));
+}
+
+//*****************************************************************************
+//
+//! Passes a value read from or written to the device through to the shadow.
+//! A written value that differs from the shadow marks the register dirty.
+//
+//*****************************************************************************
+static void EthoShadowUpdate(uint32_t SSI_BASE, uint8_t address, uint8_t value, bool written)
+{
+	if (!EthoShadowHit(SSI_BASE, address)) {
+		return;
+	}
 
-	for (pos = 0; pos < array_length; pos++) {
-		if (start_address >= 131072) {
-			//Iterated beyond addressable memory
-			xSemaphoreGive(g_pSPI0Semaphore);
+	taskENTER_CRITICAL();
+	if (written && EthoShadow[address] != value) {
+		EthoShadowDirty[address / 32] |= (1 << (address % 32));
+	}
+	EthoShadow[address] = value;
+	taskEXIT_CRITICAL();
+}
 
-			LogItemEEPROM(EEPROMIOException);
+//*****************************************************************************
+//
+//! Loads the register shadow with burst reads and marks every register
+//! dirty. Reads go to the device until the shadow is complete.
+//
+//*****************************************************************************
+bool EthoShadowInit(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN)
+{
+	uint32_t burst_data[ETHO_BURST_LENGTH];
+	uint32_t reg, pos;
 
+	if (g_pEthoIndirectSemaphore == NULL) {
+		g_pEthoIndirectSemaphore = xSemaphoreCreateMutex();
+	}
+	EthoShadowValid = false;
+	for (reg = 0; reg < ETHO_SHADOW_SIZE; reg += ETHO_BURST_LENGTH) {
+		if (!EthoControllerBulkRead(SSI_BASE, CS_PORT_BASE, CS_PIN, reg, ETHO_BURST_LENGTH, burst_data)) {
 			return false;
 		}
-		if (EEPROMSingleWrite(SSI_BASE, CS_PORT_BASE, CS_PIN, start_address, (data[pos])) == 0) {
-			xSemaphoreGive(g_pSPI0Semaphore);
-
-			LogItemEEPROM(EEPROMIOException);
-
-			while (1) {
-				// We encountered a bad write, notify the developer.
-			}
+		for (pos = 0; pos < ETHO_BURST_LENGTH; pos++) {
+			EthoShadow[reg + pos] = (burst_data[pos] & 0xFF);
 		}
-		start_address++;
 	}
 
-	xSemaphoreGive(g_pSPI0Semaphore);
+	EthoShadowMarkRange(0, ETHO_SHADOW_SIZE, true);
+	EthoShadowSSIBase = SSI_BASE;
+	EthoShadowCSBase = CS_PORT_BASE;
+	EthoShadowCSPin = CS_PIN;
+	EthoShadowValid = true;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns true once EthoShadowInit() has loaded the register shadow.
+//
+//*****************************************************************************
+bool EthoShadowIsValid(void)
+{
+	return EthoShadowValid;
+}
+
+//*****************************************************************************
+//
+//! Finds the next run of consecutive dirty registers at or after *start.
+//
+//*****************************************************************************
+bool EthoShadowNextDirtyRange(uint32_t *start, uint32_t *length)
+{
+	uint32_t reg = *start;
+
+	while (reg < ETHO_SHADOW_SIZE && !((EthoShadowDirty[reg / 32] >> (reg % 32)) & 1)) {
+		reg++;
+	}
+	if (reg >= ETHO_SHADOW_SIZE) {
+		return false;
+	}
 
+	*start = reg;
+	while (reg < ETHO_SHADOW_SIZE && ((EthoShadowDirty[reg / 32] >> (reg % 32)) & 1)) {
+		reg++;
+	}
+	*length = reg - *start;
 	return true;
 }
 
 //*****************************************************************************
 //
-//! Reads an array of 8-bit values to the EEPROM chip and handles overflow
-//! to another page.
-//!
-//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
-//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
-//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
-//! \param start_address the 17-bit starting address in EEPROM to write to
-//! \param output pointer-to-array of 8-bit values to save results into
-//! \param array_length number of values held in the array. This value should be non-zero.
-//!
-//! This function takes the address provided by the user and accompanying data
-//! and performs read operations for each address up to the array size. If
-//! the next address were to overflow to another page, this function provides
-//! safe methods for dealing with this.
-//!
-//!
-//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//! Copies a range of registers out of the shadow and marks them clean.
 //
 //*****************************************************************************
-bool EEPROMBulkRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t start_address, uint8_t *output, uint32_t array_length)
+void EthoShadowTakeRange(uint32_t start, uint32_t length, uint8_t *output)
 {
-	int pos = 0;
+	uint32_t pos;
 
-	LogItemEEPROM(EEPROMReadOP);
+	//Copy and clear together so a write in between is not lost
+	taskENTER_CRITICAL();
+	for (pos = 0; pos < length && (start + pos) < ETHO_SHADOW_SIZE; pos++) {
+		output[pos] = EthoShadow[start + pos];
+		EthoShadowDirty[(start + pos) / 32] &= ~(1 << ((start + pos) % 32));
+	}
+	taskEXIT_CRITICAL();
+}
 
-	xSemaphoreTake(g_pSPI0Semaphore,0);
+//*****************************************************************************
+//
+//! Marks a range of registers as dirty or clean.
+//
+//*****************************************************************************
+void EthoShadowMarkRange(uint32_t start, uint32_t length, bool dirty)
+{
+	uint32_t reg;
 
-	if (start_address >= 131072) {
-		//User provided value outside range of addressable memory
-		xSemaphoreGive(g_pSPI0Semaphore);
+	taskENTER_CRITICAL();
+	for (reg = start; reg < (start + length) && reg < ETHO_SHADOW_SIZE; reg++) {
+		if (dirty) {
+			EthoShadowDirty[reg / 32] |= (1 << (reg % 32));
+		}
+		else {
+			EthoShadowDirty[reg / 32] &= ~(1 << (reg % 32));
+		}
+	}
+	taskEXIT_CRITICAL();
+}
 
-		LogItemEEPROM(EEPROMIOException);
+//*****************************************************************************
+//
+//! Returns true if a write to this register from the calling task has to be
+//! staged in the shadow because the task has a batch open.
+//
+//*****************************************************************************
+static bool EthoBatchDefers(uint32_t SSI_BASE, uint8_t address)
+{
+	return (EthoBatchOwner != NULL && EthoBatchOwner == xTaskGetCurrentTaskHandle() && EthoShadowHit(SSI_BASE, address));
+}
+
+//*****************************************************************************
+//
+//! Stages a write in the shadow. The register is marked dirty as if it had
+//! been written and pending until the batch is committed.
+//
+//*****************************************************************************
+static void EthoBatchStage(uint8_t address, uint8_t value)
+{
+	taskENTER_CRITICAL();
+	if (EthoShadow[address] != value) {
+		EthoShadowDirty[address / 32] |= (1 << (address % 32));
+	}
+	EthoShadow[address] = value;
+	EthoBatchPending[address / 32] |= (1 << (address % 32));
+	taskEXIT_CRITICAL();
+}
+
+//*****************************************************************************
+//
+//! Opens a batch for the calling task.
+//
+//*****************************************************************************
+bool EthoBatchBegin(void)
+{
+	xTaskHandle task = xTaskGetCurrentTaskHandle();
 
+	if (!EthoShadowValid || (EthoBatchOwner != NULL && EthoBatchOwner != task)) {
 		return false;
 	}
+	if (EthoBatchOwner == NULL) {
+		memset(EthoBatchPending, 0, sizeof(EthoBatchPending));
+		EthoBatchOwner = task;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns true if the calling task has a batch open.
+//
+//*****************************************************************************
+bool EthoBatchActive(void)
+{
+	return (EthoBatchOwner != NULL && EthoBatchOwner == xTaskGetCurrentTaskHandle());
+}
 
-	for (pos = 0; pos < array_length; pos++) {
-		if (start_address >= 131072) {
-			//Iterated beyond addressable memory
-			xSemaphoreGive(g_pSPI0Semaphore);
+//*****************************************************************************
+//
+//! Closes the calling task's batch and writes every pending register, one
+//! burst per run of consecutive registers.
+//
+//*****************************************************************************
+bool EthoBatchCommit(uint32_t *registers, uint32_t *bursts)
+{
+	uint32_t burst_data[ETHO_BURST_LENGTH];
+	uint32_t reg = 0, start, length;
+	bool result = true;
 
-			LogItemEEPROM(EEPROMIOException);
+	if (registers) {
+		*registers = 0;
+	}
+	if (bursts) {
+		*bursts = 0;
+	}
+	if (!EthoBatchActive()) {
+		return false;
+	}
+	//Close the batch first so the writes below go to the device
+	EthoBatchOwner = NULL;
 
-			return false;
+	while (reg < ETHO_SHADOW_SIZE) {
+		if (!((EthoBatchPending[reg / 32] >> (reg % 32)) & 1)) {
+			reg++;
+			continue;
+		}
+		taskENTER_CRITICAL();
+		for (start = reg, length = 0; reg < ETHO_SHADOW_SIZE && length < ETHO_BURST_LENGTH && ((EthoBatchPending[reg / 32] >> (reg % 32)) & 1); reg++, length++) {
+			burst_data[length] = EthoShadow[reg];
+			EthoBatchPending[reg / 32] &= ~(1 << (reg % 32));
+		}
+		taskEXIT_CRITICAL();
+		result &= EthoControllerBulkWrite(EthoShadowSSIBase, EthoShadowCSBase, EthoShadowCSPin, start, length, burst_data);
+		if (registers) {
+			*registers += length;
+		}
+		if (bursts) {
+			(*bursts)++;
 		}
-		output[pos] = EEPROMSingleRead(SSI_BASE, CS_PORT_BASE, CS_PIN, start_address);
-		start_address++;
 	}
+	return result;
+}
 
-	xSemaphoreGive(g_pSPI0Semaphore);
-	return true;
+//*****************************************************************************
+//
+//! Takes the mutex that serializes accesses to the Ethernet Controller's
+//! indirect tables. Does nothing before the scheduler is started.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void EthoIndirectLock(void)
+{
+	if (g_pEthoIndirectSemaphore != NULL && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		xSemaphoreTake(g_pEthoIndirectSemaphore, portMAX_DELAY);
+	}
+}
+
+//*****************************************************************************
+//
+//! Releases the mutex taken by EthoIndirectLock().
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void EthoIndirectUnlock(void)
+{
+	if (g_pEthoIndirectSemaphore != NULL && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		xSemaphoreGive(g_pEthoIndirectSemaphore);
+	}
 }
 
 //*****************************************************************************
@@ -519,34 +1403,38 @@ bool EEPROMBulkRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, u
 //*****************************************************************************
 uint32_t EthoControllerSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t address)
 {
-	uint32_t READ_DATA;
-	uint32_t READCOMMAND = 0x03;
+	uint8_t READCOMMAND[3] = {0x03, address, 0x00};
+	uint8_t READ_DATA[3];
 	uint32_t DUMMYDATA = 0x00;
+	PERF_BEGIN();
 
-	LogItemEEPROM(EthoControllerReadOP);
+	LogItemEEPROMData(EthoControllerReadOP, address);
+
+	if (EthoShadowHit(SSI_BASE, address)) {
+		PERF_END(PerfEthoRead);
+		return EthoShadow[address];
+	}
 
-	xSemaphoreTake(g_pSPI1Semaphore,0);
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		LogItemEEPROM(EthoControlIOException);
+		PERF_END(PerfEthoRead);
+		return 0;
+	}
 
 	//Pull status information for port 3 from register 0x39
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
 	delayUs(3);
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, DUMMYDATA);
 	delayUs(3);
-	//Read our data back from the same address and verify it matches
-	SSIDataPut(SSI_BASE, READCOMMAND);
-	SSIDataGet(SSI_BASE, &READ_DATA);
-	SSIDataPut(SSI_BASE, address);
-	SSIDataGet(SSI_BASE, &READ_DATA);
-	SSIDataPut(SSI_BASE, DUMMYDATA);
-	//Wait for the SSI Port to finish all communication before bringing CS high
-	while(SSIBusy(SSI_BASE));
+	//The register value is shifted in while the dummy byte is clocked out
+	SSITransfer(SSI_BASE, READCOMMAND, READ_DATA, 3);
 	delayUs(3);
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-	SSIDataGet(SSI_BASE, &READ_DATA);
 
-	xSemaphoreGive(g_pSPI1Semaphore);
+	SPIBusRelease(SSI_BASE);
 
-	return READ_DATA;
+	PERF_END(PerfEthoRead);
+	return READ_DATA[2];
 }
 
 //*****************************************************************************
@@ -562,9 +1450,10 @@ uint32_t EthoControllerSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint
 //!
 //! This function takes the address provided by the user and performs the timing
 //! needed to aquire the status information inside the specified register on a
-//! MICREL KSZ8895MQX Ethernet Controller. It then proceeds to get all successive registers
-//! from the device until the count parameter has been reached. This information is then returned
-//! as a pointer-to-array of uint32_t values.
+//! MICREL KSZ8895MQX Ethernet Controller. The KSZ8895 auto-increments its register
+//! address for as long as CS is held low, so all successive registers up to the
+//! count parameter are clocked out in a single burst behind one READ command.
+//! This information is then returned as a pointer-to-array of uint32_t values.
 //!
 //! \note Ensure that the array passed to the "output" parameter is defined as having at least the size of count
 //!
@@ -573,44 +1462,141 @@ uint32_t EthoControllerSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint
 //*****************************************************************************
 bool EthoControllerBulkRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t start_address, uint8_t count, uint32_t *output)
 {
-	uint32_t READ_DATA;
-	uint32_t READCOMMAND = 0x03;
+	uint8_t READCOMMAND[2] = {0x03, start_address};
 	uint32_t DUMMYDATA = 0x00;
 	int i = 0;
+	bool result;
+	PERF_BEGIN();
 
-	LogItemEEPROM(EthoControllerReadOP);
-
-	xSemaphoreTake(g_pSPI1Semaphore,0);
+	LogItemEEPROMData(EthoControllerReadOP, start_address);
 
-	if ((start_address + count) > 255) {
+	if (count == 0 || (start_address + count) > 256) {
 		//User tried to request more results than are held in this 8-bit device.
+		LogItemEEPROM(EthoControlIOException);
+		PERF_END(PerfEthoBulkRead);
 		return false;
 	}
-	for (i = 0; i < count; i++) {
-	//Pull status information for port 3 from register 0x39
+
+	//Serve the burst from RAM if none of its registers can change on their own
+	for (i = 0; i < count && EthoShadowHit(SSI_BASE, start_address + i); i++);
+	if (i == count) {
+		for (i = 0; i < count; i++) {
+			output[i] = EthoShadow[start_address + i];
+		}
+		PERF_END(PerfEthoBulkRead);
+		return true;
+	}
+
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		LogItemEEPROM(EthoControlIOException);
+		PERF_END(PerfEthoBulkRead);
+		return false;
+	}
+
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
 	delayUs(3);
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, DUMMYDATA);
 	delayUs(3);
-	//Read our data back from the same address and verify it matches
-	SSIDataPut(SSI_BASE, READCOMMAND);
-	SSIDataGet(SSI_BASE, &READ_DATA);
-	SSIDataPut(SSI_BASE, (start_address + i));
-	SSIDataGet(SSI_BASE, &READ_DATA);
-	SSIDataPut(SSI_BASE, DUMMYDATA);
-	//Wait for the SSI Port to finish all communication before bringing CS high
-	while(SSIBusy(SSI_BASE));
+	//Send the READ command and the first register address once
+	SSITransfer(SSI_BASE, READCOMMAND, NULL, 2);
+	//Each dummy byte clocks out the next register in sequence
+	result = SSITransfer(SSI_BASE, NULL, EthoTransferBuffer, count);
 	delayUs(3);
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-	SSIDataGet(SSI_BASE, &READ_DATA);
 
-	output[i] = READ_DATA;
+	for (i = 0; i < count; i++) {
+		output[i] = EthoTransferBuffer[i];
+		if (result) {
+			EthoShadowUpdate(SSI_BASE, start_address + i, EthoTransferBuffer[i], false);
+		}
+	}
+
+	SPIBusRelease(SSI_BASE);
+
+	if (!result) {
+		LogItemEEPROM(EthoControlIOException);
+	}
+	PERF_END(PerfEthoBulkRead);
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Writes multiple consecutive registers on the Ethernet Controller over SPI.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param start_address the 8-bit address in the Ethernet Controller to begin writing to
+//! \param count the number of registers from the starting address to write.
+//! \param data pointer-to-array of values to write, one per register
+//!
+//! This function sends a single WRITE command and the starting address, then
+//! clocks every value in the data array out while CS is held low. The KSZ8895
+//! auto-increments the register address after each byte.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Success)
+//
+//*****************************************************************************
+bool EthoControllerBulkWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t start_address, uint8_t count, uint32_t *data)
+{
+	uint32_t DUMMYDATA = 0x00;
+	int i = 0;
+	bool result;
+	PERF_BEGIN();
+
+	LogItemEEPROMData(EthoControllerWriteOP, start_address);
+
+	if (count == 0 || (start_address + count) > 256) {
+		//User tried to write more registers than are held in this 8-bit device.
+		LogItemEEPROM(EthoControlIOException);
+		PERF_END(PerfEthoBulkWrite);
+		return false;
+	}
 
+	//Inside a batch the whole burst is staged if every register can be
+	for (i = 0; i < count && EthoBatchDefers(SSI_BASE, start_address + i); i++);
+	if (i == count) {
+		for (i = 0; i < count; i++) {
+			EthoBatchStage(start_address + i, (data[i] & 0xFF));
+		}
+		PERF_END(PerfEthoBulkWrite);
+		return true;
 	}
 
-	xSemaphoreGive(g_pSPI1Semaphore);
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		LogItemEEPROM(EthoControlIOException);
+		PERF_END(PerfEthoBulkWrite);
+		return false;
+	}
 
-	return true;
+	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+	delayUs(3);
+	GPIOPinWrite(CS_PORT_BASE, CS_PIN, DUMMYDATA);
+	delayUs(3);
+	//Stage the WRITE command and the first register address ahead of the data
+	EthoTransferBuffer[0] = 0x02;
+	EthoTransferBuffer[1] = start_address;
+	//Each byte is written to the next register in sequence
+	for (i = 0; i < count; i++) {
+		EthoTransferBuffer[2 + i] = (data[i] & 0xFF);
+	}
+	result = SSITransfer(SSI_BASE, EthoTransferBuffer, NULL, count + 2);
+	delayUs(3);
+	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
+
+	//Write-through to the register shadow
+	for (i = 0; i < count && result; i++) {
+		EthoShadowUpdate(SSI_BASE, start_address + i, EthoTransferBuffer[2 + i], true);
+	}
+
+	SPIBusRelease(SSI_BASE);
+
+	if (!result) {
+		LogItemEEPROM(EthoControlIOException);
+	}
+	PERF_END(PerfEthoBulkWrite);
+	return result;
 }
 
 //*****************************************************************************
@@ -632,32 +1618,77 @@ bool EthoControllerBulkRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t C
 //*****************************************************************************
 bool EthoControllerSingleWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t address, uint32_t data)
 {
-	uint32_t READ_DATA;
-	uint32_t WRITECOMMAND = 0x02;
+	uint8_t WRITECOMMAND[3] = {0x02, address, (uint8_t)data};
 	uint32_t DUMMYDATA = 0x00;
+	PERF_BEGIN();
 
-	LogItemEEPROM(EthoControllerWriteOP);
+	LogItemEEPROMData(EthoControllerWriteOP, address);
+
+	//Inside a batch the write is only staged in the shadow
+	if (EthoBatchDefers(SSI_BASE, address)) {
+		EthoBatchStage(address, WRITECOMMAND[2]);
+		PERF_END(PerfEthoWrite);
+		return true;
+	}
 
-	xSemaphoreTake(g_pSPI1Semaphore,0);
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		LogItemEEPROM(EthoControlIOException);
+		PERF_END(PerfEthoWrite);
+		return false;
+	}
 
 	//Pull status information for port 3 from register 0x39
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
 	delayUs(3);
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, DUMMYDATA);
 	delayUs(3);
-	//Read our data back from the same address and verify it matches
-	SSIDataPut(SSI_BASE, WRITECOMMAND);
-	SSIDataGet(SSI_BASE, &READ_DATA);
-	SSIDataPut(SSI_BASE, address);
-	SSIDataGet(SSI_BASE, &READ_DATA);
-	SSIDataPut(SSI_BASE, data);
-	//Wait for the SSI Port to finish all communication before bringing CS high
-	while(SSIBusy(SSI_BASE));
+	SSITransfer(SSI_BASE, WRITECOMMAND, NULL, 3);
 	delayUs(3);
 	GPIOPinWrite(CS_PORT_BASE, CS_PIN, CS_PIN);
-	SSIDataGet(SSI_BASE, &READ_DATA);
 
-	xSemaphoreGive(g_pSPI1Semaphore);
+	//Write-through to the register shadow
+	EthoShadowUpdate(SSI_BASE, address, WRITECOMMAND[2], true);
+
+	SPIBusRelease(SSI_BASE);
 
+	PERF_END(PerfEthoWrite);
 	return true;
 }
+
+//*****************************************************************************
+//
+//! Changes bits of a register on the Ethernet Controller. The register is read
+//! and written back while the bus is held, so no other task's write to it can
+//! fall in between.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the Ethernet Controller
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param address the 8-bit address in the Ethernet Controller to change
+//! \param clear_mask bits to clear
+//! \param set_mask bits to set, applied after clear_mask
+//! \param written returns the value written (may be NULL)
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Success)
+//
+//*****************************************************************************
+bool EthoControllerModifyBits(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t address, uint8_t clear_mask, uint8_t set_mask, uint32_t *written)
+{
+	uint32_t reg_data;
+	bool result;
+
+	if (!SPIBusAcquire(SSI_BASE, SPI_ARBITER_TIMEOUT_MS)) {
+		LogItemEEPROM(EthoControlIOException);
+		return false;
+	}
+	//The read and write below nest inside this grant
+	reg_data = EthoControllerSingleRead(SSI_BASE, CS_PORT_BASE, CS_PIN, address);
+	reg_data = ((reg_data & ~clear_mask) | set_mask) & 0xFF;
+	result = EthoControllerSingleWrite(SSI_BASE, CS_PORT_BASE, CS_PIN, address, reg_data);
+	SPIBusRelease(SSI_BASE);
+
+	if (written) {
+		*written = reg_data;
+	}
+	return result;
+}
@@ -30,9 +30,100 @@
 
 //*****************************************************************************
 //
-//! Pauses execution of the microcontroller for the time specified in ui32Ms in
-//! milliseconds by converting ui32Ms to MCU ticks. This function blocks all
-//! other running tasks for the time specified. [USE SPARINGLY].
+// 25AA1024 geometry and write cycle polling settings.
+//
+//*****************************************************************************
+#define EEPROM_SIZE						131072
+#define EEPROM_PAGE_SIZE				256
+#define EEPROM_WIP_POLL_INTERVAL_US		100
+#define EEPROM_WIP_POLL_LIMIT			100
+//*****************************************************************************
+//
+//! Initial value (and final XOR) of the CRC-32 used by EEPROMCrc32().
+//
+//*****************************************************************************
+#define EEPROM_CRC32_INIT				0xFFFFFFFF
+
+//*****************************************************************************
+//
+// KSZ8895 burst transfer settings. Number of consecutive registers moved in a
+// single CS window by callers of EthoControllerBulkRead/EthoControllerBulkWrite
+// that stage data on the stack.
+//
+//*****************************************************************************
+#define ETHO_BURST_LENGTH				32
+
+//*****************************************************************************
+//
+// KSZ8895 register shadow settings. The whole register space is mirrored in
+// RAM so that reads of configuration registers do not need the SPI bus.
+//
+//*****************************************************************************
+#define ETHO_SHADOW_SIZE				256
+
+//*****************************************************************************
+//
+// uDMA SSI transaction engine settings. Transfers shorter than
+// SSI_DMA_MIN_LENGTH are clocked through the FIFO by the CPU since arming the
+// channels costs more than the transfer itself. SSI_DMA_MAX_LENGTH is the
+// largest transfer a single uDMA request can move. The SSI interrupts call
+// FreeRTOS API functions and therefore must sit at or below
+// configMAX_SYSCALL_INTERRUPT_PRIORITY (0xA0).
+//
+//*****************************************************************************
+#define SSI_DMA_MIN_LENGTH				8
+#define SSI_DMA_MAX_LENGTH				1024
+#define SSI_DMA_TIMEOUT_MS				100
+#define SSI_DMA_INT_PRIORITY			0xC0
+
+//*****************************************************************************
+//
+// Timing service settings. DELAY_TIMEBASE is a free running 32-bit counter
+// used for short polled waits, DELAY_ONESHOT wakes tasks sleeping in delayUs()
+// for DELAY_BLOCK_MIN_US or longer.
+//
+//*****************************************************************************
+#define DELAY_TIMEBASE_BASE				TIMER5_BASE
+#define DELAY_TIMEBASE_SYS_BASE			SYSCTL_PERIPH_TIMER5
+#define DELAY_ONESHOT_BASE				TIMER4_BASE
+#define DELAY_ONESHOT_SYS_BASE			SYSCTL_PERIPH_TIMER4
+#define DELAY_ONESHOT_INT				INT_TIMER4A
+#define DELAY_BLOCK_MIN_US				100
+#define DELAY_INT_PRIORITY				0xC0
+
+//*****************************************************************************
+//
+//! Starts the timebase and prepares the one-shot timer used by delayMs() and
+//! delayUs(). Must be called after the system clock has been set.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void DelayTimerInit(void);
+//*****************************************************************************
+//
+//! Returns the number of microseconds since DelayTimerInit() was called, or 0
+//! if it has not been called yet. Wraps after 2^32 timebase counts (~85s).
+//!
+//! \return Returns the elapsed time in microseconds
+//
+//*****************************************************************************
+uint32_t DelayTimebaseUs(void);
+//*****************************************************************************
+//
+//! Interrupt handler for the one-shot delay timer. Wakes the task waiting in
+//! delayUs().
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void DelayTimerIntHandler(void);
+//*****************************************************************************
+//
+//! Pauses the calling task for the time specified in ui32Ms in milliseconds.
+//! Once the scheduler is running, tasks are put to sleep with vTaskDelay so
+//! that other tasks may run in the meantime. Before the scheduler starts, or
+//! when called from an interrupt handler, the timebase is polled instead.
 //!
 //! \param ui32Ms the number of milliseconds to pause the MCU
 //
@@ -40,9 +131,11 @@
 void delayMs(uint32_t ui32Ms);
 //*****************************************************************************
 //
-//! Pauses execution of the microcontroller for the time specified in ui32Us in
-//! microseconds by converting ui32Us to MCU ticks. This function blocks all
-//! other running tasks for the time specified. [USE SPARINGLY].
+//! Pauses the calling task for the time specified in ui32Us in microseconds.
+//! Waits shorter than DELAY_BLOCK_MIN_US (CS setup/hold times and the like)
+//! poll the timebase since a context switch would take longer than the wait
+//! itself. Longer waits arm the one-shot timer and sleep until it expires, and
+//! waits of a millisecond or more are handed to delayMs().
 //!
 //! \param ui32Us the number of microseconds to pause the MCU
 //
@@ -50,6 +143,55 @@ void delayMs(uint32_t ui32Ms);
 void delayUs(uint32_t ui32Us);
 //*****************************************************************************
 //
+//! Enables the uDMA controller, assigns channels 10/11 to SSI0 and 24/25 to
+//! SSI1 and enables both SSI interrupts. Must be called after ConfigureSSI()
+//! and before any EEPROM or Ethernet Controller access.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SSIDMAInit(void);
+//*****************************************************************************
+//
+//! Moves a block of data through an SSI port. Every byte in tx is clocked out
+//! while the byte shifted in at the same time is stored in rx.
+//!
+//! \param SSI_BASE the base address of the SSI port (SSI0 or SSI1)
+//! \param tx pointer-to-array of bytes to send. Pass NULL to clock out zeros.
+//! \param rx pointer-to-array that receives the bytes read back. Pass NULL to discard them.
+//! \param length number of bytes to move
+//!
+//! Transfers of at least SSI_DMA_MIN_LENGTH bytes are handed to the uDMA
+//! engine, split into SSI_DMA_MAX_LENGTH pieces where required. Shorter
+//! transfers are clocked through the FIFO directly. The SSI port is idle
+//! when this function returns, so the caller may release CS straight away.
+//!
+//! \note The caller must already own the SPI port (see SPIBusAcquire()) and
+//! drive CS itself.
+//!
+//! \return Returns the result of the operation (0 = Timed Out, 1 = Succeeded)
+//
+//*****************************************************************************
+bool SSITransfer(uint32_t SSI_BASE, uint8_t *tx, uint8_t *rx, uint32_t length);
+//*****************************************************************************
+//
+//! Interrupt handler for SSI0 (EEPROM). Signals uDMA transfer completion.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SSI0IntHandler(void);
+//*****************************************************************************
+//
+//! Interrupt handler for SSI1 (Ethernet Controller). Signals uDMA transfer
+//! completion.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SSI1IntHandler(void);
+//*****************************************************************************
+//
 //! Writes a single 8 bit value to a register within the EEPROM at the specified
 //! address. This function does not handle page operations.
 //!
@@ -75,6 +217,28 @@ void delayUs(uint32_t ui32Us);
 bool EEPROMSingleWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address, uint8_t data);
 //*****************************************************************************
 //
+//! Writes up to one page (256 bytes) of 8-bit values to the EEPROM using a
+//! single WRITE instruction.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param address the 17-bit starting address in EEPROM to write to
+//! \param data pointer-to-array of 8-bit values to write sequentially
+//! \param length number of values to write. Must be non-zero and must not run
+//! past the end of the page that holds "address".
+//!
+//! The write enable latch is set once, all bytes are clocked out behind a single
+//! command/address header and the write cycle is completed by polling the WIP
+//! bit rather than waiting a fixed period. The page is then read back in one
+//! sequential read and compared against the data provided.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool EEPROMPageWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address, uint8_t *data, uint32_t length);
+//*****************************************************************************
+//
 //! Reads a single 8 bit value to a register within the EEPROM at the specified
 //! address. This function does not handle page operations.
 //!
@@ -97,6 +261,27 @@ bool EEPROMSingleWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN
 uint8_t EEPROMSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address);
 //*****************************************************************************
 //
+//! Reads any number of consecutive 8-bit values from the EEPROM using a single
+//! READ instruction.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param address the 17-bit starting address in EEPROM to read from
+//! \param output pointer-to-array of 8-bit values to save results into
+//! \param length number of values to read. This value should be non-zero.
+//!
+//! The 25AA1024 auto-increments its internal address pointer for as long as CS
+//! is held low, so one command/address header is sent per SPI_ARBITER_CHUNK_SIZE
+//! bytes. The bus is given up between chunks so that waiting transactions are
+//! not held up by long reads. Page boundaries do not apply to read operations.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool EEPROMSequentialRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address, uint8_t *output, uint32_t length);
+//*****************************************************************************
+//
 //! Writes an array of 8-bit values to the EEPROM chip and handles overflow
 //! to another page.
 //!
@@ -108,9 +293,10 @@ uint8_t EEPROMSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_P
 //! \param array_length number of values held in the array. This value should be non-zero.
 //!
 //! This function takes the address provided by the user and accompanying data
-//! and performs write operations for each 8-bit value in the given array. If
-//! the next address were to overflow to another page, this function provides
-//! safe methods for dealing with this.
+//! and splits the array on 256-byte page boundaries. Each piece is written
+//! with a single page write (see EEPROMPageWrite) so that the write enable,
+//! command header, write cycle and read-back verification are paid once per
+//! page instead of once per byte.
 //!
 //!
 //! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
@@ -130,9 +316,8 @@ bool EEPROMBulkWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN,
 //! \param array_length number of values held in the array. This value should be non-zero.
 //!
 //! This function takes the address provided by the user and accompanying data
-//! and performs read operations for each address up to the array size. If
-//! the next address were to overflow to another page, this function provides
-//! safe methods for dealing with this.
+//! and reads every address up to the array size in one sequential read
+//! (see EEPROMSequentialRead). Reads are not limited by page boundaries.
 //!
 //!
 //! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
@@ -169,9 +354,10 @@ uint32_t EthoControllerSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint
 //!
 //! This function takes the address provided by the user and performs the timing
 //! needed to aquire the status information inside the specified register on a
-//! MICREL KSZ8895MQX Ethernet Controller. It then proceeds to get all successive registers
-//! from the device until the count parameter has been reached. This information is then returned
-//! as a pointer-to-array of uint32_t values.
+//! MICREL KSZ8895MQX Ethernet Controller. The KSZ8895 auto-increments its register
+//! address for as long as CS is held low, so all successive registers up to the
+//! count parameter are clocked out in a single burst behind one READ command.
+//! This information is then returned as a pointer-to-array of uint32_t values.
 //!
 //! \note Ensure that the array passed to the "output" parameter is defined as having at least the size of count
 //!
@@ -181,6 +367,25 @@ uint32_t EthoControllerSingleRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint
 bool EthoControllerBulkRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t start_address, uint8_t count, uint32_t *output);
 //*****************************************************************************
 //
+//! Writes multiple consecutive registers on the Ethernet Controller over SPI.
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the EEPROM
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param start_address the 8-bit address in the Ethernet Controller to begin writing to
+//! \param count the number of registers from the starting address to write.
+//! \param data pointer-to-array of values to write, one per register
+//!
+//! This function sends a single WRITE command and the starting address, then
+//! clocks every value in the data array out while CS is held low. The KSZ8895
+//! auto-increments the register address after each byte.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Success)
+//
+//*****************************************************************************
+bool EthoControllerBulkWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t start_address, uint8_t count, uint32_t *data);
+//*****************************************************************************
+//
 //! Writes a status register from the Ethernet Controller over SPI.
 //!
 //! \param SSI_BASE the base address of the SSI port connected to the EEPROM
@@ -199,6 +404,25 @@ bool EthoControllerBulkRead(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t C
 bool EthoControllerSingleWrite(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t address, uint32_t data);
 //*****************************************************************************
 //
+//! Changes bits of a register on the Ethernet Controller (read-modify-write).
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the Ethernet Controller
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//! \param address the 8-bit address in the Ethernet Controller to change
+//! \param clear_mask bits to clear
+//! \param set_mask bits to set, applied after clear_mask
+//! \param written returns the value written (may be NULL)
+//!
+//! The bus is held from the read until the write has finished, so another
+//! task cannot change the register in between.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Success)
+//
+//*****************************************************************************
+bool EthoControllerModifyBits(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint8_t address, uint8_t clear_mask, uint8_t set_mask, uint32_t *written);
+//*****************************************************************************
+//
 //! Erases the 25AA1024 memory area completely.
 //!
 //! \param SSI_BASE the base address of the SSI port connected to the EEPROM
@@ -224,6 +448,136 @@ bool EEPROMChipErase(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN);
 //
 //*****************************************************************************
 bool EEPROMPageErase(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN, uint32_t address);
+//*****************************************************************************
+//
+//! Updates a CRC-32 (IEEE 802.3) with a block of data. Used to validate the
+//! images saved to the EEPROM.
+//!
+//! \param crc the running CRC, start with EEPROM_CRC32_INIT
+//! \param data pointer-to-array of data to add to the CRC
+//! \param length the number of bytes in data
+//!
+//! \return Returns the updated CRC. XOR the final value with EEPROM_CRC32_INIT.
+//
+//*****************************************************************************
+uint32_t EEPROMCrc32(uint32_t crc, const uint8_t *data, uint32_t length);
+//*****************************************************************************
+//
+//! Loads the RAM shadow of the Ethernet Controller's registers with burst
+//! reads. From then on reads of cacheable registers on this controller are
+//! served from RAM and every write is passed through to the shadow. All
+//! registers start out dirty since nothing is known about the saved image.
+//! Also creates the mutex used by EthoIndirectLock().
+//!
+//! \param SSI_BASE the base address of the SSI port connected to the Ethernet Controller
+//! \param CS_PORT_BASE the base address of the port that the CS GPIO pin is on
+//! \param CS_PIN the pin of the Chip Select (CS) on the port specified above
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool EthoShadowInit(uint32_t SSI_BASE, uint32_t CS_PORT_BASE, uint32_t CS_PIN);
+//*****************************************************************************
+//
+//! Returns true once EthoShadowInit() has loaded the register shadow.
+//
+//*****************************************************************************
+bool EthoShadowIsValid(void);
+//*****************************************************************************
+//
+//! Returns true if the register only changes when the firmware writes it, so
+//! that it can be served from the shadow. Status, LinkMD, indirect access and
+//! interrupt status registers and registers with self-clearing bits are
+//! always read from the device.
+//!
+//! \param address the 8-bit address in the Ethernet Controller
+//
+//*****************************************************************************
+bool EthoShadowIsCacheable(uint8_t address);
+//*****************************************************************************
+//
+//! Finds the next run of consecutive dirty registers, i.e. cacheable registers
+//! that were written with a new value since the shadow was last marked clean.
+//!
+//! \param start the register to begin searching from. Returns the first
+//! register of the run.
+//! \param length returns the number of registers in the run
+//!
+//! \return Returns true if a dirty run was found, otherwise false
+//
+//*****************************************************************************
+bool EthoShadowNextDirtyRange(uint32_t *start, uint32_t *length);
+//*****************************************************************************
+//
+//! Copies a range of registers out of the shadow and marks them clean.
+//!
+//! \param start the first register to copy
+//! \param length the number of registers to copy
+//! \param output pointer-to-array of at least length values
+//
+//*****************************************************************************
+void EthoShadowTakeRange(uint32_t start, uint32_t length, uint8_t *output);
+//*****************************************************************************
+//
+//! Marks a range of registers as dirty or clean, e.g. after they have been
+//! restored from or failed to be saved to EEPROM.
+//!
+//! \param start the first register to mark
+//! \param length the number of registers to mark
+//! \param dirty true to mark the registers dirty, false to mark them clean
+//
+//*****************************************************************************
+void EthoShadowMarkRange(uint32_t start, uint32_t length, bool dirty);
+//*****************************************************************************
+//
+//! Opens a batch for the calling task. Until EthoBatchCommit() the task's
+//! writes to cacheable registers are only staged in the shadow, so repeated
+//! writes to a register coalesce and reads see the staged values. Writes to
+//! other registers and from other tasks still go to the device immediately.
+//!
+//! \return Returns false if the shadow is not loaded or another task has a
+//! batch open, otherwise true
+//
+//*****************************************************************************
+bool EthoBatchBegin(void);
+//*****************************************************************************
+//
+//! Returns true if the calling task has a batch open.
+//
+//*****************************************************************************
+bool EthoBatchActive(void);
+//*****************************************************************************
+//
+//! Closes the calling task's batch and writes every staged register to the
+//! device with one burst per run of consecutive registers.
+//!
+//! \param registers returns the number of registers written (may be NULL)
+//! \param bursts returns the number of bursts used (may be NULL)
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool EthoBatchCommit(uint32_t *registers, uint32_t *bursts);
+//*****************************************************************************
+//
+//! Takes the mutex that serializes accesses to the Ethernet Controller's
+//! indirect tables (registers 0x6E - 0x78). An indirect access spans several
+//! SPI transfers, so a task must hold the lock from the access control write
+//! until it has read or loaded the data registers. Does nothing before the
+//! scheduler is started.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void EthoIndirectLock(void);
+//*****************************************************************************
+//
+//! Releases the mutex taken by EthoIndirectLock().
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void EthoIndirectUnlock(void);
 
 
 
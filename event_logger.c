@@ -28,14 +28,17 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "inc/hw_gpio.h"
+#include "inc/hw_nvic.h"
 #include "sysctl.h"
 #include "gpio.h"
 #include "rom.h"
 #include "freertos_init.h"
 #include "eee_hal.h"
 #include "event_logger.h"
+#include "spi_arbiter.h"
 #include "uartstdio.h"
 #include "priorities.h"
+#include "memory_budget.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -46,36 +49,89 @@
 
 //*****************************************************************************
 //
-//! The stack size for the logger task.
+//! The number of events that can wait in the LOGGER ring buffer. Must be a
+//! power of two so that the free running indexes wrap cleanly.
 //
 //*****************************************************************************
-#define LOGGERTASKSTACKSIZE        128         // Stack size in words
+#define LOGGER_RING_SIZE           64
 
 //*****************************************************************************
 //
-//! The size of items placed in the LOGGER message queue.
-//! Based on size of LOGGER_CODES.
+//! Number of bytes of log records held in RAM before they are written out.
+//! Records never cross a page and are flushed as soon as they complete an
+//! EEPROM page, so the stage only ever needs to hold one page.
 //
 //*****************************************************************************
-#define LOGGER_ITEM_SIZE           sizeof(LoggerCodes)
+#define LOGGER_STAGE_SIZE          EEPROM_PAGE_SIZE
 //*****************************************************************************
 //
-//! The number of items that can be placed in the LOGGER message queue.
+//! Maximum time in milliseconds that a log record may sit in RAM before the
+//! stage is flushed to EEPROM, regardless of fill level.
 //
 //*****************************************************************************
-#define LOGGER_QUEUE_SIZE          10
-
+#define LOGGER_FLUSH_TIMEOUT       2000
 
 //*****************************************************************************
 //
-//! Interval to pause the LOGGER task between loops to allow other, higher
-//! priority RTOS tasks to run for a while.
+//! Marks a ring buffer slot as carrying a payload byte in bits 8-15.
 //
 //*****************************************************************************
-#define LOGGER_TASK_DELAY        200
+#define LOGGER_RING_PAYLOAD        0x10000
 
-xQueueHandle g_pLoggerQueue;
 extern xSemaphoreHandle g_pUARTSemaphore;
+//*****************************************************************************
+//
+//! Ring buffer of events waiting for the LOGGER task. Bits 0-7 hold the
+//! LoggerCodes value, bits 8-15 the payload and bit 16 flags the payload as
+//! present. Any task or interrupt may add to LogRingHead, only the LOGGER task
+//! advances LogRingTail. Both indexes run free and are masked on access.
+//
+//*****************************************************************************
+static volatile uint32_t LogRing[LOGGER_RING_SIZE];
+static volatile uint32_t LogRingHead = 0;
+static volatile uint32_t LogRingTail = 0;
+//! Number of events discarded because the ring was full
+static volatile uint32_t LogRingDropped = 0;
+//*****************************************************************************
+//
+//! FreeRTOS mutex guarding the RAM log stage. The LOGGER task holds it while
+//! appending records and LoggerFlush() holds it while writing the stage out.
+//
+//*****************************************************************************
+static xSemaphoreHandle g_pLoggerStageSemaphore;
+
+//*****************************************************************************
+//
+//! RAM stage for log records that have not been written to EEPROM yet.
+//! LogStage[0] belongs at EEPROM address LogStageAddr and the stage never
+//! crosses an EEPROM page.
+//
+//*****************************************************************************
+static uint8_t LogStage[LOGGER_STAGE_SIZE];
+static uint32_t LogStageLength = 0;
+static uint32_t LogStageAddr = EEPROM_LOG_BASE;
+//! Tick count at which the oldest staged record was added
+static portTickType LogStageTime = 0;
+
+//*****************************************************************************
+//
+//! Sequence number that will be given to the next record written.
+//
+//*****************************************************************************
+static uint32_t LogNextSeq = 0;
+//*****************************************************************************
+//
+//! Tick count the delta of the next event record is measured from.
+//
+//*****************************************************************************
+static portTickType LogLastTick = 0;
+//*****************************************************************************
+//
+//! Set when the next event record must be preceded by a time mark. This is
+//! the case after every boot, since the tick count starts over.
+//
+//*****************************************************************************
+static bool LogNeedTimeMark = true;
 
 //*****************************************************************************
 //
@@ -87,8 +143,8 @@ uint32_t LogStatusFlags = 0x00;
 
 //*****************************************************************************
 //
-//! Next logical memory slot for a log entry. Initialized by default to the
-//! starting address allocated for log entries.
+//! Next logical memory slot for a log record. Recovered from the log itself
+//! by LoggerRecover() at boot.
 //
 //*****************************************************************************
 uint32_t NextLogSlot = EEPROM_LOG_BASE;
@@ -104,87 +160,366 @@ xTaskHandle LoggerTaskHandle;
 
 //*****************************************************************************
 //
-//! System logger for any enabled events. Uses a FreeRTOS queue to buffer events
-//! that needed to be placed as entries in the EEPROM. All logs start at
+//! Reads the record held in the given slot (0 - LOG_TOTAL_RECORDS - 1).
+//
+//*****************************************************************************
+static bool LoggerReadRecord(uint32_t slot, uint8_t *record)
+{
+	return EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_LOG_BASE + (slot * LOG_RECORD_SIZE), record, LOG_RECORD_SIZE);
+}
+
+//*****************************************************************************
+//
+//! Returns true if the record is the first record of a page written in the
+//! current format, i.e. a valid time mark.
+//
+//*****************************************************************************
+static bool LoggerIsPageStart(uint8_t *record)
+{
+	return (LogRecordValid(record) && (record[0] & LOG_RECORD_TIMEMARK));
+}
+
+//*****************************************************************************
+//
+//! Erases the log area and starts the log over. Sequence numbers carry on
+//! from where they were. The caller must hold g_pLoggerStageSemaphore or be
+//! running before the scheduler has started.
+//
+//*****************************************************************************
+static void LoggerEraseArea(void)
+{
+	uint32_t page;
+
+	for (page = 0; page < LOG_AREA_PAGES; page++) {
+		EEPROMPageErase(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_LOG_BASE + (page * EEPROM_PAGE_SIZE));
+	}
+	LogStageLength = 0;
+	NextLogSlot = EEPROM_LOG_BASE;
+	LogNeedTimeMark = true;
+}
+
+//*****************************************************************************
+//
+//! Writes the whole stage to EEPROM in one page write. A page is erased the
+//! first time it is written to on every pass around the log so that its
+//! unused records read back as empty. The caller must hold
+//! g_pLoggerStageSemaphore.
+//
+//*****************************************************************************
+static void LoggerWriteStage(void)
+{
+	if (LogStageLength == 0) {
+		return;
+	}
+
+	if ((LogStageAddr % EEPROM_PAGE_SIZE) == 0) {
+		EEPROMPageErase(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, LogStageAddr);
+	}
+
+	EEPROMBulkWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, LogStageAddr, LogStage, LogStageLength);
+
+	LogStageAddr += LogStageLength;
+	LogStageLength = 0;
+}
+
+//*****************************************************************************
+//
+//! Adds a single record to the RAM stage, gives it the next sequence number
+//! and writes the stage out once the EEPROM page it belongs to is full. The
+//! caller must hold g_pLoggerStageSemaphore.
+//
+//*****************************************************************************
+static void LoggerStageRecord(uint8_t *record)
+{
+	uint32_t pos;
+
+	if (LogStageLength == 0) {
+		LogStageAddr = NextLogSlot;
+		LogStageTime = xTaskGetTickCount();
+	}
+
+	record[1] = ((LogNextSeq >> 16) & 0xFF);
+	record[2] = ((LogNextSeq >> 8) & 0xFF);
+	record[3] = ((LogNextSeq) & 0xFF);
+	LogNextSeq = (LogNextSeq + 1) & LOG_SEQ_MASK;
+
+	for (pos = 0; pos < LOG_RECORD_SIZE; pos++) {
+		LogStage[LogStageLength++] = record[pos];
+	}
+	NextLogSlot += LOG_RECORD_SIZE;
+
+	if ((NextLogSlot % EEPROM_PAGE_SIZE) == 0) {
+		//Page complete, write it out and move to the next one
+		LoggerWriteStage();
+		if (NextLogSlot >= (EEPROM_LOG_BASE + LOG_AREA_SIZE)) {
+			NextLogSlot = EEPROM_LOG_BASE;
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Builds the record(s) for a single event and adds them to the stage. A time
+//! mark carrying the absolute tick count is put in front of the event if this
+//! is the first record of a page, the first record since boot, or if the time
+//! since the previous record does not fit in the 16-bit delta. The caller must
+//! hold g_pLoggerStageSemaphore.
+//
+//*****************************************************************************
+static void LoggerStageEvent(uint32_t event, portTickType tick)
+{
+	uint8_t record[LOG_RECORD_SIZE];
+	portTickType delta = tick - LogLastTick;
+
+	//A mark that lands in the last slot of a page is followed by the next page's own mark
+	while (LogNeedTimeMark || (NextLogSlot % EEPROM_PAGE_SIZE) == 0 || delta > 0xFFFF) {
+		record[0] = LOG_RECORD_VALID | (LOG_FORMAT_VERSION << 4) | LOG_RECORD_TIMEMARK;
+		record[4] = ((tick >> 24) & 0xFF);
+		record[5] = ((tick >> 16) & 0xFF);
+		record[6] = ((tick >> 8) & 0xFF);
+		record[7] = ((tick) & 0xFF);
+		LoggerStageRecord(record);
+		LogNeedTimeMark = false;
+		delta = 0;
+	}
+
+	record[0] = LOG_RECORD_VALID | (LOG_FORMAT_VERSION << 4) | ((event & LOGGER_RING_PAYLOAD) ? LOG_RECORD_PAYLOAD : 0);
+	record[4] = ((delta >> 8) & 0xFF);
+	record[5] = ((delta) & 0xFF);
+	record[6] = (event & 0xFF);
+	record[7] = ((event >> 8) & 0xFF);
+	LoggerStageRecord(record);
+
+	LogLastTick = tick;
+}
+
+//*****************************************************************************
+//
+//! Writes any log records still held in RAM to EEPROM.
+//
+//*****************************************************************************
+void LoggerFlush(void)
+{
+	if (g_pLoggerStageSemaphore == NULL) {
+		return;
+	}
+
+	xSemaphoreTake(g_pLoggerStageSemaphore, portMAX_DELAY);
+	LoggerWriteStage();
+	xSemaphoreGive(g_pLoggerStageSemaphore);
+}
+
+//*****************************************************************************
+//
+//! Erases every log record, in RAM and in EEPROM.
+//
+//*****************************************************************************
+void LoggerClear(void)
+{
+	if (g_pLoggerStageSemaphore != NULL) {
+		xSemaphoreTake(g_pLoggerStageSemaphore, portMAX_DELAY);
+	}
+	LoggerEraseArea();
+	if (g_pLoggerStageSemaphore != NULL) {
+		xSemaphoreGive(g_pLoggerStageSemaphore);
+	}
+}
+
+//*****************************************************************************
+//
+//! Finds the newest record in the log and sets NextLogSlot and the next
+//! sequence number from it. Every page starts with a time mark and sequence
+//! numbers increase around the ring, so the newest page is found with a binary
+//! search over the first record of each page and the newest record with a
+//! binary search inside that page. If the first page does not hold a record
+//! in the current format the log area is erased.
+//
+//*****************************************************************************
+void LoggerRecover(void)
+{
+	uint8_t first[LOG_RECORD_SIZE];
+	uint8_t probe[LOG_RECORD_SIZE];
+	uint32_t seq0, lo, hi, mid;
+	uint32_t head_page, head_seq, count;
+
+	LoggerReadRecord(0, first);
+	if (!LoggerIsPageStart(first)) {
+		//Empty log or one left behind by an older firmware version
+		LoggerEraseArea();
+		LogNextSeq = 0;
+		return;
+	}
+	seq0 = LogRecordSeq(first);
+
+	//Newest page is the last one whose first sequence number is not older than page 0's
+	lo = 0;
+	hi = LOG_AREA_PAGES - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		LoggerReadRecord(mid * LOG_RECORDS_PER_PAGE, probe);
+		if (LoggerIsPageStart(probe) && (((LogRecordSeq(probe) - seq0) & LOG_SEQ_MASK) < (LOG_SEQ_MASK / 2))) {
+			lo = mid;
+		}
+		else {
+			hi = mid - 1;
+		}
+	}
+	head_page = lo;
+	LoggerReadRecord(head_page * LOG_RECORDS_PER_PAGE, probe);
+	head_seq = LogRecordSeq(probe);
+
+	//Records in a page are contiguous from its time mark, the page was erased before its first write
+	lo = 0;
+	hi = LOG_RECORDS_PER_PAGE - 1;
+	while (lo < hi) {
+		mid = (lo + hi + 1) / 2;
+		LoggerReadRecord((head_page * LOG_RECORDS_PER_PAGE) + mid, probe);
+		if (LogRecordValid(probe) && LogRecordSeq(probe) == ((head_seq + mid) & LOG_SEQ_MASK)) {
+			lo = mid;
+		}
+		else {
+			hi = mid - 1;
+		}
+	}
+	count = lo + 1;
+
+	NextLogSlot = EEPROM_LOG_BASE + (head_page * EEPROM_PAGE_SIZE) + (count * LOG_RECORD_SIZE);
+	if (NextLogSlot >= (EEPROM_LOG_BASE + LOG_AREA_SIZE)) {
+		NextLogSlot = EEPROM_LOG_BASE;
+	}
+	LogNextSeq = (head_seq + count) & LOG_SEQ_MASK;
+	LogNeedTimeMark = true;
+}
+
+//*****************************************************************************
+//
+//! Reports which records are currently held in the log. The oldest page is
+//! the one that will be overwritten next, if it has been written before, and
+//! the first page otherwise.
+//
+//*****************************************************************************
+bool LoggerGetBounds(uint32_t *oldest_seq, uint32_t *oldest_slot, uint32_t *next_seq)
+{
+	uint8_t record[LOG_RECORD_SIZE];
+	uint32_t next_slot = (NextLogSlot - EEPROM_LOG_BASE) / LOG_RECORD_SIZE;
+	uint32_t page = next_slot / LOG_RECORDS_PER_PAGE;
+
+	if ((next_slot % LOG_RECORDS_PER_PAGE) != 0) {
+		page = (page + 1) % LOG_AREA_PAGES;
+	}
+
+	*next_seq = LogNextSeq;
+
+	if (!LoggerReadRecord(page * LOG_RECORDS_PER_PAGE, record)) {
+		return false;
+	}
+	if (!LoggerIsPageStart(record)) {
+		page = 0;
+		if (!LoggerReadRecord(0, record)) {
+			return false;
+		}
+		if (!LoggerIsPageStart(record)) {
+			//Nothing has been logged yet
+			*oldest_seq = LogNextSeq;
+			*oldest_slot = next_slot;
+			return true;
+		}
+	}
+
+	*oldest_seq = LogRecordSeq(record);
+	*oldest_slot = page * LOG_RECORDS_PER_PAGE;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! System logger for any enabled events. Uses a ring buffer to hold events
+//! that needed to be placed as records in the EEPROM. All logs start at
 //! EEPROM_LOG_BASE specified by developer in freertos_init.h <br>
 //!
-//! Log entries consist of the following: <br>
-//! 32-bits = FreeRTOS Task Time <br>
-//! 8-bits = Log Entry Type <br>
+//! The task sleeps until LogItemEEPROM() notifies it that the ring is no
+//! longer empty, then drains the ring completely into a RAM stage. The stage
+//! is written out one EEPROM page at a time as pages fill, or all at once
+//! after LOGGER_FLUSH_TIMEOUT milliseconds or when LoggerFlush() is called.
+//! While nothing is staged the task blocks indefinitely.
+//!
+//! Log records are LOG_RECORD_SIZE bytes, see event_logger.h for the layout.
 //!
 //! (Max number of log types limited by LogStatusFlags [32 types])
 //
 //*****************************************************************************
 static void LoggerTask(void *pvParameters)
 {
-    portTickType ui32WakeTime;
-    uint32_t ui32LOGGERToggleDelay;
-    LoggerCodes code_issued;
-    LoggerCodes last_code_issued;
+    portTickType ui32WaitTime;
+    portTickType ui32Elapsed;
+    uint32_t event_issued;
+    uint32_t last_event_issued = 0xFFFFFFFF;
 
-    ui32LOGGERToggleDelay = LOGGER_TASK_DELAY;
+    //Log pages are written in the background, any other transaction may go first
+    SPIArbiterSetPriority(SPIPriorityBackground);
 
-    //
-    // Get the current tick count.
-    //
-    ui32WakeTime = xTaskGetTickCount();
     //
     // Loop forever.
     //
     while(1)
     {
+        xSemaphoreTake(g_pLoggerStageSemaphore, portMAX_DELAY);
         //
-        // Read the next message, if available on queue.
+        // Drain every event currently in the ring.
         //
-        if(xQueueReceive(g_pLoggerQueue, &code_issued, 0) == pdPASS)
+        while(LogRingTail != LogRingHead)
         {
+        	event_issued = LogRing[LogRingTail & (LOGGER_RING_SIZE - 1)];
+        	LogRingTail++;
+
         	//Is this log entry type enabled?
-        	if ((LogStatusFlags >> code_issued) & 1) {
+        	if ((LogStatusFlags >> (event_issued & 0xFF)) & 1) {
 
         		//Only log unique events
-        		if (code_issued != last_code_issued) {
-					int eeprom_sector = 0;
-					//Get RTOS system time since vTaskStartScheduler()
-					TickType_t RTOSTime = xTaskGetTickCount();
-					uint8_t LogTime[4] = {((RTOSTime >> 24) & 0xFF), ((RTOSTime >> 16) & 0xFF), ((RTOSTime >> 8) & 0xFF), ((RTOSTime) & 0xFF)};
-
-					//Write FreeRTOS system time to EEPROM
-					for (eeprom_sector = 0; eeprom_sector < 4; eeprom_sector++) {
-						EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(NextLogSlot + eeprom_sector), LogTime[eeprom_sector]);
-					}
-					//Write Log Message to EEPROM
-					EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, NextLogSlot + eeprom_sector, code_issued);
-					if (((NextLogSlot + 5) > EEPROM_LOG_BASE + MAX_LOG_ENTRIES)) {
-						NextLogSlot = EEPROM_LOG_BASE;
-					}
-					else {
-						//Each log takes five sectors.
-						NextLogSlot += 5;
-					}
-					//Hold the last code logged so that we are wasting space logging concurrent writes.
-					last_code_issued = code_issued;
+        		if (event_issued != last_event_issued) {
+					//Stamp with RTOS system time since vTaskStartScheduler()
+					LoggerStageEvent(event_issued, xTaskGetTickCount());
+					//Hold the last event logged so that we are wasting space logging concurrent writes.
+					last_event_issued = event_issued;
         		}
         	}
         }
-        vTaskDelayUntil(&ui32WakeTime, ui32LOGGERToggleDelay / portTICK_RATE_MS);
+        //Write out a partial page once its oldest record has waited long enough
+        ui32WaitTime = portMAX_DELAY;
+        if (LogStageLength > 0) {
+        	ui32Elapsed = xTaskGetTickCount() - LogStageTime;
+        	if (ui32Elapsed >= (LOGGER_FLUSH_TIMEOUT / portTICK_RATE_MS)) {
+        		LoggerWriteStage();
+        	}
+        	else {
+        		ui32WaitTime = (LOGGER_FLUSH_TIMEOUT / portTICK_RATE_MS) - ui32Elapsed;
+        	}
+        }
+        xSemaphoreGive(g_pLoggerStageSemaphore);
+
+        //Sleep until new events arrive or the staged records are due
+        ulTaskNotifyTake(pdTRUE, ui32WaitTime);
     }
 }
 
 //*****************************************************************************
 //
-//! Initializes the EEPROM LOGGER task.
+//! Initializes the EEPROM LOGGER task. Must be called before the scheduler
+//! is started since the head of the log is recovered from EEPROM here.
 //
 //*****************************************************************************
 uint32_t LoggerTaskInit(void)
 {
 
-    g_pLoggerQueue = xQueueCreate(LOGGER_QUEUE_SIZE, LOGGER_ITEM_SIZE);
+    LoggerRecover();
+    g_pLoggerStageSemaphore = xSemaphoreCreateMutex();
 
     //
-    // Create the LED task.
+    // Create the LOGGER task.
     //
-    if(xTaskCreate(LoggerTask, (const portCHAR *)"LOGGER", LOGGERTASKSTACKSIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_LOGGER_TASK, &LoggerTaskHandle) != pdTRUE)
+    LoggerTaskHandle = MemoryTaskCreate(LoggerTask, "LOGGER", LOGGERTASKSTACKSIZE,
+                   tskIDLE_PRIORITY + PRIORITY_LOGGER_TASK);
+    if(LoggerTaskHandle == NULL)
     {
         return(1);
     }
@@ -194,19 +529,109 @@ uint32_t LoggerTaskInit(void)
     return(0);
 }
 
+//*****************************************************************************
+//
+//! Adds an event to the ring buffer and wakes the LOGGER task if the ring was
+//! empty. Shared by LogItemEEPROM() and LogItemEEPROMData().
+//
+//*****************************************************************************
+static void LoggerPostEvent(uint32_t event)
+{
+	uint32_t ui32Mask;
+	bool was_empty = false;
+	bool in_isr;
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+
+	//Cheapest check first, most calls come from the HAL with their types disabled
+	if (!((LogStatusFlags >> (event & 0xFF)) & 1) || LoggerTaskHandle == NULL) {
+		return;
+	}
+
+	in_isr = ((HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M) != 0);
+
+	//Entries caused by the logger writing its own pages would keep it awake forever
+	if (!in_isr && xTaskGetCurrentTaskHandle() == LoggerTaskHandle) {
+		return;
+	}
+
+	//Reserving a slot only needs BASEPRI raised for a few instructions
+	ui32Mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	if ((LogRingHead - LogRingTail) < LOGGER_RING_SIZE) {
+		was_empty = (LogRingHead == LogRingTail);
+		LogRing[LogRingHead & (LOGGER_RING_SIZE - 1)] = event;
+		LogRingHead++;
+	}
+	else {
+		LogRingDropped++;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(ui32Mask);
+
+	//Before the scheduler starts the task drains the ring on its first run
+	if (!was_empty || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+		return;
+	}
+
+	if (in_isr) {
+		vTaskNotifyGiveFromISR(LoggerTaskHandle, &xHigherPriorityTaskWoken);
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+	else {
+		xTaskNotifyGive(LoggerTaskHandle);
+	}
+}
+
 //*****************************************************************************
 //
 //! Log Item EEPROM
 //! \brief Takes the LoggerCode passed as "code" and places it in the LOGGER
-//! task queue if the task is running. Otherwise, this entry is discarded.
+//! task ring buffer if the task exists and this type of entry is enabled.
+//! Otherwise, this entry is discarded.
+//!
+//! Safe to call from tasks and from interrupt handlers running at or below
+//! configMAX_SYSCALL_INTERRUPT_PRIORITY. Disabled entry types return before
+//! any RTOS call is made, and the LOGGER task is only notified when the ring
+//! goes from empty to non-empty.
 //!
 //! \param code The LoggerCodes value to place in the next logical memory slot
 //! for a log.
 //
 //*****************************************************************************
 void LogItemEEPROM(LoggerCodes code) {
-    if ((eTaskGetState(LoggerTaskHandle) == eReady || eTaskGetState(LoggerTaskHandle) == eRunning || eTaskGetState(LoggerTaskHandle) == eBlocked) && (LoggerTaskHandle != 0)) {
-    	xQueueSend(g_pLoggerQueue,&code,0);
-    }
+	LoggerPostEvent((uint32_t)code & 0xFF);
+}
+
+//*****************************************************************************
+//
+//! Log Item EEPROM With Data
+//! \brief Same as LogItemEEPROM() but stores a one byte payload (register
+//! address, port, user index...) alongside the event.
+//!
+//! \param code The LoggerCodes value to place in the next logical memory slot
+//! for a log.
+//! \param data The payload to store with the entry
+//
+//*****************************************************************************
+void LogItemEEPROMData(LoggerCodes code, uint8_t data) {
+	LoggerPostEvent(((uint32_t)code & 0xFF) | ((uint32_t)data << 8) | LOGGER_RING_PAYLOAD);
+}
+
+//*****************************************************************************
+//
+//! Returns the number of events waiting in the ring buffer that the LOGGER
+//! task has not picked up yet.
+//
+//*****************************************************************************
+uint32_t LoggerPendingItems(void)
+{
+	return (LogRingHead - LogRingTail);
 }
 
+//*****************************************************************************
+//
+//! Returns the sequence number the next log record will be given.
+//
+//*****************************************************************************
+uint32_t LoggerNextSequence(void)
+{
+	return LogNextSeq;
+}
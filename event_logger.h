@@ -29,6 +29,7 @@
 #include <stdbool.h>
 #include "FreeRTOS.h"
 #include "task.h"
+#include "eee_hal.h"
 
 //*****************************************************************************
 //
@@ -42,14 +43,44 @@
 #define MAX_LOG_TYPES 			32
 //*****************************************************************************
 //
-//! Maximum number of log entries that can be placed in EEPROM. Since the EEPROM
-//! log is placed at after all other values placed in EEPROM, this value can be
-//! increased if necessary. However, it is HIGHLY RECOMMENDED that this value
-//! is not increased past 2000, as the system would need to read 10,000 sectors
-//! (2000 entries * 5 sectors/entry) to print the entire contents of the log.
+//! Number of EEPROM pages reserved for the log, starting at EEPROM_LOG_BASE.
+//! The log is a ring of fixed size records, a page is erased the first time
+//! it is written to on each pass around the ring.
 //
 //*****************************************************************************
-#define MAX_LOG_ENTRIES			400
+#define LOG_AREA_PAGES			8
+#define LOG_AREA_SIZE			(LOG_AREA_PAGES * EEPROM_PAGE_SIZE)
+//*****************************************************************************
+//
+//! Size of a single log record in sectors. Records are aligned so that a
+//! page always holds a whole number of them. <br>
+//!
+//! Byte 0 = flags (LOG_RECORD_VALID, format version in bits 4-6,
+//! LOG_RECORD_TIMEMARK, LOG_RECORD_PAYLOAD) <br>
+//! Bytes 1-3 = 24-bit sequence number, big endian <br>
+//! Event record: bytes 4-5 = ticks since the previous record, byte 6 =
+//! LoggerCodes value, byte 7 = payload <br>
+//! Time mark: bytes 4-7 = absolute FreeRTOS tick count <br>
+//!
+//! Every page starts with a time mark so any page can be decoded on its own.
+//
+//*****************************************************************************
+#define LOG_RECORD_SIZE			8
+#define LOG_RECORDS_PER_PAGE	(EEPROM_PAGE_SIZE / LOG_RECORD_SIZE)
+#define LOG_TOTAL_RECORDS		(LOG_AREA_PAGES * LOG_RECORDS_PER_PAGE)
+#define LOG_SEQ_MASK			0xFFFFFF
+#define LOG_FORMAT_VERSION		1
+#define LOG_RECORD_VALID		0x80
+#define LOG_RECORD_TIMEMARK		0x02
+#define LOG_RECORD_PAYLOAD		0x01
+
+//*****************************************************************************
+//
+//! Helpers for decoding a raw log record.
+//
+//*****************************************************************************
+#define LogRecordValid(rec)		(((rec)[0] & 0xF0) == (LOG_RECORD_VALID | (LOG_FORMAT_VERSION << 4)))
+#define LogRecordSeq(rec)		(((uint32_t)(rec)[1] << 16) | ((uint32_t)(rec)[2] << 8) | (uint32_t)(rec)[3])
 
 //*****************************************************************************
 //
@@ -87,13 +118,12 @@ typedef enum {
 
 //*****************************************************************************
 //
-//! System logger for any enabled events. Uses a FreeRTOS queue to buffer events
-//! that needed to be placed as entries in the EEPROM. All logs start at
+//! System logger for any enabled events. Uses a ring buffer to hold events
+//! that needed to be placed as records in the EEPROM. All logs start at
 //! EEPROM_LOG_BASE specified by developer in freertos_init.h <br>
 //!
-//! Log entries consist of the following: <br>
-//! 32-bits = FreeRTOS Task Time <br>
-//! 8-bits = Log Entry Type <br>
+//! Log records are LOG_RECORD_SIZE bytes, see LOG_RECORD_SIZE for the layout.
+//! Must be called before the scheduler is started.
 //!
 //! (Max number of log types limited by LogStatusFlags [32 types])
 //
@@ -104,10 +134,11 @@ extern uint32_t LoggerTaskInit(void);
 //
 //! Log Item EEPROM
 //! \brief Takes the LoggerCode passed as "code" and places it in the LOGGER
-//! task queue if the task is running. Otherwise, this entry is discarded.
+//! task ring buffer if the task exists and this type of entry is enabled.
+//! Otherwise, this entry is discarded.
 //!
 //! This function should be used anywhere in the firmware where an event should
-//! be logged to the EEPROM
+//! be logged to the EEPROM. It may be called from interrupt handlers.
 //!
 //! \param code The LoggerCodes value to place in the next logical memory slot
 //! for a log.
@@ -115,6 +146,82 @@ extern uint32_t LoggerTaskInit(void);
 //*****************************************************************************
 extern void LogItemEEPROM(LoggerCodes code);
 
+//*****************************************************************************
+//
+//! Log Item EEPROM With Data
+//! \brief Same as LogItemEEPROM() but stores a one byte payload (register
+//! address, port, user index...) with the entry. Entries with the same code
+//! but different payloads are not merged.
+//!
+//! \param code The LoggerCodes value to place in the next logical memory slot
+//! for a log.
+//! \param data The payload to store with the entry
+//
+//*****************************************************************************
+extern void LogItemEEPROMData(LoggerCodes code, uint8_t data);
+
+//*****************************************************************************
+//
+//! Logger Flush
+//! \brief Writes any log entries the LOGGER task is still holding in RAM to
+//! the EEPROM. Call this before resetting the system or before reading the
+//! log back so that no entries are lost or missed.
+//
+//*****************************************************************************
+extern void LoggerFlush(void);
+
+//*****************************************************************************
+//
+//! Logger Pending Items
+//! \brief Returns the number of LoggerCodes waiting in the ring buffer that
+//! the LOGGER task has not picked up yet.
+//
+//*****************************************************************************
+extern uint32_t LoggerPendingItems(void);
+
+//*****************************************************************************
+//
+//! Logger Clear
+//! \brief Discards any staged log records and erases the log area. Sequence
+//! numbers continue from where they were.
+//
+//*****************************************************************************
+extern void LoggerClear(void);
+
+//*****************************************************************************
+//
+//! Logger Recover
+//! \brief Locates the newest record in the EEPROM log and restores
+//! NextLogSlot and the sequence counter from it. Erases the log area if it
+//! does not hold records in the current format. Called by LoggerTaskInit().
+//
+//*****************************************************************************
+extern void LoggerRecover(void);
+
+//*****************************************************************************
+//
+//! Logger Get Bounds
+//! \brief Reports the records currently held in the log.
+//!
+//! \param oldest_seq Returns the sequence number of the oldest record
+//! \param oldest_slot Returns the record slot (0 - LOG_TOTAL_RECORDS - 1) of
+//! the oldest record
+//! \param next_seq Returns the sequence number the next record will be given.
+//! The log is empty if this equals oldest_seq.
+//!
+//! \return Returns true if the log could be read, otherwise false.
+//
+//*****************************************************************************
+extern bool LoggerGetBounds(uint32_t *oldest_seq, uint32_t *oldest_slot, uint32_t *next_seq);
+
+//*****************************************************************************
+//
+//! Logger Next Sequence
+//! \brief Returns the sequence number the next log record will be given.
+//
+//*****************************************************************************
+extern uint32_t LoggerNextSequence(void);
+
 
 //*****************************************************************************
 //
@@ -134,7 +241,7 @@ static char *LogTypes[MAX_LOG_TYPES] = {"System Restarted", "Stack Overflow", "E
 extern uint32_t LogStatusFlags;
 //*****************************************************************************
 //
-//! Next logical slot for EEPROM log entries
+//! Next logical slot (EEPROM address) for EEPROM log records
 //
 //*****************************************************************************
 extern uint32_t NextLogSlot;
@@ -40,12 +40,23 @@
 #include "sysctl.h"
 #include "uart.h"
 #include "interrupt.h"
-#include "uartstdio.h"
 #include "led_manager.h"
 #include "interpreter_task.h"
 #include "event_logger.h"
 #include "port_monitor_task.h"
 #include "i2c_task.h"
+#include "config_store.h"
+#include "vlan_table.h"
+#include "boot_task.h"
+#include "mac_table.h"
+#include "mib_counters.h"
+#include "cable_diag.h"
+#include "perf_stats.h"
+#include "spi_clock.h"
+#include "spi_arbiter.h"
+#include "layer_sync.h"
+#include "memory_budget.h"
+#include "console.h"
 #include "freertos_init.h"
 #include "FreeRTOS.h"
 #include "task.h"
@@ -55,7 +66,8 @@
 
 //*****************************************************************************
 //
-// The mutex that protects concurrent access of UART/SSI from multiple tasks.
+// The mutex that protects concurrent access of the UART from multiple tasks.
+// The SSI ports are owned by the SPI bus arbiter (see spi_arbiter.h).
 //
 //*****************************************************************************
 
@@ -67,31 +79,6 @@
 //
 //*****************************************************************************
 xSemaphoreHandle g_pUARTSemaphore;
-//*****************************************************************************
-//
-//! Mutex to control and block access to the SSI0 [EEPROM] RX and TX buffers.
-//! Prevents multiple FreeRTOS tasks from interacting with this interface at
-//! the same time.
-//
-//*****************************************************************************
-xSemaphoreHandle g_pSPI0Semaphore;
-//*****************************************************************************
-//
-//! Mutex to control and block access to the SSI0 [Ethernet Controller] RX and
-//! TX buffers. Prevents multiple FreeRTOS tasks from interacting with this
-//! interface at the same time.
-//
-//*****************************************************************************
-xSemaphoreHandle g_pSPI1Semaphore;
-//*****************************************************************************
-//
-//! Mutex to control and block access to the I2C RX and TX buffers.
-//! Prevents multiple FreeRTOS tasks from interacting with this
-//! interface at the same time.
-//
-//*****************************************************************************
-xSemaphoreHandle g_pI2CSemaphore;
-
 //*****************************************************************************
 //
 //! External handle to the LED task Queue.
@@ -100,16 +87,11 @@ xSemaphoreHandle g_pI2CSemaphore;
 extern xQueueHandle g_pLEDQueue;
 //*****************************************************************************
 //
-//! External handle to the I2C task Queue.
-//
-//*****************************************************************************
-extern xQueueHandle g_pI2CQueue;
-//*****************************************************************************
-//
-//! External handle to the EEPROM System Logger task Queue.
+//! Buffer used during boot to hold one EEPROM page read with EEPROMBulkRead.
+//! Kept off the stack since InitializeEEPROM runs before the scheduler starts.
 //
 //*****************************************************************************
-extern xQueueHandle g_pLoggerQueue;
+static uint8_t BootPageBuffer[EEPROM_PAGE_SIZE];
 //*****************************************************************************
 //
 // The error routine that is called if the driver library encounters an error.
@@ -151,10 +133,11 @@ bool UsePasswordMask = false;
 //*****************************************************************************
 //
 //! Global Variable to enable/disable the ability of the UART interpreter to
-//! receive input from the CLI.
+//! receive input from the CLI. Kept for the UART standard I/O library, whose
+//! receive path is no longer used: lines are assembled by console.c.
 //
 //*****************************************************************************
-bool UARTInterpreterEnabled = true;
+bool UARTInterpreterEnabled = false;
 
 
 //*****************************************************************************
@@ -213,16 +196,13 @@ vApplicationStackOverflowHook(xTaskHandle *pxTask, char *pcTaskName)
 	eTaskState task_state = eTaskGetState(&pxTask);
 
 	//Display this information to the user.
-	UARTprintf("Task encountered a stack overflow error: \n\tTask Name: %s\n\tTask State: %s\n\tCalling Task: %s", task_name, TASK_STATES[task_state],calling_task_name);
+	ConsolePrintf("Task encountered a stack overflow error: \n\tTask Name: %s\n\tTask State: %s\n\tCalling Task: %s", task_name, TASK_STATES[task_state],calling_task_name);
 
 	uint32_t taskDelay = LONG_RUNNING_TASK_DLY;
 	uint32_t currentTime;
 
-    if (eTaskGetState(LoggerTaskHandle) == eReady || eTaskGetState(LoggerTaskHandle) == eRunning || eTaskGetState(LoggerTaskHandle) == eBlocked) {
-    	LoggerCodes StackOverflow_Exception = StackOverflow;
-    	xQueueSend(g_pLoggerQueue,&StackOverflow_Exception,0);
-    }
-    while (uxQueueMessagesWaiting(g_pLoggerQueue)) {
+    LogItemEEPROM(StackOverflow);
+    while (LoggerPendingItems()) {
     	currentTime = xTaskGetTickCount();
     	vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
     }
@@ -245,39 +225,39 @@ vApplicationStackOverflowHook(xTaskHandle *pxTask, char *pcTaskName)
 //*****************************************************************************
 void ShowDebugInformation() {
     //Print initialization text to the commmand prompt window
-	UARTprintf("\033[8;45;100t\n");
-    UARTprintf("\033[2J\n[Console Mode]: Operating in VT100/ASCII Mode\n");
-    UARTprintf("[Auto]: Set Window Size to 100x45\n");
-    UARTprintf("\nEagle Embedded Engineering 100BaseTX Switch Configuration Interface\n");
+	ConsolePrintfWait("\033[8;45;100t\n");
+    ConsolePrintfWait("\033[2J\n[Console Mode]: Operating in VT100/ASCII Mode\n");
+    ConsolePrintfWait("[Auto]: Set Window Size to 100x45\n");
+    ConsolePrintfWait("\nEagle Embedded Engineering 100BaseTX Switch Configuration Interface\n");
 
     //Test and verify operation of EEPROM
-    UARTprintf("[BOOTING]: Testing EEPROM:");
+    ConsolePrintfWait("[BOOTING]: Testing EEPROM:");
     if (EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, 0x00000001, 0x19)) {
-    	UARTprintf(" \033[30;42mPASSED!\033[0m\n");
+    	ConsolePrintfWait(" \033[30;42mPASSED!\033[0m\n");
     }
     else {
-    	UARTprintf(" \033[30;41mFAILED!\033[0m\n");
+    	ConsolePrintfWait(" \033[30;41mFAILED!\033[0m\n");
     }
 
     //Test and verify operation of Ethernet Controllers
-    UARTprintf("[BOOTING]: Testing Ethernet Controller:");
+    ConsolePrintfWait("[BOOTING]: Testing Ethernet Controller:");
     if (EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,0x01) > 0) {
-    	UARTprintf(" \033[30;42mPASSED!\033[0m\n");
+    	ConsolePrintfWait(" \033[30;42mPASSED!\033[0m\n");
     }
     else {
-    	UARTprintf(" \033[30;41mFAILED!\033[0m\n");
+    	ConsolePrintfWait(" \033[30;41mFAILED!\033[0m\n");
     }
 
 
-    UARTprintf("\n-----------------------------------------\n");
-    UARTprintf(  "|  (c) 2016 Eagle Embedded Engineering  |\n");
-    UARTprintf(  "|       MISL Ethernet Switch Layer      |\n");
-    UARTprintf(  "|            Firmware v%d.%d.%d           |\n", MAJOR_VERSION, MINOR_VERSION, REVISION);
-    UARTprintf(  "-----------------------------------------\n");
-    UARTprintf(  "-----------------------------------------\n");
-    UARTprintf(  "|      Enter commands one at a time     |\n");
-    UARTprintf(  "| followed by a single carriage return  |\n");
-    UARTprintf(  "-----------------------------------------\n\n");
+    ConsolePrintfWait("\n-----------------------------------------\n");
+    ConsolePrintfWait(  "|  (c) 2016 Eagle Embedded Engineering  |\n");
+    ConsolePrintfWait(  "|       MISL Ethernet Switch Layer      |\n");
+    ConsolePrintfWait(  "|            Firmware v%d.%d.%d           |\n", MAJOR_VERSION, MINOR_VERSION, REVISION);
+    ConsolePrintfWait(  "-----------------------------------------\n");
+    ConsolePrintfWait(  "-----------------------------------------\n");
+    ConsolePrintfWait(  "|      Enter commands one at a time     |\n");
+    ConsolePrintfWait(  "| followed by a single carriage return  |\n");
+    ConsolePrintfWait(  "-----------------------------------------\n\n");
 
 }
 
@@ -313,12 +293,12 @@ DTSTriggered(void)
 
 
 	 //[TODO]: Write routine to send test characters that only a windows application would see over a console
-	 UARTFlushRx();
-	 UARTFlushTx(true);
-	 UARTprintf("EEE\n");
+	 ConsoleFlushFromISR();
+	 ConsoleFlushTx(true);
+	 ConsolePrintfFromISR("EEE\n");
 	 //Wait for short period for Windows App to process characters
 	 delayMs(50);
-	 UARTEchoSet(false);
+	 ConsoleEchoSet(false);
      while(UARTCharsAvail(UART1_BASE) != false) {
     	 if (i < 20) {
     	 AuthString[i] = UARTCharGetNonBlocking(UART1_BASE);
@@ -327,7 +307,7 @@ DTSTriggered(void)
      }
 
 	 if (strcmp(AuthString,"EEEWinApp2016") == 0) {
-		 UARTprintf("WinAppModeActivated\n");
+		 ConsolePrintfFromISR("WinAppModeActivated\n");
 		 ConsoleMode = false;
 	 }
 	 else {
@@ -336,7 +316,7 @@ DTSTriggered(void)
 
 
 	 if (ConsoleMode) {
-		UARTEchoSet(true);
+		ConsoleEchoSet(true);
 		Authenticated = false;
 
 	 }
@@ -354,7 +334,7 @@ DTSTriggered(void)
 			 // Error. The queue should never be full. If so print the
 			 // error message on UART and wait for ever.
 			 //
-			 UARTprintf("\nQueue full. This should never happen.\n");
+			 ConsolePrintfFromISR("\nQueue full. This should never happen.\n");
 			 while(1)
 			 {
 			 }
@@ -366,8 +346,8 @@ DTSTriggered(void)
 	GPIOIntTypeSet(GPIO_PORTD_BASE, GPIO_PIN_6, GPIO_RISING_EDGE);
 	GPIOIntEnable(GPIO_PORTD_BASE, GPIO_PIN_6);
 
-	UARTFlushTx(true);
-	UARTprintf("\n\n=== AUTHENTICATION REQUIRED ===\nUsername: ");
+	ConsoleFlushTx(true);
+	ConsolePrintfFromISR("\n\n=== AUTHENTICATION REQUIRED ===\nUsername: ");
 
 }
 
@@ -413,7 +393,7 @@ void DTSOFF(void)
 
 //*****************************************************************************
 //
-//! Configure the UART and its pins.  This must be called before UARTprintf().
+//! Configure the UART and its pins.  This must be called before ConsolePrintf().
 //!
 //! \return Returns void
 //
@@ -430,7 +410,6 @@ ConfigureUART(void)
     // Enable UART0
     //
     ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_UART1);
-    UARTEchoSet(true);
     //
     // Configure GPIO Pins for UART mode.
     //
@@ -444,9 +423,10 @@ ConfigureUART(void)
     UARTClockSourceSet(UART1_BASE, UART_CLOCK_PIOSC);
 
     //
-    // Initialize the UART for console I/O.
+    // Initialize the UART for console I/O. Received characters are assembled
+    // into lines by the console interrupt handler.
     //
-    UARTStdioConfig(1, 115200, 16000000);
+    ConsoleInit(16000000);
     ///
     /// SETUP THE DATA TERMINAL READY (DTS) PIN DETECTION
     /// This will tell the microcontroller when the user opens a valid console connection. Pin B4 should be tied to the DTS pin
@@ -478,8 +458,8 @@ void ConfigureSSI(void) {
 
 	ROM_SysCtlPeripheralEnable(ETHO_1_SYS_PORT_BASE);
 	ROM_SysCtlPeripheralEnable(ETHO_1_SYS_BASE);
-
-
+
+
 
 	//
 	// Configure GPIO Pins for SPI Mode [Using SSI0]
@@ -502,7 +482,7 @@ void ConfigureSSI(void) {
     GPIOPinTypeSSI(EEPROM_SSI_CS_BASE, EEPROM_SSI_CLK_PIN | EEPROM_SSI_RX_PIN | EEPROM_SSI_TX_PIN);
 
     SSIConfigSetExpClk(EEPROM_BASE_ADDR, SysCtlClockGet(), SSI_FRF_MOTO_MODE_0,
-                       SSI_MODE_MASTER, 1000000, 8);
+                       SSI_MODE_MASTER, SPI_CLOCK_EEPROM_DEFAULT, 8);
     SSIEnable(EEPROM_BASE_ADDR);
 	//*************************************************
 	//
@@ -523,7 +503,7 @@ void ConfigureSSI(void) {
     GPIOPinTypeSSI(ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CLK_PIN | ETHO_1_SSI_RX_PIN | ETHO_1_SSI_TX_PIN);
 
     SSIConfigSetExpClk(ETHO_1_BASE_ADDR, SysCtlClockGet(), SSI_FRF_MOTO_MODE_0,
-                       SSI_MODE_MASTER, 4000000, 8);
+                       SSI_MODE_MASTER, SPI_CLOCK_ETHO_DEFAULT, 8);
     SSIEnable(ETHO_1_BASE_ADDR);
 
 
@@ -567,8 +547,10 @@ void ConfigureI2C(void) {
     //Enable Loopback mode
     //HWREG(I2C0_BASE + I2C_O_MCR) |= 0x01;
 
-    //Enable I2C Interrupts
-    IntEnable(INT_I2C0);
+    //Enable I2C Interrupts. The ISR queues frames, so its priority must allow
+    //FreeRTOS API calls
+    IntPrioritySet(I2C_INTERRUPT_BASE, I2C_INT_PRIORITY);
+    IntEnable(I2C_INTERRUPT_BASE);
 
     // Set the slave address for the I2C port
     I2CSlaveInit(I2C_BASE_ADDR, I2C_DEVICE_ADDR);
@@ -579,12 +561,17 @@ void ConfigureI2C(void) {
     //Setup communications over I2C as a slave device
     I2CSlaveIntEnableEx(I2C_BASE_ADDR, I2C_SLAVE_INT_START|I2C_SLAVE_INT_STOP|I2C_SLAVE_INT_DATA);
 
+    //The ISR decides whether each received byte is acknowledged
+    I2CSlaveACKOverride(I2C_BASE_ADDR, true);
+    I2CSlaveACKValueSet(I2C_BASE_ADDR, true);
+
     //
     // Setup I2C master clock speed using system clock. If the third parameter
     // is setup as true, the I2C port will operate at 400 kbps. Otherwise, the
-    // bitrate of the port will be 100 kbps.
+    // bitrate of the port will be 100 kbps. Fast mode keeps copying the
+    // configuration to other layers ("system sync layers") short.
     //
-	I2CMasterInitExpClk(I2C_BASE_ADDR, SysCtlClockGet(), false);
+	I2CMasterInitExpClk(I2C_BASE_ADDR, SysCtlClockGet(), true);
 
 	// Enable this device as a slave device. Since all communication is being sent
 	// from master to slave while loopback is enabled, then this statement
@@ -621,86 +608,6 @@ void ConfigureWatchdog(void) {
     ROM_WatchdogEnable(WATCHDOG0_BASE);
 }
 
-//*****************************************************************************
-//
-//! Interrupt handler for all I2C communication. Detects when a valid command has
-//! been issued by checking the number of parameters sent over I2C. Once validated,
-//! the information is placed on the I2CQueue as an I2C_Packet. This information is
-//! used to call the appropriate function pointer that will execute the users' request.
-//! EXAMPLE:
-//! 	<START BIT> <7-bit ADDRESS> <I2C CODE> <PARAMETER N> <PARAMETER N+1> <END>
-//!
-//! If the function called returns values, the master will have to request N number of
-//! values over I2C. For example, if the function exports the current running configuration
-//! (256 values), the I2C master will have to reqest information 256 times.
-//!
-//! \return Returns void
-//
-//*****************************************************************************
-void I2C0SlaveIntHandler(void)
-{
-	static I2C_Packet data;
-
-	memset(&data, 0, sizeof(I2C_Packet));
-
-    // Clear the I2C0 interrupt flag.
-    uint32_t int_status = I2CSlaveIntStatusEx(I2C_BASE_ADDR, false);
-    uint32_t slave_status = I2CSlaveStatus(I2C_BASE_ADDR);
-    I2CSlaveIntClearEx(I2C_BASE_ADDR, int_status);
-    // Disable the I2C0 interrupt while processing the request
-    I2CSlaveIntDisable(I2C_BASE_ADDR);
-
-    xSemaphoreTakeFromISR(g_pI2CSemaphore, NULL);
-
-    if (slave_status & I2C_SLAVE_ACT_RREQ) {
-    	//Is this I2C interrupt from a START command?
-		if (int_status & I2C_SLAVE_INT_START ) {
-			//Reset the indexer
-			data.I2CRXIndex = 0;
-		}
-		else if (int_status & I2C_SLAVE_INT_DATA) {
-			// Read a byte from the master.
-			data.I2CRXBuffer[data.I2CRXIndex] = I2CSlaveDataGet(I2C_BASE_ADDR);
-			//Is the current number of parameters received greater than the max?
-			if (data.I2CRXIndex > I2CBUFFERSIZE)
-			{
-				//If so, wrap back to zero
-				data.I2CRXIndex = 0;
-			}
-			//Is the current number of parameters equal to or greater than the number of custom parameters required for the sent code?
-			if (data.I2CRXIndex >= I2C_Mappings[data.I2CRXBuffer[0]].custom_pcount)
-			{
-				//If so, place this packet in the I2CManager queue
-				UARTprintf("\nDetectedI2CCode: 0x%02x\n", I2C_Mappings[data.I2CRXBuffer[0]].command_code);
-				if(xQueueSendFromISR(g_pI2CQueue, &data, NULL) != pdPASS)
-				{
-				 //
-				 // Error. The queue should never be full. If so print the
-				 // error message on UART and wait for ever.
-				 //
-				 UARTprintf("\nQueue full. This should never happen.\n");
-				 while(1)
-				 {
-				 }
-				}
-			}
-
-			data.I2CRXIndex++;
-		}
-		else if (int_status & I2C_SLAVE_INT_STOP) {
-			//We received a stop commmand.
-		}
-    }
-
-    if (int_status & I2C_MASTER_INT_DATA) {
-    	UARTprintf("Value read back from slave: %02X\n", I2CMasterDataGet(I2C_BASE_ADDR));
-    }
-
-    xSemaphoreGiveFromISR(g_pI2CSemaphore, NULL);
-    I2CSlaveIntEnable(I2C_BASE_ADDR);
-}
-
-
 //*****************************************************************************
 //
 //! The interrupt handler for the watchdog.  This feeds the dog (so that the
@@ -724,247 +631,66 @@ WatchdogIntHandler(void)
 //! called on first boot as specified by bit 2 in register 0x1E. If this bit is
 //! '0', the initialization is performed and the bit is set to '1'.
 //!
-//! \return Returns void
+//! Only the saved Ethernet Controller registers are restored here so that the
+//! switch can start forwarding as early as possible. The VLAN table and the
+//! user database are loaded afterwards by the boot task.
+//!
+//! \return Returns the flags of a legacy configuration (register 0x1E) the
+//! boot task still has to load, or 0 if there is none
 //
 //******************************************************************************
-bool InitializeEEPROM(void) {
+uint8_t InitializeEEPROM(void) {
 	//LOAD CONFIGURATION FROM EEPROM TO ETHERNET CONTROLLER
-	uint8_t FirmwareSettings = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,EEPROM_FIRMWARE_SETTINGS), vlan_data;
-	uint32_t reg = 0, progress = 0, users_cnt = 0;
+	uint8_t FirmwareSettings = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,EEPROM_FIRMWARE_SETTINGS);
+	uint8_t legacy_flags = 0x00;
+	uint32_t reg = 0, burst_length = 0;
 
-	UARTprintf("\033[2J");
+	ConsolePrintfWait("\033[2J");
 
 	//Was the EEPROM initialized? This bit should be a '1'
 	if ((FirmwareSettings & 0x80) == 0x80)
 	{
-		UARTprintf("[BOOTING]: Reintializing EEPROM...");
+		ConsolePrintfWait("[BOOTING]: Reintializing EEPROM...");
 		EEPROMChipErase(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN);
-		UARTprintf("DONE!\n");
+		ConsolePrintfWait("DONE!\n");
 	}
-	if ((FirmwareSettings & 0x40) == 0x40) {
-		//Load config from Ethernet Controller
-		UARTprintf("\n[BOOTING]: Loading configuration from memory...please wait\n");
-		progress = CreateProgressBar();
-		for (reg = 0; reg < 0xFF; reg++)
+	//Find the newest intact generation of the configuration store
+	if (ConfigStoreOpen(BootPageBuffer)) {
+		ConsolePrintfWait("[BOOTING]: Restoring configuration generation %d...", ConfigStoreGeneration());
+		ConsolePrintfWait(ConfigStoreApply(CONFIG_SECTION_MASK(CONFIG_SECTION_SWITCH), BootPageBuffer) ? "DONE!\n" : "FAILED!\n");
+	}
+	else if ((FirmwareSettings & 0x40) == 0x40) {
+		//Load config saved by firmware without the configuration store
+		ConsolePrintfWait("[BOOTING]: Restoring legacy configuration...");
+		//Fetch the whole saved register image with a single sequential read
+		EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_SWITCH_CONFIG_BASE, BootPageBuffer, 0xFF);
+		for (reg = 0; reg < 0xFF; reg += burst_length)
 		{
-			if (EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,reg,EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_SWITCH_CONFIG_BASE + reg))))
-			{
-				UpdateProgressBar(&progress, Increment, (100*reg)/0xFF);
-				//ShowProgress((100*reg)/0xFF);
-				delayMs(10);
+			uint32_t burst_data[ETHO_BURST_LENGTH];
+			uint32_t pos = 0;
+
+			burst_length = ((0xFF - reg) < ETHO_BURST_LENGTH) ? (0xFF - reg) : ETHO_BURST_LENGTH;
+			for (pos = 0; pos < burst_length; pos++) {
+				burst_data[pos] = BootPageBuffer[reg + pos];
 			}
+			//Restore the next group of registers in a single burst
+			EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,reg,burst_length,burst_data);
 		}
-		UARTprintf("\n");
-
-		//Load Log Status Flags from EEPROM registers [0x1F - 0x22]
-		LogStatusFlags = (EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_1) << 24) 		|
-							(EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_2) << 16) 	|
-							(EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_3) << 8) 	|
-							(EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_4));
-
-		//Load last used log slot for this iteration
-		NextLogSlot = (EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_1) << 24) 			|
-							(EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_2) << 16) 	|
-							(EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_3) << 8) 	|
-							(EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_NEXTLOG_4));
-
-		if (NextLogSlot < EEPROM_LOG_BASE) {
-			NextLogSlot = EEPROM_LOG_BASE;
-		}
+		ConsolePrintfWait("DONE!\n");
+		//The device now holds the saved image, nothing needs to be saved again
+		EthoShadowMarkRange(0, ETHO_SHADOW_SIZE, false);
+		//VLANs and users follow in the boot task, which then migrates everything into the store
+		legacy_flags = FirmwareSettings;
+	}
+	BootPhaseMark(BootPhaseSwitchRestored);
 
-		if ((FirmwareSettings & 0x20) == 0x20) {
-			//Load config from Ethernet Controller
-			UARTprintf("\n[BOOTING]: Reconfiguring VLANS from memory...please wait\n");
-			progress = CreateProgressBar();
-			for (reg = 0; reg < 4095; reg++)
-			{
-				vlan_data = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_VLAN_TABLE_BASE + reg));
-				if ((vlan_data & 0x80) == 0x80)
-				{
-					//Valid VLAN, Save to VLAN table
-					uint8_t port_membership = 0x00;
-
-					uint32_t indirect_reg_addr = ((reg+1) / 4), indirect_reg_data = 0x00;
-					//Obtain current indirect access data 0 and modify
-					uint32_t indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0);
-					//Select VLAN table, set operation mode to READ, and set 2 bits from MSB of indirect_reg_addr in bits 0 and 1 of this register
-					indirect_access_data |= (INDIRECT_TABLESELECT_VLAN << INDIRECT_CONTROL_TABLESELECT) | (INDIRECT_READTYPE_READ << INDIRECT_CONTROL_READTYPEBIT) | (((indirect_reg_addr >> 8) & 0xFF) << INDIRECT_CONTROL_ADDRESS_HIGH);
-					//Write the modified register to the Ethernet Controller
-					if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, indirect_access_data))
-					{
-						return false;
-					}
-					//Obtain current indirect access data 1 and modify
-					indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_1);
-					//Set this register to the remaining 8 bits of the 10-bit indirect_reg_addr
-					indirect_access_data = (indirect_reg_addr & 0xFF);
-					if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_1, indirect_access_data))
-					{
-						return false;
-					}
-
-					//VLAN SETTINGS MODIFICATION START HERE
-					/*Each indirect register contains informatin for four VLANs organized in the following way:
-					* ENTRY 0 (12 bits) maps to first VLAN, indirect bits (12-0): register 119 (bits 4-0), register 120 (bits 7-0)
-					* ENTRY 1 (12 bits) maps to second VLAN, indirect bits (25-13): register 117 (bits 1-0), register 118 (bits 7-0), register 119 (bits 7-5)
-					* ENTRY 2 (12 bits) maps to third VLAN, indirect bits (38-26): register 116 (bits 6-0), register 117 (7-2)
-					* ENTRY 3 (12 bits) maps to fourth VLAN, indirect bits (51-39): register 114 (bits 3-0), register 115 (7-0), register 116 (bit 7);
-					*
-					* VLAN GROUP = (VLAN_ID / 4)
-					* VLAN = VLAN GROUP % 4
-					*/
-					switch ((reg+1) % 4) {
-					//User requested a change to the first VLAN in GROUP X
-					case 0:
-						//Get the information held in register 119
-						indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_1);
-						//Set VLAN entry to VALID
-						indirect_reg_data |= (1 << 4);
-
-						//Read current port membership data
-						port_membership = ((vlan_data & 0x7F) >> 2);
-
-						//Place first four bits of port_membership value into bits [3-0] of indirect register 119
-						indirect_reg_data |= ((port_membership >> 1 ) << 0);
-						//Overwrite register 119 with updated information
-						if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_1, indirect_reg_data))
-						{
-							return false;
-						}
-						//Get the information held in register 120
-						indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_0);
-						//Place the fifth bit into bit 7 of indirect register 120
-						indirect_reg_data |= ((port_membership & 0x01) << 7);
-						//Overwrite register 120 with updated information
-						if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_0, indirect_reg_data))
-						{
-							return false;
-						}
-						break;
-					//User requested a change to the second VLAN in GROUP X
-					case 1:
-						//Get the information held in register 117
-						indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_3);
-						//Set VLAN entry to VALID
-						indirect_reg_data |= (1 << 1);
-
-						//Read current port membership data
-						port_membership = ((vlan_data & 0x7F) >> 2);
-
-						//Place first bit of port_membership value into bit [0] of indirect register 117
-						indirect_reg_data |= ((port_membership >> 4 ) << 0);
-						//Overwrite register 117 with updated information
-						if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_3, indirect_reg_data))
-						{
-							return false;
-						}
-						//Get the information held in register 118
-						indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_2);
-						//Place the last four bits of port_membership value into bits [7-4] of indirect register 118
-						indirect_reg_data |= ((port_membership & 0xF) << 4);
-						//Overwrite register 118 with updated information
-						if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_2, indirect_reg_data))
-						{
-							return false;
-						}
-						break;
-					//User requested a change to the third VLAN in GROUP X
-					case 2:
-						//Get the information held in register 116
-						indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_4);
-						//Set VLAN entry to VALID
-						indirect_reg_data |= (1 << 6);
-
-						//Read current port membership data
-						port_membership = ((vlan_data & 0x7F) >> 2);
-
-						//Place port_membership value into bits [5-1] of indirect register 116
-						indirect_reg_data |= ((port_membership) << 1);
-						//Overwrite register 116 with updated information
-						if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_4, indirect_reg_data))
-						{
-							return false;
-						}
-						break;
-					//User requested a change to the fourth VLAN in GROUP X
-					case 3:
-						//Get the information held in register 114
-						indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_6);
-						//Set VLAN entry to VALID
-						indirect_reg_data |= (1 << 3);
-
-						//Read current port membership data
-						port_membership = ((vlan_data & 0x7F) >> 2);
-
-						//Place first three bits of port_membership value into bits [2-0] of indirect register 114
-						indirect_reg_data |= ((port_membership >> 2 ) << 0);
-						//Overwrite register 114 with updated information
-						if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_6, indirect_reg_data))
-						{
-							return false;
-						}
-						//Get the information held in register 115
-						indirect_reg_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_5);
-						//Place the last two bits of port_membership value into bits [7-6] of indirect register 115
-						indirect_reg_data |= ((port_membership & 0x3) << 6);
-						//Overwrite register 115 with updated information
-						if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_REGISTER_DATA_5, indirect_reg_data))
-						{
-							return false;
-						}
-						break;
-					}
-
-					//Obtain current indirect access data 0 and modify
-					indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0);
-					//Select VLAN table, set operation mode to READ, and set 2 bits from MSB of indirect_reg_addr in bits 0 and 1 of this register
-					indirect_access_data &= ~0x1f;
-					indirect_access_data |= (INDIRECT_TABLESELECT_VLAN << INDIRECT_CONTROL_TABLESELECT) | (INDIRECT_READTYPE_WRITE << INDIRECT_CONTROL_READTYPEBIT) | (((indirect_reg_addr >> 8) & 0xFF) << INDIRECT_CONTROL_ADDRESS_HIGH);
-					//Write the modified register to the Ethernet Controller
-					if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, indirect_access_data))
-					{
-						return false;
-					}
-					//Obtain current indirect access data 1 and modify
-					indirect_access_data = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_1);
-					//Set this register to the remaining 8 bits of the 10-bit indirect_reg_addr
-					indirect_access_data = (indirect_reg_addr & 0xFF);
-					if (!EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,INDIRECT_ACCESS_CONTROL_1, indirect_access_data))
-					{
-						return false;
-					}
+	//Load Log Status Flags [0x1F - 0x22]. The next log slot is recovered from the log itself by LoggerTaskInit()
+	uint8_t log_settings[4];
+	EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_LOGFLAGS_1, log_settings, 4);
 
-				}
-				UpdateProgressBar(&progress, Increment, (100*(reg))/4095);
-				delayMs(3);
-			}
-			UARTprintf("\n");
+	LogStatusFlags = (log_settings[0] << 24) | (log_settings[1] << 16) | (log_settings[2] << 8) | (log_settings[3]);
 
-		}
-		if ((FirmwareSettings & 0x10) == 0x10) {
-			UARTprintf("\n[BOOTING]: Loading User Database...please wait\n");
-			progress = CreateProgressBar();
-			//Load Users Into Memory, Read in 15 users
-			for (users_cnt = 0; users_cnt < MAX_USERS; users_cnt++) {
-				//Get username from EEPROM (16 characters [16 registers])
-				EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (users_cnt*65)),users[users_cnt].username, 16);
-				//Get password from EEPROM (16 characters [16 registers])
-				EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (users_cnt*65) + 16),users[users_cnt].password, 16);
-				//Get first name from EEPROM (16 characters [16 registers])
-				EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (users_cnt*65) + 32),users[users_cnt].first_name, 16);
-				//Get last name from EEPROM (16 characters [16 registers])
-				EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (users_cnt*65) + 48),users[users_cnt].last_name, 16);
-				//Get permission level from user. PermLevel is cast from 8-bit unsigned integer
-				users[users_cnt].permissions = (PermLevel)EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN,(EEPROM_USERS_BASE + (users_cnt*65) + 64));
-				//Set this user to be left unchanged on next configuration save.
-				users[users_cnt].nextAction = None;
-
-				UpdateProgressBar(&progress, Increment, (100*(users_cnt))/MAX_USERS);
-			}
-			UARTprintf("\n");
-		}
-	}
-	return true;
+	return legacy_flags;
 }
 
 
@@ -984,13 +710,35 @@ bool InitializeEEPROM(void) {
 int
 main(void)
 {
+	uint8_t legacy_flags;
+	uint32_t reset_cause;
+	SPIClockInfo eeprom_clock, etho_clock;
+	bool spi_tested;
+
 	//*************************************************
 	//
-    // Set the clocking to run at 50 MHz from the PLL.
+    // Set the clocking to run at 80 MHz from the PLL.
 	//
 	//*************************************************
 	ROM_SysCtlClockSet(SYSCTL_SYSDIV_2_5 | SYSCTL_USE_PLL | SYSCTL_XTAL_25MHZ |
                        SYSCTL_OSC_MAIN);
+#if ENABLE_PERF_STATS
+	//Start the cycle counter so bring-up is timed as well
+	PerfInit();
+#endif
+
+	//*************************************************
+	//
+	// After a power-on reset the Ethernet Controller
+	// was powered up as well and its VLAN table is
+	// empty. The cause bits add up until cleared.
+	//
+	//*************************************************
+	reset_cause = SysCtlResetCauseGet();
+	SysCtlResetCauseClear(reset_cause);
+	if (reset_cause & SYSCTL_CAUSE_POR) {
+		VLANTablePowerOn();
+	}
 
 	//*************************************************
 	//
@@ -1014,29 +762,52 @@ main(void)
     // seen by the user.
 	//
 	//*************************************************
-    UARTFlushRx();
-    UARTFlushTx(true);
-    UARTprintf("\033[0m");
+    ConsoleFlush();
+    ConsoleFlushTx(true);
+    ConsolePrintfWait("\033[0m");
 	//*************************************************
 	//
-    // Create mutexes to guard the UART, SPI0, SPI1,
-    // and I2C ports.
+    // Create the mutex that guards the UART and the
+    // arbiter that owns the SPI0 and SPI1 ports. The
+    // I2C slave is only driven by its ISR.
 	//
 	//*************************************************
     g_pUARTSemaphore = xSemaphoreCreateMutex();
-    g_pSPI0Semaphore = xSemaphoreCreateMutex();
-    g_pSPI1Semaphore = xSemaphoreCreateMutex();
-    g_pI2CSemaphore = xSemaphoreCreateMutex();
+    SPIArbiterInit();
 
 	//*************************************************
 	//
-	// Load saved configuration from EEPROM.
-    // Starts reading from memory address 0x100
+	// Start the delay timers and hand both SSI ports
+	// and the console output over to the uDMA engine.
+	// Delays and transfers are polled until the
+	// scheduler starts. Then pick the SPI clock of
+	// each bus and load the Ethernet Controller
+	// register shadow.
 	//
 	//*************************************************
-    UARTEchoSet(false);
-    InitializeEEPROM();
-    UARTEchoSet(true);
+    DelayTimerInit();
+    BootPhaseMark(BootPhaseTimebase);
+    SSIDMAInit();
+    ConsoleDMAInit();
+    spi_tested = SPIClockInit();
+    EthoShadowInit(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN);
+
+	//*************************************************
+	//
+	// Load the saved switch registers from EEPROM.
+    // VLANs and users are loaded by the boot task
+    // once the scheduler is running.
+	//
+	//*************************************************
+    ConsoleEchoSet(false);
+    legacy_flags = InitializeEEPROM();
+    ConsoleEchoSet(true);
+    LayerAddressInit();
+    SPIClockGet(SPI_CLOCK_BUS_EEPROM, &eeprom_clock);
+    SPIClockGet(SPI_CLOCK_BUS_ETHO, &etho_clock);
+    ConsolePrintfWait("[BOOTING]: SPI clocks: EEPROM %d kHz, Ethernet Controller %d kHz%s\n", eeprom_clock.rate / 1000,
+    		etho_clock.rate / 1000, (spi_tested ? "" : " (self-test FAILED, using defaults)"));
+    ConsolePrintfWait("[BOOTING]: I2C layer address 0x%02x\n", LayerAddressGet());
 	//*************************************************
 	//
 	// Set the register 0x01 in Ethernet Controller 1
@@ -1045,7 +816,8 @@ main(void)
 	//
 	//*************************************************
     EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x01,0x01);
-   	UARTprintf("[BOOTING]: Started Ethernet Controller\n");
+    BootPhaseMark(BootPhaseForwarding);
+   	ConsolePrintfWait("[BOOTING]: Started Ethernet Controller\n");
 
    	//Setup Ethernet Controller to handle additional cascaded layers
    	//Enable Micrel Auto MDI/MDI-X mode
@@ -1056,11 +828,12 @@ main(void)
    	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x84, 0x70);
    	//Enable IP multicast packet forwarding
    	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x86, 0x30);
-   	//Enable rapid aging
-//   	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x03, 0x06);
-   	//Enable rapid aging based on port state
-//   	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x02, 0x01);
-   	UARTprintf("[BOOTING]: Configured Port 5 for expansion\n");
+   	//Aging, flow control, storm protection and priority queues are set by the QoS
+   	//profiles ("system qos-profile") and restored with the saved switch registers
+   	ConsolePrintfWait("[BOOTING]: Configured Port 5 for expansion\n");
+   	MACTableInit();
+   	MIBCountersInit();
+   	CableDiagInit();
 
 
 
@@ -1072,6 +845,15 @@ main(void)
    	// header.
 	//
 	//*************************************************
+			if(BootTaskInit(legacy_flags) != 0)
+			{
+				while(1)
+				{
+					//
+					//This should never happen! Wait for someone to help us!
+					//
+				}
+			}
 	#if ENABLE_LED_MANAGER
 			if(LEDManagerTaskInit() != 0)
 			{
@@ -1170,7 +952,7 @@ main(void)
 			// Error. The queue should never be full. If so print the
 			// error message on UART and wait for ever.
 			//
-			UARTprintf("\nQueue full. This should never happen.\n");
+			ConsolePrintfWait("\nQueue full. This should never happen.\n");
 			while(1)
 			{
 			}
@@ -1193,11 +975,12 @@ main(void)
 	// Start the FreeRTOS scheduler, this statement should NOT return.
 	//
 	//****************************************************************
+	MemoryIdleTaskAdd();
     vTaskStartScheduler();
 
     // In case the scheduler returns for some reason, print an error and loop
     // forever.
-	UARTprintf("\n RTOS ERROR: Scheduler stopped. System resetting in 3 seconds\n");
+	ConsolePrintfWait("\n RTOS ERROR: Scheduler stopped. System resetting in 3 seconds\n");
     while(1)
     {
 
@@ -52,11 +52,11 @@ static const char *TASK_STATES[] = {
 static bool ConsoleMode = true;
 //*****************************************************************************
 //
-//! \var I2C_DEVICE_ADDR The current I2C address of this slave/master device.
-//! Reconfigurable through the console at runtime.
+//! I2C address a layer answers at until "system i2c address" saves another
+//! one (see LayerAddressInit()).
 //
 //*****************************************************************************
-static uint8_t I2C_DEVICE_ADDR = 0x1A;
+#define I2C_DEVICE_ADDR 0x1A
 //*****************************************************************************
 //
 //! \var console_hostname The current identifier that the user sees when connecting
@@ -173,6 +173,12 @@ void ShowDebugInformation();
 
 #define ETHO_1_SYS_BASE			SYSCTL_PERIPH_SSI1
 #define ETHO_1_SYS_PORT_BASE	SYSCTL_PERIPH_GPIOD
+
+// KSZ8895MLUB interrupt output (INTR_N), active low
+#define ETHO_1_INT_BASE			GPIO_PORTE_BASE
+#define ETHO_1_INT_PIN			GPIO_PIN_4
+#define ETHO_1_INT_VECTOR		INT_GPIOE
+#define ETHO_1_INT_SYS_PORT_BASE	SYSCTL_PERIPH_GPIOE
 //*****************************************************************************
 //
 // I2C port and pin settings.
@@ -228,10 +234,17 @@ void ShowDebugInformation();
 #define EEPROM_FIRMWARE_NEXTLOG_2	0x24
 #define EEPROM_FIRMWARE_NEXTLOG_3	0x25
 #define EEPROM_FIRMWARE_NEXTLOG_4	0x26
+#define EEPROM_FIRMWARE_SPICLOCK	0x27
+#define EEPROM_FIRMWARE_I2CADDR		0x29
 #define EEPROM_SWITCH_CONFIG_BASE 	0x100
 #define EEPROM_VLAN_TABLE_BASE 		0x200
 #define EEPROM_USERS_BASE			0x1200
+#define EEPROM_USER_RECORD_SIZE		65
 #define EEPROM_LOG_BASE				0x1600
+#define EEPROM_CONFIG_SLOT_A		0x4000
+#define EEPROM_CONFIG_SLOT_B		0x8000
+#define EEPROM_CONFIG_SLOT_SIZE		0x4000
+#define EEPROM_SPI_TEST_PAGE		0x1FF00
 
 
 #endif /* FREERTOS_INIT_H_ */
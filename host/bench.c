@@ -0,0 +1,425 @@
+/**\file bench.c
+ * \brief <b>Host benchmark of the configuration, VLAN and MAC table paths</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "host_mock.h"
+#include "ksz8895_model.h"
+#include "eeprom_25aa1024_model.h"
+#include "bench_limits.h"
+#include "freertos_init.h"
+#include "i2c_task.h"
+#include "interpreter_task.h"
+#include "command_functions.h"
+#include "vlan_table.h"
+#include "mac_table.h"
+
+//*****************************************************************************
+//
+// Host benchmark of the switch firmware. The firmware sources run against the
+// modeled TivaWare peripherals and kernel (mock_tivaware.c, mock_freertos.c)
+// with a KSZ8895MLUB on SSI1 and a 25AA1024 on SSI0. Every boot runs in a
+// child process so it starts from fresh statics; the EEPROM image and the
+// results are kept in memory shared with the parent.
+//
+//*****************************************************************************
+#define BENCH_VLAN_COUNT			12
+#define BENCH_STATIC_MAC_COUNT		4
+#define BENCH_DYNAMIC_MAC_COUNT		40
+#define BENCH_FAILURE_COUNT			16
+#define BENCH_FAILURE_LENGTH		160
+#define BENCH_OUTPUT_SIZE			65536
+
+extern int FirmwareMain(void);
+
+typedef enum
+{
+	BenchBoot,
+	BenchVLANSet,
+	BenchVLANShow,
+	BenchSave,
+	BenchStaticMAC,
+	BenchDynamicMAC,
+	BenchRestore,
+	BenchScenarioCount
+} BenchScenario;
+
+typedef struct
+{
+	uint32_t eeprom_bytes;
+	uint32_t etho_bytes;
+	uint32_t transactions;
+	uint64_t us;
+	bool measured;
+} BenchFigures;
+
+typedef struct
+{
+	const char *name;
+	BenchFigures limit;
+} BenchScenarioInfo;
+
+static const BenchScenarioInfo BenchScenarios[BenchScenarioCount] = {
+	{"first boot",			{BENCH_BOOT_EEPROM_BYTES, BENCH_BOOT_ETHO_BYTES, BENCH_BOOT_TRANSACTIONS, BENCH_BOOT_US}},
+	{"vlan set",			{BENCH_VLAN_SET_EEPROM_BYTES, BENCH_VLAN_SET_ETHO_BYTES, BENCH_VLAN_SET_TRANSACTIONS, BENCH_VLAN_SET_US}},
+	{"vlan show",			{BENCH_VLAN_SHOW_EEPROM_BYTES, BENCH_VLAN_SHOW_ETHO_BYTES, BENCH_VLAN_SHOW_TRANSACTIONS, BENCH_VLAN_SHOW_US}},
+	{"config save",			{BENCH_SAVE_EEPROM_BYTES, BENCH_SAVE_ETHO_BYTES, BENCH_SAVE_TRANSACTIONS, BENCH_SAVE_US}},
+	{"static MAC dump",		{BENCH_STATIC_MAC_EEPROM_BYTES, BENCH_STATIC_MAC_ETHO_BYTES, BENCH_STATIC_MAC_TRANSACTIONS, BENCH_STATIC_MAC_US}},
+	{"dynamic MAC dump",	{BENCH_DYNAMIC_MAC_EEPROM_BYTES, BENCH_DYNAMIC_MAC_ETHO_BYTES, BENCH_DYNAMIC_MAC_TRANSACTIONS, BENCH_DYNAMIC_MAC_US}},
+	{"boot restore",		{BENCH_RESTORE_EEPROM_BYTES, BENCH_RESTORE_ETHO_BYTES, BENCH_RESTORE_TRANSACTIONS, BENCH_RESTORE_US}}
+};
+
+//*****************************************************************************
+//
+//! State shared between the boots (child processes) and the parent.
+//
+//*****************************************************************************
+typedef struct
+{
+	uint8_t eeprom[EEPROM_MODEL_SIZE];
+	uint8_t saved_regs[KSZ8895_REGISTER_COUNT];
+	uint32_t vlan_ids[BENCH_VLAN_COUNT];
+	uint8_t vlan_membership[BENCH_VLAN_COUNT];
+	BenchFigures results[BenchScenarioCount];
+	uint32_t failures;
+	char failure[BENCH_FAILURE_COUNT][BENCH_FAILURE_LENGTH];
+} BenchShared;
+
+static BenchShared *Bench;
+static KSZ8895Model BenchSwitch;
+static EEPROMModel BenchEEPROM;
+static uint64_t BenchStart;
+static char BenchOutput[BENCH_OUTPUT_SIZE];
+
+static void BenchFail(const char *format, ...)
+{
+	va_list args;
+
+	if (Bench->failures < BENCH_FAILURE_COUNT) {
+		va_start(args, format);
+		vsnprintf(Bench->failure[Bench->failures], BENCH_FAILURE_LENGTH, format, args);
+		va_end(args);
+	}
+	Bench->failures++;
+}
+
+//*****************************************************************************
+//
+//! Attaches fresh device models to both SPI buses. The EEPROM array lives in
+//! shared memory so it survives into the next boot.
+//
+//*****************************************************************************
+static void BenchAttach(void)
+{
+	HostSPIDevice device;
+
+	KSZ8895ModelInit(&BenchSwitch);
+	KSZ8895ModelDevice(&BenchSwitch, &device);
+	HostSPIAttach(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, &device);
+
+	EEPROMModelInit(&BenchEEPROM, Bench->eeprom);
+	EEPROMModelDevice(&BenchEEPROM, &device);
+	HostSPIAttach(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, &device);
+}
+
+static void BenchBegin(void)
+{
+	HostBusCountersReset();
+	HostConsoleOutputReset();
+	BenchStart = HostTimeNs();
+}
+
+//*****************************************************************************
+//
+//! Records the figures of a scenario, then lets the console finish sending so
+//! that its output can be checked. Console time is not part of the figures.
+//
+//*****************************************************************************
+static uint32_t BenchEnd(BenchScenario scenario)
+{
+	HostBusCounters eeprom, etho;
+	BenchFigures *figures = &Bench->results[scenario];
+	uint64_t due;
+	uint32_t length;
+
+	figures->us = (HostTimeNs() - BenchStart) / 1000;
+	HostBusCountersGet(EEPROM_BASE_ADDR, &eeprom);
+	HostBusCountersGet(ETHO_1_BASE_ADDR, &etho);
+	figures->eeprom_bytes = eeprom.bytes;
+	figures->etho_bytes = etho.bytes;
+	figures->transactions = eeprom.transactions + etho.transactions;
+	figures->measured = true;
+
+	while (HostNextEvent(&due)) {
+		HostAdvance((due > HostTimeNs()) ? (due - HostTimeNs()) : 0);
+	}
+	length = HostConsoleOutput(BenchOutput, BENCH_OUTPUT_SIZE - 1);
+	BenchOutput[length] = '\0';
+
+	if (BenchSwitch.overclocked) {
+		BenchFail("%s: KSZ8895 clocked above %d Hz", BenchScenarios[scenario].name, KSZ8895_MAX_RATE);
+	}
+	if (BenchEEPROM.overclocked) {
+		BenchFail("%s: 25AA1024 clocked above %d Hz", BenchScenarios[scenario].name, EEPROM_MODEL_MAX_RATE);
+	}
+	return length;
+}
+
+static bool BenchCommand(bool (*command)(char *params[MAX_PARAMS]), const char *first, const char *second)
+{
+	char param0[16], param1[16];
+	char *params[MAX_PARAMS] = {param0, param1};
+
+	snprintf(param0, sizeof(param0), "%s", (first != NULL) ? first : "");
+	snprintf(param1, sizeof(param1), "%s", (second != NULL) ? second : "");
+	return command(params);
+}
+
+static void BenchBootFirmware(void)
+{
+	HostSchedulerStart(FirmwareMain);
+	if (!HostTaskRun("BOOT")) {
+		BenchFail("boot task not created");
+	}
+	if (!HostTaskEnter("Interpreter")) {
+		BenchFail("interpreter task not created");
+	}
+}
+
+//*****************************************************************************
+//
+//! First boot on a blank EEPROM: sets up VLANs, lists them, saves the
+//! configuration and dumps the MAC tables.
+//
+//*****************************************************************************
+static void BenchFirstBoot(void)
+{
+	static const char *ports[4] = {ETHO_PORT1_HARDWARE, ETHO_PORT2_HARDWARE, ETHO_PORT3_HARDWARE, ETHO_PORT4_HARDWARE};
+	char vlan[8], text[24];
+	uint8_t mac[6] = {0x02, 0x00, 0x5E, 0x10, 0x00, 0x00};
+	uint32_t index;
+
+	BenchAttach();
+
+	BenchBegin();
+	BenchBootFirmware();
+	BenchEnd(BenchBoot);
+
+	BenchBegin();
+	for (index = 0; index < 4; index++) {
+		snprintf(vlan, sizeof(vlan), "%u", (unsigned)(10 * (index + 1)));
+		if (!BenchCommand(COM_SetPortVLAN, ports[index], vlan)) {
+			BenchFail("vlan set: port VLAN %s on %s failed", vlan, ports[index]);
+		}
+	}
+	for (index = 0; index < BENCH_VLAN_COUNT; index++) {
+		Bench->vlan_ids[index] = 10 * (index + 1);
+		snprintf(vlan, sizeof(vlan), "%u", (unsigned)Bench->vlan_ids[index]);
+		if (!BenchCommand(COM_SetVLANEntry, ports[index % 4], vlan)) {
+			BenchFail("vlan set: VLAN %s on %s failed", vlan, ports[index % 4]);
+		}
+	}
+	if (!BenchCommand(COM_EnableVLANS, NULL, NULL)) {
+		BenchFail("vlan set: enabling VLANs failed");
+	}
+	BenchEnd(BenchVLANSet);
+	for (index = 0; index < BENCH_VLAN_COUNT; index++) {
+		if (!VLANGetEntry(Bench->vlan_ids[index], &Bench->vlan_membership[index])) {
+			BenchFail("vlan set: VLAN %u is not valid", (unsigned)Bench->vlan_ids[index]);
+		}
+	}
+
+	//The table pages every ten entries, the operator asks for the next page
+	HostConsoleType("n");
+	BenchBegin();
+	BenchCommand(COM_ShowVLANTable, NULL, NULL);
+	BenchEnd(BenchVLANShow);
+	for (index = 0; index < BENCH_VLAN_COUNT; index++) {
+		snprintf(text, sizeof(text), "\n%u ", (unsigned)Bench->vlan_ids[index]);
+		if (strstr(BenchOutput, text) == NULL) {
+			BenchFail("vlan show: VLAN %u not listed", (unsigned)Bench->vlan_ids[index]);
+		}
+	}
+
+	BenchBegin();
+	if (!BenchCommand(COM_SaveSwitchConfiguration, NULL, NULL)) {
+		BenchFail("config save: failed");
+	}
+	BenchEnd(BenchSave);
+	memcpy(Bench->saved_regs, BenchSwitch.regs, KSZ8895_REGISTER_COUNT);
+
+	for (index = 0; index < BENCH_STATIC_MAC_COUNT; index++) {
+		mac[4] = 0xA0;
+		mac[5] = (uint8_t)index;
+		KSZ8895ModelStaticSet(&BenchSwitch, index, mac, (uint8_t)(1 << (index % 4)), 0);
+	}
+	for (index = 0; index < BENCH_DYNAMIC_MAC_COUNT; index++) {
+		mac[4] = 0xD0;
+		mac[5] = (uint8_t)index;
+		KSZ8895ModelLearn(&BenchSwitch, mac, (uint8_t)(index % 4), 1);
+	}
+	//Let the MAC table snapshot taken at boot go stale
+	HostAdvance((MAC_SNAPSHOT_REFRESH_MS + 1000) * 1000000ULL);
+
+	BenchBegin();
+	BenchCommand(COM_ShowStaticMACTable, NULL, NULL);
+	BenchEnd(BenchStaticMAC);
+	for (index = 0; index < BENCH_STATIC_MAC_COUNT; index++) {
+		snprintf(text, sizeof(text), "02:00:5E:10:A0:%02X", (unsigned)index);
+		if (strstr(BenchOutput, text) == NULL) {
+			BenchFail("static MAC dump: %s not listed", text);
+		}
+	}
+
+	BenchBegin();
+	BenchCommand(COM_ShowDynamicMACTable, NULL, NULL);
+	BenchEnd(BenchDynamicMAC);
+	for (index = 0; index < BENCH_DYNAMIC_MAC_COUNT; index++) {
+		snprintf(text, sizeof(text), "02:00:5E:10:D0:%02X", (unsigned)index);
+		if (strstr(BenchOutput, text) == NULL) {
+			BenchFail("dynamic MAC dump: %s not listed", text);
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Second boot on the saved EEPROM with a freshly reset Ethernet Controller.
+//! The VLANs and the switch registers must come back as they were saved. The
+//! indirect access registers (0x6E - 0x7F) only hold the last access.
+//
+//*****************************************************************************
+static void BenchRestoreBoot(void)
+{
+	uint32_t index, address;
+	uint8_t membership;
+
+	BenchAttach();
+
+	BenchBegin();
+	BenchBootFirmware();
+	BenchEnd(BenchRestore);
+
+	for (index = 0; index < BENCH_VLAN_COUNT; index++) {
+		if (!VLANGetEntry(Bench->vlan_ids[index], &membership) || membership != Bench->vlan_membership[index]) {
+			BenchFail("boot restore: VLAN %u not restored", (unsigned)Bench->vlan_ids[index]);
+		}
+	}
+	for (address = 0x02; address < 0xFF; address++) {
+		if (address >= 0x6E && address <= 0x7F) {
+			continue;
+		}
+		if (BenchSwitch.regs[address] != Bench->saved_regs[address]) {
+			BenchFail("boot restore: register 0x%02X is 0x%02X, saved 0x%02X", (unsigned)address,
+					BenchSwitch.regs[address], Bench->saved_regs[address]);
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Runs one boot in a child process.
+//
+//*****************************************************************************
+static bool BenchRun(void (*boot)(void), const char *name)
+{
+	pid_t child;
+	int status;
+
+	fflush(stdout);
+	child = fork();
+	if (child == 0) {
+		boot();
+		fflush(stdout);
+		_exit(0);
+	}
+	if (child < 0 || waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		BenchFail("%s did not complete", name);
+		return false;
+	}
+	return true;
+}
+
+static bool BenchCheck(const char *name, const char *figure, uint64_t value, uint64_t limit)
+{
+	if (value > limit) {
+		BenchFail("%s: %s %llu over the limit of %llu", name, figure, (unsigned long long)value, (unsigned long long)limit);
+		return false;
+	}
+	return true;
+}
+
+int main(void)
+{
+	const BenchFigures *figures, *limit;
+	uint32_t index;
+
+	Bench = mmap(NULL, sizeof(BenchShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (Bench == MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+	memset(Bench, 0, sizeof(BenchShared));
+	memset(Bench->eeprom, 0xFF, EEPROM_MODEL_SIZE);
+
+	if (BenchRun(BenchFirstBoot, "first boot")) {
+		BenchRun(BenchRestoreBoot, "boot restore");
+	}
+
+	printf("\n%-18s %12s %12s %13s %12s\n", "scenario", "EEPROM bytes", "Etho bytes", "transactions", "modeled us");
+	for (index = 0; index < BenchScenarioCount; index++) {
+		figures = &Bench->results[index];
+		limit = &BenchScenarios[index].limit;
+		if (!figures->measured) {
+			printf("%-18s %12s\n", BenchScenarios[index].name, "not run");
+			continue;
+		}
+		printf("%-18s %12u %12u %13u %12llu\n", BenchScenarios[index].name, (unsigned)figures->eeprom_bytes,
+				(unsigned)figures->etho_bytes, (unsigned)figures->transactions, (unsigned long long)figures->us);
+		BenchCheck(BenchScenarios[index].name, "EEPROM bytes", figures->eeprom_bytes, limit->eeprom_bytes);
+		BenchCheck(BenchScenarios[index].name, "Etho bytes", figures->etho_bytes, limit->etho_bytes);
+		BenchCheck(BenchScenarios[index].name, "transactions", figures->transactions, limit->transactions);
+		BenchCheck(BenchScenarios[index].name, "modeled us", figures->us, limit->us);
+	}
+
+	for (index = 0; index < Bench->failures && index < BENCH_FAILURE_COUNT; index++) {
+		printf("FAIL: %s\n", Bench->failure[index]);
+	}
+	if (Bench->failures > BENCH_FAILURE_COUNT) {
+		printf("FAIL: %u more\n", (unsigned)(Bench->failures - BENCH_FAILURE_COUNT));
+	}
+	printf("%s\n", (Bench->failures == 0) ? "PASS" : "FAIL");
+	return (Bench->failures == 0) ? 0 : 1;
+}
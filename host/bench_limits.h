@@ -0,0 +1,72 @@
+/**\file bench_limits.h
+ * \brief <b>Limits of the host benchmark scenarios</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef BENCH_LIMITS_H_
+#define BENCH_LIMITS_H_
+
+//*****************************************************************************
+//
+// Upper limits for each benchmark scenario: bytes clocked on the EEPROM bus
+// (SSI0) and on the Ethernet Controller bus (SSI1), chip select cycles on both
+// buses, and modeled time in microseconds. A scenario over any limit fails the
+// benchmark. The limits are the measured figures plus roughly 10%; lower them
+// together with a change that improves a figure.
+//
+//*****************************************************************************
+#define BENCH_BOOT_EEPROM_BYTES			2450
+#define BENCH_BOOT_ETHO_BYTES			510
+#define BENCH_BOOT_TRANSACTIONS			810
+#define BENCH_BOOT_US					76000
+
+#define BENCH_VLAN_SET_EEPROM_BYTES		0
+#define BENCH_VLAN_SET_ETHO_BYTES		430
+#define BENCH_VLAN_SET_TRANSACTIONS		80
+#define BENCH_VLAN_SET_US				1100
+
+#define BENCH_VLAN_SHOW_EEPROM_BYTES	0
+#define BENCH_VLAN_SHOW_ETHO_BYTES		0
+#define BENCH_VLAN_SHOW_TRANSACTIONS	0
+#define BENCH_VLAN_SHOW_US				36000
+
+#define BENCH_SAVE_EEPROM_BYTES			4100
+#define BENCH_SAVE_ETHO_BYTES			0
+#define BENCH_SAVE_TRANSACTIONS			560
+#define BENCH_SAVE_US					56000
+
+#define BENCH_RESTORE_EEPROM_BYTES		5000
+#define BENCH_RESTORE_ETHO_BYTES		1150
+#define BENCH_RESTORE_TRANSACTIONS		740
+#define BENCH_RESTORE_US				66000
+
+#define BENCH_STATIC_MAC_EEPROM_BYTES	0
+#define BENCH_STATIC_MAC_ETHO_BYTES		500
+#define BENCH_STATIC_MAC_TRANSACTIONS	72
+#define BENCH_STATIC_MAC_US				1050
+
+#define BENCH_DYNAMIC_MAC_EEPROM_BYTES	0
+#define BENCH_DYNAMIC_MAC_ETHO_BYTES	660
+#define BENCH_DYNAMIC_MAC_TRANSACTIONS	88
+#define BENCH_DYNAMIC_MAC_US			1350
+
+#endif /* BENCH_LIMITS_H_ */
@@ -0,0 +1,167 @@
+/**\file eeprom_25aa1024_model.c
+ * \brief <b>Model of the 25AA1024 SPI EEPROM</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <string.h>
+#include "eeprom_25aa1024_model.h"
+
+#define EEPROM_MODEL_READ			0x03
+#define EEPROM_MODEL_WRITE			0x02
+#define EEPROM_MODEL_WREN			0x06
+#define EEPROM_MODEL_WRDI			0x04
+#define EEPROM_MODEL_RDSR			0x05
+#define EEPROM_MODEL_PE				0x42
+#define EEPROM_MODEL_SE				0xD8
+#define EEPROM_MODEL_CE				0xC7
+
+static bool EEPROMModelBusy(EEPROMModel *model)
+{
+	return (HostTimeNs() < model->busy_until);
+}
+
+static void EEPROMModelSelect(void *context)
+{
+	EEPROMModel *model = context;
+
+	model->position = 0;
+	model->command = 0;
+	model->address = 0;
+	model->write_pending = false;
+	model->erase_pending = 0;
+	memset(model->staged_valid, 0, sizeof(model->staged_valid));
+}
+
+//*****************************************************************************
+//
+//! Bringing CS high starts the write or erase cycle of the instruction that
+//! was clocked in, if the write enable latch was set.
+//
+//*****************************************************************************
+static void EEPROMModelDeselect(void *context)
+{
+	EEPROMModel *model = context;
+	uint32_t pos;
+
+	if (model->write_pending && model->wel) {
+		for (pos = 0; pos < EEPROM_MODEL_PAGE_SIZE; pos++) {
+			if (model->staged_valid[pos]) {
+				model->memory[model->page + pos] = model->staged[pos];
+			}
+		}
+		model->busy_until = HostTimeNs() + EEPROM_MODEL_WRITE_NS;
+		model->write_cycles++;
+		model->wel = false;
+	}
+	else if (model->erase_pending && model->wel) {
+		if (model->erase_pending == EEPROM_MODEL_CE) {
+			memset(model->memory, 0xFF, EEPROM_MODEL_SIZE);
+		}
+		else if (model->erase_pending == EEPROM_MODEL_SE) {
+			memset(&model->memory[model->address & ~(EEPROM_MODEL_SECTOR_SIZE - 1)], 0xFF, EEPROM_MODEL_SECTOR_SIZE);
+		}
+		else {
+			memset(&model->memory[model->address & ~(EEPROM_MODEL_PAGE_SIZE - 1)], 0xFF, EEPROM_MODEL_PAGE_SIZE);
+		}
+		model->busy_until = HostTimeNs() + ((model->erase_pending == EEPROM_MODEL_PE) ? EEPROM_MODEL_WRITE_NS : EEPROM_MODEL_ERASE_NS);
+		model->write_cycles++;
+		model->wel = false;
+	}
+	model->write_pending = false;
+	model->erase_pending = 0;
+}
+
+//*****************************************************************************
+//
+//! One byte of an instruction: the opcode, a 24-bit address for the memory
+//! instructions, then data. Writes wrap inside the page.
+//
+//*****************************************************************************
+static uint8_t EEPROMModelExchange(void *context, uint8_t mosi, uint32_t rate)
+{
+	EEPROMModel *model = context;
+	uint8_t miso = 0xFF;
+	uint32_t offset;
+
+	if (model->position == 0) {
+		model->command = mosi;
+		//Only the status register can be read during a write cycle
+		if (EEPROMModelBusy(model) && mosi != EEPROM_MODEL_RDSR) {
+			model->command = 0;
+		}
+		else if (mosi == EEPROM_MODEL_WREN) {
+			model->wel = true;
+		}
+		else if (mosi == EEPROM_MODEL_WRDI) {
+			model->wel = false;
+		}
+		else if (mosi == EEPROM_MODEL_CE) {
+			model->erase_pending = EEPROM_MODEL_CE;
+		}
+	}
+	else if (model->command == EEPROM_MODEL_RDSR) {
+		miso = (EEPROMModelBusy(model) ? 0x01 : 0x00) | (model->wel ? 0x02 : 0x00);
+	}
+	else if (model->position <= 3) {
+		model->address = ((model->address << 8) | mosi) & (EEPROM_MODEL_SIZE - 1);
+		if (model->position == 3) {
+			if (model->command == EEPROM_MODEL_WRITE) {
+				model->page = model->address & ~(EEPROM_MODEL_PAGE_SIZE - 1);
+			}
+			else if (model->command == EEPROM_MODEL_PE || model->command == EEPROM_MODEL_SE) {
+				model->erase_pending = model->command;
+			}
+		}
+	}
+	else if (model->command == EEPROM_MODEL_READ) {
+		miso = model->memory[model->address];
+		model->address = (model->address + 1) & (EEPROM_MODEL_SIZE - 1);
+	}
+	else if (model->command == EEPROM_MODEL_WRITE) {
+		offset = model->address & (EEPROM_MODEL_PAGE_SIZE - 1);
+		model->staged[offset] = mosi;
+		model->staged_valid[offset] = true;
+		model->write_pending = true;
+		model->address = model->page | ((offset + 1) & (EEPROM_MODEL_PAGE_SIZE - 1));
+	}
+	model->position++;
+
+	if (rate > EEPROM_MODEL_MAX_RATE) {
+		model->overclocked = true;
+		miso ^= 0x55;
+	}
+	return miso;
+}
+
+void EEPROMModelInit(EEPROMModel *model, uint8_t *memory)
+{
+	memset(model, 0, sizeof(*model));
+	model->memory = memory;
+}
+
+void EEPROMModelDevice(EEPROMModel *model, HostSPIDevice *device)
+{
+	device->select = EEPROMModelSelect;
+	device->exchange = EEPROMModelExchange;
+	device->deselect = EEPROMModelDeselect;
+	device->context = model;
+}
@@ -0,0 +1,72 @@
+/**\file eeprom_25aa1024_model.h
+ * \brief <b>Model of the 25AA1024 SPI EEPROM</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef EEPROM_25AA1024_MODEL_H_
+#define EEPROM_25AA1024_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "host_mock.h"
+
+//*****************************************************************************
+//
+// Model of the Microchip 25AA1024 SPI EEPROM: READ, WRITE with page wrap,
+// the write enable latch, the status register, page, sector and chip erase,
+// and the self-timed write cycle during which only RDSR is accepted.
+//
+//*****************************************************************************
+#define EEPROM_MODEL_SIZE			131072
+#define EEPROM_MODEL_PAGE_SIZE		256
+#define EEPROM_MODEL_SECTOR_SIZE	32768
+#define EEPROM_MODEL_MAX_RATE		10000000
+#define EEPROM_MODEL_WRITE_NS		6000000ULL
+#define EEPROM_MODEL_ERASE_NS		10000000ULL
+
+typedef struct
+{
+	//! Memory array, EEPROM_MODEL_SIZE bytes owned by the caller
+	uint8_t *memory;
+	//! Page being written, committed when CS goes high
+	uint8_t staged[EEPROM_MODEL_PAGE_SIZE];
+	bool staged_valid[EEPROM_MODEL_PAGE_SIZE];
+	uint32_t page;
+	bool write_pending;
+	uint8_t erase_pending;
+	//! Write enable latch
+	bool wel;
+	//! End of the current write cycle
+	uint64_t busy_until;
+	uint8_t command;
+	uint32_t address;
+	uint32_t position;
+	//! Number of write and erase cycles started
+	uint32_t write_cycles;
+	//! Set once a byte was clocked faster than the part allows
+	bool overclocked;
+} EEPROMModel;
+
+extern void EEPROMModelInit(EEPROMModel *model, uint8_t *memory);
+extern void EEPROMModelDevice(EEPROMModel *model, HostSPIDevice *device);
+
+#endif /* EEPROM_25AA1024_MODEL_H_ */
@@ -0,0 +1,111 @@
+/**\file host_mock.h
+ * \brief <b>Modeled time, interrupts, buses and kernel of the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef HOST_MOCK_H_
+#define HOST_MOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+// Modeled hardware. Time only moves when the firmware waits: every byte on an
+// SSI port takes 8 bit times at the rate programmed with SSIConfigSetExpClk(),
+// delays and blocking kernel calls advance to the next event, and every poll
+// of a status register costs HOST_POLL_NS. CPU time spent in firmware code is
+// not modeled, so the figures are a lower bound set by the buses.
+//
+//*****************************************************************************
+#define HOST_CPU_CLOCK_HZ			80000000
+#define HOST_POLL_NS				50
+#define HOST_UART_BAUD				115200
+#define HOST_EVENT_COUNT			16
+#define HOST_SPI_DEVICE_COUNT		2
+
+//*****************************************************************************
+//
+//! An SPI device on a chip select. select() and deselect() are called on the
+//! CS edges, exchange() once per byte with the rate the byte is clocked at.
+//
+//*****************************************************************************
+typedef struct
+{
+	void (*select)(void *context);
+	uint8_t (*exchange)(void *context, uint8_t mosi, uint32_t rate);
+	void (*deselect)(void *context);
+	void *context;
+} HostSPIDevice;
+
+//*****************************************************************************
+//
+//! Bus activity, kept per SSI port.
+//
+//*****************************************************************************
+typedef struct
+{
+	uint32_t transactions;
+	uint32_t bytes;
+	uint64_t busy_ns;
+	uint32_t max_rate;
+} HostBusCounters;
+
+//*****************************************************************************
+//
+// Modeled time and interrupts (mock_tivaware.c)
+//
+//*****************************************************************************
+extern uint64_t HostTimeNs(void);
+extern void HostAdvance(uint64_t ns);
+extern bool HostNextEvent(uint64_t *due);
+extern void HostEventAdd(uint64_t due, void (*handler)(void *), void *context);
+extern void HostIRQPend(void (*handler)(void));
+extern void HostIRQDeliver(void);
+extern bool HostIRQPending(void);
+extern bool HostInISR(void);
+
+//*****************************************************************************
+//
+// Buses and devices (mock_tivaware.c)
+//
+//*****************************************************************************
+extern void HostSPIAttach(uint32_t ssi_base, uint32_t cs_port, uint8_t cs_pin, const HostSPIDevice *device);
+extern void HostBusCountersGet(uint32_t ssi_base, HostBusCounters *counters);
+extern void HostBusCountersReset(void);
+extern void HostConsoleType(const char *keys);
+extern bool HostConsoleTypeNext(void);
+extern uint32_t HostConsoleOutput(char *buffer, uint32_t length);
+extern void HostConsoleOutputReset(void);
+
+//*****************************************************************************
+//
+// Kernel (mock_freertos.c)
+//
+//*****************************************************************************
+extern bool HostTaskRun(const char *name);
+extern bool HostTaskEnter(const char *name);
+extern bool HostSchedulerStart(int (*entry)(void));
+extern bool HostInterruptsEnabled(void);
+extern void HostFatal(const char *message);
+
+#endif /* HOST_MOCK_H_ */
@@ -0,0 +1,76 @@
+/**\file FreeRTOS.h
+ * \brief <b>FreeRTOS types for the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Stand-in for the FreeRTOS kernel headers used by the host benchmark. The
+// types and macros follow the TivaWare FreeRTOS port (heap_2, no static
+// allocation) and the repository's FreeRTOSConfig.h is used unchanged. The
+// kernel itself is modeled by host/mock_freertos.c.
+//
+//*****************************************************************************
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define portBASE_TYPE						long
+#define portTickType						TickType_t
+#define portCHAR							char
+#define portMAX_DELAY						((TickType_t)0xFFFFFFFF)
+#define portTICK_RATE_MS					((TickType_t)1000 / configTICK_RATE_HZ)
+#define portTICK_PERIOD_MS					portTICK_RATE_MS
+
+#define pdFALSE								((BaseType_t)0)
+#define pdTRUE								((BaseType_t)1)
+#define pdFAIL								pdFALSE
+#define pdPASS								pdTRUE
+
+#include "FreeRTOSConfig.h"
+
+//*****************************************************************************
+//
+// Interrupt masking. Pending interrupts of the models are delivered once the
+// last mask is cleared.
+//
+//*****************************************************************************
+extern uint32_t HostInterruptMask(void);
+extern void HostInterruptUnmask(uint32_t previous);
+extern void HostCriticalEnter(void);
+extern void HostCriticalExit(void);
+
+#define portSET_INTERRUPT_MASK_FROM_ISR()		HostInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x)	HostInterruptUnmask(x)
+#define portYIELD_FROM_ISR(x)					((void)(x))
+#define portENTER_CRITICAL()					HostCriticalEnter()
+#define portEXIT_CRITICAL()						HostCriticalExit()
+
+extern size_t xPortGetFreeHeapSize(void);
+
+#endif /* INC_FREERTOS_H */
@@ -0,0 +1,54 @@
+/**\file queue.h
+ * \brief <b>FreeRTOS queue API for the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef INC_QUEUE_H
+#define INC_QUEUE_H
+
+#include "FreeRTOS.h"
+
+//*****************************************************************************
+//
+// Queue API of the modeled kernel (see host/mock_freertos.c). Semaphores are
+// queues with an item size of zero, as in the real kernel.
+//
+//*****************************************************************************
+typedef struct HostQueue *QueueHandle_t;
+typedef QueueHandle_t xQueueHandle;
+
+extern QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize);
+extern BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait);
+extern BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue,
+		BaseType_t *pxHigherPriorityTaskWoken);
+extern BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait);
+extern BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken);
+extern BaseType_t xQueueReset(QueueHandle_t xQueue);
+extern UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue);
+extern UBaseType_t uxQueueMessagesWaitingFromISR(QueueHandle_t xQueue);
+extern void vQueueSetQueueNumber(QueueHandle_t xQueue, UBaseType_t uxQueueNumber);
+extern UBaseType_t uxQueueGetQueueNumber(QueueHandle_t xQueue);
+extern void vQueueAddToRegistry(QueueHandle_t xQueue, const char *pcQueueName);
+
+#define xQueueSendToBack(q, item, ticks)	xQueueSend((q), (item), (ticks))
+
+#endif /* INC_QUEUE_H */
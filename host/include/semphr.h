@@ -0,0 +1,50 @@
+/**\file semphr.h
+ * \brief <b>FreeRTOS semaphore API for the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "queue.h"
+
+//*****************************************************************************
+//
+// Semaphore API of the modeled kernel. A binary semaphore starts empty and a
+// mutex starts given. The modeled kernel runs one task at a time, so mutexes
+// need no priority inheritance.
+//
+//*****************************************************************************
+typedef QueueHandle_t SemaphoreHandle_t;
+typedef QueueHandle_t xSemaphoreHandle;
+
+extern SemaphoreHandle_t HostSemaphoreCreate(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount);
+
+#define xSemaphoreCreateBinary()					HostSemaphoreCreate(1, 0)
+#define xSemaphoreCreateMutex()						HostSemaphoreCreate(1, 1)
+#define xSemaphoreCreateRecursiveMutex()			HostSemaphoreCreate(1, 1)
+#define xSemaphoreTake(s, ticks)					xQueueReceive((s), NULL, (ticks))
+#define xSemaphoreGive(s)							xQueueSend((s), NULL, 0)
+#define xSemaphoreGiveFromISR(s, woken)				xQueueSendFromISR((s), NULL, (woken))
+#define xSemaphoreTakeFromISR(s, woken)				xQueueReceiveFromISR((s), NULL, (woken))
+
+#endif /* SEMAPHORE_H */
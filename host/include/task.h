@@ -0,0 +1,93 @@
+/**\file task.h
+ * \brief <b>FreeRTOS task API for the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+#include "FreeRTOS.h"
+
+//*****************************************************************************
+//
+// Task API of the modeled kernel (see host/mock_freertos.c).
+//
+//*****************************************************************************
+typedef struct HostTask *TaskHandle_t;
+typedef TaskHandle_t xTaskHandle;
+typedef void (*TaskFunction_t)(void *);
+typedef TaskFunction_t pdTASK_CODE;
+
+typedef enum
+{
+	eRunning = 0,
+	eReady,
+	eBlocked,
+	eSuspended,
+	eDeleted
+} eTaskState;
+
+typedef struct xTASK_STATUS
+{
+	TaskHandle_t xHandle;
+	const char *pcTaskName;
+	UBaseType_t xTaskNumber;
+	eTaskState eCurrentState;
+	UBaseType_t uxCurrentPriority;
+	UBaseType_t uxBasePriority;
+	uint32_t ulRunTimeCounter;
+	uint16_t usStackHighWaterMark;
+} TaskStatus_t;
+
+#define tskIDLE_PRIORITY					((UBaseType_t)0)
+#define taskSCHEDULER_SUSPENDED				((BaseType_t)0)
+#define taskSCHEDULER_NOT_STARTED			((BaseType_t)1)
+#define taskSCHEDULER_RUNNING				((BaseType_t)2)
+
+#define taskENTER_CRITICAL()				HostCriticalEnter()
+#define taskEXIT_CRITICAL()					HostCriticalExit()
+#define taskYIELD()
+
+extern BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char *pcName, uint16_t usStackDepth,
+		void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pxCreatedTask);
+extern void vTaskDelete(TaskHandle_t xTaskToDelete);
+extern void vTaskStartScheduler(void);
+extern void vTaskSuspendAll(void);
+extern BaseType_t xTaskResumeAll(void);
+extern void vTaskDelay(TickType_t xTicksToDelay);
+extern void vTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement);
+extern TickType_t xTaskGetTickCount(void);
+extern BaseType_t xTaskGetSchedulerState(void);
+extern TaskHandle_t xTaskGetCurrentTaskHandle(void);
+extern TaskHandle_t xTaskGetIdleTaskHandle(void);
+extern UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask);
+extern void vTaskSetTaskNumber(TaskHandle_t xTask, UBaseType_t uxHandle);
+extern UBaseType_t uxTaskGetSystemState(TaskStatus_t *pxTaskStatusArray, UBaseType_t uxArraySize,
+		uint32_t *pulTotalRunTime);
+extern UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+extern char *pcTaskGetTaskName(TaskHandle_t xTaskToQuery);
+extern eTaskState eTaskGetState(TaskHandle_t xTask);
+extern BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
+extern void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken);
+extern uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+#endif /* INC_TASK_H */
@@ -0,0 +1,370 @@
+/**\file tivaware_mock.h
+ * \brief <b>TivaWare declarations for the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef TIVAWARE_MOCK_H_
+#define TIVAWARE_MOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+// Stand-in for the TivaWare driver library (driverlib, inc/hw_*.h, uartstdio)
+// used by the host benchmark. Every driverlib header the firmware includes
+// resolves to this file. Base addresses and uDMA channel numbers are the real
+// TM4C123 values so that the firmware's own tables keep working, the other
+// constants only need to be distinct.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Register access. HWREG() goes through a small register map so that the DWT
+// cycle counter follows the modeled time and NVIC_INT_CTRL reports an active
+// vector while a mocked interrupt handler runs.
+//
+//*****************************************************************************
+extern volatile uint32_t *HostRegister(uint32_t address);
+#define HWREG(x)						(*HostRegister((uint32_t)(x)))
+#define NVIC_INT_CTRL					0xE000ED04
+#define NVIC_INT_CTRL_VEC_ACT_M			0x000000FF
+
+//*****************************************************************************
+//
+// Memory map (inc/hw_memmap.h)
+//
+//*****************************************************************************
+#define WATCHDOG0_BASE					0x40000000
+#define GPIO_PORTA_BASE					0x40004000
+#define GPIO_PORTB_BASE					0x40005000
+#define GPIO_PORTC_BASE					0x40006000
+#define GPIO_PORTD_BASE					0x40007000
+#define SSI0_BASE						0x40008000
+#define SSI1_BASE						0x40009000
+#define UART0_BASE						0x4000C000
+#define UART1_BASE						0x4000D000
+#define I2C0_BASE						0x40020000
+#define GPIO_PORTE_BASE					0x40024000
+#define GPIO_PORTF_BASE					0x40025000
+#define TIMER3_BASE						0x40033000
+#define TIMER4_BASE						0x40034000
+#define TIMER5_BASE						0x40035000
+#define UDMA_BASE						0x400FF000
+
+#define SSI_O_DR						0x00000008
+#define UART_O_DR						0x00000000
+#define I2C_O_MCR						0x00000020
+
+//*****************************************************************************
+//
+// Interrupt assignments (inc/hw_ints.h)
+//
+//*****************************************************************************
+#define INT_GPIOE						20
+#define INT_UART1						22
+#define INT_SSI0						23
+#define INT_I2C0						24
+#define INT_WATCHDOG					34
+#define INT_SSI1						50
+#define INT_TIMER3A						51
+#define INT_TIMER4A						86
+#define INT_TIMER5A						108
+
+//*****************************************************************************
+//
+// sysctl.h
+//
+//*****************************************************************************
+#define SYSCTL_PERIPH_GPIOA				0xF0000800
+#define SYSCTL_PERIPH_GPIOB				0xF0000801
+#define SYSCTL_PERIPH_GPIOD				0xF0000803
+#define SYSCTL_PERIPH_GPIOE				0xF0000804
+#define SYSCTL_PERIPH_GPIOF				0xF0000805
+#define SYSCTL_PERIPH_I2C0				0xF0002000
+#define SYSCTL_PERIPH_SSI0				0xF0001C00
+#define SYSCTL_PERIPH_SSI1				0xF0001C01
+#define SYSCTL_PERIPH_TIMER3			0xF0000403
+#define SYSCTL_PERIPH_TIMER4			0xF0000404
+#define SYSCTL_PERIPH_TIMER5			0xF0000405
+#define SYSCTL_PERIPH_UART1				0xF0001801
+#define SYSCTL_PERIPH_UDMA				0xF0000C00
+#define SYSCTL_PERIPH_WDOG0				0xF0000000
+#define SYSCTL_SYSDIV_2_5				0xC1000000
+#define SYSCTL_USE_PLL					0x00000000
+#define SYSCTL_XTAL_25MHZ				0x00000640
+#define SYSCTL_OSC_MAIN					0x00000000
+#define SYSCTL_CAUSE_POR				0x00000002
+#define SYSCTL_CAUSE_SW					0x00000010
+
+extern void SysCtlClockSet(uint32_t ui32Config);
+extern uint32_t SysCtlClockGet(void);
+extern void SysCtlDelay(uint32_t ui32Count);
+extern void SysCtlPeripheralEnable(uint32_t ui32Peripheral);
+extern void SysCtlReset(void);
+extern uint32_t SysCtlResetCauseGet(void);
+extern void SysCtlResetCauseClear(uint32_t ui32Causes);
+
+//*****************************************************************************
+//
+// gpio.h and pin_map.h
+//
+//*****************************************************************************
+#define GPIO_PIN_0						0x00000001
+#define GPIO_PIN_1						0x00000002
+#define GPIO_PIN_2						0x00000004
+#define GPIO_PIN_3						0x00000008
+#define GPIO_PIN_4						0x00000010
+#define GPIO_PIN_5						0x00000020
+#define GPIO_PIN_6						0x00000040
+#define GPIO_PIN_7						0x00000080
+#define GPIO_FALLING_EDGE				0x00000000
+#define GPIO_RISING_EDGE				0x00000004
+#define GPIO_STRENGTH_2MA				0x00000001
+#define GPIO_PIN_TYPE_STD_WPU			0x0000000A
+#define GPIO_INT_PIN_6					0x00000040
+
+#define GPIO_PA2_SSI0CLK				0x00000802
+#define GPIO_PA3_SSI0FSS				0x00000C02
+#define GPIO_PA4_SSI0RX					0x00001002
+#define GPIO_PA5_SSI0TX					0x00001402
+#define GPIO_PB0_U1RX					0x00010001
+#define GPIO_PB1_U1TX					0x00010401
+#define GPIO_PB2_I2C0SCL				0x00010803
+#define GPIO_PB3_I2C0SDA				0x00010C03
+#define GPIO_PD0_SSI1CLK				0x00030002
+#define GPIO_PD1_SSI1FSS				0x00030402
+#define GPIO_PD2_SSI1RX					0x00030802
+#define GPIO_PD3_SSI1TX					0x00030C02
+
+extern void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val);
+extern int32_t GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeI2C(uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeI2CSCL(uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeSSI(uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins);
+extern void GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32Strength, uint32_t ui32PadType);
+extern void GPIOPinConfigure(uint32_t ui32PinConfig);
+extern void GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType);
+extern void GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags);
+extern void GPIOIntDisable(uint32_t ui32Port, uint32_t ui32IntFlags);
+extern void GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags);
+extern void GPIOIntRegister(uint32_t ui32Port, void (*pfnIntHandler)(void));
+extern void GPIOIntUnregister(uint32_t ui32Port);
+
+//*****************************************************************************
+//
+// ssi.h
+//
+//*****************************************************************************
+#define SSI_FRF_MOTO_MODE_0				0x00000000
+#define SSI_MODE_MASTER					0x00000000
+#define SSI_DMA_RX						0x00000001
+#define SSI_DMA_TX						0x00000002
+
+extern void SSIConfigSetExpClk(uint32_t ui32Base, uint32_t ui32SSIClk, uint32_t ui32Protocol, uint32_t ui32Mode,
+		uint32_t ui32BitRate, uint32_t ui32DataWidth);
+extern void SSIEnable(uint32_t ui32Base);
+extern void SSIDisable(uint32_t ui32Base);
+extern void SSIDataPut(uint32_t ui32Base, uint32_t ui32Data);
+extern void SSIDataGet(uint32_t ui32Base, uint32_t *pui32Data);
+extern int32_t SSIDataGetNonBlocking(uint32_t ui32Base, uint32_t *pui32Data);
+extern bool SSIBusy(uint32_t ui32Base);
+extern void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+extern void SSIDMADisable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+
+//*****************************************************************************
+//
+// timer.h
+//
+//*****************************************************************************
+#define TIMER_A							0x000000FF
+#define TIMER_CFG_ONE_SHOT				0x00000021
+#define TIMER_CFG_PERIODIC				0x00000022
+#define TIMER_TIMA_TIMEOUT				0x00000001
+
+extern void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config);
+extern void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value);
+extern void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer);
+extern uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+
+//*****************************************************************************
+//
+// udma.h
+//
+//*****************************************************************************
+typedef struct
+{
+	volatile void *pvSrcEndAddr;
+	volatile void *pvDstEndAddr;
+	volatile uint32_t ui32Control;
+	volatile uint32_t ui32Spare;
+} tDMAControlTable;
+
+#define UDMA_CHANNEL_SSI0RX				10
+#define UDMA_CHANNEL_SSI0TX				11
+#define UDMA_CHANNEL_UART1TX			23
+#define UDMA_CHANNEL_SSI1RX				24
+#define UDMA_CHANNEL_SSI1TX				25
+#define UDMA_CH10_SSI0RX				0x0000000A
+#define UDMA_CH11_SSI0TX				0x0000000B
+#define UDMA_CH23_UART1TX				0x00000017
+#define UDMA_CH24_SSI1RX				0x00000018
+#define UDMA_CH25_SSI1TX				0x00000019
+#define UDMA_PRI_SELECT					0x00000000
+#define UDMA_ALT_SELECT					0x00000020
+#define UDMA_ATTR_USEBURST				0x00000001
+#define UDMA_ATTR_ALTSELECT				0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY			0x00000004
+#define UDMA_ATTR_REQMASK				0x00000008
+#define UDMA_ATTR_ALL					0x0000000F
+#define UDMA_MODE_BASIC					0x00000001
+#define UDMA_SIZE_8						0x00000000
+#define UDMA_SRC_INC_8					0x00000000
+#define UDMA_SRC_INC_NONE				0x0C000000
+#define UDMA_DST_INC_8					0x00000000
+#define UDMA_DST_INC_NONE				0xC0000000
+#define UDMA_ARB_4						0x00008000
+
+extern void uDMAEnable(void);
+extern void uDMAControlBaseSet(void *pControlTable);
+extern void uDMAChannelAssign(uint32_t ui32Mapping);
+extern void uDMAChannelAttributeEnable(uint32_t ui32ChannelNum, uint32_t ui32Attr);
+extern void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr);
+extern void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control);
+extern void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode, void *pvSrcAddr,
+		void *pvDstAddr, uint32_t ui32TransferSize);
+extern void uDMAChannelEnable(uint32_t ui32ChannelNum);
+extern void uDMAChannelDisable(uint32_t ui32ChannelNum);
+extern bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum);
+extern uint32_t uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex);
+extern void uDMAIntClear(uint32_t ui32ChanMask);
+
+//*****************************************************************************
+//
+// uart.h and uartstdio.h
+//
+//*****************************************************************************
+#define UART_CONFIG_WLEN_8				0x00000060
+#define UART_CONFIG_STOP_ONE			0x00000000
+#define UART_CONFIG_PAR_NONE			0x00000000
+#define UART_FIFO_TX4_8					0x00000002
+#define UART_FIFO_RX4_8					0x00000010
+#define UART_INT_RT						0x00000040
+#define UART_INT_RX						0x00000010
+#define UART_DMA_TX						0x00000002
+#define UART_CLOCK_PIOSC				0x00000005
+
+extern void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk, uint32_t ui32Baud, uint32_t ui32Config);
+extern void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel, uint32_t ui32RxLevel);
+extern void UARTFIFOEnable(uint32_t ui32Base);
+extern void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern uint32_t UARTIntStatus(uint32_t ui32Base, bool bMasked);
+extern void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void UARTEnable(uint32_t ui32Base);
+extern void UARTCharPut(uint32_t ui32Base, unsigned char ucData);
+extern bool UARTCharsAvail(uint32_t ui32Base);
+extern int32_t UARTCharGetNonBlocking(uint32_t ui32Base);
+extern bool UARTBusy(uint32_t ui32Base);
+extern void UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+extern void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source);
+extern void UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock);
+extern void UARTprintf(const char *pcString, ...);
+
+//*****************************************************************************
+//
+// i2c.h and inc/hw_i2c.h
+//
+//*****************************************************************************
+#define I2C_MASTER_CMD_SINGLE_SEND					0x00000007
+#define I2C_MASTER_CMD_SINGLE_RECEIVE				0x00000007
+#define I2C_MASTER_CMD_BURST_SEND_START				0x00000003
+#define I2C_MASTER_CMD_BURST_SEND_CONT				0x00000001
+#define I2C_MASTER_CMD_BURST_SEND_FINISH			0x00000005
+#define I2C_MASTER_CMD_BURST_SEND_ERROR_STOP		0x00000004
+#define I2C_MASTER_CMD_BURST_RECEIVE_START			0x0000000B
+#define I2C_MASTER_CMD_BURST_RECEIVE_CONT			0x00000009
+#define I2C_MASTER_CMD_BURST_RECEIVE_FINISH			0x00000005
+#define I2C_MASTER_CMD_BURST_RECEIVE_ERROR_STOP		0x00000004
+#define I2C_MASTER_ERR_NONE							0x00000000
+#define I2C_SLAVE_ACT_RREQ							0x00000001
+#define I2C_SLAVE_ACT_TREQ							0x00000002
+#define I2C_SLAVE_INT_START							0x00000002
+#define I2C_SLAVE_INT_STOP							0x00000004
+#define I2C_SLAVE_INT_DATA							0x00000001
+
+extern void I2CMasterInitExpClk(uint32_t ui32Base, uint32_t ui32I2CClk, bool bFast);
+extern void I2CMasterSlaveAddrSet(uint32_t ui32Base, uint8_t ui8SlaveAddr, bool bReceive);
+extern void I2CMasterControl(uint32_t ui32Base, uint32_t ui32Cmd);
+extern bool I2CMasterBusy(uint32_t ui32Base);
+extern uint32_t I2CMasterErr(uint32_t ui32Base);
+extern void I2CMasterDataPut(uint32_t ui32Base, uint8_t ui8Data);
+extern uint32_t I2CMasterDataGet(uint32_t ui32Base);
+extern void I2CSlaveInit(uint32_t ui32Base, uint8_t ui8SlaveAddr);
+extern void I2CSlaveAddressSet(uint32_t ui32Base, uint8_t ui8AddrNum, uint8_t ui8SlaveAddr);
+extern void I2CSlaveEnable(uint32_t ui32Base);
+extern void I2CSlaveIntEnableEx(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern uint32_t I2CSlaveIntStatusEx(uint32_t ui32Base, bool bMasked);
+extern void I2CSlaveIntClearEx(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern uint32_t I2CSlaveStatus(uint32_t ui32Base);
+extern void I2CSlaveDataPut(uint32_t ui32Base, uint8_t ui8Data);
+extern uint32_t I2CSlaveDataGet(uint32_t ui32Base);
+extern void I2CSlaveACKOverride(uint32_t ui32Base, bool bEnable);
+extern void I2CSlaveACKValueSet(uint32_t ui32Base, bool bACK);
+
+//*****************************************************************************
+//
+// interrupt.h and watchdog.h
+//
+//*****************************************************************************
+extern void IntEnable(uint32_t ui32Interrupt);
+extern void IntDisable(uint32_t ui32Interrupt);
+extern void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority);
+extern void WatchdogReloadSet(uint32_t ui32Base, uint32_t ui32LoadVal);
+extern void WatchdogResetEnable(uint32_t ui32Base);
+extern void WatchdogEnable(uint32_t ui32Base);
+extern void WatchdogIntClear(uint32_t ui32Base);
+
+//*****************************************************************************
+//
+// rom.h. The ROM copies of the driver library are the same functions.
+//
+//*****************************************************************************
+#define ROM_GPIOPinConfigure			GPIOPinConfigure
+#define ROM_GPIOPinTypeUART				GPIOPinTypeUART
+#define ROM_IntEnable					IntEnable
+#define ROM_SysCtlClockGet				SysCtlClockGet
+#define ROM_SysCtlClockSet				SysCtlClockSet
+#define ROM_SysCtlDelay					SysCtlDelay
+#define ROM_SysCtlPeripheralEnable		SysCtlPeripheralEnable
+#define ROM_WatchdogEnable				WatchdogEnable
+#define ROM_WatchdogIntClear			WatchdogIntClear
+#define ROM_WatchdogReloadSet			WatchdogReloadSet
+#define ROM_WatchdogResetEnable			WatchdogResetEnable
+
+#endif /* TIVAWARE_MOCK_H_ */
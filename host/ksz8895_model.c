@@ -0,0 +1,181 @@
+/**\file ksz8895_model.c
+ * \brief <b>Register level model of the KSZ8895MLUB SPI interface</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <string.h>
+#include "ksz8895_model.h"
+
+#define KSZ8895_READ				0x03
+#define KSZ8895_WRITE				0x02
+#define KSZ8895_CHIP_ID				0x95
+#define KSZ8895_INDIRECT_CONTROL_0	0x6E
+#define KSZ8895_INDIRECT_CONTROL_1	0x6F
+#define KSZ8895_INDIRECT_DATA_8		0x70
+#define KSZ8895_TABLE_STATIC		0
+#define KSZ8895_TABLE_DYNAMIC		2
+#define KSZ8895_TABLE_MIB			3
+
+//*****************************************************************************
+//
+//! Runs the indirect access selected by the control registers. Writing the
+//! low address byte (0x6F) triggers it.
+//
+//*****************************************************************************
+static void KSZ8895ModelIndirect(KSZ8895Model *model)
+{
+	uint8_t control = model->regs[KSZ8895_INDIRECT_CONTROL_0];
+	uint32_t table = (control >> 2) & 0x03;
+	uint32_t index = ((control & 0x03) << 8) | model->regs[KSZ8895_INDIRECT_CONTROL_1];
+	uint8_t *entry = model->tables[table][index];
+
+	if ((control >> 4) & 1) {
+		memcpy(&model->regs[KSZ8895_INDIRECT_DATA_8], entry, KSZ8895_ENTRY_LENGTH);
+		if (table == KSZ8895_TABLE_MIB) {
+			//Counter valid (bit 6 of DATA_3)
+			model->regs[KSZ8895_INDIRECT_DATA_8 + 5] |= 0x40;
+		}
+	}
+	else if (table != KSZ8895_TABLE_DYNAMIC && table != KSZ8895_TABLE_MIB) {
+		memcpy(entry, &model->regs[KSZ8895_INDIRECT_DATA_8], KSZ8895_ENTRY_LENGTH);
+	}
+}
+
+static void KSZ8895ModelSelect(void *context)
+{
+	KSZ8895Model *model = context;
+
+	model->position = 0;
+}
+
+static void KSZ8895ModelDeselect(void *context)
+{
+}
+
+//*****************************************************************************
+//
+//! One byte of a transaction: command, register address, then data with the
+//! address incrementing after every byte.
+//
+//*****************************************************************************
+static uint8_t KSZ8895ModelExchange(void *context, uint8_t mosi, uint32_t rate)
+{
+	KSZ8895Model *model = context;
+	uint8_t miso = 0xFF;
+
+	if (model->position == 0) {
+		model->command = mosi;
+	}
+	else if (model->position == 1) {
+		model->address = mosi;
+	}
+	else if (model->command == KSZ8895_READ) {
+		miso = model->regs[model->address++];
+	}
+	else if (model->command == KSZ8895_WRITE) {
+		//The chip ID is read-only
+		if (model->address != 0x00) {
+			model->regs[model->address] = mosi;
+		}
+		if (model->address == KSZ8895_INDIRECT_CONTROL_1) {
+			KSZ8895ModelIndirect(model);
+		}
+		model->address++;
+	}
+	model->position++;
+
+	if (rate > KSZ8895_MAX_RATE) {
+		model->overclocked = true;
+		miso ^= 0x55;
+	}
+	return miso;
+}
+
+void KSZ8895ModelInit(KSZ8895Model *model)
+{
+	uint32_t index;
+
+	memset(model, 0, sizeof(*model));
+	model->regs[0x00] = KSZ8895_CHIP_ID;
+	model->regs[0x01] = 0x40;
+	for (index = 0; index < KSZ8895_TABLE_SIZE; index++) {
+		//Bit 7 of DATA_8: table empty
+		model->tables[KSZ8895_TABLE_DYNAMIC][index][0] = 0x80;
+	}
+}
+
+void KSZ8895ModelDevice(KSZ8895Model *model, HostSPIDevice *device)
+{
+	device->select = KSZ8895ModelSelect;
+	device->exchange = KSZ8895ModelExchange;
+	device->deselect = KSZ8895ModelDeselect;
+	device->context = model;
+}
+
+//*****************************************************************************
+//
+//! Adds an address to the dynamic MAC table. Every entry carries the number
+//! of valid entries minus one in bits 70-61.
+//
+//*****************************************************************************
+bool KSZ8895ModelLearn(KSZ8895Model *model, const uint8_t *mac, uint8_t port, uint8_t fid)
+{
+	uint32_t index, count;
+	uint8_t *entry;
+
+	if (model->learned >= KSZ8895_TABLE_SIZE) {
+		return false;
+	}
+	entry = model->tables[KSZ8895_TABLE_DYNAMIC][model->learned++];
+	entry[2] = fid & 0x7F;
+	memcpy(&entry[3], mac, 6);
+	entry[1] = port & 0x07;
+
+	count = model->learned - 1;
+	for (index = 0; index < model->learned; index++) {
+		entry = model->tables[KSZ8895_TABLE_DYNAMIC][index];
+		entry[0] = (count >> 3) & 0x7F;
+		entry[1] = (uint8_t)((entry[1] & 0x07) | ((count & 0x07) << 5));
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Writes a valid entry to the static MAC table. The firmware reads static
+//! entries from DATA_7, so the entry starts at byte 1.
+//
+//*****************************************************************************
+bool KSZ8895ModelStaticSet(KSZ8895Model *model, uint32_t index, const uint8_t *mac, uint8_t ports, uint8_t fid)
+{
+	uint8_t *entry;
+
+	if (index >= KSZ8895_TABLE_SIZE) {
+		return false;
+	}
+	entry = model->tables[KSZ8895_TABLE_STATIC][index];
+	entry[0] = 0;
+	entry[1] = (uint8_t)((fid & 0x7F) << 1) | 1;
+	entry[2] = 0x20 | (ports & 0x1F);
+	memcpy(&entry[3], mac, 6);
+	return true;
+}
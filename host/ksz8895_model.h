@@ -0,0 +1,65 @@
+/**\file ksz8895_model.h
+ * \brief <b>Register level model of the KSZ8895MLUB SPI interface</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef KSZ8895_MODEL_H_
+#define KSZ8895_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "host_mock.h"
+
+//*****************************************************************************
+//
+// Register level model of the Micrel KSZ8895MLUB SPI interface: the register
+// file with auto-increment, and the static MAC, VLAN, dynamic MAC and MIB
+// tables behind the indirect access registers (0x6E - 0x78).
+//
+//*****************************************************************************
+#define KSZ8895_REGISTER_COUNT		256
+#define KSZ8895_TABLE_SIZE			1024
+#define KSZ8895_ENTRY_LENGTH		9
+#define KSZ8895_MAX_RATE			25000000
+
+typedef struct
+{
+	//! Register file, 0x70 - 0x78 hold the data of the last indirect access
+	uint8_t regs[KSZ8895_REGISTER_COUNT];
+	//! Static MAC, VLAN, dynamic MAC and MIB tables, bytes in DATA_8 - DATA_0 order
+	uint8_t tables[4][KSZ8895_TABLE_SIZE][KSZ8895_ENTRY_LENGTH];
+	//! Number of entries in the dynamic MAC table
+	uint32_t learned;
+	//! Bytes clocked in the current transaction
+	uint32_t position;
+	uint8_t command;
+	uint8_t address;
+	//! Set once a byte was clocked faster than the part allows
+	bool overclocked;
+} KSZ8895Model;
+
+extern void KSZ8895ModelInit(KSZ8895Model *model);
+extern void KSZ8895ModelDevice(KSZ8895Model *model, HostSPIDevice *device);
+extern bool KSZ8895ModelLearn(KSZ8895Model *model, const uint8_t *mac, uint8_t port, uint8_t fid);
+extern bool KSZ8895ModelStaticSet(KSZ8895Model *model, uint32_t index, const uint8_t *mac, uint8_t ports, uint8_t fid);
+
+#endif /* KSZ8895_MODEL_H_ */
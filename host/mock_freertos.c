@@ -0,0 +1,661 @@
+/**\file mock_freertos.c
+ * \brief <b>Single-threaded model of the FreeRTOS kernel for the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "host_mock.h"
+
+//*****************************************************************************
+//
+// Single-threaded model of the FreeRTOS kernel. The firmware's main() runs up
+// to vTaskStartScheduler(), after which the benchmark runs a task function to
+// completion with HostTaskRun() or calls command functions on behalf of a task
+// after HostTaskEnter(). Other tasks never run. A call that would block first
+// lets the models catch up (pending interrupts, then the next timed event) and
+// only then times out; a wait without a timeout that nothing can satisfy is a
+// deadlock and stops the benchmark.
+//
+//*****************************************************************************
+#define HOST_TASK_COUNT				16
+#define HOST_TASK_NAME_LEN			16
+#define HOST_QUEUE_COUNT			48
+#define HOST_TICK_NS				(1000000000ULL / configTICK_RATE_HZ)
+
+//*****************************************************************************
+//
+// Allocation sizes charged to the modeled heap_2 heap: every block carries an
+// 8-byte header and is rounded up to 8 bytes. The control block sizes are
+// those of the TivaWare FreeRTOS port with trace and run time stats enabled.
+//
+//*****************************************************************************
+#define HOST_HEAP_BLOCK_HEADER		8
+#define HOST_HEAP_ALIGNMENT			8
+#define HOST_TCB_SIZE				96
+#define HOST_QUEUE_SIZE				80
+
+struct HostTask
+{
+	char name[HOST_TASK_NAME_LEN];
+	TaskFunction_t function;
+	void *parameters;
+	uint16_t stack_words;
+	UBaseType_t priority;
+	UBaseType_t number;
+	uint32_t notifications;
+	bool deleted;
+};
+
+struct HostQueue
+{
+	uint8_t *storage;
+	UBaseType_t length;
+	UBaseType_t item_size;
+	UBaseType_t count;
+	UBaseType_t head;
+	UBaseType_t number;
+	const char *name;
+};
+
+static struct HostTask HostTasks[HOST_TASK_COUNT];
+static uint32_t HostTaskCount = 0;
+static struct HostTask *HostCurrent = NULL;
+static struct HostTask *HostIdle = NULL;
+
+static struct HostQueue HostQueues[HOST_QUEUE_COUNT];
+static uint32_t HostQueueCount = 0;
+
+static BaseType_t HostSchedulerState = taskSCHEDULER_NOT_STARTED;
+static jmp_buf HostSchedulerJump;
+static jmp_buf HostTaskJump;
+static bool HostTaskRunning = false;
+
+static uint32_t HostMasked = 0;
+static uint32_t HostCriticalNesting = 0;
+static uint32_t HostSuspendNesting = 0;
+static size_t HostHeapUsed = 0;
+
+//*****************************************************************************
+//
+//! Stops the benchmark with a message. Used for conditions that would hang
+//! or crash the target (deadlocks, heap exhaustion, calls that never return).
+//
+//*****************************************************************************
+void HostFatal(const char *message)
+{
+	fflush(stdout);
+	fprintf(stderr, "\n[HOST] FATAL at %llu us in %s: %s\n", (unsigned long long)(HostTimeNs() / 1000),
+			(HostCurrent != NULL) ? HostCurrent->name : "main", message);
+	exit(2);
+}
+
+//*****************************************************************************
+//
+//! Returns true if interrupts may be delivered: the scheduler is running and
+//! neither BASEPRI nor a critical section masks them. The kernel keeps
+//! interrupts masked from the first kernel call until the scheduler starts.
+//
+//*****************************************************************************
+bool HostInterruptsEnabled(void)
+{
+	return (HostSchedulerState != taskSCHEDULER_NOT_STARTED && HostMasked == 0 && HostCriticalNesting == 0);
+}
+
+uint32_t HostInterruptMask(void)
+{
+	uint32_t previous = HostMasked;
+
+	HostMasked = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+	return previous;
+}
+
+void HostInterruptUnmask(uint32_t previous)
+{
+	HostMasked = previous;
+	HostIRQDeliver();
+}
+
+void HostCriticalEnter(void)
+{
+	HostCriticalNesting++;
+}
+
+void HostCriticalExit(void)
+{
+	if (HostCriticalNesting > 0 && --HostCriticalNesting == 0) {
+		HostIRQDeliver();
+	}
+}
+
+//*****************************************************************************
+//
+//! Charges an allocation to the modeled heap.
+//
+//*****************************************************************************
+static void HostHeapAllocate(size_t size)
+{
+	size = (size + HOST_HEAP_BLOCK_HEADER + HOST_HEAP_ALIGNMENT - 1) & ~(size_t)(HOST_HEAP_ALIGNMENT - 1);
+	if (HostHeapUsed + size > configTOTAL_HEAP_SIZE) {
+		HostFatal("heap_2 heap exhausted (configTOTAL_HEAP_SIZE)");
+	}
+	HostHeapUsed += size;
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+	return (configTOTAL_HEAP_SIZE - HostHeapUsed);
+}
+
+//*****************************************************************************
+//
+//! Waits until ready() holds for the queue or the timeout expires. Pending
+//! interrupts are delivered first, then time moves to the next model event,
+//! then the console operator gets to type the next scripted key.
+//
+//*****************************************************************************
+static bool HostWait(struct HostQueue *queue, bool (*ready)(struct HostQueue *), TickType_t ticks)
+{
+	uint64_t deadline = HostTimeNs() + ((uint64_t)ticks * HOST_TICK_NS);
+	uint64_t due;
+	char message[96];
+
+	while (!ready(queue)) {
+		if (ticks == 0) {
+			return false;
+		}
+		if (HostInISR()) {
+			HostFatal("blocking kernel call inside an interrupt handler");
+		}
+		if (HostIRQPending() && HostInterruptsEnabled()) {
+			HostIRQDeliver();
+			continue;
+		}
+		if (HostNextEvent(&due) && (ticks == portMAX_DELAY || due <= deadline)) {
+			HostAdvance((due > HostTimeNs()) ? (due - HostTimeNs()) : 0);
+			continue;
+		}
+		if (HostConsoleTypeNext()) {
+			continue;
+		}
+		if (ticks != portMAX_DELAY) {
+			HostAdvance(deadline - HostTimeNs());
+			return ready(queue);
+		}
+		snprintf(message, sizeof(message), "deadlock waiting forever on %s", (queue->name != NULL) ? queue->name : "a queue");
+		HostFatal(message);
+	}
+	return true;
+}
+
+static bool HostQueueHasItem(struct HostQueue *queue)
+{
+	return (queue->count > 0);
+}
+
+static bool HostQueueHasSpace(struct HostQueue *queue)
+{
+	return (queue->count < queue->length);
+}
+
+static struct HostQueue *HostQueueAllocate(UBaseType_t length, UBaseType_t item_size)
+{
+	struct HostQueue *queue;
+
+	if (HostQueueCount >= HOST_QUEUE_COUNT) {
+		HostFatal("too many queues for the modeled kernel");
+	}
+	HostHeapAllocate(HOST_QUEUE_SIZE + (length * item_size));
+	queue = &HostQueues[HostQueueCount++];
+	memset(queue, 0, sizeof(*queue));
+	queue->length = length;
+	queue->item_size = item_size;
+	if (item_size > 0) {
+		queue->storage = calloc(length, item_size);
+	}
+	return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+	return HostQueueAllocate(uxQueueLength, uxItemSize);
+}
+
+SemaphoreHandle_t HostSemaphoreCreate(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount)
+{
+	struct HostQueue *queue = HostQueueAllocate(uxMaxCount, 0);
+
+	queue->count = uxInitialCount;
+	return queue;
+}
+
+static void HostQueuePush(struct HostQueue *queue, const void *item)
+{
+	if (queue->item_size > 0) {
+		memcpy(&queue->storage[((queue->head + queue->count) % queue->length) * queue->item_size], item, queue->item_size);
+	}
+	queue->count++;
+	traceQUEUE_SEND(queue);
+}
+
+static void HostQueuePop(struct HostQueue *queue, void *item)
+{
+	if (queue->item_size > 0) {
+		if (item != NULL) {
+			memcpy(item, &queue->storage[queue->head * queue->item_size], queue->item_size);
+		}
+		queue->head = (queue->head + 1) % queue->length;
+	}
+	queue->count--;
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+{
+	if (!HostWait(xQueue, HostQueueHasSpace, xTicksToWait)) {
+		return pdFALSE;
+	}
+	HostQueuePush(xQueue, pvItemToQueue);
+	return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t xQueue, const void *pvItemToQueue, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	if (!HostQueueHasSpace(xQueue)) {
+		return pdFALSE;
+	}
+	HostQueuePush(xQueue, pvItemToQueue);
+	if (pxHigherPriorityTaskWoken != NULL) {
+		*pxHigherPriorityTaskWoken = pdTRUE;
+	}
+	return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+	if (!HostWait(xQueue, HostQueueHasItem, xTicksToWait)) {
+		return pdFALSE;
+	}
+	HostQueuePop(xQueue, pvBuffer);
+	return pdTRUE;
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void *pvBuffer, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	if (!HostQueueHasItem(xQueue)) {
+		return pdFALSE;
+	}
+	HostQueuePop(xQueue, pvBuffer);
+	return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue)
+{
+	xQueue->count = 0;
+	xQueue->head = 0;
+	return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+	return xQueue->count;
+}
+
+UBaseType_t uxQueueMessagesWaitingFromISR(QueueHandle_t xQueue)
+{
+	return xQueue->count;
+}
+
+void vQueueSetQueueNumber(QueueHandle_t xQueue, UBaseType_t uxQueueNumber)
+{
+	xQueue->number = uxQueueNumber;
+}
+
+UBaseType_t uxQueueGetQueueNumber(QueueHandle_t xQueue)
+{
+	return xQueue->number;
+}
+
+void vQueueAddToRegistry(QueueHandle_t xQueue, const char *pcQueueName)
+{
+	xQueue->name = pcQueueName;
+}
+
+//*****************************************************************************
+//
+// Tasks
+//
+//*****************************************************************************
+static struct HostTask *HostTaskFind(const char *name)
+{
+	uint32_t i;
+
+	for (i = 0; i < HostTaskCount; i++) {
+		if (strcmp(HostTasks[i].name, name) == 0) {
+			return &HostTasks[i];
+		}
+	}
+	return NULL;
+}
+
+static struct HostTask *HostTaskAdd(TaskFunction_t function, const char *name, uint16_t stack_words,
+		void *parameters, UBaseType_t priority)
+{
+	struct HostTask *task;
+
+	if (HostTaskCount >= HOST_TASK_COUNT) {
+		HostFatal("too many tasks for the modeled kernel");
+	}
+	HostHeapAllocate(HOST_TCB_SIZE + ((size_t)stack_words * 4));
+	task = &HostTasks[HostTaskCount++];
+	memset(task, 0, sizeof(*task));
+	strncpy(task->name, name, HOST_TASK_NAME_LEN - 1);
+	task->function = function;
+	task->parameters = parameters;
+	task->stack_words = stack_words;
+	task->priority = priority;
+	return task;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char *pcName, uint16_t usStackDepth,
+		void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pxCreatedTask)
+{
+	struct HostTask *task = HostTaskAdd(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority);
+
+	if (pxCreatedTask != NULL) {
+		*pxCreatedTask = task;
+	}
+	return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+	struct HostTask *task = (xTaskToDelete != NULL) ? xTaskToDelete : HostCurrent;
+
+	if (task == NULL) {
+		return;
+	}
+	task->deleted = true;
+	if (task == HostCurrent && HostTaskRunning) {
+		longjmp(HostTaskJump, 1);
+	}
+}
+
+//*****************************************************************************
+//
+//! Starts the scheduler: the idle task is created, interrupts are unmasked
+//! and control returns to HostSchedulerStart().
+//
+//*****************************************************************************
+void vTaskStartScheduler(void)
+{
+	HostIdle = HostTaskAdd(NULL, "IDLE", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY);
+	HostSchedulerState = taskSCHEDULER_RUNNING;
+	HostCriticalNesting = 0;
+	HostMasked = 0;
+	longjmp(HostSchedulerJump, 1);
+}
+
+//*****************************************************************************
+//
+//! Runs the firmware's main() until it starts the scheduler.
+//!
+//! \param entry the firmware's main()
+//!
+//! \return Returns true once the scheduler was started
+//
+//*****************************************************************************
+bool HostSchedulerStart(int (*entry)(void))
+{
+	if (setjmp(HostSchedulerJump) == 0) {
+		entry();
+		HostFatal("main() returned without starting the scheduler");
+	}
+	HostIRQDeliver();
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Runs a task function until it deletes itself.
+//!
+//! \param name the name the task was created with
+//!
+//! \return Returns false if there is no such task
+//
+//*****************************************************************************
+bool HostTaskRun(const char *name)
+{
+	struct HostTask *task = HostTaskFind(name);
+
+	if (task == NULL || task->deleted || task->function == NULL) {
+		return false;
+	}
+	HostCurrent = task;
+	HostTaskRunning = true;
+	if (setjmp(HostTaskJump) == 0) {
+		task->function(task->parameters);
+		HostFatal("task function returned");
+	}
+	HostTaskRunning = false;
+	HostCurrent = NULL;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Makes the following calls run on behalf of a task, for example command
+//! functions called the way the interpreter task calls them.
+//!
+//! \param name the name the task was created with
+//!
+//! \return Returns false if there is no such task
+//
+//*****************************************************************************
+bool HostTaskEnter(const char *name)
+{
+	struct HostTask *task = HostTaskFind(name);
+
+	if (task == NULL || task->deleted) {
+		return false;
+	}
+	HostCurrent = task;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Suspends the scheduler. Interrupts stay enabled, only blocking calls are
+//! refused until the matching xTaskResumeAll().
+//
+//*****************************************************************************
+void vTaskSuspendAll(void)
+{
+	HostSuspendNesting++;
+	HostSchedulerState = taskSCHEDULER_SUSPENDED;
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+	if (HostSuspendNesting == 0) {
+		HostFatal("xTaskResumeAll() without vTaskSuspendAll()");
+	}
+	if (--HostSuspendNesting == 0) {
+		HostSchedulerState = taskSCHEDULER_RUNNING;
+	}
+	return pdFALSE;
+}
+
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+	if (HostSuspendNesting != 0) {
+		HostFatal("vTaskDelay() with the scheduler suspended");
+	}
+	HostAdvance((uint64_t)xTicksToDelay * HOST_TICK_NS);
+}
+
+void vTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement)
+{
+	TickType_t wake = *pxPreviousWakeTime + xTimeIncrement;
+	TickType_t now = xTaskGetTickCount();
+
+	if ((TickType_t)(wake - now) < (portMAX_DELAY / 2)) {
+		vTaskDelay(wake - now);
+	}
+	*pxPreviousWakeTime = wake;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+	return (TickType_t)(HostTimeNs() / HOST_TICK_NS);
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+	return HostSchedulerState;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+	return HostCurrent;
+}
+
+TaskHandle_t xTaskGetIdleTaskHandle(void)
+{
+	return HostIdle;
+}
+
+UBaseType_t uxTaskGetTaskNumber(TaskHandle_t xTask)
+{
+	return (xTask != NULL) ? xTask->number : 0;
+}
+
+void vTaskSetTaskNumber(TaskHandle_t xTask, UBaseType_t uxHandle)
+{
+	if (xTask != NULL) {
+		xTask->number = uxHandle;
+	}
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *pxTaskStatusArray, UBaseType_t uxArraySize, uint32_t *pulTotalRunTime)
+{
+	UBaseType_t count = 0;
+	uint32_t i;
+
+	for (i = 0; i < HostTaskCount && count < uxArraySize; i++) {
+		if (HostTasks[i].deleted) {
+			continue;
+		}
+		pxTaskStatusArray[count].xHandle = &HostTasks[i];
+		pxTaskStatusArray[count].pcTaskName = HostTasks[i].name;
+		pxTaskStatusArray[count].xTaskNumber = HostTasks[i].number;
+		pxTaskStatusArray[count].eCurrentState = (&HostTasks[i] == HostCurrent) ? eRunning : eBlocked;
+		pxTaskStatusArray[count].uxCurrentPriority = HostTasks[i].priority;
+		pxTaskStatusArray[count].uxBasePriority = HostTasks[i].priority;
+		pxTaskStatusArray[count].ulRunTimeCounter = 0;
+		pxTaskStatusArray[count].usStackHighWaterMark = HostTasks[i].stack_words;
+		count++;
+	}
+	if (pulTotalRunTime != NULL) {
+		*pulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
+	}
+	return count;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+	struct HostTask *task = (xTask != NULL) ? xTask : HostCurrent;
+
+	return (task != NULL) ? task->stack_words : 0;
+}
+
+char *pcTaskGetTaskName(TaskHandle_t xTaskToQuery)
+{
+	struct HostTask *task = (xTaskToQuery != NULL) ? xTaskToQuery : HostCurrent;
+
+	return (task != NULL) ? task->name : "main";
+}
+
+eTaskState eTaskGetState(TaskHandle_t xTask)
+{
+	if (xTask == NULL || xTask->deleted) {
+		return eDeleted;
+	}
+	return (xTask == HostCurrent) ? eRunning : eBlocked;
+}
+
+//*****************************************************************************
+//
+// Direct to task notifications. Only the running task can wait for one.
+//
+//*****************************************************************************
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+	xTaskToNotify->notifications++;
+	return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	xTaskToNotify->notifications++;
+	if (pxHigherPriorityTaskWoken != NULL) {
+		*pxHigherPriorityTaskWoken = pdTRUE;
+	}
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+	uint64_t deadline = HostTimeNs() + ((uint64_t)xTicksToWait * HOST_TICK_NS);
+	uint32_t count;
+	uint64_t due;
+
+	if (HostCurrent == NULL) {
+		HostFatal("ulTaskNotifyTake() outside of a task");
+	}
+	while (HostCurrent->notifications == 0 && xTicksToWait != 0) {
+		if (HostIRQPending() && HostInterruptsEnabled()) {
+			HostIRQDeliver();
+		}
+		else if (HostNextEvent(&due) && (xTicksToWait == portMAX_DELAY || due <= deadline)) {
+			HostAdvance((due > HostTimeNs()) ? (due - HostTimeNs()) : 0);
+		}
+		else if (xTicksToWait != portMAX_DELAY) {
+			HostAdvance(deadline - HostTimeNs());
+			break;
+		}
+		else {
+			HostFatal("deadlock waiting forever on a task notification");
+		}
+	}
+	count = HostCurrent->notifications;
+	if (count > 0) {
+		HostCurrent->notifications = xClearCountOnExit ? 0 : (count - 1);
+	}
+	return count;
+}
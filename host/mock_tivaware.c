@@ -0,0 +1,867 @@
+/**\file mock_tivaware.c
+ * \brief <b>Model of the TM4C123 peripherals for the host benchmark</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tivaware_mock.h"
+#include "host_mock.h"
+
+//*****************************************************************************
+//
+// Model of the TM4C123 peripherals the firmware drives: the SSI ports with
+// their uDMA channels and GPIO chip selects, UART1 with its TX channel, the
+// delay timers and the DWT cycle counter. I2C, the watchdog and the NVIC only
+// accept their configuration.
+//
+//*****************************************************************************
+#define HOST_SSI_PORT_COUNT			2
+#define HOST_SSI_FIFO_DEPTH			8
+#define HOST_IRQ_COUNT				8
+#define HOST_GPIO_PORT_COUNT		6
+#define HOST_DMA_CHANNEL_COUNT		32
+#define HOST_REGISTER_COUNT			16
+#define HOST_CONSOLE_OUTPUT_SIZE	65536
+#define HOST_CONSOLE_INPUT_SIZE		256
+#define HOST_UART_CHAR_NS			(10ULL * 1000000000ULL / HOST_UART_BAUD)
+#define HOST_CYCLES(ns)				((uint32_t)(((ns) * (HOST_CPU_CLOCK_HZ / 1000000ULL)) / 1000ULL))
+#define HOST_NS(cycles)				(((uint64_t)(cycles) * 1000ULL) / (HOST_CPU_CLOCK_HZ / 1000000ULL))
+
+//*****************************************************************************
+//
+// Interrupt handlers of the firmware raised by the models
+//
+//*****************************************************************************
+extern void SSI0IntHandler(void);
+extern void SSI1IntHandler(void);
+extern void DelayTimerIntHandler(void);
+extern void ConsoleUARTIntHandler(void);
+
+typedef struct
+{
+	uint64_t due;
+	void (*handler)(void *);
+	void *context;
+	bool used;
+} HostEvent;
+
+typedef struct
+{
+	uint32_t ssi_base;
+	uint32_t cs_port;
+	uint8_t cs_pin;
+	bool selected;
+	HostSPIDevice device;
+} HostSPISlot;
+
+typedef struct
+{
+	uint32_t base;
+	uint32_t rate;
+	uint32_t rx_channel;
+	uint32_t tx_channel;
+	void (*handler)(void);
+	uint8_t fifo[HOST_SSI_FIFO_DEPTH];
+	uint32_t fifo_count;
+	uint64_t busy_until;
+	HostBusCounters counters;
+} HostSSIPort;
+
+typedef struct
+{
+	uint32_t control;
+	uint8_t *source;
+	uint8_t *destination;
+	uint32_t size;
+	uint32_t remaining;
+	uint64_t started;
+	uint64_t due;
+	bool enabled;
+} HostDMAChannel;
+
+static uint64_t HostNow = 0;
+static HostEvent HostEvents[HOST_EVENT_COUNT];
+static void (*HostIRQs[HOST_IRQ_COUNT])(void);
+static uint32_t HostIRQCount = 0;
+static bool HostISRActive = false;
+
+static HostSPISlot HostSPISlots[HOST_SPI_DEVICE_COUNT];
+static uint32_t HostSPISlotCount = 0;
+static HostSSIPort HostSSIPorts[HOST_SSI_PORT_COUNT] = {
+	{SSI0_BASE, 1000000, UDMA_CHANNEL_SSI0RX, UDMA_CHANNEL_SSI0TX, SSI0IntHandler},
+	{SSI1_BASE, 1000000, UDMA_CHANNEL_SSI1RX, UDMA_CHANNEL_SSI1TX, SSI1IntHandler}
+};
+static HostDMAChannel HostDMAChannels[HOST_DMA_CHANNEL_COUNT];
+
+static const uint32_t HostGPIOBases[HOST_GPIO_PORT_COUNT] = {
+	GPIO_PORTA_BASE, GPIO_PORTB_BASE, GPIO_PORTC_BASE, GPIO_PORTD_BASE, GPIO_PORTE_BASE, GPIO_PORTF_BASE
+};
+static uint8_t HostGPIOLevels[HOST_GPIO_PORT_COUNT] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static uint32_t HostTimebaseLoad = 0xFFFFFFFF;
+static uint64_t HostTimebaseStart = 0;
+static uint32_t HostOneShotLoad = 0;
+static uint64_t HostOneShotDue = 0;
+static bool HostOneShotArmed = false;
+
+static char HostConsoleOut[HOST_CONSOLE_OUTPUT_SIZE];
+static uint32_t HostConsoleOutLength = 0;
+static char HostConsoleIn[HOST_CONSOLE_INPUT_SIZE];
+static uint32_t HostConsoleInHead = 0, HostConsoleInTail = 0;
+static int32_t HostUARTRx = -1;
+
+static uint32_t HostRegisterAddress[HOST_REGISTER_COUNT];
+static volatile uint32_t HostRegisterValue[HOST_REGISTER_COUNT];
+static uint32_t HostRegisterCount = 0;
+static uint32_t HostCycleBase = 0;
+
+//*****************************************************************************
+//
+// Modeled time and interrupts
+//
+//*****************************************************************************
+uint64_t HostTimeNs(void)
+{
+	return HostNow;
+}
+
+bool HostInISR(void)
+{
+	return HostISRActive;
+}
+
+void HostEventAdd(uint64_t due, void (*handler)(void *), void *context)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOST_EVENT_COUNT; i++) {
+		if (!HostEvents[i].used) {
+			HostEvents[i].due = due;
+			HostEvents[i].handler = handler;
+			HostEvents[i].context = context;
+			HostEvents[i].used = true;
+			return;
+		}
+	}
+	HostFatal("too many pending model events");
+}
+
+bool HostNextEvent(uint64_t *due)
+{
+	bool found = false;
+	uint32_t i;
+
+	for (i = 0; i < HOST_EVENT_COUNT; i++) {
+		if (HostEvents[i].used && (!found || HostEvents[i].due < *due)) {
+			*due = HostEvents[i].due;
+			found = true;
+		}
+	}
+	return found;
+}
+
+//*****************************************************************************
+//
+//! Moves modeled time forward, firing every event that falls due on the way,
+//! and delivers the interrupts they raised if interrupts are enabled.
+//
+//*****************************************************************************
+void HostAdvance(uint64_t ns)
+{
+	uint64_t target = HostNow + ns;
+	uint64_t due;
+	uint32_t i;
+
+	while (HostNextEvent(&due) && due <= target) {
+		for (i = 0; i < HOST_EVENT_COUNT; i++) {
+			if (HostEvents[i].used && HostEvents[i].due == due) {
+				HostEvents[i].used = false;
+				if (due > HostNow) {
+					HostNow = due;
+				}
+				HostEvents[i].handler(HostEvents[i].context);
+				break;
+			}
+		}
+	}
+	HostNow = target;
+	HostIRQDeliver();
+}
+
+void HostIRQPend(void (*handler)(void))
+{
+	uint32_t i;
+
+	for (i = 0; i < HostIRQCount; i++) {
+		if (HostIRQs[i] == handler) {
+			return;
+		}
+	}
+	if (HostIRQCount >= HOST_IRQ_COUNT) {
+		HostFatal("too many pending interrupts");
+	}
+	HostIRQs[HostIRQCount++] = handler;
+}
+
+bool HostIRQPending(void)
+{
+	return (HostIRQCount > 0);
+}
+
+//*****************************************************************************
+//
+//! Runs the pending interrupt handlers in the order they were raised. Handlers
+//! do not nest.
+//
+//*****************************************************************************
+void HostIRQDeliver(void)
+{
+	void (*handler)(void);
+
+	while (HostIRQCount > 0 && !HostISRActive && HostInterruptsEnabled()) {
+		handler = HostIRQs[0];
+		memmove(&HostIRQs[0], &HostIRQs[1], (--HostIRQCount) * sizeof(HostIRQs[0]));
+		HostISRActive = true;
+		handler();
+		HostISRActive = false;
+	}
+}
+
+//*****************************************************************************
+//
+//! Register map behind HWREG(). The DWT cycle counter runs with the modeled
+//! time and NVIC_INT_CTRL reports an active vector inside a handler.
+//
+//*****************************************************************************
+volatile uint32_t *HostRegister(uint32_t address)
+{
+	uint32_t i, cycles;
+
+	for (i = 0; i < HostRegisterCount; i++) {
+		if (HostRegisterAddress[i] == address) {
+			break;
+		}
+	}
+	if (i == HostRegisterCount) {
+		if (HostRegisterCount >= HOST_REGISTER_COUNT) {
+			HostFatal("too many registers accessed through HWREG()");
+		}
+		HostRegisterAddress[i] = address;
+		HostRegisterValue[i] = 0;
+		HostRegisterCount++;
+	}
+	if (address == 0xE0001004) {
+		//DWT_CYCCNT, a write from the firmware is kept as the new origin
+		cycles = HOST_CYCLES(HostNow);
+		HostRegisterValue[i] += cycles - HostCycleBase;
+		HostCycleBase = cycles;
+	}
+	else if (address == NVIC_INT_CTRL) {
+		HostRegisterValue[i] = HostISRActive ? 0x10 : 0x00;
+	}
+	return &HostRegisterValue[i];
+}
+
+//*****************************************************************************
+//
+// System control
+//
+//*****************************************************************************
+void SysCtlClockSet(uint32_t ui32Config)
+{
+}
+
+uint32_t SysCtlClockGet(void)
+{
+	return HOST_CPU_CLOCK_HZ;
+}
+
+void SysCtlDelay(uint32_t ui32Count)
+{
+	//Three cycles per loop
+	HostAdvance(HOST_NS((uint64_t)ui32Count * 3));
+}
+
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+}
+
+void SysCtlReset(void)
+{
+	HostFatal("SysCtlReset()");
+}
+
+//*****************************************************************************
+//
+//! Every benchmark boot starts with freshly reset device models, as after
+//! a power-on reset.
+//
+//*****************************************************************************
+static uint32_t HostResetCause = SYSCTL_CAUSE_POR;
+
+uint32_t SysCtlResetCauseGet(void)
+{
+	return HostResetCause;
+}
+
+void SysCtlResetCauseClear(uint32_t ui32Causes)
+{
+	HostResetCause &= ~ui32Causes;
+}
+
+//*****************************************************************************
+//
+// GPIO. Chip selects of attached SPI devices are followed on every write.
+//
+//*****************************************************************************
+static int32_t HostGPIOIndex(uint32_t port)
+{
+	int32_t i;
+
+	for (i = 0; i < HOST_GPIO_PORT_COUNT; i++) {
+		if (HostGPIOBases[i] == port) {
+			return i;
+		}
+	}
+	HostFatal("unknown GPIO port");
+	return 0;
+}
+
+static HostSSIPort *HostSSIFind(uint32_t base)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOST_SSI_PORT_COUNT; i++) {
+		if (HostSSIPorts[i].base == base) {
+			return &HostSSIPorts[i];
+		}
+	}
+	HostFatal("unknown SSI port");
+	return NULL;
+}
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+	int32_t index = HostGPIOIndex(ui32Port);
+	uint32_t i;
+	bool low;
+
+	HostGPIOLevels[index] = (HostGPIOLevels[index] & ~ui8Pins) | (ui8Val & ui8Pins);
+
+	for (i = 0; i < HostSPISlotCount; i++) {
+		if (HostSPISlots[i].cs_port != ui32Port || !(HostSPISlots[i].cs_pin & ui8Pins)) {
+			continue;
+		}
+		low = !(HostGPIOLevels[index] & HostSPISlots[i].cs_pin);
+		if (low && !HostSPISlots[i].selected) {
+			HostSPISlots[i].selected = true;
+			HostSSIFind(HostSPISlots[i].ssi_base)->counters.transactions++;
+			HostSPISlots[i].device.select(HostSPISlots[i].device.context);
+		}
+		else if (!low && HostSPISlots[i].selected) {
+			HostSPISlots[i].selected = false;
+			HostSPISlots[i].device.deselect(HostSPISlots[i].device.context);
+		}
+	}
+}
+
+int32_t GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+	return (HostGPIOLevels[HostGPIOIndex(ui32Port)] & ui8Pins);
+}
+
+void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeI2C(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeI2CSCL(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeSSI(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32Strength, uint32_t ui32PadType) {}
+void GPIOPinConfigure(uint32_t ui32PinConfig) {}
+void GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType) {}
+void GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags) {}
+void GPIOIntDisable(uint32_t ui32Port, uint32_t ui32IntFlags) {}
+void GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags) {}
+void GPIOIntRegister(uint32_t ui32Port, void (*pfnIntHandler)(void)) {}
+void GPIOIntUnregister(uint32_t ui32Port) {}
+
+//*****************************************************************************
+//
+// SSI. A byte is exchanged with the device whose chip select is low; with no
+// device selected the bus floats high.
+//
+//*****************************************************************************
+void HostSPIAttach(uint32_t ssi_base, uint32_t cs_port, uint8_t cs_pin, const HostSPIDevice *device)
+{
+	if (HostSPISlotCount >= HOST_SPI_DEVICE_COUNT) {
+		HostFatal("too many SPI devices");
+	}
+	HostSPISlots[HostSPISlotCount].ssi_base = ssi_base;
+	HostSPISlots[HostSPISlotCount].cs_port = cs_port;
+	HostSPISlots[HostSPISlotCount].cs_pin = cs_pin;
+	HostSPISlots[HostSPISlotCount].selected = !(HostGPIOLevels[HostGPIOIndex(cs_port)] & cs_pin);
+	HostSPISlots[HostSPISlotCount].device = *device;
+	HostSPISlotCount++;
+}
+
+static uint8_t HostSSIExchange(HostSSIPort *port, uint8_t mosi)
+{
+	uint8_t miso = 0xFF;
+	uint32_t i;
+
+	for (i = 0; i < HostSPISlotCount; i++) {
+		if (HostSPISlots[i].ssi_base == port->base && HostSPISlots[i].selected) {
+			miso = HostSPISlots[i].device.exchange(HostSPISlots[i].device.context, mosi, port->rate);
+		}
+	}
+	port->counters.bytes++;
+	port->counters.busy_ns += (8ULL * 1000000000ULL) / port->rate;
+	if (port->rate > port->counters.max_rate) {
+		port->counters.max_rate = port->rate;
+	}
+	return miso;
+}
+
+void HostBusCountersGet(uint32_t ssi_base, HostBusCounters *counters)
+{
+	*counters = HostSSIFind(ssi_base)->counters;
+}
+
+void HostBusCountersReset(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < HOST_SSI_PORT_COUNT; i++) {
+		memset(&HostSSIPorts[i].counters, 0, sizeof(HostSSIPorts[i].counters));
+	}
+}
+
+//*****************************************************************************
+//
+//! Same divider search as the driver library: the rate is the SSI clock over
+//! an even prescaler times (1 + SCR).
+//
+//*****************************************************************************
+void SSIConfigSetExpClk(uint32_t ui32Base, uint32_t ui32SSIClk, uint32_t ui32Protocol, uint32_t ui32Mode,
+		uint32_t ui32BitRate, uint32_t ui32DataWidth)
+{
+	uint32_t max_bit_rate = ui32SSIClk / ui32BitRate;
+	uint32_t prescale = 0, scr;
+
+	do {
+		prescale += 2;
+		scr = (max_bit_rate / prescale) - 1;
+	} while (scr > 255);
+
+	HostSSIFind(ui32Base)->rate = ui32SSIClk / (prescale * (1 + scr));
+}
+
+void SSIEnable(uint32_t ui32Base) {}
+void SSIDisable(uint32_t ui32Base) {}
+
+void SSIDataPut(uint32_t ui32Base, uint32_t ui32Data)
+{
+	HostSSIPort *port = HostSSIFind(ui32Base);
+	uint8_t miso = HostSSIExchange(port, (uint8_t)ui32Data);
+
+	if (port->fifo_count >= HOST_SSI_FIFO_DEPTH) {
+		HostFatal("SSI receive FIFO overrun");
+	}
+	port->fifo[port->fifo_count++] = miso;
+	HostAdvance((8ULL * 1000000000ULL) / port->rate);
+}
+
+static bool HostSSIPop(HostSSIPort *port, uint32_t *data)
+{
+	if (port->fifo_count == 0) {
+		return false;
+	}
+	*data = port->fifo[0];
+	memmove(&port->fifo[0], &port->fifo[1], --port->fifo_count);
+	return true;
+}
+
+void SSIDataGet(uint32_t ui32Base, uint32_t *pui32Data)
+{
+	if (!HostSSIPop(HostSSIFind(ui32Base), pui32Data)) {
+		HostFatal("SSIDataGet() on an empty receive FIFO would never return");
+	}
+}
+
+int32_t SSIDataGetNonBlocking(uint32_t ui32Base, uint32_t *pui32Data)
+{
+	return HostSSIPop(HostSSIFind(ui32Base), pui32Data) ? 1 : 0;
+}
+
+bool SSIBusy(uint32_t ui32Base)
+{
+	HostSSIPort *port = HostSSIFind(ui32Base);
+
+	HostAdvance(HOST_POLL_NS);
+	return (HostNow < port->busy_until);
+}
+
+//*****************************************************************************
+//
+//! Retires an SSI uDMA transfer once its last byte has been clocked.
+//
+//*****************************************************************************
+static void HostSSIDMAComplete(void *context)
+{
+	HostSSIPort *port = context;
+	HostDMAChannel *rx = &HostDMAChannels[port->rx_channel];
+	HostDMAChannel *tx = &HostDMAChannels[port->tx_channel];
+
+	if (!rx->enabled || HostNow < rx->due) {
+		return;
+	}
+	rx->enabled = false;
+	tx->enabled = false;
+	rx->remaining = 0;
+	tx->remaining = 0;
+	HostIRQPend(port->handler);
+}
+
+//*****************************************************************************
+//
+//! Raising the request lines runs the armed RX and TX channels. The bytes are
+//! exchanged at once and the channels finish after the time the bus takes to
+//! clock them.
+//
+//*****************************************************************************
+void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+	HostSSIPort *port = HostSSIFind(ui32Base);
+	HostDMAChannel *rx = &HostDMAChannels[port->rx_channel];
+	HostDMAChannel *tx = &HostDMAChannels[port->tx_channel];
+	uint32_t pos;
+	uint8_t miso;
+
+	if ((ui32DMAFlags & (SSI_DMA_RX | SSI_DMA_TX)) != (SSI_DMA_RX | SSI_DMA_TX) || !rx->enabled || !tx->enabled) {
+		return;
+	}
+	if (rx->size != tx->size) {
+		HostFatal("SSI RX and TX channels armed with different lengths");
+	}
+	for (pos = 0; pos < tx->size; pos++) {
+		miso = HostSSIExchange(port, tx->source[((tx->control & UDMA_SRC_INC_NONE) == UDMA_SRC_INC_NONE) ? 0 : pos]);
+		rx->destination[((rx->control & UDMA_DST_INC_NONE) == UDMA_DST_INC_NONE) ? 0 : pos] = miso;
+	}
+	rx->started = HostNow;
+	rx->due = HostNow + ((uint64_t)tx->size * 8ULL * 1000000000ULL) / port->rate;
+	tx->due = rx->due;
+	port->busy_until = rx->due;
+	HostEventAdd(rx->due, HostSSIDMAComplete, port);
+}
+
+void SSIDMADisable(uint32_t ui32Base, uint32_t ui32DMAFlags) {}
+
+//*****************************************************************************
+//
+// uDMA
+//
+//*****************************************************************************
+void uDMAEnable(void) {}
+void uDMAControlBaseSet(void *pControlTable) {}
+void uDMAChannelAssign(uint32_t ui32Mapping) {}
+void uDMAChannelAttributeEnable(uint32_t ui32ChannelNum, uint32_t ui32Attr) {}
+void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr) {}
+
+void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+	HostDMAChannels[ui32ChannelStructIndex & 0x1F].control = ui32Control;
+}
+
+void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode, void *pvSrcAddr,
+		void *pvDstAddr, uint32_t ui32TransferSize)
+{
+	HostDMAChannel *channel = &HostDMAChannels[ui32ChannelStructIndex & 0x1F];
+
+	channel->source = pvSrcAddr;
+	channel->destination = pvDstAddr;
+	channel->size = ui32TransferSize;
+	channel->remaining = ui32TransferSize;
+}
+
+//*****************************************************************************
+//
+//! Retires a console transfer once the UART has shifted out the last byte.
+//
+//*****************************************************************************
+static void HostUARTDMAComplete(void *context)
+{
+	HostDMAChannel *channel = context;
+
+	if (!channel->enabled || HostNow < channel->due) {
+		return;
+	}
+	channel->enabled = false;
+	channel->remaining = 0;
+	HostIRQPend(ConsoleUARTIntHandler);
+}
+
+static void HostConsoleWrite(const char *data, uint32_t length)
+{
+	if (getenv("BENCH_VERBOSE") != NULL) {
+		fwrite(data, 1, length, stdout);
+	}
+	if (length > (HOST_CONSOLE_OUTPUT_SIZE - HostConsoleOutLength)) {
+		length = HOST_CONSOLE_OUTPUT_SIZE - HostConsoleOutLength;
+	}
+	memcpy(&HostConsoleOut[HostConsoleOutLength], data, length);
+	HostConsoleOutLength += length;
+}
+
+void uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+	HostDMAChannel *channel = &HostDMAChannels[ui32ChannelNum & 0x1F];
+
+	channel->enabled = true;
+	if ((ui32ChannelNum & 0x1F) == UDMA_CHANNEL_UART1TX) {
+		HostConsoleWrite((const char *)channel->source, channel->size);
+		channel->started = HostNow;
+		channel->due = HostNow + (channel->size * HOST_UART_CHAR_NS);
+		HostEventAdd(channel->due, HostUARTDMAComplete, channel);
+	}
+}
+
+void uDMAChannelDisable(uint32_t ui32ChannelNum)
+{
+	HostDMAChannel *channel = &HostDMAChannels[ui32ChannelNum & 0x1F];
+
+	if (channel->enabled && HostNow < channel->due) {
+		channel->remaining = channel->size - (uint32_t)((HostNow - channel->started) * channel->size / (channel->due - channel->started));
+	}
+	channel->enabled = false;
+}
+
+bool uDMAChannelIsEnabled(uint32_t ui32ChannelNum)
+{
+	HostAdvance(HOST_POLL_NS);
+	return HostDMAChannels[ui32ChannelNum & 0x1F].enabled;
+}
+
+uint32_t uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex)
+{
+	return HostDMAChannels[ui32ChannelStructIndex & 0x1F].remaining;
+}
+
+void uDMAIntClear(uint32_t ui32ChanMask) {}
+
+//*****************************************************************************
+//
+// Timers. TIMER5 is the free running timebase of delayUs(), TIMER4 the
+// one-shot that wakes a task sleeping in delayUs().
+//
+//*****************************************************************************
+static void HostOneShotExpired(void *context)
+{
+	if (!HostOneShotArmed || HostNow < HostOneShotDue) {
+		return;
+	}
+	HostOneShotArmed = false;
+	HostIRQPend(DelayTimerIntHandler);
+}
+
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config) {}
+
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+	if (ui32Base == TIMER5_BASE) {
+		HostTimebaseLoad = ui32Value;
+	}
+	else if (ui32Base == TIMER4_BASE) {
+		HostOneShotLoad = ui32Value;
+	}
+}
+
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	if (ui32Base == TIMER5_BASE) {
+		HostTimebaseStart = HostNow;
+	}
+	else if (ui32Base == TIMER4_BASE) {
+		HostOneShotArmed = true;
+		HostOneShotDue = HostNow + HOST_NS(HostOneShotLoad);
+		HostEventAdd(HostOneShotDue, HostOneShotExpired, NULL);
+	}
+}
+
+void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	if (ui32Base == TIMER4_BASE) {
+		HostOneShotArmed = false;
+	}
+}
+
+uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	HostAdvance(HOST_POLL_NS);
+	if (ui32Base == TIMER5_BASE) {
+		//Counts down from the load value
+		return HostTimebaseLoad - HOST_CYCLES(HostNow - HostTimebaseStart);
+	}
+	return 0;
+}
+
+void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+
+//*****************************************************************************
+//
+// UART1, the console. Output is kept for the benchmark, input is typed from a
+// script one character at a time whenever the firmware waits for it.
+//
+//*****************************************************************************
+void UARTConfigSetExpClk(uint32_t ui32Base, uint32_t ui32UARTClk, uint32_t ui32Baud, uint32_t ui32Config) {}
+void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel, uint32_t ui32RxLevel) {}
+void UARTFIFOEnable(uint32_t ui32Base) {}
+void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+void UARTEnable(uint32_t ui32Base) {}
+void UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags) {}
+void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source) {}
+void UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock) {}
+
+uint32_t UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+	return (HostUARTRx >= 0) ? UART_INT_RX : 0;
+}
+
+void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+
+void UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+	char data = (char)ucData;
+
+	HostConsoleWrite(&data, 1);
+	HostAdvance(HOST_UART_CHAR_NS);
+}
+
+bool UARTCharsAvail(uint32_t ui32Base)
+{
+	return (HostUARTRx >= 0);
+}
+
+int32_t UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+	int32_t data = HostUARTRx;
+
+	HostUARTRx = -1;
+	return data;
+}
+
+bool UARTBusy(uint32_t ui32Base)
+{
+	return false;
+}
+
+void UARTprintf(const char *pcString, ...)
+{
+	char buffer[256];
+	va_list vaArgP;
+	int length;
+
+	va_start(vaArgP, pcString);
+	length = vsnprintf(buffer, sizeof(buffer), pcString, vaArgP);
+	va_end(vaArgP);
+	if (length > 0) {
+		HostConsoleWrite(buffer, ((uint32_t)length < sizeof(buffer)) ? (uint32_t)length : (sizeof(buffer) - 1));
+	}
+}
+
+void HostConsoleType(const char *keys)
+{
+	while (*keys != '\0' && (HostConsoleInHead - HostConsoleInTail) < HOST_CONSOLE_INPUT_SIZE) {
+		HostConsoleIn[HostConsoleInHead++ % HOST_CONSOLE_INPUT_SIZE] = *keys++;
+	}
+}
+
+//*****************************************************************************
+//
+//! Puts the next scripted key into the receive FIFO and raises the UART
+//! interrupt. Called by the kernel model when the firmware would otherwise
+//! wait forever.
+//
+//*****************************************************************************
+bool HostConsoleTypeNext(void)
+{
+	if (HostUARTRx >= 0 || HostConsoleInTail == HostConsoleInHead) {
+		return false;
+	}
+	HostUARTRx = (uint8_t)HostConsoleIn[HostConsoleInTail++ % HOST_CONSOLE_INPUT_SIZE];
+	HostAdvance(HOST_UART_CHAR_NS);
+	HostIRQPend(ConsoleUARTIntHandler);
+	HostIRQDeliver();
+	return true;
+}
+
+uint32_t HostConsoleOutput(char *buffer, uint32_t length)
+{
+	if (length > HostConsoleOutLength) {
+		length = HostConsoleOutLength;
+	}
+	memcpy(buffer, HostConsoleOut, length);
+	return length;
+}
+
+void HostConsoleOutputReset(void)
+{
+	HostConsoleOutLength = 0;
+}
+
+//*****************************************************************************
+//
+// I2C, interrupt controller and watchdog. The I2C slave never sees a master
+// in the benchmark.
+//
+//*****************************************************************************
+void I2CMasterInitExpClk(uint32_t ui32Base, uint32_t ui32I2CClk, bool bFast) {}
+void I2CMasterSlaveAddrSet(uint32_t ui32Base, uint8_t ui8SlaveAddr, bool bReceive) {}
+void I2CMasterControl(uint32_t ui32Base, uint32_t ui32Cmd) {}
+bool I2CMasterBusy(uint32_t ui32Base) { return false; }
+uint32_t I2CMasterErr(uint32_t ui32Base) { return I2C_MASTER_ERR_NONE; }
+void I2CMasterDataPut(uint32_t ui32Base, uint8_t ui8Data) {}
+uint32_t I2CMasterDataGet(uint32_t ui32Base) { return 0; }
+void I2CSlaveInit(uint32_t ui32Base, uint8_t ui8SlaveAddr) {}
+void I2CSlaveAddressSet(uint32_t ui32Base, uint8_t ui8AddrNum, uint8_t ui8SlaveAddr) {}
+void I2CSlaveEnable(uint32_t ui32Base) {}
+void I2CSlaveIntEnableEx(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+uint32_t I2CSlaveIntStatusEx(uint32_t ui32Base, bool bMasked) { return 0; }
+void I2CSlaveIntClearEx(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+uint32_t I2CSlaveStatus(uint32_t ui32Base) { return 0; }
+void I2CSlaveDataPut(uint32_t ui32Base, uint8_t ui8Data) {}
+uint32_t I2CSlaveDataGet(uint32_t ui32Base) { return 0; }
+void I2CSlaveACKOverride(uint32_t ui32Base, bool bEnable) {}
+void I2CSlaveACKValueSet(uint32_t ui32Base, bool bACK) {}
+
+void IntEnable(uint32_t ui32Interrupt) {}
+void IntDisable(uint32_t ui32Interrupt) {}
+void IntPrioritySet(uint32_t ui32Interrupt, uint8_t ui8Priority) {}
+void WatchdogReloadSet(uint32_t ui32Base, uint32_t ui32LoadVal) {}
+void WatchdogResetEnable(uint32_t ui32Base) {}
+void WatchdogEnable(uint32_t ui32Base) {}
+void WatchdogIntClear(uint32_t ui32Base) {}
@@ -32,11 +32,14 @@
 #include "driverlib/rom.h"
 #include "drivers/rgb.h"
 #include "drivers/buttons.h"
-#include "utils/uartstdio.h"
+#include "console.h"
 #include "i2c_task.h"
 #include "i2c.h"
 #include "freertos_init.h"
+#include "boot_task.h"
+#include "spi_arbiter.h"
 #include "priorities.h"
+#include "memory_budget.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -44,19 +47,330 @@
 
 //*****************************************************************************
 //
-//! An external handle to the I2C Interface Mutex that blocks other tasks
-//! from using the resource until it becomes available.
+//! States of the I2C slave. A write transaction is received into a frame
+//! from its first byte until it holds as many bytes as its command needs.
+//! Bytes of a rejected or already complete frame are not acknowledged.
 //
 //*****************************************************************************
-extern xSemaphoreHandle g_pI2CSemaphore;
+typedef enum {
+	//! Waiting for the command code of the next frame
+	I2CSlaveIdle,
+	//! Receiving the parameters of the frame in I2CFrame
+	I2CSlaveReceive,
+	//! The frame is complete and queued, further bytes are refused
+	I2CSlaveComplete,
+	//! The frame was rejected, the rest of the transaction is refused
+	I2CSlaveDiscard
+} I2CSlaveState;
 
 //*****************************************************************************
 //
-//! A handle to the I2C queue that gets filled by the I2C ISR.
+//! A handle to the I2C queue that gets filled by the I2C ISR. It carries
+//! indices into I2CFrames.
 //
 //*****************************************************************************
-xQueueHandle g_pI2CQueue;
+xQueueHandle g_pI2CQueue = NULL;
 
+//*****************************************************************************
+//
+//! Frames and the mask of those not in use. A frame is owned by the ISR
+//! while it is received and by the I2C task from the queue until it has run
+//! its command.
+//
+//*****************************************************************************
+static I2C_Packet I2CFrames[I2C_FRAME_COUNT];
+static volatile uint32_t I2CFramesFree = ((1 << I2C_FRAME_COUNT) - 1);
+
+//*****************************************************************************
+//
+//! Receive state: the frame being received and the number of bytes it needs,
+//! 0 while the length of a variable frame is not known yet.
+//
+//*****************************************************************************
+static I2CSlaveState I2CState = I2CSlaveIdle;
+static uint8_t I2CFrame = I2C_NO_FRAME;
+static uint32_t I2CFrameLength = 0;
+
+//*****************************************************************************
+//
+//! The response read by the master: the number of values followed by the
+//! values. The I2C task only builds a response while I2CResponsePending is not
+//! zero, the ISR only sends one while it is zero. A read that arrives while
+//! commands are pending is held (the slave stretches the clock) until the
+//! I2C task posts the response to the newest command.
+//
+//*****************************************************************************
+static uint8_t I2CResponse[I2C_RESPONSE_SIZE + 1] = {0};
+static uint32_t I2CResponseLength = 1;
+static uint32_t I2CResponseIndex = 0;
+static volatile uint32_t I2CResponsePending = 0;
+static volatile bool I2CResponseHeld = false;
+
+//*****************************************************************************
+//
+//! Counters reported by I2CSlaveStatsGet().
+//
+//*****************************************************************************
+static I2CSlaveStats I2CCounters = {0};
+
+//*****************************************************************************
+//
+//! Ends the frame being received, returning it to the pool.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void I2CFrameDrop(void)
+{
+	if (I2CFrame != I2C_NO_FRAME) {
+		I2CFramesFree |= (1 << I2CFrame);
+		I2CFrame = I2C_NO_FRAME;
+	}
+	//The master learns that the command did not run from an empty response
+	if (I2CResponsePending == 0) {
+		I2CResponse[0] = 0;
+		I2CResponseLength = 1;
+	}
+}
+
+//*****************************************************************************
+//
+//! Rejects the rest of the transaction. Bytes are no longer acknowledged, so
+//! the master sees a NACK instead of the command silently being lost.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void I2CSlaveReject(void)
+{
+	I2CFrameDrop();
+	I2CState = I2CSlaveDiscard;
+	I2CSlaveACKValueSet(I2C_BASE_ADDR, false);
+}
+
+//*****************************************************************************
+//
+//! Handles a byte written by the master. The first byte selects the command,
+//! which sets how many parameters must follow. Called from the I2C ISR.
+//!
+//! \param value the byte received
+//! \param pxHigherPriorityTaskWoken set if the I2C task was woken
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void I2CSlaveReceiveByte(uint8_t value, portBASE_TYPE *pxHigherPriorityTaskWoken)
+{
+	I2C_Packet *frame;
+	uint8_t index;
+
+	if (I2CState == I2CSlaveIdle) {
+		//Nothing can take frames if the I2C task was not created
+		if (value >= MAX_I2C_COMMAND || I2C_Mappings[value].command_code != value || g_pI2CQueue == NULL) {
+			I2CCounters.rejected++;
+			I2CSlaveReject();
+			return;
+		}
+		for (index = 0; index < I2C_FRAME_COUNT; index++) {
+			if (I2CFramesFree & (1 << index)) {
+				break;
+			}
+		}
+		if (index == I2C_FRAME_COUNT) {
+			I2CCounters.overruns++;
+			I2CSlaveReject();
+			return;
+		}
+		I2CFramesFree &= ~(1 << index);
+		I2CFrame = index;
+		I2CFrames[index].I2CRXIndex = 0;
+		I2CFrameLength = (I2C_Mappings[value].custom_pcount == I2C_VARIABLE_PCOUNT) ? 0 : (1 + I2C_Mappings[value].custom_pcount);
+		I2CState = I2CSlaveReceive;
+	}
+	else if (I2CState == I2CSlaveComplete) {
+		//More bytes than the command takes
+		I2CCounters.rejected++;
+		I2CState = I2CSlaveDiscard;
+		I2CSlaveACKValueSet(I2C_BASE_ADDR, false);
+		return;
+	}
+	else if (I2CState != I2CSlaveReceive) {
+		return;
+	}
+
+	frame = &I2CFrames[I2CFrame];
+	frame->I2CRXBuffer[frame->I2CRXIndex++] = value;
+
+	//The second byte of a variable frame is the number of bytes that follow
+	if (I2CFrameLength == 0 && frame->I2CRXIndex == 2) {
+		if (value > I2C_VARIABLE_MAX_LENGTH) {
+			I2CCounters.rejected++;
+			I2CSlaveReject();
+			return;
+		}
+		I2CFrameLength = 2 + value;
+	}
+	if (I2CFrameLength == 0 || frame->I2CRXIndex < I2CFrameLength) {
+		return;
+	}
+
+	//The frame is complete, hand it to the I2C task. The queue holds every frame so this cannot fail.
+	if (xQueueSendFromISR(g_pI2CQueue, &I2CFrame, pxHigherPriorityTaskWoken) != pdPASS) {
+		I2CCounters.overruns++;
+		I2CSlaveReject();
+		return;
+	}
+	I2CResponsePending++;
+	I2CCounters.frames++;
+	I2CFrame = I2C_NO_FRAME;
+	I2CState = I2CSlaveComplete;
+	I2CSlaveACKValueSet(I2C_BASE_ADDR, false);
+}
+
+//*****************************************************************************
+//
+//! Handles a byte requested by the master. While commands are pending the
+//! request is left unanswered, which holds the clock low until
+//! I2CResponsePost() sends the first byte. Called from the I2C ISR.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void I2CSlaveSendByte(void)
+{
+	if (I2CResponsePending != 0) {
+		I2CResponseHeld = true;
+		return;
+	}
+	I2CSlaveDataPut(I2C_BASE_ADDR, (I2CResponseIndex < I2CResponseLength) ? I2CResponse[I2CResponseIndex++] : I2C_RESPONSE_PAD);
+}
+
+//*****************************************************************************
+//
+//! Handles a START or STOP condition. A frame that is not complete when its
+//! transaction ends is dropped. Called from the I2C ISR.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void I2CSlaveTransactionEnd(void)
+{
+	if (I2CState == I2CSlaveReceive) {
+		I2CCounters.short_frames++;
+		I2CFrameDrop();
+	}
+	I2CState = I2CSlaveIdle;
+	I2CResponseIndex = 0;
+	//Refuse the next frame straight away if there is nowhere to put it
+	I2CSlaveACKValueSet(I2C_BASE_ADDR, I2CFramesFree != 0);
+}
+
+//*****************************************************************************
+//
+//! Interrupt handler for all I2C communication. Detects when a valid command has
+//! been issued by checking the number of parameters sent over I2C. Once validated,
+//! the frame is passed to the I2C task, which calls the function pointer that will
+//! execute the users' request.
+//! EXAMPLE:
+//! 	<START BIT> <7-bit ADDRESS + W> <I2C CODE> <PARAMETER N> <PARAMETER N+1> <END>
+//!
+//! The master then reads the values returned by the command in one transaction:
+//! 	<START BIT> <7-bit ADDRESS + R> <NUMBER OF VALUES> <VALUE 1> ... <VALUE N> <END>
+//!
+//! Unknown command codes, bad lengths and frames arriving while every frame is
+//! in use are not acknowledged. Nothing is printed from here, the counters can be
+//! read with I2CSlaveStatsGet().
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void I2C0SlaveIntHandler(void)
+{
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+	uint32_t int_status = I2CSlaveIntStatusEx(I2C_BASE_ADDR, true);
+	uint32_t slave_status;
+
+	I2CSlaveIntClearEx(I2C_BASE_ADDR, int_status);
+
+	//A repeated START also ends the transaction before it
+	if (int_status & I2C_SLAVE_INT_START) {
+		I2CSlaveTransactionEnd();
+	}
+	if (int_status & I2C_SLAVE_INT_DATA) {
+		slave_status = I2CSlaveStatus(I2C_BASE_ADDR);
+		if (slave_status & I2C_SLAVE_ACT_RREQ) {
+			I2CSlaveReceiveByte((uint8_t)I2CSlaveDataGet(I2C_BASE_ADDR), &xHigherPriorityTaskWoken);
+		}
+		else if (slave_status & I2C_SLAVE_ACT_TREQ) {
+			I2CSlaveSendByte();
+		}
+	}
+	if (int_status & I2C_SLAVE_INT_STOP) {
+		I2CSlaveTransactionEnd();
+	}
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+//*****************************************************************************
+//
+//! Adds values to the response of the command being run. Only called by
+//! commands run by the I2C task.
+//!
+//! \param data the values
+//! \param length number of values
+//!
+//! \return Returns false if the response is full, nothing is added then.
+//
+//*****************************************************************************
+bool I2CResponseAppend(const uint8_t *data, uint32_t length)
+{
+	if (I2CResponseLength + length > I2C_RESPONSE_SIZE + 1) {
+		return false;
+	}
+	while (length--) {
+		I2CResponse[I2CResponseLength++] = *data++;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Completes the response of a command. If the master is already waiting to
+//! read and no other command is pending, its first byte is sent.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void I2CResponsePost(void)
+{
+	I2CResponse[0] = (uint8_t)(I2CResponseLength - 1);
+
+	taskENTER_CRITICAL();
+	I2CResponseIndex = 0;
+	I2CResponsePending--;
+	if (I2CResponsePending == 0 && I2CResponseHeld) {
+		I2CResponseHeld = false;
+		I2CSlaveDataPut(I2C_BASE_ADDR, I2CResponse[I2CResponseIndex++]);
+	}
+	taskEXIT_CRITICAL();
+}
+
+//*****************************************************************************
+//
+//! Copies the counters kept by the I2C ISR.
+//!
+//! \param stats receives the counters
+//!
+//! \return None.
+//
+//*****************************************************************************
+void I2CSlaveStatsGet(I2CSlaveStats *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = I2CCounters;
+	taskEXIT_CRITICAL();
+}
 
 //*****************************************************************************
 //
@@ -67,59 +381,73 @@ xQueueHandle g_pI2CQueue;
 //! However, there are a few functions that require additional information after
 //! the command code to be recognized as valid commands. For more information
 //! regarding this refer to i2c_task.h
+//!
+//! Frames arrive already validated by the I2C ISR. Frames rejected by the ISR
+//! are reported on the console once the bus is quiet.
 //
 //*****************************************************************************
 static void I2CManagerTask(void *pvParameters)
 {
-	I2C_Packet data;
+	uint8_t frame;
+	I2C_Packet *data;
+	const I2C_Codes *code;
+	I2CSlaveStats stats, reported = {0};
+
+	//Requests from the I2C master are served ahead of command-line and background work
+	SPIArbiterSetPriority(SPIPriorityHigh);
 
     while(1)
     {
         //
         // Read the next message, if available on queue.
         //
-        if(xQueueReceive(g_pI2CQueue, &data, (portTICK_PERIOD_MS*100)) == pdPASS)
+        if(xQueueReceive(g_pI2CQueue, &frame, (portTICK_PERIOD_MS*100)) == pdPASS)
         {
         	int i = 0;
         	uint8_t  functionParameters[MAX_PARAMS] = {0x00};
-        	//COMMAND CODE
-        	if (data.I2CRXBuffer[0] < MAX_I2C_COMMAND) {
+        	uint8_t returnValue;
 
-        		//Gather all static parameters for function call, skip first item since it's our command code.
-        		if (I2C_Mappings[data.I2CRXBuffer[0]].static_pcount != NO_PARAMETERS)
-        		{
-        			for (i = 0; i < I2C_Mappings[data.I2CRXBuffer[0]].static_pcount; i++) {
-        				functionParameters[i] = I2C_Mappings[data.I2CRXBuffer[0]].static_parameters[i];
-        			}
-        		}
+        	data = &I2CFrames[frame];
+        	code = &I2C_Mappings[data->I2CRXBuffer[0]];
+
+        	//Gather all static parameters for function call, skip first item since it's our command code.
+        	for (i = 0; i < code->static_pcount; i++) {
+        		functionParameters[i] = code->static_parameters[i];
+        	}
 
-        		//Gather all custom parameters sent over i2c and append them after the static parameters found (if any).
-        		if (I2C_Mappings[data.I2CRXBuffer[0]].custom_pcount != NO_PARAMETERS)
+        	//Gather all custom parameters sent over i2c and append them after the static parameters found (if any).
+        	//Variable frames are passed on as received, starting with their length byte.
+        	if (code->custom_pcount != I2C_VARIABLE_PCOUNT)
+        	{
+        		for (i = 0; i < code->custom_pcount; i++)
         		{
-            		for (i = 0; i < I2C_Mappings[data.I2CRXBuffer[0]].custom_pcount; i++)
-            		{
-            			functionParameters[i + I2C_Mappings[data.I2CRXBuffer[0]].static_pcount] = data.I2CRXBuffer[i+1];
-            		}
+        			functionParameters[i + code->static_pcount] = data->I2CRXBuffer[i+1];
         		}
+        	}
 
-        		//If the user sent a valid command, get the I2C bus and call it.
-        		if (I2C_Mappings[data.I2CRXBuffer[0]].command_code == data.I2CRXBuffer[0]) {
-        			// Pend on the I2C interface becoming available
-        			xSemaphoreTake(g_pI2CSemaphore, POLL_SEMAPHORE);
-        			// Adhere to I2C timing and pause for 50 microseconds
-        			delayUs(I2C_SLAVE_SEND_DLY);
-        			// Send the number of values this I2C function will return to the master
-        			I2CSlaveDataPut(I2C_BASE_ADDR,I2C_Mappings[data.I2CRXBuffer[0]].return_pcount);
-        			I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_SINGLE_RECEIVE);
-        			// Call the function pointer with the parameters gathered.
-            		uint8_t returnValue = I2C_Mappings[data.I2CRXBuffer[0]].func(functionParameters);
-            		if (I2C_Mappings[data.I2CRXBuffer[0]].return_pcount == 1) {
-            			I2CSlaveDataPut(I2C_BASE_ADDR,returnValue);
-            			I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_SINGLE_RECEIVE);
-            		}
-            		xSemaphoreGive(g_pI2CSemaphore);
-            		UARTprintf("\nI2CFunctionReturned: 0x%02x\n", returnValue);
-        		}
+        	// Commands may save the configuration, wait until the boot task has loaded it
+        	BootWaitReady();
+        	// Call the function pointer with the parameters gathered, it may add values to the response.
+        	I2CResponseLength = 1;
+        	returnValue = code->func((code->custom_pcount == I2C_VARIABLE_PCOUNT) ? &data->I2CRXBuffer[1] : functionParameters);
+        	if (code->return_pcount == 1) {
+        		I2CResponseAppend(&returnValue, 1);
+        	}
+
+        	// The frame is no longer needed, let the ISR receive into it
+        	taskENTER_CRITICAL();
+        	I2CFramesFree |= (1 << frame);
+        	taskEXIT_CRITICAL();
+        	I2CResponsePost();
+        	ConsolePrintf("\nI2CFunctionReturned: 0x%02x\n", returnValue);
+        }
+        else
+        {
+        	I2CSlaveStatsGet(&stats);
+        	if (stats.rejected != reported.rejected || stats.overruns != reported.overruns || stats.short_frames != reported.short_frames) {
+        		ConsolePrintf("\n[I2C]: %u rejected, %u overrun and %u incomplete frames\n", stats.rejected - reported.rejected,
+        				stats.overruns - reported.overruns, stats.short_frames - reported.short_frames);
+        		reported = stats;
         	}
         }
     }
@@ -133,13 +461,13 @@ static void I2CManagerTask(void *pvParameters)
 //*****************************************************************************
 uint32_t I2CManagerTaskInit(void)
 {
-	g_pI2CQueue = xQueueCreate(I2C_QUEUE_SIZE, I2C_ITEM_SIZE);
+	g_pI2CQueue = MemoryQueueCreate("I2C_FRAMES", I2C_QUEUE_SIZE, I2C_ITEM_SIZE);
 
 	//
     // Create the I2C Manager task.
     //
-    if(xTaskCreate(I2CManagerTask, (const portCHAR *)"I2C_MANAGER", I2CTASKSTACKSIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_I2CMANAGER_TASK, NULL) != pdTRUE)
+    if(MemoryTaskCreate(I2CManagerTask, "I2C_MANAGER", I2CTASKSTACKSIZE,
+                   tskIDLE_PRIORITY + PRIORITY_I2CMANAGER_TASK) == NULL)
     {
         return(1);
     }
@@ -51,24 +51,54 @@
 
 //*****************************************************************************
 //
-//! The stack size for the LED toggle task.
+//! Number of frames the I2C ISR can fill while the I2C task works on earlier
+//! ones. The queue carries frame indices, so it can never be full.
 //
 //*****************************************************************************
-#define I2CTASKSTACKSIZE        900         // Stack size in words
+#define I2C_FRAME_COUNT			2
+#define I2C_NO_FRAME			0xFF
+#define I2C_ITEM_SIZE           sizeof(uint8_t)
+#define I2C_QUEUE_SIZE          I2C_FRAME_COUNT
 
 //*****************************************************************************
 //
-//! The item size and queue size for the LED message queue.
+//! Largest response the master can read back after a command, not counting
+//! the leading length byte. Bytes read past the end of a response are sent as
+//! I2C_RESPONSE_PAD.
 //
 //*****************************************************************************
-#define I2C_ITEM_SIZE           sizeof(I2C_Packet)
-#define I2C_QUEUE_SIZE          5
+#define I2C_RESPONSE_SIZE		255
+#define I2C_RESPONSE_PAD		0xFF
 
-#define POLL_SEMAPHORE			0
-#define I2C_SLAVE_SEND_DLY		40
+//*****************************************************************************
+//
+//! Priority of the I2C interrupt. Must not be above
+//! configMAX_SYSCALL_INTERRUPT_PRIORITY as the ISR queues frames.
+//
+//*****************************************************************************
+#define I2C_INT_PRIORITY		0xC0
 
-//! \brief I2CManager queue item. Used to pass commands in real-time from I2C port to the
-//! FreeRTOS interpreter.
+//*****************************************************************************
+//
+//! Registers returned by the port status commands, MAC table entries
+//! returned by one read of the MAC table (2 + 8 bytes each), 32-bit values
+//! returned per port by the port statistics command and bytes returned per
+//! port by the cable diagnostics command.
+//
+//*****************************************************************************
+#define I2C_PORT_STATUS_LENGTH	16
+#define I2C_MAC_CHUNK_ENTRIES	30
+#define I2C_PORT_STATS_LENGTH	6
+#define I2C_CABLE_DIAG_LENGTH	7
+
+//! Value of custom_pcount for commands whose first custom parameter is the
+//! number of bytes that follow it (see I2C_RunBatch). The frame is passed to
+//! the command as received instead of being copied into MAX_PARAMS values.
+#define I2C_VARIABLE_PCOUNT		0xFF
+//! Largest number of bytes that can follow the length of a variable frame
+#define I2C_VARIABLE_MAX_LENGTH	(I2CBUFFERSIZE - 2)
+
+//! \brief I2C frame. Filled by the I2C ISR and passed by index to the I2CManager task.
 //!
 //! Values placed in I2CRXBuffer are read sequentially to ensure that a valid command has been
 //! issued over the I2C port specified in freertos_init.h. The current value of I2CRXIndex is
@@ -82,7 +112,22 @@ typedef struct I2CPacket {
 	uint8_t I2CRXIndex;
 } I2C_Packet;
 
+//! \brief Counters kept by the I2C ISR, see I2CSlaveStatsGet().
+typedef struct {
+	//! Frames passed to the I2C task
+	uint32_t frames;
+	//! Frames with an unknown command code, a bad length or extra bytes
+	uint32_t rejected;
+	//! Frames refused because every frame was still in use
+	uint32_t overruns;
+	//! Frames ended by a STOP or repeated START before they were complete
+	uint32_t short_frames;
+} I2CSlaveStats;
+
 extern uint32_t I2CManagerTaskInit(void);
+extern void I2C0SlaveIntHandler(void);
+extern bool I2CResponseAppend(const uint8_t *data, uint32_t length);
+extern void I2CSlaveStatsGet(I2CSlaveStats *stats);
 
 //! \brief I2C interpretation structure. Contains I2C expected code along with the number
 //! of custom, static, and returned parameters.
@@ -90,9 +135,12 @@ extern uint32_t I2CManagerTaskInit(void);
 //! Addition of records to the I2C_Mappings table should implement ALL of these properties.
 //! The number of static parameters (those defined in the "static_parameters" array) should
 //! be identifed in static_pcount. The number of custom parameters to be sent by the master
-//! over I2C should be identified in "custom_pcount". The value placed in "return_pcount"
-//! will be sent over I2C when calling a command to allow the master to know how many values
-//! will be returned after execution.
+//! over I2C should be identified in "custom_pcount". Commands returning one value set
+//! "return_pcount" to 1, the value returned by the function is then sent back. Commands
+//! returning more set it to I2C_VARIABLE_PCOUNT and add their values with
+//! I2CResponseAppend(). The master reads the number of values returned followed by the
+//! values. Commands taking a variable number of parameters set "custom_pcount" to
+//! I2C_VARIABLE_PCOUNT.
 typedef struct I2CCodes {
 	//! The I2C command value in hex. Max number of entries limited to 256
 	uint8_t command_code;
@@ -118,23 +166,31 @@ static const I2C_Codes I2C_Mappings[80] = {
 	// Save running configuration to EEPROM
 	{0x01,0,0,1,{},I2C_SaveSwitchConfiguration},
 	// Download running configuration from EEPROM
-	{0x02,0,0,0xFF,{},I2C_DownloadSwitchConfiguration},
+	{0x02,0,0,I2C_VARIABLE_PCOUNT,{},I2C_DownloadSwitchConfiguration},
 	// Clear running configuration from EEPROM
 	{0x03,0,0,1,{},I2C_ClearSwitchConfiguration},
-	// Upload running configuration to EEPROM
-	{0x04,0,0,0,{},I2CNotImplementedFunction},
+	// Configuration replication: digest of the saved sections given (see layer_sync.h)
+	{0x04,0,1,I2C_VARIABLE_PCOUNT,{},I2C_SyncQuery},
 	// Reset the Ethernet Controller
 	{0x05,0,0,0,{},I2CNotImplementedFunction},
 	// Reset MISL Switch Layer
 	{0x06,0,0,0,{},I2CNotImplementedFunction},
-	{0x07,0,0,0,{},I2CNotImplementedFunction},
-	{0x08,0,0,0,{},I2CNotImplementedFunction},
-	{0x09,0,0,0,{},I2CNotImplementedFunction},
-	{0x0A,0,0,0,{},I2CNotImplementedFunction},
-	{0x0B,0,0,0,{},I2CNotImplementedFunction},
-	{0x0C,0,0,0,{},I2CNotImplementedFunction},
-	{0x0D,0,0,0,{},I2CNotImplementedFunction},
-	{0x0E,0,0,0,{},I2CNotImplementedFunction},
+	// Count learned MAC addresses on a port (0 = all ports)
+	{0x07,0,1,1,{},I2C_CountMACAddresses},
+	// Run several commands as one batch: length, then each code and its parameters
+	{0x08,0,I2C_VARIABLE_PCOUNT,1,{},I2C_RunBatch},
+	// Read learned MAC addresses: port (0 = all ports), then the 16-bit position to start from
+	{0x09,0,3,I2C_VARIABLE_PCOUNT,{},I2C_ReadMACTable},
+	// Read the traffic and error statistics of every port
+	{0x0A,0,0,I2C_VARIABLE_PCOUNT,{},I2C_ReadPortStatistics},
+	// Read the last cable diagnostics of every port
+	{0x0B,0,0,I2C_VARIABLE_PCOUNT,{},I2C_ReadCableDiagnostics},
+	// Configuration replication: begin or resume a section (section, 16-bit length, 32-bit CRC)
+	{0x0C,0,7,I2C_VARIABLE_PCOUNT,{},I2C_SyncBegin},
+	// Configuration replication: one chunk of the section (length, 16-bit offset, data, 32-bit CRC)
+	{0x0D,0,I2C_VARIABLE_PCOUNT,1,{},I2C_SyncData},
+	// Configuration replication: commit and apply the received sections (sections, 32-bit digest)
+	{0x0E,0,5,1,{},I2C_SyncCommit},
 	{0x0F,0,0,0,{},I2CNotImplementedFunction},
 
 	//QUICK ETHERNET PORT 1 CONTROL COMMANDS
@@ -169,7 +225,7 @@ static const I2C_Codes I2C_Mappings[80] = {
 	// Set port 1 VLAN
 	{0x1E,0,0,1,{},I2CNotImplementedFunction},
 	// Retrieve port 1 status
-	{0x1F,0,0,1,{},I2CNotImplementedFunction},
+	{0x1F,1,0,I2C_VARIABLE_PCOUNT,{PORT1_OFFSET_HEX},I2C_GetPortStatus},
 
 
 	//QUICK ETHERNET PORT 2 CONTROL COMMANDS
@@ -204,7 +260,7 @@ static const I2C_Codes I2C_Mappings[80] = {
 	// Set port 2 VLAN
 	{0x2E,0,0,1,{},I2CNotImplementedFunction},
 	// Retrieve port 2 status
-	{0x2F,0,0,1,{},I2CNotImplementedFunction},
+	{0x2F,1,0,I2C_VARIABLE_PCOUNT,{PORT2_OFFSET_HEX},I2C_GetPortStatus},
 
 
 	//QUICK ETHERNET PORT 3 CONTROL COMMANDS
@@ -239,7 +295,7 @@ static const I2C_Codes I2C_Mappings[80] = {
 	// Set port 3 VLAN
 	{0x3E,0,0,1,{},I2CNotImplementedFunction},
 	// Retrieve port 3 status
-	{0x3F,0,0,1,{},I2CNotImplementedFunction},
+	{0x3F,1,0,I2C_VARIABLE_PCOUNT,{PORT3_OFFSET_HEX},I2C_GetPortStatus},
 
 
 	//QUICK ETHERNET PORT 4 CONTROL COMMANDS
@@ -274,7 +330,7 @@ static const I2C_Codes I2C_Mappings[80] = {
 	// Set port 4 VLAN
 	{0x4E,0,0,1,{},I2CNotImplementedFunction},
 	// Retrieve port 4 status
-	{0x4F,0,0,1,{},I2CNotImplementedFunction},
+	{0x4F,1,0,I2C_VARIABLE_PCOUNT,{PORT4_OFFSET_HEX},I2C_GetPortStatus},
 
 };
 
@@ -25,14 +25,19 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "driverlib/gpio.h"
 #include "driverlib/rom.h"
-#include "utils/uartstdio.h"
 #include "interpreter_task.h"
 #include "freertos_init.h"
+#include "boot_task.h"
+#include "switch_batch.h"
+#include "console.h"
 #include "priorities.h"
+#include "memory_budget.h"
+#include "perf_stats.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -41,85 +46,290 @@
 #include "event_logger.h"
 
 
+extern xSemaphoreHandle g_pUARTSemaphore;
+
+User_Data ActiveUser;
+
 //*****************************************************************************
 //
-//! The stack size for the LED toggle task.
+//! Describes one menu of the command tree. Menus are numbered in the order
+//! they are found from Command_Categories (menu 0).
 //
 //*****************************************************************************
-#define INTERPRETERTASKSTACKSIZE        256         // Stack size in words
+typedef struct {
+	//! The menu's commands, terminated by an entry with no text
+	const Command *commands;
+	//! Length of the longest command text, used to align the help column
+	uint8_t help_width;
+	//! First command taking user input, COMMAND_INDEX_NONE if there is none
+	uint8_t user_entry;
+	//! Menu number of user_entry's child menu
+	uint8_t user_child;
+} CommandMenu;
 
 //*****************************************************************************
 //
-//! The item size and queue size for the LED message queue.
+//! One slot of the command word hash table. Slots with menu 0 are empty, so
+//! menus are stored plus one.
 //
 //*****************************************************************************
-#define INTERPRETER_ITEM_SIZE           sizeof(char[UART_RX_BUFFER_SIZE])
-#define INTERPRETER_QUEUE_SIZE          10
+typedef struct {
+	//! Menu number plus one
+	uint8_t menu;
+	//! Position of the command in its menu
+	uint8_t entry;
+	//! Menu number of the command's child menu
+	uint8_t child;
+} CommandSlot;
+
 //*****************************************************************************
 //
-//! The queue that holds messages sent to the LED task.
+//! Index over the command tree, built once by CommandIndexBuild(). Resolving a
+//! command word is a single hash probe instead of a scan of its menu.
 //
 //*****************************************************************************
-xQueueHandle g_pINTERPRETERQueue;
-extern xQueueHandle g_pLoggerQueue;
+static CommandMenu CommandMenus[COMMAND_INDEX_MAX_MENUS];
+static uint32_t CommandMenuCount = 0;
+static CommandSlot CommandSlots[COMMAND_INDEX_SLOTS];
 
-extern xSemaphoreHandle g_pUARTSemaphore;
+//*****************************************************************************
+//
+//! Hashes a command word together with the menu it belongs to (FNV-1a).
+//!
+//! \param menu the menu number
+//! \param word the command word
+//!
+//! \return Returns the first slot to probe
+//
+//*****************************************************************************
+static uint32_t CommandIndexHash(uint32_t menu, const char *word)
+{
+	uint32_t hash = 2166136261u ^ menu;
 
-User_Data ActiveUser;
+	while (*word != '\0') {
+		hash = (hash ^ (uint8_t)*word++) * 16777619u;
+	}
+	return (hash & (COMMAND_INDEX_SLOTS - 1));
+}
+
+//*****************************************************************************
+//
+//! Returns the number of a menu, adding it to the index if it is new. Menus
+//! shared by several parents (i.e. Enable_Disable_Options) are stored once.
+//!
+//! \param commands the menu's commands
+//!
+//! \return Returns the menu number or COMMAND_INDEX_NONE if the index is full
+//
+//*****************************************************************************
+static uint32_t CommandIndexMenu(const Command *commands)
+{
+	uint32_t menu;
+
+	for (menu = 0; menu < CommandMenuCount; menu++) {
+		if (CommandMenus[menu].commands == commands) {
+			return menu;
+		}
+	}
+	if (CommandMenuCount == COMMAND_INDEX_MAX_MENUS) {
+		return COMMAND_INDEX_NONE;
+	}
+	CommandMenus[CommandMenuCount].commands = commands;
+	CommandMenus[CommandMenuCount].help_width = 0;
+	CommandMenus[CommandMenuCount].user_entry = COMMAND_INDEX_NONE;
+	CommandMenus[CommandMenuCount].user_child = COMMAND_INDEX_NONE;
+	return CommandMenuCount++;
+}
+
+//*****************************************************************************
+//
+//! Builds the command index from Command_Categories. Each menu is visited once,
+//! its help column width is computed and its command words are hashed.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool CommandIndexBuild(void)
+{
+	const Command *commands;
+	uint32_t menu, entry, child, slot, probes, length;
+
+	memset(CommandSlots, 0, sizeof(CommandSlots));
+	CommandMenuCount = 0;
+	CommandIndexMenu(Command_Categories);
+
+	//Menus found while indexing are appended, so this visits the whole tree
+	for (menu = 0; menu < CommandMenuCount; menu++) {
+		commands = CommandMenus[menu].commands;
+		for (entry = 0; commands[entry].text != 0; entry++) {
+			if (entry == MAX_MENU_ITEMS) {
+				return false;
+			}
+			child = COMMAND_INDEX_NONE;
+			if (commands[entry].childCommand != NO_CHILD_MENU) {
+				child = CommandIndexMenu(commands[entry].childCommand);
+				if (child == COMMAND_INDEX_NONE) {
+					return false;
+				}
+			}
+			length = strlen(commands[entry].text);
+			if (length > CommandMenus[menu].help_width) {
+				CommandMenus[menu].help_width = length;
+			}
+			if (commands[entry].paramsUserProvided && CommandMenus[menu].user_entry == COMMAND_INDEX_NONE) {
+				CommandMenus[menu].user_entry = entry;
+				CommandMenus[menu].user_child = child;
+			}
+
+			slot = CommandIndexHash(menu, commands[entry].text);
+			for (probes = 0; CommandSlots[slot].menu != 0; probes++) {
+				if (probes == COMMAND_INDEX_SLOTS) {
+					return false;
+				}
+				slot = (slot + 1) & (COMMAND_INDEX_SLOTS - 1);
+			}
+			CommandSlots[slot].menu = menu + 1;
+			CommandSlots[slot].entry = entry;
+			CommandSlots[slot].child = child;
+		}
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Resolves one command word. As with a scan of the menu, the first command
+//! that either matches the word or takes user input is chosen.
+//!
+//! \param menu the menu number, updated to the chosen command's child menu
+//! \param word the command word entered
+//!
+//! \return Returns the chosen command or NULL if the word is not recognized
+//
+//*****************************************************************************
+static const Command *CommandIndexFind(uint32_t *menu, const char *word)
+{
+	const CommandMenu *current = &CommandMenus[*menu];
+	uint32_t slot = CommandIndexHash(*menu, word);
+	uint32_t entry = COMMAND_INDEX_NONE;
+	uint32_t child = COMMAND_INDEX_NONE;
+	uint32_t probes;
+
+	for (probes = 0; CommandSlots[slot].menu != 0 && probes < COMMAND_INDEX_SLOTS; probes++) {
+		if (CommandSlots[slot].menu == (*menu + 1) && strcmp(current->commands[CommandSlots[slot].entry].text, word) == 0) {
+			entry = CommandSlots[slot].entry;
+			child = CommandSlots[slot].child;
+			break;
+		}
+		slot = (slot + 1) & (COMMAND_INDEX_SLOTS - 1);
+	}
+	if (current->user_entry < entry) {
+		entry = current->user_entry;
+		child = current->user_child;
+	}
+	if (entry == COMMAND_INDEX_NONE) {
+		return NULL;
+	}
+	*menu = child;
+	return &current->commands[entry];
+}
+
+//*****************************************************************************
+//
+//! Prints the help for a menu, aligned to its precomputed column width. The
+//! UART mutex is held for the whole listing so it is not interleaved.
+//!
+//! \param menu the menu number
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void CommandIndexHelp(uint32_t menu)
+{
+	const Command *commands = CommandMenus[menu].commands;
+	bool childHasElevatedPermissions = false;
+	uint32_t entry, pad;
+
+	xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
+	for (entry = 0; commands[entry].text != 0; entry++) {
+		ConsolePrintfWait("\t%s", commands[entry].text);
+		if (commands[entry].permissionsRequired > ActiveUser.permissions) {
+			ConsolePrintfWait("*");
+			childHasElevatedPermissions = true;
+		}
+		for (pad = strlen(commands[entry].text); pad < CommandMenus[menu].help_width; pad++) {
+			ConsolePrintfWait(" ");
+		}
+		if (commands[entry].permissionsRequired > ActiveUser.permissions) {
+			ConsolePrintfWait("\b");
+		}
+		ConsolePrintfWait("\t%s\n", commands[entry].help);
+	}
+	if (childHasElevatedPermissions) {
+		ConsolePrintfWait("\n[*] Command requires elevated priviledges!\n");
+	}
+	xSemaphoreGive(g_pUARTSemaphore);
+}
+
+//*****************************************************************************
+//
+//! Prints a message while holding the UART mutex, so that other tasks' output
+//! is only held off while the interpreter is actually printing.
+//!
+//! \param pcString format string, as for ConsolePrintfWait()
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void InterpreterPrintf(const char *pcString, ...)
+{
+	va_list vaArgP;
+
+	xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
+	va_start(vaArgP, pcString);
+	ConsoleVPrintf(pcString, vaArgP, true);
+	va_end(vaArgP);
+	xSemaphoreGive(g_pUARTSemaphore);
+}
 
 static void InterpreterTask(void *pvParameters)
 {
-	//Holds the value passed to us by the xQueueReceive function
-    char consoleinput[UART_RX_BUFFER_SIZE] = "";
-    //Used for string split function to get the commands issued. Holds a maximum of 128 words.
-    static char *commandwords[UART_RX_BUFFER_SIZE] = {{0}};
+	//Index of the console line being interpreted
+    uint8_t line;
 
     while(1)
     {
     	while (!Authenticated) {
-    		portTickType ui32WakeTime;
     		int i = 0;
     		char auth_username[16] = {0x00};
     		char auth_password[16] = {0x00};
 
-    		//This task takes a while, so we want share nicely with other tasks instead of blocking
-    		uint32_t ui32TaskDelay = SHORT_TASK_DLY;
-
-    		//Get system time in ticks
-    		ui32WakeTime = xTaskGetTickCount();
-    		UARTprintf("\n\n=== AUTHENTICATION REQUIRED ===\n");
+    		ConsolePrintfWait("\n\n=== AUTHENTICATION REQUIRED ===\n");
 
     		while (auth_username[0] == 0x00) {
-    			UARTprintf("Username: ");
-				//Wait for enter key and pend this task unil done
-				while ((UARTPeek('\n') == -1) && (UARTPeek('\r') == -1)) {
-					while (!UARTRxBytesAvail()) {
-						uint32_t currentTime = xTaskGetTickCount();
-						vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-					}
-				}
-
-	    		UARTgets(auth_username, 16);
+    			ConsolePrintfWait("Username: ");
+				//Pend this task until a line has been entered
+	    		ConsoleGets(auth_username, 16);
     		}
 
     		//Replace everything the user receives from the microcontroller with '*'
     		UsePasswordMask = true;
 
     		while (auth_password[0] == 0x00) {
-        		UARTprintf("\nPassword: ");
-				//Wait for enter key and pend this task until done
-				while ((UARTPeek('\n') == -1) && (UARTPeek('\r') == -1)) {
-					while (!UARTRxBytesAvail()) {
-						uint32_t currentTime = xTaskGetTickCount();
-						vTaskDelayUntil(&ui32WakeTime, ui32TaskDelay / portTICK_RATE_MS);
-					}
-				}
-	    		UARTgets(auth_password, 16);
+        		ConsolePrintfWait("\nPassword: ");
+				//Pend this task until a line has been entered
+	    		ConsoleGets(auth_password, 16);
     		}
 
     		//Allow cleartext communication over the UART TX buffer.
     		UsePasswordMask = false;
 
+    		//Saved users are only known once the boot task has loaded the user database
+    		if (!BootConfigReady()) {
+    			ConsolePrintfWait("\nLoading configuration...please wait");
+    			BootWaitReady();
+    		}
+
 
 
     		//Check to see if user exists
@@ -132,13 +342,13 @@ static void InterpreterTask(void *pvParameters)
 							Authenticated = true;
 							ActiveUser = users[i];
 							ShowDebugInformation();
-							UARTprintf("\n\n=== AUTHENTICATION SUCCESSFUL ===\nWelcome %s %s\n", ActiveUser.first_name, ActiveUser.last_name);
-						    UARTprintf("For help with a command, append a '?' and hit <ENTER>\n");
-						    UARTprintf("ex: port f0 ? \n");
-							UARTprintf("\n\033[1m%s\033[0m>", console_hostname);
+							ConsolePrintfWait("\n\n=== AUTHENTICATION SUCCESSFUL ===\nWelcome %s %s\n", ActiveUser.first_name, ActiveUser.last_name);
+						    ConsolePrintfWait("For help with a command, append a '?' and hit <ENTER>\n");
+						    ConsolePrintfWait("ex: port f0 ? \n");
+							ConsolePrintfWait("\n\033[1m%s\033[0m>", console_hostname);
 
 							//Log to EEPROM
-							LogItemEEPROM(UserLoggedIn);
+							LogItemEEPROMData(UserLoggedIn, i);
 
 							break;
 						}
@@ -146,171 +356,125 @@ static void InterpreterTask(void *pvParameters)
     			}
     		}
     		if (!Authenticated) {
-    		UARTprintf("\nAUTHENTICATION FAILED!\n");
+    		ConsolePrintfWait("\nAUTHENTICATION FAILED!\n");
     		}
     	}
         //
-        // Read the next message, if available on queue.
+        // Read the next line, if one has been entered.
         //
-        if(xQueueReceive(g_pINTERPRETERQueue, &consoleinput, (portTICK_PERIOD_MS*100)) == pdPASS)
+        if(ConsoleLineReceive(&line, (portTICK_PERIOD_MS*100)))
         {
-        	char *token = strtok (consoleinput, " ");
-        	int n_spaces = 0, i,j,k=0,l=0,longest_string=0;
+        	//The line is tokenized in place, the words and parameters point into it until it is released
+        	char *token = strtok (ConsoleLineBuffer(line), " ");
+        	char *commandwords[MAX_DEPTH_INHERITANCE + 1] = {0};
+        	int n_spaces = 0, i, k = 0, l;
         	char *params[MAX_PARAMS] = {0};
-        	bool foundChild = false;
-            xSemaphoreTake(g_pUARTSemaphore,portMAX_DELAY);
-
-            //Empty and reinitialize the commandwords array
-            memset(commandwords, 0, sizeof(commandwords));
-
+        	const Command *entry = NULL;
+        	uint32_t menu = 0;
+        	bool result, batched;
 
         	while (token) {
+        		if (n_spaces < MAX_DEPTH_INHERITANCE) {
+        			commandwords[n_spaces] = token;
+        		}
         		++n_spaces;
-        		commandwords[n_spaces-1] = token;
         		token = strtok (NULL, " ");
-        		if (n_spaces > 126) {
-        			UARTprintf("Command issued is too long. A maximum of 127 words can be issued at any given time.");
-        		}
         	}
 
-        	UARTprintf("\n");
-
+        	InterpreterPrintf("\n");
 
-        	Command (*Menu)[MAX_MENU_ITEMS];
-        	Menu = &Command_Categories;
-
-        	//Check if user hit enter without entering parameters
-        	if (commandwords[0] != 0x00) {
-				for (i = 0; i < MAX_DEPTH_INHERITANCE; i++) {
-					for (j = 0; j < MAX_MENU_ITEMS; j++) {
+        	//No command is deeper than the command tree, so nothing is resolved
+        	if (n_spaces > MAX_DEPTH_INHERITANCE) {
+        		InterpreterPrintf("Command issued is too long. A maximum of %d words can be issued at any given time.\n", MAX_DEPTH_INHERITANCE);
+        		commandwords[0] = 0x00;
+        	}
 
+        	//Resolve one command word per menu level. Check if user hit enter without entering parameters
+			for (i = 0; i < MAX_DEPTH_INHERITANCE && commandwords[i] != 0x00; i++) {
+				//User has requested help for this menu. Print help!
+				if (strcmp("?", commandwords[i]) == 0) {
+					CommandIndexHelp(menu);
+					entry = NULL;
+					break;
+				}
 
-						if ((*Menu)[j].text == 0 && !foundChild)
-						{
-							//End of array found without a match. Inform user and print help menu for that menu
-							UARTprintf("Command Not Recognized.\n");
-							i = MAX_DEPTH_INHERITANCE;
-							break;
+				//Did we receive a valid command word?
+				entry = CommandIndexFind(&menu, commandwords[i]);
+				if (entry == NULL) {
+					if (i == 0) {
+						//End of menu found without a match
+						InterpreterPrintf("Command Not Recognized.\n");
+					}
+					else {
+						//Show the commands issued up to the error since we received a partial command
+						xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
+						ConsolePrintfWait("Incomplete Command Entered: \n");
+						for (l = 0; l < i; l++) {
+							ConsolePrintfWait("%s ", commandwords[l]);
 						}
-						else if ((*Menu)[j].text == 0 && foundChild) {
-
-							//Show help for the current menu since we received a partial command
-							UARTprintf("Incomplete Command Entered: \n");
-							//Print the commands issued up to the error
-							for (k = 0; k < i; k++) {
-
-								UARTprintf("%s ", commandwords[k]);
-							}
+						ConsolePrintfWait("<incomplete>\nFor help with commands, type a '?' after the command.\n");
+						xSemaphoreGive(g_pUARTSemaphore);
+					}
+					break;
+				}
 
-							UARTprintf("<incomplete>\nFor help with commands, type a '?' after the command.\n");
+				//Save this branch's function parameters
+				if (entry->paramsRequired != NO_PARAMETERS) {
+					for (l = 0; l < entry->paramsRequired && k < MAX_PARAMS; l++) {
+						params[k++] = entry->paramsUserProvided ? commandwords[i] : (char *)entry->functionParams[l];
+					}
+				}
 
-							//Set the outer loop iterator to the maximum so we will exit after the next break
-							i = MAX_DEPTH_INHERITANCE;
-							break;
-						}
-						//Did we receive a valid command word?
-						if ((strcmp((*Menu)[j].text,commandwords[i]) == 0 || ((*Menu)[j].paramsUserProvided && i < n_spaces)) && (strcmp("?", commandwords[i]) != 0))
-						{
-								//Save this branch's function parameters
-								if ((*Menu)[j].paramsRequired != NO_PARAMETERS) {
-									if ((*Menu)[j].paramsUserProvided) {
-										for (l = 0; l < (*Menu)[j].paramsRequired; l++) {
-												params[k] = commandwords[i];
-												k++;
-
-										}
-									}
-									else {
-										for (l=0; l < (*Menu)[j].paramsRequired; l++) {
-											params[k] = (*Menu)[j].functionParams[l];
-											k++;
-										}
-									}
-								}
-								//Is this is termininating command? If so, run the function tied to it
-								if ((*Menu)[j].isExecutable) {
-									if (commandwords[i+1] != 0x00)
-									{
-										UARTprintf("Invalid Command, too many parameters entered!\n");
-									}
-									else if ((*Menu)[j].permissionsRequired > ActiveUser.permissions) {
-										UARTprintf("[UNAUTHORIZED]: You require elevated permissions to use this command!\n");
-									}
-									else {
-										//Call function here
-										if ((*Menu)[j].func(params) == true) {
-											UARTprintf("\nCommand Executed Successfully\n");
-										}
-										else {
-											UARTprintf("\nAn error occurred while executing this task.\n");
-										}
-									}
-
-									i = MAX_DEPTH_INHERITANCE;
-									break;
-							}
-							else {
-								//Notify future iterations that we are now dealing with child nodes.
-								foundChild = true;
-								//Set the menu item we are looking at to the child of the current menu item
-								Menu = ((*Menu)[j].childCommand);
-								break;
+				//Is this is termininating command? If so, run the function tied to it
+				if (entry->isExecutable) {
+					if (commandwords[i+1] != 0x00)
+					{
+						InterpreterPrintf("Invalid Command, too many parameters entered!\n");
+					}
+					else if (entry->permissionsRequired > ActiveUser.permissions) {
+						InterpreterPrintf("[UNAUTHORIZED]: You require elevated permissions to use this command!\n");
+					}
+					else {
+						//Commands may read or change VLANs and users, wait until the boot task has loaded them
+						BootWaitReady();
+						//Call function here. The UART mutex is not held so other tasks may print meanwhile
+						batched = SwitchBatchActive();
+						PERF_BEGIN();
+						PERF_SPAN_BEGIN();
+						result = entry->func(params);
+						PERF_END(PerfCommand);
+						PERF_SPAN_END(commandwords, i + 1);
+						if (batched && SwitchBatchActive()) {
+							//Inside a batch only failures are reported, the commit reports the rest
+							SwitchBatchRecord(result);
+							if (!result) {
+								InterpreterPrintf("\nAn error occurred while executing this task.\n");
 							}
 						}
-						else if (strcmp("?", commandwords[i]) == 0) {
-							bool childHasElevatedPermissions = false;
-							//User has requested help for this menu. Print help!
-							//In order to make sure help text is aligned properly, first find the longest string
-							for (k=0; k<MAX_MENU_ITEMS;k++) {
-								if ((*Menu)[k].text == 0){
-									//End of help
-									break;
-								}
-								else if (strlen((*Menu)[k].text) > longest_string){
-
-									longest_string = strlen((*Menu)[k].text);
-								}
-							}
-
-							//Print the help text with spaces added for all words shorter than the longest found
-							for (k=0; k<MAX_MENU_ITEMS;k++) {
-								if ((*Menu)[k].text == 0){
-									//End of help
-									break;
-								}
-								UARTprintf("\t%s", (*Menu)[k].text);
-								if ((*Menu)[k].permissionsRequired > ActiveUser.permissions) {
-									UARTprintf("*");
-									childHasElevatedPermissions = true;
-								}
-								for (l = 0; l < (longest_string - strlen((*Menu)[k].text)); l++)
-								{
-									UARTprintf(" ");
-								}
-								if ((*Menu)[k].permissionsRequired > ActiveUser.permissions) {
-									UARTprintf("\b");
-								}
-								UARTprintf("\t%s\n", (*Menu)[k].help);
-							}
-							if (childHasElevatedPermissions) {
-							UARTprintf("\n[*] Command requires elevated priviledges!\n");
-							}
-
-							i = MAX_DEPTH_INHERITANCE;
-							break;
+						else {
+							InterpreterPrintf(result ? "\nCommand Executed Successfully\n" : "\nAn error occurred while executing this task.\n");
 						}
-
-
-
-
 					}
+					entry = NULL;
+					break;
 				}
-        	}
+			}
+
+			//The words ran out before reaching a terminating command
+			if (entry != NULL && commandwords[i] == 0x00) {
+				xSemaphoreTake(g_pUARTSemaphore, portMAX_DELAY);
+				ConsolePrintfWait("Incomplete Command Entered: \n");
+				for (l = 0; l < i; l++) {
+					ConsolePrintfWait("%s ", commandwords[l]);
+				}
+				ConsolePrintfWait("<incomplete>\nFor help with commands, type a '?' after the command.\n");
+				xSemaphoreGive(g_pUARTSemaphore);
+			}
 
-        	//Print the command line message
-        	UARTprintf("\033[1m%s\033[0m>", console_hostname);
+        	ConsoleLineRelease(line);
 
-        	xSemaphoreGive(g_pUARTSemaphore);
+        	//Print the command line message
+        	InterpreterPrintf("\033[1m%s\033[0m%s>", console_hostname, SwitchBatchActive() ? "(batch)" : "");
         }
     }
 }
@@ -322,14 +486,16 @@ static void InterpreterTask(void *pvParameters)
 //*****************************************************************************
 uint32_t InterpreterTaskInit(void)
 {
-
-	g_pINTERPRETERQueue = xQueueCreate(INTERPRETER_QUEUE_SIZE, INTERPRETER_ITEM_SIZE);
+	//Index the command tree once so each command word resolves with a single lookup
+	if (!CommandIndexBuild()) {
+		return(1);
+	}
 
     //
     // Create the Interpreter task.
     //
-    if(xTaskCreate(InterpreterTask, (const portCHAR *)"InterpreterTask", INTERPRETERTASKSTACKSIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_INTERPRETER_TASK, NULL) != pdTRUE)
+    if(MemoryTaskCreate(InterpreterTask, "Interpreter", INTERPRETERTASKSTACKSIZE,
+                   tskIDLE_PRIORITY + PRIORITY_INTERPRETER_TASK) == NULL)
     {
         return(1);
     }
@@ -341,7 +507,7 @@ uint32_t InterpreterTaskInit(void)
 }
 
 bool NotImplementedFunction(char* x[MAX_PARAMS]) {
-	UARTprintf("Function Not Implemented!");
+	ConsolePrintfWait("Function Not Implemented!");
 	return true;
 }
 
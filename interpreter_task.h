@@ -47,6 +47,12 @@
 #define MAX_DEPTH_INHERITANCE 12
 //! Maximum number of total menu items in each command menu. [IMPORTANT]: Should be LARGER than the LARGEST command menu!
 #define MAX_MENU_ITEMS 50
+//! Maximum number of menus in the command index. Should be at least the number of Command arrays below
+#define COMMAND_INDEX_MAX_MENUS 48
+//! Number of slots in the command index's hash table. Must be a power of two, at least 1.25 times the number of commands
+#define COMMAND_INDEX_SLOTS 256
+//! Marks a missing menu or command in the command index
+#define COMMAND_INDEX_NONE 0xFF
 //! Maximum number of statically defined parameters in each menu item
 #define MAX_PARAMS 20
 //! Placeholder for no statically defined parameters. Use to improve readability of new commands.
@@ -70,6 +76,7 @@
 #define ETHO_PORT2_HARDWARE_HEX 					0x20
 #define ETHO_PORT3_HARDWARE_HEX 					0x30
 #define ETHO_PORT4_HARDWARE_HEX 					0x40
+#define ETHO_PORT5_HARDWARE_HEX 					0x50
 /** @} */
 
 
@@ -273,6 +280,7 @@
 #define INDIRECT_TABLESELCT_STATICMAC 				0
 #define INDIRECT_TABLESELECT_VLAN 					1
 #define INDIRECT_TABLESELECT_DYNMAC					2
+#define INDIRECT_TABLESELECT_MIB					3
 
 #define INDIRECT_CONTROL_ADDRESS_HIGH 				0x00
 #define INDIRECT_CONTROL_ADDRESS_LOW 				0x00
@@ -306,6 +314,7 @@
 
 
 #define INTERRUPT_STATUS_REGISTER 0x7C
+#define INTERRUPT_MASK_REGISTER 0x7D
 
 //**************************************************************************************************************************************
 //
@@ -462,10 +471,36 @@ static const Command LED_Options[3] = {
 		{0,0,0,0,0,0,0}
 };
 
-static const Command Table_Options[4] = {
+//************************************************************************************************************
+//
+//! Commands for searching the MAC table snapshot by port or by MAC address prefix
+//
+//************************************************************************************************************
+static const Command FindMACPort_Options[2] = {
+		{"<port [f0 - f3, exp-port]>", 		"lists addresses learned on or forwarded to a port", 	TERMINATING_COMMMAND, 1,true, COM_FindMACByPort, 	EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ReadOnlyUser},
+		{0,0,0,0,0,0,0}
+};
+static const Command FindMACPrefix_Options[2] = {
+		{"<mac-prefix [xx:xx:xx:xx:xx:xx]>", "lists addresses starting with a prefix", 				TERMINATING_COMMMAND, 1,true, COM_FindMACByPrefix, 	EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ReadOnlyUser},
+		{0,0,0,0,0,0,0}
+};
+static const Command FindMAC_Options[3] = {
+		{"port", 	"find MAC addresses by port", 		HAS_CHILD, 	NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,	FindMACPort_Options,	ReadOnlyUser},
+		{"mac", 	"find MAC addresses by prefix", 	HAS_CHILD, 	NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,	FindMACPrefix_Options,	ReadOnlyUser},
+		{0,0,0,0,0,0,0}
+};
+
+static const Command Table_Options[11] = {
 		{"vlan-table", 			"shows the current VLAN table", 						TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowVLANTable, 			EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
 		{"static-mac-table",	"shows the static MAC table", 							TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowStaticMACTable, 	EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
 		{"dyn-mac-table", 		"shows the dynamic MAC table", 							TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowDynamicMACTable, 	EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
+		{"boot-times", 			"shows how long each phase of bring-up took", 			TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowBootTimes, 			EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
+		{"memory", 				"shows stack, queue and heap usage", 					TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowMemory, 			EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
+		{"perf", 				"shows operation latencies and task CPU time", 			TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowPerf, 				EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
+		{"perf-reset", 			"clears the performance counters", 						TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ResetPerf, 				EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ModifySystem},
+		{"find-mac", 			"searches the MAC tables by port or address prefix", 	HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		FindMAC_Options,				ReadOnlyUser},
+		{"spi-clock", 			"shows the SPI clock of the EEPROM and the controller", TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowSPIClock, 			EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
+		{"qos", 				"shows the QoS profile, queues and rate limits", 		TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowQoS, 				EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
 		{0,0,0,0,0,0,0}
 };
 
@@ -475,8 +510,14 @@ static const Command I2C_Command_Code[2] = {
 		{0,0,0,0,0,0,0}
 };
 
-static const Command I2C_Options[2] = {
+static const Command I2C_Address[2] = {
+		{"<layer-addr [0x08 - 0x77]>", 			"address this layer answers at, saved", 	TERMINATING_COMMMAND, 	1,	true, 	COM_SetLayerAddress, 	EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ModifySystem},
+		{0,0,0,0,0,0,0}
+};
+
+static const Command I2C_Options[3] = {
 		{"send-command", 		"send an I2C over loopback", 								HAS_CHILD, 	NO_PARAMETERS,	false, 	NotImplementedFunction, EMPTY_STATIC_PARAMS,		I2C_Command_Code,					ModifySystem},
+		{"address", 			"set the I2C address of this layer", 						HAS_CHILD, 	NO_PARAMETERS,	false, 	NotImplementedFunction, EMPTY_STATIC_PARAMS,		I2C_Address,						ModifySystem},
 		{0,0,0,0,0,0,0}
 };
 
@@ -485,7 +526,32 @@ static const Command I2C_Options[2] = {
 //! Mid level commands for changing system properties
 //
 //********************************************************************************************************************
-static const Command System_Commands[10] = {
+static const Command SPIClockRate_Options[2] = {
+		{"<auto|rate-khz>", "new rate, auto to tune the bus again", TERMINATING_COMMMAND, 1,true, COM_SetSPIClock, EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ModifySystem},
+		{0,0,0,0,0,0,0}
+};
+static const Command SPIClock_Options[3] = {
+		{"eeprom", 		"SPI clock of the EEPROM", 					HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{"0"},	SPIClockRate_Options,	ModifySystem},
+		{"ethernet", 	"SPI clock of the ethernet controller", 	HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{"1"},	SPIClockRate_Options,	ModifySystem},
+		{0,0,0,0,0,0,0}
+};
+static const Command SyncLayers_Options[3] = {
+		{"all", 						"every layer found on the I2C bus", 	TERMINATING_COMMMAND, 	1,	false, 	COM_SyncLayers, 	{"all"},				NO_CHILD_MENU,	ModifySystem},
+		{"<layer-addr [0x08 - 0x77]>", 	"the layer at this I2C address", 		TERMINATING_COMMMAND, 	1,	true, 	COM_SyncLayers, 	EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ModifySystem},
+		{0,0,0,0,0,0,0}
+};
+static const Command Sync_Options[3] = {
+		{"layers", 				"copy the saved switch and VLAN settings to other layers", 	HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{"0"},	SyncLayers_Options,	ModifySystem},
+		{"layers-with-users", 	"copy the saved settings and users to other layers", 		HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{"1"},	SyncLayers_Options,	ModifySystem},
+		{0,0,0,0,0,0,0}
+};
+static const Command QoSProfile_Options[4] = {
+		{"default", 				"reset values: one queue, no limits, flow control on", 			TERMINATING_COMMMAND, 	1,	false, 	COM_SetQoSProfile, 	{"0"},	NO_CHILD_MENU,	ModifySystem},
+		{"cascade-uplink", 			"four queues, fair sharing of exp-port, storm control on f0-f3", 	TERMINATING_COMMMAND, 	1,	false, 	COM_SetQoSProfile, 	{"1"},	NO_CHILD_MENU,	ModifySystem},
+		{"low-latency-control", 	"strict priority, no flow control, best effort limited", 		TERMINATING_COMMMAND, 	1,	false, 	COM_SetQoSProfile, 	{"2"},	NO_CHILD_MENU,	ModifySystem},
+		{0,0,0,0,0,0,0}
+};
+static const Command System_Commands[13] = {
 		{"eeprom", 				"change settings for the EEPROM", 						HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		EEPROM_Options,					ModifySystem},
 		{"i2c", 				"control other layers with I2C", 						HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		I2C_Options,					ModifySystem},
 		{"status", 				"show global system information", 						TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowRunningConfig, 		EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ReadOnlyUser},
@@ -493,7 +559,10 @@ static const Command System_Commands[10] = {
 		{"large-packets", 		"allow 2KB packets", 									HAS_CHILD, 				3,				false, 	NotImplementedFunction, 	{GLOBAL_CONTROL_1,"0x06"},	Enable_Disable_Options,			ModifySystem},
 		{"power-saving", 		"enable/disable power saving on all PHYs", 				HAS_CHILD, 				3,				false, 	NotImplementedFunction, 	{GLOBAL_CONTROL_9,"0x03"},	INV_Enable_Disable_Options,		ModifySystem},
 		{"led-mode", 			"set LED mode 0 or mode 1", 							HAS_CHILD, 				3,				false, 	NotImplementedFunction, 	{GLOBAL_CONTROL_9,"0x01"},	LED_Options,					ModifySystem},
-		{"show", 				"access VLAN and MAC tables", 							HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		Table_Options,					ReadOnlyUser},
+		{"show", 				"access tables and system usage", 							HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		Table_Options,					ReadOnlyUser},
+		{"spi-clock", 			"select the SPI clock of a bus", 		HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		SPIClock_Options,				ModifySystem},
+		{"sync", 				"copy the saved configuration to other layers over I2C", 	HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		Sync_Options,					ModifySystem},
+		{"qos-profile", 		"apply a QoS and storm-control profile", 				HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,		QoSProfile_Options,				ModifySystem},
 		{"reset", 				"performs a soft reset of the system", 					TERMINATING_COMMMAND, 	NO_PARAMETERS, 	false, 	COM_ResetTivaC, 			EMPTY_STATIC_PARAMS,		NO_CHILD_MENU,					ModifySystem},
 		{0,0,0,0,0,0,0}
 };
@@ -525,9 +594,11 @@ static const Command Controller_Options[3] = {
 //! Commands to modify the configuration saved on the 25AA1024 EEPROM
 //
 //********************************************************************************************************************
-static const Command Config_Commands[3] = {
+static const Command Config_Commands[5] = {
 		{"save", 	"move the current configuration to the EEPROM", 		TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_SaveSwitchConfiguration, 	EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ModifyPortsOnly},
 		{"delete", 	"remove the current configuration from the EEPROM", 	TERMINATING_COMMMAND, 	1,				false, 	COM_DeleteConfig, 				EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ModifySystem},
+		{"begin", 	"queue the following changes until 'config commit'", 	TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_BatchBegin, 				EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ModifyPortsOnly},
+		{"commit", 	"apply the changes queued since 'config begin'", 		TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_BatchCommit, 				EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ModifyPortsOnly},
 		{0,0,0,0,0,0,0}
 };
 //*******************************************************************************************************************
@@ -562,12 +633,13 @@ static const Command Duplex_Settings[5] = {
 		{"10BT", 			"set this port to operate at 10BaseT", 												TERMINATING_COMMMAND, 	3,	false, 	COM_ClearBitEthernetController, 	{PORT_CONTROL5_OFFSET,"0x06","Setting port to 10 Mbps..."}, 		NO_CHILD_MENU,	ModifyPortsOnly},
 		{0,0,0,0,0,0}
 };
-static const Command Port_Options[15] = {
+static const Command Port_Options[16] = {
 		{"enable", 				"turn this port on", 										TERMINATING_COMMMAND, 	3,				false, 	COM_ClearBitEthernetController, 	{PORT_CONTROL6_OFFSET,"0x03","Enabling Selected Port..."},				 	NO_CHILD_MENU,				ModifyPortsOnly},
 		{"disable", 			"turn this port off", 										TERMINATING_COMMMAND, 	3,				false, 	COM_SetBitEthernetController, 		{PORT_CONTROL6_OFFSET,"0x03","Disabling Selected Port..."},				 	NO_CHILD_MENU,				ModifyPortsOnly},
 		{"vlan", 				"assign a vlan to this port", 								HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 			EMPTY_STATIC_PARAMS, 														VLAN_Settings,				ModifyPortsOnly},
 		{"speed",				"modify the rate at which this port operates", 				HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 			EMPTY_STATIC_PARAMS,														Duplex_Settings,			ModifyPortsOnly},
 		{"status",				"information regarding the current state of this port", 	TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowPortStatus, 				EMPTY_STATIC_PARAMS,														NO_CHILD_MENU,				ReadOnlyUser},
+		{"stats",				"traffic and error counters of this port", 					TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowPortStats, 					EMPTY_STATIC_PARAMS,														NO_CHILD_MENU,				ReadOnlyUser},
 		{"broadcast-storm", 	"enable/disable broadcast storm protection", 				HAS_CHILD, 				2,				false, 	NotImplementedFunction, 			{PORT_CONTROL0_OFFSET, "0x07"},												Enable_Disable_Options,		ModifyPortsOnly},
 		{"sniff-state", 		"sniffing settings for this port", 							HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 			EMPTY_STATIC_PARAMS, 														Sniffing_Settings,			ModifyPortsOnly},
 		{"toggle-tx", 			"enable/disable packet transmission", 						HAS_CHILD, 				2,				false, 	NotImplementedFunction, 			{PORT_CONTROL2_OFFSET, "0x02"},												Enable_Disable_Options,		ModifyPortsOnly},
@@ -579,11 +651,22 @@ static const Command Port_Options[15] = {
 		{"force-mdi", 			"manually enable/disable MDI mode", 						HAS_CHILD, 				2,				false, 	NotImplementedFunction, 			{PORT_CONTROL6_OFFSET, "0x01"},												Enable_Disable_Options,		ModifyPortsOnly},
 		{0,0,0,0,0,0,0}
 };
-static const Command Port_Commands[5] = {
+static const Command DiagScan_Options[2] = {
+		{"<minutes [0-1440]>", "minutes between scans, 0 disables the scan", TERMINATING_COMMMAND, 1,true, COM_SetCableDiagScan, EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	ModifyPortsOnly},
+		{0,0,0,0,0,0,0}
+};
+static const Command All_Port_Options[4] = {
+		{"diagnostics", 		"run cable diagnostics on every port at once", 				TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_RunAllCableDiagnostics, 		EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,		ReadOnlyUser},
+		{"diagnostics-results", "show the last cable diagnostics of every port", 			TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ShowCableDiagnostics, 			EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,		ReadOnlyUser},
+		{"diagnostics-scan", 	"test ports without a link in the background", 			HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 			EMPTY_STATIC_PARAMS,	DiagScan_Options,	ModifyPortsOnly},
+		{0,0,0,0,0,0,0}
+};
+static const Command Port_Commands[6] = {
 		{"f0", 	"settings for fast-ethernet0", 	HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{PORT1_OFFSET},	Port_Options, 	ReadOnlyUser},
 		{"f1", 	"settings for fast-ethernet1", 	HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{PORT2_OFFSET},	Port_Options,	ReadOnlyUser},
 		{"f2", 	"settings for fast-ethernet2", 	HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{PORT3_OFFSET},	Port_Options,	ReadOnlyUser},
 		{"f3", 	"settings for fast-ethernet3", 	HAS_CHILD, 	1,	false, 	NotImplementedFunction, 	{PORT4_OFFSET},	Port_Options,	ReadOnlyUser},
+		{"all", "settings for every port", 		HAS_CHILD, 	NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,	All_Port_Options,	ReadOnlyUser},
 		{0,0,0,0,0,0,0}
 };
 
@@ -593,10 +676,20 @@ static const Command Port_Commands[5] = {
 // Event Management
 //
 //********************************************************************************************************************
-static const Command Event_Options[5] = {
+static const Command ListLastEvents_Options[2] = {
+		{"<count>", "number of most recent log records to show", TERMINATING_COMMMAND, 1,true, COM_ListLastEvents, EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	Administrator},
+		{0,0,0,0,0,0,0}
+};
+static const Command ListEventsSince_Options[2] = {
+		{"<sequence-no>", "first log record to show", TERMINATING_COMMMAND, 1,true, COM_ListEventsSince, EMPTY_STATIC_PARAMS,	NO_CHILD_MENU,	Administrator},
+		{0,0,0,0,0,0,0}
+};
+static const Command Event_Options[7] = {
 		{"status", 			"list currently enabled/disabled events", 	TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_EventStatus, 		EMPTY_STATIC_PARAMS, NO_CHILD_MENU, 		ReadOnlyUser},
 		{"manage", 			"add an event to log", 						TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ManageEvents, 		EMPTY_STATIC_PARAMS, NO_CHILD_MENU, Administrator},
 		{"list", 			"show all logged events", 					TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_ListEvents, 		EMPTY_STATIC_PARAMS, NO_CHILD_MENU, Administrator},
+		{"list-last", 		"show the most recent logged events", 		HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, EMPTY_STATIC_PARAMS, ListLastEvents_Options, Administrator},
+		{"list-since", 		"show logged events from a sequence number", HAS_CHILD, 			NO_PARAMETERS,	false, 	NotImplementedFunction, EMPTY_STATIC_PARAMS, ListEventsSince_Options, Administrator},
 		{"clear", 			"clear all logged events", 					TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_DeleteEvents, 		EMPTY_STATIC_PARAMS, NO_CHILD_MENU, Administrator},
 		{0,0,0,0,0,0,0}
 };
@@ -634,7 +727,7 @@ static const Command Command_Categories[7] = {
 		{"port", 		"modify a port on the switch board", 								HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS, 	&Port_Commands[0],			ReadOnlyUser},
 		{"controller", 	"modify a setting on the ethernet controller", 						HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,	&Controller_Options[0],		ReadOnlyUser},
 		{"system", 		"advanced settings for changing the operation of this device", 		HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,	&System_Commands[0],		ReadOnlyUser},
-		{"config", 		"save or delete this switch's running configuration", 				HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,	&Config_Commands[0],		ModifyPortsOnly},
+		{"config", 		"save, delete or batch this switch's running configuration", 				HAS_CHILD, 				NO_PARAMETERS,	false, 	NotImplementedFunction, 	EMPTY_STATIC_PARAMS,	&Config_Commands[0],		ModifyPortsOnly},
 		{"logout", 		"exit this session. Does not automatically save configuration.",	TERMINATING_COMMMAND, 	NO_PARAMETERS,	false, 	COM_Logout, 	EMPTY_STATIC_PARAMS, 				NO_CHILD_MENU,				ReadOnlyUser},
 		{0,0,0,0,0,0,0}
 };
@@ -0,0 +1,592 @@
+/**\file layer_sync.c
+ * \brief <b>Configuration Replication Between Layers</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "i2c.h"
+#include "eee_hal.h"
+#include "freertos_init.h"
+#include "config_store.h"
+#include "layer_sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+//*****************************************************************************
+//
+//! Size of the largest frame the master sends: the command code, the frame
+//! length, the offset, a chunk and its CRC.
+//
+//*****************************************************************************
+#define LAYER_SYNC_FRAME_SIZE		(2 + 2 + LAYER_SYNC_CHUNK_SIZE + 4)
+
+//*****************************************************************************
+//
+//! Number of times the I2C master is polled before the waiting task starts
+//! to sleep between polls. A byte takes about 25 us at 400 kbps, so only a
+//! layer holding the clock while it runs a command makes the task sleep.
+//
+//*****************************************************************************
+#define LAYER_SYNC_SPIN_COUNT		2000
+
+//*****************************************************************************
+//
+//! \brief The section a layer is receiving. Chunks are collected a page at a
+//! time and written to the EEPROM once the page is complete, so an
+//! interrupted transfer resumes from the last chunk received.
+//
+//*****************************************************************************
+typedef struct {
+	//! Section being received, CONFIG_SECTION_COUNT if none
+	uint32_t section;
+	//! Length and CRC-32 of the section announced by the master
+	uint32_t length;
+	uint32_t crc;
+	//! Bytes received so far and the CRC-32 of them
+	uint32_t received;
+	uint32_t received_crc;
+} LayerSyncReceiver;
+
+static LayerSyncReceiver LayerSyncRx = {CONFIG_SECTION_COUNT, 0, 0, 0, 0};
+static uint8_t LayerSyncRxPage[EEPROM_PAGE_SIZE];
+
+//*****************************************************************************
+//
+//! Page of the section being sent. Kept off the stack of the interpreter
+//! task, the only one sending.
+//
+//*****************************************************************************
+static uint8_t LayerSyncTxPage[EEPROM_PAGE_SIZE];
+
+//*****************************************************************************
+//
+//! Sections received in full since the last commit and where they are.
+//
+//*****************************************************************************
+static ConfigSectionEntry LayerSyncRxEntries[CONFIG_SECTION_COUNT];
+static uint32_t LayerSyncRxDone = 0;
+
+//*****************************************************************************
+//
+//! I2C address this layer answers at, see LayerAddressInit().
+//
+//*****************************************************************************
+static uint8_t LayerAddress = I2C_DEVICE_ADDR;
+
+//*****************************************************************************
+//
+//! Stores a 32-bit value most significant byte first.
+//
+//*****************************************************************************
+static void LayerSyncPut32(uint8_t *data, uint32_t value)
+{
+	data[0] = (uint8_t)(value >> 24);
+	data[1] = (uint8_t)(value >> 16);
+	data[2] = (uint8_t)(value >> 8);
+	data[3] = (uint8_t)value;
+}
+
+//*****************************************************************************
+//
+//! Reads a 32-bit value stored most significant byte first.
+//
+//*****************************************************************************
+static uint32_t LayerSyncGet32(const uint8_t *data)
+{
+	return (((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3]);
+}
+
+//*****************************************************************************
+//
+//! Returns the CRC-32 of a chunk and its offset, as carried by
+//! LAYER_SYNC_CMD_DATA.
+//
+//*****************************************************************************
+static uint32_t LayerSyncChunkCrc(uint32_t offset, const uint8_t *data, uint32_t length)
+{
+	uint8_t position[2] = {(uint8_t)(offset >> 8), (uint8_t)offset};
+	uint32_t crc;
+
+	crc = EEPROMCrc32(EEPROM_CRC32_INIT, position, sizeof(position));
+	crc = EEPROMCrc32(crc, data, length);
+	return (crc ^ EEPROM_CRC32_INIT);
+}
+
+//*****************************************************************************
+//
+//! Waits for the I2C master to finish the current byte.
+//!
+//! \return Returns false if the byte was not acknowledged, arbitration was
+//! lost or the transfer timed out
+//
+//*****************************************************************************
+static bool LayerSyncWait(void)
+{
+	portTickType start = xTaskGetTickCount();
+	uint32_t spins = 0;
+
+	while (I2CMasterBusy(I2C_BASE_ADDR)) {
+		if (++spins < LAYER_SYNC_SPIN_COUNT) {
+			continue;
+		}
+		if (((xTaskGetTickCount() - start) * portTICK_RATE_MS) > LAYER_SYNC_TIMEOUT_MS) {
+			return false;
+		}
+		vTaskDelay(1);
+	}
+	return (I2CMasterErr(I2C_BASE_ADDR) == I2C_MASTER_ERR_NONE);
+}
+
+//*****************************************************************************
+//
+//! Writes a frame to a layer.
+//!
+//! \param address 7-bit I2C address of the layer
+//! \param frame the command code followed by its parameters
+//! \param length number of bytes in the frame
+//!
+//! \return Returns false if the layer did not take every byte
+//
+//*****************************************************************************
+static bool LayerSyncSend(uint8_t address, const uint8_t *frame, uint32_t length)
+{
+	uint32_t pos;
+
+	I2CMasterSlaveAddrSet(I2C_BASE_ADDR, address, false);
+	I2CMasterDataPut(I2C_BASE_ADDR, frame[0]);
+	I2CMasterControl(I2C_BASE_ADDR, (length == 1) ? I2C_MASTER_CMD_SINGLE_SEND : I2C_MASTER_CMD_BURST_SEND_START);
+	for (pos = 1; ; pos++) {
+		if (!LayerSyncWait()) {
+			//The last byte already ended with a STOP
+			if (pos < length) {
+				I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+			}
+			return false;
+		}
+		if (pos == length) {
+			return true;
+		}
+		I2CMasterDataPut(I2C_BASE_ADDR, frame[pos]);
+		I2CMasterControl(I2C_BASE_ADDR, (pos == (length - 1)) ? I2C_MASTER_CMD_BURST_SEND_FINISH : I2C_MASTER_CMD_BURST_SEND_CONT);
+	}
+}
+
+//*****************************************************************************
+//
+//! Reads the response to the last frame sent to a layer: the number of
+//! values followed by the values. The layer holds the clock until its command
+//! has run.
+//!
+//! \param address 7-bit I2C address of the layer
+//! \param values returns the values
+//! \param length number of values expected
+//!
+//! \return Returns false on a bus error or if the layer returned a different
+//! number of values, e.g. none because the command did not run
+//
+//*****************************************************************************
+static bool LayerSyncReceive(uint8_t address, uint8_t *values, uint32_t length)
+{
+	uint32_t pos, count = 0;
+
+	I2CMasterSlaveAddrSet(I2C_BASE_ADDR, address, true);
+	I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_BURST_RECEIVE_START);
+	for (pos = 0; pos <= length; pos++) {
+		if (!LayerSyncWait()) {
+			if (pos < length) {
+				I2CMasterControl(I2C_BASE_ADDR, I2C_MASTER_CMD_BURST_RECEIVE_ERROR_STOP);
+			}
+			return false;
+		}
+		if (pos == 0) {
+			count = I2CMasterDataGet(I2C_BASE_ADDR);
+		}
+		else {
+			values[pos - 1] = (uint8_t)I2CMasterDataGet(I2C_BASE_ADDR);
+		}
+		if (pos < length) {
+			//The last byte is not acknowledged, which ends the read
+			I2CMasterControl(I2C_BASE_ADDR, (pos == (length - 1)) ? I2C_MASTER_CMD_BURST_RECEIVE_FINISH : I2C_MASTER_CMD_BURST_RECEIVE_CONT);
+		}
+	}
+	return (count == length);
+}
+
+//*****************************************************************************
+//
+//! Sends a frame and reads its response.
+//
+//*****************************************************************************
+static bool LayerSyncTransfer(uint8_t address, const uint8_t *frame, uint32_t length, uint8_t *values, uint32_t count)
+{
+	return (LayerSyncSend(address, frame, length) && LayerSyncReceive(address, values, count));
+}
+
+//*****************************************************************************
+//
+//! Sends a frame and reads its response, sending it again after a bus error.
+//!
+//! \return Returns false if every attempt failed
+//
+//*****************************************************************************
+static bool LayerSyncTransferRetry(uint8_t address, const uint8_t *frame, uint32_t length, uint8_t *values, uint32_t count, LayerSyncReport *report)
+{
+	uint32_t attempt;
+
+	for (attempt = 0; attempt <= LAYER_SYNC_RETRIES; attempt++) {
+		if (LayerSyncTransfer(address, frame, length, values, count)) {
+			return true;
+		}
+		report->retries++;
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+//! Copies one section of the committed generation to a layer. After an
+//! error the layer is asked where to continue from, so chunks it already
+//! holds are not sent again.
+//!
+//! \param address 7-bit I2C address of the layer
+//! \param section the section (CONFIG_SECTION_*)
+//! \param entry the section's entry in the committed generation
+//! \param page scratch buffer of EEPROM_PAGE_SIZE bytes
+//! \param report counts the bytes and retries
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool LayerSyncSendSection(uint8_t address, uint32_t section, const ConfigSectionEntry *entry, uint8_t *page, LayerSyncReport *report)
+{
+	uint8_t frame[LAYER_SYNC_FRAME_SIZE];
+	uint8_t values[3];
+	uint32_t offset = 0, count, cached = 0xFFFFFFFF, failures = 0;
+	bool resume = true;
+
+	while (true) {
+		if (resume) {
+			frame[0] = LAYER_SYNC_CMD_BEGIN;
+			frame[1] = (uint8_t)section;
+			frame[2] = (uint8_t)(entry->length >> 8);
+			frame[3] = (uint8_t)entry->length;
+			LayerSyncPut32(&frame[4], entry->crc);
+			if (!LayerSyncTransferRetry(address, frame, 8, values, 3, report) || values[0] != 1) {
+				return false;
+			}
+			offset = ((uint32_t)values[1] << 8) | values[2];
+			if (offset > entry->length) {
+				return false;
+			}
+			resume = false;
+		}
+		if (offset == entry->length) {
+			return true;
+		}
+
+		//Chunks never span two pages, so one page read serves several frames
+		if ((offset & ~(EEPROM_PAGE_SIZE - 1)) != cached) {
+			cached = offset & ~(EEPROM_PAGE_SIZE - 1);
+			count = ((entry->length - cached) < EEPROM_PAGE_SIZE) ? (entry->length - cached) : EEPROM_PAGE_SIZE;
+			if (!ConfigStoreSectionRead(section, cached, page, count)) {
+				return false;
+			}
+		}
+		count = ((entry->length - offset) < LAYER_SYNC_CHUNK_SIZE) ? (entry->length - offset) : LAYER_SYNC_CHUNK_SIZE;
+
+		frame[0] = LAYER_SYNC_CMD_DATA;
+		frame[1] = (uint8_t)(2 + count + 4);
+		frame[2] = (uint8_t)(offset >> 8);
+		frame[3] = (uint8_t)offset;
+		memcpy(&frame[4], &page[offset - cached], count);
+		LayerSyncPut32(&frame[4 + count], LayerSyncChunkCrc(offset, &page[offset - cached], count));
+
+		if (LayerSyncTransfer(address, frame, 4 + count + 4, values, 1) && values[0] == 1) {
+			offset += count;
+			report->bytes += count;
+			failures = 0;
+		}
+		else {
+			report->retries++;
+			if (++failures > LAYER_SYNC_RETRIES) {
+				return false;
+			}
+			resume = true;
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Copies sections of the committed configuration to the layer at an I2C
+//! address, unless the layer already holds them.
+//!
+//! \param address 7-bit I2C address of the layer
+//! \param sections mask of sections to copy (see CONFIG_SECTION_MASK)
+//! \param report returns the outcome
+//!
+//! \return Returns the outcome
+//
+//*****************************************************************************
+LayerSyncResult LayerSyncRun(uint8_t address, uint32_t sections, LayerSyncReport *report)
+{
+	uint8_t frame[6];
+	uint8_t values[4];
+	ConfigSectionEntry entry;
+	portTickType start = xTaskGetTickCount();
+	uint32_t digest, section;
+
+	memset(report, 0x00, sizeof(LayerSyncReport));
+	digest = ConfigStoreDigest(NULL, sections);
+
+	//Version check: layers already holding the same sections are left alone
+	frame[0] = LAYER_SYNC_CMD_QUERY;
+	frame[1] = (uint8_t)sections;
+	if (!LayerSyncTransferRetry(address, frame, 2, values, 4, report)) {
+		report->result = LayerSyncAbsent;
+	}
+	else if (LayerSyncGet32(values) == digest) {
+		report->result = LayerSyncUpToDate;
+	}
+	else {
+		report->result = LayerSyncUpdated;
+		for (section = 0; section < CONFIG_SECTION_COUNT && report->result == LayerSyncUpdated; section++) {
+			if ((sections & CONFIG_SECTION_MASK(section)) && ConfigStoreSectionInfo(section, &entry)
+					&& !LayerSyncSendSection(address, section, &entry, LayerSyncTxPage, report)) {
+				report->result = LayerSyncFailed;
+			}
+		}
+		if (report->result == LayerSyncUpdated) {
+			frame[0] = LAYER_SYNC_CMD_COMMIT;
+			frame[1] = (uint8_t)sections;
+			LayerSyncPut32(&frame[2], digest);
+			if (!LayerSyncTransferRetry(address, frame, 6, values, 1, report) || values[0] != 1) {
+				report->result = LayerSyncFailed;
+			}
+		}
+	}
+	report->time_ms = (xTaskGetTickCount() - start) * portTICK_RATE_MS;
+	return report->result;
+}
+
+//*****************************************************************************
+//
+//! Starts or resumes receiving a section.
+//!
+//! \param section the section (CONFIG_SECTION_*)
+//! \param length length of the section
+//! \param crc CRC-32 of the section
+//! \param offset returns the offset the master is to send from
+//!
+//! \return Returns false if the section is unknown
+//
+//*****************************************************************************
+bool LayerSyncReceiveBegin(uint32_t section, uint32_t length, uint32_t crc, uint32_t *offset)
+{
+	*offset = 0;
+	if (section >= CONFIG_SECTION_COUNT || length == 0) {
+		return false;
+	}
+
+	if ((LayerSyncRxDone & CONFIG_SECTION_MASK(section)) && LayerSyncRxEntries[section].length == length && LayerSyncRxEntries[section].crc == crc) {
+		//Received in full before the master lost track of it
+		*offset = length;
+	}
+	else if (LayerSyncRx.section == section && LayerSyncRx.length == length && LayerSyncRx.crc == crc) {
+		*offset = LayerSyncRx.received;
+	}
+	else {
+		LayerSyncRxDone &= ~CONFIG_SECTION_MASK(section);
+		LayerSyncRx.section = section;
+		LayerSyncRx.length = length;
+		LayerSyncRx.crc = crc;
+		LayerSyncRx.received = 0;
+		LayerSyncRx.received_crc = EEPROM_CRC32_INIT;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Stores the next chunk of the section being received. Complete pages are
+//! written to the EEPROM, the last one once the section is complete. The
+//! section is checked against its CRC once its last chunk arrives.
+//!
+//! \param offset position of the chunk within the section
+//! \param data the chunk
+//! \param length number of bytes in the chunk
+//! \param crc CRC-32 of the offset and the chunk
+//!
+//! \return Returns false if the chunk is corrupt, out of order or could not
+//! be saved
+//
+//*****************************************************************************
+bool LayerSyncReceiveData(uint32_t offset, const uint8_t *data, uint32_t length, uint32_t crc)
+{
+	LayerSyncReceiver *rx = &LayerSyncRx;
+	uint32_t pos = 0, page_offset, count, received, received_crc;
+
+	if (rx->section >= CONFIG_SECTION_COUNT || length == 0 || crc != LayerSyncChunkCrc(offset, data, length)) {
+		return false;
+	}
+	//A chunk sent again because its response was lost
+	if ((offset + length) <= rx->received) {
+		return true;
+	}
+	if (offset != rx->received || (offset + length) > rx->length) {
+		return false;
+	}
+
+	received = rx->received;
+	received_crc = rx->received_crc;
+	while (pos < length) {
+		page_offset = received % EEPROM_PAGE_SIZE;
+		count = ((length - pos) < (EEPROM_PAGE_SIZE - page_offset)) ? (length - pos) : (EEPROM_PAGE_SIZE - page_offset);
+		memcpy(&LayerSyncRxPage[page_offset], &data[pos], count);
+		received_crc = EEPROMCrc32(received_crc, &data[pos], count);
+		received += count;
+		pos += count;
+		if ((received % EEPROM_PAGE_SIZE) == 0 || received == rx->length) {
+			if (!ConfigStoreImportWrite(rx->section, (received - page_offset - count), LayerSyncRxPage, (page_offset + count))) {
+				return false;
+			}
+		}
+		//Only move on once the bytes are safe, the master resends from here after a failure
+		rx->received = received;
+		rx->received_crc = received_crc;
+	}
+
+	if (rx->received == rx->length) {
+		if ((rx->received_crc ^ EEPROM_CRC32_INIT) != rx->crc) {
+			//Start the section over
+			rx->received = 0;
+			rx->received_crc = EEPROM_CRC32_INIT;
+			return false;
+		}
+		memset(&LayerSyncRxEntries[rx->section], 0x00, sizeof(ConfigSectionEntry));
+		LayerSyncRxEntries[rx->section].length = rx->length;
+		LayerSyncRxEntries[rx->section].crc = rx->crc;
+		LayerSyncRxEntries[rx->section].present = 1;
+		LayerSyncRxDone |= CONFIG_SECTION_MASK(rx->section);
+		rx->section = CONFIG_SECTION_COUNT;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Commits and applies the received sections. Sections the master copied
+//! but did not send are ones it does not hold, they are removed.
+//!
+//! \param sections mask of sections the master copied
+//! \param digest the master's digest of those sections
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool LayerSyncReceiveCommit(uint32_t sections, uint32_t digest)
+{
+	ConfigSectionEntry entries[CONFIG_SECTION_COUNT];
+	uint8_t page_buffer[EEPROM_PAGE_SIZE];
+	uint32_t index;
+	bool result;
+
+	sections &= CONFIG_SECTIONS_ALL;
+	//Already committed, the master did not get the response
+	if (ConfigStoreDigest(NULL, sections) == digest) {
+		return true;
+	}
+
+	memset(entries, 0x00, sizeof(entries));
+	for (index = 0; index < CONFIG_SECTION_COUNT; index++) {
+		if (sections & LayerSyncRxDone & CONFIG_SECTION_MASK(index)) {
+			entries[index] = LayerSyncRxEntries[index];
+		}
+	}
+	//Something is missing or left over from an older transfer
+	result = (ConfigStoreDigest(entries, sections) == digest);
+	if (result) {
+		result = ConfigStoreImportCommit(sections, entries, page_buffer);
+	}
+	//Either way the next transfer starts from scratch
+	LayerSyncRxDone = 0;
+	LayerSyncRx.section = CONFIG_SECTION_COUNT;
+	if (!result) {
+		return false;
+	}
+	return ConfigStoreApply(sections, page_buffer);
+}
+
+//*****************************************************************************
+//
+//! Loads the I2C address saved for this layer and sets the slave to it.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void LayerAddressInit(void)
+{
+	uint8_t address = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_I2CADDR);
+
+	if (address >= LAYER_ADDR_MIN && address <= LAYER_ADDR_MAX) {
+		LayerAddress = address;
+		I2CSlaveAddressSet(I2C_BASE_ADDR, 0, LayerAddress);
+	}
+}
+
+//*****************************************************************************
+//
+//! Returns the I2C address this layer answers at.
+//!
+//! \return Returns the 7-bit address
+//
+//*****************************************************************************
+uint8_t LayerAddressGet(void)
+{
+	return LayerAddress;
+}
+
+//*****************************************************************************
+//
+//! Saves a new I2C address for this layer and moves the slave to it.
+//!
+//! \param address 7-bit address (LAYER_ADDR_MIN - LAYER_ADDR_MAX)
+//!
+//! \return Returns false if the address is out of range or could not be
+//! saved
+//
+//*****************************************************************************
+bool LayerAddressSet(uint8_t address)
+{
+	if (address < LAYER_ADDR_MIN || address > LAYER_ADDR_MAX) {
+		return false;
+	}
+	if (!EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_I2CADDR, address)) {
+		return false;
+	}
+	LayerAddress = address;
+	I2CSlaveAddressSet(I2C_BASE_ADDR, 0, LayerAddress);
+	return true;
+}
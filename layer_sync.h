@@ -0,0 +1,219 @@
+/**\file layer_sync.h
+ * \brief <b>Configuration Replication Between Layers</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef LAYER_SYNC_H_
+#define LAYER_SYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+//! I2C commands of the replication protocol (see i2c_task.h). A layer copying
+//! its configuration is the I2C master, the layer receiving it the slave.
+//! Values of more than one byte are sent most significant byte first.
+//!
+//! LAYER_SYNC_CMD_QUERY: <sections>
+//! 	returns the 32-bit digest of those sections (see ConfigStoreDigest)
+//! LAYER_SYNC_CMD_BEGIN: <section> <16-bit length> <32-bit section CRC>
+//! 	returns <result> <16-bit offset to send from>. The offset is 0 for a new
+//! 	section, where the last transfer stopped if it was interrupted and the
+//! 	length once the section has been received in full.
+//! LAYER_SYNC_CMD_DATA: <frame length> <16-bit offset> <data> <32-bit CRC>
+//! 	returns <result>. The CRC covers the offset and the data. A chunk not at
+//! 	the offset expected is refused, the master asks again with BEGIN.
+//! LAYER_SYNC_CMD_COMMIT: <sections> <32-bit digest>
+//! 	returns <result>. Commits and applies the received sections if their
+//! 	digest matches. Sections that were not sent are removed.
+//
+//*****************************************************************************
+#define LAYER_SYNC_CMD_QUERY		0x04
+#define LAYER_SYNC_CMD_BEGIN		0x0C
+#define LAYER_SYNC_CMD_DATA			0x0D
+#define LAYER_SYNC_CMD_COMMIT		0x0E
+
+//*****************************************************************************
+//
+//! Bytes of section data per LAYER_SYNC_CMD_DATA frame. Divides
+//! EEPROM_PAGE_SIZE so a chunk never spans two pages, and together with the
+//! offset and the CRC fits in I2C_VARIABLE_MAX_LENGTH.
+//
+//*****************************************************************************
+#define LAYER_SYNC_CHUNK_SIZE		32
+
+//*****************************************************************************
+//
+//! Addresses probed by "system sync layers all", starting at the default
+//! address of a layer (I2C_DEVICE_ADDR). Every layer leaves the factory at
+//! that address, so each one in a stack needs its own address in this range
+//! ("system i2c address") before it can be found. The layer's own address is
+//! skipped.
+//
+//*****************************************************************************
+#define LAYER_SYNC_FIRST_ADDR		0x1A
+#define LAYER_SYNC_LAST_ADDR		0x21
+
+//*****************************************************************************
+//
+//! Range of 7-bit addresses a layer can be given. The others are reserved by
+//! the I2C specification.
+//
+//*****************************************************************************
+#define LAYER_ADDR_MIN				0x08
+#define LAYER_ADDR_MAX				0x77
+
+//*****************************************************************************
+//
+//! Times a frame is sent again after a bus error or a refused chunk before
+//! the layer is given up on. Counted from the last frame that got through.
+//
+//*****************************************************************************
+#define LAYER_SYNC_RETRIES			3
+
+//*****************************************************************************
+//
+//! Longest time in milliseconds the master waits for a transfer to finish.
+//! A layer holds the clock while it runs a command, the longest being a
+//! commit that programs a full VLAN table.
+//
+//*****************************************************************************
+#define LAYER_SYNC_TIMEOUT_MS		3000
+
+//*****************************************************************************
+//
+//! \brief Outcome of copying the configuration to one layer.
+//
+//*****************************************************************************
+typedef enum {
+	//! Nothing answered at the address
+	LayerSyncAbsent,
+	//! The layer already held the same sections
+	LayerSyncUpToDate,
+	//! The sections were copied, committed and applied
+	LayerSyncUpdated,
+	//! The transfer or the commit failed, the layer kept its configuration
+	LayerSyncFailed
+} LayerSyncResult;
+
+//*****************************************************************************
+//
+//! \brief Report of LayerSyncRun().
+//
+//*****************************************************************************
+typedef struct {
+	LayerSyncResult result;
+	//! Section bytes the layer accepted
+	uint32_t bytes;
+	//! Frames that had to be sent again
+	uint32_t retries;
+	//! Time taken in milliseconds
+	uint32_t time_ms;
+} LayerSyncReport;
+
+//*****************************************************************************
+//
+//! Copies sections of the committed configuration to the layer at an I2C
+//! address. Skipped if the layer's digest of the sections already matches.
+//! Only called by the interpreter task, which owns the I2C master.
+//!
+//! \param address 7-bit I2C address of the layer
+//! \param sections mask of sections to copy (see CONFIG_SECTION_MASK)
+//! \param report returns the outcome
+//!
+//! \return Returns the outcome
+//
+//*****************************************************************************
+extern LayerSyncResult LayerSyncRun(uint8_t address, uint32_t sections, LayerSyncReport *report);
+//*****************************************************************************
+//
+//! Loads the I2C address saved for this layer in EEPROM_FIRMWARE_I2CADDR and
+//! sets the slave to it. An erased or invalid byte keeps I2C_DEVICE_ADDR.
+//! Called once from main() after the EEPROM has been initialized.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void LayerAddressInit(void);
+//*****************************************************************************
+//
+//! Returns the I2C address this layer answers at.
+//!
+//! \return Returns the 7-bit address
+//
+//*****************************************************************************
+extern uint8_t LayerAddressGet(void);
+//*****************************************************************************
+//
+//! Saves a new I2C address for this layer and moves the slave to it at once.
+//!
+//! \param address 7-bit address (LAYER_ADDR_MIN - LAYER_ADDR_MAX)
+//!
+//! \return Returns false if the address is out of range or could not be
+//! saved
+//
+//*****************************************************************************
+extern bool LayerAddressSet(uint8_t address);
+//*****************************************************************************
+//
+//! Starts or resumes receiving a section (LAYER_SYNC_CMD_BEGIN). Called by
+//! the I2C task.
+//!
+//! \param section the section (CONFIG_SECTION_*)
+//! \param length length of the section
+//! \param crc CRC-32 of the section
+//! \param offset returns the offset the master is to send from
+//!
+//! \return Returns false if the section is unknown
+//
+//*****************************************************************************
+extern bool LayerSyncReceiveBegin(uint32_t section, uint32_t length, uint32_t crc, uint32_t *offset);
+//*****************************************************************************
+//
+//! Stores the next chunk of the section being received
+//! (LAYER_SYNC_CMD_DATA). Called by the I2C task.
+//!
+//! \param offset position of the chunk within the section
+//! \param data the chunk
+//! \param length number of bytes in the chunk
+//! \param crc CRC-32 of the offset and the chunk
+//!
+//! \return Returns false if the chunk is corrupt, out of order or could not
+//! be saved
+//
+//*****************************************************************************
+extern bool LayerSyncReceiveData(uint32_t offset, const uint8_t *data, uint32_t length, uint32_t crc);
+//*****************************************************************************
+//
+//! Commits and applies the received sections (LAYER_SYNC_CMD_COMMIT). Called
+//! by the I2C task.
+//!
+//! \param sections mask of sections the master copied
+//! \param digest the master's digest of those sections
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool LayerSyncReceiveCommit(uint32_t sections, uint32_t digest);
+
+#endif /* LAYER_SYNC_H_ */
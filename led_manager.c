@@ -1,5 +1,5 @@
 /**\file led_manager.c
- * \brief <b>A FreeRTOS task that spawns/deletes LED tasks at runtime.</b>
+ * \brief <b>Starts the LED timer and sets the LED blink patterns at runtime.</b>
  *
  *
  *  Created on: May 20, 2016
@@ -25,116 +25,105 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
 #include "sysctl.h"
 #include "inc/hw_types.h"
 #include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
 #include "driverlib/rom.h"
-#include "drivers/rgb.h"
-#include "drivers/buttons.h"
-#include "utils/uartstdio.h"
-#include "led_task.h"
 #include "led_manager.h"
-#include "priorities.h"
+#include "led_task.h"
+#include "memory_budget.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "semphr.h"
-
-//*****************************************************************************
-//
-//! The stack size for the LED toggle task.
-//
-//*****************************************************************************
-#define LEDTASKSTACKSIZE        500         // Stack size in words
 
 //*****************************************************************************
 //
-//! The item size and queue size for the LED message queue.
+//! The item size for the LED message queue, see LED_QUEUE_SIZE.
 //
 //*****************************************************************************
 #define LED_ITEM_SIZE           sizeof(LEDProps)
-#define LED_QUEUE_SIZE          20
 
 //*****************************************************************************
 //
-//! Default LED toggle delay value. LED toggling frequency is twice this number.
+//! The queue that holds messages sent to the LED manager. The LED timer applies
+//! them on its next tick.
 //
 //*****************************************************************************
-#define LED_TOGGLE_DELAY        125
+xQueueHandle g_pLEDQueue;
 
 //*****************************************************************************
 //
-//! The queue that holds messages sent to the LED task.
+//! Initializes the LED message queue, turns on every LED and starts the LED
+//! timer. No task is created, every LED is driven from LEDTimerIntHandler().
+//!
+//! \return Returns 0 on success
 //
 //*****************************************************************************
-xQueueHandle g_pLEDQueue;
-static LEDParameters LEDTaskData;
-static void LEDManagerTask(void *pvParameters)
+uint32_t LEDManagerTaskInit(void)
 {
+	uint8_t led;
+
+    g_pLEDQueue = MemoryQueueCreate("LED", LED_QUEUE_SIZE, LED_ITEM_SIZE);
+    if (g_pLEDQueue == NULL) {
+    	return(1);
+    }
+
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+    GPIOPinTypeGPIOOutput(LED1_PORT_BASE, LED1_PIN_BASE | LED2_PIN_BASE | LED3_PIN_BASE | LED4_PIN_BASE);
+    for (led = 0; led < LED_COUNT; led++) {
+    	LEDPatternClear(led);
+    }
 
-	LEDProps LEDToModify;
-	static TaskHandle_t TaskHandles[4] = {0};
     //
-    // Loop forever.
+    // Start the periodic LED timer.
     //
-	GPIOPinWrite(LEDS[0].port_base, LEDS[0].pin_base, LEDS[0].pin_base);
-	GPIOPinWrite(LEDS[1].port_base, LEDS[1].pin_base, LEDS[1].pin_base);
-	GPIOPinWrite(LEDS[2].port_base, LEDS[2].pin_base, LEDS[2].pin_base);
-	GPIOPinWrite(LEDS[3].port_base, LEDS[3].pin_base, LEDS[3].pin_base);
+    ROM_SysCtlPeripheralEnable(LED_TIMER_SYS_BASE);
+    TimerConfigure(LED_TIMER_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(LED_TIMER_BASE, TIMER_A, ((SysCtlClockGet() / 1000) * LED_TICK_MS) - 1);
+    TimerIntEnable(LED_TIMER_BASE, TIMER_TIMA_TIMEOUT);
 
-    while(1)
-    {
-        //
-        // Read the next message, if available on queue.
-        //
-        if(xQueueReceive(g_pLEDQueue, &LEDToModify, NULL) == pdPASS)
-        {
-        	char TASK_ID[5] = "LED";
-        	LEDTaskData.port_base = LEDS[LEDToModify.LEDID].port_base;
-        	LEDTaskData.pin_base = LEDS[LEDToModify.LEDID].pin_base;
-        	LEDTaskData.interval = LEDToModify.interval;
+	//Interrupts that call FreeRTOS API functions must not be above configMAX_SYSCALL_INTERRUPT_PRIORITY
+    IntPrioritySet(LED_TIMER_INT, LED_INT_PRIORITY);
+    IntEnable(LED_TIMER_INT);
+    TimerEnable(LED_TIMER_BASE, TIMER_A);
 
-        	//Is LED ID Valid?
-        	if (LEDToModify.LEDID < 4) {
-				//Does task exist?
-				if (TaskHandles[LEDToModify.LEDID] != 0)
-				{
-					vTaskDelete(TaskHandles[LEDToModify.LEDID]);
-			    	GPIOPinWrite(LEDS[LEDToModify.LEDID].port_base, LEDS[LEDToModify.LEDID].pin_base, LEDS[LEDToModify.LEDID].pin_base);
-					TaskHandles[LEDToModify.LEDID] = 0;
-				}
-				if (!LEDToModify.ClearLED) {
-					TASK_ID[4] = LEDToModify.LEDID + '0';
-					xTaskCreate(LEDTask, (const portCHAR *)TASK_ID, LEDTASKSTACKSIZE, &LEDTaskData, tskIDLE_PRIORITY + PRIORITY_LED_TASK, &TaskHandles[LEDToModify.LEDID]);
-				}
-        	}
-        }
-    }
+    //
+    // Success.
+    //
+    return(0);
 }
 
 //*****************************************************************************
 //
-//! Initializes the LED task.
+//! Blinks an LED with a pattern that cannot be expressed as a LEDProps
+//! interval, for example a number of short flashes. Must not be called from an
+//! interrupt, use g_pLEDQueue there.
+//!
+//! \param led the LED (0 - 3)
+//! \param period_ms length of one blink in (ms), zero holds the LED on
+//! \param on_ms time in (ms) the LED is on in each blink
+//! \param count number of blinks before the LED is cleared, zero blinks forever
+//!
+//! \return Returns false if the LED or the pattern is invalid
 //
 //*****************************************************************************
-uint32_t LEDManagerTaskInit(void)
+bool LEDManagerSetPattern(uint8_t led, uint16_t period_ms, uint16_t on_ms, uint16_t count)
 {
-    g_pLEDQueue = xQueueCreate(LED_QUEUE_SIZE, LED_ITEM_SIZE);
-
-    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-    GPIOPinTypeGPIOOutput(LED1_PORT_BASE, LED1_PIN_BASE | LED2_PIN_BASE | LED3_PIN_BASE | LED4_PIN_BASE);
+	LEDPattern pattern;
 
-    //
-    // Create the LED task.
-    //
-    if(xTaskCreate(LEDManagerTask, (const portCHAR *)"LED_MANAGER", LEDTASKSTACKSIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_LEDMANAGER_TASK, NULL) != pdTRUE)
-    {
-        return(1);
-    }
+	if (led >= LED_COUNT || on_ms > period_ms) {
+		return false;
+	}
+	pattern.period_ms = period_ms;
+	pattern.on_ms = on_ms;
+	pattern.count = count;
 
-    //
-    // Success.
-    //
-    return(0);
+	//The LED timer interrupt is masked while the pattern is replaced
+	taskENTER_CRITICAL();
+	LEDPatternApply(led, &pattern);
+	taskEXIT_CRITICAL();
+	return true;
 }
@@ -41,21 +41,36 @@ typedef struct LEDParams {
 
 //*****************************************************************************
 //
-//! \brief Parameters that the LED manager uses to pass function parameters to each LED
-//! task it spawns.
+//! \brief Message sent to the LED manager through g_pLEDQueue to start or stop
+//! blinking an LED.
 //
 //*****************************************************************************
 typedef struct LEDInfo {
-	//! A number representing which LED this new task should control (0 - 3)
+	//! A number representing which LED this message controls (0 - 3)
 	uint8_t LEDID;
 	//! An interval in (ms) to use when toggling the LED on and off. An interval
-	//! less than or equal to zero means that this task should hold the LED on
-	//! until deleted.
+	//! less than or equal to zero means that the LED should be held on
+	//! until cleared.
 	uint32_t interval;
-	//! Should this LED task be deleted?
+	//! Should this LED be cleared?
 	bool ClearLED;
 } LEDProps;
 
+//*****************************************************************************
+//
+//! \brief Blink pattern of one LED. The LED is on for the first on_ms of every
+//! period_ms and off for the rest.
+//
+//*****************************************************************************
+typedef struct LEDPatternInfo {
+	//! Length of one blink in (ms), zero holds the LED on
+	uint16_t period_ms;
+	//! Time in (ms) the LED is on in each blink
+	uint16_t on_ms;
+	//! Number of blinks before the LED is cleared, zero blinks forever
+	uint16_t count;
+} LEDPattern;
+
 //*****************************************************************************
 //
 //! Configuration settings that allow the developer to change which port and pins
@@ -73,14 +88,26 @@ typedef struct LEDInfo {
 #define LED4_PORT_BASE GPIO_PORTE_BASE
 
 
+//*****************************************************************************
+//
+//! Timer that steps the blink patterns of every LED each LED_TICK_MS.
+//
+//*****************************************************************************
+#define LED_COUNT				4
+#define LED_TICK_MS				10
+#define LED_TIMER_BASE			TIMER3_BASE
+#define LED_TIMER_SYS_BASE		SYSCTL_PERIPH_TIMER3
+#define LED_TIMER_INT			INT_TIMER3A
+#define LED_INT_PRIORITY		0xC0
+
 //*****************************************************************************
 //
 //! Once configured above, the "LEDS" array assigns a port and pin to a logical
-//! LED. The LED manager then spawns four tasks on demand that are passed a single
-//! entry in this array.
+//! LED. The LED timer then drives every entry in this array from its blink
+//! pattern.
 //
 //*****************************************************************************
-static LEDParameters LEDS[4] = {
+static LEDParameters LEDS[LED_COUNT] = {
 		{LED1_PORT_BASE, LED1_PIN_BASE},
 		{LED2_PORT_BASE, LED2_PIN_BASE},
 		{LED3_PORT_BASE, LED3_PIN_BASE},
@@ -88,5 +115,6 @@ static LEDParameters LEDS[4] = {
 };
 
 extern uint32_t LEDManagerTaskInit(void);
+extern bool LEDManagerSetPattern(uint8_t led, uint16_t period_ms, uint16_t on_ms, uint16_t count);
 
 #endif /* LED_MANAGER_H_ */
@@ -1,5 +1,5 @@
 /**\file led_task.c
- * \brief <b>A Simple FreeRTOS task designed to blink an LED on the port, pin and interval specified.</b>
+ * \brief <b>A single timer interrupt that blinks every LED from its pattern.</b>
  *
  *
  *  Created on: May 20, 2016
@@ -27,66 +27,147 @@
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "driverlib/gpio.h"
+#include "driverlib/timer.h"
 #include "driverlib/rom.h"
-#include "drivers/rgb.h"
-#include "drivers/buttons.h"
-#include "utils/uartstdio.h"
-#include "led_task.h"
 #include "led_manager.h"
-#include "priorities.h"
+#include "led_task.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
-#include "semphr.h"
 
 //*****************************************************************************
 //
-//! Default LED toggle delay value. LED toggling frequency is twice this number.
+//! \brief State of one LED driven by the LED timer.
+//
+//*****************************************************************************
+typedef struct LEDStateInfo {
+	//! The pattern being blinked
+	LEDPattern pattern;
+	//! Time in (ms) since the current blink started
+	uint16_t elapsed;
+	//! Blinks left before the LED is cleared, zero if it blinks forever
+	uint16_t remaining;
+	//! Is a pattern being blinked?
+	bool active;
+	//! Is the pin currently driven high?
+	bool lit;
+} LEDState;
+
+//*****************************************************************************
+//
+//! The queue that holds messages sent to the LED manager.
 //
 //*****************************************************************************
-#define LED_DEF_TOGGLE_DELAY        125
+extern xQueueHandle g_pLEDQueue;
 
+static LEDState LEDStates[LED_COUNT];
 
 //*****************************************************************************
 //
-//! This task toggles the user selected LED at a user selected frequency.
+//! Drives the pin of an LED, only touching the GPIO when the level changes.
+//!
+//! \param led the LED (0 - 3)
+//! \param lit true to drive the pin high
+//!
+//! \return Returns void
 //
 //*****************************************************************************
-void LEDTask(void *pvParameters)
+static void LEDWrite(uint8_t led, bool lit)
 {
-    portTickType ui32WakeTime;
-    uint32_t ui32LEDToggleDelay;
-    LEDParameters *params = (LEDParameters*)pvParameters;
-    ui32WakeTime = xTaskGetTickCount();
-    //
-    // Initialize the LED Toggle Delay to default value.
-    //
-    if (params->interval > 0) {
-        ui32LEDToggleDelay = params->interval;
-    }
-    else {
-    	ui32LEDToggleDelay = LED_DEF_TOGGLE_DELAY;
-    }
-
+	if (LEDStates[led].lit != lit) {
+		GPIOPinWrite(LEDS[led].port_base, LEDS[led].pin_base, lit ? LEDS[led].pin_base : 0);
+		LEDStates[led].lit = lit;
+	}
+}
 
-    //
-    // Loop forever.
-    //
-    while(1)
-    {
-        //
-        // Get the current tick count.
-        //
-    	GPIOPinWrite(params->port_base, params->pin_base, params->pin_base);
-         //
-        // Wait for the required amount of time.
-        //
-        vTaskDelayUntil(&ui32WakeTime, ui32LEDToggleDelay / portTICK_RATE_MS);
+//*****************************************************************************
+//
+//! Starts blinking an LED from the first blink of its pattern.
+//!
+//! \param led the LED (0 - 3)
+//! \param pattern the pattern to blink
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void LEDPatternApply(uint8_t led, const LEDPattern *pattern)
+{
+	if (led >= LED_COUNT) {
+		return;
+	}
+	LEDStates[led].pattern = *pattern;
+	LEDStates[led].elapsed = 0;
+	LEDStates[led].remaining = pattern->count;
+	LEDStates[led].active = true;
+	LEDStates[led].lit = false;
+	LEDWrite(led, (pattern->on_ms > 0) || (pattern->period_ms == 0));
+}
 
-    	if (params->interval > 0) {
-    		GPIOPinWrite(params->port_base, params->pin_base, 0);
-    	}
-        vTaskDelayUntil(&ui32WakeTime, ui32LEDToggleDelay / portTICK_RATE_MS);
-    }
+//*****************************************************************************
+//
+//! Stops blinking an LED and returns its pin to the level set at power-up.
+//!
+//! \param led the LED (0 - 3)
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void LEDPatternClear(uint8_t led)
+{
+	if (led >= LED_COUNT) {
+		return;
+	}
+	LEDStates[led].active = false;
+	LEDStates[led].lit = false;
+	LEDWrite(led, true);
 }
 
+//*****************************************************************************
+//
+//! Interrupt handler for the LED timer. Applies the messages waiting in
+//! g_pLEDQueue, then advances the pattern of every LED by LED_TICK_MS.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void LEDTimerIntHandler(void)
+{
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+	LEDProps message;
+	LEDPattern pattern;
+	LEDState *state;
+	uint8_t led;
+
+	TimerIntClear(LED_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+
+	while (xQueueReceiveFromISR(g_pLEDQueue, &message, &xHigherPriorityTaskWoken) == pdPASS) {
+		if (message.ClearLED) {
+			LEDPatternClear(message.LEDID);
+		}
+		else {
+			//An interval toggles the LED on and off forever, no interval holds it on
+			pattern.period_ms = (uint16_t)(message.interval * 2);
+			pattern.on_ms = (uint16_t)message.interval;
+			pattern.count = 0;
+			LEDPatternApply(message.LEDID, &pattern);
+		}
+	}
+
+	for (led = 0; led < LED_COUNT; led++) {
+		state = &LEDStates[led];
+		if (!state->active || state->pattern.period_ms == 0) {
+			continue;
+		}
+		state->elapsed += LED_TICK_MS;
+		if (state->elapsed >= state->pattern.period_ms) {
+			state->elapsed = 0;
+			if (state->remaining != 0 && --state->remaining == 0) {
+				LEDPatternClear(led);
+				continue;
+			}
+		}
+		LEDWrite(led, state->elapsed < state->pattern.on_ms);
+	}
+
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
@@ -1,5 +1,5 @@
 /**\file led_task.h
- * \brief <b>Function Prototypes for each LED task</b>
+ * \brief <b>Function Prototypes for the LED timer</b>
  *
  *
  *  Created on: May 20, 2016
@@ -27,9 +27,11 @@
 
 //*****************************************************************************
 //
-// Prototypes for the LED task.
+// Prototypes for the LED timer. LEDPatternApply() and LEDPatternClear() must
+// be called from the LED timer or with its interrupt masked.
 //
 //*****************************************************************************
-extern uint32_t LEDTaskInit(void);
-extern void LEDTask(void *pvParameters);
+extern void LEDPatternApply(uint8_t led, const LEDPattern *pattern);
+extern void LEDPatternClear(uint8_t led);
+extern void LEDTimerIntHandler(void);
 #endif // __LED_TASK_H__
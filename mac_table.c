@@ -0,0 +1,458 @@
+/**\file mac_table.c
+ * \brief <b>MAC Table Snapshot Service</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "eee_hal.h"
+#include "interpreter_task.h"
+#include "freertos_init.h"
+#include "mac_table.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+//*****************************************************************************
+//
+//! Snapshot of the static and dynamic MAC tables.
+//
+//*****************************************************************************
+static MACEntry MACStatic[MAC_STATIC_TABLE_SIZE];
+static uint32_t MACStaticCount = 0;
+static MACEntry MACDynamic[MAC_SNAPSHOT_DYNAMIC_MAX];
+static uint32_t MACDynamicCount = 0;
+//*****************************************************************************
+//
+//! Number of valid dynamic entries reported by the Ethernet Controller.
+//
+//*****************************************************************************
+static uint32_t MACDynamicLearned = 0;
+//*****************************************************************************
+//
+//! Tick counts of the last refresh of each table and of the next refresh.
+//
+//*****************************************************************************
+static portTickType MACStaticTime = 0;
+static portTickType MACDynamicTime = 0;
+static portTickType MACRefreshDue = 0;
+//*****************************************************************************
+//
+//! Guards the snapshot. Held while a refresh updates it and while readers
+//! copy entries out, never while printing.
+//
+//*****************************************************************************
+static xSemaphoreHandle MACTableMutex = NULL;
+
+//*****************************************************************************
+//
+//! Names of the ports, indexed by port number (see MAC_PORT_COUNT).
+//
+//*****************************************************************************
+static const char *MACPortNames[MAC_PORT_COUNT] = {"f3", "f2", "f1", "f0", "exp-port"};
+
+//*****************************************************************************
+//
+//! Takes the snapshot mutex once the scheduler is running.
+//!
+//! \return Returns true if the mutex was taken and must be given back
+//
+//*****************************************************************************
+static bool MACTableLock(void)
+{
+	if (MACTableMutex != NULL && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		return (xSemaphoreTake(MACTableMutex, portMAX_DELAY) == pdTRUE);
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+//! Reads one entry of an indirect MAC table with a single control write and a
+//! single burst read of the data registers. Dynamic entries that are still
+//! being updated are read again up to MAC_ENTRY_READY_RETRIES times.
+//!
+//! \param table INDIRECT_TABLESELCT_STATICMAC or INDIRECT_TABLESELECT_DYNMAC
+//! \param index the entry to read
+//! \param data returns the data registers, 8 (static) or 9 (dynamic) values
+//! \param ready returns false if a dynamic entry never became ready
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool MACTableReadEntry(uint32_t table, uint32_t index, uint32_t *data, bool *ready)
+{
+	uint32_t control[2];
+	uint32_t retry;
+	bool dynamic = (table == INDIRECT_TABLESELECT_DYNMAC);
+	bool result;
+
+	control[0] = (table << INDIRECT_CONTROL_TABLESELECT) | (INDIRECT_READTYPE_READ << INDIRECT_CONTROL_READTYPEBIT) | (((index >> 8) & 0x03) << INDIRECT_CONTROL_ADDRESS_HIGH);
+	control[1] = (index & 0xFF);
+
+	EthoIndirectLock();
+	result = EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, 2, control);
+	if (result) {
+		if (dynamic) {
+			result = EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_8, 9, data);
+			//Bit 7 of DATA_6 is set while the entry is being updated
+			for (retry = 0; result && ((data[2] >> 7) & 1) && retry < MAC_ENTRY_READY_RETRIES; retry++) {
+				result = EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_8, 9, data);
+			}
+		}
+		else {
+			result = EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_7, 8, data);
+		}
+	}
+	EthoIndirectUnlock();
+
+	*ready = !(dynamic && ((data[2] >> 7) & 1));
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Reads the static MAC table into the snapshot.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool MACTableRefreshStatic(void)
+{
+	uint32_t data[8];
+	uint32_t index, pos;
+	bool ready;
+
+	MACStaticCount = 0;
+	for (index = 0; index < MAC_STATIC_TABLE_SIZE; index++) {
+		if (!MACTableReadEntry(INDIRECT_TABLESELCT_STATICMAC, index, data, &ready)) {
+			return false;
+		}
+		//Bit 53 (bit 5 of DATA_6) marks a valid entry
+		if (!((data[1] >> 5) & 1)) {
+			continue;
+		}
+		for (pos = 0; pos < 6; pos++) {
+			MACStatic[MACStaticCount].mac[pos] = (data[2 + pos] & 0xFF);
+		}
+		MACStatic[MACStaticCount].port = (data[1] & 0x1F) | (((data[1] >> 7) & 1) ? MAC_STATIC_OVERRIDE : 0);
+		MACStatic[MACStaticCount].fid = ((data[0] >> 1) & 0x7F) | ((data[0] & 1) ? MAC_STATIC_USE_FID : 0);
+		MACStaticCount++;
+	}
+	MACStaticTime = xTaskGetTickCount();
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Reads the valid entries of the dynamic MAC table into the snapshot. Only
+//! as many entries as the Ethernet Controller reports valid are read, and no
+//! more than MAC_SNAPSHOT_DYNAMIC_MAX are kept.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool MACTableRefreshDynamic(void)
+{
+	uint32_t data[9];
+	uint32_t index, pos, learned = 1;
+	bool ready;
+
+	MACDynamicCount = 0;
+	for (index = 0; index < learned && MACDynamicCount < MAC_SNAPSHOT_DYNAMIC_MAX; index++) {
+		if (!MACTableReadEntry(INDIRECT_TABLESELECT_DYNMAC, index, data, &ready)) {
+			MACDynamicLearned = MACDynamicCount;
+			return false;
+		}
+		//Bit 71 (bit 7 of DATA_8) is set when the table is empty
+		if ((data[0] >> 7) & 1) {
+			learned = 0;
+			break;
+		}
+		//Bits 70-61 hold the number of valid entries minus one. The table may shrink while we read it
+		learned = ((((data[0] & 0x7F) << 3) | ((data[1] >> 5) & 0x07)) + 1);
+		if (!ready || index >= learned) {
+			continue;
+		}
+		for (pos = 0; pos < 6; pos++) {
+			MACDynamic[MACDynamicCount].mac[pos] = (data[3 + pos] & 0xFF);
+		}
+		MACDynamic[MACDynamicCount].port = (data[1] & 0x07);
+		MACDynamic[MACDynamicCount].fid = (data[2] & 0x7F);
+		MACDynamicCount++;
+	}
+	MACDynamicLearned = learned;
+	MACDynamicTime = xTaskGetTickCount();
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns true if a snapshot entry matches a filter.
+//!
+//! \param table MAC_TABLE_STATIC or MAC_TABLE_DYNAMIC
+//! \param entry the entry to check
+//! \param filter the filter, NULL matches every entry
+//!
+//! \return Returns true if the entry matches
+//
+//*****************************************************************************
+static bool MACTableMatches(uint32_t table, const MACEntry *entry, const MACFilter *filter)
+{
+	if (filter == NULL) {
+		return true;
+	}
+	if (filter->port != MAC_PORT_ANY) {
+		if (table == MAC_TABLE_DYNAMIC && entry->port != filter->port) {
+			return false;
+		}
+		if (table == MAC_TABLE_STATIC && !((entry->port >> filter->port) & 1)) {
+			return false;
+		}
+	}
+	return (memcmp(entry->mac, filter->prefix, filter->prefix_length) == 0);
+}
+
+//*****************************************************************************
+//
+//! Creates the snapshot mutex. The first snapshot is taken by the first call
+//! to MACTableService() so that it does not delay booting.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void MACTableInit(void)
+{
+	if (MACTableMutex == NULL) {
+		MACTableMutex = xSemaphoreCreateMutex();
+	}
+	MACRefreshDue = xTaskGetTickCount();
+}
+
+//*****************************************************************************
+//
+//! Reads tables from the Ethernet Controller into the snapshot.
+//!
+//! \param tables MAC_TABLE_STATIC and/or MAC_TABLE_DYNAMIC
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool MACTableRefresh(uint32_t tables)
+{
+	bool locked = MACTableLock();
+	bool result = true;
+
+	if (tables & MAC_TABLE_STATIC) {
+		result &= MACTableRefreshStatic();
+	}
+	if (tables & MAC_TABLE_DYNAMIC) {
+		result &= MACTableRefreshDynamic();
+	}
+	if (locked) {
+		xSemaphoreGive(MACTableMutex);
+	}
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Drops the snapshot entries learned on ports whose link changed and
+//! schedules a refresh once MAC_SNAPSHOT_SETTLE_MS has passed.
+//!
+//! \param port_mask bit n selects port n (0 - 4)
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void MACTablePortsChanged(uint32_t port_mask)
+{
+	bool locked = MACTableLock();
+	uint32_t source, target = 0;
+
+	for (source = 0; source < MACDynamicCount; source++) {
+		if (!((port_mask >> MACDynamic[source].port) & 1)) {
+			MACDynamic[target++] = MACDynamic[source];
+		}
+	}
+	MACDynamicLearned -= (MACDynamicCount - target);
+	MACDynamicCount = target;
+	MACRefreshDue = xTaskGetTickCount() + (MAC_SNAPSHOT_SETTLE_MS / portTICK_RATE_MS);
+
+	if (locked) {
+		xSemaphoreGive(MACTableMutex);
+	}
+}
+
+//*****************************************************************************
+//
+//! Refreshes the snapshot if a refresh is due.
+//!
+//! \return Returns the number of ticks until the next refresh is due
+//
+//*****************************************************************************
+uint32_t MACTableService(void)
+{
+	portTickType now = xTaskGetTickCount();
+
+	if ((portTickType)(now - MACRefreshDue) < (portMAX_DELAY / 2)) {
+		MACTableRefresh(MAC_TABLE_STATIC | MAC_TABLE_DYNAMIC);
+		now = xTaskGetTickCount();
+		MACRefreshDue = now + (MAC_SNAPSHOT_REFRESH_MS / portTICK_RATE_MS);
+	}
+	return (MACRefreshDue - now);
+}
+
+//*****************************************************************************
+//
+//! Copies the next snapshot entry matching a filter.
+//!
+//! \param table MAC_TABLE_STATIC or MAC_TABLE_DYNAMIC
+//! \param index position to search from, updated to continue after the entry
+//! \param filter entries to return, NULL for all
+//! \param entry returns the entry
+//!
+//! \return Returns true if an entry was found, false at the end of the table
+//
+//*****************************************************************************
+bool MACTableNext(uint32_t table, uint32_t *index, const MACFilter *filter, MACEntry *entry)
+{
+	const MACEntry *entries = (table == MAC_TABLE_STATIC) ? MACStatic : MACDynamic;
+	bool locked = MACTableLock();
+	bool found = false;
+	uint32_t count = (table == MAC_TABLE_STATIC) ? MACStaticCount : MACDynamicCount;
+
+	for (; *index < count && !found; (*index)++) {
+		if (MACTableMatches(table, &entries[*index], filter)) {
+			*entry = entries[*index];
+			found = true;
+		}
+	}
+	if (locked) {
+		xSemaphoreGive(MACTableMutex);
+	}
+	return found;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of valid entries the Ethernet Controller reported in its
+//! dynamic table at the last refresh.
+//!
+//! \return Returns the number of learned addresses
+//
+//*****************************************************************************
+uint32_t MACTableLearned(void)
+{
+	return MACDynamicLearned;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of milliseconds since a table was last refreshed.
+//!
+//! \param table MAC_TABLE_STATIC or MAC_TABLE_DYNAMIC
+//!
+//! \return Returns the age of the snapshot in milliseconds
+//
+//*****************************************************************************
+uint32_t MACTableAge(uint32_t table)
+{
+	portTickType taken = (table == MAC_TABLE_STATIC) ? MACStaticTime : MACDynamicTime;
+
+	return ((xTaskGetTickCount() - taken) * portTICK_RATE_MS);
+}
+
+//*****************************************************************************
+//
+//! Returns the name of a port.
+//!
+//! \param port the port (0 - 4)
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *MACTablePortName(uint8_t port)
+{
+	return ((port < MAC_PORT_COUNT) ? MACPortNames[port] : "unknown");
+}
+
+//*****************************************************************************
+//
+//! Looks up a port by name.
+//!
+//! \param name the name entered by the user
+//!
+//! \return Returns the port (0 - 4) or MAC_PORT_ANY if the name is unknown
+//
+//*****************************************************************************
+uint8_t MACTablePortFromName(const char *name)
+{
+	uint8_t port;
+
+	for (port = 0; port < MAC_PORT_COUNT; port++) {
+		if (strcmp(name, MACPortNames[port]) == 0) {
+			return port;
+		}
+	}
+	return MAC_PORT_ANY;
+}
+
+//*****************************************************************************
+//
+//! Parses a MAC address prefix of one to six hexadecimal bytes.
+//!
+//! \param text the prefix entered by the user
+//! \param filter returns the prefix in prefix and prefix_length
+//!
+//! \return Returns true if the prefix is valid, otherwise false
+//
+//*****************************************************************************
+bool MACTableParsePrefix(const char *text, MACFilter *filter)
+{
+	uint32_t value, digits;
+
+	filter->prefix_length = 0;
+	while (*text != '\0') {
+		if (filter->prefix_length == 6) {
+			return false;
+		}
+		for (value = 0, digits = 0; isxdigit((unsigned char)*text) && digits < 2; text++, digits++) {
+			value = (value << 4) | (isdigit((unsigned char)*text) ? (*text - '0') : ((tolower((unsigned char)*text) - 'a') + 10));
+		}
+		if (digits == 0) {
+			return false;
+		}
+		filter->prefix[filter->prefix_length++] = (uint8_t)value;
+		if (*text == ':' || *text == '-') {
+			text++;
+		}
+		else if (*text != '\0') {
+			return false;
+		}
+	}
+	return (filter->prefix_length != 0);
+}
@@ -0,0 +1,224 @@
+/**\file mac_table.h
+ * \brief <b>MAC Table Snapshot Service</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef MAC_TABLE_H_
+#define MAC_TABLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+//! Number of entries in the KSZ8895MLUB's static and dynamic MAC tables.
+//
+//*****************************************************************************
+#define MAC_STATIC_TABLE_SIZE		32
+#define MAC_DYNAMIC_TABLE_SIZE		1024
+
+//*****************************************************************************
+//
+//! Number of learned addresses kept in the dynamic snapshot. Further
+//! addresses are counted (MACTableLearned()) but not kept.
+//
+//*****************************************************************************
+#define MAC_SNAPSHOT_DYNAMIC_MAX	64
+
+//*****************************************************************************
+//
+//! Number of times a dynamic entry is read again while the Ethernet
+//! Controller reports it as not ready before it is skipped.
+//
+//*****************************************************************************
+#define MAC_ENTRY_READY_RETRIES		4
+
+//*****************************************************************************
+//
+//! Interval in milliseconds between refreshes of the snapshot, and the time
+//! after a link change before the addresses learned since are read.
+//
+//*****************************************************************************
+#define MAC_SNAPSHOT_REFRESH_MS		10000
+#define MAC_SNAPSHOT_SETTLE_MS		1000
+
+//*****************************************************************************
+//
+//! Tables held in the snapshot, may be combined.
+//
+//*****************************************************************************
+#define MAC_TABLE_STATIC			0x01
+#define MAC_TABLE_DYNAMIC			0x02
+
+//*****************************************************************************
+//
+//! Ports are numbered as on the KSZ8895MLUB: 0 = port 1 (f3) through
+//! 4 = port 5 (exp-port). MAC_PORT_ANY matches every port in a filter.
+//
+//*****************************************************************************
+#define MAC_PORT_COUNT				5
+#define MAC_PORT_ANY				0xFF
+
+//*****************************************************************************
+//
+//! Flags kept in the top bits of a static entry's port and fid fields.
+//
+//*****************************************************************************
+#define MAC_STATIC_OVERRIDE			0x80
+#define MAC_STATIC_USE_FID			0x80
+
+//*****************************************************************************
+//
+//! \brief One entry of the MAC table snapshot.
+//
+//*****************************************************************************
+typedef struct {
+	//! MAC address, most significant byte first
+	uint8_t mac[6];
+	//! Dynamic entries: source port (0 - 4). Static entries: bits 4-0 forwarding
+	//! ports (bit n = port n), MAC_STATIC_OVERRIDE if STP is overridden
+	uint8_t port;
+	//! Bits 6-0 filter ID. Static entries: MAC_STATIC_USE_FID if the FID is used
+	uint8_t fid;
+} MACEntry;
+
+//*****************************************************************************
+//
+//! \brief Selects which snapshot entries MACTableNext() returns.
+//
+//*****************************************************************************
+typedef struct {
+	//! Port to match (0 - 4) or MAC_PORT_ANY
+	uint8_t port;
+	//! Number of leading MAC address bytes to match (0 = any address)
+	uint8_t prefix_length;
+	//! Leading MAC address bytes to match
+	uint8_t prefix[6];
+} MACFilter;
+
+//*****************************************************************************
+//
+//! Creates the snapshot mutex and takes the first snapshot of both tables.
+//! Must be called before the scheduler is started.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void MACTableInit(void);
+//*****************************************************************************
+//
+//! Reads tables from the Ethernet Controller into the snapshot.
+//!
+//! \param tables MAC_TABLE_STATIC and/or MAC_TABLE_DYNAMIC
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool MACTableRefresh(uint32_t tables);
+//*****************************************************************************
+//
+//! Drops the snapshot entries learned on ports whose link changed (their
+//! addresses have been flushed) and schedules a refresh once
+//! MAC_SNAPSHOT_SETTLE_MS has passed.
+//!
+//! \param port_mask bit n selects port n (0 - 4)
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void MACTablePortsChanged(uint32_t port_mask);
+//*****************************************************************************
+//
+//! Refreshes the snapshot if a refresh is due. Called by the port monitor task.
+//!
+//! \return Returns the number of ticks until the next refresh is due
+//
+//*****************************************************************************
+extern uint32_t MACTableService(void);
+//*****************************************************************************
+//
+//! Copies the next snapshot entry matching a filter. Does not access the
+//! Ethernet Controller.
+//!
+//! \param table MAC_TABLE_STATIC or MAC_TABLE_DYNAMIC
+//! \param index position to search from, set to 0 for the first call. Updated
+//! to continue after the returned entry.
+//! \param filter entries to return, NULL for all
+//! \param entry returns the entry
+//!
+//! \return Returns true if an entry was found, false at the end of the table
+//
+//*****************************************************************************
+extern bool MACTableNext(uint32_t table, uint32_t *index, const MACFilter *filter, MACEntry *entry);
+//*****************************************************************************
+//
+//! Returns the number of valid entries the Ethernet Controller reported in its
+//! dynamic table at the last refresh, including those not kept.
+//!
+//! \return Returns the number of learned addresses
+//
+//*****************************************************************************
+extern uint32_t MACTableLearned(void);
+//*****************************************************************************
+//
+//! Returns the number of milliseconds since a table was last refreshed.
+//!
+//! \param table MAC_TABLE_STATIC or MAC_TABLE_DYNAMIC
+//!
+//! \return Returns the age of the snapshot in milliseconds
+//
+//*****************************************************************************
+extern uint32_t MACTableAge(uint32_t table);
+//*****************************************************************************
+//
+//! Returns the name of a port ("f0" - "f3", "exp-port").
+//!
+//! \param port the port (0 - 4)
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+extern const char *MACTablePortName(uint8_t port);
+//*****************************************************************************
+//
+//! Looks up a port by name ("f0" - "f3", "exp-port").
+//!
+//! \param name the name entered by the user
+//!
+//! \return Returns the port (0 - 4) or MAC_PORT_ANY if the name is unknown
+//
+//*****************************************************************************
+extern uint8_t MACTablePortFromName(const char *name);
+//*****************************************************************************
+//
+//! Parses a MAC address prefix of one to six hexadecimal bytes separated by
+//! ':' or '-' (e.g. "00:1A:2B").
+//!
+//! \param text the prefix entered by the user
+//! \param filter returns the prefix in prefix and prefix_length
+//!
+//! \return Returns true if the prefix is valid, otherwise false
+//
+//*****************************************************************************
+extern bool MACTableParsePrefix(const char *text, MACFilter *filter);
+
+#endif /* MAC_TABLE_H_ */
@@ -0,0 +1,298 @@
+/**\file memory_budget.c
+ * \brief <b>Task and Queue Creation with a RAM Budget Report</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "memory_budget.h"
+#include "console.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+//*****************************************************************************
+//
+//! \brief A task created through MemoryTaskCreate().
+//
+//*****************************************************************************
+typedef struct {
+	TaskHandle_t handle;
+	const char *name;
+	uint32_t stack_words;
+	//! Free words left when the task deleted itself
+	uint32_t free_words;
+	bool exited;
+	//! Is this the idle task? Its handle is only known once the scheduler runs.
+	bool idle;
+} MemoryTask;
+
+//*****************************************************************************
+//
+//! \brief A queue created through MemoryQueueCreate(). The queue number set
+//! with vQueueSetQueueNumber() is its index plus one.
+//
+//*****************************************************************************
+typedef struct {
+	QueueHandle_t queue;
+	const char *name;
+	uint32_t length;
+	uint32_t item_size;
+	volatile uint32_t peak;
+} MemoryQueue;
+
+static MemoryTask MemoryTasks[MEMORY_TASK_COUNT];
+static uint32_t MemoryTaskTotal = 0;
+static MemoryQueue MemoryQueues[MEMORY_QUEUE_COUNT];
+static uint32_t MemoryQueueTotal = 0;
+
+//*****************************************************************************
+//
+//! Bytes of heap taken by the tasks and queues created through this module.
+//
+//*****************************************************************************
+static uint32_t MemoryBytes = 0;
+
+//*****************************************************************************
+//
+//! Adds a task to the list reported by "system show memory". The task number
+//! (see vTaskSetTaskNumber()) of an added task is its index plus one, the
+//! performance counters use it to tell callers apart.
+//!
+//! \param handle the task, NULL for the idle task
+//! \param name name the task was created with
+//! \param stack_words size of the stack in words
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void MemoryTaskAdd(TaskHandle_t handle, const char *name, uint32_t stack_words)
+{
+	if (MemoryTaskTotal >= MEMORY_TASK_COUNT) {
+		return;
+	}
+	MemoryTasks[MemoryTaskTotal].handle = handle;
+	MemoryTasks[MemoryTaskTotal].name = name;
+	MemoryTasks[MemoryTaskTotal].stack_words = stack_words;
+	MemoryTasks[MemoryTaskTotal].free_words = 0;
+	MemoryTasks[MemoryTaskTotal].exited = false;
+	MemoryTasks[MemoryTaskTotal].idle = (handle == NULL);
+	MemoryTaskTotal++;
+	if (handle != NULL) {
+		vTaskSetTaskNumber(handle, MemoryTaskTotal);
+	}
+}
+
+//*****************************************************************************
+//
+//! Adds the idle task to the memory report. The kernel creates it on the heap
+//! when the scheduler starts, so call this just before vTaskStartScheduler().
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void MemoryIdleTaskAdd(void)
+{
+	MemoryTaskAdd(NULL, "IDLE", IDLE_TASK_STACK_SIZE);
+}
+
+//*****************************************************************************
+//
+//! Creates a task on the heap and adds it to the memory report. Must be called
+//! before the scheduler is started. A task that does not fit in the report
+//! is not created, the last entry is kept for the idle task.
+//!
+//! \param task function the task runs
+//! \param name name of the task
+//! \param stack_words size of stack in words
+//! \param priority priority of the task
+//!
+//! \return Returns the task, or NULL if it could not be created
+//
+//*****************************************************************************
+TaskHandle_t MemoryTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_words, UBaseType_t priority)
+{
+	size_t heap_free = xPortGetFreeHeapSize();
+	TaskHandle_t handle = NULL;
+
+	if (MemoryTaskTotal >= (MEMORY_TASK_COUNT - 1)) {
+		ConsolePrintfWait("[BOOTING]: No room for task %s, raise MEMORY_TASK_COUNT\n", name);
+		return NULL;
+	}
+	if (xTaskCreate(task, name, stack_words, NULL, priority, &handle) == pdPASS) {
+		MemoryBytes += heap_free - xPortGetFreeHeapSize();
+		MemoryTaskAdd(handle, name, stack_words);
+	}
+	return handle;
+}
+
+//*****************************************************************************
+//
+//! Records the stack usage of the calling task before it deletes itself, its
+//! handle must not be used afterwards.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void MemoryTaskExit(void)
+{
+	TaskHandle_t handle = xTaskGetCurrentTaskHandle();
+	uint32_t i;
+
+	for (i = 0; i < MemoryTaskTotal; i++) {
+		if (MemoryTasks[i].handle == handle) {
+			MemoryTasks[i].free_words = uxTaskGetStackHighWaterMark(NULL);
+			MemoryTasks[i].exited = true;
+		}
+	}
+}
+
+//*****************************************************************************
+//
+//! Creates a queue on the heap and adds it to the memory report. Must be
+//! called before the scheduler is started.
+//!
+//! \param name name of the queue, also added to the kernel's queue registry
+//! \param length number of items the queue can hold
+//! \param item_size size of one item in bytes
+//!
+//! \return Returns the queue, or NULL if it could not be created
+//
+//*****************************************************************************
+QueueHandle_t MemoryQueueCreate(const char *name, uint32_t length, uint32_t item_size)
+{
+	size_t heap_free = xPortGetFreeHeapSize();
+	QueueHandle_t queue = xQueueCreate(length, item_size);
+
+	if (queue == NULL) {
+		return NULL;
+	}
+	MemoryBytes += heap_free - xPortGetFreeHeapSize();
+	if (MemoryQueueTotal >= MEMORY_QUEUE_COUNT) {
+		ConsolePrintfWait("[BOOTING]: Queue %s is not reported, raise MEMORY_QUEUE_COUNT\n", name);
+	}
+	else {
+		MemoryQueues[MemoryQueueTotal].queue = queue;
+		MemoryQueues[MemoryQueueTotal].name = name;
+		MemoryQueues[MemoryQueueTotal].length = length;
+		MemoryQueues[MemoryQueueTotal].item_size = item_size;
+		MemoryQueues[MemoryQueueTotal].peak = 0;
+		MemoryQueueTotal++;
+		vQueueSetQueueNumber(queue, MemoryQueueTotal);
+		vQueueAddToRegistry(queue, name);
+	}
+	return queue;
+}
+
+//*****************************************************************************
+//
+//! Called by the kernel (traceQUEUE_SEND, see FreeRTOSConfig.h) just before an
+//! item is copied into a queue, from tasks and interrupts. Semaphores and
+//! queues that were not created through MemoryQueueCreate() have queue number
+//! zero and are skipped.
+//!
+//! \param queue the queue receiving the item
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void MemoryQueueSent(void *queue)
+{
+	UBaseType_t number = uxQueueGetQueueNumber((QueueHandle_t)queue);
+	uint32_t waiting;
+
+	if (number == 0 || number > MemoryQueueTotal) {
+		return;
+	}
+	//The item has not been copied yet
+	waiting = uxQueueMessagesWaitingFromISR((QueueHandle_t)queue) + 1;
+	if (waiting > MemoryQueues[number - 1].length) {
+		waiting = MemoryQueues[number - 1].length;
+	}
+	if (waiting > MemoryQueues[number - 1].peak) {
+		MemoryQueues[number - 1].peak = waiting;
+	}
+}
+
+//*****************************************************************************
+//
+//! Returns the stack usage of a task.
+//!
+//! \param index the task (0 - MEMORY_TASK_COUNT - 1), in order of creation
+//! \param info returns the stack usage
+//!
+//! \return Returns false if there is no such task
+//
+//*****************************************************************************
+bool MemoryTaskGet(uint32_t index, MemoryTaskInfo *info)
+{
+	TaskHandle_t handle;
+
+	if (index >= MemoryTaskTotal) {
+		return false;
+	}
+	info->name = MemoryTasks[index].name;
+	info->stack_words = MemoryTasks[index].stack_words;
+	info->free_words = MemoryTasks[index].free_words;
+	info->exited = MemoryTasks[index].exited;
+	if (!info->exited) {
+		handle = MemoryTasks[index].idle ? xTaskGetIdleTaskHandle() : MemoryTasks[index].handle;
+		info->free_words = uxTaskGetStackHighWaterMark(handle);
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns the usage of a queue.
+//!
+//! \param index the queue (0 - MEMORY_QUEUE_COUNT - 1), in order of creation
+//! \param info returns the usage
+//!
+//! \return Returns false if there is no such queue
+//
+//*****************************************************************************
+bool MemoryQueueGet(uint32_t index, MemoryQueueInfo *info)
+{
+	if (index >= MemoryQueueTotal) {
+		return false;
+	}
+	info->name = MemoryQueues[index].name;
+	info->length = MemoryQueues[index].length;
+	info->item_size = MemoryQueues[index].item_size;
+	info->waiting = uxQueueMessagesWaiting(MemoryQueues[index].queue);
+	info->peak = MemoryQueues[index].peak;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns the bytes of heap taken by the stacks, task control blocks and
+//! queues created through this module, including the heap_2 block headers.
+//!
+//! \return Returns the number of bytes
+//
+//*****************************************************************************
+uint32_t MemoryHeapBytes(void)
+{
+	return MemoryBytes;
+}
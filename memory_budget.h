@@ -0,0 +1,113 @@
+/**\file memory_budget.h
+ * \brief <b>Task and Queue Creation with a RAM Budget Report</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef MEMORY_BUDGET_H_
+#define MEMORY_BUDGET_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+//*****************************************************************************
+//
+//! Stack sizes in words of every task. All tasks, queues and semaphores are
+//! taken from the FreeRTOS heap (heap_2) once during initialization and never
+//! deleted, apart from the boot task. Use "system show memory" to see how much
+//! of each stack has ever been used before changing a size.
+//
+//*****************************************************************************
+#define BOOT_TASK_STACK_SIZE			300
+#define LOGGERTASKSTACKSIZE				128
+#define INTERPRETERTASKSTACKSIZE		256
+#define I2CTASKSTACKSIZE				900
+#define PORT_MONITOR_STACK_SIZE			500
+#define IDLE_TASK_STACK_SIZE			configMINIMAL_STACK_SIZE
+
+//*****************************************************************************
+//
+//! Queue lengths. The console line and I2C frame queues carry indices into
+//! their buffer pools, their lengths follow CONSOLE_LINE_COUNT and
+//! I2C_FRAME_COUNT.
+//
+//*****************************************************************************
+#define CONSOLE_KEY_QUEUE_SIZE			8
+#define LED_QUEUE_SIZE					20
+
+//*****************************************************************************
+//
+//! Number of tasks (including the idle task) and queues reported by
+//! "system show memory". Also sizes the per-task tables of the performance
+//! counters and the SPI arbiter, so MemoryTaskCreate() refuses to create more
+//! tasks than fit. Two more than are created today of each.
+//
+//*****************************************************************************
+#define MEMORY_TASK_COUNT				8
+#define MEMORY_QUEUE_COUNT				6
+
+//*****************************************************************************
+//
+//! \brief Stack usage of one task, see MemoryTaskGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Name the task was created with
+	const char *name;
+	//! Size of the stack in words
+	uint32_t stack_words;
+	//! Smallest number of words that were ever left free on the stack
+	uint32_t free_words;
+	//! Has the task deleted itself?
+	bool exited;
+} MemoryTaskInfo;
+
+//*****************************************************************************
+//
+//! \brief Usage of one queue, see MemoryQueueGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Name the queue was created with
+	const char *name;
+	//! Number of items the queue can hold
+	uint32_t length;
+	//! Size of one item in bytes
+	uint32_t item_size;
+	//! Items waiting right now
+	uint32_t waiting;
+	//! Largest number of items that were ever waiting
+	uint32_t peak;
+} MemoryQueueInfo;
+
+extern TaskHandle_t MemoryTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_words, UBaseType_t priority);
+extern void MemoryIdleTaskAdd(void);
+extern void MemoryTaskExit(void);
+extern QueueHandle_t MemoryQueueCreate(const char *name, uint32_t length, uint32_t item_size);
+extern void MemoryQueueSent(void *queue);
+extern bool MemoryTaskGet(uint32_t index, MemoryTaskInfo *info);
+extern bool MemoryQueueGet(uint32_t index, MemoryQueueInfo *info);
+extern uint32_t MemoryHeapBytes(void);
+
+#endif /* MEMORY_BUDGET_H_ */
@@ -0,0 +1,356 @@
+/**\file mib_counters.c
+ * \brief <b>Per-Port MIB Counter Collector</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "eee_hal.h"
+#include "interpreter_task.h"
+#include "freertos_init.h"
+#include "mib_counters.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+//*****************************************************************************
+//
+//! Indirect addresses of the KSZ8895MLUB's MIB counters. Port n's counters
+//! start at n * MIB_PORT_STRIDE. The 16-bit dropped packet counters are at
+//! MIB_TX_DROP_BASE + n and MIB_RX_DROP_BASE + n.
+//
+//*****************************************************************************
+#define MIB_PORT_STRIDE				0x20
+#define MIB_TX_DROP_BASE			0x100
+#define MIB_RX_DROP_BASE			0x105
+#define MIB_COUNTER_MASK			0x3FFFFFFF
+#define MIB_DROP_COUNTER_MASK		0xFFFF
+
+//*****************************************************************************
+//
+//! \brief One counter read from the Ethernet Controller and the value it
+//! is added to.
+//
+//*****************************************************************************
+typedef struct {
+	//! Offset in a port's counters, or MIB_TX_DROP_BASE / MIB_RX_DROP_BASE
+	uint16_t address;
+	MIBMetric metric;
+} MIBSource;
+
+//*****************************************************************************
+//
+//! Counters read for each port.
+//
+//*****************************************************************************
+static const MIBSource MIBSources[] = {
+	{0x00, MIB_RX_BYTES},		//RxLoPriorityByte
+	{0x01, MIB_RX_BYTES},		//RxHiPriorityByte
+	{0x0B, MIB_RX_PACKETS},		//RxBroadcast
+	{0x0C, MIB_RX_PACKETS},		//RxMulticast
+	{0x0D, MIB_RX_PACKETS},		//RxUnicast
+	{0x14, MIB_TX_BYTES},		//TxLoPriorityByte
+	{0x15, MIB_TX_BYTES},		//TxHiPriorityByte
+	{0x18, MIB_TX_PACKETS},		//TxBroadcastPkts
+	{0x19, MIB_TX_PACKETS},		//TxMulticastPkts
+	{0x1A, MIB_TX_PACKETS},		//TxUnicastPkts
+	{0x07, MIB_CRC_ERRORS},		//RxCRCError
+	{0x02, MIB_RX_ERRORS},		//RxUndersizePkt
+	{0x03, MIB_RX_ERRORS},		//RxFragments
+	{0x04, MIB_RX_ERRORS},		//RxOversize
+	{0x05, MIB_RX_ERRORS},		//RxJabbers
+	{0x06, MIB_RX_ERRORS},		//RxSymbolError
+	{0x08, MIB_RX_ERRORS},		//RxAlignmentError
+	{0x1C, MIB_COLLISIONS},		//TxTotalCollision
+	{MIB_RX_DROP_BASE, MIB_RX_DROPS},
+	{MIB_TX_DROP_BASE, MIB_TX_DROPS}
+};
+#define MIB_SOURCE_COUNT			(sizeof(MIBSources) / sizeof(MIBSources[0]))
+
+//*****************************************************************************
+//
+//! Names of the values, indexed by MIBMetric.
+//
+//*****************************************************************************
+static const char *MIBMetricNames[MIB_METRIC_COUNT] = {
+	"rx bytes", "tx bytes", "rx packets", "tx packets", "rx drops", "tx drops", "crc errors", "rx errors", "collisions"
+};
+
+//*****************************************************************************
+//
+//! Last value read from each counter, and the values extended to 64 bits.
+//! A total always equals its counters modulo their width, so the next
+//! difference also covers any rollover.
+//
+//*****************************************************************************
+static uint32_t MIBRaw[MIB_PORT_COUNT][MIB_SOURCE_COUNT];
+static uint64_t MIBTotal[MIB_PORT_COUNT][MIB_METRIC_COUNT];
+
+//*****************************************************************************
+//
+//! Sliding window: the increase of each value during the last samples and
+//! how long each sample took. MIBWindowNext is the slot of the next sample,
+//! the extra slot lets it be filled while readers use the others.
+//
+//*****************************************************************************
+#define MIB_WINDOW_SLOTS			(MIB_WINDOW_SAMPLES + 1)
+static uint32_t MIBWindow[MIB_WINDOW_SLOTS][MIB_PORT_COUNT][MIB_METRIC_COUNT];
+static uint32_t MIBWindowTime[MIB_WINDOW_SLOTS];
+static uint32_t MIBWindowNext = 0;
+static uint32_t MIBSamples = 0;
+
+//*****************************************************************************
+//
+//! Tick counts of the last sample and of the next sample.
+//
+//*****************************************************************************
+static portTickType MIBSampleTime = 0;
+static portTickType MIBSampleDue = 0;
+
+//*****************************************************************************
+//
+//! Guards the counters. Held while a sample updates them and while readers
+//! copy them out, never while the Ethernet Controller is read.
+//
+//*****************************************************************************
+static xSemaphoreHandle MIBMutex = NULL;
+
+//*****************************************************************************
+//
+//! Takes the counter mutex once the scheduler is running.
+//!
+//! \return Returns true if the mutex was taken and must be given back
+//
+//*****************************************************************************
+static bool MIBLock(void)
+{
+	if (MIBMutex != NULL && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		return (xSemaphoreTake(MIBMutex, portMAX_DELAY) == pdTRUE);
+	}
+	return false;
+}
+
+//*****************************************************************************
+//
+//! Reads one MIB counter with a single control write and a single burst read
+//! of the data registers.
+//!
+//! \param address indirect address of the counter
+//! \param value returns the counter
+//!
+//! \return Returns false if the counter could not be read or never became
+//! valid
+//
+//*****************************************************************************
+static bool MIBReadCounter(uint32_t address, uint32_t *value)
+{
+	uint32_t control[2];
+	uint32_t data[4];
+	uint32_t retry;
+	bool result;
+
+	control[0] = (INDIRECT_TABLESELECT_MIB << INDIRECT_CONTROL_TABLESELECT) | (INDIRECT_READTYPE_READ << INDIRECT_CONTROL_READTYPEBIT) | (((address >> 8) & 0x03) << INDIRECT_CONTROL_ADDRESS_HIGH);
+	control[1] = (address & 0xFF);
+
+	EthoIndirectLock();
+	result = EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, 2, control);
+	if (result) {
+		result = EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_3, 4, data);
+		//Bit 6 of DATA_3 is set once the counter is valid
+		for (retry = 0; result && address < MIB_TX_DROP_BASE && !((data[0] >> 6) & 1) && retry < MIB_READ_RETRIES; retry++) {
+			result = EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_3, 4, data);
+		}
+	}
+	EthoIndirectUnlock();
+
+	if (!result) {
+		return false;
+	}
+	if (address >= MIB_TX_DROP_BASE) {
+		*value = ((data[2] & 0xFF) << 8) | (data[3] & 0xFF);
+		return true;
+	}
+	*value = ((data[0] & 0x3F) << 24) | ((data[1] & 0xFF) << 16) | ((data[2] & 0xFF) << 8) | (data[3] & 0xFF);
+	return ((data[0] >> 6) & 1);
+}
+
+//*****************************************************************************
+//
+//! Reads every counter of a port and adds the increase since the last sample
+//! to the totals and to the window slot of this sample. A counter that cannot
+//! be read keeps its last value, its increase is counted by the next sample.
+//!
+//! \param port the port (0 - 4)
+//! \param slot window slot of this sample
+//! \param first true for the first sample, which only sets the totals
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void MIBSamplePort(uint8_t port, uint32_t slot, bool first)
+{
+	uint32_t raw[MIB_SOURCE_COUNT];
+	bool valid[MIB_SOURCE_COUNT];
+	uint32_t source, address, delta;
+	bool locked;
+
+	for (source = 0; source < MIB_SOURCE_COUNT; source++) {
+		address = MIBSources[source].address;
+		address = (address >= MIB_TX_DROP_BASE) ? (address + port) : ((port * MIB_PORT_STRIDE) + address);
+		valid[source] = MIBReadCounter(address, &raw[source]);
+	}
+
+	locked = MIBLock();
+	if (!first) {
+		memset(MIBWindow[slot][port], 0, sizeof(MIBWindow[slot][port]));
+	}
+	for (source = 0; source < MIB_SOURCE_COUNT; source++) {
+		if (!valid[source]) {
+			continue;
+		}
+		if (first) {
+			MIBTotal[port][MIBSources[source].metric] += raw[source];
+		}
+		else {
+			delta = (raw[source] - MIBRaw[port][source]) & ((MIBSources[source].address >= MIB_TX_DROP_BASE) ? MIB_DROP_COUNTER_MASK : MIB_COUNTER_MASK);
+			MIBTotal[port][MIBSources[source].metric] += delta;
+			MIBWindow[slot][port][MIBSources[source].metric] += delta;
+		}
+		MIBRaw[port][source] = raw[source];
+	}
+	if (locked) {
+		xSemaphoreGive(MIBMutex);
+	}
+}
+
+//*****************************************************************************
+//
+//! Creates the counter mutex.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void MIBCountersInit(void)
+{
+	if (MIBMutex == NULL) {
+		MIBMutex = xSemaphoreCreateMutex();
+	}
+	MIBSampleDue = xTaskGetTickCount();
+}
+
+//*****************************************************************************
+//
+//! Reads the counters of every port if a sample is due.
+//!
+//! \return Returns the number of ticks until the next sample is due
+//
+//*****************************************************************************
+uint32_t MIBCountersService(void)
+{
+	portTickType now = xTaskGetTickCount();
+	uint8_t port;
+	bool first = (MIBSamples == 0);
+	bool locked;
+
+	if ((portTickType)(now - MIBSampleDue) < (portMAX_DELAY / 2)) {
+		for (port = 0; port < MIB_PORT_COUNT; port++) {
+			MIBSamplePort(port, MIBWindowNext, first);
+		}
+		//Publish the sample to readers
+		locked = MIBLock();
+		MIBWindowTime[MIBWindowNext] = (now - MIBSampleTime) * portTICK_RATE_MS;
+		if (!first) {
+			MIBWindowNext = (MIBWindowNext + 1) % MIB_WINDOW_SLOTS;
+		}
+		MIBSamples++;
+		if (locked) {
+			xSemaphoreGive(MIBMutex);
+		}
+		MIBSampleTime = now;
+		now = xTaskGetTickCount();
+		MIBSampleDue = MIBSampleTime + (MIB_SAMPLE_MS / portTICK_RATE_MS);
+	}
+	return (MIBSampleDue - now);
+}
+
+//*****************************************************************************
+//
+//! Copies the counters and rates of a port.
+//!
+//! \param port the port (0 - 4)
+//! \param stats returns the counters and rates
+//!
+//! \return Returns false if the port is invalid or no sample was taken yet
+//
+//*****************************************************************************
+bool MIBCountersGet(uint8_t port, MIBPortStats *stats)
+{
+	uint32_t metric, sample, slot, samples, time;
+	uint64_t sum;
+	bool locked;
+
+	if (port >= MIB_PORT_COUNT || MIBSamples == 0) {
+		return false;
+	}
+	locked = MIBLock();
+	samples = ((MIBSamples - 1) < MIB_WINDOW_SAMPLES) ? (MIBSamples - 1) : MIB_WINDOW_SAMPLES;
+	for (metric = 0; metric < MIB_METRIC_COUNT; metric++) {
+		stats->total[metric] = MIBTotal[port][metric];
+		stats->rate[metric] = 0;
+		stats->average[metric] = 0;
+		sum = 0;
+		time = 0;
+		//Walk back from the newest sample
+		for (sample = 0; sample < samples; sample++) {
+			slot = (MIBWindowNext + MIB_WINDOW_SLOTS - 1 - sample) % MIB_WINDOW_SLOTS;
+			if (sample == 0 && MIBWindowTime[slot] != 0) {
+				stats->rate[metric] = (uint32_t)(((uint64_t)MIBWindow[slot][port][metric] * 1000) / MIBWindowTime[slot]);
+			}
+			sum += MIBWindow[slot][port][metric];
+			time += MIBWindowTime[slot];
+		}
+		if (time != 0) {
+			stats->average[metric] = (uint32_t)((sum * 1000) / time);
+		}
+	}
+	if (locked) {
+		xSemaphoreGive(MIBMutex);
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns the name of a value.
+//!
+//! \param metric the value
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *MIBMetricName(MIBMetric metric)
+{
+	return ((metric < MIB_METRIC_COUNT) ? MIBMetricNames[metric] : "unknown");
+}
@@ -0,0 +1,142 @@
+/**\file mib_counters.h
+ * \brief <b>Per-Port MIB Counter Collector</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef MIB_COUNTERS_H_
+#define MIB_COUNTERS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+//! Number of KSZ8895MLUB ports with MIB counters. Ports are numbered as on
+//! the KSZ8895MLUB: 0 = port 1 (f3) through 4 = port 5 (exp-port).
+//
+//*****************************************************************************
+#define MIB_PORT_COUNT				5
+
+//*****************************************************************************
+//
+//! Interval in milliseconds between two reads of the counters, and the
+//! number of samples averaged by the sliding window. The 30-bit byte counters
+//! wrap after about 85 seconds at 100 Mbps, so the interval must stay well
+//! below that.
+//
+//*****************************************************************************
+#define MIB_SAMPLE_MS				1000
+#define MIB_WINDOW_SAMPLES			5
+
+//*****************************************************************************
+//
+//! Number of times a counter is read again while the Ethernet Controller
+//! reports it as not valid before it is skipped for this sample.
+//
+//*****************************************************************************
+#define MIB_READ_RETRIES			4
+
+//*****************************************************************************
+//
+//! \brief Values collected for each port. Each combines one or more of the
+//! KSZ8895MLUB's counters.
+//
+//*****************************************************************************
+typedef enum {
+	//! Bytes received, both priorities
+	MIB_RX_BYTES,
+	//! Bytes transmitted, both priorities
+	MIB_TX_BYTES,
+	//! Unicast, multicast and broadcast packets received
+	MIB_RX_PACKETS,
+	//! Unicast, multicast and broadcast packets transmitted
+	MIB_TX_PACKETS,
+	//! Packets dropped on reception
+	MIB_RX_DROPS,
+	//! Packets dropped on transmission
+	MIB_TX_DROPS,
+	//! Packets received with a CRC error
+	MIB_CRC_ERRORS,
+	//! Undersize, fragment, oversize, jabber, symbol and alignment errors
+	MIB_RX_ERRORS,
+	//! Transmit collisions
+	MIB_COLLISIONS,
+	MIB_METRIC_COUNT
+} MIBMetric;
+
+//*****************************************************************************
+//
+//! \brief Counters and rates of one port, see MIBCountersGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Values since the Ethernet Controller was reset, extended to 64 bits
+	uint64_t total[MIB_METRIC_COUNT];
+	//! Values per second over the last sample
+	uint32_t rate[MIB_METRIC_COUNT];
+	//! Values per second over the last MIB_WINDOW_SAMPLES samples
+	uint32_t average[MIB_METRIC_COUNT];
+} MIBPortStats;
+
+//*****************************************************************************
+//
+//! Creates the mutex guarding the counters. The first sample is taken by the
+//! first call to MIBCountersService(). Must be called before the scheduler is
+//! started.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void MIBCountersInit(void);
+//*****************************************************************************
+//
+//! Reads the counters of every port if a sample is due. Called by the port
+//! monitor task.
+//!
+//! \return Returns the number of ticks until the next sample is due
+//
+//*****************************************************************************
+extern uint32_t MIBCountersService(void);
+//*****************************************************************************
+//
+//! Copies the counters and rates of a port. Does not access the Ethernet
+//! Controller.
+//!
+//! \param port the port (0 - 4)
+//! \param stats returns the counters and rates
+//!
+//! \return Returns false if the port is invalid or no sample was taken yet
+//
+//*****************************************************************************
+extern bool MIBCountersGet(uint8_t port, MIBPortStats *stats);
+//*****************************************************************************
+//
+//! Returns the name of a value as shown by "port fX stats".
+//!
+//! \param metric the value
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+extern const char *MIBMetricName(MIBMetric metric);
+
+#endif /* MIB_COUNTERS_H_ */
@@ -0,0 +1,444 @@
+/**\file perf_stats.c
+ * \brief <b>Cycle-Counter Latency Histograms and Task Run-Time Statistics</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "inc/hw_nvic.h"
+#include "sysctl.h"
+#include "memory_budget.h"
+#include "perf_stats.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if ENABLE_PERF_STATS
+
+//*****************************************************************************
+//
+//! Cortex-M4 debug registers that enable and hold the free running cycle
+//! counter (DEMCR, DWT_CTRL and DWT_CYCCNT).
+//
+//*****************************************************************************
+#define PERF_DEMCR					0xE000EDFC
+#define PERF_DEMCR_TRCENA			0x01000000
+#define PERF_DWT_CTRL				0xE0001000
+#define PERF_DWT_CTRL_CYCCNTENA		0x00000001
+#define PERF_DWT_CYCCNT				0xE0001004
+
+static const char *PerfOpNames[PERF_OP_COUNT] = {
+	"eeprom-read",
+	"eeprom-write",
+	"eeprom-bulk-write",
+	"eeprom-erase",
+	"etho-read",
+	"etho-bulk-read",
+	"etho-write",
+	"etho-bulk-write",
+	"cli-command"
+};
+
+static PerfOpStats PerfOps[PERF_OP_COUNT];
+static PerfBusStats PerfBus;
+
+//*****************************************************************************
+//
+//! The last PERF_HISTORY_COUNT spans, PerfHistoryNext is the slot written
+//! next.
+//
+//*****************************************************************************
+static PerfSpan PerfHistory[PERF_HISTORY_COUNT];
+static uint32_t PerfHistoryNext = 0;
+static uint32_t PerfHistoryCount = 0;
+
+//*****************************************************************************
+//
+//! Cycles in one microsecond, zero until PerfInit() is called.
+//
+//*****************************************************************************
+static uint32_t PerfUsCycles = 0;
+
+//*****************************************************************************
+//
+//! Task run-time counters recorded by PerfReset(), and the states read by
+//! PerfTaskShares(). Kept here rather than on the caller's stack.
+//
+//*****************************************************************************
+static TaskHandle_t PerfRunHandles[MEMORY_TASK_COUNT];
+static uint32_t PerfRunBase[MEMORY_TASK_COUNT];
+static uint32_t PerfRunTotalBase = 0;
+static TaskStatus_t PerfTaskStates[MEMORY_TASK_COUNT];
+
+//*****************************************************************************
+//
+//! Starts the cycle counter. Called from main() once the system clock is set
+//! and again by the kernel through portCONFIGURE_TIMER_FOR_RUN_TIME_STATS(),
+//! the counter is only started once.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void PerfInit(void)
+{
+	if (PerfUsCycles != 0) {
+		return;
+	}
+	HWREG(PERF_DEMCR) |= PERF_DEMCR_TRCENA;
+	HWREG(PERF_DWT_CYCCNT) = 0;
+	HWREG(PERF_DWT_CTRL) |= PERF_DWT_CTRL_CYCCNTENA;
+	PerfUsCycles = SysCtlClockGet() / 1000000;
+}
+
+//*****************************************************************************
+//
+//! Returns the cycle counter, which wraps after 2^32 cycles (~85s).
+//!
+//! \return Returns the number of cycles since PerfInit()
+//
+//*****************************************************************************
+uint32_t PerfCycles(void)
+{
+	return HWREG(PERF_DWT_CYCCNT);
+}
+
+//*****************************************************************************
+//
+//! Returns the counter used by configGENERATE_RUN_TIME_STATS.
+//!
+//! \return Returns the cycle counter divided by 2^PERF_RUNTIME_SHIFT
+//
+//*****************************************************************************
+uint32_t PerfRunTimeCounter(void)
+{
+	return (HWREG(PERF_DWT_CYCCNT) >> PERF_RUNTIME_SHIFT);
+}
+
+//*****************************************************************************
+//
+//! Returns the caller slot of the running code.
+//!
+//! \return Returns the task number set by MemoryTaskCreate(), or 0 before the
+//! scheduler starts and in interrupts
+//
+//*****************************************************************************
+static uint32_t PerfCaller(void)
+{
+	uint32_t caller;
+
+	if ((HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M) != 0 || xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+		return 0;
+	}
+	caller = uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+	return ((caller < PERF_CALLER_COUNT) ? caller : 0);
+}
+
+//*****************************************************************************
+//
+//! Adds one run of an operation, see PERF_END(). May be called from tasks and
+//! interrupts.
+//!
+//! \param op the operation
+//! \param start the cycle counter when the operation started
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void PerfRecord(PerfOp op, uint32_t start)
+{
+	uint32_t cycles = HWREG(PERF_DWT_CYCCNT) - start;
+	uint32_t us, bucket = 0, caller;
+	UBaseType_t mask;
+
+	if (op >= PERF_OP_COUNT || PerfUsCycles == 0) {
+		return;
+	}
+	for (us = cycles / PerfUsCycles; us != 0 && bucket < (PERF_HISTOGRAM_BUCKETS - 1); us >>= 1) {
+		bucket++;
+	}
+	caller = PerfCaller();
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	PerfOps[op].count++;
+	PerfOps[op].total_cycles += cycles;
+	if (cycles > PerfOps[op].max_cycles) {
+		PerfOps[op].max_cycles = cycles;
+	}
+	PerfOps[op].histogram[bucket]++;
+	PerfOps[op].callers[caller]++;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+//*****************************************************************************
+//
+//! Counts one SSITransfer(), see PERF_BUS(). May be called from tasks and
+//! interrupts.
+//!
+//! \param ssi_base the base address of the SSI port
+//! \param length number of bytes clocked
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void PerfBusRecord(uint32_t ssi_base, uint32_t length)
+{
+	uint32_t bus = (ssi_base == SSI0_BASE) ? 0 : 1;
+	UBaseType_t mask;
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	PerfBus.transactions[bus]++;
+	PerfBus.bytes[bus] += length;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+//*****************************************************************************
+//
+//! Copies the bus traffic since PerfInit(). The counters wrap after 2^32.
+//!
+//! \param stats returns the traffic
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void PerfBusGet(PerfBusStats *stats)
+{
+	UBaseType_t mask;
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	*stats = PerfBus;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+//*****************************************************************************
+//
+//! Starts measuring the time and bus traffic of a command. Traffic caused by
+//! other tasks meanwhile is counted too.
+//!
+//! \param span receives the starting point
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void PerfSpanBegin(PerfSpan *span)
+{
+	PerfBusGet(&span->bus);
+	span->time = HWREG(PERF_DWT_CYCCNT);
+}
+
+//*****************************************************************************
+//
+//! Ends a span started by PerfSpanBegin() and adds it to the history shown by
+//! "system show perf".
+//!
+//! \param span the span
+//! \param words words joined with spaces to label the span
+//! \param count number of words
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void PerfSpanEnd(PerfSpan *span, const char *const *words, uint32_t count)
+{
+	PerfBusStats now;
+	uint32_t cycles = HWREG(PERF_DWT_CYCCNT) - span->time;
+	uint32_t bus, word, pos = 0;
+	const char *text;
+
+	PerfBusGet(&now);
+	for (bus = 0; bus < PERF_BUS_COUNT; bus++) {
+		span->bus.transactions[bus] = now.transactions[bus] - span->bus.transactions[bus];
+		span->bus.bytes[bus] = now.bytes[bus] - span->bus.bytes[bus];
+	}
+	span->time = (PerfUsCycles != 0) ? (cycles / PerfUsCycles) : 0;
+	for (word = 0; word < count && words[word] != NULL; word++) {
+		if (word != 0 && pos < (PERF_LABEL_SIZE - 1)) {
+			span->label[pos++] = ' ';
+		}
+		for (text = words[word]; *text != '\0' && pos < (PERF_LABEL_SIZE - 1); text++) {
+			span->label[pos++] = *text;
+		}
+	}
+	span->label[pos] = '\0';
+
+	taskENTER_CRITICAL();
+	PerfHistory[PerfHistoryNext] = *span;
+	PerfHistoryNext = (PerfHistoryNext + 1) % PERF_HISTORY_COUNT;
+	if (PerfHistoryCount < PERF_HISTORY_COUNT) {
+		PerfHistoryCount++;
+	}
+	taskEXIT_CRITICAL();
+}
+
+//*****************************************************************************
+//
+//! Copies a span from the history.
+//!
+//! \param index the span, 0 is the most recent
+//! \param span returns the span
+//!
+//! \return Returns false if there is no such span
+//
+//*****************************************************************************
+bool PerfHistoryGet(uint32_t index, PerfSpan *span)
+{
+	bool found;
+
+	taskENTER_CRITICAL();
+	found = (index < PerfHistoryCount);
+	if (found) {
+		*span = PerfHistory[(PerfHistoryNext + PERF_HISTORY_COUNT - 1 - index) % PERF_HISTORY_COUNT];
+	}
+	taskEXIT_CRITICAL();
+	return found;
+}
+
+//*****************************************************************************
+//
+//! Clears every operation counter and starts measuring the CPU share of each
+//! task again.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void PerfReset(void)
+{
+	UBaseType_t mask, count, i;
+	uint32_t total = 0;
+
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	memset(PerfOps, 0x00, sizeof(PerfOps));
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+	memset(PerfRunHandles, 0x00, sizeof(PerfRunHandles));
+	count = uxTaskGetSystemState(PerfTaskStates, MEMORY_TASK_COUNT, &total);
+	for (i = 0; i < count; i++) {
+		PerfRunHandles[i] = PerfTaskStates[i].xHandle;
+		PerfRunBase[i] = PerfTaskStates[i].ulRunTimeCounter;
+	}
+	PerfRunTotalBase = total;
+}
+
+//*****************************************************************************
+//
+//! Copies the counters of an operation.
+//!
+//! \param op the operation
+//! \param stats returns the counters
+//!
+//! \return Returns false if the operation is invalid
+//
+//*****************************************************************************
+bool PerfOpGet(PerfOp op, PerfOpStats *stats)
+{
+	UBaseType_t mask;
+
+	if (op >= PERF_OP_COUNT) {
+		return false;
+	}
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	*stats = PerfOps[op];
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of cycles in one microsecond.
+//!
+//! \return Returns the number of cycles, zero before PerfInit()
+//
+//*****************************************************************************
+uint32_t PerfCyclesPerUs(void)
+{
+	return PerfUsCycles;
+}
+
+//*****************************************************************************
+//
+//! Reads the CPU time every task used since the last PerfReset() (or since the
+//! scheduler started). The times wrap after 2^32 run-time counts, so reset at
+//! least every few hours.
+//!
+//! \param shares returns one entry per task
+//! \param max number of entries shares can hold
+//!
+//! \return Returns the number of entries filled in
+//
+//*****************************************************************************
+uint32_t PerfTaskShares(PerfTaskShare *shares, uint32_t max)
+{
+	UBaseType_t count, i, base;
+	uint32_t total = 0, time;
+
+	count = uxTaskGetSystemState(PerfTaskStates, MEMORY_TASK_COUNT, &total);
+	total -= PerfRunTotalBase;
+	for (i = 0; i < count && i < max; i++) {
+		time = PerfTaskStates[i].ulRunTimeCounter;
+		for (base = 0; base < MEMORY_TASK_COUNT; base++) {
+			if (PerfRunHandles[base] == PerfTaskStates[i].xHandle) {
+				time -= PerfRunBase[base];
+				break;
+			}
+		}
+		shares[i].name = PerfTaskStates[i].pcTaskName;
+		shares[i].time_ms = (PerfUsCycles != 0) ? (uint32_t)(((uint64_t)time << PERF_RUNTIME_SHIFT) / (PerfUsCycles * 1000)) : 0;
+		shares[i].permille = (total != 0) ? (uint32_t)(((uint64_t)time * 1000) / total) : 0;
+	}
+	return i;
+}
+
+//*****************************************************************************
+//
+//! Returns the name of an operation.
+//!
+//! \param op the operation
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *PerfOpName(PerfOp op)
+{
+	return ((op < PERF_OP_COUNT) ? PerfOpNames[op] : "unknown");
+}
+
+//*****************************************************************************
+//
+//! Returns the name of a caller slot.
+//!
+//! \param caller the slot (0 - PERF_CALLER_COUNT - 1)
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *PerfCallerName(uint32_t caller)
+{
+	MemoryTaskInfo task;
+
+	if (caller == 0) {
+		return "boot/isr";
+	}
+	return (MemoryTaskGet(caller - 1, &task) ? task.name : "unknown");
+}
+
+#endif
@@ -0,0 +1,198 @@
+/**\file perf_stats.h
+ * \brief <b>Cycle-Counter Latency Histograms and Task Run-Time Statistics</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef PERF_STATS_H_
+#define PERF_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "memory_budget.h"
+
+//*****************************************************************************
+//
+//! Set to false to compile every performance counter out. Follows
+//! configGENERATE_RUN_TIME_STATS in FreeRTOSConfig.h unless defined by the
+//! build.
+//
+//*****************************************************************************
+#ifndef ENABLE_PERF_STATS
+#define ENABLE_PERF_STATS			configGENERATE_RUN_TIME_STATS
+#endif
+
+//*****************************************************************************
+//
+//! Number of log2 latency buckets. Bucket 0 counts operations shorter than
+//! 1 us, bucket n those of 2^(n-1) us or longer, the last bucket everything
+//! from 2^(PERF_HISTOGRAM_BUCKETS - 2) us (16 ms) up.
+//
+//*****************************************************************************
+#define PERF_HISTOGRAM_BUCKETS		16
+
+//*****************************************************************************
+//
+//! Callers are told apart by the task number set by MemoryTaskCreate(). Slot 0
+//! counts calls made before the scheduler started or from interrupts.
+//
+//*****************************************************************************
+#define PERF_CALLER_COUNT			(MEMORY_TASK_COUNT + 1)
+
+//*****************************************************************************
+//
+//! The run-time counter used by configGENERATE_RUN_TIME_STATS is the cycle
+//! counter divided by 2^PERF_RUNTIME_SHIFT (3.2 us at 80 MHz), so the task
+//! times wrap after about four hours instead of 54 seconds.
+//
+//*****************************************************************************
+#define PERF_RUNTIME_SHIFT			8
+
+//*****************************************************************************
+//
+//! Number of SSI buses counted (SSI0 to the EEPROM, SSI1 to the Ethernet
+//! Controller), and number of recent commands whose bus cost is kept.
+//
+//*****************************************************************************
+#define PERF_BUS_COUNT				2
+#define PERF_HISTORY_COUNT			4
+#define PERF_LABEL_SIZE				24
+
+//*****************************************************************************
+//
+//! \brief Operations that are timed. EEPROMSingleRead() and EEPROMBulkRead()
+//! are counted as the EEPROMSequentialRead() they call, EEPROMSingleWrite() as
+//! an EEPROMPageWrite(). Reads served from the register shadow and writes
+//! staged by a batch are counted too and fill the lowest buckets.
+//
+//*****************************************************************************
+typedef enum {
+	PerfEEPROMRead,
+	PerfEEPROMWrite,
+	PerfEEPROMBulkWrite,
+	PerfEEPROMErase,
+	PerfEthoRead,
+	PerfEthoBulkRead,
+	PerfEthoWrite,
+	PerfEthoBulkWrite,
+	PerfCommand,
+	PERF_OP_COUNT
+} PerfOp;
+
+//*****************************************************************************
+//
+//! \brief Counters of one operation, see PerfOpGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Number of times the operation ran
+	uint32_t count;
+	//! Longest run in cycles
+	uint32_t max_cycles;
+	//! Sum of all runs in cycles
+	uint64_t total_cycles;
+	//! Runs per log2 latency bucket
+	uint32_t histogram[PERF_HISTOGRAM_BUCKETS];
+	//! Runs per caller
+	uint32_t callers[PERF_CALLER_COUNT];
+} PerfOpStats;
+
+//*****************************************************************************
+//
+//! \brief Traffic on the SSI buses, one entry per bus (0 = EEPROM,
+//! 1 = Ethernet Controller).
+//
+//*****************************************************************************
+typedef struct {
+	//! Number of SSITransfer() calls
+	uint32_t transactions[PERF_BUS_COUNT];
+	//! Bytes clocked by those calls
+	uint32_t bytes[PERF_BUS_COUNT];
+} PerfBusStats;
+
+//*****************************************************************************
+//
+//! \brief Time and bus traffic of one command or of booting, see PerfSpanEnd().
+//
+//*****************************************************************************
+typedef struct {
+	//! The command words, or "boot"
+	char label[PERF_LABEL_SIZE];
+	//! Cycle counter when the span started, then its length in microseconds
+	uint32_t time;
+	//! Bus traffic when the span started, then the traffic it caused
+	PerfBusStats bus;
+} PerfSpan;
+
+//*****************************************************************************
+//
+//! \brief CPU time of one task since the last PerfReset(), see PerfTaskShares().
+//
+//*****************************************************************************
+typedef struct {
+	//! Name of the task
+	const char *name;
+	//! CPU time in milliseconds
+	uint32_t time_ms;
+	//! Share of the CPU in tenths of a percent
+	uint32_t permille;
+} PerfTaskShare;
+
+//*****************************************************************************
+//
+//! PERF_BEGIN() starts timing in the function it is placed in, after the
+//! declarations. PERF_END() must then precede every return of the function.
+//
+//*****************************************************************************
+#if ENABLE_PERF_STATS
+#define PERF_BEGIN()				uint32_t perf_start = PerfCycles()
+#define PERF_END(op)				PerfRecord((op), perf_start)
+#define PERF_BUS(ssi_base, length)	PerfBusRecord((ssi_base), (length))
+#define PERF_SPAN_BEGIN()			PerfSpan perf_span; PerfSpanBegin(&perf_span)
+#define PERF_SPAN_END(words, count)	PerfSpanEnd(&perf_span, (const char *const *)(words), (count))
+#else
+#define PERF_BEGIN()
+#define PERF_END(op)
+#define PERF_BUS(ssi_base, length)
+#define PERF_SPAN_BEGIN()
+#define PERF_SPAN_END(words, count)
+#endif
+
+#if ENABLE_PERF_STATS
+extern void PerfInit(void);
+extern uint32_t PerfCycles(void);
+extern uint32_t PerfRunTimeCounter(void);
+extern void PerfRecord(PerfOp op, uint32_t start);
+extern void PerfBusRecord(uint32_t ssi_base, uint32_t length);
+extern void PerfBusGet(PerfBusStats *stats);
+extern void PerfSpanBegin(PerfSpan *span);
+extern void PerfSpanEnd(PerfSpan *span, const char *const *words, uint32_t count);
+extern bool PerfHistoryGet(uint32_t index, PerfSpan *span);
+extern void PerfReset(void);
+extern bool PerfOpGet(PerfOp op, PerfOpStats *stats);
+extern uint32_t PerfCyclesPerUs(void);
+extern uint32_t PerfTaskShares(PerfTaskShare *shares, uint32_t max);
+extern const char *PerfOpName(PerfOp op);
+extern const char *PerfCallerName(uint32_t caller);
+#endif
+
+#endif /* PERF_STATS_H_ */
@@ -26,15 +26,23 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
 #include "sysctl.h"
 #include "inc/hw_types.h"
 #include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/rom.h"
-#include "utils/uartstdio.h"
+#include "console.h"
 #include "port_monitor_task.h"
 #include "freertos_init.h"
 #include "interpreter_task.h"
+#include "event_logger.h"
+#include "mac_table.h"
+#include "mib_counters.h"
+#include "cable_diag.h"
+#include "spi_arbiter.h"
 #include "priorities.h"
+#include "memory_budget.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -48,220 +56,303 @@
 //*****************************************************************************
 extern xSemaphoreHandle g_pUARTSemaphore;
 
-
 //*****************************************************************************
 //
-//! PORT MONITOR TASK
-//! This task periodically scans the interrupt status register in the KSZ8895MLUB
-//! (register 0x7C) for active high bits. When one is found, the corresponding
-//! port will have it's MAC address learning turned off temporarily so that
-//! a flush of all dynamic MACs addresses learned can be performed. Once complete
-//! the interrupt bit is cleared and the user is informed that the port has
-//! been (connected/disconnected).
-//!
-//! This task will only scan the connected ports after a user has successfully
-//! logged into the system.
+//! Handle of the port monitor task, notified by PortMonitorIntHandler().
 //
 //*****************************************************************************
-static void PortMonitorTask(void *pvParameters)
-{
-    while(1)
-    {
-		uint32_t taskDelay = LONG_RUNNING_TASK_DLY;
-		uint32_t currentTime = xTaskGetTickCount();
+static xTaskHandle PortMonitorTaskHandle = NULL;
 
-		if (Authenticated) {
-			//Check all port interrupt flags
-			uint32_t flags = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER);
-			uint8_t eth0_reg_settings = 0x00;
-			if (flags & 0x10) { // PORT 5
-				//Clear port interrupt flag
-				flags = 0x10;
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER, flags);
-
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x5E);
-				if ((eth0_reg_settings >> 5) & 1) {
-					UARTprintf("\n[SYSTEM]: Expansion port connected!\n");
-				}
-				else {
-					UARTprintf("\n[SYSTEM]: Expansion port disconnected!\n");
-				}
-
-				//Disable port learning for port 5
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x52);
-				eth0_reg_settings |= (1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x52, eth0_reg_settings);
+//*****************************************************************************
+//
+//! Describes a single KSZ8895MLUB port whose link state is monitored.
+//
+//*****************************************************************************
+typedef struct {
+	//! Base register address of the port (0x10 - 0x50)
+	uint8_t port_base;
+	//! Bit in INTERRUPT_STATUS_REGISTER assigned to this port
+	uint8_t int_flag;
+	//! Name shown to the user on a link change
+	char *name;
+} MonitoredPort;
 
-				//Flush Dyn MAC Table for this port
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX);
-				eth0_reg_settings |= (1 << 5);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX, eth0_reg_settings);
+//*****************************************************************************
+//
+//! Ports handled on a link change interrupt. Physical ports are inverted
+//! logically (see POFFSET_LOGICAL in interpreter_task.h).
+//
+//*****************************************************************************
+static const MonitoredPort MonitoredPorts[PORT_MONITOR_PORT_COUNT] = {
+		{ETHO_PORT5_HARDWARE_HEX, 0x10, "Expansion port"},
+		{ETHO_PORT4_HARDWARE_HEX, 0x08, "Port 0"},
+		{ETHO_PORT3_HARDWARE_HEX, 0x04, "Port 1"},
+		{ETHO_PORT2_HARDWARE_HEX, 0x02, "Port 2"},
+		{ETHO_PORT1_HARDWARE_HEX, 0x01, "Port 3"}
+};
 
-				while ((EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX) >> 5) 	& 	1) {
-					uint32_t currentTime = xTaskGetTickCount();
-					vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
-				}
+//*****************************************************************************
+//
+//! Debounce state of each monitored port, in the same order as MonitoredPorts.
+//! A port is pending from its first link change interrupt until its link has
+//! been quiet for PORT_LINK_DEBOUNCE_MS.
+//
+//*****************************************************************************
+static bool PortPending[PORT_MONITOR_PORT_COUNT];
+static portTickType PortSettleTime[PORT_MONITOR_PORT_COUNT];
 
-				//Enable port learning for port 5
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x52);
-				eth0_reg_settings &= ~(1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x52, eth0_reg_settings);
+//*****************************************************************************
+//
+//! Removes the dynamic MAC table entries learned on the given ports. The
+//! KSZ8895MLUB only flushes entries of ports that have learning disabled, so
+//! with PORT_FLUSH_PER_PORT enabled learning is turned off on the selected
+//! ports alone and every other port keeps its addresses. Otherwise learning
+//! is turned off on all ports and the whole table is flushed. Learning is
+//! restored to its previous setting afterwards. The wait for the flush to
+//! finish sleeps between checks and gives up after
+//! PORT_MONITOR_FLUSH_TIMEOUT_MS.
+//!
+//! \param port_mask Bit i selects MonitoredPorts[i]
+//!
+//! \return Returns true if the flush completed, otherwise false.
+//
+//*****************************************************************************
+static bool PortFlushDynamicMACs(uint32_t port_mask)
+{
+	uint8_t port_control2[PORT_MONITOR_PORT_COUNT];
+	uint8_t eth0_reg_settings;
+	uint32_t waited = 0;
+	uint32_t i;
+	bool result = true;
+
+	if (!PORT_FLUSH_PER_PORT) {
+		port_mask = (1 << PORT_MONITOR_PORT_COUNT) - 1;
+	}
+
+	//Disable port learning
+	for (i = 0; i < PORT_MONITOR_PORT_COUNT; i++) {
+		if (port_mask & (1 << i)) {
+			port_control2[i] = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, MonitoredPorts[i].port_base + PORT_CONTROL2_OFFSET_HEX);
+			EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, MonitoredPorts[i].port_base + PORT_CONTROL2_OFFSET_HEX, port_control2[i] | (1 << 0));
+		}
+	}
+
+	//Flush Dyn MAC Table
+	eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX);
+	eth0_reg_settings |= (1 << 5);
+	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX, eth0_reg_settings);
+
+	while ((EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX) >> 5) 	& 	1) {
+		if (waited >= PORT_MONITOR_FLUSH_TIMEOUT_MS) {
+			LogItemEEPROM(EthoControlIOException);
+			result = false;
+			break;
+		}
+		delayMs(PORT_MONITOR_FLUSH_POLL_MS);
+		waited += PORT_MONITOR_FLUSH_POLL_MS;
+	}
+
+	//Restore port learning
+	for (i = 0; i < PORT_MONITOR_PORT_COUNT; i++) {
+		if (port_mask & (1 << i)) {
+			EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, MonitoredPorts[i].port_base + PORT_CONTROL2_OFFSET_HEX, port_control2[i]);
+		}
+	}
+	return result;
+}
 
+//*****************************************************************************
+//
+//! Handles the ports whose link has settled. Their learned MAC addresses are
+//! flushed with a single flush operation and the user is informed that each
+//! port has been (connected/disconnected) if logged in.
+//!
+//! \param port_mask Bit i selects MonitoredPorts[i]
+//
+//*****************************************************************************
+static void PortLinksSettled(uint32_t port_mask)
+{
+	uint8_t eth0_reg_settings;
+	uint32_t snapshot_mask = 0;
+	uint32_t i;
+
+	PortFlushDynamicMACs(port_mask);
+	//Drop the flushed addresses from the MAC table snapshot (port bases 0x10 - 0x50 = ports 0 - 4)
+	for (i = 0; i < PORT_MONITOR_PORT_COUNT; i++) {
+		if (port_mask & (1 << i)) {
+			snapshot_mask |= (1 << ((MonitoredPorts[i].port_base >> 4) - 1));
+		}
+	}
+	MACTablePortsChanged(snapshot_mask);
+
+	if (!Authenticated) {
+		return;
+	}
+	for (i = 0; i < PORT_MONITOR_PORT_COUNT; i++) {
+		if (port_mask & (1 << i)) {
+			eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, MonitoredPorts[i].port_base + PORT_STATUS1_OFFSET_HEX);
+			if ((eth0_reg_settings >> 5) & 1) {
+				ConsolePrintf("\n[SYSTEM]: %s connected!\n", MonitoredPorts[i].name);
 			}
-			if (flags & 0x08) { // PORT 4
-				//Clear port interrupt flag
-				flags = 0x08;
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER, flags);
-
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x4E);
-				if ((eth0_reg_settings >> 5) & 1) {
-					UARTprintf("\n[SYSTEM]: Port 0 connected!\n");
-				}
-				else {
-					UARTprintf("\n[SYSTEM]: Port 0 disconnected!\n");
-				}
-
-				//Disable port learning for port 4
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x42);
-				eth0_reg_settings |= (1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x42, eth0_reg_settings);
-
-				//Flush Dyn MAC Table for this port
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX);
-				eth0_reg_settings |= (1 << 5);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX, eth0_reg_settings);
-
-				while ((EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX) >> 5) 	& 	1) {
-					uint32_t currentTime = xTaskGetTickCount();
-					vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
-				}
-
-				//Enable port learning for port 4
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x42);
-				eth0_reg_settings &= ~(1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x42, eth0_reg_settings);
-
+			else {
+				ConsolePrintf("\n[SYSTEM]: %s disconnected!\n", MonitoredPorts[i].name);
 			}
-			if (flags & 0x04) { // PORT 3
-				//Clear port interrupt flag
-				flags = 0x04;
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER, flags);
-
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x3E);
-				if ((eth0_reg_settings >> 5) & 1) {
-					UARTprintf("\n[SYSTEM]: Port 1 connected!\n");
-				}
-				else {
-					UARTprintf("\n[SYSTEM]: Port 1 disconnected!\n");
-				}
-
-				//Disable port learning for port 3
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x32);
-				eth0_reg_settings |= (1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x32, eth0_reg_settings);
+		}
+	}
+}
 
-				//Flush Dyn MAC Table for this port
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX);
-				eth0_reg_settings |= (1 << 5);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX, eth0_reg_settings);
+//*****************************************************************************
+//
+//! PORT MONITOR TASK
+//! This task sleeps until the KSZ8895MLUB drives its interrupt line low, then
+//! reads the interrupt status register (register 0x7C) for active high bits.
+//! Each bit found is cleared and (re)starts the debounce period of its port.
+//! Once a port's link has been quiet for PORT_LINK_DEBOUNCE_MS the MAC
+//! addresses learned on it are flushed and the user is informed that the port
+//! has been (connected/disconnected). A flapping link therefore costs one
+//! flush once it settles instead of one per transition.
+//!
+//! The interrupt line stays low while any status bit is set, so the register
+//! is read again after every pass and the task only goes back to sleep once
+//! it reads zero. Otherwise a change arriving mid-pass would never produce
+//! another falling edge.
+//!
+//! Between changes the task also refreshes the MAC table snapshot, samples
+//! the MIB counters of every port every MIB_SAMPLE_MS and runs the cable
+//! diagnostics requested through CableDiagStart().
+//
+//*****************************************************************************
+static void PortMonitorTask(void *pvParameters)
+{
+	uint32_t flags;
+	uint32_t settled;
+	uint32_t i;
+	portTickType now;
+	portTickType ui32WaitTime;
+	portTickType snapshot_wait;
+
+	//Unmask the link change interrupt of every monitored port
+	for (i = 0, flags = 0; i < PORT_MONITOR_PORT_COUNT; i++) {
+		flags |= MonitoredPorts[i].int_flag;
+	}
+	EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_MASK_REGISTER, flags);
 
-				while ((EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX) >> 5) 	& 	1) {
-					uint32_t currentTime = xTaskGetTickCount();
-					vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
+    while(1)
+    {
+		//Link changes go ahead of every other SPI transaction
+		SPIArbiterSetPriority(SPIPriorityUrgent);
+
+		//Check all port interrupt flags, including any raised before we started
+		flags = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER);
+		while (flags != 0) {
+			//Clear port interrupt flags
+			EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER, flags);
+			now = xTaskGetTickCount();
+			for (i = 0; i < PORT_MONITOR_PORT_COUNT; i++) {
+				if (flags & MonitoredPorts[i].int_flag) {
+					PortPending[i] = true;
+					PortSettleTime[i] = now + (PORT_LINK_DEBOUNCE_MS / portTICK_RATE_MS);
 				}
-
-				//Enable port learning for port 3
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x32);
-				eth0_reg_settings &= ~(1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x32, eth0_reg_settings);
 			}
-			if (flags & 0x02) { // PORT 2
-				//Clear port interrupt flag
-				flags = 0x02;
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER, flags);
-
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x2E);
-				if ((eth0_reg_settings >> 5) & 1) {
-					UARTprintf("\n[SYSTEM]: Port 2 connected!\n");
-				}
-				else {
-					UARTprintf("\n[SYSTEM]: Port 2 disconnected!\n");
-				}
-
-
-				//Disable port learning for port 2
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x22);
-				eth0_reg_settings |= (1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x22, eth0_reg_settings);
-
-				//Flush Dyn MAC Table for this port
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX);
-				eth0_reg_settings |= (1 << 5);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX, eth0_reg_settings);
-
-				while ((EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX) >> 5) 	& 	1) {
-					uint32_t currentTime = xTaskGetTickCount();
-					vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
-				}
+			flags = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER);
+		}
 
-				//Enable port learning for port 2
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x22);
-				eth0_reg_settings &= ~(1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x22, eth0_reg_settings);
+		//Handle every port that has settled and find the next one due
+		now = xTaskGetTickCount();
+		settled = 0;
+		ui32WaitTime = portMAX_DELAY;
+		for (i = 0; i < PORT_MONITOR_PORT_COUNT; i++) {
+			if (!PortPending[i]) {
+				continue;
 			}
-			if (flags & 0x01) { // PORT 1
-				//Clear port interrupt flag
-				flags = 0x01;
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INTERRUPT_STATUS_REGISTER, flags);
-
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x1E);
-				if ((eth0_reg_settings >> 5) & 1) {
-					UARTprintf("\n[SYSTEM]: Port 3 connected!\n");
-				}
-				else {
-					UARTprintf("\n[SYSTEM]: Port 3 disconnected!\n");
-				}
-
-				//Disable port learning for port 4
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x12);
-				eth0_reg_settings |= (1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x12, eth0_reg_settings);
+			if ((portTickType)(now - PortSettleTime[i]) < (portMAX_DELAY / 2)) {
+				PortPending[i] = false;
+				settled |= (1 << i);
+			}
+			else if ((portTickType)(PortSettleTime[i] - now) < ui32WaitTime) {
+				ui32WaitTime = PortSettleTime[i] - now;
+			}
+		}
+		if (settled != 0) {
+			PortLinksSettled(settled);
+		}
+		SPIArbiterSetPriority(SPIPriorityNormal);
 
-				//Flush Dyn MAC Table for this port
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX);
-				eth0_reg_settings |= (1 << 5);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX, eth0_reg_settings);
+		//Keep the MAC table snapshot and the MIB counters up to date
+		snapshot_wait = MACTableService();
+		if (snapshot_wait < ui32WaitTime) {
+			ui32WaitTime = snapshot_wait;
+		}
+		snapshot_wait = MIBCountersService();
+		if (snapshot_wait < ui32WaitTime) {
+			ui32WaitTime = snapshot_wait;
+		}
+		snapshot_wait = CableDiagService();
+		if (snapshot_wait < ui32WaitTime) {
+			ui32WaitTime = snapshot_wait;
+		}
 
-				while ((EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, GLOBAL_CONTROL_0_HEX) >> 5) 	& 	1) {
-					uint32_t currentTime = xTaskGetTickCount();
-					vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
-				}
+		//Sleep until the switch signals another change, a port settles, a snapshot is due or a test is requested
+		ulTaskNotifyTake(pdTRUE, ui32WaitTime);
+    }
+}
 
-				//Enable port learning for port 4
-				eth0_reg_settings = EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x12);
-				eth0_reg_settings &= ~(1 << 0);
-				EthoControllerSingleWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, 0x12, eth0_reg_settings);
-			}
-		}
+//*****************************************************************************
+//
+//! Interrupt handler for the KSZ8895MLUB interrupt line. Wakes the port
+//! monitor task, all SPI traffic is done from the task.
+//
+//*****************************************************************************
+void PortMonitorIntHandler(void)
+{
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 
+	GPIOIntClear(ETHO_1_INT_BASE, ETHO_1_INT_PIN);
 
-		vTaskDelayUntil(&currentTime, taskDelay / portTICK_RATE_MS);
+	if (PortMonitorTaskHandle != NULL) {
+		vTaskNotifyGiveFromISR(PortMonitorTaskHandle, &xHigherPriorityTaskWoken);
+	}
+	portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
 
-    }
+//*****************************************************************************
+//
+//! Wakes the port monitor task from another task so it handles new work, such
+//! as a cable test, before its next timeout.
+//
+//*****************************************************************************
+void PortMonitorWake(void)
+{
+	if (PortMonitorTaskHandle != NULL) {
+		xTaskNotifyGive(PortMonitorTaskHandle);
+	}
 }
 
 //*****************************************************************************
 //
-//! Initializes and creates the port monitoring task.
+//! Initializes and creates the port monitoring task and attaches its interrupt
+//! to the KSZ8895MLUB interrupt line. Since interrupts stay masked until the
+//! scheduler starts, an edge seen before then is handled once it runs.
 //
 //*****************************************************************************
 uint32_t PortManagerTaskInit(void)
 {
-    if(xTaskCreate(PortMonitorTask, (const portCHAR *)"PORT_MONITOR", PORT_MONITOR_STACK_SIZE, NULL,
-                   tskIDLE_PRIORITY + PRIORITY_PORT_MONITOR_TASK, NULL) != pdTRUE)
+    PortMonitorTaskHandle = MemoryTaskCreate(PortMonitorTask, "PORT_MONITOR", PORT_MONITOR_STACK_SIZE,
+                   tskIDLE_PRIORITY + PRIORITY_PORT_MONITOR_TASK);
+    if(PortMonitorTaskHandle == NULL)
     {
         return(1);
     }
+
+    ROM_SysCtlPeripheralEnable(ETHO_1_INT_SYS_PORT_BASE);
+    // The interrupt output is open drain and active low
+    GPIOPinTypeGPIOInput(ETHO_1_INT_BASE, ETHO_1_INT_PIN);
+    GPIOPadConfigSet(ETHO_1_INT_BASE, ETHO_1_INT_PIN, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
+    GPIOIntRegister(ETHO_1_INT_BASE, PortMonitorIntHandler);
+    GPIOIntTypeSet(ETHO_1_INT_BASE, ETHO_1_INT_PIN, GPIO_FALLING_EDGE);
+    IntPrioritySet(ETHO_1_INT_VECTOR, PORT_MONITOR_INT_PRIORITY);
+    GPIOIntClear(ETHO_1_INT_BASE, ETHO_1_INT_PIN);
+    GPIOIntEnable(ETHO_1_INT_BASE, ETHO_1_INT_PIN);
     //
     // Success.
     //
@@ -25,8 +25,52 @@
 #ifndef PORT_MONITOR_TASK_H_
 #define PORT_MONITOR_TASK_H_
 
-#define PORT_MONITOR_STACK_SIZE        500
+//*****************************************************************************
+//
+//! Number of KSZ8895MLUB ports (including the expansion port) watched for
+//! link changes.
+//
+//*****************************************************************************
+#define PORT_MONITOR_PORT_COUNT        5
+//*****************************************************************************
+//
+//! Interval in milliseconds between checks for the end of a dynamic MAC table
+//! flush.
+//
+//*****************************************************************************
+#define PORT_MONITOR_FLUSH_POLL_MS     1
+//*****************************************************************************
+//
+//! Maximum time in milliseconds to wait for a dynamic MAC table flush to
+//! complete before giving up and logging an EthoControlIOException.
+//
+//*****************************************************************************
+#define PORT_MONITOR_FLUSH_TIMEOUT_MS  20
+//*****************************************************************************
+//
+//! Time in milliseconds a port's link must stay quiet after a link change
+//! before its MAC addresses are flushed. Set to 0 to react to every change.
+//
+//*****************************************************************************
+#define PORT_LINK_DEBOUNCE_MS          100
+//*****************************************************************************
+//
+//! When true, a link change only flushes the MAC addresses learned on the
+//! port that changed. When false, the whole dynamic MAC table is flushed.
+//
+//*****************************************************************************
+#define PORT_FLUSH_PER_PORT            true
+//*****************************************************************************
+//
+//! NVIC priority of the KSZ8895MLUB interrupt line. Must be numerically equal
+//! to or greater than configMAX_SYSCALL_INTERRUPT_PRIORITY since the handler
+//! notifies the port monitor task.
+//
+//*****************************************************************************
+#define PORT_MONITOR_INT_PRIORITY      0xC0
 
 extern uint32_t PortManagerTaskInit(void);
+extern void PortMonitorIntHandler(void);
+extern void PortMonitorWake(void);
 
 #endif /* PORT_MONITOR_TASK_H_ */
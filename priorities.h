@@ -35,8 +35,7 @@
 #define PRIORITY_LOGGER_TASK    	6
 #define PRIORITY_I2CMANAGER_TASK	5
 #define PRIORITY_PORT_MONITOR_TASK  4
-#define PRIORITY_LED_TASK       	3
-#define PRIORITY_LEDMANAGER_TASK  	2
+#define PRIORITY_BOOT_TASK  		1
 
 
 #endif // __PRIORITIES_H__
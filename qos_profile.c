@@ -0,0 +1,371 @@
+/**\file qos_profile.c
+ * \brief <b>Data-Plane QoS and Storm-Control Profiles</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "eee_hal.h"
+#include "freertos_init.h"
+#include "switch_batch.h"
+#include "qos_profile.h"
+
+//*****************************************************************************
+//
+//! Global Control 1 - 5 and the bits a profile owns. The other bits of these
+//! registers (2K frames, VLANs, sniffing, ...) are left as they are.
+//
+//*****************************************************************************
+#define QOS_GLOBAL_CONTROL1			0x03
+#define QOS_GLOBAL_CONTROL2			0x04
+#define QOS_GLOBAL_CONTROL3			0x05
+#define QOS_GLOBAL_CONTROL4			0x06
+#define QOS_GLOBAL_CONTROL5			0x07
+#define QOS_CONTROL1_TX_FLOW_OFF	(1 << 5)
+#define QOS_CONTROL1_RX_FLOW_OFF	(1 << 4)
+#define QOS_CONTROL1_AGING			(1 << 2)
+#define QOS_CONTROL1_FAST_AGING		(1 << 1)
+#define QOS_CONTROL2_NO_MCAST_STORM	(1 << 6)
+#define QOS_CONTROL3_FAIR_QUEUEING	(1 << 3)
+#define QOS_CONTROL4_STORM_HIGH		0x07
+
+//*****************************************************************************
+//
+//! Port Control 0 bits a profile owns. Tag insertion and removal (bits 2:1)
+//! belong to the VLAN settings.
+//
+//*****************************************************************************
+#define QOS_PORT_CONTROL0			0x00
+#define QOS_PORT0_STORM				(1 << 7)
+#define QOS_PORT0_DIFFSERV			(1 << 6)
+#define QOS_PORT0_8021P				(1 << 5)
+#define QOS_PORT0_PRIORITY_SHIFT	3
+#define QOS_PORT0_PRIORITY			(0x3 << QOS_PORT0_PRIORITY_SHIFT)
+#define QOS_PORT0_FOUR_QUEUES		(1 << 0)
+
+//*****************************************************************************
+//
+//! TOS priority control registers and the rate limit registers of each port.
+//! Port 1 - 5 each have a bank of 16 registers from 0xB0 on, holding the
+//! ingress limits of priority 0 - 3 and the egress limits of queue 0 - 3.
+//
+//*****************************************************************************
+#define QOS_TOS_PRIORITY0			0x90
+#define QOS_RATE_BANK				0xB0
+#define QOS_INGRESS_RATE0			0x07
+#define QOS_EGRESS_RATE0			0x0B
+#define QOS_RATE_MASK				0x7F
+
+//*****************************************************************************
+//
+//! Registers written per profile: Global Control 1 - 5, then Port Control 0
+//! and the two rate limits of each port, then the TOS priority registers.
+//
+//*****************************************************************************
+#define QOS_GLOBAL_REGISTERS		5
+#define QOS_PORT_REGISTERS			3
+#define QOS_REGISTER_COUNT			(QOS_GLOBAL_REGISTERS + (QOS_PORT_COUNT * QOS_PORT_REGISTERS) + QOS_DSCP_REGISTERS)
+
+//*****************************************************************************
+//
+//! \brief The bits of one register set by a profile.
+//
+//*****************************************************************************
+typedef struct {
+	uint8_t address;
+	uint8_t mask;
+	uint8_t value;
+} QoSRegister;
+
+//*****************************************************************************
+//
+//! Port settings after reset, and the port settings of the profiles.
+//! Ports without a link partner that sends priority tags gain nothing from
+//! classification, but it costs nothing either, so all ports classify.
+//
+//*****************************************************************************
+#define QOS_PORT_RESET			{0, false, false, false, false, 0, 0}
+#define QOS_PORT_ACCESS			{0, true, true, true, true, 0, 0}
+#define QOS_PORT_UPLINK			{0, true, true, true, false, 0, 0}
+#define QOS_PORT_CONTROL		{0, true, true, true, true, 50, 0}
+
+//*****************************************************************************
+//
+//! DiffServ map of the profiles: the class selector bits (5:4) pick the
+//! queue, so CS0/CS1 and AF1x go to queue 0, CS2/CS3 and AF2x/AF3x to queue 1,
+//! CS4/CS5 and AF4x to queue 2, CS6/CS7 (network control) to queue 3.
+//! EF (46) is moved up to queue 3 as well.
+//
+//*****************************************************************************
+#define QOS_DSCP_RESET			{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+								 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
+#define QOS_DSCP_CLASSES		{0x00, 0x00, 0x00, 0x00, 0x55, 0x55, 0x55, 0x55, \
+								 0xAA, 0xAA, 0xAA, 0xBA, 0xFF, 0xFF, 0xFF, 0xFF}
+
+//*****************************************************************************
+//
+//! The profiles, indexed by QOS_PROFILE_*. <br>
+//! "default" restores the reset values of the KSZ8895MLUB. <br>
+//! "cascade-uplink" keeps broadcast storms on f0 - f3 from reaching the other
+//! layers, queues by 802.1p and DiffServ and shares the expansion port fairly
+//! between the queues, so best-effort traffic of a busy layer still gets
+//! through. Flow control stays on so that bursts converging on the expansion
+//! port are paused rather than dropped. <br>
+//! "low-latency-control" serves the queues in strict priority and disables
+//! flow control, whose PAUSE frames would hold back control traffic along
+//! with everything else. Best-effort traffic received on f0 - f3 is limited to
+//! 50 Mbps per port so that no single device can fill the expansion port, and
+//! multicast counts against a lower storm rate.
+//
+//*****************************************************************************
+static const QoSSettings QoSProfiles[QOS_PROFILE_COUNT] = {
+	{0x63, false, true, true, false, false, QOS_DSCP_RESET,
+			{QOS_PORT_RESET, QOS_PORT_RESET, QOS_PORT_RESET, QOS_PORT_RESET, QOS_PORT_RESET}},
+	{0x63, false, true, true, false, true, QOS_DSCP_CLASSES,
+			{QOS_PORT_ACCESS, QOS_PORT_ACCESS, QOS_PORT_ACCESS, QOS_PORT_ACCESS, QOS_PORT_UPLINK}},
+	{0x32, true, false, true, false, false, QOS_DSCP_CLASSES,
+			{QOS_PORT_CONTROL, QOS_PORT_CONTROL, QOS_PORT_CONTROL, QOS_PORT_CONTROL, QOS_PORT_UPLINK}}
+};
+
+static const char *QoSProfileNames[QOS_PROFILE_COUNT + 1] = {
+	"default", "cascade-uplink", "low-latency-control", "custom"
+};
+
+//*****************************************************************************
+//
+//! Returns the first register of the rate limit bank of a port.
+//
+//*****************************************************************************
+static uint8_t QoSRateBank(uint32_t port)
+{
+	return (uint8_t)(QOS_RATE_BANK + (port << 4));
+}
+
+//*****************************************************************************
+//
+//! Converts one of the registers written for a set of settings.
+//!
+//! \param settings the settings to convert
+//! \param index the register (0 - QOS_REGISTER_COUNT - 1)
+//! \param reg returns the address and the bits to set
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void QoSEncode(const QoSSettings *settings, uint32_t index, QoSRegister *reg)
+{
+	const QoSPortSettings *port;
+
+	if (index < QOS_GLOBAL_REGISTERS) {
+		reg->address = (uint8_t)(QOS_GLOBAL_CONTROL1 + index);
+		switch (reg->address) {
+		case QOS_GLOBAL_CONTROL1:
+			reg->mask = QOS_CONTROL1_TX_FLOW_OFF | QOS_CONTROL1_RX_FLOW_OFF | QOS_CONTROL1_AGING | QOS_CONTROL1_FAST_AGING;
+			reg->value = (settings->flow_control ? 0 : (QOS_CONTROL1_TX_FLOW_OFF | QOS_CONTROL1_RX_FLOW_OFF))
+					| (settings->aging ? QOS_CONTROL1_AGING : 0) | (settings->fast_aging ? QOS_CONTROL1_FAST_AGING : 0);
+			break;
+		case QOS_GLOBAL_CONTROL2:
+			reg->mask = QOS_CONTROL2_NO_MCAST_STORM;
+			reg->value = (settings->storm_multicast ? 0 : QOS_CONTROL2_NO_MCAST_STORM);
+			break;
+		case QOS_GLOBAL_CONTROL3:
+			reg->mask = QOS_CONTROL3_FAIR_QUEUEING;
+			reg->value = (settings->fair_queueing ? QOS_CONTROL3_FAIR_QUEUEING : 0);
+			break;
+		case QOS_GLOBAL_CONTROL4:
+			reg->mask = QOS_CONTROL4_STORM_HIGH;
+			reg->value = (uint8_t)((settings->storm_rate >> 8) & QOS_CONTROL4_STORM_HIGH);
+			break;
+		default:
+			reg->mask = 0xFF;
+			reg->value = (uint8_t)settings->storm_rate;
+			break;
+		}
+		return;
+	}
+	index -= QOS_GLOBAL_REGISTERS;
+
+	if (index < (QOS_PORT_COUNT * QOS_PORT_REGISTERS)) {
+		port = &settings->ports[index / QOS_PORT_REGISTERS];
+		switch (index % QOS_PORT_REGISTERS) {
+		case 0:
+			reg->address = (uint8_t)((((index / QOS_PORT_REGISTERS) + 1) << 4) + QOS_PORT_CONTROL0);
+			reg->mask = QOS_PORT0_STORM | QOS_PORT0_DIFFSERV | QOS_PORT0_8021P | QOS_PORT0_PRIORITY | QOS_PORT0_FOUR_QUEUES;
+			reg->value = (port->storm_protection ? QOS_PORT0_STORM : 0) | (port->classify_diffserv ? QOS_PORT0_DIFFSERV : 0)
+					| (port->classify_8021p ? QOS_PORT0_8021P : 0) | ((port->priority << QOS_PORT0_PRIORITY_SHIFT) & QOS_PORT0_PRIORITY)
+					| (port->four_queues ? QOS_PORT0_FOUR_QUEUES : 0);
+			break;
+		case 1:
+			reg->address = QoSRateBank(index / QOS_PORT_REGISTERS) + QOS_INGRESS_RATE0;
+			reg->mask = QOS_RATE_MASK;
+			reg->value = port->ingress_mbps;
+			break;
+		default:
+			reg->address = QoSRateBank(index / QOS_PORT_REGISTERS) + QOS_EGRESS_RATE0;
+			reg->mask = QOS_RATE_MASK;
+			reg->value = port->egress_mbps;
+			break;
+		}
+		return;
+	}
+	index -= (QOS_PORT_COUNT * QOS_PORT_REGISTERS);
+
+	reg->address = (uint8_t)(QOS_TOS_PRIORITY0 + index);
+	reg->mask = 0xFF;
+	reg->value = settings->dscp_map[index];
+}
+
+//*****************************************************************************
+//
+//! Reads a register of the Ethernet Controller, from the shadow if possible.
+//
+//*****************************************************************************
+static uint8_t QoSRead(uint8_t address)
+{
+	return (uint8_t)EthoControllerSingleRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, address);
+}
+
+//*****************************************************************************
+//
+//! Writes a profile to the Ethernet Controller through a switch batch.
+//!
+//! \param profile the profile (0 - QOS_PROFILE_COUNT - 1)
+//! \param result returns the result of the batch (may be NULL)
+//!
+//! \return Returns false if the profile is invalid, another task has a batch
+//! open or a write failed
+//
+//*****************************************************************************
+bool QoSProfileApply(uint32_t profile, SwitchBatchResult *result)
+{
+	QoSRegister reg;
+	uint32_t index;
+	bool own_batch, success = true;
+
+	if (result) {
+		memset(result, 0, sizeof(*result));
+	}
+	if (profile >= QOS_PROFILE_COUNT) {
+		return false;
+	}
+	//Inside "config begin" the registers are only staged, "config commit" writes them
+	own_batch = !SwitchBatchActive();
+	if (own_batch && !SwitchBatchBegin()) {
+		return false;
+	}
+	for (index = 0; index < QOS_REGISTER_COUNT; index++) {
+		QoSEncode(&QoSProfiles[profile], index, &reg);
+		success &= EthoControllerModifyBits(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN,
+				reg.address, reg.mask, (reg.value & reg.mask), NULL);
+	}
+	if (own_batch) {
+		success &= SwitchBatchCommit(result);
+	}
+	return success;
+}
+
+//*****************************************************************************
+//
+//! Finds the profile the Ethernet Controller is configured with.
+//!
+//! \return Returns the profile, or QOS_PROFILE_CUSTOM if none matches
+//
+//*****************************************************************************
+uint32_t QoSProfileActive(void)
+{
+	uint8_t registers[QOS_REGISTER_COUNT];
+	QoSRegister reg;
+	uint32_t profile, index;
+
+	//The addresses are the same for every profile
+	for (index = 0; index < QOS_REGISTER_COUNT; index++) {
+		QoSEncode(&QoSProfiles[0], index, &reg);
+		registers[index] = QoSRead(reg.address);
+	}
+	for (profile = 0; profile < QOS_PROFILE_COUNT; profile++) {
+		for (index = 0; index < QOS_REGISTER_COUNT; index++) {
+			QoSEncode(&QoSProfiles[profile], index, &reg);
+			if ((registers[index] & reg.mask) != (reg.value & reg.mask)) {
+				break;
+			}
+		}
+		if (index == QOS_REGISTER_COUNT) {
+			return profile;
+		}
+	}
+	return QOS_PROFILE_CUSTOM;
+}
+
+//*****************************************************************************
+//
+//! Returns the name of a profile as used by "system qos-profile".
+//!
+//! \param profile the profile, QOS_PROFILE_CUSTOM for "custom"
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *QoSProfileName(uint32_t profile)
+{
+	return QoSProfileNames[(profile < QOS_PROFILE_COUNT) ? profile : QOS_PROFILE_CUSTOM];
+}
+
+//*****************************************************************************
+//
+//! Reads the settings a profile consists of back from the Ethernet
+//! Controller.
+//!
+//! \param settings returns the settings
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void QoSGet(QoSSettings *settings)
+{
+	QoSPortSettings *port;
+	uint8_t value;
+	uint32_t index;
+
+	value = QoSRead(QOS_GLOBAL_CONTROL1);
+	settings->flow_control = !(value & (QOS_CONTROL1_TX_FLOW_OFF | QOS_CONTROL1_RX_FLOW_OFF));
+	settings->aging = ((value & QOS_CONTROL1_AGING) != 0);
+	settings->fast_aging = ((value & QOS_CONTROL1_FAST_AGING) != 0);
+	settings->storm_multicast = !(QoSRead(QOS_GLOBAL_CONTROL2) & QOS_CONTROL2_NO_MCAST_STORM);
+	settings->fair_queueing = ((QoSRead(QOS_GLOBAL_CONTROL3) & QOS_CONTROL3_FAIR_QUEUEING) != 0);
+	settings->storm_rate = (uint16_t)(((QoSRead(QOS_GLOBAL_CONTROL4) & QOS_CONTROL4_STORM_HIGH) << 8) | QoSRead(QOS_GLOBAL_CONTROL5));
+
+	for (index = 0; index < QOS_PORT_COUNT; index++) {
+		port = &settings->ports[index];
+		value = QoSRead((uint8_t)(((index + 1) << 4) + QOS_PORT_CONTROL0));
+		port->storm_protection = ((value & QOS_PORT0_STORM) != 0);
+		port->classify_diffserv = ((value & QOS_PORT0_DIFFSERV) != 0);
+		port->classify_8021p = ((value & QOS_PORT0_8021P) != 0);
+		port->priority = (value & QOS_PORT0_PRIORITY) >> QOS_PORT0_PRIORITY_SHIFT;
+		port->four_queues = ((value & QOS_PORT0_FOUR_QUEUES) != 0);
+		port->ingress_mbps = QoSRead(QoSRateBank(index) + QOS_INGRESS_RATE0) & QOS_RATE_MASK;
+		port->egress_mbps = QoSRead(QoSRateBank(index) + QOS_EGRESS_RATE0) & QOS_RATE_MASK;
+	}
+	for (index = 0; index < QOS_DSCP_REGISTERS; index++) {
+		settings->dscp_map[index] = QoSRead((uint8_t)(QOS_TOS_PRIORITY0 + index));
+	}
+}
@@ -0,0 +1,155 @@
+/**\file qos_profile.h
+ * \brief <b>Data-Plane QoS and Storm-Control Profiles</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+#ifndef QOS_PROFILE_H_
+#define QOS_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "switch_batch.h"
+
+//*****************************************************************************
+//
+//! Number of KSZ8895MLUB ports covered by a profile. Ports are numbered as on
+//! the KSZ8895MLUB: 0 = port 1 (f3) through 4 = port 5 (exp-port).
+//
+//*****************************************************************************
+#define QOS_PORT_COUNT				5
+
+//*****************************************************************************
+//
+//! The 64 DiffServ code points are mapped to a queue by the TOS priority
+//! registers, two bits per code point and four code points per register,
+//! code point 0 in bits 1:0 of the first register.
+//
+//*****************************************************************************
+#define QOS_DSCP_COUNT				64
+#define QOS_DSCP_REGISTERS			(QOS_DSCP_COUNT / 4)
+#define QOS_DSCP_QUEUE(map, dscp)	(((map)[(dscp) >> 2] >> (((dscp) & 0x3) * 2)) & 0x3)
+
+//*****************************************************************************
+//
+//! Profiles selectable with "system qos-profile". QOS_PROFILE_CUSTOM is
+//! returned by QoSProfileActive() if the registers match none of them.
+//
+//*****************************************************************************
+#define QOS_PROFILE_DEFAULT			0
+#define QOS_PROFILE_CASCADE_UPLINK	1
+#define QOS_PROFILE_LOW_LATENCY		2
+#define QOS_PROFILE_COUNT			3
+#define QOS_PROFILE_CUSTOM			QOS_PROFILE_COUNT
+
+//*****************************************************************************
+//
+//! \brief QoS settings of one port.
+//
+//*****************************************************************************
+typedef struct {
+	//! Queue (0 - 3) of frames that are not classified by their tag or TOS
+	uint8_t priority;
+	//! Four transmit queues instead of one
+	bool four_queues;
+	//! Classify tagged frames by their 802.1p priority
+	bool classify_8021p;
+	//! Classify IP frames by their DiffServ code point
+	bool classify_diffserv;
+	//! Limit broadcast frames to the storm rate
+	bool storm_protection;
+	//! Rate limit of priority 0 (best effort) frames received in Mbps (1 - 100), 0 = no limit
+	uint8_t ingress_mbps;
+	//! Rate limit of queue 0 (best effort) frames transmitted in Mbps (1 - 100), 0 = no limit
+	uint8_t egress_mbps;
+} QoSPortSettings;
+
+//*****************************************************************************
+//
+//! \brief Data-plane settings set by a profile, see QoSGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Broadcast frames allowed per 50 ms on ports with storm protection (11 bits)
+	uint16_t storm_rate;
+	//! Count multicast frames against the storm rate as well
+	bool storm_multicast;
+	//! Honour and send PAUSE frames
+	bool flow_control;
+	//! Age out learned MAC addresses
+	bool aging;
+	//! Age out after about 800 us instead of 300 s
+	bool fast_aging;
+	//! Weighted fair queueing between the queues instead of strict priority
+	bool fair_queueing;
+	//! Queue of each DiffServ code point, see QOS_DSCP_QUEUE()
+	uint8_t dscp_map[QOS_DSCP_REGISTERS];
+	QoSPortSettings ports[QOS_PORT_COUNT];
+} QoSSettings;
+
+//*****************************************************************************
+//
+//! Writes a profile to the Ethernet Controller. The registers are staged in a
+//! switch batch and written in a few bursts when it is committed, instead of
+//! one command per register. Inside a batch opened with "config begin" they are
+//! only staged and written by "config commit". The registers are saved with
+//! the switch configuration, so the profile is kept after "config save".
+//!
+//! \param profile the profile (0 - QOS_PROFILE_COUNT - 1)
+//! \param result returns the result of the batch (may be NULL). Left at zero
+//! if the registers were staged in a batch that is still open.
+//!
+//! \return Returns false if the profile is invalid, another task has a batch
+//! open or a write failed
+//
+//*****************************************************************************
+extern bool QoSProfileApply(uint32_t profile, SwitchBatchResult *result);
+//*****************************************************************************
+//
+//! Finds the profile the Ethernet Controller is configured with. Registers
+//! are read from the register shadow where possible.
+//!
+//! \return Returns the profile, or QOS_PROFILE_CUSTOM if none matches
+//
+//*****************************************************************************
+extern uint32_t QoSProfileActive(void);
+//*****************************************************************************
+//
+//! Returns the name of a profile as used by "system qos-profile".
+//!
+//! \param profile the profile, QOS_PROFILE_CUSTOM for "custom"
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+extern const char *QoSProfileName(uint32_t profile);
+//*****************************************************************************
+//
+//! Reads the settings a profile consists of back from the Ethernet
+//! Controller.
+//!
+//! \param settings returns the settings
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void QoSGet(QoSSettings *settings);
+
+#endif /* QOS_PROFILE_H_ */
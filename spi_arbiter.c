@@ -0,0 +1,304 @@
+/**\file spi_arbiter.c
+ * \brief <b>Priority-Aware SPI Bus Arbiter</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "spi_arbiter.h"
+
+//*****************************************************************************
+//
+//! \brief A transaction waiting for a bus. Lives on the stack of the waiting
+//! task and is only touched by other tasks while it is queued.
+//
+//*****************************************************************************
+typedef struct SPIArbiterWaiter {
+	//! The waiting task and its slot
+	xTaskHandle task;
+	uint32_t slot;
+	SPIPriority priority;
+	//! Set when the bus has been handed to this transaction
+	volatile bool granted;
+	//! Set if the transaction was queued ahead of a lower priority one
+	bool overtook;
+	struct SPIArbiterWaiter *next;
+} SPIArbiterWaiter;
+
+//*****************************************************************************
+//
+//! \brief Ownership and wait queue of one bus. The queue is ordered by
+//! priority, highest first, and by arrival within a priority.
+//
+//*****************************************************************************
+typedef struct {
+	uint32_t ssi_base;
+	xTaskHandle owner;
+	//! Number of nested grants held by the owner
+	uint32_t depth;
+	SPIArbiterWaiter *waiters;
+	SPIArbiterStats stats;
+} SPIArbiterBus;
+
+static SPIArbiterBus SPIArbiterBuses[SPI_ARBITER_BUS_COUNT] = {
+	{SSI0_BASE, NULL, 0, NULL},
+	{SSI1_BASE, NULL, 0, NULL}
+};
+
+//*****************************************************************************
+//
+//! Transaction priority and wake-up semaphore of every task slot. A task only
+//! ever waits for one bus at a time, so one semaphore per task is enough.
+//
+//*****************************************************************************
+static SPIPriority SPIArbiterPriorities[SPI_ARBITER_SLOT_COUNT];
+static xSemaphoreHandle SPIArbiterWake[SPI_ARBITER_SLOT_COUNT];
+static bool SPIArbiterReady = false;
+
+//*****************************************************************************
+//
+//! Returns the arbitration state of the given SSI port or NULL if the port is
+//! not arbitrated.
+//
+//*****************************************************************************
+static SPIArbiterBus *SPIArbiterGetBus(uint32_t SSI_BASE)
+{
+	if (SSI_BASE == SSI0_BASE) {
+		return &SPIArbiterBuses[SPI_ARBITER_BUS_EEPROM];
+	}
+	else if (SSI_BASE == SSI1_BASE) {
+		return &SPIArbiterBuses[SPI_ARBITER_BUS_ETHO];
+	}
+	return NULL;
+}
+
+//*****************************************************************************
+//
+//! Returns true if requests have to be arbitrated, i.e. the scheduler is
+//! running. Before that only one thread uses the HAL.
+//
+//*****************************************************************************
+static bool SPIArbiterActive(void)
+{
+	return (SPIArbiterReady && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING);
+}
+
+//*****************************************************************************
+//
+//! Returns the slot of the calling task.
+//
+//*****************************************************************************
+static uint32_t SPIArbiterSlot(void)
+{
+	uint32_t slot = uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+
+	return ((slot < SPI_ARBITER_SLOT_COUNT) ? slot : 0);
+}
+
+//*****************************************************************************
+//
+//! Creates the wake-up semaphore of every task slot.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SPIArbiterInit(void)
+{
+	uint32_t slot;
+
+	for (slot = 0; slot < SPI_ARBITER_SLOT_COUNT; slot++) {
+		SPIArbiterPriorities[slot] = SPIPriorityNormal;
+		SPIArbiterWake[slot] = xSemaphoreCreateBinary();
+	}
+	SPIArbiterReady = true;
+}
+
+//*****************************************************************************
+//
+//! Gives the calling task the bus, or queues the request and blocks until the
+//! bus is handed to it by SPIBusRelease().
+//!
+//! \param SSI_BASE the base address of the SSI port (SSI0 or SSI1)
+//! \param timeout_ms longest time to wait in milliseconds
+//!
+//! \return Returns false if the bus could not be had in time
+//
+//*****************************************************************************
+bool SPIBusAcquire(uint32_t SSI_BASE, uint32_t timeout_ms)
+{
+	SPIArbiterBus *bus = SPIArbiterGetBus(SSI_BASE);
+	SPIArbiterWaiter waiter;
+	SPIArbiterWaiter **link;
+	portTickType start, elapsed;
+	portTickType timeout = timeout_ms / portTICK_RATE_MS;
+	uint32_t waited_ms;
+
+	if (bus == NULL || !SPIArbiterActive()) {
+		return true;
+	}
+
+	waiter.task = xTaskGetCurrentTaskHandle();
+	waiter.slot = SPIArbiterSlot();
+	waiter.priority = SPIArbiterPriorities[waiter.slot];
+	waiter.granted = false;
+
+	taskENTER_CRITICAL();
+	if (bus->owner == waiter.task) {
+		//Nested call from within another HAL function of the owner
+		bus->depth++;
+		taskEXIT_CRITICAL();
+		return true;
+	}
+	if (bus->owner == NULL) {
+		bus->owner = waiter.task;
+		bus->depth = 1;
+		bus->stats.grants++;
+		taskEXIT_CRITICAL();
+		return true;
+	}
+	//Queue behind every transaction of the same or a higher priority
+	for (link = &bus->waiters; *link != NULL && (*link)->priority >= waiter.priority; link = &(*link)->next);
+	waiter.overtook = (*link != NULL);
+	waiter.next = *link;
+	*link = &waiter;
+	bus->stats.waiting++;
+	taskEXIT_CRITICAL();
+
+	//A wake-up left over from an earlier grant that was noticed without it is skipped by the loop
+	start = xTaskGetTickCount();
+	while (!waiter.granted) {
+		elapsed = xTaskGetTickCount() - start;
+		if (elapsed >= timeout || xSemaphoreTake(SPIArbiterWake[waiter.slot], timeout - elapsed) != pdTRUE) {
+			break;
+		}
+	}
+	waited_ms = (xTaskGetTickCount() - start) * portTICK_RATE_MS;
+
+	taskENTER_CRITICAL();
+	if (!waiter.granted) {
+		//Timed out, leave the queue
+		for (link = &bus->waiters; *link != NULL && *link != &waiter; link = &(*link)->next);
+		if (*link != NULL) {
+			*link = waiter.next;
+		}
+		bus->stats.waiting--;
+		bus->stats.timeouts++;
+	}
+	else if (waited_ms > bus->stats.max_wait_ms) {
+		bus->stats.max_wait_ms = waited_ms;
+	}
+	taskEXIT_CRITICAL();
+
+	return waiter.granted;
+}
+
+//*****************************************************************************
+//
+//! Releases one level of the calling task's ownership of the bus and hands
+//! the bus to the first queued transaction once the last level is released.
+//!
+//! \param SSI_BASE the base address of the SSI port (SSI0 or SSI1)
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SPIBusRelease(uint32_t SSI_BASE)
+{
+	SPIArbiterBus *bus = SPIArbiterGetBus(SSI_BASE);
+	SPIArbiterWaiter *next;
+	xSemaphoreHandle wake = NULL;
+
+	if (bus == NULL || !SPIArbiterActive()) {
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	if (bus->owner == xTaskGetCurrentTaskHandle() && --bus->depth == 0) {
+		next = bus->waiters;
+		if (next != NULL) {
+			//Hand the bus over directly so the releasing task cannot take it straight back
+			bus->waiters = next->next;
+			bus->owner = next->task;
+			bus->depth = 1;
+			bus->stats.grants++;
+			bus->stats.waits++;
+			bus->stats.waiting--;
+			if (next->overtook) {
+				bus->stats.preemptions++;
+			}
+			wake = SPIArbiterWake[next->slot];
+			next->granted = true;
+		}
+		else {
+			bus->owner = NULL;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if (wake != NULL) {
+		xSemaphoreGive(wake);
+	}
+}
+
+//*****************************************************************************
+//
+//! Sets the priority of the calling task's SPI transactions.
+//!
+//! \param priority the new priority
+//!
+//! \return Returns the previous priority
+//
+//*****************************************************************************
+SPIPriority SPIArbiterSetPriority(SPIPriority priority)
+{
+	uint32_t slot = SPIArbiterSlot();
+	SPIPriority previous = SPIArbiterPriorities[slot];
+
+	if (priority < SPI_PRIORITY_COUNT) {
+		SPIArbiterPriorities[slot] = priority;
+	}
+	return previous;
+}
+
+//*****************************************************************************
+//
+//! Copies the counters of a bus.
+//!
+//! \param bus SPI_ARBITER_BUS_EEPROM or SPI_ARBITER_BUS_ETHO
+//! \param stats returns the counters
+//!
+//! \return Returns false if the bus is invalid
+//
+//*****************************************************************************
+bool SPIArbiterGet(uint8_t bus, SPIArbiterStats *stats)
+{
+	if (bus >= SPI_ARBITER_BUS_COUNT) {
+		return false;
+	}
+	taskENTER_CRITICAL();
+	*stats = SPIArbiterBuses[bus].stats;
+	taskEXIT_CRITICAL();
+	return true;
+}
@@ -0,0 +1,168 @@
+/**\file spi_arbiter.h
+ * \brief <b>Priority-Aware SPI Bus Arbiter</b>
+ *
+ *
+ *  Created on: Oct 15, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef SPI_ARBITER_H_
+#define SPI_ARBITER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "eee_hal.h"
+#include "memory_budget.h"
+
+//*****************************************************************************
+//
+//! SSI buses owned by the arbiter: SSI0 to the 25AA1024 EEPROM and SSI1 to the
+//! KSZ8895MLUB. Numbered like the SPI clock profiles (see spi_clock.h).
+//
+//*****************************************************************************
+#define SPI_ARBITER_BUS_EEPROM		0
+#define SPI_ARBITER_BUS_ETHO		1
+#define SPI_ARBITER_BUS_COUNT		2
+
+//*****************************************************************************
+//
+//! Longest time in milliseconds a HAL transaction waits for its bus before it
+//! fails. The longest single hold is one EEPROM page write or erase
+//! (about 6 ms), so only a stuck bus reaches this.
+//
+//*****************************************************************************
+#define SPI_ARBITER_TIMEOUT_MS		500
+
+//*****************************************************************************
+//
+//! Largest number of bytes an EEPROM read moves per bus grant. Longer reads
+//! are split so that waiting transactions get the bus in between. Writes are
+//! always split on page boundaries.
+//
+//*****************************************************************************
+#define SPI_ARBITER_CHUNK_SIZE		EEPROM_PAGE_SIZE
+
+//*****************************************************************************
+//
+//! One slot per task number set by MemoryTaskCreate(). Slot 0 is shared by
+//! tasks that were not created through MemoryTaskCreate().
+//
+//*****************************************************************************
+#define SPI_ARBITER_SLOT_COUNT		(MEMORY_TASK_COUNT + 1)
+
+//*****************************************************************************
+//
+//! \brief Priority of a task's SPI transactions. When a bus is released it is
+//! handed to the waiting transaction with the highest priority, in order of
+//! arrival within a priority. It is independent of the FreeRTOS priority of
+//! the task, so the interpreter can save the configuration in the background
+//! while a lower priority task handles a link change.
+//
+//*****************************************************************************
+typedef enum {
+	//! Long jobs: configuration saves and log writes
+	SPIPriorityBackground,
+	//! Command-line and boot, the default of every task
+	SPIPriorityNormal,
+	//! Requests from the I2C master
+	SPIPriorityHigh,
+	//! Link change handling in PortMonitorTask
+	SPIPriorityUrgent,
+	SPI_PRIORITY_COUNT
+} SPIPriority;
+
+//*****************************************************************************
+//
+//! \brief Counters of one bus since boot, see SPIArbiterGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Number of times the bus was granted (nested grants are not counted)
+	uint32_t grants;
+	//! Grants that had to wait for another task
+	uint32_t waits;
+	//! Grants handed to a transaction that arrived after a lower priority
+	//! one was already waiting
+	uint32_t preemptions;
+	//! Transactions that gave up waiting
+	uint32_t timeouts;
+	//! Longest wait in milliseconds
+	uint32_t max_wait_ms;
+	//! Transactions waiting right now
+	uint32_t waiting;
+} SPIArbiterStats;
+
+//*****************************************************************************
+//
+//! Creates the wake-up semaphore of every task slot. Must be called before the
+//! scheduler is started. Until then the HAL is only used by one thread, so
+//! every request is granted straight away.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void SPIArbiterInit(void);
+//*****************************************************************************
+//
+//! Gives the calling task the bus, or blocks until the bus is handed to it.
+//! A task that already owns the bus only nests one level deeper, so HAL
+//! functions may call each other. Does nothing before the scheduler is
+//! started.
+//!
+//! \param SSI_BASE the base address of the SSI port (SSI0 or SSI1)
+//! \param timeout_ms longest time to wait in milliseconds
+//!
+//! \return Returns false if the bus could not be had in time
+//
+//*****************************************************************************
+extern bool SPIBusAcquire(uint32_t SSI_BASE, uint32_t timeout_ms);
+//*****************************************************************************
+//
+//! Releases one level of the calling task's ownership of the bus. The last
+//! release hands the bus to the highest priority waiting transaction.
+//!
+//! \param SSI_BASE the base address of the SSI port (SSI0 or SSI1)
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void SPIBusRelease(uint32_t SSI_BASE);
+//*****************************************************************************
+//
+//! Sets the priority of the calling task's SPI transactions.
+//!
+//! \param priority the new priority
+//!
+//! \return Returns the previous priority, so that it can be restored
+//
+//*****************************************************************************
+extern SPIPriority SPIArbiterSetPriority(SPIPriority priority);
+//*****************************************************************************
+//
+//! Copies the counters of a bus.
+//!
+//! \param bus SPI_ARBITER_BUS_EEPROM or SPI_ARBITER_BUS_ETHO
+//! \param stats returns the counters
+//!
+//! \return Returns false if the bus is invalid
+//
+//*****************************************************************************
+extern bool SPIArbiterGet(uint8_t bus, SPIArbiterStats *stats);
+
+#endif /* SPI_ARBITER_H_ */
@@ -0,0 +1,412 @@
+/**\file spi_clock.c
+ * \brief <b>SPI Clock Profiles and Self-Test</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "ssi.h"
+#include "sysctl.h"
+#include "eee_hal.h"
+#include "interpreter_task.h"
+#include "freertos_init.h"
+#include "spi_arbiter.h"
+#include "spi_clock.h"
+
+//*****************************************************************************
+//
+//! Saved setting of a bus in EEPROM_FIRMWARE_SPICLOCK + bus: the upper four
+//! bits tell how the profile in the lower four bits was chosen. Any other
+//! value, including an erased EEPROM, tunes the bus at the next boot.
+//
+//*****************************************************************************
+#define SPI_CLOCK_SAVED_TUNED		0x50
+#define SPI_CLOCK_SAVED_FIXED		0x60
+#define SPI_CLOCK_SAVED_NONE		0xFF
+#define SPI_CLOCK_SAVED_KIND_MASK	0xF0
+#define SPI_CLOCK_SAVED_PROFILE_MASK	0x0F
+
+//*****************************************************************************
+//
+//! Bytes of the EEPROM test page written and read back, and the indirect
+//! data registers (DATA_7 - DATA_0) of the KSZ8895MLUB used as scratch
+//! registers. Both test lengths are above SSI_DMA_MIN_LENGTH so the uDMA path
+//! is tested too.
+//
+//*****************************************************************************
+#define SPI_CLOCK_TEST_LENGTH		64
+#define SPI_CLOCK_SCRATCH_BASE		INDIRECT_REGISTER_DATA_7
+#define SPI_CLOCK_SCRATCH_COUNT		8
+
+//*****************************************************************************
+//
+//! Rates of the profiles and the limits of each bus.
+//
+//*****************************************************************************
+static const uint32_t SPIClockRates[SPI_CLOCK_PROFILE_COUNT] = SPI_CLOCK_PROFILE_RATES;
+static const uint32_t SPIClockDefaults[SPI_CLOCK_BUS_COUNT] = {SPI_CLOCK_EEPROM_DEFAULT, SPI_CLOCK_ETHO_DEFAULT};
+static const uint32_t SPIClockLimits[SPI_CLOCK_BUS_COUNT] = {SPI_CLOCK_EEPROM_MAX, SPI_CLOCK_ETHO_MAX};
+static const uint32_t SPIClockBases[SPI_CLOCK_BUS_COUNT] = {EEPROM_BASE_ADDR, ETHO_1_BASE_ADDR};
+static const char *SPIClockBusNames[SPI_CLOCK_BUS_COUNT] = {"EEPROM", "Ethernet Controller"};
+
+//*****************************************************************************
+//
+//! Clock of each bus. Written by SPIClockInit() before the scheduler starts
+//! and by SPIClockSelect() while it holds the bus.
+//
+//*****************************************************************************
+static SPIClockInfo SPIClocks[SPI_CLOCK_BUS_COUNT];
+
+//*****************************************************************************
+//
+//! Returns the rate SSIConfigSetExpClk() really programs for a requested rate.
+//! The driver rounds the divider down, so the result can be above the request
+//! when the rate does not divide the system clock.
+//!
+//! \param rate the requested rate in Hz
+//!
+//! \return Returns the rate in Hz
+//
+//*****************************************************************************
+static uint32_t SPIClockActual(uint32_t rate)
+{
+	uint32_t clock = SysCtlClockGet();
+	uint32_t divider = clock / rate;
+	uint32_t prescale = 0, scr;
+
+	//Same search as SSIConfigSetExpClk(): the smallest even CPSDVSR that fits SCR
+	do {
+		prescale += 2;
+		scr = (divider / prescale) - 1;
+	} while (scr > 255);
+	return clock / (prescale * (1 + scr));
+}
+
+//*****************************************************************************
+//
+//! Reprograms the clock of a bus. The caller must own the bus or the
+//! scheduler must not be running yet.
+//!
+//! \param bus the bus
+//! \param rate the rate in Hz
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void SPIClockApply(uint8_t bus, uint32_t rate)
+{
+	SSIDisable(SPIClockBases[bus]);
+	SSIConfigSetExpClk(SPIClockBases[bus], SysCtlClockGet(), SSI_FRF_MOTO_MODE_0, SSI_MODE_MASTER, rate, 8);
+	SSIEnable(SPIClockBases[bus]);
+	SPIClocks[bus].rate = SPIClockActual(rate);
+}
+
+//*****************************************************************************
+//
+//! Fills a buffer with a test pattern. Different seeds toggle every bit.
+//!
+//! \param data the buffer
+//! \param length number of bytes
+//! \param seed selects the pattern
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void SPIClockPattern(uint8_t *data, uint32_t length, uint32_t seed)
+{
+	uint32_t i;
+
+	for (i = 0; i < length; i++) {
+		data[i] = (uint8_t)(((i + seed) * 0x1D) ^ ((seed & 1) ? 0x5A : 0xA5));
+	}
+}
+
+//*****************************************************************************
+//
+//! Tests a bus at its current rate: the EEPROM test page is written once and
+//! read back SPI_CLOCK_TEST_PASSES times, the scratch registers of the
+//! Ethernet Controller are written and read back SPI_CLOCK_TEST_PASSES times.
+//!
+//! \param bus the bus
+//! \param seed selects the patterns
+//!
+//! \return Returns true if every read returned the pattern
+//
+//*****************************************************************************
+static bool SPIClockTest(uint8_t bus, uint32_t seed)
+{
+	uint8_t expected[SPI_CLOCK_TEST_LENGTH];
+	uint8_t data[SPI_CLOCK_TEST_LENGTH];
+	uint32_t etho_expected[SPI_CLOCK_SCRATCH_COUNT];
+	uint32_t etho_data[SPI_CLOCK_SCRATCH_COUNT];
+	uint32_t pass, i;
+	bool result = true;
+
+	if (bus == SPI_CLOCK_BUS_EEPROM) {
+		SPIClockPattern(expected, SPI_CLOCK_TEST_LENGTH, seed);
+		//The page write reads the page back once itself
+		if (!EEPROMPageWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_SPI_TEST_PAGE, expected, SPI_CLOCK_TEST_LENGTH)) {
+			return false;
+		}
+		for (pass = 0; pass < SPI_CLOCK_TEST_PASSES && result; pass++) {
+			memset(data, 0, sizeof(data));
+			result = EEPROMSequentialRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_SPI_TEST_PAGE, data, SPI_CLOCK_TEST_LENGTH) &&
+					(memcmp(data, expected, SPI_CLOCK_TEST_LENGTH) == 0);
+		}
+		return result;
+	}
+
+	for (pass = 0; pass < SPI_CLOCK_TEST_PASSES && result; pass++) {
+		SPIClockPattern(expected, SPI_CLOCK_SCRATCH_COUNT, seed + pass);
+		for (i = 0; i < SPI_CLOCK_SCRATCH_COUNT; i++) {
+			etho_expected[i] = expected[i];
+			etho_data[i] = 0;
+		}
+		result = EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, SPI_CLOCK_SCRATCH_BASE, SPI_CLOCK_SCRATCH_COUNT, etho_expected) &&
+				EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, SPI_CLOCK_SCRATCH_BASE, SPI_CLOCK_SCRATCH_COUNT, etho_data) &&
+				(memcmp(etho_data, etho_expected, sizeof(etho_data)) == 0);
+	}
+	//Leave the scratch registers as they are after a reset
+	memset(etho_data, 0, sizeof(etho_data));
+	EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, SPI_CLOCK_SCRATCH_BASE, SPI_CLOCK_SCRATCH_COUNT, etho_data);
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Tests the profiles of a bus from the fastest the device is rated for down
+//! to its default rate and keeps the first that passes, or the default rate
+//! if none does.
+//!
+//! \param bus the bus
+//!
+//! \return Returns the profile chosen, or SPI_CLOCK_PROFILE_COUNT if none passed
+//
+//*****************************************************************************
+static uint32_t SPIClockTune(uint8_t bus)
+{
+	uint32_t profile;
+
+	for (profile = 0; profile < SPI_CLOCK_PROFILE_COUNT; profile++) {
+		if (SPIClockProfileRate(profile) > SPIClockLimits[bus]) {
+			continue;
+		}
+		if (SPIClockProfileRate(profile) < SPIClockActual(SPIClockDefaults[bus])) {
+			break;
+		}
+		SPIClockApply(bus, SPIClockRates[profile]);
+		if (SPIClockTest(bus, profile)) {
+			SPIClocks[bus].passed |= (1 << profile);
+			SPIClocks[bus].source = SPIClockTuned;
+			return profile;
+		}
+	}
+	SPIClockApply(bus, SPIClockDefaults[bus]);
+	SPIClocks[bus].source = SPIClockDefault;
+	return SPI_CLOCK_PROFILE_COUNT;
+}
+
+//*****************************************************************************
+//
+//! Restores the saved rate of each bus or tunes it.
+//!
+//! \return Returns false if the self-test of a bus failed at every rate
+//
+//*****************************************************************************
+bool SPIClockInit(void)
+{
+	uint8_t saved[SPI_CLOCK_BUS_COUNT];
+	uint32_t profile, kind;
+	uint8_t bus;
+	bool result = true;
+
+	//Both buses still run at the rates set by ConfigureSSI()
+	for (bus = 0; bus < SPI_CLOCK_BUS_COUNT; bus++) {
+		SPIClocks[bus].rate = SPIClockActual(SPIClockDefaults[bus]);
+		SPIClocks[bus].source = SPIClockDefault;
+		SPIClocks[bus].passed = 0;
+		SPIClocks[bus].selected = 0;
+		saved[bus] = EEPROMSingleRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_SPICLOCK + bus);
+	}
+
+	for (bus = 0; bus < SPI_CLOCK_BUS_COUNT; bus++) {
+		kind = saved[bus] & SPI_CLOCK_SAVED_KIND_MASK;
+		profile = saved[bus] & SPI_CLOCK_SAVED_PROFILE_MASK;
+		if ((kind == SPI_CLOCK_SAVED_TUNED || kind == SPI_CLOCK_SAVED_FIXED) && profile < SPI_CLOCK_PROFILE_COUNT &&
+				SPIClockProfileRate(profile) <= SPIClockLimits[bus]) {
+			if (kind == SPI_CLOCK_SAVED_FIXED) {
+				SPIClocks[bus].selected = SPIClockProfileRate(profile);
+			}
+			//Check the saved rate before trusting it
+			SPIClockApply(bus, SPIClockRates[profile]);
+			if (SPIClockTest(bus, profile)) {
+				SPIClocks[bus].passed |= (1 << profile);
+				SPIClocks[bus].source = (kind == SPI_CLOCK_SAVED_FIXED) ? SPIClockFixed : SPIClockTuned;
+				continue;
+			}
+			if (kind == SPI_CLOCK_SAVED_FIXED) {
+				//Keep the selection, it may pass again once the fault is fixed
+				SPIClockApply(bus, SPIClockDefaults[bus]);
+				result = false;
+				continue;
+			}
+		}
+		profile = SPIClockTune(bus);
+		if (profile == SPI_CLOCK_PROFILE_COUNT) {
+			result = false;
+		}
+		else if (saved[bus] != (SPI_CLOCK_SAVED_TUNED | profile)) {
+			EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_SPICLOCK + bus, (uint8_t)(SPI_CLOCK_SAVED_TUNED | profile));
+		}
+	}
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Switches a bus to a new rate at once and saves it for the next boot. The
+//! rate is self-tested while the bus is held (see SPIBusAcquire()), a rate
+//! that fails is not kept and the bus returns to its previous rate. A rate of
+//! 0 tunes the bus again, the result is saved as a tuned rate. If no profile
+//! passes the bus runs at its default rate and nothing is saved.
+//!
+//! \param bus SPI_CLOCK_BUS_EEPROM or SPI_CLOCK_BUS_ETHO
+//! \param rate a rate returned by SPIClockProfileRate() not above the
+//! device's rating, or 0 to tune the bus again
+//!
+//! \return Returns false if the rate is not a valid profile, failed the
+//! self-test (with 0, every profile failed) or could not be saved
+//
+//*****************************************************************************
+bool SPIClockSelect(uint8_t bus, uint32_t rate)
+{
+	uint32_t profile = SPI_CLOCK_PROFILE_COUNT;
+	uint32_t previous_rate;
+	SPIClockSource previous_source;
+	uint8_t saved = SPI_CLOCK_SAVED_NONE;
+	bool result = true;
+
+	if (bus >= SPI_CLOCK_BUS_COUNT || rate > SPIClockLimits[bus]) {
+		return false;
+	}
+	if (rate != 0) {
+		for (profile = 0; profile < SPI_CLOCK_PROFILE_COUNT && SPIClockProfileRate(profile) != rate; profile++);
+		if (profile == SPI_CLOCK_PROFILE_COUNT) {
+			return false;
+		}
+	}
+
+	//The test borrows the indirect data registers, keep other indirect accesses out
+	if (bus == SPI_CLOCK_BUS_ETHO) {
+		EthoIndirectLock();
+	}
+	if (!SPIBusAcquire(SPIClockBases[bus], SPI_ARBITER_TIMEOUT_MS)) {
+		if (bus == SPI_CLOCK_BUS_ETHO) {
+			EthoIndirectUnlock();
+		}
+		return false;
+	}
+	previous_rate = SPIClocks[bus].rate;
+	previous_source = SPIClocks[bus].source;
+	if (rate == 0) {
+		profile = SPIClockTune(bus);
+		if (profile != SPI_CLOCK_PROFILE_COUNT) {
+			saved = (uint8_t)(SPI_CLOCK_SAVED_TUNED | profile);
+		}
+		else {
+			//The bus is back at its default rate, keep the saved setting
+			result = false;
+		}
+	}
+	else {
+		SPIClockApply(bus, rate);
+		result = SPIClockTest(bus, profile);
+		if (result) {
+			SPIClocks[bus].passed |= (1 << profile);
+			SPIClocks[bus].source = SPIClockFixed;
+			saved = (uint8_t)(SPI_CLOCK_SAVED_FIXED | profile);
+		}
+		else {
+			SPIClockApply(bus, previous_rate);
+			SPIClocks[bus].source = previous_source;
+		}
+	}
+	SPIBusRelease(SPIClockBases[bus]);
+	if (bus == SPI_CLOCK_BUS_ETHO) {
+		EthoIndirectUnlock();
+	}
+
+	if (!result || !EEPROMSingleWrite(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_FIRMWARE_SPICLOCK + bus, saved)) {
+		return false;
+	}
+	SPIClocks[bus].selected = rate;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Copies the clock of a bus.
+//!
+//! \param bus SPI_CLOCK_BUS_EEPROM or SPI_CLOCK_BUS_ETHO
+//! \param info returns the clock
+//!
+//! \return Returns false if the bus is invalid
+//
+//*****************************************************************************
+bool SPIClockGet(uint8_t bus, SPIClockInfo *info)
+{
+	if (bus >= SPI_CLOCK_BUS_COUNT) {
+		return false;
+	}
+	*info = SPIClocks[bus];
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns the rate a profile really runs at with the current system clock.
+//!
+//! \param profile the profile (0 - SPI_CLOCK_PROFILE_COUNT - 1)
+//!
+//! \return Returns the rate in Hz, 0 if the profile is invalid
+//
+//*****************************************************************************
+uint32_t SPIClockProfileRate(uint32_t profile)
+{
+	return ((profile < SPI_CLOCK_PROFILE_COUNT) ? SPIClockActual(SPIClockRates[profile]) : 0);
+}
+
+//*****************************************************************************
+//
+//! Returns the name of a bus.
+//!
+//! \param bus the bus
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+const char *SPIClockBusName(uint8_t bus)
+{
+	return ((bus < SPI_CLOCK_BUS_COUNT) ? SPIClockBusNames[bus] : "unknown");
+}
@@ -0,0 +1,165 @@
+/**\file spi_clock.h
+ * \brief <b>SPI Clock Profiles and Self-Test</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef SPI_CLOCK_H_
+#define SPI_CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+//! SSI buses with a clock profile: SSI0 to the 25AA1024 EEPROM and SSI1 to
+//! the KSZ8895MLUB.
+//
+//*****************************************************************************
+#define SPI_CLOCK_BUS_EEPROM		0
+#define SPI_CLOCK_BUS_ETHO			1
+#define SPI_CLOCK_BUS_COUNT			2
+
+//*****************************************************************************
+//
+//! Clock rates that can be selected, fastest first. The SSI clock is the
+//! system clock divided by an even prescaler (CPSDVSR) and by 1 + SCR, so each
+//! of these divides the 80 MHz system clock. The rate really programmed is
+//! computed from SysCtlClockGet(), see SPIClockProfileRate().
+//
+//*****************************************************************************
+#define SPI_CLOCK_PROFILE_COUNT		6
+#define SPI_CLOCK_PROFILE_RATES		{10000000, 8000000, 5000000, 4000000, 2000000, 1000000}
+
+//*****************************************************************************
+//
+//! Conservative rates used until a profile has been verified and whenever
+//! the self-test fails, and the fastest rate each device is rated for. The
+//! 25AA1024 is rated for 10 MHz below 4.5 V.
+//
+//*****************************************************************************
+#define SPI_CLOCK_EEPROM_DEFAULT	1000000
+#define SPI_CLOCK_ETHO_DEFAULT		4000000
+#define SPI_CLOCK_EEPROM_MAX		10000000
+#define SPI_CLOCK_ETHO_MAX			12500000
+
+//*****************************************************************************
+//
+//! Number of times the test pattern must be read back intact for a rate to
+//! pass.
+//
+//*****************************************************************************
+#define SPI_CLOCK_TEST_PASSES		8
+
+//*****************************************************************************
+//
+//! \brief How the rate of a bus was chosen.
+//
+//*****************************************************************************
+typedef enum {
+	//! The conservative default, no profile passed or none was tested
+	SPIClockDefault,
+	//! The fastest profile that passed the self-test
+	SPIClockTuned,
+	//! A profile selected with "system spi-clock"
+	SPIClockFixed
+} SPIClockSource;
+
+//*****************************************************************************
+//
+//! \brief Clock of one bus, see SPIClockGet().
+//
+//*****************************************************************************
+typedef struct {
+	//! Rate in use in Hz
+	uint32_t rate;
+	SPIClockSource source;
+	//! Bit n set if profile n passed the self-test during this boot
+	uint32_t passed;
+	//! Rate selected with "system spi-clock" for the next boot in Hz, 0 if
+	//! the bus is tuned
+	uint32_t selected;
+} SPIClockInfo;
+
+//*****************************************************************************
+//
+//! Restores the saved rate of each bus or tunes it. A saved rate is checked
+//! with the same self-test; a tuned rate that fails is tuned again and a
+//! selected one that fails falls back to the default. Tuning writes the
+//! patterns at decreasing rates (the reserved EEPROM page EEPROM_SPI_TEST_PAGE
+//! and the indirect data registers of the KSZ8895MLUB) and keeps the fastest
+//! rate that passes. Must be called before the scheduler is started and
+//! before the EEPROM and the Ethernet Controller are otherwise used.
+//!
+//! \return Returns false if the self-test of a bus failed at every rate
+//
+//*****************************************************************************
+extern bool SPIClockInit(void);
+//*****************************************************************************
+//
+//! Switches a bus to a new rate at once and saves it for the next boot. The
+//! rate is self-tested while the bus is held (see SPIBusAcquire()), a rate
+//! that fails is not kept and the bus returns to its previous rate. A rate of
+//! 0 tunes the bus again, the result is saved as a tuned rate. If no profile
+//! passes the bus runs at its default rate and nothing is saved.
+//!
+//! \param bus SPI_CLOCK_BUS_EEPROM or SPI_CLOCK_BUS_ETHO
+//! \param rate a rate returned by SPIClockProfileRate() not above the
+//! device's rating, or 0 to tune the bus again
+//!
+//! \return Returns false if the rate is not a valid profile, failed the
+//! self-test (with 0, every profile failed) or could not be saved
+//
+//*****************************************************************************
+extern bool SPIClockSelect(uint8_t bus, uint32_t rate);
+//*****************************************************************************
+//
+//! Copies the clock of a bus.
+//!
+//! \param bus SPI_CLOCK_BUS_EEPROM or SPI_CLOCK_BUS_ETHO
+//! \param info returns the clock
+//!
+//! \return Returns false if the bus is invalid
+//
+//*****************************************************************************
+extern bool SPIClockGet(uint8_t bus, SPIClockInfo *info);
+//*****************************************************************************
+//
+//! Returns the rate a profile really runs at with the current system clock.
+//!
+//! \param profile the profile (0 - SPI_CLOCK_PROFILE_COUNT - 1)
+//!
+//! \return Returns the rate in Hz, 0 if the profile is invalid
+//
+//*****************************************************************************
+extern uint32_t SPIClockProfileRate(uint32_t profile);
+//*****************************************************************************
+//
+//! Returns the name of a bus as shown by "system show spi-clock".
+//!
+//! \param bus the bus
+//!
+//! \return Returns a pointer to the name
+//
+//*****************************************************************************
+extern const char *SPIClockBusName(uint8_t bus);
+
+#endif /* SPI_CLOCK_H_ */
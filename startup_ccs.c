@@ -30,7 +30,7 @@
 #include "task.h"
 #include "command_functions.h"
 #include "event_logger.h"
-#include "uartstdio.h"
+#include "console.h"
 
 //*****************************************************************************
 //
@@ -43,7 +43,6 @@ static void FaultISR(void);
 static void IntDefaultHandler(void);
 
 
-extern xQueueHandle g_pLoggerQueue;
 //*****************************************************************************
 //
 // External declaration for the reset handler that is to be called when the
@@ -67,9 +66,13 @@ extern uint32_t __STACK_TOP;
 extern void xPortPendSVHandler(void);
 extern void vPortSVCHandler(void);
 extern void xPortSysTickHandler(void);
-extern void UARTStdioIntHandler(void);
+extern void ConsoleUARTIntHandler(void);
 extern void I2C0SlaveIntHandler(void);
 extern void WatchdogIntHandler(void);
+extern void SSI0IntHandler(void);
+extern void SSI1IntHandler(void);
+extern void DelayTimerIntHandler(void);
+extern void LEDTimerIntHandler(void);
 //*****************************************************************************
 //
 // The vector table.  Note that the proper constructs must be placed on this to
@@ -103,8 +106,8 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port D
     IntDefaultHandler,                      // GPIO Port E
 	IntDefaultHandler,                      // UART0 Rx and Tx
-	UARTStdioIntHandler,                      // UART1 Rx and Tx
-    IntDefaultHandler,                      // SSI0 Rx and Tx
+	ConsoleUARTIntHandler,                    // UART1 Rx and Tx
+    SSI0IntHandler,                         // SSI0 Rx and Tx
 	I2C0SlaveIntHandler,                      // I2C0 Master and Slave
     IntDefaultHandler,                      // PWM Fault
     IntDefaultHandler,                      // PWM Generator 0
@@ -131,8 +134,8 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // GPIO Port G
     IntDefaultHandler,                      // GPIO Port H
     IntDefaultHandler,                      // UART2 Rx and Tx
-    IntDefaultHandler,                      // SSI1 Rx and Tx
-    IntDefaultHandler,                      // Timer 3 subtimer A
+    SSI1IntHandler,                         // SSI1 Rx and Tx
+    LEDTimerIntHandler,                     // Timer 3 subtimer A
     IntDefaultHandler,                      // Timer 3 subtimer B
     IntDefaultHandler,                      // I2C1 Master and Slave
     IntDefaultHandler,                      // Quadrature Encoder 1
@@ -167,7 +170,7 @@ void (* const g_pfnVectors[])(void) =
     0,                                      // Reserved
     IntDefaultHandler,                      // I2C2 Master and Slave
     IntDefaultHandler,                      // I2C3 Master and Slave
-    IntDefaultHandler,                      // Timer 4 subtimer A
+    DelayTimerIntHandler,                   // Timer 4 subtimer A
     IntDefaultHandler,                      // Timer 4 subtimer B
     0,                                      // Reserved
     0,                                      // Reserved
@@ -291,8 +294,8 @@ FaultISR(void)
     //
     // Enter an infinite loop.
     //
-	UARTprintf("\n\033[30;41m[ERROR]:\033[0m System encountered a fault. Currently paused for debugging!\n");
-	UARTFlushTx(false);
+	ConsolePrintfFromISR("\n\033[30;41m[ERROR]:\033[0m System encountered a fault. Currently paused for debugging!\n");
+	ConsoleFlushTx(false);
 
     while(1)
     {
@@ -0,0 +1,126 @@
+/**\file switch_batch.c
+ * \brief <b>Batched Switch Configuration</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "eee_hal.h"
+#include "vlan_table.h"
+#include "switch_batch.h"
+
+//*****************************************************************************
+//
+//! Command counts of the open batch. Only one task can have a batch open.
+//
+//*****************************************************************************
+static uint32_t SwitchBatchCommands = 0;
+static uint32_t SwitchBatchFailed = 0;
+
+//*****************************************************************************
+//
+//! Opens a batch for the calling task.
+//!
+//! \return Returns false if another task has a batch open, otherwise true
+//
+//*****************************************************************************
+bool SwitchBatchBegin(void)
+{
+	if (EthoBatchActive()) {
+		return true;
+	}
+	if (!EthoBatchBegin()) {
+		return false;
+	}
+	SwitchBatchCommands = 0;
+	SwitchBatchFailed = 0;
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Returns true if the calling task has a batch open.
+//!
+//! \return Returns true if the calling task has a batch open
+//
+//*****************************************************************************
+bool SwitchBatchActive(void)
+{
+	return EthoBatchActive();
+}
+
+//*****************************************************************************
+//
+//! Counts a command run inside the calling task's batch.
+//!
+//! \param result the result of the command
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void SwitchBatchRecord(bool result)
+{
+	if (!EthoBatchActive()) {
+		return;
+	}
+	SwitchBatchCommands++;
+	if (!result) {
+		SwitchBatchFailed++;
+	}
+}
+
+//*****************************************************************************
+//
+//! Closes the calling task's batch and writes what it changed.
+//!
+//! \param result returns the aggregated result of the batch (may be NULL)
+//!
+//! \return Returns true if every command and every write succeeded
+//
+//*****************************************************************************
+bool SwitchBatchCommit(SwitchBatchResult *result)
+{
+	SwitchBatchResult summary;
+	uint32_t start = DelayTimebaseUs();
+	bool success;
+
+	memset(&summary, 0, sizeof(summary));
+	if (!EthoBatchActive()) {
+		if (result) {
+			*result = summary;
+		}
+		return false;
+	}
+	summary.commands = SwitchBatchCommands;
+	summary.failed = SwitchBatchFailed;
+
+	//The VLAN table first, so that VLANs staged together with 802.1Q mode are in place when it is enabled
+	success = VLANBatchCommit(&summary.vlan_groups);
+	success &= EthoBatchCommit(&summary.registers, &summary.bursts);
+	summary.commit_us = DelayTimebaseUs() - start;
+
+	if (result) {
+		*result = summary;
+	}
+	return (success && summary.failed == 0);
+}
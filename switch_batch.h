@@ -0,0 +1,93 @@
+/**\file switch_batch.h
+ * \brief <b>Batched Switch Configuration</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef SWITCH_BATCH_H_
+#define SWITCH_BATCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+//! \brief Aggregated result of a batch, filled in by SwitchBatchCommit().
+//
+//*****************************************************************************
+typedef struct {
+	//! Number of commands run inside the batch
+	uint32_t commands;
+	//! Number of those commands that failed
+	uint32_t failed;
+	//! Number of registers written when the batch was committed
+	uint32_t registers;
+	//! Number of SPI bursts used to write them
+	uint32_t bursts;
+	//! Number of VLAN table groups written
+	uint32_t vlan_groups;
+	//! Time taken to commit the batch in microseconds
+	uint32_t commit_us;
+} SwitchBatchResult;
+
+//*****************************************************************************
+//
+//! Opens a batch for the calling task. Until SwitchBatchCommit() the task's
+//! register writes are staged in the register shadow and its VLAN changes in
+//! the RAM membership map, so that several writes to the same register or
+//! VLAN group cost a single write when the batch is committed.
+//!
+//! \return Returns false if another task has a batch open, otherwise true
+//
+//*****************************************************************************
+extern bool SwitchBatchBegin(void);
+
+//*****************************************************************************
+//
+//! Returns true if the calling task has a batch open.
+//
+//*****************************************************************************
+extern bool SwitchBatchActive(void);
+
+//*****************************************************************************
+//
+//! Counts a command run inside the calling task's batch.
+//!
+//! \param result the result of the command
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void SwitchBatchRecord(bool result);
+
+//*****************************************************************************
+//
+//! Closes the calling task's batch. Changed VLAN groups are written first,
+//! then every staged register in as few bursts as possible.
+//!
+//! \param result returns the aggregated result of the batch (may be NULL)
+//!
+//! \return Returns true if every command and every write succeeded
+//
+//*****************************************************************************
+extern bool SwitchBatchCommit(SwitchBatchResult *result);
+
+#endif /* SWITCH_BATCH_H_ */
@@ -0,0 +1,790 @@
+/**\file vlan_table.c
+ * \brief <b>KSZ8895MLUB VLAN Table Engine and RAM Membership Map</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_types.h"
+#include "eee_hal.h"
+#include "interpreter_task.h"
+#include "freertos_init.h"
+#include "vlan_table.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+//*****************************************************************************
+//
+//! RAM membership map for the whole VLAN table. Each group of four VLANs is
+//! packed into VLAN_MAP_GROUP_BYTES bytes so that 4096 entries cost 3KB
+//! of SRAM. Entry N of a group occupies bits (6*N + 5) - (6*N) of the group's
+//! 24-bit word: bit 5 = valid, bits 4-0 = port membership.
+//
+//*****************************************************************************
+static uint8_t VLANMap[VLAN_GROUP_COUNT * VLAN_MAP_GROUP_BYTES];
+
+//*****************************************************************************
+//
+//! Groups changed in the RAM membership map during a batch (see
+//! EthoBatchBegin()) that still have to be written by VLANBatchCommit().
+//
+//*****************************************************************************
+static uint32_t VLANBatchPending[VLAN_GROUP_COUNT / 32];
+
+//*****************************************************************************
+//
+//! True while the Ethernet Controller still holds the empty VLAN table it
+//! powered up with (see VLANTablePowerOn()). Cleared by the first write.
+//
+//*****************************************************************************
+static bool VLANTableEmpty = false;
+
+//*****************************************************************************
+//
+//! Packed map entry fields.
+//
+//*****************************************************************************
+#define VLAN_MAP_ENTRY_BITS 		6
+#define VLAN_MAP_ENTRY_VALID 		0x20
+#define VLAN_MAP_ENTRY_MASK 		0x3F
+
+//*****************************************************************************
+//
+//! Size of the legacy VLAN image area at EEPROM_VLAN_TABLE_BASE (0x200 - 0x11FF).
+//
+//*****************************************************************************
+#define VLAN_IMAGE_AREA_SIZE 		0x1000
+
+//*****************************************************************************
+//
+//! Legacy (dense) image layout: one byte per VLAN ID starting at VLAN 1.
+//! Bit 7 = valid, bits 6-2 = port membership, bits 1-0 always clear.
+//
+//*****************************************************************************
+#define VLAN_IMAGE_VALID 			0x80
+#define VLAN_IMAGE_MEMBERSHIP_SHIFT	2
+#define VLAN_IMAGE_ENTRIES 			(VLAN_TABLE_SIZE - 1)
+
+//*****************************************************************************
+//
+//! State of the sparse image being rendered by VLANImageRender().
+//
+//*****************************************************************************
+static struct {
+	//! Header of the image, filled in by VLANImageBegin()
+	uint8_t header[VLAN_SPARSE_HEADER_SIZE];
+	//! Record currently being rendered
+	uint8_t record[VLAN_SPARSE_RECORD_SIZE];
+	//! Total length of the image in bytes
+	uint32_t length;
+	//! Offset of the next byte to render
+	uint32_t offset;
+	//! Next VLAN to look for when starting a record
+	uint32_t vlan_id;
+} VLANRender;
+
+//*****************************************************************************
+//
+//! State of the sparse image being parsed by VLANImageLoad().
+//
+//*****************************************************************************
+static struct {
+	//! Header of the image as received
+	uint8_t header[VLAN_SPARSE_HEADER_SIZE];
+	//! Record currently being received
+	uint8_t record[VLAN_SPARSE_RECORD_SIZE];
+	//! Largest image accepted, in bytes
+	uint32_t max_length;
+	//! Total length of the image in bytes, known once the header is in
+	uint32_t length;
+	//! Number of bytes received so far
+	uint32_t received;
+	//! Running CRC of the header and records
+	uint32_t crc;
+	//! Set once the header or a record has been rejected
+	bool failed;
+} VLANLoader;
+
+//*****************************************************************************
+//
+//! Returns the packed 24-bit map word for a group.
+//!
+//! \param group the indirect table entry (0 - 1023)
+//!
+//! \return Returns the four 6-bit entries of the group
+//
+//*****************************************************************************
+static uint32_t VLANMapGetGroup(uint32_t group)
+{
+	const uint8_t *p = &VLANMap[group * VLAN_MAP_GROUP_BYTES];
+	return (p[0]) | (p[1] << 8) | (p[2] << 16);
+}
+
+//*****************************************************************************
+//
+//! Stores the packed 24-bit map word for a group.
+//!
+//! \param group the indirect table entry (0 - 1023)
+//! \param word the four 6-bit entries of the group
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void VLANMapSetGroup(uint32_t group, uint32_t word)
+{
+	uint8_t *p = &VLANMap[group * VLAN_MAP_GROUP_BYTES];
+	p[0] = word & 0xFF;
+	p[1] = (word >> 8) & 0xFF;
+	p[2] = (word >> 16) & 0xFF;
+}
+
+//*****************************************************************************
+//
+//! Gives lower priority tasks a chance to run during long table operations.
+//! Does nothing before the scheduler has been started.
+//!
+//! \param group the group that was just processed
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void VLANTableYield(uint32_t group)
+{
+	if (((group + 1) % VLAN_YIELD_INTERVAL) == 0 && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		vTaskDelay(1);
+	}
+}
+
+//*****************************************************************************
+//
+//! Selects a VLAN table group and starts an indirect read or write. Both
+//! access control registers are written in one auto-incremented transfer;
+//! writing INDIRECT_ACCESS_CONTROL_1 triggers the operation.
+//!
+//! \param group the indirect table entry (0 - 1023)
+//! \param read_type INDIRECT_READTYPE_READ or INDIRECT_READTYPE_WRITE
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool VLANGroupAccess(uint32_t group, uint32_t read_type)
+{
+	uint32_t control[2];
+
+	control[0] = (INDIRECT_TABLESELECT_VLAN << INDIRECT_CONTROL_TABLESELECT) | (read_type << INDIRECT_CONTROL_READTYPEBIT) | (((group >> 8) & 0x03) << INDIRECT_CONTROL_ADDRESS_HIGH);
+	control[1] = (group & 0xFF);
+
+	return EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_ACCESS_CONTROL_0, 2, control);
+}
+
+//*****************************************************************************
+//
+//! Reads the raw 56-bit contents of a VLAN table group from the Ethernet
+//! Controller with one indirect read and one bulk register read.
+//!
+//! \param group the indirect table entry (0 - 1023)
+//! \param value returns bits 55-0 of the group
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool VLANGroupRead(uint32_t group, uint64_t *value)
+{
+	uint32_t data[7];
+	bool result;
+	int i;
+
+	EthoIndirectLock();
+	//INDIRECT_REGISTER_DATA_6 (bits 55-48) through INDIRECT_REGISTER_DATA_0 (bits 7-0)
+	result = VLANGroupAccess(group, INDIRECT_READTYPE_READ) &&
+			EthoControllerBulkRead(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_6, 7, data);
+	EthoIndirectUnlock();
+	if (!result) {
+		return false;
+	}
+
+	*value = 0;
+	for (i = 0; i < 7; i++) {
+		*value = (*value << 8) | (data[i] & 0xFF);
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Writes the raw 56-bit contents of a VLAN table group to the Ethernet
+//! Controller. The data registers are loaded first, then the write is
+//! triggered through the access control registers.
+//!
+//! \param group the indirect table entry (0 - 1023)
+//! \param value bits 55-0 of the group
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool VLANGroupWrite(uint32_t group, uint64_t value)
+{
+	uint32_t data[7];
+	bool result;
+	int i;
+
+	for (i = 6; i >= 0; i--) {
+		data[i] = (uint32_t)(value & 0xFF);
+		value >>= 8;
+	}
+	VLANTableEmpty = false;
+	EthoIndirectLock();
+	result = EthoControllerBulkWrite(ETHO_1_BASE_ADDR, ETHO_1_SSI_CS_BASE, ETHO_1_SSI_CS_PIN, INDIRECT_REGISTER_DATA_6, 7, data) &&
+			VLANGroupAccess(group, INDIRECT_READTYPE_WRITE);
+	EthoIndirectUnlock();
+	return result;
+}
+
+//*****************************************************************************
+//
+//! Unpacks all four entries of a raw group into a packed map word.
+//!
+//! \param value bits 55-0 of the group as read from the Ethernet Controller
+//!
+//! \return Returns the four 6-bit map entries of the group
+//
+//*****************************************************************************
+static uint32_t VLANGroupToMap(uint64_t value)
+{
+	uint32_t word = 0, entry;
+	int i;
+
+	for (i = 0; i < VLAN_GROUP_SIZE; i++) {
+		entry = (uint32_t)(value >> (VLAN_ENTRY_BITS * i));
+		word |= ((((entry & VLAN_ENTRY_VALID) ? VLAN_MAP_ENTRY_VALID : 0) | ((entry >> VLAN_ENTRY_MEMBERSHIP_SHIFT) & VLAN_ENTRY_MEMBERSHIP_MASK)) << (VLAN_MAP_ENTRY_BITS * i));
+	}
+	return word;
+}
+
+//*****************************************************************************
+//
+//! Packs a map word into a raw group. Filter IDs and the unused upper bits of
+//! the group are taken from the existing contents so they are preserved.
+//!
+//! \param value existing bits 55-0 of the group
+//! \param word the four 6-bit map entries of the group
+//!
+//! \return Returns the new bits 55-0 of the group
+//
+//*****************************************************************************
+static uint64_t VLANMapToGroup(uint64_t value, uint32_t word)
+{
+	uint64_t field;
+	uint32_t entry;
+	int i;
+
+	for (i = 0; i < VLAN_GROUP_SIZE; i++) {
+		entry = (word >> (VLAN_MAP_ENTRY_BITS * i)) & VLAN_MAP_ENTRY_MASK;
+		field = ((entry & VLAN_MAP_ENTRY_VALID) ? VLAN_ENTRY_VALID : 0) | ((entry & VLAN_ENTRY_MEMBERSHIP_MASK) << VLAN_ENTRY_MEMBERSHIP_SHIFT);
+
+		value &= ~((uint64_t)(VLAN_ENTRY_VALID | (VLAN_ENTRY_MEMBERSHIP_MASK << VLAN_ENTRY_MEMBERSHIP_SHIFT)) << (VLAN_ENTRY_BITS * i));
+		value |= field << (VLAN_ENTRY_BITS * i);
+	}
+	return value;
+}
+
+//*****************************************************************************
+//
+//! Reads a group from the Ethernet Controller, merges the map word for it and
+//! writes it back.
+//!
+//! \param group the indirect table entry (0 - 1023)
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool VLANGroupCommit(uint32_t group)
+{
+	uint64_t value;
+
+	if (!VLANGroupRead(group, &value)) {
+		return false;
+	}
+	return VLANGroupWrite(group, VLANMapToGroup(value, VLANMapGetGroup(group)));
+}
+
+//*****************************************************************************
+//
+//! Sets one VLAN in the RAM membership map without touching the Ethernet
+//! Controller.
+//!
+//! \param vlan_id the VLAN to change (1 - 4095)
+//! \param valid true if the entry is valid (active)
+//! \param membership the 5-bit port membership mask
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void VLANMapSetEntry(uint32_t vlan_id, bool valid, uint8_t membership)
+{
+	uint32_t group = vlan_id / VLAN_GROUP_SIZE;
+	uint32_t shift = VLAN_MAP_ENTRY_BITS * (vlan_id % VLAN_GROUP_SIZE);
+	uint32_t word = VLANMapGetGroup(group);
+
+	word &= ~(VLAN_MAP_ENTRY_MASK << shift);
+	word |= ((valid ? VLAN_MAP_ENTRY_VALID : 0) | (membership & VLAN_ENTRY_MEMBERSHIP_MASK)) << shift;
+	VLANMapSetGroup(group, word);
+}
+
+//*****************************************************************************
+//
+//! Clears the RAM membership map.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void VLANMapClear(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < sizeof(VLANMap); i++) {
+		VLANMap[i] = 0;
+	}
+}
+
+//*****************************************************************************
+//
+//! Builds the sparse image record for a VLAN.
+//!
+//! \param vlan_id the VLAN (1 - 4095)
+//! \param membership the 5-bit port membership mask
+//! \param record returns the VLAN_SPARSE_RECORD_SIZE byte record
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+static void VLANSparseRecord(uint32_t vlan_id, uint8_t membership, uint8_t *record)
+{
+	record[0] = (vlan_id >> 8) & 0x0F;
+	record[1] = vlan_id & 0xFF;
+	record[2] = membership & VLAN_ENTRY_MEMBERSHIP_MASK;
+}
+
+//*****************************************************************************
+//
+//! Loads the RAM membership map from a legacy dense image, one page at a time.
+//!
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+static bool VLANDenseLoad(uint8_t *buffer)
+{
+	uint32_t index, length, i;
+
+	for (index = 0; index < VLAN_IMAGE_ENTRIES; index += EEPROM_PAGE_SIZE) {
+		length = ((VLAN_IMAGE_ENTRIES - index) < EEPROM_PAGE_SIZE) ? (VLAN_IMAGE_ENTRIES - index) : EEPROM_PAGE_SIZE;
+		if (!EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, (EEPROM_VLAN_TABLE_BASE + index), buffer, length)) {
+			return false;
+		}
+		for (i = 0; i < length; i++) {
+			if (buffer[i] & VLAN_IMAGE_VALID) {
+				VLANMapSetEntry(index + i + 1, true, (buffer[i] >> VLAN_IMAGE_MEMBERSHIP_SHIFT));
+			}
+		}
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Programs the Ethernet Controller from the RAM membership map. Groups with
+//! an active VLAN are merged and written; empty groups are only read and are
+//! cleared if the controller still holds entries from before the restart.
+//! After a power-on reset nothing can be left over, empty groups are skipped.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool VLANTableProgram(void)
+{
+	uint64_t value;
+	uint32_t group;
+	bool sweep = !VLANTableEmpty;
+
+	for (group = 0; group < VLAN_GROUP_COUNT; group++) {
+		if (!sweep && VLANMapGetGroup(group) == 0) {
+			continue;
+		}
+		if (!VLANGroupRead(group, &value)) {
+			return false;
+		}
+		if (VLANMapGetGroup(group) != 0 || VLANGroupToMap(value) != 0) {
+			if (!VLANGroupWrite(group, VLANMapToGroup(value, VLANMapGetGroup(group)))) {
+				return false;
+			}
+		}
+		VLANTableYield(group);
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Records that the Ethernet Controller was powered up together with the MCU,
+//! so its VLAN table holds no entries until the first write.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void VLANTablePowerOn(void)
+{
+	VLANTableEmpty = true;
+}
+
+//*****************************************************************************
+//
+//! Reads the whole VLAN table from the Ethernet Controller into the RAM
+//! membership map, one indirect read per group of four VLANs. After a
+//! power-on reset the table is known to be empty and is not read.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool VLANTableLoad(void)
+{
+	uint64_t value;
+	uint32_t group;
+
+	if (VLANTableEmpty) {
+		VLANMapClear();
+		return true;
+	}
+	for (group = 0; group < VLAN_GROUP_COUNT; group++) {
+		if (!VLANGroupRead(group, &value)) {
+			return false;
+		}
+		VLANMapSetGroup(group, VLANGroupToMap(value));
+		VLANTableYield(group);
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Fills the RAM membership map from the legacy VLAN image area at
+//! EEPROM_VLAN_TABLE_BASE and programs the Ethernet Controller from it. Both
+//! the sparse layout and the older dense layout (one byte per VLAN) are
+//! accepted. Sparse images are read up to their last record and checked
+//! against their CRC.
+//!
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool VLANTableRestore(uint8_t *buffer)
+{
+	uint32_t offset;
+
+	VLANMapClear();
+
+	if (!EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, EEPROM_VLAN_TABLE_BASE, buffer, EEPROM_PAGE_SIZE)) {
+		return false;
+	}
+	if (buffer[0] == VLAN_SPARSE_MAGIC_0) {
+		//Feed whole pages, VLANImageLoad() ignores anything past the last record
+		VLANImageLoadBegin(VLAN_IMAGE_AREA_SIZE);
+		for (offset = 0; VLANImageLoadPending() != 0 && offset < VLAN_IMAGE_AREA_SIZE; offset += EEPROM_PAGE_SIZE) {
+			if (offset != 0 && !EEPROMBulkRead(EEPROM_BASE_ADDR, EEPROM_SSI_CS_BASE, EEPROM_SSI_CS_PIN, (EEPROM_VLAN_TABLE_BASE + offset), buffer, EEPROM_PAGE_SIZE)) {
+				return false;
+			}
+			VLANImageLoad(buffer, EEPROM_PAGE_SIZE);
+		}
+		if (!VLANImageLoadEnd()) {
+			return false;
+		}
+	}
+	else if (!VLANDenseLoad(buffer)) {
+		return false;
+	}
+
+	return VLANTableProgram();
+}
+
+//*****************************************************************************
+//
+//! Starts rendering the RAM membership map as a sparse image. Works out the
+//! record count and CRC so that the header can be rendered first.
+//!
+//! \return Returns the length of the image in bytes
+//
+//*****************************************************************************
+uint32_t VLANImageBegin(void)
+{
+	uint8_t membership;
+	uint32_t vlan_id, count = 0, crc;
+
+	for (vlan_id = 1; vlan_id < VLAN_TABLE_SIZE; vlan_id++) {
+		if (VLANGetEntry(vlan_id, NULL)) {
+			count++;
+		}
+	}
+
+	VLANRender.header[0] = VLAN_SPARSE_MAGIC_0;
+	VLANRender.header[1] = VLAN_SPARSE_MAGIC_1;
+	VLANRender.header[2] = VLAN_SPARSE_VERSION;
+	VLANRender.header[3] = 0x00;
+	VLANRender.header[4] = (count >> 8) & 0xFF;
+	VLANRender.header[5] = count & 0xFF;
+
+	crc = EEPROMCrc32(EEPROM_CRC32_INIT, VLANRender.header, VLAN_SPARSE_CRC_OFFSET);
+	for (vlan_id = 1; vlan_id < VLAN_TABLE_SIZE; vlan_id++) {
+		if (VLANGetEntry(vlan_id, &membership)) {
+			VLANSparseRecord(vlan_id, membership, VLANRender.record);
+			crc = EEPROMCrc32(crc, VLANRender.record, VLAN_SPARSE_RECORD_SIZE);
+		}
+	}
+	crc ^= EEPROM_CRC32_INIT;
+	VLANRender.header[6] = (crc >> 24) & 0xFF;
+	VLANRender.header[7] = (crc >> 16) & 0xFF;
+	VLANRender.header[8] = (crc >> 8) & 0xFF;
+	VLANRender.header[9] = crc & 0xFF;
+
+	VLANRender.length = VLAN_SPARSE_HEADER_SIZE + (count * VLAN_SPARSE_RECORD_SIZE);
+	VLANRender.offset = 0;
+	VLANRender.vlan_id = 1;
+	return VLANRender.length;
+}
+
+//*****************************************************************************
+//
+//! Renders the next bytes of the sparse image started by VLANImageBegin().
+//!
+//! \param buffer pointer-to-array of at least length bytes
+//! \param length the largest number of bytes to render
+//!
+//! \return Returns the number of bytes rendered, 0 once the image is complete
+//
+//*****************************************************************************
+uint32_t VLANImageRender(uint8_t *buffer, uint32_t length)
+{
+	uint32_t count = 0, index;
+	uint8_t membership = 0;
+
+	while (count < length && VLANRender.offset < VLANRender.length) {
+		if (VLANRender.offset < VLAN_SPARSE_HEADER_SIZE) {
+			buffer[count++] = VLANRender.header[VLANRender.offset++];
+			continue;
+		}
+		index = (VLANRender.offset - VLAN_SPARSE_HEADER_SIZE) % VLAN_SPARSE_RECORD_SIZE;
+		if (index == 0) {
+			while (VLANRender.vlan_id < VLAN_TABLE_SIZE && !VLANGetEntry(VLANRender.vlan_id, &membership)) {
+				VLANRender.vlan_id++;
+			}
+			VLANSparseRecord(VLANRender.vlan_id, membership, VLANRender.record);
+			VLANRender.vlan_id++;
+		}
+		buffer[count++] = VLANRender.record[index];
+		VLANRender.offset++;
+	}
+	return count;
+}
+
+//*****************************************************************************
+//
+//! Clears the RAM membership map and prepares to receive a sparse image.
+//!
+//! \param max_length the largest image accepted, in bytes
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+void VLANImageLoadBegin(uint32_t max_length)
+{
+	VLANMapClear();
+	VLANLoader.max_length = max_length;
+	VLANLoader.length = VLAN_SPARSE_HEADER_SIZE;
+	VLANLoader.received = 0;
+	VLANLoader.failed = false;
+}
+
+//*****************************************************************************
+//
+//! Feeds the next bytes of a sparse image into the RAM membership map. Bytes
+//! past the end of the image are ignored.
+//!
+//! \param data pointer-to-array of image bytes
+//! \param length the number of bytes in data
+//!
+//! \return Returns false once the image has been rejected, otherwise true
+//
+//*****************************************************************************
+bool VLANImageLoad(const uint8_t *data, uint32_t length)
+{
+	uint32_t index, count, vlan_id;
+
+	while (length-- && !VLANLoader.failed && VLANLoader.received < VLANLoader.length) {
+		if (VLANLoader.received < VLAN_SPARSE_HEADER_SIZE) {
+			VLANLoader.header[VLANLoader.received++] = *data++;
+			if (VLANLoader.received == VLAN_SPARSE_HEADER_SIZE) {
+				count = (VLANLoader.header[4] << 8) | VLANLoader.header[5];
+				VLANLoader.length = VLAN_SPARSE_HEADER_SIZE + (count * VLAN_SPARSE_RECORD_SIZE);
+				VLANLoader.failed = (VLANLoader.header[0] != VLAN_SPARSE_MAGIC_0 || VLANLoader.header[1] != VLAN_SPARSE_MAGIC_1 ||
+									 VLANLoader.header[2] != VLAN_SPARSE_VERSION || count >= VLAN_TABLE_SIZE || VLANLoader.length > VLANLoader.max_length);
+				VLANLoader.crc = EEPROMCrc32(EEPROM_CRC32_INIT, VLANLoader.header, VLAN_SPARSE_CRC_OFFSET);
+			}
+			continue;
+		}
+		index = (VLANLoader.received - VLAN_SPARSE_HEADER_SIZE) % VLAN_SPARSE_RECORD_SIZE;
+		VLANLoader.record[index] = *data++;
+		VLANLoader.received++;
+		if (index == (VLAN_SPARSE_RECORD_SIZE - 1)) {
+			VLANLoader.crc = EEPROMCrc32(VLANLoader.crc, VLANLoader.record, VLAN_SPARSE_RECORD_SIZE);
+			vlan_id = (VLANLoader.record[0] << 8) | VLANLoader.record[1];
+			if (vlan_id != 0 && vlan_id < VLAN_TABLE_SIZE) {
+				VLANMapSetEntry(vlan_id, true, VLANLoader.record[2]);
+			}
+		}
+	}
+	return !VLANLoader.failed;
+}
+
+//*****************************************************************************
+//
+//! Returns the number of bytes VLANImageLoad() still expects. Until the
+//! header has been received only the header length is known.
+//!
+//! \return Returns the number of bytes still expected, 0 once complete or rejected
+//
+//*****************************************************************************
+uint32_t VLANImageLoadPending(void)
+{
+	if (VLANLoader.failed) {
+		return 0;
+	}
+	return VLANLoader.length - VLANLoader.received;
+}
+
+//*****************************************************************************
+//
+//! Finishes a sparse image load. The RAM membership map is cleared again if
+//! the image was incomplete, rejected or failed its CRC check. The Ethernet
+//! Controller is not accessed, see VLANTableProgram().
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool VLANImageLoadEnd(void)
+{
+	uint8_t *header = VLANLoader.header;
+
+	if (VLANLoader.failed || VLANLoader.received < VLAN_SPARSE_HEADER_SIZE || VLANLoader.received < VLANLoader.length ||
+		(VLANLoader.crc ^ EEPROM_CRC32_INIT) != (((uint32_t)header[6] << 24) | (header[7] << 16) | (header[8] << 8) | header[9])) {
+		VLANMapClear();
+		return false;
+	}
+	return true;
+}
+
+//*****************************************************************************
+//
+//! Reads the membership of a VLAN from the RAM membership map.
+//!
+//! \param vlan_id the VLAN to look up (1 - 4095)
+//! \param membership returns the 5-bit port membership mask (may be NULL)
+//!
+//! \return Returns true if the VLAN entry is valid (active), otherwise false
+//
+//*****************************************************************************
+bool VLANGetEntry(uint32_t vlan_id, uint8_t *membership)
+{
+	uint32_t entry;
+
+	if (vlan_id == 0 || vlan_id >= VLAN_TABLE_SIZE) {
+		return false;
+	}
+	entry = (VLANMapGetGroup(vlan_id / VLAN_GROUP_SIZE) >> (VLAN_MAP_ENTRY_BITS * (vlan_id % VLAN_GROUP_SIZE))) & VLAN_MAP_ENTRY_MASK;
+	if (membership) {
+		*membership = entry & VLAN_ENTRY_MEMBERSHIP_MASK;
+	}
+	return (entry & VLAN_MAP_ENTRY_VALID) != 0;
+}
+
+//*****************************************************************************
+//
+//! Updates a VLAN in the RAM membership map and writes its group back to the
+//! Ethernet Controller with a single indirect read-modify-write. The filter
+//! IDs of all four entries are preserved.
+//!
+//! \param vlan_id the VLAN to change (1 - 4095)
+//! \param valid true if the entry is valid (active)
+//! \param membership the 5-bit port membership mask
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool VLANSetEntry(uint32_t vlan_id, bool valid, uint8_t membership)
+{
+	uint32_t group = vlan_id / VLAN_GROUP_SIZE;
+
+	if (vlan_id == 0 || vlan_id >= VLAN_TABLE_SIZE) {
+		return false;
+	}
+	VLANMapSetEntry(vlan_id, valid, membership);
+
+	//Inside a batch the group is written once by VLANBatchCommit()
+	if (EthoBatchActive()) {
+		VLANBatchPending[group / 32] |= (1 << (group % 32));
+		return true;
+	}
+	return VLANGroupCommit(group);
+}
+
+//*****************************************************************************
+//
+//! Writes every group changed by VLANSetEntry() during the calling task's
+//! batch, once per group however many of its VLANs were changed.
+//!
+//! \param groups returns the number of groups written (may be NULL)
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+bool VLANBatchCommit(uint32_t *groups)
+{
+	uint32_t group, written = 0;
+	bool result = true;
+
+	for (group = 0; group < VLAN_GROUP_COUNT; group++) {
+		if (VLANBatchPending[group / 32] == 0) {
+			group += 31;
+			continue;
+		}
+		if ((VLANBatchPending[group / 32] >> (group % 32)) & 1) {
+			VLANBatchPending[group / 32] &= ~(1 << (group % 32));
+			result &= VLANGroupCommit(group);
+			written++;
+		}
+	}
+	if (groups) {
+		*groups = written;
+	}
+	return result;
+}
@@ -0,0 +1,245 @@
+/**\file vlan_table.h
+ * \brief <b>KSZ8895MLUB VLAN Table Engine and RAM Membership Map</b>
+ *
+ *
+ *  Created on: Oct 14, 2026
+ *      Copyright (c) 2016 Christopher R. Miller, Kevin Schmidgall, William Nault, Colton Schimank, Mike Willey,
+ *      Dr. Joseph Morgan and the Mobile Integrated Solutions Laboratory
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a
+ *      copy of this software and associated documentation files (the "Software"),
+ *      to deal in the Software without restriction, including without limitation
+ *      the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *      and/or sell copies of the Software, and to permit persons to whom the Software
+ *      is furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ *      BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ *      IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *      WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ *      SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ ******************************************************************************************************************************************/
+
+#ifndef VLAN_TABLE_H_
+#define VLAN_TABLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+//! Number of VLAN IDs in the KSZ8895MLUB VLAN table and number of indirect
+//! table entries (groups) they are stored in. Each group holds four VLANs.
+//
+//*****************************************************************************
+#define VLAN_TABLE_SIZE 			4096
+#define VLAN_GROUP_SIZE 			4
+#define VLAN_GROUP_COUNT 			(VLAN_TABLE_SIZE / VLAN_GROUP_SIZE)
+//*****************************************************************************
+//
+//! Bytes of membership map used per group: four 6-bit entries (valid bit and
+//! 5-bit port mask) packed into 24 bits.
+//
+//*****************************************************************************
+#define VLAN_MAP_GROUP_BYTES 		3
+//*****************************************************************************
+//
+//! Number of groups processed between yields during full table operations so
+//! that lower priority tasks keep running.
+//
+//*****************************************************************************
+#define VLAN_YIELD_INTERVAL 		64
+
+//*****************************************************************************
+//
+//! Layout of a single 13-bit VLAN table entry on the KSZ8895MLUB. <br>
+//! Bit 12 = entry valid <br>
+//! Bits 11-7 = port membership (bit 7 = port 1 ... bit 11 = port 5) <br>
+//! Bits 6-0 = filter ID <br>
+//!
+//! Entry N of a group sits at bits (13*N + 12) - (13*N) of the 56-bit value held
+//! in INDIRECT_REGISTER_DATA_6 (bits 55-48) to INDIRECT_REGISTER_DATA_0 (bits 7-0).
+//
+//*****************************************************************************
+#define VLAN_ENTRY_BITS 			13
+#define VLAN_ENTRY_VALID 			(1 << 12)
+#define VLAN_ENTRY_MEMBERSHIP_SHIFT	7
+#define VLAN_ENTRY_MEMBERSHIP_MASK	0x1F
+
+//*****************************************************************************
+//
+//! Sparse VLAN image layout. <br>
+//! Header: 'V', 'L', version, reserved, record count (MSB first), CRC-32
+//! (MSB first) of the first six header bytes and all records. <br>
+//! Record: VLAN ID bits 11-8, VLAN ID bits 7-0, port membership. Records are
+//! sorted by VLAN ID and only active VLANs are stored. <br>
+//!
+//! The first magic byte has bit 1 set, which no byte of a legacy dense image
+//! can have, so the two layouts are told apart by the first byte alone.
+//
+//*****************************************************************************
+#define VLAN_SPARSE_MAGIC_0 		0x56
+#define VLAN_SPARSE_MAGIC_1 		0x4C
+#define VLAN_SPARSE_VERSION 		1
+#define VLAN_SPARSE_HEADER_SIZE		10
+#define VLAN_SPARSE_CRC_OFFSET		6
+#define VLAN_SPARSE_RECORD_SIZE		3
+#define VLAN_SPARSE_MAX_SIZE		(VLAN_SPARSE_HEADER_SIZE + ((VLAN_TABLE_SIZE - 1) * VLAN_SPARSE_RECORD_SIZE))
+
+//*****************************************************************************
+//
+// Prototypes for the VLAN table engine.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Reads the whole VLAN table from the Ethernet Controller into the RAM
+//! membership map, one indirect read per group of four VLANs. After a
+//! power-on reset the table is known to be empty and is not read.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool VLANTableLoad(void);
+
+//*****************************************************************************
+//
+//! Fills the RAM membership map from the legacy VLAN image area at
+//! EEPROM_VLAN_TABLE_BASE and programs the Ethernet Controller from it. Both
+//! the sparse layout and the older dense layout (one byte per VLAN) are
+//! accepted. Only used when no configuration store generation exists.
+//!
+//! \param buffer scratch buffer of at least EEPROM_PAGE_SIZE bytes
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool VLANTableRestore(uint8_t *buffer);
+
+//*****************************************************************************
+//
+//! Programs the Ethernet Controller from the RAM membership map, writing only
+//! the groups that hold an active VLAN or still hold stale entries. After a
+//! power-on reset only the groups with an active VLAN are accessed.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool VLANTableProgram(void);
+
+//*****************************************************************************
+//
+//! Records that the Ethernet Controller was powered up together with the MCU,
+//! so its VLAN table holds no entries until the first write. Called from
+//! main() after a power-on reset, before the table is programmed.
+//!
+//! \return Returns void
+//
+//*****************************************************************************
+extern void VLANTablePowerOn(void);
+
+//*****************************************************************************
+//
+//! Starts rendering the RAM membership map as a sparse image.
+//!
+//! \return Returns the length of the image in bytes
+//
+//*****************************************************************************
+extern uint32_t VLANImageBegin(void);
+
+//*****************************************************************************
+//
+//! Renders the next bytes of the sparse image started by VLANImageBegin().
+//!
+//! \param buffer pointer-to-array of at least length bytes
+//! \param length the largest number of bytes to render
+//!
+//! \return Returns the number of bytes rendered, 0 once the image is complete
+//
+//*****************************************************************************
+extern uint32_t VLANImageRender(uint8_t *buffer, uint32_t length);
+
+//*****************************************************************************
+//
+//! Clears the RAM membership map and prepares to receive a sparse image.
+//!
+//! \param max_length the largest image accepted, in bytes
+//
+//*****************************************************************************
+extern void VLANImageLoadBegin(uint32_t max_length);
+
+//*****************************************************************************
+//
+//! Feeds the next bytes of a sparse image into the RAM membership map. Bytes
+//! past the end of the image are ignored.
+//!
+//! \param data pointer-to-array of image bytes
+//! \param length the number of bytes in data
+//!
+//! \return Returns false once the image has been rejected, otherwise true
+//
+//*****************************************************************************
+extern bool VLANImageLoad(const uint8_t *data, uint32_t length);
+
+//*****************************************************************************
+//
+//! Returns the number of bytes VLANImageLoad() still expects.
+//!
+//! \return Returns the number of bytes still expected, 0 once complete or rejected
+//
+//*****************************************************************************
+extern uint32_t VLANImageLoadPending(void);
+
+//*****************************************************************************
+//
+//! Finishes a sparse image load. The RAM membership map is cleared again if
+//! the image was incomplete, rejected or failed its CRC check.
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool VLANImageLoadEnd(void);
+
+//*****************************************************************************
+//
+//! Reads the membership of a VLAN from the RAM membership map.
+//!
+//! \param vlan_id the VLAN to look up (1 - 4095)
+//! \param membership returns the 5-bit port membership mask (may be NULL)
+//!
+//! \return Returns true if the VLAN entry is valid (active), otherwise false
+//
+//*****************************************************************************
+extern bool VLANGetEntry(uint32_t vlan_id, uint8_t *membership);
+
+//*****************************************************************************
+//
+//! Updates a VLAN in the RAM membership map and writes its group back to the
+//! Ethernet Controller with a single indirect read-modify-write. The filter
+//! IDs of all four entries are preserved.
+//!
+//! \param vlan_id the VLAN to change (1 - 4095)
+//! \param valid true if the entry is valid (active)
+//! \param membership the 5-bit port membership mask
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool VLANSetEntry(uint32_t vlan_id, bool valid, uint8_t membership);
+
+//*****************************************************************************
+//
+//! Writes every group changed by VLANSetEntry() during the calling task's
+//! batch (see EthoBatchBegin()), once per group.
+//!
+//! \param groups returns the number of groups written (may be NULL)
+//!
+//! \return Returns the result of the operation (0 = Failed, 1 = Succeeded)
+//
+//*****************************************************************************
+extern bool VLANBatchCommit(uint32_t *groups);
+
+#endif /* VLAN_TABLE_H_ */